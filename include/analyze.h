@@ -39,6 +39,7 @@
 #include "analyze/info.h"
 #include "analyze/pnts.h"
 #include "analyze/polygonize.h"
+#include "analyze/shotline.h"
 #include "analyze/nirt.h"
 #include "analyze/worker.h"
 #include "analyze/voxelize.h"
@@ -88,6 +88,105 @@ ANALYZE_EXPORT extern int rectangular_triple_grid_generator(struct xray *rayp, v
 ANALYZE_EXPORT extern double rectangular_grid_spacing(void *grid_context);
 
 
+/**
+ * Per-ray summary recorded by the caller for the adaptive grid.  Two
+ * neighboring rays that disagree on the regions they pass through or
+ * on whether they saw an overlap straddle a feature of the model, and
+ * the cells between them get refined.  The thickness is used to
+ * refine where the line-of-sight thickness curves faster than the
+ * current cell size can integrate.
+ */
+struct adaptive_grid_sample {
+    unsigned long regions;	/**< @brief hash of the regions hit along the ray, in order */
+    fastf_t thickness;		/**< @brief total line-of-sight thickness along the ray */
+    int overlap;		/**< @brief non-zero if the ray passed through an overlap */
+};
+
+/**
+ * Summary of an adaptive grid, filled in by adaptive_grid_stats().
+ */
+struct adaptive_grid_stats {
+    size_t cells;		/**< @brief number of top level cells */
+    fastf_t u_size, v_size;	/**< @brief dimensions of a top level cell */
+    size_t rays;		/**< @brief rays handed out, including correction rays */
+    size_t leaves;		/**< @brief cells that were not subdivided */
+    size_t unresolved;		/**< @brief finest cells that still straddle a feature */
+    int max_level;		/**< @brief deepest subdivision allowed */
+    int level;			/**< @brief deepest subdivision reached */
+    fastf_t error;		/**< @brief estimated error of the thickness integral over the view */
+};
+
+/**
+ * Adaptive grid over one view plane.  The plane is first covered by
+ * a uniform grid of cells, one ray through the center of each.  Cells
+ * whose ray disagrees with a neighbor are split into 3x3 children;
+ * the center child reuses the parent ray so only eight new rays are
+ * needed per split.  Refinement proceeds one level per round until no
+ * cell needs splitting or the spacing limit is reached.
+ *
+ * Each ray carries a weight equal to the area of its cell in units
+ * of the top level cell area.  Splitting a cell also hands out one
+ * correction ray through the parent center with a negative weight
+ * that trades the parent's contribution for that of its center
+ * child, so accumulations made with the weights are always those of
+ * the current set of leaf cells.  Callers should skip anything that
+ * is not a weighted accumulation (hit counts, event reports, plots)
+ * for rays with a negative weight.
+ */
+struct adaptive_grid;
+
+/**
+ * Create an adaptive grid spanning u_len by v_len from origin along
+ * the unit vectors u_dir and v_dir, with u_cells by v_cells top level
+ * cells and rays fired along ray_dir.  Cells are never split below
+ * spacing_limit.  thickness_tol bounds the thickness second
+ * difference between a cell and its neighbors before the cell is
+ * split; pass INFINITY to refine on region and overlap changes only.
+ */
+ANALYZE_EXPORT extern struct adaptive_grid *adaptive_grid_create(const point_t origin, const vect_t u_dir, const vect_t v_dir, const vect_t ray_dir,
+								 fastf_t u_len, fastf_t v_len, size_t u_cells, size_t v_cells,
+								 fastf_t spacing_limit, fastf_t thickness_tol);
+
+/**
+ * Hand out the next ray of the current round.  The cell the ray
+ * belongs to is returned in sample, and the weights to accumulate it
+ * with in weight and cell_scale.  cell_scale is the factor to apply
+ * to the squared top level cell dimensions for the cell of this ray,
+ * and is needed for second moments across the ray.
+ *
+ * This function is not thread safe; callers running in parallel
+ * must serialize calls to it.
+ *
+ * Returns 1 when the current round has no more rays, 0 otherwise.
+ */
+ANALYZE_EXPORT extern int adaptive_grid_next_ray(struct adaptive_grid *grid, struct xray *rayp, size_t *sample, fastf_t *weight, fastf_t *cell_scale);
+
+/**
+ * Record the summary of the ray fired for sample.  Distinct samples
+ * may be recorded in parallel.
+ */
+ANALYZE_EXPORT extern void adaptive_grid_record(struct adaptive_grid *grid, size_t sample, const struct adaptive_grid_sample *s);
+
+/**
+ * Split the cells of the last round that need it and queue the rays
+ * for the next round.  Must be called once every ray of the current
+ * round has been recorded.
+ *
+ * Returns the number of rays queued, 0 when the grid is done.
+ */
+ANALYZE_EXPORT extern size_t adaptive_grid_refine(struct adaptive_grid *grid);
+
+/**
+ * Summarize the grid, including the estimated error of the thickness
+ * integral over the view plane.  The estimate is the midpoint rule
+ * error of the smooth cells plus half the thickness jump over the
+ * finest cells that still straddle a feature.
+ */
+ANALYZE_EXPORT extern void adaptive_grid_stats(struct adaptive_grid *grid, struct adaptive_grid_stats *stats);
+
+ANALYZE_EXPORT extern void adaptive_grid_destroy(struct adaptive_grid *grid);
+
+
 __END_DECLS
 
 #endif /* ANALYZE_GRID_H */
@@ -224,6 +224,22 @@ analyze_set_aspect(struct current_state *context, fastf_t aspect);
 ANALYZE_EXPORT extern void
 analyze_set_samples_per_model_axis(struct current_state *context, fastf_t samples_per_model_axis);
 
+/**
+ * refine the triple grid only around cells whose neighboring rays
+ * differ in regions hit, thickness or overlap status, in a single
+ * pass, instead of halving the grid spacing over the whole model
+ * until the tolerances converge.  Has no effect on single grids.
+ */
+ANALYZE_EXPORT extern void
+analyze_set_adaptive_grid(struct current_state *context, int use_adaptive_grid);
+
+/**
+ * returns the estimated volume error of the last adaptive grid
+ * raytrace, averaged over the views
+ */
+ANALYZE_EXPORT extern fastf_t
+analyze_get_adaptive_grid_error(struct current_state *context);
+
 /**
  * sets the tolerance values for overlaps, volume, mass and surface area for the analysis
  */
@@ -58,6 +58,7 @@ struct nirt_opt_vals {
     int read_matrix;
     int show_formats;
     int silent_mode;
+    int space_partition;
     int use_air;
     int verbose_mode;
     struct bu_ptbl attrs;
@@ -73,10 +74,11 @@ struct nirt_opt_vals {
     struct bu_color color_even;
     struct bu_color color_gap;
     struct bu_color color_ovlp;
-
+    /* Shots to queue and fire together on all processors, 0 for none */
+    int batch_size;
 };
 
-#define NIRT_OPT_INIT {0, 0, 1, NIRT_OVLP_RESOLVE, 0, 0, 0, NIRT_SILENT_UNSET, 0, 0, BU_PTBL_INIT_ZERO, 0, 0, BU_PTBL_INIT_ZERO, BU_VLS_INIT_ZERO, BU_VLS_INIT_ZERO, VINIT_ZERO, BU_VLS_INIT_ZERO, BU_COLOR_CYAN, BU_COLOR_YELLOW, BU_COLOR_PURPLE, BU_COLOR_WHITE}
+#define NIRT_OPT_INIT {0, 0, 1, NIRT_OVLP_RESOLVE, 0, 0, 0, NIRT_SILENT_UNSET, 0, 0, 0, BU_PTBL_INIT_ZERO, 0, 0, BU_PTBL_INIT_ZERO, BU_VLS_INIT_ZERO, BU_VLS_INIT_ZERO, VINIT_ZERO, BU_VLS_INIT_ZERO, BU_COLOR_CYAN, BU_COLOR_YELLOW, BU_COLOR_PURPLE, BU_COLOR_WHITE, 0}
 
 /**
  * Given a nirt_opt_vals container, set up and return a bu_opt_desc that can
@@ -0,0 +1,125 @@
+/*                        S H O T L I N E . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @addtogroup libanalyze
+ *
+ *  Shoot batches of independent rays on all available processors and
+ *  keep the partitions each one produced.
+ *
+ */
+/** @{ */
+/** @file analyze/shotline.h */
+
+#ifndef ANALYZE_SHOTLINE_H
+#define ANALYZE_SHOTLINE_H
+
+#include "common.h"
+#include "raytrace.h"
+
+#include "analyze/defines.h"
+
+__BEGIN_DECLS
+
+/** Overlap handling for analyze_shotlines() */
+#define ANALYZE_SHOT_OVLP_RESOLVE          0 /**< @brief default overlap resolution */
+#define ANALYZE_SHOT_OVLP_REBUILD_FASTGEN  1 /**< @brief rt_rebuild_overlaps(), FASTGEN regions only */
+#define ANALYZE_SHOT_OVLP_REBUILD_ALL      2 /**< @brief rt_rebuild_overlaps(), all regions */
+
+/** One partition along a shotline, in ray order */
+struct analyze_shot_part {
+    struct region *regp;	/**< @brief region claiming the partition */
+    struct soltab *in_stp;	/**< @brief solid the ray enters through */
+    struct soltab *out_stp;	/**< @brief solid the ray leaves through */
+    fastf_t in_dist;
+    fastf_t out_dist;
+    point_t in_pt;
+    point_t out_pt;
+    vect_t in_norm;		/**< @brief outward normal, flip applied */
+    vect_t out_norm;		/**< @brief outward normal, flip applied */
+    int in_surfno;
+    int out_surfno;
+    struct region **claimants;	/**< @brief NULL terminated overlap claimants, or NULL */
+};
+
+/** One overlap reported while evaluating a shotline */
+struct analyze_shot_ovlp {
+    struct region *reg1;
+    struct region *reg2;
+    fastf_t in_dist;
+    fastf_t out_dist;
+    point_t in_pt;
+    point_t out_pt;
+};
+
+/**
+ * A ray to shoot and, once shot, what it found.  A miss leaves npart
+ * at zero.  The region and solid pointers stay valid until the rt_i
+ * is cleaned.
+ */
+struct analyze_shotline {
+    struct xray ray;
+    size_t npart;
+    struct analyze_shot_part *parts;
+    size_t novlp;
+    struct analyze_shot_ovlp *ovlps;
+};
+
+/**
+ * Record the partitions of part_head into s, computing the hit points
+ * and normals.  Meant to be called from an a_hit callback, so a single
+ * ray and a batch produce identical records.
+ */
+ANALYZE_EXPORT extern void analyze_shotline_parts(struct analyze_shotline *s, struct application *ap, struct partition *part_head);
+
+/**
+ * Shoot each of the nshots rays through the prepped rtip on up to ncpu
+ * threads, recording the results in place so they come back in input
+ * order.  resp must point to ncpu resources initialized for rtip, one
+ * per thread.  ovlp is one of the ANALYZE_SHOT_OVLP_* values.
+ *
+ * Only the ray of each record is read; the rest is overwritten, so
+ * results of an earlier call must be released with
+ * analyze_shotlines_free() before the records are reused.
+ *
+ * Returns 0 on success, -1 on bad input.  Results are released with
+ * analyze_shotlines_free().
+ */
+ANALYZE_EXPORT extern int analyze_shotlines(struct rt_i *rtip, struct resource *resp, size_t ncpu, struct analyze_shotline *shots, size_t nshots, int ovlp);
+
+/**
+ * Release the partition and overlap records of nshots shotlines,
+ * leaving their rays in place to be shot again.
+ */
+ANALYZE_EXPORT extern void analyze_shotlines_free(struct analyze_shotline *shots, size_t nshots);
+
+__END_DECLS
+
+#endif /* ANALYZE_SHOTLINE_H */
+
+/** @} */
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
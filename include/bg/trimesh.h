@@ -190,7 +190,15 @@ BG_EXPORT extern int bg_trimesh_decimate(int **ofaces, int *n_ofaces,
 
 /* Make an attempt at a trimesh intersection calculator that returns the sets
  * of faces intersecting and inside the other for each mesh. Doesn't attempt
- * a boolean evaluation, just characterizes faces */
+ * a boolean evaluation, just characterizes faces.
+ *
+ * Each output array is allocated with bu_calloc and must be freed by the
+ * caller with bu_free; it is set to NULL when its count is zero.  Any output
+ * may be NULL if it isn't wanted, and the inside classification is skipped if
+ * none of the inside outputs are requested.  The inside classification assumes
+ * both meshes are closed.
+ *
+ * Returns 1 if any faces of the two meshes intersect, 0 otherwise. */
 BG_EXPORT extern int
 bg_trimesh_isect(
     int **faces_inside_1, int *num_faces_inside_1, int **faces_inside_2, int *num_faces_inside_2,
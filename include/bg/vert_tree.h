@@ -21,11 +21,11 @@
 /*----------------------------------------------------------------------*/
 /** @addtogroup bg_vert_tree
  *
- * Routines to manage a binary search tree of vertices.
+ * Routines to manage a welded set of vertices.
  *
  * The actual vertices are stored in an array
  * for convenient use by routines such as "mk_bot".
- * The binary search tree stores indices into the array.
+ * A spatial hash of tolerance sized cells stores indices into the array.
  *
  */
 /** @{ */
@@ -50,7 +50,7 @@ __BEGIN_DECLS
 struct bg_vert_tree {
     uint32_t magic;
     int tree_type;		/**< @brief vertices or vertices with normals */
-    union vert_tree *the_tree;	/**< @brief the actual vertex tree */
+    struct bg_vert_hash *the_tree;	/**< @brief spatial hash of the vertices in the array */
     fastf_t *the_array;		/**< @brief the array of vertices */
     size_t curr_vert;		/**< @brief the number of vertices currently in the array */
     size_t max_vert;		/**< @brief the current maximum capacity of the array */
@@ -87,6 +87,8 @@ BG_EXPORT extern void bg_vert_tree_destroy(struct bg_vert_tree *tree);
 /**
  *@brief
  *	Routine to add a vertex to the current list of part vertices.
+ *	If a vertex within sqrt(local_tol_sq) is already present, the
+ *	closest one is reused instead.
  *	The array is re-alloc'd if needed.
  *	Returns index into the array of vertices where this vertex is stored
  */
@@ -113,7 +115,7 @@ BG_EXPORT extern size_t bg_vert_tree_add_w_norm(struct bg_vert_tree *tree,
 
 /**
  *@brief
- *	Routine to free the binary search tree and reset the current number of vertices.
+ *	Routine to free the vertex hash and reset the current number of vertices.
  *	The vertex array is left untouched, for reuse later.
  */
 BG_EXPORT extern void bg_vert_tree_clean(struct bg_vert_tree *tree);
@@ -66,6 +66,14 @@ BN_EXPORT extern void bn_noise_init(void);
  */
 BN_EXPORT extern double bn_noise_perlin(point_t pt);
 
+/**
+ * Perlin noise at each of the n points, stored in values.  Results
+ * match bn_noise_perlin().
+ */
+BN_EXPORT extern void bn_noise_perlin_n(size_t n,
+					point_t *points,
+					double *values);
+
 /* FIXME: Why isn't the result listed first? */
 
 /**
@@ -136,6 +144,46 @@ BN_EXPORT extern double bn_noise_turb(point_t point,
 				      double lacunarity,
 				      double octaves);
 
+/**
+ * @brief
+ * Spectral weights for one set of fBm parameters.
+ *
+ * bn_noise_fbm() and bn_noise_turb() look the weights up on every
+ * call.  Callers that evaluate the same parameters many times (e.g.,
+ * shaders) should instead get the weights once with
+ * bn_noise_spec_get() when they are set up and use the bn_noise_spec_
+ * functions below.  The returned tables are shared, immutable and
+ * remain valid until the program exits; they must not be freed.
+ */
+struct bn_noise_spec;
+
+BN_EXPORT extern const struct bn_noise_spec *bn_noise_spec_get(double h_val,
+							     double lacunarity,
+							     double octaves);
+
+/**
+ * Same as bn_noise_fbm() and bn_noise_turb() with the parameters the
+ * spec was created with.
+ */
+BN_EXPORT extern double bn_noise_spec_fbm(const struct bn_noise_spec *spec,
+					  point_t point);
+BN_EXPORT extern double bn_noise_spec_turb(const struct bn_noise_spec *spec,
+					   point_t point);
+
+/**
+ * Evaluate bn_noise_spec_fbm() or bn_noise_spec_turb() at each of the
+ * n points, storing the results in values.  Evaluating a run of
+ * points per call amortizes the per-call and per-octave setup.
+ */
+BN_EXPORT extern void bn_noise_spec_fbm_n(const struct bn_noise_spec *spec,
+					  size_t n,
+					  point_t *points,
+					  double *values);
+BN_EXPORT extern void bn_noise_spec_turb_n(const struct bn_noise_spec *spec,
+					   size_t n,
+					   point_t *points,
+					   double *values);
+
 /**
  * From "Texturing and Modeling, A Procedural Approach" 2nd ed
  */
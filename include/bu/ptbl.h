@@ -140,6 +140,24 @@ BU_EXPORT extern void bu_ptbl_init(struct bu_ptbl *b,
 				   size_t len,
 				   const char *str);
 
+/**
+ * Attach a pointer hash index to an initialized table, so that
+ * bu_ptbl_locate(), bu_ptbl_ins_unique() and bu_ptbl_cat_uniq() no
+ * longer scan the whole table.  Table order and all return values are
+ * unchanged.
+ *
+ * The index is kept by libbu beside the table, keyed by the table's
+ * address, and is released by bu_ptbl_free(); an indexed table must
+ * be freed with it.  A struct copy of an indexed table is a plain,
+ * unindexed table.  The index follows changes made through the
+ * bu_ptbl_*() routines and entries appended directly at the end of
+ * the table.  Callers that overwrite existing entries in place
+ * (BU_PTBL_SET(), bu_sort() of the buffer) must call bu_ptbl_index()
+ * again afterwards.  bu_ptbl_locate() only reads the index, so it
+ * needs no more locking than on a plain table.
+ */
+BU_EXPORT extern void bu_ptbl_index(struct bu_ptbl *b);
+
 /**
  * Reset the table to have no elements, but retain any existing
  * storage.
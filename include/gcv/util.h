@@ -61,7 +61,9 @@ GCV_EXPORT extern int gcv_bot_is_orientable(const struct rt_bot_internal *bot);
  * write_region is a function pointer to a routine that will
  * write out the region in a given file format.
  *
- * This routine must be prepared to run in parallel.
+ * This routine must be prepared to run in parallel, unless the walk
+ * is driven by gcv_walk_regions(), which calls it for one region at
+ * a time in the order a serial walk makes the calls.
  */
 struct gcv_region_end_data
 {
@@ -85,6 +87,44 @@ GCV_EXPORT extern union tree *gcv_region_end(struct db_tree_state *tsp, const st
  */
 GCV_EXPORT extern union tree *gcv_region_end_mc(struct db_tree_state *tsp, const struct db_full_path *pathp, union tree *curtree, void *client_data);
 
+/**
+ * Walk the regions below argv as db_walk_tree() does, running
+ * reg_end_func on up to ncpu threads (0 for all available).
+ *
+ * Each thread gets its own resource in tsp->ts_resp and its own
+ * scratch model in *tsp->ts_m, so reg_end_func must use those rather
+ * than rt_uniresource or a model of the caller's.  Output handed to
+ * gcv_region_emit() is written in the order a serial walk produces,
+ * whatever order the threads finish in; with more than one thread, a
+ * first walk that evaluates nothing finds that order.  A region that
+ * db_walk_tree() splits into several subtrees is emitted once for
+ * each.  gcv_region_end() may be used as reg_end_func;
+ * under this walk it triangulates each region before writing it.
+ *
+ * Returns the db_walk_tree() result.
+ */
+GCV_EXPORT extern int gcv_walk_regions(struct db_i *dbip, int argc, const char **argv, size_t ncpu,
+				       const struct db_tree_state *init_state,
+				       union tree *(*reg_end_func)(struct db_tree_state *, const struct db_full_path *, union tree *, void *),
+				       union tree *(*leaf_func)(struct db_tree_state *, const struct db_full_path *, struct rt_db_internal *, void *),
+				       void *client_data);
+
+/**
+ * Hand an evaluated region from a region end callback to write_region,
+ * which runs with bomb protection and then the region is killed.  The
+ * caller must not touch r afterwards.
+ *
+ * Under gcv_walk_regions() the write may be deferred until earlier
+ * regions have been written, in which case pathp and tsp are copied.
+ * Call this at most once per region, outside of any BU_SETJUMP.  r may
+ * be NULL so that write_region can keep per-region bookkeeping in
+ * order; regions a callback never emits are skipped.  Elsewhere the
+ * region is written immediately.
+ */
+GCV_EXPORT extern void gcv_region_emit(struct db_tree_state *tsp, const struct db_full_path *pathp, struct nmgregion *r,
+				       void (*write_region)(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *tsp, void *client_data),
+				       void *client_data);
+
 
 GCV_EXPORT extern union tree *gcv_bottess_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union tree *curtree, void *client_data);
 
@@ -154,6 +154,10 @@ GED_EXPORT extern int ged_inside_internal(struct ged *gedp,
 
 GED_EXPORT void draw_scene(struct bv_scene_obj *s, struct bview *v);
 
+/* Like draw_scene, for cnt objects at once - view independent geometry is
+ * generated on all available processors. */
+GED_EXPORT void draw_scenes(struct bv_scene_obj **objs, size_t cnt, struct bview *v);
+
 
 /** @} */
 
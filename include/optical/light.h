@@ -63,6 +63,7 @@ struct light_specific {
     /* Internal fields */
     vect_t	lt_color;	/**< @brief RGB, as 0..1 */
     fastf_t	lt_radius;	/**< @brief approximate radius of spherical light */
+    fastf_t	lt_bradius;	/**< @brief radius of sphere about lt_pos bounding the light */
     fastf_t	lt_cosangle;	/**< @brief cos of lt_angle */
     vect_t	lt_pos;		/**< @brief location in space of light */
     vect_t	lt_vec;		/**< @brief Unit vector from origin to light */
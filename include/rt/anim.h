@@ -136,6 +136,15 @@ RT_EXPORT extern int db_do_anim(struct animate *anp,
 				mat_t arc,
 				struct mater_info *materp);
 
+/**
+ * Return 1 if the animation applies at some node of pathp, that is
+ * when the arc it animates ends at pathp's last node or above it, and
+ * 0 otherwise.  Paths are compared as db_apply_anims() does while
+ * walking the tree.
+ */
+RT_EXPORT extern int db_anim_on_path(const struct animate *anp,
+				     const struct db_full_path *pathp);
+
 /**
  * Release chain of animation structures
  *
@@ -207,6 +207,62 @@ RT_EXPORT extern int rt_poly_roots(bn_poly_t *eqn,
 				   bn_complex_t roots[],
 				   const char *name);
 
+/**
+ * Find the real roots of a polynomial that lie in [lo, hi], such as
+ * the span of a ray that can reach a primitive.
+ *
+ * The roots are stored in ascending order in roots[], which must hold
+ * eqn->dgr values, and their number is returned.  A root where the
+ * polynomial touches zero without changing sign (e.g., a ray grazing
+ * a surface) is stored twice.  Unlike rt_poly_roots() the polynomial
+ * is left unchanged.
+ *
+ * Quadratics, cubics and quartics are solved in closed form, and the
+ * result is accepted only if it agrees with the Sturm sequence count
+ * of distinct roots in the interval.  Otherwise, and for higher
+ * degrees, the roots are isolated with the Sturm sequence and refined
+ * by bracketed Newton iteration.
+ */
+RT_EXPORT extern int rt_poly_real_roots(const bn_poly_t *eqn,
+					fastf_t lo,
+					fastf_t hi,
+					fastf_t roots[]);
+
+/**
+ * Solve n polynomials with rt_poly_real_roots(), each over its own
+ * [lo[i], hi[i]].  The roots of eqns[i] are stored starting at
+ * roots[i * BN_MAX_POLY_DEGREE] and their number in nroots[i].
+ */
+RT_EXPORT extern void rt_poly_real_roots_n(size_t n,
+					   const bn_poly_t *eqns,
+					   const fastf_t lo[],
+					   const fastf_t hi[],
+					   fastf_t roots[],
+					   int nroots[]);
+
+/**
+ * Like rt_poly_real_roots(), but for degrees up to four a complex pair
+ * within RT_ROOT_TOL of the real axis is stored as well, as a double
+ * root at its real part.  Primitives that took such near misses from
+ * rt_poly_roots() as grazing hits, such as the tgc, use this to keep
+ * doing so.
+ */
+RT_EXPORT extern int rt_poly_near_real_roots(const bn_poly_t *eqn,
+					     fastf_t lo,
+					     fastf_t hi,
+					     fastf_t roots[]);
+
+/**
+ * Solve n polynomials with rt_poly_near_real_roots(), stored as by
+ * rt_poly_real_roots_n().
+ */
+RT_EXPORT extern void rt_poly_near_real_roots_n(size_t n,
+						const bn_poly_t *eqns,
+						const fastf_t lo[],
+						const fastf_t hi[],
+						fastf_t roots[],
+						int nroots[]);
+
 /** @} */
 
 
@@ -494,6 +494,26 @@ RT_EXPORT extern int db_get_external(struct bu_external *ep,
 				     const struct directory *dp,
 				     const struct db_i *dbip);
 
+/**
+ * Like db_get_external(), but when the object bytes are already in
+ * memory (an RT_DIR_INMEM object, or a database opened read-only and
+ * memory mapped by db_open()) 'ep' is pointed directly at them
+ * instead of receiving a private copy.
+ *
+ * A borrowed view must not be modified or passed to
+ * bu_free_external(), and remains valid only until the object is
+ * rewritten or the database is closed.  It is intended for callers
+ * that only parse the external form, such as the importers.
+ *
+ * Returns -
+ * -1 error
+ * 0 success, 'ep' owns a copy and must be freed with bu_free_external()
+ * 1 success, 'ep' is a borrowed view and must not be freed
+ */
+RT_EXPORT extern int db_get_external_view(struct bu_external *ep,
+					  const struct directory *dp,
+					  const struct db_i *dbip);
+
 /**
  * Given that caller already has an external representation of the
  * database object, update it to have a new name (taken from
@@ -883,6 +903,14 @@ RT_EXPORT extern void db_alloc_directory_block(struct resource *resp);
  */
 RT_EXPORT extern void rt_alloc_seg_block(struct resource *res);
 
+/**
+ * This routine is called by the GET_PT macro when the partition
+ * freelist is exhausted.  Like rt_alloc_seg_block(), it gets a whole
+ * contiguous batch of partitions at once, each with its pt_seglist
+ * already initialized.
+ */
+RT_EXPORT extern void rt_alloc_pt_block(struct resource *res);
+
 
 /**
  * Read named MGED db, build toc.
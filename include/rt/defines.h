@@ -191,6 +191,7 @@
 #define RT_MAXLINE              10240
 
 #define RT_PART_NUBSPT  0
+#define RT_PART_HLBVH   1	/**< @brief  flattened bounding volume hierarchy over all solid RPPs */
 
 #endif /* RT_DEFINES_H */
 
@@ -140,6 +140,10 @@ struct rt_functab {
 			    fastf_t /* s_size */);
 #define RTFUNCTAB_FUNC_ADAPTIVE_PLOT_CAST(_func) ((int (*)(struct bu_list *, struct rt_db_internal *, const struct bn_tol *, const struct bview *, fastf_t))((void (*)(void))_func))
 
+    /** intersect n ray/solid pairs; segp[i].seg_stp is NULL on a miss,
+     * and any segments after the first are queued on segp[i].l, which
+     * the caller initializes as an empty list head.  ap is required,
+     * segments come from its a_resource */
     void (*ft_vshot)(struct soltab * /*stp*/[],
 		     struct xray *[] /*rp*/,
 		     struct seg * /*segp*/,
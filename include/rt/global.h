@@ -63,6 +63,21 @@ __BEGIN_DECLS
  * need to (re)allocate massive numbers of individual vlists. */
 RT_EXPORT extern struct bu_list rt_vlfree;
 
+/**
+ * The vlist free list the calling thread should draw from - the one it
+ * installed with rt_vlfree_set(), or rt_vlfree if it has none.  The
+ * librt plotting routines allocate their vlists from here, so threads
+ * that each install a private list may plot concurrently.
+ */
+RT_EXPORT extern struct bu_list *rt_vlfree_get(void);
+
+/**
+ * Install hd as the calling thread's vlist free list, or with NULL go
+ * back to rt_vlfree.  The list stays owned by the caller, who should
+ * move any entries still on it to rt_vlfree when done.
+ */
+RT_EXPORT extern void rt_vlfree_set(struct bu_list *hd);
+
 /**
  * Default librt-supplied resource structure for uniprocessor cases.  Because
  * only one of these structures can be used with each thread of execution (see
@@ -60,6 +60,29 @@ RT_EXPORT extern int rt_unprep(struct rt_i *rtip,
 RT_EXPORT extern int rt_reprep(struct rt_i *rtip,
 			       struct rt_reprep_obj_list *objs,
 			       struct resource *resp);
+
+/**
+ * Bring a prepped rt_i up to date after animations on its database
+ * changed.  anims holds every struct animate that was added, removed
+ * or modified since the last prep; removed ones need only still have
+ * a valid an_path.  Each region with one of them on its path or on an
+ * arc inside it is released, along with the solids only it uses, and
+ * walked again with ncpu threads under the animations now attached to
+ * the database.  Every other region and solid keeps its prep.  The
+ * space partition is updated in place: solids leave and join the
+ * NUBSP cells, or the BVH is refit around them.
+ *
+ * Data that applications hang off regions (reg_udata, reg_mfuncs)
+ * must be released before the call and set up again after it.
+ *
+ * Returns the number of regions re-prepped, or -1 when the rt_i has
+ * to be cleaned and prepped from scratch instead (rooted animations,
+ * or a region that cannot be walked again by name).
+ */
+RT_EXPORT extern int rt_reprep_anim(struct rt_i *rtip,
+				    const struct bu_ptbl *anims,
+				    size_t ncpu,
+				    struct resource *resp);
 RT_EXPORT extern int re_prep_solids(struct rt_i *rtip,
 				    int num_solids,
 				    char **solid_names,
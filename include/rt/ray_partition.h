@@ -89,16 +89,16 @@ struct partition {
 	GET_PT(ip, p, res); \
 	memset(((char *) &(p)->RT_PT_MIDDLE_START), 0, RT_PT_MIDDLE_LEN(p)); }
 
+/**
+ * Partitions are carved out of contiguous blocks by
+ * rt_alloc_pt_block(), so the partitions of one ray tend to be
+ * neighbors in memory.
+ */
 #define GET_PT(ip, p, res) { \
-	if (BU_LIST_NON_EMPTY_P(p, partition, &res->re_parthead)) { \
-	    BU_LIST_DEQUEUE((struct bu_list *)(p)); \
-	    bu_ptbl_reset(&(p)->pt_seglist); \
-	} else { \
-	    BU_ALLOC((p), struct partition); \
-	    (p)->pt_magic = PT_MAGIC; \
-	    bu_ptbl_init(&(p)->pt_seglist, 42, "pt_seglist ptbl"); \
-	    (res)->re_partlen++; \
-	} \
+	while (!BU_LIST_NON_EMPTY_P(p, partition, &(res)->re_parthead)) \
+	    rt_alloc_pt_block(res); \
+	BU_LIST_DEQUEUE((struct bu_list *)(p)); \
+	bu_ptbl_reset(&(p)->pt_seglist); \
 	res->re_partget++; }
 
 #define FREE_PT(p, res) { \
@@ -102,11 +102,18 @@ struct resource {
     long                re_tree_free;
     struct directory *  re_directory_hd;
     struct bu_ptbl      re_directory_blocks;    /**< @brief  Table of malloc'ed blocks */
+    struct bu_ptbl      re_part_blocks; /**< @brief  Table of malloc'ed blocks of partitions */
+    struct partition ** re_ptidx;       /**< @brief  In-order partition index for rt_boolweave() */
+    size_t              re_ptidx_len;   /**< @brief  # elements used in re_ptidx[] */
+    size_t              re_ptidx_max;   /**< @brief  # elements allocated in re_ptidx[] */
+    unsigned int *      re_boolmark;    /**< @brief  per-solid stamps for compiled booleans [st_bit] */
+    size_t              re_boolmark_len; /**< @brief  # elements in re_boolmark[] */
+    unsigned int        re_boolstamp;   /**< @brief  stamp of the partition being evaluated */
 };
 
 #define RESOURCE_NULL   ((struct resource *)0)
 #define RT_CK_RESOURCE(_p) BU_CKMAG(_p, RESOURCE_MAGIC, "struct resource")
-#define RT_RESOURCE_INIT_ZERO { RESOURCE_MAGIC, 0, BU_LIST_INIT_ZERO, BU_PTBL_INIT_ZERO, 0, 0, 0, BU_LIST_INIT_ZERO, 0, 0, 0, BU_LIST_INIT_ZERO, BU_LIST_INIT_ZERO, BU_LIST_INIT_ZERO, NULL, 0, NULL, 0, 0, 0, 0, 0, 0, 0, 0, NULL, 0, 0, 0, 0, BU_PTBL_INIT_ZERO, NULL, 0, 0, 0, NULL, BU_PTBL_INIT_ZERO }
+#define RT_RESOURCE_INIT_ZERO { RESOURCE_MAGIC, 0, BU_LIST_INIT_ZERO, BU_PTBL_INIT_ZERO, 0, 0, 0, BU_LIST_INIT_ZERO, 0, 0, 0, BU_LIST_INIT_ZERO, BU_LIST_INIT_ZERO, BU_LIST_INIT_ZERO, NULL, 0, NULL, 0, 0, 0, 0, 0, 0, 0, 0, NULL, 0, 0, 0, 0, BU_PTBL_INIT_ZERO, NULL, 0, 0, 0, NULL, BU_PTBL_INIT_ZERO, BU_PTBL_INIT_ZERO, NULL, 0, 0, NULL, 0, 0 }
 
 /**
  * Definition of global parallel-processing semaphores.
@@ -43,6 +43,9 @@
 
 __BEGIN_DECLS
 
+struct bvh_flat_node; /* opaque, see librt/cut_hlbvh.h */
+struct bool_progs; /* opaque, see librt/bool.c */
+
 // libbu's callback type isn't quite right for this case, so we might as well
 // be specific.
 typedef void(*rti_clbk_t)(struct rt_i *rtip, struct db_tree_state *tsp, struct region *r);
@@ -72,7 +75,7 @@ struct rt_i {
     size_t              rti_nlights;    /**< @brief  number of light sources */
     int                 rti_prismtrace; /**< @brief  add support for pixel prism trace */
     char *              rti_region_fix_file; /**< @brief  rt_regionfix() file or NULL */
-    int                 rti_space_partition;  /**< @brief  space partitioning method */
+    int                 rti_space_partition;  /**< @brief  space partitioning method, RT_PART_NUBSPT or RT_PART_HLBVH */
     struct bn_tol       rti_tol;        /**< @brief  Math tolerances for this model */
     struct bg_tess_tol  rti_ttol;       /**< @brief  Tessellation tolerance defaults */
     fastf_t             rti_max_beam_radius; /**< @brief  Max threat radius for FASTGEN cline solid */
@@ -118,7 +121,13 @@ struct rt_i {
     struct bu_hist      rti_hist_cellsize; /**< @brief  occupancy of cut cells */
     struct bu_hist      rti_hist_cell_pieces; /**< @brief  solid pieces per cell */
     struct bu_hist      rti_hist_cutdepth; /**< @brief  depth of cut tree */
+    struct bvh_flat_node *rti_bvh_nodes; /**< @brief  RT_PART_HLBVH tree, nodes in depth-first order */
+    long                rti_bvh_nnodes; /**< @brief  # of nodes in rti_bvh_nodes */
+    struct soltab **    rti_bvh_solids; /**< @brief  finite solids in BVH leaf order */
+    size_t              rti_bvh_nsolids; /**< @brief  # of entries in rti_bvh_solids */
+    fastf_t             rti_bvh_cost;   /**< @brief  node area sum over root area of rti_bvh_nodes as built */
     struct soltab **    rti_Solids;     /**< @brief  ptrs to soltab [st_bit] */
+    struct bool_progs * rti_boolprogs;  /**< @brief  region boolean trees compiled for rt_boolfinal() */
     struct bu_list      rti_solidheads[RT_DBNHASH]; /**< @brief  active solid lists */
     struct bu_ptbl      rti_resources;  /**< @brief  list of 'struct resource's encountered */
     size_t              rti_cutlen;     /**< @brief  goal for # solids per boxnode */
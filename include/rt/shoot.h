@@ -95,6 +95,28 @@ __BEGIN_DECLS
 RT_EXPORT extern int rt_shootray(struct application *ap);
 
 
+/**
+ * Answer whether anything opaque lies along a ray, as needed for
+ * shadow and other visibility-only rays, without building partitions.
+ *
+ * The ray in ap->a_ray (with a_rt_i and a_resource) is walked until a
+ * segment entering between mindist and maxdist is found on a solid
+ * used by a region whose boolean tree is all unions, for which
+ * opaque() returns nonzero.  Such a segment is inside that region, so
+ * the ray stops there.  A NULL opaque treats every region as opaque.
+ * The a_hit and a_miss callbacks are not used.  Overlaps are not
+ * resolved, so a ray through an overlap with a non-opaque region is
+ * reported as occluded.
+ *
+ * Returns -
+ *  1 if the ray is occluded
+ *  0 if no solid at all is hit between mindist and maxdist
+ * -1 if something was hit that could not be proven opaque without
+ *    full boolean evaluation; the caller should use rt_shootray()
+ */
+RT_EXPORT extern int rt_occluded(struct application *ap, fastf_t mindist, fastf_t maxdist, int (*opaque)(struct application *, const struct region *));
+
+
 /**
  * @brief
  * Shoot a bundle of rays
@@ -142,6 +164,27 @@ RT_EXPORT extern struct partition *rt_shootray_simple(struct application *ap,
  */
 RT_EXPORT extern int rt_shootray_bundle(struct application *ap, struct xray *rays, int nrays);
 
+
+/** Number of rays traced together by rt_shootray_packet() */
+#define RT_PACKET_MAX 16
+
+/**
+ * Shoot a packet of coherent rays, such as neighboring pixels of a
+ * view.  Each element of aps is a fully set up application, as would
+ * be handed to rt_shootray(), and gets exactly the same callbacks and
+ * a_return, with the callbacks made in array order after the whole
+ * packet has been traced.  All elements must share a_rt_i and
+ * a_resource.
+ *
+ * With the RT_PART_HLBVH space partitioning, the rays of a packet
+ * descend the scene hierarchy together (RT_PACKET_MAX at a time) and
+ * BoT primitives intersect them in one pass.  Otherwise each ray is
+ * simply handed to rt_shootray().
+ *
+ * Returns the number of rays shot.
+ */
+RT_EXPORT extern int rt_shootray_packet(struct application *aps, int nrays);
+
 /**
  * To be called only in non-parallel mode, to tally up the statistics
  * from the resource structure(s) into the rt instance structure.
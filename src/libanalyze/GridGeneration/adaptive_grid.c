@@ -0,0 +1,413 @@
+/*                  A D A P T I V E _ G R I D . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file adaptive_grid.c
+ *
+ * Grid of rays over a view plane that is only refined where
+ * neighboring rays disagree.
+ *
+ * Cells are addressed by integer coordinates at their own level, so
+ * a cell at level l with coordinates (iu, iv) covers
+ * [iu, iu+1) x [iv, iv+1) in units of the top level cell size over
+ * 3^l.  Splitting in three rather than two keeps the parent ray at
+ * the center of the middle child.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "bu/malloc.h"
+#include "raytrace.h"
+#include "vmath.h"
+
+#include "analyze.h"
+
+/* 3^12 top level subdivisions per axis is far below any sensible
+ * spacing limit, and keeps the integer coordinates well in range.
+ */
+#define ADAPTIVE_GRID_MAX_LEVEL 12
+
+struct adaptive_grid_node {
+    int64_t iu, iv;	/* coordinates at this node's level */
+    int level;
+    int shot;		/* sample has been recorded */
+    size_t child;	/* first of nine children, 0 for a leaf */
+    struct adaptive_grid_sample sample;
+};
+
+struct adaptive_grid_ray {
+    size_t node;
+    int correction;
+};
+
+struct adaptive_grid {
+    point_t origin;
+    vect_t u_dir;
+    vect_t v_dir;
+    vect_t ray_dir;
+    size_t u_cells, v_cells;
+    fastf_t u_size, v_size;
+    int max_level;
+    fastf_t thickness_tol;
+    int64_t pow3[ADAPTIVE_GRID_MAX_LEVEL + 1];
+
+    struct adaptive_grid_node *nodes;
+    size_t node_cnt, node_max;
+
+    /* rays of the current round */
+    struct adaptive_grid_ray *rays;
+    size_t ray_cnt, ray_max;
+    size_t current;
+    size_t total_rays;
+
+    /* cells shot or created in the current round */
+    size_t *cand;
+    size_t cand_cnt, cand_max;
+};
+
+
+static void
+grid_queue_ray(struct adaptive_grid *grid, size_t node, int correction)
+{
+    if (grid->ray_cnt == grid->ray_max) {
+	grid->ray_max = grid->ray_max ? grid->ray_max * 2 : 64;
+	grid->rays = (struct adaptive_grid_ray *)bu_realloc(grid->rays, grid->ray_max * sizeof(struct adaptive_grid_ray), "adaptive grid rays");
+    }
+    grid->rays[grid->ray_cnt].node = node;
+    grid->rays[grid->ray_cnt].correction = correction;
+    grid->ray_cnt++;
+}
+
+
+static void
+grid_queue_cand(struct adaptive_grid *grid, size_t node)
+{
+    if (grid->cand_cnt == grid->cand_max) {
+	grid->cand_max = grid->cand_max ? grid->cand_max * 2 : 64;
+	grid->cand = (size_t *)bu_realloc(grid->cand, grid->cand_max * sizeof(size_t), "adaptive grid candidates");
+    }
+    grid->cand[grid->cand_cnt++] = node;
+}
+
+
+/**
+ * Find the cell that was shot at level or coarser and covers the
+ * level cell (iu, iv).  Returns NULL outside of the grid.
+ */
+static const struct adaptive_grid_node *
+grid_cell_at(const struct adaptive_grid *grid, int64_t iu, int64_t iv, int level)
+{
+    const struct adaptive_grid_node *node;
+    int64_t scale = grid->pow3[level];
+    int l;
+
+    if (iu < 0 || iv < 0 || iu >= (int64_t)grid->u_cells * scale || iv >= (int64_t)grid->v_cells * scale)
+	return NULL;
+
+    node = &grid->nodes[(size_t)(iv / scale) * grid->u_cells + (size_t)(iu / scale)];
+    for (l = 0; l < level && node->child; l++) {
+	const struct adaptive_grid_node *next;
+	scale /= 3;
+	next = &grid->nodes[node->child + (size_t)(((iv / scale) % 3) * 3 + (iu / scale) % 3)];
+	if (!next->shot)
+	    break;
+	node = next;
+    }
+    return node;
+}
+
+
+/**
+ * Compare a cell with its four neighbors.  Sets d2 to the sum of the
+ * thickness second differences along u and v, and jump to the largest
+ * thickness difference with a neighbor that disagrees.  Coarser leaf
+ * neighbors that disagree are returned in coarse so the feature can
+ * be chased into them.
+ *
+ * Returns non-zero if any neighbor disagrees on regions or overlap.
+ */
+static int
+grid_assess(const struct adaptive_grid *grid, size_t idx, fastf_t *d2, fastf_t *jump, size_t coarse[4], int *coarse_cnt)
+{
+    static const int64_t du[4] = {-1, 1, 0, 0};
+    static const int64_t dv[4] = {0, 0, -1, 1};
+    const struct adaptive_grid_node *n = &grid->nodes[idx];
+    const struct adaptive_grid_node *nb[4];
+    int differs = 0;
+    int i;
+
+    *d2 = 0.0;
+    *jump = 0.0;
+    *coarse_cnt = 0;
+
+    for (i = 0; i < 4; i++) {
+	const struct adaptive_grid_node *m = grid_cell_at(grid, n->iu + du[i], n->iv + dv[i], n->level);
+	nb[i] = (m && m->shot) ? m : NULL;
+	if (!nb[i])
+	    continue;
+	if (m->sample.regions != n->sample.regions || !m->sample.overlap != !n->sample.overlap) {
+	    fastf_t dt = fabs(m->sample.thickness - n->sample.thickness);
+	    differs = 1;
+	    V_MAX(*jump, dt);
+	    if (m->level < n->level && !m->child && m->level < grid->max_level)
+		coarse[(*coarse_cnt)++] = (size_t)(m - grid->nodes);
+	}
+    }
+
+    if (nb[0] && nb[1])
+	*d2 += fabs(nb[0]->sample.thickness - 2.0 * n->sample.thickness + nb[1]->sample.thickness);
+    if (nb[2] && nb[3])
+	*d2 += fabs(nb[2]->sample.thickness - 2.0 * n->sample.thickness + nb[3]->sample.thickness);
+
+    return differs;
+}
+
+
+struct adaptive_grid *
+adaptive_grid_create(const point_t origin, const vect_t u_dir, const vect_t v_dir, const vect_t ray_dir,
+		     fastf_t u_len, fastf_t v_len, size_t u_cells, size_t v_cells,
+		     fastf_t spacing_limit, fastf_t thickness_tol)
+{
+    struct adaptive_grid *grid;
+    fastf_t min_size;
+    size_t i, j;
+
+    BU_GET(grid, struct adaptive_grid);
+    memset(grid, 0, sizeof(struct adaptive_grid));
+
+    if (!u_cells)
+	u_cells = 1;
+    if (!v_cells)
+	v_cells = 1;
+
+    VMOVE(grid->origin, origin);
+    VMOVE(grid->u_dir, u_dir);
+    VMOVE(grid->v_dir, v_dir);
+    VMOVE(grid->ray_dir, ray_dir);
+    grid->u_cells = u_cells;
+    grid->v_cells = v_cells;
+    grid->u_size = u_len / (fastf_t)u_cells;
+    grid->v_size = v_len / (fastf_t)v_cells;
+    grid->thickness_tol = thickness_tol;
+
+    grid->pow3[0] = 1;
+    for (i = 1; i <= ADAPTIVE_GRID_MAX_LEVEL; i++)
+	grid->pow3[i] = grid->pow3[i-1] * 3;
+
+    min_size = FMIN(grid->u_size, grid->v_size);
+    while (grid->max_level < ADAPTIVE_GRID_MAX_LEVEL
+	   && min_size / (fastf_t)grid->pow3[grid->max_level + 1] >= spacing_limit)
+	grid->max_level++;
+
+    grid->node_max = grid->node_cnt = u_cells * v_cells;
+    grid->nodes = (struct adaptive_grid_node *)bu_calloc(grid->node_max, sizeof(struct adaptive_grid_node), "adaptive grid nodes");
+    for (j = 0; j < v_cells; j++) {
+	for (i = 0; i < u_cells; i++) {
+	    size_t idx = j * u_cells + i;
+	    grid->nodes[idx].iu = (int64_t)i;
+	    grid->nodes[idx].iv = (int64_t)j;
+	    grid_queue_ray(grid, idx, 0);
+	    grid_queue_cand(grid, idx);
+	}
+    }
+
+    return grid;
+}
+
+
+int
+adaptive_grid_next_ray(struct adaptive_grid *grid, struct xray *rayp, size_t *sample, fastf_t *weight, fastf_t *cell_scale)
+{
+    const struct adaptive_grid_ray *r;
+    const struct adaptive_grid_node *n;
+    fastf_t inv_scale, u, v, w;
+
+    if (grid->current >= grid->ray_cnt)
+	return 1;
+
+    r = &grid->rays[grid->current++];
+    n = &grid->nodes[r->node];
+    grid->total_rays++;
+
+    inv_scale = 1.0 / (fastf_t)grid->pow3[n->level];
+    u = ((fastf_t)n->iu + 0.5) * grid->u_size * inv_scale;
+    v = ((fastf_t)n->iv + 0.5) * grid->v_size * inv_scale;
+    VJOIN2(rayp->r_pt, grid->origin, u, grid->u_dir, v, grid->v_dir);
+    VMOVE(rayp->r_dir, grid->ray_dir);
+
+    *sample = r->node;
+    w = inv_scale * inv_scale;
+    if (r->correction) {
+	/* replace the parent weight 9c with the center child's c; the
+	 * transverse second moment goes from 81c^2 to c^2 likewise.
+	 */
+	fastf_t c = w / 9.0;
+	*weight = -8.0 * c;
+	*cell_scale = 10.0 * c;
+    } else {
+	*weight = w;
+	*cell_scale = w;
+    }
+    return 0;
+}
+
+
+void
+adaptive_grid_record(struct adaptive_grid *grid, size_t sample, const struct adaptive_grid_sample *s)
+{
+    if (sample >= grid->node_cnt)
+	return;
+    grid->nodes[sample].sample = *s;
+    grid->nodes[sample].shot = 1;
+}
+
+
+size_t
+adaptive_grid_refine(struct adaptive_grid *grid)
+{
+    char *split;
+    size_t i, cnt;
+
+    cnt = grid->node_cnt;
+    split = (char *)bu_calloc(cnt, sizeof(char), "adaptive grid split flags");
+
+    for (i = 0; i < grid->cand_cnt; i++) {
+	size_t idx = grid->cand[i];
+	const struct adaptive_grid_node *n = &grid->nodes[idx];
+	size_t coarse[4];
+	int coarse_cnt, k;
+	fastf_t d2, jump;
+
+	if (!n->shot || n->child || n->level >= grid->max_level)
+	    continue;
+
+	if (grid_assess(grid, idx, &d2, &jump, coarse, &coarse_cnt)) {
+	    split[idx] = 1;
+	    for (k = 0; k < coarse_cnt; k++)
+		split[coarse[k]] = 1;
+	} else if (d2 > grid->thickness_tol) {
+	    split[idx] = 1;
+	}
+    }
+
+    grid->ray_cnt = 0;
+    grid->cand_cnt = 0;
+    grid->current = 0;
+
+    for (i = 0; i < cnt; i++) {
+	size_t child;
+	int a, b;
+
+	if (!split[i])
+	    continue;
+
+	if (grid->node_cnt + 9 > grid->node_max) {
+	    grid->node_max = (grid->node_cnt + 9) * 2;
+	    grid->nodes = (struct adaptive_grid_node *)bu_realloc(grid->nodes, grid->node_max * sizeof(struct adaptive_grid_node), "adaptive grid nodes");
+	}
+
+	child = grid->node_cnt;
+	for (b = 0; b < 3; b++) {
+	    for (a = 0; a < 3; a++) {
+		struct adaptive_grid_node *c = &grid->nodes[grid->node_cnt];
+		memset(c, 0, sizeof(struct adaptive_grid_node));
+		c->iu = grid->nodes[i].iu * 3 + a;
+		c->iv = grid->nodes[i].iv * 3 + b;
+		c->level = grid->nodes[i].level + 1;
+		if (a == 1 && b == 1) {
+		    c->sample = grid->nodes[i].sample;
+		    c->shot = 1;
+		} else {
+		    grid_queue_ray(grid, grid->node_cnt, 0);
+		}
+		grid_queue_cand(grid, grid->node_cnt);
+		grid->node_cnt++;
+	    }
+	}
+	grid->nodes[i].child = child;
+	grid_queue_ray(grid, i, 1);
+    }
+
+    bu_free(split, "adaptive grid split flags");
+    return grid->ray_cnt;
+}
+
+
+void
+adaptive_grid_stats(struct adaptive_grid *grid, struct adaptive_grid_stats *stats)
+{
+    size_t i;
+
+    memset(stats, 0, sizeof(struct adaptive_grid_stats));
+    stats->cells = grid->u_cells * grid->v_cells;
+    stats->u_size = grid->u_size;
+    stats->v_size = grid->v_size;
+    stats->rays = grid->total_rays;
+    stats->max_level = grid->max_level;
+
+    for (i = 0; i < grid->node_cnt; i++) {
+	const struct adaptive_grid_node *n = &grid->nodes[i];
+	size_t coarse[4];
+	int coarse_cnt;
+	fastf_t d2, jump, area;
+
+	if (n->child || !n->shot)
+	    continue;
+
+	stats->leaves++;
+	V_MAX(stats->level, n->level);
+
+	area = grid->u_size * grid->v_size / (fastf_t)(grid->pow3[n->level] * grid->pow3[n->level]);
+	if (grid_assess(grid, i, &d2, &jump, coarse, &coarse_cnt)) {
+	    /* the boundary crosses the cell somewhere we can't resolve */
+	    stats->unresolved++;
+	    stats->error += area * jump * 0.5;
+	} else {
+	    /* midpoint rule error, h^2 f''/24 per axis */
+	    stats->error += area * d2 / 24.0;
+	}
+    }
+}
+
+
+void
+adaptive_grid_destroy(struct adaptive_grid *grid)
+{
+    if (!grid)
+	return;
+    bu_free(grid->nodes, "adaptive grid nodes");
+    if (grid->rays)
+	bu_free(grid->rays, "adaptive grid rays");
+    if (grid->cand)
+	bu_free(grid->cand, "adaptive grid candidates");
+    BU_PUT(grid, struct adaptive_grid);
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
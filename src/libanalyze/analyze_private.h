@@ -93,6 +93,8 @@ struct per_region_data {
 #define A_LENDEN a_color[0]
 #define A_LEN a_color[1]
 #define A_STATE a_uptr
+#define A_WEIGHT a_dist        /* area weight of the ray's cell, see adaptive_grid_next_ray() */
+#define A_CELLSCALE a_color[2] /* squared cell size factor for moments across the ray */
 
 struct current_state {
     int curr_view; 	/* the "view" number we are shooting */
@@ -144,6 +146,7 @@ struct current_state {
     int use_air;
     int use_single_grid;
     int grid_size_flag; 	/* flag that identifies when the grid-size is mentioned */
+    int use_adaptive_grid;	/* refine only where neighboring rays differ */
     int use_view_information;
     int quiet_missed_report;
     int default_den;
@@ -172,6 +175,11 @@ struct current_state {
     point_t eye_model;
     struct rectangular_grid *grid;
 
+    /* adaptive grid variables */
+    struct adaptive_grid *adaptive_grid;
+    struct adaptive_grid_sample *adaptive_samples; /* one per cpu, filled in by the hit routines */
+    double adaptive_error[3];	/* estimated volume error per view */
+
     struct rt_i *rtip;
     struct resource *resp;
 
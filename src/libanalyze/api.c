@@ -25,6 +25,7 @@
 
 #include "common.h"
 
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -78,6 +79,12 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
     double last_out_dist = -1.0;
     double gap_dist;
     struct current_state *state = (struct current_state *)ap->A_STATE;
+    struct adaptive_grid_sample *sample = NULL;
+
+    /* a negative weight takes back part of a ray that was already
+     * reported, so only the weighted sums are updated
+     */
+    int correction = (ap->A_WEIGHT < 0.0);
 
     if (!segs) /* unexpected */
 	return 0;
@@ -85,6 +92,9 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
     if (PartHeadp->pt_forw == PartHeadp)
 	return 1;
 
+    if (state->adaptive_samples)
+	sample = &state->adaptive_samples[ap->a_resource->re_cpu];
+
 
     /* examine each partition until we get back to the head */
     for (pp=PartHeadp->pt_forw; pp != PartHeadp; pp = pp->pt_forw) {
@@ -107,6 +117,11 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
 	VJOIN1(pt, ap->a_ray.r_pt, pp->pt_inhit->hit_dist, ap->a_ray.r_dir);
 	VJOIN1(opt, ap->a_ray.r_pt, pp->pt_outhit->hit_dist, ap->a_ray.r_dir);
 
+	if (sample) {
+	    sample->regions = sample->regions * 31 + (unsigned long)pp->pt_regionp->reg_bit + 1;
+	    sample->thickness += dist;
+	}
+
 	if (state->debug) {
 	    bu_semaphore_acquire(BU_SEM_GENERAL);
 	    bu_vls_printf(state->debug_str, "%s %g->%g\n", pp->pt_regionp->reg_name,
@@ -114,7 +129,7 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
 	    bu_semaphore_release(BU_SEM_GENERAL);
 	}
 
-	if (state->analysis_flags & ANALYSIS_EXP_AIR) {
+	if (!correction && (state->analysis_flags & ANALYSIS_EXP_AIR)) {
 
 	    gap_dist = (pp->pt_inhit->hit_dist - last_out_dist);
 
@@ -130,7 +145,7 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
 	}
 
 	/* looking for voids in the model */
-	if (state->analysis_flags & ANALYSIS_GAP) {
+	if (!correction && (state->analysis_flags & ANALYSIS_GAP)) {
 	    if (pp->pt_back != PartHeadp) {
 		/* if this entry point is further than the previous
 		 * exit point then we have a void
@@ -181,6 +196,8 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
 			Ly_sq = Ly*Ly;
 			Lz_sq = Lz*Lz;
 			cell_area = Ly_sq;
+			Ly_sq *= ap->A_CELLSCALE;
+			Lz_sq *= ap->A_CELLSCALE;
 			break;
 		    case 1:
 			Lx_sq = Lx*Lx;
@@ -188,6 +205,8 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
 			Ly_sq *= Ly_sq;
 			Lz_sq = Lz*Lz;
 			cell_area = Lx_sq;
+			Lx_sq *= ap->A_CELLSCALE;
+			Lz_sq *= ap->A_CELLSCALE;
 			break;
 		    case 2:
 		    default:
@@ -196,6 +215,8 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
 			Lz_sq = dist*pp->pt_regionp->reg_los*0.01;
 			Lz_sq *= Lz_sq;
 			cell_area = Lx_sq;
+			Lx_sq *= ap->A_CELLSCALE;
+			Ly_sq *= ap->A_CELLSCALE;
 			break;
 		}
 
@@ -205,14 +226,14 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
 		 */
 		los = pp->pt_regionp->reg_los;
 
-		if (los < 1) {
+		if (los < 1 && !correction) {
 		    bu_semaphore_acquire(BU_SEM_GENERAL);
 		    bu_vls_printf(state->log_str, "bad LOS (%d) on %s\n", los, pp->pt_regionp->reg_name);
 		    bu_semaphore_release(BU_SEM_GENERAL);
 		}
 
 		/* accumulate the total mass values */
-		val = grams_per_cu_mm * dist * (pp->pt_regionp->reg_los * 0.01);
+		val = grams_per_cu_mm * dist * (pp->pt_regionp->reg_los * 0.01) * ap->A_WEIGHT;
 		ap->A_LENDEN += val;
 
 		prd = ((struct per_region_data *)pp->pt_regionp->reg_udata);
@@ -319,15 +340,16 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
 	/* compute the volume of the object */
 	if (state->analysis_flags & ANALYSIS_VOLUME) {
 	    struct per_region_data *prd = ((struct per_region_data *)pp->pt_regionp->reg_udata);
-	    ap->A_LEN += dist; /* add to total volume */
+	    double wdist = dist * ap->A_WEIGHT;
+	    ap->A_LEN += wdist; /* add to total volume */
 	    {
 		bu_semaphore_acquire(state->sem_worker);
 
 		/* add to region volume */
-		prd->r_len[state->curr_view] += dist;
+		prd->r_len[state->curr_view] += wdist;
 
 		/* add to object volume */
-		prd->optr->o_len[state->curr_view] += dist;
+		prd->optr->o_len[state->curr_view] += wdist;
 
 		bu_semaphore_release(state->sem_worker);
 	    }
@@ -337,7 +359,7 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
 			      pp->pt_regionp->reg_name, dist, prd->optr->o_len[state->curr_view], prd->optr->o_name);
 		bu_semaphore_release(BU_SEM_GENERAL);
 	    }
-	    if (state->plot_volume) {
+	    if (state->plot_volume && !correction) {
 		bu_semaphore_acquire(state->sem_plot);
 		if (ap->a_user & 1) {
 		    pl_color(state->plot_volume, 128, 255, 192);  /* pale green */
@@ -351,14 +373,14 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
 	}
 
 	/* look for two adjacent air regions */
-	if (state->analysis_flags & ANALYSIS_ADJ_AIR) {
+	if (!correction && (state->analysis_flags & ANALYSIS_ADJ_AIR)) {
 	    if (last_air && pp->pt_regionp->reg_aircode &&
 		pp->pt_regionp->reg_aircode != last_air) {
 		state->adj_air_callback(&ap->a_ray, pp, pt, state->adj_air_callback_data);
 	    }
 	}
 
-	if (pp->pt_regionp->reg_aircode) {
+	if (pp->pt_regionp->reg_aircode && !correction) {
 	    /* look for air first on shotlines */
 	    if (pp->pt_back == PartHeadp) {
 		if (state->analysis_flags & ANALYSIS_FIRST_AIR)
@@ -382,14 +404,15 @@ analyze_hit(struct application *ap, struct partition *PartHeadp, struct seg *seg
 	}
 
 	/* note that this region has been seen */
-	((struct per_region_data *)pp->pt_regionp->reg_udata)->hits++;
+	if (!correction)
+	    ((struct per_region_data *)pp->pt_regionp->reg_udata)->hits++;
 
 	last_air = pp->pt_regionp->reg_aircode;
 	last_out_dist = pp->pt_outhit->hit_dist;
 	VJOIN1(last_out_point, ap->a_ray.r_pt, pp->pt_outhit->hit_dist, ap->a_ray.r_dir);
     }
 
-    if (state->analysis_flags & ANALYSIS_EXP_AIR && last_air) {
+    if (state->analysis_flags & ANALYSIS_EXP_AIR && last_air && !correction) {
 	/* the last thing we hit was air.  Make a note of that */
 	pp = PartHeadp->pt_back;
 	state->exp_air_callback(pp, last_out_point, pt, opt, state->exp_air_callback_data);
@@ -458,6 +481,13 @@ analyze_overlap(struct application *ap,
 	/* too small to matter, pick one or none */
 	return 1;
 
+    if (state->adaptive_samples)
+	state->adaptive_samples[ap->a_resource->re_cpu].overlap = 1;
+
+    /* already reported by the ray this one corrects */
+    if (ap->A_WEIGHT < 0.0)
+	return 1;
+
     VJOIN1(ihit, rp->r_pt, ihitp->hit_dist, rp->r_dir);
 
     if (state->analysis_flags & ANALYSIS_OVERLAPS) {
@@ -798,8 +828,37 @@ analyze_worker(int cpu, void *ptr)
     ap.A_LENDEN = 0.0; /* really the cumulative length*density for mass computation*/
     ap.A_LEN = 0.0;    /* really the cumulative length for volume computation */
     ap.A_STATE = ptr; /* really copying the state ptr to the a_uptr */
+    ap.A_WEIGHT = 1.0;
+    ap.A_CELLSCALE = 1.0;
     ap.a_overlap = analyze_overlap;
 
+    if (state->adaptive_grid) {
+	struct adaptive_grid_sample *sample = &state->adaptive_samples[ap.a_resource->re_cpu];
+	size_t idx;
+
+	while (1) {
+	    bu_semaphore_acquire(state->sem_worker);
+	    if (adaptive_grid_next_ray(state->adaptive_grid, &ap.a_ray, &idx, &ap.A_WEIGHT, &ap.A_CELLSCALE)) {
+		bu_semaphore_release(state->sem_worker);
+		break;
+	    }
+	    bu_semaphore_release(state->sem_worker);
+	    ap.a_user = (int)idx;
+	    memset(sample, 0, sizeof(struct adaptive_grid_sample));
+	    (void)rt_shootray(&ap);
+	    if (state->aborted)
+		return;
+	    adaptive_grid_record(state->adaptive_grid, idx, sample);
+	}
+
+	/* shots are counted in top level cells once the view is done */
+	bu_semaphore_acquire(state->sem_stats);
+	state->m_lenDensity[state->curr_view] += ap.A_LENDEN;
+	state->m_len[state->curr_view] += ap.A_LEN;
+	bu_semaphore_release(state->sem_stats);
+	return;
+    }
+
     shot_cnt = 0;
     while (1) {
 	bu_semaphore_acquire(state->sem_worker);
@@ -1241,11 +1300,86 @@ analyze_setup_ae(struct current_state *state)
 }
 
 
+/**
+ * Shoot the triple grid once, refining each view only where
+ * neighboring rays differ in the regions they hit, their thickness or
+ * their overlap status.
+ */
+static void
+shoot_rays_adaptive(struct current_state *state)
+{
+    int view, axis;
+
+    for (axis = 0; axis < 3; axis++) {
+	state->steps[axis] = (long)ceil(state->span[axis] / state->gridSpacing);
+	if (state->steps[axis] < 1)
+	    state->steps[axis] = 1;
+    }
+
+    bu_log("Processing with adaptive grid spacing %g mm down to %g mm, %ld x %ld x %ld\n",
+	   state->gridSpacing,
+	   state->gridSpacingLimit,
+	   state->steps[0],
+	   state->steps[1],
+	   state->steps[2]);
+
+    state->adaptive_samples = (struct adaptive_grid_sample *)bu_calloc(MAX_PSW, sizeof(struct adaptive_grid_sample), "adaptive_samples");
+    for (view = 0; view < state->num_views; view++) {
+	struct adaptive_grid_stats stats;
+	fastf_t thickness_tol = INFINITY;
+
+	if (state->verbose)
+	    bu_vls_printf(state->verbose_str, "  view %d\n", view);
+	analyze_triple_grid_setup(view, state);
+
+	/* keep the midpoint rule error of every cell within its share
+	 * of the volume tolerance, (area/view area) * tol
+	 */
+	if ((state->analysis_flags & ANALYSIS_VOLUME) && state->volume_tolerance > 0.0)
+	    thickness_tol = 24.0 * state->volume_tolerance / state->area[view];
+
+	state->adaptive_grid = adaptive_grid_create(state->rtip->mdl_min, state->u_dir, state->v_dir, state->grid->ray_direction,
+						    state->span[state->u_axis], state->span[state->v_axis],
+						    (size_t)state->steps[state->u_axis], (size_t)state->steps[state->v_axis],
+						    state->gridSpacingLimit, thickness_tol);
+	do {
+	    bu_parallel(analyze_worker, state->ncpu, (void *)state);
+	} while (!state->aborted && adaptive_grid_refine(state->adaptive_grid));
+
+	adaptive_grid_stats(state->adaptive_grid, &stats);
+	adaptive_grid_destroy(state->adaptive_grid);
+	state->adaptive_grid = NULL;
+
+	state->shots[view] += stats.cells;
+	state->adaptive_error[view] = stats.error;
+	bu_log("View %d: %zu rays, %zu cells down to level %d of %d, %zu unresolved, estimated volume error %g cu mm\n",
+	       view, stats.rays, stats.leaves, stats.level, stats.max_level, stats.unresolved, stats.error);
+
+	if (state->aborted)
+	    break;
+    }
+    bu_free(state->adaptive_samples, "adaptive_samples");
+    state->adaptive_samples = NULL;
+
+    /* fills in the per-view values used in the summaries */
+    (void)mass_volume_surf_area_terminate_check(state);
+
+    if (state->verbose)
+	bu_vls_printf(state->verbose_str, "Computation Done\n");
+}
+
+
 static void
 shoot_rays(struct current_state *state)
 {
     /* compute */
     double inv_spacing;
+
+    if (state->use_adaptive_grid && !state->use_single_grid && !(state->analysis_flags & ANALYSIS_SURF_AREA)) {
+	shoot_rays_adaptive(state);
+	return;
+    }
+
     do {
 	inv_spacing = 1.0/state->gridSpacing;
 	VSCALE(state->steps, state->span, inv_spacing);
@@ -1308,6 +1442,8 @@ perform_raytracing(struct current_state *state, struct db_i *dbip, char *names[]
 
     state->grid = &grid;
     grid.single_grid = 0;
+    state->adaptive_grid = NULL;
+    state->adaptive_samples = NULL;
 
     state->analysis_flags = flags;
 
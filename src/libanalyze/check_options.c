@@ -60,6 +60,7 @@ analyze_current_state_init(void)
     state->samples_per_model_axis = 2.0;
     state->aborted = 0;
     state->grid_size_flag = 0;
+    state->use_adaptive_grid = 0;
 
     state->exp_air_callback = NULL;
     state->exp_air_callback_data = NULL;
@@ -238,6 +239,34 @@ analyze_set_samples_per_model_axis(struct current_state *state, fastf_t samples_
     state->samples_per_model_axis = samples_per_model_axis;
 }
 
+/*
+ * sets the flag to refine the triple grid only where neighboring rays
+ * differ, instead of halving the grid spacing over the whole model.
+ */
+void
+analyze_set_adaptive_grid(struct current_state *state, int use_adaptive_grid)
+{
+    state->use_adaptive_grid = use_adaptive_grid;
+}
+
+/*
+ * returns the estimated volume error of the adaptive grid, averaged
+ * over the views.
+ */
+fastf_t
+analyze_get_adaptive_grid_error(struct current_state *state)
+{
+    int view;
+    fastf_t error = 0.0;
+
+    if (state->num_views < 1)
+	return 0.0;
+
+    for (view = 0; view < state->num_views; view++)
+	error += state->adaptive_error[view];
+    return error / state->num_views;
+}
+
 /*
  * sets tolerance for different analysis options -- overlaps, volume, mass and
  * surface area
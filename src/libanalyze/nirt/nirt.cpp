@@ -449,7 +449,8 @@ _nirt_get_rtip(struct nirt_state *nss)
 		return RTI_NULL;
 	    }
 	    nss->i->rtip_air->rti_dbip->dbi_read_only = 1;
-	    rt_init_resource(nss->i->res_air, 0, nss->i->rtip_air);
+	    for (size_t i = 0; i < nss->i->ncpu; i++)
+		rt_init_resource(&nss->i->res_air[i], (int)i, nss->i->rtip_air);
 	    nss->i->rtip_air->useair = 1;
 	}
 	return nss->i->rtip_air;
@@ -464,7 +465,8 @@ _nirt_get_rtip(struct nirt_state *nss)
 	    return RTI_NULL;
 	}
 	nss->i->rtip->rti_dbip->dbi_read_only = 1;
-	rt_init_resource(nss->i->res, 0, nss->i->rtip);
+	for (size_t i = 0; i < nss->i->ncpu; i++)
+	    rt_init_resource(&nss->i->res[i], (int)i, nss->i->rtip);
     }
     return nss->i->rtip;
 }
@@ -520,6 +522,7 @@ _nirt_raytrace_prep(struct nirt_state *nss)
     bu_free(attrs, "objs");
 
     nmsg(nss, "Prepping the geometry...\n");
+    nss->i->ap->a_rt_i->rti_space_partition = nss->i->space_partition;
     rt_prep(nss->i->ap->a_rt_i);
     nmsg(nss, "%s ", (nss->i->active_paths.size() == 1) ? "Object" : "Objects");
     for (size_t i = 0; i < nss->i->active_paths.size(); i++) {
@@ -1095,15 +1098,15 @@ _nirt_report(struct nirt_state *nss, char type, struct nirt_output_record *r)
  ************************/
 
 static void
-_nirt_find_ovlps(std::set<struct nirt_overlap *> &ovlps, struct nirt_state *nss, struct partition *pp)
+_nirt_find_ovlps(std::set<struct nirt_overlap *> &ovlps, struct nirt_state *nss, const struct analyze_shot_part *pp)
 {
     struct nirt_overlap *op;
 
     for (op = nss->i->vals->ovlp_list.forw; op != &(nss->i->vals->ovlp_list); op = op->forw) {
-	if (((pp->pt_inhit->hit_dist <= op->in_dist)
-		    && (op->in_dist <= pp->pt_outhit->hit_dist)) ||
-		((pp->pt_inhit->hit_dist <= op->out_dist)
-		 && (op->in_dist <= pp->pt_outhit->hit_dist))) {
+	if (((pp->in_dist <= op->in_dist)
+		    && (op->in_dist <= pp->out_dist)) ||
+		((pp->in_dist <= op->out_dist)
+		 && (op->in_dist <= pp->out_dist))) {
 	    ovlps.insert(op);
 	}
     }
@@ -1169,15 +1172,15 @@ _nirt_in_ovlp(struct nirt_overlap **op, std::set<struct nirt_overlap *> &ovlps,
 
 
 static struct nirt_overlap *
-_nirt_find_ovlp(struct nirt_state *nss, struct partition *pp)
+_nirt_find_ovlp(struct nirt_state *nss, const struct analyze_shot_part *pp)
 {
     struct nirt_overlap *op;
 
     for (op = nss->i->vals->ovlp_list.forw; op != &(nss->i->vals->ovlp_list); op = op->forw) {
-	if (((pp->pt_inhit->hit_dist <= op->in_dist)
-		    && (op->in_dist <= pp->pt_outhit->hit_dist)) ||
-		((pp->pt_inhit->hit_dist <= op->out_dist)
-		 && (op->in_dist <= pp->pt_outhit->hit_dist)))
+	if (((pp->in_dist <= op->in_dist)
+		    && (op->in_dist <= pp->out_dist)) ||
+		((pp->in_dist <= op->out_dist)
+		 && (op->in_dist <= pp->out_dist)))
 	    break;
     }
     return (op == &(nss->i->vals->ovlp_list)) ? NIRT_OVERLAP_NULL : op;
@@ -1200,15 +1203,17 @@ _nirt_init_ovlp(struct nirt_state *nss)
 }
 
 
-extern "C" int
-_nirt_if_hit(struct application *ap, struct partition *part_head, struct seg *UNUSED(finished_segs))
+/* Report the partitions of one shotline, using the overlaps collected
+ * in vals->ovlp_list while it was shot */
+static void
+_nirt_report_hit(struct nirt_state *nss, const struct analyze_shotline *shot)
 {
     struct bu_list *vhead;
-    struct nirt_state *nss = (struct nirt_state *)ap->a_uptr;
     struct nirt_output_record *vals = nss->i->vals;
     int part_nm = 0;
     struct nirt_overlap *ovp;
-    struct partition *part;
+    const struct analyze_shot_part *part;
+    vect_t ray_dir;
     int ev_odd = 1; /* first partition is colored as "odd" */
     point_t out_old = VINIT_ZERO;
     double d_out_old = 0.0;
@@ -1222,24 +1227,18 @@ _nirt_if_hit(struct application *ap, struct partition *part_head, struct seg *UN
     _nirt_report(nss, 'r', vals);
     _nirt_report(nss, 'h', vals);
 
-    if (nss->i->overlap_claims == NIRT_OVLP_REBUILD_FASTGEN) {
-	rt_rebuild_overlaps(part_head, ap, 1);
-    } else if (nss->i->overlap_claims == NIRT_OVLP_REBUILD_ALL) {
-	rt_rebuild_overlaps(part_head, ap, 0);
-    }
+    VMOVE(ray_dir, shot->ray.r_dir);
 
-    for (part = part_head->pt_forw; part != part_head; part = part->pt_forw) {
+    for (part = shot->parts; part < shot->parts + shot->npart; part++) {
 	s->type = NIRT_PARTITION_SEG;
 
 	++part_nm;
 
 	/* Update the output values */
-	RT_HIT_NORMAL(s->nm_in, part->pt_inhit, part->pt_inseg->seg_stp,
-		&ap->a_ray, part->pt_inflip);
-	RT_HIT_NORMAL(s->nm_out, part->pt_outhit, part->pt_outseg->seg_stp,
-		&ap->a_ray, part->pt_outflip);
-	VMOVE(s->in, part->pt_inhit->hit_point);
-	VMOVE(s->out, part->pt_outhit->hit_point);
+	VMOVE(s->nm_in, part->in_norm);
+	VMOVE(s->nm_out, part->out_norm);
+	VMOVE(s->in, part->in_pt);
+	VMOVE(s->out, part->out_pt);
 	if (part_nm > 1) VMOVE(s->gap_in, out_old);
 
 	ndbg(nss, ANALYZE_DEBUG_NIRT_HITS, "Partition %d entry: (%g, %g, %g) exit: (%g, %g, %g)\n",
@@ -1256,7 +1255,7 @@ _nirt_if_hit(struct application *ap, struct partition *part_head, struct seg *UN
 	s->nm_v_out = v_calc(nss, s->nm_out);
 
 	s->los = s->d_in - s->d_out;
-	s->scaled_los = 0.01 * s->los * part->pt_regionp->reg_los;
+	s->scaled_los = 0.01 * s->los * part->regp->reg_los;
 
 	if (part_nm > 1) {
 	    /* old d_out - new d_in */
@@ -1288,29 +1287,29 @@ _nirt_if_hit(struct application *ap, struct partition *part_head, struct seg *UN
 	VMOVE(out_old, s->out); // Stash the out value for gap_los calculation in the next partition
 	d_out_old = s->d_out; // Stash the d_out value for gap_los calculation in the next partition
 
-	s->path_name = std::string(part->pt_regionp->reg_name);
+	s->path_name = std::string(part->regp->reg_name);
 	{
 	    char *tmp_regname = (char *)bu_calloc(s->path_name.size() + 1, sizeof(char), "tmp reg_name");
-	    bu_path_basename(part->pt_regionp->reg_name, tmp_regname);
+	    bu_path_basename(part->regp->reg_name, tmp_regname);
 	    s->reg_name = std::string(tmp_regname);
 	    bu_free(tmp_regname, "tmp reg_name");
 	}
 
-	s->reg_id = part->pt_regionp->reg_regionid;
-	s->surf_num_in = part->pt_inhit->hit_surfno;
-	s->surf_num_out = part->pt_outhit->hit_surfno;
-	s->obliq_in = _nirt_get_obliq(ap->a_ray.r_dir, s->nm_in);
-	s->obliq_out = _nirt_get_obliq(ap->a_ray.r_dir, s->nm_out);
+	s->reg_id = part->regp->reg_regionid;
+	s->surf_num_in = part->in_surfno;
+	s->surf_num_out = part->out_surfno;
+	s->obliq_in = _nirt_get_obliq(ray_dir, s->nm_in);
+	s->obliq_out = _nirt_get_obliq(ray_dir, s->nm_out);
 
 	s->claimant_list = std::string();
 	s->claimant_listn = std::string();
-	if (part->pt_overlap_reg == 0) {
+	if (!part->claimants) {
 	    s->claimant_count = 1;
 	} else {
 	    struct region **rpp;
 	    struct bu_vls tmpcp = BU_VLS_INIT_ZERO;
 	    s->claimant_count = 0;
-	    for (rpp = part->pt_overlap_reg; *rpp != REGION_NULL; ++rpp) {
+	    for (rpp = part->claimants; *rpp != REGION_NULL; ++rpp) {
 		char *base = NULL;
 		if (s->claimant_count) {
 		    s->claimant_list.push_back(' ');
@@ -1332,7 +1331,7 @@ _nirt_if_hit(struct application *ap, struct partition *part_head, struct seg *UN
 	std::set<std::string>::iterator a_it;
 	for (a_it = nss->i->attrs.begin(); a_it != nss->i->attrs.end(); a_it++) {
 	    const char *key = (*a_it).c_str();
-	    const char *val = bu_avs_get(&part->pt_regionp->attr_values, key);
+	    const char *val = bu_avs_get(&part->regp->attr_values, key);
 	    if (val != NULL) {
 		s->attributes.append(key);
 		s->attributes.append("=");
@@ -1372,7 +1371,7 @@ _nirt_if_hit(struct application *ap, struct partition *part_head, struct seg *UN
 	    BV_ADD_VLIST(nss->i->segs->free_vlist_hd, vhead, s->out, BV_VLIST_LINE_DRAW);
 	} else {
 	    // Have ovlps - need to be nuanced about what we draw and when
-	    fastf_t curr_dist = part->pt_inhit->hit_dist;
+	    fastf_t curr_dist = part->in_dist;
 	    point_t curr_pnt;
 	    VMOVE(curr_pnt, s->in);
 	    while (seg_ovlps.size()) {
@@ -1412,7 +1411,7 @@ _nirt_if_hit(struct application *ap, struct partition *part_head, struct seg *UN
 		    }
 		}
 	    }
-	    if (curr_dist < part->pt_outhit->hit_dist) {
+	    if (curr_dist < part->out_dist) {
 		vhead = bv_vlblock_find(nss->i->segs, seg_rgb[RED], seg_rgb[GRN], seg_rgb[BLU]);
 		BV_ADD_VLIST(nss->i->segs->free_vlist_hd, vhead, curr_pnt, BV_VLIST_LINE_MOVE);
 		BV_ADD_VLIST(nss->i->segs->free_vlist_hd, vhead, s->out, BV_VLIST_LINE_DRAW);
@@ -1449,8 +1448,8 @@ _nirt_if_hit(struct application *ap, struct partition *part_head, struct seg *UN
 
 	    s->ov_reg1_id = ovp->reg1->reg_regionid;
 	    s->ov_reg2_id = ovp->reg2->reg_regionid;
-	    s->ov_sol_in = std::string(part->pt_inseg->seg_stp->st_dp->d_namep);
-	    s->ov_sol_out = std::string(part->pt_outseg->seg_stp->st_dp->d_namep);
+	    s->ov_sol_in = std::string(part->in_stp->st_dp->d_namep);
+	    s->ov_sol_out = std::string(part->out_stp->st_dp->d_namep);
 	    VMOVE(s->ov_in, ovp->in_point);
 	    VMOVE(s->ov_out, ovp->out_point);
 
@@ -1486,7 +1485,29 @@ _nirt_if_hit(struct application *ap, struct partition *part_head, struct seg *UN
 
     /* We're done reporting - let print get at everything */
     vals->seg->type = NIRT_ALL_SEG;
+}
+
+
+extern "C" int
+_nirt_if_hit(struct application *ap, struct partition *part_head, struct seg *UNUSED(finished_segs))
+{
+    struct nirt_state *nss = (struct nirt_state *)ap->a_uptr;
+    struct analyze_shotline shot;
 
+    if (nss->i->overlap_claims == NIRT_OVLP_REBUILD_FASTGEN) {
+	rt_rebuild_overlaps(part_head, ap, 1);
+    } else if (nss->i->overlap_claims == NIRT_OVLP_REBUILD_ALL) {
+	rt_rebuild_overlaps(part_head, ap, 0);
+    }
+
+    memset(&shot, 0, sizeof(struct analyze_shotline));
+    VMOVE(shot.ray.r_pt, ap->a_ray.r_pt);
+    VMOVE(shot.ray.r_dir, ap->a_ray.r_dir);
+    analyze_shotline_parts(&shot, ap, part_head);
+
+    _nirt_report_hit(nss, &shot);
+
+    analyze_shotlines_free(&shot, 1);
     return HIT;
 }
 
@@ -1529,6 +1550,89 @@ _nirt_if_overlap(struct application *ap, struct partition *pp, struct region *re
     return rt_defoverlap (ap, pp, reg1, reg2, InputHdp);
 }
 
+/* Fire the queued batch on all cpus, then report each shot in the
+ * order it was queued, under the values it was queued with */
+static int
+_nirt_batch_flush(struct nirt_state *nss)
+{
+    struct nirt_output_record saved = *nss->i->vals;
+    struct analyze_shotline *shots;
+    struct nirt_overlap *o;
+    size_t i, j, n = nss->i->batch.size();
+    int ovlp = ANALYZE_SHOT_OVLP_RESOLVE;
+
+    if (!n) return 0;
+
+    if (nss->i->overlap_claims == NIRT_OVLP_REBUILD_FASTGEN) {
+	ovlp = ANALYZE_SHOT_OVLP_REBUILD_FASTGEN;
+    } else if (nss->i->overlap_claims == NIRT_OVLP_REBUILD_ALL) {
+	ovlp = ANALYZE_SHOT_OVLP_REBUILD_ALL;
+    }
+
+    shots = (struct analyze_shotline *)bu_calloc(n, sizeof(struct analyze_shotline), "nirt batch");
+    for (i = 0; i < n; i++) {
+	VMOVE(shots[i].ray.r_pt, nss->i->batch[i].orig);
+	VMOVE(shots[i].ray.r_dir, nss->i->batch[i].dir);
+    }
+
+    if (analyze_shotlines(nss->i->ap->a_rt_i, nss->i->ap->a_resource, nss->i->ncpu, shots, n, ovlp) < 0) {
+	nerr(nss, "Error: batch of %zu shots failed\n", n);
+	nss->i->batch.clear();
+	bu_free(shots, "nirt batch");
+	return -1;
+    }
+
+    for (i = 0; i < n; i++) {
+	VMOVE(nss->i->vals->orig, shots[i].ray.r_pt);
+	VMOVE(nss->i->vals->dir, shots[i].ray.r_dir);
+	nss->i->vals->h = nss->i->batch[i].h;
+	nss->i->vals->v = nss->i->batch[i].v;
+	nss->i->vals->d_orig = nss->i->batch[i].d_orig;
+	nss->i->vals->a = nss->i->batch[i].a;
+	nss->i->vals->e = nss->i->batch[i].e;
+
+	if (!shots[i].npart) {
+	    _nirt_report(nss, 'r', nss->i->vals);
+	    _nirt_report(nss, 'm', nss->i->vals);
+	    continue;
+	}
+
+	/* same list _nirt_if_overlap builds for a single shot */
+	_nirt_init_ovlp(nss);
+	for (j = 0; j < shots[i].novlp; j++) {
+	    BU_ALLOC(o, struct nirt_overlap);
+	    o->ap = NULL;
+	    o->pp = NULL;
+	    o->reg1 = shots[i].ovlps[j].reg1;
+	    o->reg2 = shots[i].ovlps[j].reg2;
+	    o->in_dist = shots[i].ovlps[j].in_dist;
+	    o->out_dist = shots[i].ovlps[j].out_dist;
+	    VMOVE(o->in_point, shots[i].ovlps[j].in_pt);
+	    VMOVE(o->out_point, shots[i].ovlps[j].out_pt);
+	    o->forw = nss->i->vals->ovlp_list.forw;
+	    o->backw = &(nss->i->vals->ovlp_list);
+	    o->forw->backw = o;
+	    nss->i->vals->ovlp_list.forw = o;
+	}
+
+	_nirt_report_hit(nss, &shots[i]);
+    }
+
+    VMOVE(nss->i->vals->orig, saved.orig);
+    VMOVE(nss->i->vals->dir, saved.dir);
+    nss->i->vals->h = saved.h;
+    nss->i->vals->v = saved.v;
+    nss->i->vals->d_orig = saved.d_orig;
+    nss->i->vals->a = saved.a;
+    nss->i->vals->e = saved.e;
+
+    nss->i->batch.clear();
+    analyze_shotlines_free(shots, n);
+    bu_free(shots, "nirt batch");
+    return 0;
+}
+
+
 /**************
  *  Commands  *
  **************/
@@ -1549,10 +1653,12 @@ static const struct nirt_cmd_desc nirt_descs[] = {
     { "hv",             "set/query gridplane coordinates",               "horz vert [dist]" },
     { "xyz",            "set/query target coordinates",                  "X Y Z" },
     { "s",              "shoot a ray at the target",                     NULL },
+    { "batch",          "set/query shots queued per parallel batch",     "<n>" },
     { "backout",        "back out of model",                             NULL },
     { "useair",         "set/query use of air",                          "<0|1|2|...>" },
     { "units",          "set/query local units",                         "<mm|cm|m|in|ft>" },
     { "overlap_claims", "set/query overlap rebuilding/retention",        "<0|1|2|3>" },
+    { "space_partition", "set/query space partitioning method",          "<nubsp|bvh>" },
     { "fmt",            "set/query output formats",                      "{rhpfmog} format item item ..." },
     { "plotfile",       "designate an output file to hold plot data",    "file" },
     { "print",          "query an output item",                          "item" },
@@ -1862,15 +1968,31 @@ _nirt_cmd_shoot(void *ns, int argc, const char **UNUSED(argv))
 	    nss->i->ap->a_ray.r_pt[2] * nss->i->base2local,
 	    V3ARGS(nss->i->ap->a_ray.r_dir));
 
-    // TODO - any necessary initialization for data collection by callbacks
-    _nirt_init_ovlp(nss);
-    (void)rt_shootray(nss->i->ap);
+    if (nss->i->batch_size > 1) {
+	/* Queue the shot, it reports when the batch is fired */
+	struct nirt_batch_ray br;
+	VMOVE(br.orig, nss->i->vals->orig);
+	VMOVE(br.dir, nss->i->vals->dir);
+	br.h = nss->i->vals->h;
+	br.v = nss->i->vals->v;
+	br.d_orig = nss->i->vals->d_orig;
+	br.a = nss->i->vals->a;
+	br.e = nss->i->vals->e;
+	nss->i->batch.push_back(br);
+    } else {
+	// TODO - any necessary initialization for data collection by callbacks
+	_nirt_init_ovlp(nss);
+	(void)rt_shootray(nss->i->ap);
+    }
 
     // Undo backout
     for (i = 0; i < 3; ++i) {
 	nss->i->vals->orig[i] = nss->i->vals->orig[i] - (bov * -1*(nss->i->vals->dir[i]));
     }
 
+    if (nss->i->batch.size() && nss->i->batch.size() >= nss->i->batch_size)
+	return _nirt_batch_flush(nss);
+
     return 0;
 }
 
@@ -1901,6 +2023,34 @@ _nirt_cmd_backout(void *ns, int argc, const char *argv[])
 }
 
 
+extern "C" int
+_nirt_cmd_batch(void *ns, int argc, const char *argv[])
+{
+    struct nirt_state *nss = (struct nirt_state *)ns;
+    struct bu_vls optparse_msg = BU_VLS_INIT_ZERO;
+    int n = 0;
+    if (!ns) return -1;
+    if (argc == 1) {
+	nout(nss, "batch = %zu\n", nss->i->batch_size);
+	return 0;
+    }
+    if (argc > 2) {
+	nerr(nss, "Usage:  batch %s\n", _nirt_get_desc_args("batch"));
+	return -1;
+    }
+    if (bu_opt_int(&optparse_msg, 1, (const char **)&(argv[1]), (void *)&n) == -1 || n < 0) {
+	nerr(nss, "Error: bu_opt value read failure: %s\n\nUsage:  batch %s\n", bu_vls_cstr(&optparse_msg), _nirt_get_desc_args("batch"));
+	bu_vls_free(&optparse_msg);
+	return -1;
+    }
+    bu_vls_free(&optparse_msg);
+
+    /* Anything still queued was fired before this command ran */
+    nss->i->batch_size = (size_t)n;
+    return 0;
+}
+
+
 extern "C" int
 _nirt_cmd_color_plot(void *ns, int argc, const char *argv[])
 {
@@ -2063,6 +2213,46 @@ _nirt_cmd_do_overlap_claims(void *ns, int argc, const char *argv[])
 }
 
 
+extern "C" int
+_nirt_cmd_space_partition(void *ns, int argc, const char *argv[])
+{
+    struct nirt_state *nss = (struct nirt_state *)ns;
+    int method;
+    if (!ns) return -1;
+
+    if (argc == 1) {
+	if (nss->i->space_partition == RT_PART_HLBVH) {
+	    nout(nss, "bvh (%d)\n", RT_PART_HLBVH);
+	} else {
+	    nout(nss, "nubsp (%d)\n", RT_PART_NUBSPT);
+	}
+	return 0;
+    }
+
+    if (argc > 2) {
+	nerr(nss, "Usage:  space_partition %s\n", _nirt_get_desc_args("space_partition"));
+	return -1;
+    }
+
+    if (BU_STR_EQUAL(argv[1], "nubsp") || BU_STR_EQUAL(argv[1], "0")) {
+	method = RT_PART_NUBSPT;
+    } else if (BU_STR_EQUAL(argv[1], "bvh") || BU_STR_EQUAL(argv[1], "1")) {
+	method = RT_PART_HLBVH;
+    } else {
+	nerr(nss, "Error: Invalid space_partition specification: '%s'\n", argv[1]);
+	return -1;
+    }
+
+    /* The partitioning is built during prep, so changing it needs a re-prep */
+    if (method != nss->i->space_partition) {
+	nss->i->space_partition = method;
+	nss->i->need_reprep = 1;
+    }
+
+    return 0;
+}
+
+
 extern "C" int
 _nirt_cmd_format_output(void *ns, int argc, const char **argv)
 {
@@ -2545,6 +2735,7 @@ _nirt_cmd_state(void *ns, int argc, const char *argv[])
 	bu_vls_printf(&dumpstr, "xyz %g %g %g\n", V3ARGS(nss->i->vals->orig));
 	bu_vls_printf(&dumpstr, "dir %g %g %g\n", V3ARGS(nss->i->vals->dir));
 	bu_vls_printf(&dumpstr, "useair %d\n", nss->i->use_air);
+	bu_vls_printf(&dumpstr, "space_partition %s\n", (nss->i->space_partition == RT_PART_HLBVH) ? "bvh" : "nubsp");
 	bu_vls_printf(&dumpstr, "units %s\n", bu_units_string(nss->i->local2base));
 	bu_vls_printf(&dumpstr, "overlap_claims ");
 	switch (nss->i->overlap_claims) {
@@ -2601,6 +2792,7 @@ const struct bu_cmdtab _libanalyze_nirt_cmds[] = {
     { "ae",             _nirt_cmd_az_el},
     { "attr",           _nirt_cmd_attr},
     { "backout",        _nirt_cmd_backout},
+    { "batch",          _nirt_cmd_batch},
     { "center",         _nirt_cmd_target_coor},
     { "color",          _nirt_cmd_color_plot},
     { "debug",          _nirt_cmd_debug},
@@ -2616,6 +2808,7 @@ const struct bu_cmdtab _libanalyze_nirt_cmds[] = {
     { "bot_minpieces",  _nirt_cmd_deprecated},
     { "q",              _nirt_cmd_quit},
     { "s",              _nirt_cmd_shoot},
+    { "space_partition", _nirt_cmd_space_partition},
     { "state",          _nirt_cmd_state},
     { "units",          _nirt_cmd_units},
     { "useair",         _nirt_cmd_use_air},
@@ -2626,6 +2819,22 @@ const struct bu_cmdtab _libanalyze_nirt_cmds[] = {
 
 
 
+/* Commands that can run while shots are queued: shooting, and setting
+ * (not querying) where the next shot aims.  Queued shots report under
+ * the values they were queued with. */
+static bool
+_nirt_batch_cmd(int ac, char **av)
+{
+    static const char *aim_cmds[] = {"xyz", "center", "dir", "ae", "hv", NULL};
+    if (BU_STR_EQUAL(av[0], "s")) return true;
+    if (ac < 2) return false;
+    for (const char **c = aim_cmds; *c; c++) {
+	if (BU_STR_EQUAL(av[0], *c)) return true;
+    }
+    return false;
+}
+
+
 /* Parse command line command and execute */
 static int
 _nirt_exec_cmd(struct nirt_state *ns, const char *cmdstr)
@@ -2691,6 +2900,11 @@ _nirt_exec_cmd(struct nirt_state *ns, const char *cmdstr)
     }
     av[ac] = NULL;
 
+    /* Shots queued in batch mode have to report before any command that
+     * could change what they report, or print something of its own */
+    if (ns->i->batch.size() && !_nirt_batch_cmd(ac, av))
+	(void)_nirt_batch_flush(ns);
+
     if (bu_cmd(_libanalyze_nirt_cmds, ac, (const char **)av, 0, (void *)ns, &ret) != BRLCAD_OK) ret = -1;
 
     for (i = 0; i < ac_max; i++) {
@@ -2897,6 +3111,7 @@ nirt_init(struct nirt_state *ns)
     n->base2local = 0.0;
     n->local2base = 0.0;
     n->use_air = 0;
+    n->space_partition = RT_PART_NUBSPT;
     n->backout = 1;
 
     n->b_state = false;
@@ -2907,11 +3122,13 @@ nirt_init(struct nirt_state *ns)
 
     BU_GET(n->ap, struct application);
     n->dbip = DBI_NULL;
-    BU_GET(n->res, struct resource);
-    BU_GET(n->res_air, struct resource);
+    n->ncpu = bu_avail_cpus();
+    n->res = (struct resource *)bu_calloc(n->ncpu, sizeof(struct resource), "nirt resources");
+    n->res_air = (struct resource *)bu_calloc(n->ncpu, sizeof(struct resource), "nirt air resources");
     n->rtip = RTI_NULL;
     n->rtip_air = RTI_NULL;
     n->need_reprep = 1;
+    n->batch_size = 0;
 
     BU_GET(n->val_types, struct bu_attribute_value_set);
     BU_GET(n->val_docs, struct bu_attribute_value_set);
@@ -3047,6 +3264,11 @@ void
 nirt_destroy(struct nirt_state *ns)
 {
     if (!ns) return;
+
+    /* Report any shots still queued before the model goes away */
+    if (ns->i->batch.size())
+	(void)_nirt_batch_flush(ns);
+
     bu_vls_free(&ns->nirt_cmd);
     bu_vls_free(ns->i->err);
     bu_vls_free(ns->i->msg);
@@ -3061,8 +3283,8 @@ nirt_destroy(struct nirt_state *ns)
 
     BU_PUT(ns->i->vals, struct nirt_output_record);
 
-    BU_PUT(ns->i->res, struct resource);
-    BU_PUT(ns->i->res_air, struct resource);
+    bu_free(ns->i->res, "nirt resources");
+    bu_free(ns->i->res_air, "nirt air resources");
     BU_PUT(ns->i->err, struct bu_vls);
     BU_PUT(ns->i->msg, struct bu_vls);
     BU_PUT(ns->i->out, struct bu_vls);
@@ -287,6 +287,18 @@ struct nirt_output_record {
 };
 
 
+/* A shot queued in batch mode, with the values it reports under */
+struct nirt_batch_ray {
+    point_t orig;	/* backed out */
+    vect_t dir;
+    fastf_t h;
+    fastf_t v;
+    fastf_t d_orig;
+    fastf_t a;
+    fastf_t e;
+};
+
+
 struct nirt_diff_state;
 
 class nirt_fmt_state {
@@ -344,6 +356,7 @@ struct nirt_state_impl {
     int backout;
     int overlap_claims;
     int use_air;
+    int space_partition;
     std::set<std::string> attrs;        // active attributes
     std::vector<std::string> active_paths; // active paths for raytracer
     struct nirt_output_record *vals;
@@ -362,11 +375,16 @@ struct nirt_state_impl {
     struct db_i *dbip;
     /* Note: Parallel structures are needed for operation w/ and w/o air */
     struct rt_i *rtip;
-    struct resource *res;
+    struct resource *res;      // ncpu resources, res[0] for single shots
     struct rt_i *rtip_air;
-    struct resource *res_air;
+    struct resource *res_air;  // ncpu resources, res_air[0] for single shots
+    size_t ncpu;
     int need_reprep;
 
+    /* batch mode - shots are queued and fired together on all cpus */
+    size_t batch_size;
+    std::vector<struct nirt_batch_ray> batch;
+
     /* internal format specifier arrays */
     struct bu_attribute_value_set *val_types;
     struct bu_attribute_value_set *val_docs;
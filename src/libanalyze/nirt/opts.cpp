@@ -73,6 +73,29 @@ decode_overlap(struct bu_vls *msg, size_t argc, const char **argv, void *set_var
 }
 
 
+static int
+decode_space_partition(struct bu_vls *msg, size_t argc, const char **argv, void *set_var)
+{
+    int *pval = (int *)set_var;
+
+    BU_OPT_CHECK_ARGV0(msg, argc, argv, "nirt space partition");
+
+    if (BU_STR_EQUAL(argv[0], "nubsp") || BU_STR_EQUAL(argv[0], "0")) {
+	if (pval) {
+	    (*pval) = RT_PART_NUBSPT;
+	}
+    } else if (BU_STR_EQUAL(argv[0], "bvh") || BU_STR_EQUAL(argv[0], "1")) {
+	if (pval) {
+	    (*pval) = RT_PART_HLBVH;
+	}
+    } else {
+	bu_log("Illegal space_partition specification: '%s'\n", argv[0]);
+	return -1;
+    }
+    return 1;
+}
+
+
 static int
 dequeue_scripts(struct bu_vls *UNUSED(msg), size_t UNUSED(argc), const char **UNUSED(argv), void *set_var)
 {
@@ -189,7 +212,7 @@ nirt_opt_desc(struct nirt_opt_vals *v)
     if (!v)
 	return NULL;
 
-    struct bu_opt_desc *d = (struct bu_opt_desc *)bu_calloc(26, sizeof(struct bu_opt_desc), "opt array");
+    struct bu_opt_desc *d = (struct bu_opt_desc *)bu_calloc(28, sizeof(struct bu_opt_desc), "opt array");
     BU_OPT(d[0],  "h", "help",      "",         NULL,             &v->print_help,     "print help and exit");
     BU_OPT(d[1],  "?", "",          "",         NULL,             &v->print_help,     "print help and exit");
     BU_OPT(d[2],  "A", "",          "n",        &enqueue_attrs,   &v->attrs,          "add attribute_name=n");
@@ -215,7 +238,9 @@ nirt_opt_desc(struct nirt_opt_vals *v)
     BU_OPT(d[22], "", "color_gap",  "r/g/b",    &bu_opt_color,    &v->color_gap,      "Color to use when plotting gaps between segments (default rgb:255/0/255");
     BU_OPT(d[23], "", "color_ovlp", "r/g/b",    &bu_opt_color,    &v->color_ovlp,     "Color to use when plotting overlap segments (default rgb:255/255/255");
     BU_OPT(d[24], "B", "",          "",         NULL,             NULL, "(DEPRECATED, no longer used)");
-    BU_OPT_NULL(d[25]);
+    BU_OPT(d[25], "", "space_partition", "method", &decode_space_partition, &v->space_partition, "space partitioning used for ray tracing (nubsp [default] or bvh)");
+    BU_OPT(d[26], "", "batch",      "n",        &bu_opt_int,      &v->batch_size,     "queue n shots at a time and fire them on all processors");
+    BU_OPT_NULL(d[27]);
 
     return d;
 }
@@ -235,8 +260,10 @@ nirt_opt_vals_reset(struct nirt_opt_vals *v)
     v->read_matrix = opt_defaults.read_matrix;
     v->show_formats = opt_defaults.show_formats;
     v->silent_mode = opt_defaults.silent_mode;
+    v->space_partition = opt_defaults.space_partition;
     v->use_air = opt_defaults.use_air;
     v->verbose_mode = opt_defaults.verbose_mode;
+    v->batch_size = opt_defaults.batch_size;
 
     // Reset colors
     struct bu_color cyan = BU_COLOR_CYAN;
@@ -336,6 +363,22 @@ nirt_opt_mk_args(struct bu_ptbl *tbl, struct nirt_opt_vals *tgt, struct nirt_opt
 	bu_ptbl_ins(tbl, (long *)str);
     }
 
+    if (src->space_partition != tgt->space_partition) {
+	str = bu_strdup("--space_partition");
+	bu_ptbl_ins(tbl, (long *)str);
+	bu_vls_sprintf(&tmp, "%d", tgt->space_partition);
+	str = bu_strdup(bu_vls_cstr(&tmp));
+	bu_ptbl_ins(tbl, (long *)str);
+    }
+
+    if (src->batch_size != tgt->batch_size) {
+	str = bu_strdup("--batch");
+	bu_ptbl_ins(tbl, (long *)str);
+	bu_vls_sprintf(&tmp, "%d", tgt->batch_size);
+	str = bu_strdup(bu_vls_cstr(&tmp));
+	bu_ptbl_ins(tbl, (long *)str);
+    }
+
     if (src->overlap_claims != tgt->overlap_claims) {
 	str = bu_strdup("-O");
 	bu_ptbl_ins(tbl, (long *)str);
@@ -0,0 +1,250 @@
+/*                      S H O T L I N E . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file shotline.c
+ *
+ * Shoot batches of independent rays in parallel, keeping the
+ * partitions of each in its own record.
+ *
+ */
+#include "common.h"
+
+#include <string.h> /* for memset */
+
+#include "vmath.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/parallel.h"
+#include "raytrace.h"
+#include "analyze.h"
+
+/* rays handed to a thread at a time */
+#define SHOTLINE_CHUNK 64
+
+struct shotline_state {
+    struct rt_i *rtip;
+    struct resource *resp;
+    struct analyze_shotline *shots;
+    size_t nshots;
+    size_t next;	/* first ray not yet handed out */
+    int ovlp;
+};
+
+
+static void
+shotline_free_parts(struct analyze_shotline *s)
+{
+    size_t i;
+
+    for (i = 0; i < s->npart; i++) {
+	if (s->parts[i].claimants)
+	    bu_free(s->parts[i].claimants, "shotline claimants");
+    }
+    if (s->parts)
+	bu_free(s->parts, "shotline parts");
+    s->npart = 0;
+    s->parts = NULL;
+}
+
+
+void
+analyze_shotline_parts(struct analyze_shotline *s, struct application *ap, struct partition *part_head)
+{
+    struct partition *pp;
+    struct analyze_shot_part *p;
+    struct region **rpp;
+    size_t n = 0;
+
+    for (pp = part_head->pt_forw; pp != part_head; pp = pp->pt_forw)
+	n++;
+
+    shotline_free_parts(s);
+    if (!n)
+	return;
+
+    s->npart = n;
+    s->parts = (struct analyze_shot_part *)bu_calloc(n, sizeof(struct analyze_shot_part), "shotline parts");
+    for (pp = part_head->pt_forw, p = s->parts; pp != part_head; pp = pp->pt_forw, p++) {
+	/* the normal routines fill in the hit points as well */
+	RT_HIT_NORMAL(p->in_norm, pp->pt_inhit, pp->pt_inseg->seg_stp, &ap->a_ray, pp->pt_inflip);
+	RT_HIT_NORMAL(p->out_norm, pp->pt_outhit, pp->pt_outseg->seg_stp, &ap->a_ray, pp->pt_outflip);
+
+	p->regp = pp->pt_regionp;
+	p->in_stp = pp->pt_inseg->seg_stp;
+	p->out_stp = pp->pt_outseg->seg_stp;
+	p->in_dist = pp->pt_inhit->hit_dist;
+	p->out_dist = pp->pt_outhit->hit_dist;
+	VMOVE(p->in_pt, pp->pt_inhit->hit_point);
+	VMOVE(p->out_pt, pp->pt_outhit->hit_point);
+	p->in_surfno = pp->pt_inhit->hit_surfno;
+	p->out_surfno = pp->pt_outhit->hit_surfno;
+
+	if (pp->pt_overlap_reg) {
+	    for (n = 0, rpp = pp->pt_overlap_reg; *rpp != REGION_NULL; rpp++)
+		n++;
+	    p->claimants = (struct region **)bu_calloc(n + 1, sizeof(struct region *), "shotline claimants");
+	    for (n = 0, rpp = pp->pt_overlap_reg; *rpp != REGION_NULL; rpp++)
+		p->claimants[n++] = *rpp;
+	}
+    }
+}
+
+
+static int
+shotline_hit(struct application *ap, struct partition *part_head, struct seg *UNUSED(segs))
+{
+    if (ap->a_user == ANALYZE_SHOT_OVLP_REBUILD_FASTGEN) {
+	rt_rebuild_overlaps(part_head, ap, 1);
+    } else if (ap->a_user == ANALYZE_SHOT_OVLP_REBUILD_ALL) {
+	rt_rebuild_overlaps(part_head, ap, 0);
+    }
+
+    analyze_shotline_parts((struct analyze_shotline *)ap->a_uptr, ap, part_head);
+    return 1;
+}
+
+
+static int
+shotline_miss(struct application *UNUSED(ap))
+{
+    return 0;
+}
+
+
+static int
+shotline_overlap(struct application *ap, struct partition *pp, struct region *reg1, struct region *reg2, struct partition *InputHdp)
+{
+    struct analyze_shotline *s = (struct analyze_shotline *)ap->a_uptr;
+    struct analyze_shot_ovlp *o;
+
+    s->ovlps = (struct analyze_shot_ovlp *)bu_realloc(s->ovlps, (s->novlp + 1) * sizeof(struct analyze_shot_ovlp), "shotline ovlps");
+    o = &s->ovlps[s->novlp++];
+    o->reg1 = reg1;
+    o->reg2 = reg2;
+    o->in_dist = pp->pt_inhit->hit_dist;
+    o->out_dist = pp->pt_outhit->hit_dist;
+    VJOIN1(o->in_pt, ap->a_ray.r_pt, o->in_dist, ap->a_ray.r_dir);
+    VJOIN1(o->out_pt, ap->a_ray.r_pt, o->out_dist, ap->a_ray.r_dir);
+
+    return rt_defoverlap(ap, pp, reg1, reg2, InputHdp);
+}
+
+
+static void
+shotline_worker(int cpu, void *ptr)
+{
+    struct shotline_state *state = (struct shotline_state *)ptr;
+    struct application ap;
+    size_t i, start, end;
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = state->rtip;
+    ap.a_resource = &state->resp[cpu];
+    ap.a_hit = shotline_hit;
+    ap.a_miss = shotline_miss;
+    ap.a_overlap = shotline_overlap;
+    ap.a_logoverlap = rt_silent_logoverlap;
+    ap.a_onehit = 0;
+    ap.a_user = state->ovlp;
+    ap.a_purpose = "shotline";
+
+    while (1) {
+	bu_semaphore_acquire(RT_SEM_WORKER);
+	start = state->next;
+	state->next += SHOTLINE_CHUNK;
+	bu_semaphore_release(RT_SEM_WORKER);
+
+	if (start >= state->nshots)
+	    break;
+	end = FMIN(start + SHOTLINE_CHUNK, state->nshots);
+
+	for (i = start; i < end; i++) {
+	    ap.a_uptr = (void *)&state->shots[i];
+	    VMOVE(ap.a_ray.r_pt, state->shots[i].ray.r_pt);
+	    VMOVE(ap.a_ray.r_dir, state->shots[i].ray.r_dir);
+	    (void)rt_shootray(&ap);
+	}
+    }
+}
+
+
+int
+analyze_shotlines(struct rt_i *rtip, struct resource *resp, size_t ncpu, struct analyze_shotline *shots, size_t nshots, int ovlp)
+{
+    struct shotline_state state;
+    size_t i;
+
+    if (!rtip || !resp || !ncpu || (nshots && !shots))
+	return -1;
+    RT_CK_RTI(rtip);
+
+    /* only the rays are read, so callers need not zero the records */
+    for (i = 0; i < nshots; i++) {
+	shots[i].npart = 0;
+	shots[i].parts = NULL;
+	shots[i].novlp = 0;
+	shots[i].ovlps = NULL;
+    }
+    if (!nshots)
+	return 0;
+
+    if (rtip->needprep)
+	rt_prep_parallel(rtip, ncpu);
+
+    state.rtip = rtip;
+    state.resp = resp;
+    state.shots = shots;
+    state.nshots = nshots;
+    state.next = 0;
+    state.ovlp = ovlp;
+
+    /* no point waking threads with nothing to hand them */
+    if (ncpu > (nshots + SHOTLINE_CHUNK - 1) / SHOTLINE_CHUNK)
+	ncpu = (nshots + SHOTLINE_CHUNK - 1) / SHOTLINE_CHUNK;
+
+    bu_parallel(shotline_worker, ncpu, (void *)&state);
+
+    return 0;
+}
+
+
+void
+analyze_shotlines_free(struct analyze_shotline *shots, size_t nshots)
+{
+    size_t i;
+
+    for (i = 0; i < nshots; i++) {
+	shotline_free_parts(&shots[i]);
+	if (shots[i].ovlps)
+	    bu_free(shots[i].ovlps, "shotline ovlps");
+	shots[i].novlp = 0;
+	shots[i].ovlps = NULL;
+    }
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
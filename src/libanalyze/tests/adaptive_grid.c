@@ -0,0 +1,128 @@
+/*                  A D A P T I V E _ G R I D . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file adaptive_grid.c
+ *
+ * Integrate the thickness of an analytic sphere with the adaptive
+ * grid and check the volume, the weights and the error estimate.
+ */
+
+#include "common.h"
+
+#include <math.h>
+
+#include "bu/app.h"
+#include "bu/log.h"
+#include "vmath.h"
+#include "analyze.h"
+
+
+#define RADIUS 3.7
+#define SPAN 10.0
+
+
+static void
+sphere_shot(const struct xray *rayp, struct adaptive_grid_sample *s)
+{
+    fastf_t du = rayp->r_pt[X] - SPAN * 0.5;
+    fastf_t dv = rayp->r_pt[Y] - SPAN * 0.5;
+    fastf_t d_sq = du*du + dv*dv;
+
+    s->regions = 0;
+    s->thickness = 0.0;
+    s->overlap = 0;
+    if (d_sq < RADIUS * RADIUS) {
+	s->regions = 1;
+	s->thickness = 2.0 * sqrt(RADIUS * RADIUS - d_sq);
+    }
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    point_t origin = VINIT_ZERO;
+    vect_t u_dir = {1.0, 0.0, 0.0};
+    vect_t v_dir = {0.0, 1.0, 0.0};
+    vect_t ray_dir = {0.0, 0.0, 1.0};
+    struct adaptive_grid *grid;
+    struct adaptive_grid_stats stats;
+    struct adaptive_grid_sample s;
+    struct xray ray;
+    size_t sample, uniform_rays;
+    fastf_t weight, cell_scale;
+    fastf_t len = 0.0, area = 0.0, volume, exact, err;
+    int ret = 0;
+
+    bu_setprogname(argv[0]);
+    if (argc != 1)
+	bu_exit(1, "Usage: %s\n", argv[0]);
+
+    grid = adaptive_grid_create(origin, u_dir, v_dir, ray_dir, SPAN, SPAN, 8, 8, 0.01, 0.01);
+    do {
+	while (!adaptive_grid_next_ray(grid, &ray, &sample, &weight, &cell_scale)) {
+	    sphere_shot(&ray, &s);
+	    adaptive_grid_record(grid, sample, &s);
+	    len += s.thickness * weight;
+	    area += weight;
+	}
+    } while (adaptive_grid_refine(grid));
+    adaptive_grid_stats(grid, &stats);
+    adaptive_grid_destroy(grid);
+
+    volume = len * stats.u_size * stats.v_size;
+    exact = 4.0 / 3.0 * M_PI * RADIUS * RADIUS * RADIUS;
+    err = fabs(volume - exact);
+    uniform_rays = stats.cells * (size_t)pow(9.0, stats.level);
+
+    bu_log("volume %g (exact %g, error %g, estimated %g)\n", volume, exact, err, stats.error);
+    bu_log("%zu rays, %zu leaves, %zu unresolved, level %d of %d (%zu rays uniform)\n",
+	   stats.rays, stats.leaves, stats.unresolved, stats.level, stats.max_level, uniform_rays);
+
+    /* the leaves must tile the view exactly */
+    if (!NEAR_EQUAL(area, (fastf_t)stats.cells, 1.0e-9)) {
+	bu_log("FAILED: leaf weights sum to %g, expected %zu\n", area, stats.cells);
+	ret = 1;
+    }
+    if (err > 1.0e-3 * exact) {
+	bu_log("FAILED: volume error %g too large\n", err);
+	ret = 1;
+    }
+    if (err > 4.0 * stats.error) {
+	bu_log("FAILED: error %g not bounded by estimate %g\n", err, stats.error);
+	ret = 1;
+    }
+    if (stats.rays * 4 > uniform_rays) {
+	bu_log("FAILED: %zu rays is not much below a uniform %zu\n", stats.rays, uniform_rays);
+	ret = 1;
+    }
+
+    return ret;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,161 @@
+/*                     S H O T L I N E S . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file shotlines.c
+ *
+ * Shoot a grid of rays through an object with analyze_shotlines() and
+ * check every record against the same ray shot on its own.
+ */
+
+#include "common.h"
+
+#include <string.h>
+
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/parallel.h"
+#include "raytrace.h"
+#include "analyze.h"
+#include "../analyze_private.h"
+
+
+static int
+single_hit(struct application *ap, struct partition *part_head, struct seg *UNUSED(segs))
+{
+    analyze_shotline_parts((struct analyze_shotline *)ap->a_uptr, ap, part_head);
+    return 1;
+}
+
+
+static int
+single_miss(struct application *UNUSED(ap))
+{
+    return 0;
+}
+
+
+int
+main(int argc, char **argv)
+{
+    struct bn_tol rtol = {BN_TOL_MAGIC, 10, 0.5 * 0.5, 1.0e-6, 1.0 - 1.0e-6 };
+    struct analyze_shotline *shots, single;
+    struct application ap;
+    struct resource *resp;
+    struct db_i *dbip;
+    struct rt_i *rtip;
+    fastf_t *rays = NULL;
+    size_t ncpus = bu_avail_cpus();
+    size_t i, j, nshots, nhit = 0;
+    int fails = 0;
+
+    bu_setprogname(argv[0]);
+
+    if (argc != 3)
+	bu_exit(1, "Usage: %s file.g object\n", argv[0]);
+
+    if ((dbip = db_open(argv[1], DB_OPEN_READONLY)) == DBI_NULL)
+	bu_exit(1, "Cannot open geometry database file %s\n", argv[1]);
+    if (db_dirbuild(dbip) < 0)
+	bu_exit(1, "db_dirbuild failed on geometry database file %s\n", argv[1]);
+
+    rtip = rt_new_rti(dbip);
+    resp = (struct resource *)bu_calloc(ncpus, sizeof(struct resource), "resources");
+    for (i = 0; i < ncpus; i++)
+	rt_init_resource(&resp[i], (int)i, rtip);
+    if (rt_gettree(rtip, argv[2]) < 0)
+	bu_exit(1, "rt_gettree failed on %s\n", argv[2]);
+    rt_prep_parallel(rtip, ncpus);
+
+    nshots = (size_t)analyze_get_bbox_rays(&rays, rtip->mdl_min, rtip->mdl_max, &rtol);
+    if (!nshots)
+	bu_exit(1, "no rays generated for %s\n", argv[2]);
+
+    /* left uninitialized on purpose, only the rays are filled in */
+    shots = (struct analyze_shotline *)bu_malloc(nshots * sizeof(struct analyze_shotline), "shots");
+    for (i = 0; i < nshots; i++) {
+	VMOVE(shots[i].ray.r_pt, &rays[6*i]);
+	VMOVE(shots[i].ray.r_dir, &rays[6*i+3]);
+    }
+
+    if (analyze_shotlines(rtip, resp, ncpus, shots, nshots, ANALYZE_SHOT_OVLP_RESOLVE) < 0)
+	bu_exit(1, "analyze_shotlines failed\n");
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_resource = &resp[0];
+    ap.a_hit = single_hit;
+    ap.a_miss = single_miss;
+    ap.a_logoverlap = rt_silent_logoverlap;
+
+    memset(&single, 0, sizeof(struct analyze_shotline));
+    for (i = 0; i < nshots; i++) {
+	ap.a_uptr = (void *)&single;
+	VMOVE(ap.a_ray.r_pt, shots[i].ray.r_pt);
+	VMOVE(ap.a_ray.r_dir, shots[i].ray.r_dir);
+	analyze_shotlines_free(&single, 1);
+	(void)rt_shootray(&ap);
+
+	if (single.npart)
+	    nhit++;
+	if (single.npart != shots[i].npart) {
+	    bu_log("FAILED: ray %zu: %zu partitions, %zu shot alone\n", i, shots[i].npart, single.npart);
+	    fails++;
+	    continue;
+	}
+	for (j = 0; j < single.npart; j++) {
+	    if (single.parts[j].regp != shots[i].parts[j].regp
+		|| !NEAR_EQUAL(single.parts[j].in_dist, shots[i].parts[j].in_dist, SMALL_FASTF)
+		|| !NEAR_EQUAL(single.parts[j].out_dist, shots[i].parts[j].out_dist, SMALL_FASTF)
+		|| !VNEAR_EQUAL(single.parts[j].in_norm, shots[i].parts[j].in_norm, SMALL_FASTF)) {
+		bu_log("FAILED: ray %zu partition %zu differs from the ray shot alone\n", i, j);
+		fails++;
+		break;
+	    }
+	}
+    }
+
+    if (!nhit) {
+	bu_log("FAILED: no ray hit %s\n", argv[2]);
+	fails++;
+    }
+    bu_log("%zu rays, %zu hits, %d failed\n", nshots, nhit, fails);
+
+    analyze_shotlines_free(&single, 1);
+    analyze_shotlines_free(shots, nshots);
+    bu_free(shots, "shots");
+    bu_free(rays, "rays");
+    rt_free_rti(rtip);
+    bu_free(resp, "resources");
+    db_close(dbip);
+
+    return fails != 0;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
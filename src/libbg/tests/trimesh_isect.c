@@ -0,0 +1,111 @@
+/*                   T R I M E S H _ I S E C T . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+
+#include "common.h"
+
+#include <stdio.h>
+
+#include "bu.h"
+#include "bg.h"
+
+/* Outward facing (CCW) triangles of a box with the vertex order below */
+static int box_faces[] = {
+    0,2,1, 0,3,2,	/* -Z */
+    4,5,6, 4,6,7,	/* +Z */
+    0,1,5, 0,5,4,	/* -Y */
+    3,7,6, 3,6,2,	/* +Y */
+    0,4,7, 0,7,3,	/* -X */
+    1,2,6, 1,6,5	/* +X */
+};
+
+static void
+mk_box(point_t *v, fastf_t x0, fastf_t y0, fastf_t z0, fastf_t x1, fastf_t y1, fastf_t z1)
+{
+    VSET(v[0], x0, y0, z0);
+    VSET(v[1], x1, y0, z0);
+    VSET(v[2], x1, y1, z0);
+    VSET(v[3], x0, y1, z0);
+    VSET(v[4], x0, y0, z1);
+    VSET(v[5], x1, y0, z1);
+    VSET(v[6], x1, y1, z1);
+    VSET(v[7], x0, y1, z1);
+}
+
+static int
+check(const char *name, point_t *v2, int exp_isect, int e_in1, int e_in2, int e_is1, int e_is2)
+{
+    point_t v1[8];
+    int *in1 = NULL, *in2 = NULL, *is1 = NULL, *is2 = NULL;
+    int n_in1 = -1, n_in2 = -1, n_is1 = -1, n_is2 = -1;
+    int ret;
+
+    mk_box(v1, 0, 0, 0, 2, 2, 2);
+
+    ret = bg_trimesh_isect(&in1, &n_in1, &in2, &n_in2, &is1, &n_is1, &is2, &n_is2,
+			   box_faces, 12, v1, 8, box_faces, 12, v2, 8);
+
+    bu_log("%s: ret %d, inside %d/%d, isect %d/%d\n", name, ret, n_in1, n_in2, n_is1, n_is2);
+
+    if (in1) bu_free(in1, "in1");
+    if (in2) bu_free(in2, "in2");
+    if (is1) bu_free(is1, "is1");
+    if (is2) bu_free(is2, "is2");
+
+    if (ret != exp_isect || n_in1 != e_in1 || n_in2 != e_in2 || n_is1 != e_is1 || n_is2 != e_is2) {
+	bu_log("%s: expected ret %d, inside %d/%d, isect %d/%d\n", name, exp_isect, e_in1, e_in2, e_is1, e_is2);
+	return 1;
+    }
+    return 0;
+}
+
+int
+main(int UNUSED(argc), const char **argv)
+{
+    point_t v2[8];
+    int fail = 0;
+
+    bu_setprogname(argv[0]);
+
+    /* Disjoint */
+    mk_box(v2, 5, 5, 5, 6, 6, 6);
+    fail += check("disjoint", v2, 0, 0, 0, 0, 0);
+
+    /* Second box entirely inside the first */
+    mk_box(v2, 0.5, 0.5, 0.5, 1.5, 1.5, 1.5);
+    fail += check("contained", v2, 0, 0, 12, 0, 0);
+
+    /* Second box pokes out through the first box's +X face.  Its -X
+     * face is inside, its four side faces cross the +X face of the
+     * first box, and its +X face is outside. */
+    mk_box(v2, 1, 0.5, 0.5, 3, 1.5, 1.5);
+    fail += check("crossing", v2, 1, 0, 2, 2, 8);
+
+    return (fail) ? 1 : 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -25,56 +25,219 @@
 
 #include "common.h"
 
+#include <algorithm>
+#include <atomic>
+#include <utility>
 #include <vector>
-#include <set>
-#include <map>
-#include <cmath>
-
-#include <float.h>
-#include <locale.h>
-#include <stdarg.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-#include <time.h>
-
-#define PLOT_PREFIX_STR bg_plot3_
-#include "bv/plot3.h"
+
+#include "RTree.h"
+
+#include "vmath.h"
 #include "bu/log.h"
 #include "bu/malloc.h"
-#include "bn/tol.h"
+#include "bu/parallel.h"
+#include "bg/tri_ray.h"
 #include "bg/tri_tri.h"
 #include "bg/trimesh.h"
 
+/* Faces handed to each thread at a time when testing face pairs */
+#define ISECT_CHUNK 1024
+
+typedef RTree<int, double, 3> isect_tree_t;
+
+struct isect_mesh {
+    const int *faces;
+    int num_faces;
+    point_t *verts;
+    point_t bbmin;
+    point_t bbmax;
+};
+
+struct isect_pair_state {
+    const struct isect_mesh *m1;
+    const struct isect_mesh *m2;
+    const std::vector<int> *working;	/* faces of m1 to test */
+    const isect_tree_t *tree2;		/* faces of m2 */
+    std::atomic<size_t> next;
+    std::vector<std::vector<std::pair<int, int>>> found;	/* [cpu] */
+};
+
+
+static void
+face_bbox(double *fmin, double *fmax, const struct isect_mesh *m, int f)
+{
+    point_t bmin, bmax;
+    VSETALL(bmin, MAX_FASTF);
+    VSETALL(bmax, -MAX_FASTF);
+    VMINMAX(bmin, bmax, m->verts[m->faces[3*f+0]]);
+    VMINMAX(bmin, bmax, m->verts[m->faces[3*f+1]]);
+    VMINMAX(bmin, bmax, m->verts[m->faces[3*f+2]]);
+    VMOVE(fmin, bmin);
+    VMOVE(fmax, bmax);
+}
+
+
 static void
-plot_faces(const char *fname, std::set<int> *faces, int *f, point_t *v)
+mesh_tree(isect_tree_t *tree, const struct isect_mesh *m, const std::vector<int> &fset)
+{
+    for (size_t i = 0; i < fset.size(); i++) {
+	double fmin[3], fmax[3];
+	face_bbox(fmin, fmax, m, fset[i]);
+	tree->Insert(fmin, fmax, fset[i]);
+    }
+}
+
+
+/* bu_parallel worker: test each working face of mesh 1 against the mesh 2
+ * faces whose boxes overlap its own. */
+static void
+isect_pairs_worker(int cpu, void *data)
+{
+    struct isect_pair_state *s = (struct isect_pair_state *)data;
+    std::vector<std::pair<int, int>> &found = s->found[cpu];
+    const struct isect_mesh *m1 = s->m1;
+    const struct isect_mesh *m2 = s->m2;
+
+    while (1) {
+	size_t start = s->next.fetch_add(ISECT_CHUNK);
+	if (start >= s->working->size())
+	    break;
+	size_t end = std::min(start + ISECT_CHUNK, s->working->size());
+	for (size_t i = start; i < end; i++) {
+	    int f1 = (*s->working)[i];
+	    double fmin[3], fmax[3];
+	    face_bbox(fmin, fmax, m1, f1);
+	    s->tree2->Search(fmin, fmax, [&](const int &f2, void *) {
+		if (bg_tri_tri_isect(
+			m1->verts[m1->faces[3*f1+0]], m1->verts[m1->faces[3*f1+1]], m1->verts[m1->faces[3*f1+2]],
+			m2->verts[m2->faces[3*f2+0]], m2->verts[m2->faces[3*f2+1]], m2->verts[m2->faces[3*f2+2]]))
+		    found.push_back(std::make_pair(f1, f2));
+		return true;
+	    }, NULL);
+	}
+    }
+}
+
+
+/* Is pt inside mesh m (whose faces are all in tree)?  Counts the crossings of
+ * a ray from pt, tilted off the axes so it is unlikely to graze an edge. */
+static int
+point_inside(const point_t pt, const struct isect_mesh *m, const isect_tree_t *tree)
 {
-    std::set<int>::iterator f_it;
-    FILE* plot_file = fopen(fname, "wb");
-    int r = int(256*drand48() + 100.0);
-    int g = int(256*drand48() + 100.0);
-    int b = int(256*drand48() + 100.0);
-    pl_color(plot_file, r, g, b);
-    for (f_it = faces->begin(); f_it != faces->end(); f_it++) {
-	point_t p1, p2, p3;
-	VMOVE(p1, v[f[(*f_it)*3+0]]);
-	VMOVE(p2, v[f[(*f_it)*3+1]]);
-	VMOVE(p3, v[f[(*f_it)*3+2]]);
-	pdv_3move(plot_file, p1);
-	pdv_3cont(plot_file, p2);
-	pdv_3move(plot_file, p1);
-	pdv_3cont(plot_file, p3);
-	pdv_3move(plot_file, p2);
-	pdv_3cont(plot_file, p3);
-    }
-    fclose(plot_file);
+    vect_t dir;
+    point_t end;
+    double qmin[3], qmax[3];
+    int crossings = 0;
+
+    if (!V3PNT_IN_RPP(pt, m->bbmin, m->bbmax))
+	return 0;
+
+    VSET(dir, 1.0, 0.0137, 0.0071);
+    VUNITIZE(dir);
+    /* Far enough to leave the bounding box */
+    VJOIN1(end, pt, (m->bbmax[X] - pt[X]) / dir[X] + 1.0, dir);
+    VMOVE(qmin, pt);
+    VMOVE(qmax, pt);
+    VMIN(qmin, end);
+    VMAX(qmax, end);
+
+    tree->Search(qmin, qmax, [&](const int &f, void *) {
+	if (bg_isect_tri_ray(pt, dir, m->verts[m->faces[3*f+0]], m->verts[m->faces[3*f+1]], m->verts[m->faces[3*f+2]], NULL))
+	    crossings++;
+	return true;
+    }, NULL);
+
+    return crossings % 2;
+}
+
+
+static int
+uf_find(std::vector<int> &parent, int i)
+{
+    while (parent[i] != i) {
+	parent[i] = parent[parent[i]];
+	i = parent[i];
+    }
+    return i;
+}
+
+
+/* Find the faces of m that are inside mesh o.  Faces that don't intersect o
+ * are grouped into patches that are connected across shared edges without
+ * crossing an intersecting face.  A patch lies entirely on one side of o, so
+ * one point-in-mesh test classifies all of it.  A patch with a face outside
+ * o's bounding box is outside without testing.  This assumes o is a closed
+ * mesh; open meshes are classified by ray parity, which may not mean much. */
+static void
+inside_faces(std::vector<int> &inside, const struct isect_mesh *m, const std::vector<char> &isect, const struct isect_mesh *o, const isect_tree_t *otree)
+{
+    std::vector<int> parent(m->num_faces);
+    for (int i = 0; i < m->num_faces; i++)
+	parent[i] = i;
+
+    /* Sort the edges so faces sharing one are neighbors */
+    std::vector<std::pair<uint64_t, int>> edges;
+    edges.reserve(3 * (size_t)m->num_faces);
+    for (int i = 0; i < m->num_faces; i++) {
+	if (isect[i])
+	    continue;
+	for (int k = 0; k < 3; k++) {
+	    uint64_t a = (uint64_t)(uint32_t)m->faces[3*i+k];
+	    uint64_t b = (uint64_t)(uint32_t)m->faces[3*i+(k+1)%3];
+	    uint64_t key = (a < b) ? (a << 32 | b) : (b << 32 | a);
+	    edges.push_back(std::make_pair(key, i));
+	}
+    }
+    std::sort(edges.begin(), edges.end());
+    for (size_t i = 1; i < edges.size(); i++) {
+	if (edges[i].first != edges[i-1].first)
+	    continue;
+	int r1 = uf_find(parent, edges[i].second);
+	int r2 = uf_find(parent, edges[i-1].second);
+	if (r1 != r2)
+	    parent[r1] = r2;
+    }
+
+    /* -1 unknown, 0 outside, 1 inside, indexed by patch root */
+    std::vector<signed char> state(m->num_faces, -1);
+    for (int i = 0; i < m->num_faces; i++) {
+	if (isect[i])
+	    continue;
+	double fmin[3], fmax[3];
+	face_bbox(fmin, fmax, m, i);
+	if (V3RPP_DISJOINT(fmin, fmax, o->bbmin, o->bbmax))
+	    state[uf_find(parent, i)] = 0;
+    }
+    for (int i = 0; i < m->num_faces; i++) {
+	if (isect[i])
+	    continue;
+	int r = uf_find(parent, i);
+	if (state[r] < 0) {
+	    point_t c;
+	    VADD3(c, m->verts[m->faces[3*i+0]], m->verts[m->faces[3*i+1]], m->verts[m->faces[3*i+2]]);
+	    VSCALE(c, c, 1.0/3.0);
+	    state[r] = (signed char)point_inside(c, o, otree);
+	}
+	if (state[r] == 1)
+	    inside.push_back(i);
+    }
 }
 
-/* For NURBS refinement, we do this once and keep the set of "inside" faces from
- * each mesh.  If any of the vertices from those faces are still inside after a
- * refinement and remeshing step, they are either genuinely inside the mesh (bad
- * NURBS geometry) or our closestpoint routines haven't found the right match. */
+
+static void
+set_output(int **oarray, int *ocnt, const std::vector<int> &v)
+{
+    if (ocnt)
+	(*ocnt) = (int)v.size();
+    if (!oarray)
+	return;
+    (*oarray) = NULL;
+    if (!v.size())
+	return;
+    (*oarray) = (int *)bu_calloc(v.size(), sizeof(int), "trimesh isect faces");
+    for (size_t i = 0; i < v.size(); i++)
+	(*oarray)[i] = v[i];
+}
 
 
 /* See Mesh Arrangements for Solid Geometry - this implements the initial stages
@@ -87,160 +250,125 @@ bg_trimesh_isect(
     int *faces_1, int num_faces_1, point_t *vertices_1, int num_vertices_1,
     int *faces_2, int num_faces_2, point_t *vertices_2, int num_vertices_2)
 {
-    int ret = 0;
+    std::vector<int> empty;
+    set_output(faces_inside_1, num_faces_inside_1, empty);
+    set_output(faces_inside_2, num_faces_inside_2, empty);
+    set_output(faces_isect_1, num_faces_isect_1, empty);
+    set_output(faces_isect_2, num_faces_isect_2, empty);
+
     if (!faces_1 || !num_faces_1 || !vertices_1 || !num_vertices_1) return 0;
     if (!faces_2 || !num_faces_2 || !vertices_2 || !num_vertices_2) return 0;
 
-    /* TODO - check solidity.  If these aren't both valid/solid, this test
-     * won't (currently) handle it */
-
+    /* TODO - check solidity.  If these aren't both valid/solid, the inside
+     * classification won't be meaningful */
 
     /* Step 1 - construct and check bboxes.  If they don't overlap, there's no
      * need for any further work. */
+    struct isect_mesh m1 = {faces_1, num_faces_1, vertices_1, VINIT_ZERO, VINIT_ZERO};
+    struct isect_mesh m2 = {faces_2, num_faces_2, vertices_2, VINIT_ZERO, VINIT_ZERO};
 
-    point_t bb1min, bb2min;
-    point_t bb1max, bb2max;
-
-    VSETALL(bb1min, MAX_FASTF);
-    VSETALL(bb2min, MAX_FASTF);
-    VSETALL(bb1max, -1.0*MAX_FASTF);
-    VSETALL(bb2max, -1.0*MAX_FASTF);
+    VSETALL(m1.bbmin, MAX_FASTF);
+    VSETALL(m2.bbmin, MAX_FASTF);
+    VSETALL(m1.bbmax, -1.0*MAX_FASTF);
+    VSETALL(m2.bbmax, -1.0*MAX_FASTF);
 
     for (int i = 0; i < num_vertices_1; i++) {
-	VMINMAX(bb1min, bb1max, vertices_1[i]);
+	VMINMAX(m1.bbmin, m1.bbmax, vertices_1[i]);
     }
 
     for (int i = 0; i < num_vertices_2; i++) {
-	VMINMAX(bb2min, bb2max, vertices_2[i]);
-    }
-
-    int isect = (
-	(bb1min[0] <= bb2max[0] && bb1max[0] >= bb2min[0]) &&
-	(bb1min[1] <= bb2max[1] && bb1max[1] >= bb2min[1]) &&
-	(bb1min[2] <= bb2max[2] && bb1max[2] >= bb2min[2])
-	) ? 1 : 0;
-
-    if (!isect) {
-	if (num_faces_inside_1) (*num_faces_inside_1) = 0;
-	if (num_faces_inside_2) (*num_faces_inside_2) = 0;
-	if (num_faces_isect_1) (*num_faces_isect_1) = 0;
-	if (num_faces_isect_2) (*num_faces_isect_2) = 0;
-	if (faces_inside_1) (*faces_inside_1) = NULL;
-	if (faces_inside_2) (*faces_inside_2) = NULL;
-	if (faces_isect_1) (*faces_isect_1) = NULL;
-	if (faces_isect_2) (*faces_isect_2) = NULL;
-	return 0;
+	VMINMAX(m2.bbmin, m2.bbmax, vertices_2[i]);
     }
 
-    /*if (!isect) {
-      bu_log("in bbox1.s rpp %f %f %f %f %f %f\n", bb1min[0], bb1max[0], bb1min[1], bb1max[1], bb1min[2], bb1max[2]);
-      bu_log("in bbox2.s rpp %f %f %f %f %f %f\n", bb2min[0], bb2max[0], bb2min[1], bb2max[1], bb2min[2], bb2max[2]);
-      }*/
+    if (V3RPP_DISJOINT(m1.bbmin, m1.bbmax, m2.bbmin, m2.bbmax))
+	return 0;
 
-    /* If the bboxes overlap, build the sets of faces with at least one vertex in the
-     * other mesh's bounding box.  Those are the only ones we need to worry about */
+    /* Step 2 - the only faces that can intersect the other mesh are those
+     * whose boxes overlap the other mesh's box. */
     std::vector<int> m1_working_faces;
     std::vector<int> m2_working_faces;
-
     for (int i = 0; i < num_faces_1; i++) {
-
-	if (V3PNT_IN_RPP(vertices_1[faces_1[3*i]], bb2min, bb2max)) {
+	double fmin[3], fmax[3];
+	face_bbox(fmin, fmax, &m1, i);
+	if (!V3RPP_DISJOINT(fmin, fmax, m2.bbmin, m2.bbmax))
 	    m1_working_faces.push_back(i);
-	    continue;
-	}
-
-	if (V3PNT_IN_RPP(vertices_1[faces_1[3*i+1]], bb2min, bb2max)) {
-	    m1_working_faces.push_back(i);
-	    continue;
-	}
-
-	if (V3PNT_IN_RPP(vertices_1[faces_1[3*i+2]], bb2min, bb2max)) {
-	    m1_working_faces.push_back(i);
-	    continue;
-	}
-
     }
-
     for (int i = 0; i < num_faces_2; i++) {
-
-	if (V3PNT_IN_RPP(vertices_2[faces_2[3*i]], bb1min, bb1max)) {
-	    m2_working_faces.push_back(i);
-	    continue;
-	}
-
-	if (V3PNT_IN_RPP(vertices_2[faces_2[3*i+1]], bb1min, bb1max)) {
-	    m2_working_faces.push_back(i);
-	    continue;
-	}
-
-	if (V3PNT_IN_RPP(vertices_2[faces_2[3*i+2]], bb1min, bb1max)) {
+	double fmin[3], fmax[3];
+	face_bbox(fmin, fmax, &m2, i);
+	if (!V3RPP_DISJOINT(fmin, fmax, m1.bbmin, m1.bbmax))
 	    m2_working_faces.push_back(i);
-	    continue;
-	}
-
     }
 
-    bu_log("m1_working_faces size: %zd\n", m1_working_faces.size());
-    bu_log("m2_working_faces size: %zd\n", m2_working_faces.size());
-
-    /* For each "working" face in faces_1, check it against "working" faces in
-     * face_2 for intersections.  IFF it intersects, add it and the other face
-     * to their intersects set.
-     *
-     * TODO - this is the naive NxM implementation - it can undoubtedly be improved
-     * upon with one form or another of acceleration structure - but for now
-     * we're after simple and working.  Once this is established to be a
-     * performance bottleneck we can dig deeper into it. */
-    std::set<int> m1_intersecting_faces;
-    std::set<int> m2_intersecting_faces;
-    for (size_t i = 0; i < m1_working_faces.size(); i++) {
-	for (size_t j = 0; j < m2_working_faces.size(); j++) {
-	    int v1_1 = faces_1[3*m1_working_faces[i]];
-	    int v1_2 = faces_1[3*m1_working_faces[i]+1];
-	    int v1_3 = faces_1[3*m1_working_faces[i]+2];
-	    int v2_1 = faces_2[3*m2_working_faces[j]];
-	    int v2_2 = faces_2[3*m2_working_faces[j]+1];
-	    int v2_3 = faces_2[3*m2_working_faces[j]+2];
-	    if (bg_tri_tri_isect(
-		    vertices_1[v1_1], vertices_1[v1_2], vertices_1[v1_3],
-		    vertices_2[v2_1], vertices_2[v2_2], vertices_2[v2_3]))
-	    {
-		m1_intersecting_faces.insert(m1_working_faces[i]);
-		m2_intersecting_faces.insert(m2_working_faces[j]);
-	    }
+    /* Step 3 - index the mesh 2 faces in an R-tree and, in parallel, test each
+     * mesh 1 working face only against the mesh 2 faces whose boxes overlap
+     * its own.  The inside classification casts rays against all of the other
+     * mesh, so when it is wanted the trees hold every face. */
+    int want_inside = (faces_inside_1 || num_faces_inside_1 || faces_inside_2 || num_faces_inside_2);
+    std::vector<int> all_faces_2;
+    if (want_inside) {
+	all_faces_2.resize(num_faces_2);
+	for (int i = 0; i < num_faces_2; i++)
+	    all_faces_2[i] = i;
+    }
+    isect_tree_t tree2;
+    mesh_tree(&tree2, &m2, want_inside ? all_faces_2 : m2_working_faces);
+
+    size_t ncpu = bu_avail_cpus();
+    struct isect_pair_state s;
+    s.m1 = &m1;
+    s.m2 = &m2;
+    s.working = &m1_working_faces;
+    s.tree2 = &tree2;
+    s.next = 0;
+    s.found.resize(ncpu);
+    bu_parallel(isect_pairs_worker, ncpu, &s);
+
+    std::vector<char> m1_isect(num_faces_1, 0);
+    std::vector<char> m2_isect(num_faces_2, 0);
+    int have_isect = 0;
+    for (size_t i = 0; i < s.found.size(); i++) {
+	for (size_t j = 0; j < s.found[i].size(); j++) {
+	    m1_isect[s.found[i][j].first] = 1;
+	    m2_isect[s.found[i][j].second] = 1;
+	    have_isect = 1;
 	}
     }
 
-    bu_log("m1_intersecting_faces size: %zd\n", m1_intersecting_faces.size());
-
-    plot_faces("m1.plot3", &m1_intersecting_faces, faces_1, vertices_1);
-
-    bu_log("m2_intersecting_faces size: %zd\n", m2_intersecting_faces.size());
-
-    plot_faces("m2.plot3", &m2_intersecting_faces, faces_2, vertices_2);
-
-
-#if 0
+    std::vector<int> m1_intersecting_faces;
+    std::vector<int> m2_intersecting_faces;
+    for (int i = 0; i < num_faces_1; i++) {
+	if (m1_isect[i])
+	    m1_intersecting_faces.push_back(i);
+    }
+    for (int i = 0; i < num_faces_2; i++) {
+	if (m2_isect[i])
+	    m2_intersecting_faces.push_back(i);
+    }
+    set_output(faces_isect_1, num_faces_isect_1, m1_intersecting_faces);
+    set_output(faces_isect_2, num_faces_isect_2, m2_intersecting_faces);
 
-    /* From the set of intersecting faces in each face, characterize the vertices
-     * of the face as inside or outside the other faces via the face normals (we
-     * are assuming CCW meshes with correct outward facing normals.)  Based on those
-     * vertex characterizations, look up other faces associated with those vertices.
-     * If those faces are not intersecting faces and are in the working_faces set,
-     * characterize them according to the vertex status and pull the other faces
-     * associated with that faces vertices that are not intersecting faces for
-     * processing.  In essence, we "walk" the mesh until all triangles are
-     * accounted for as either intersecting, inside the other mesh, or outside
-     * the mesh.
-     *
-     * This will work ONLY on valid solid meshes.  Anything else will need
+    /* Step 4 - characterize the faces that don't intersect as inside or
+     * outside the other mesh.  See inside_faces() - this works ONLY on valid
+     * solid meshes.  Anything else will need something like
      * https://github.com/sideeffects/WindingNumber for an inside/outside
      * determination... */
-    std::set<int> m1_inside_m2_faces;
-    std::set<int> m2_inside_m1_faces;
-#endif
+    if (want_inside) {
+	std::vector<int> all_faces_1(num_faces_1);
+	for (int i = 0; i < num_faces_1; i++)
+	    all_faces_1[i] = i;
+	isect_tree_t tree1;
+	mesh_tree(&tree1, &m1, all_faces_1);
+
+	std::vector<int> m1_inside_m2_faces;
+	std::vector<int> m2_inside_m1_faces;
+	inside_faces(m1_inside_m2_faces, &m1, m1_isect, &m2, &tree2);
+	inside_faces(m2_inside_m1_faces, &m2, m2_isect, &m1, &tree1);
+	set_output(faces_inside_1, num_faces_inside_1, m1_inside_m2_faces);
+	set_output(faces_inside_2, num_faces_inside_2, m2_inside_m1_faces);
+    }
 
-    return ret;
+    return have_isect;
 }
 
 // Local Variables:
@@ -22,11 +22,14 @@
 /** @file libbg/vert_tree.c
  *
  * @brief
- * Routines to manage a binary search tree of vertices.
+ * Routines to manage a spatial hash of vertices.
  *
  * The actual vertices are stored in an array
  * for convenient use by routines such as "mk_bot".
- * The binary search tree stores indices into the array.
+ * The hash maps tolerance sized cells of space to chains of
+ * indices into the array, so a lookup only has to visit the
+ * 27 cells around the new vertex no matter how many vertices
+ * have already been added.
  *
  */
 
@@ -45,38 +48,226 @@
 #include "bg/vert_tree.h"
 
 
-#define VERT_BLOCK 512 /**< @brief number of vertices to malloc per call when building the array */
+#define VERT_BLOCK 512 /**< @brief initial number of vertices to malloc when building the array */
+#define VERT_HASH_BLOCK 1024 /**< @brief initial number of hash buckets, must be a power of two */
+#define VERT_HASH_MIN_CELL 1.0e-6 /**< @brief smallest cell size, used for exact (zero tolerance) welding */
+#define VERT_HASH_MAX_CELL_INDEX 1.0e18 /**< @brief clamp for cell indices of huge or invalid coordinates */
 
 
 /**
  * Structure to make vertex searching fast.
  *
- * Each leaf represents a vertex, and has an index into
- *   the vertices array ("the_array")
- *
- * Each node is a cutting plane at the "cut_val" on
- *   the "coord" (0, 1, or 2) axis.
- *
- * All vertices with "coord" value less than the "cut_val" are in the "lower"
- * subtree, others are in the "higher".
+ * Space is divided into cubic cells with an edge length of at least
+ * the welding tolerance, so any vertex within tolerance of a new one
+ * lies in the new vertex's cell or one of its 26 neighbors.  Cells
+ * are hashed into "buckets", each of which heads a chain of vertex
+ * indices linked through "next".  Chain links store index + 1 so
+ * that zero can mark the end of a chain.
  */
-union vert_tree {
-    char type;		/* type - leaf or node */
-    struct vert_leaf {
-	char type;
-	size_t index;	/* index into the array */
-    } vleaf;
-    struct vert_node {
-	char type;
-	double cut_val; /* cutting value */
-	size_t coord;	/* cutting coordinate */
-	union vert_tree *higher, *lower;	/* subtrees */
-    } vnode;
+struct bg_vert_hash {
+    fastf_t cell;	/* edge length of a cell */
+    size_t nbuckets;	/* number of buckets, always a power of two */
+    size_t *buckets;	/* first vertex (index + 1) in each bucket */
+    size_t *next;	/* next vertex (index + 1) in the same bucket */
+    size_t max_next;	/* allocated length of "next" */
 };
 
-/* types for the above "vert_tree" */
-#define VERT_LEAF	'l'
-#define VERT_NODE	'n'
+
+static void
+vert_hash_cell( const struct bg_vert_hash *hash, const fastf_t *vertex, int64_t cell[3] )
+{
+    size_t i;
+
+    for ( i=0; i<3; i++ ) {
+	double c = floor( vertex[i] / hash->cell );
+
+	/* also catches NaN */
+	if ( !(c > -VERT_HASH_MAX_CELL_INDEX) ) {
+	    c = -VERT_HASH_MAX_CELL_INDEX;
+	} else if ( c > VERT_HASH_MAX_CELL_INDEX ) {
+	    c = VERT_HASH_MAX_CELL_INDEX;
+	}
+	cell[i] = (int64_t)c;
+    }
+}
+
+
+static size_t
+vert_hash_bucket( const struct bg_vert_hash *hash, int64_t x, int64_t y, int64_t z )
+{
+    uint64_t key;
+
+    key = ((uint64_t)x * 73856093ULL) ^ ((uint64_t)y * 19349663ULL) ^ ((uint64_t)z * 83492791ULL);
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+
+    return (size_t)(key & (hash->nbuckets - 1));
+}
+
+
+static void
+vert_hash_link( struct bg_vert_hash *hash, const fastf_t *vertex, size_t index )
+{
+    int64_t cell[3];
+    size_t bucket;
+
+    if ( index >= hash->max_next ) {
+	while ( index >= hash->max_next ) {
+	    hash->max_next *= 2;
+	}
+	hash->next = (size_t *)bu_realloc( hash->next, hash->max_next * sizeof( size_t ), "vert hash next" );
+    }
+
+    vert_hash_cell( hash, vertex, cell );
+    bucket = vert_hash_bucket( hash, cell[0], cell[1], cell[2] );
+    hash->next[index] = hash->buckets[bucket];
+    hash->buckets[bucket] = index + 1;
+}
+
+
+/**
+ * (Re)distribute all the vertices currently in the array over
+ * "nbuckets" buckets of cells with edge length "cell".
+ */
+static void
+vert_hash_rebuild( struct bg_vert_tree *tree, size_t stride, fastf_t cell, size_t nbuckets )
+{
+    struct bg_vert_hash *hash = tree->the_tree;
+    size_t i;
+
+    if ( hash->nbuckets != nbuckets ) {
+	bu_free( hash->buckets, "vert hash buckets" );
+	hash->buckets = (size_t *)bu_malloc( nbuckets * sizeof( size_t ), "vert hash buckets" );
+	hash->nbuckets = nbuckets;
+    }
+    memset( hash->buckets, 0, nbuckets * sizeof( size_t ) );
+    hash->cell = cell;
+
+    for ( i=0; i<tree->curr_vert; i++ ) {
+	vert_hash_link( hash, &tree->the_array[i*stride], i );
+    }
+}
+
+
+/**
+ * Make sure the hash exists and its cells are big enough for
+ * "local_tol_sq".  The cell size is set by the first tolerance used
+ * and only ever grows, since a cell larger than the tolerance is
+ * still searched correctly.
+ */
+static struct bg_vert_hash *
+vert_hash_prep( struct bg_vert_tree *tree, size_t stride, fastf_t local_tol_sq )
+{
+    struct bg_vert_hash *hash = tree->the_tree;
+    fastf_t cell = VERT_HASH_MIN_CELL;
+
+    if ( local_tol_sq > cell * cell ) {
+	cell = sqrt( local_tol_sq );
+    }
+
+    if ( !hash ) {
+	BU_ALLOC( hash, struct bg_vert_hash );
+	hash->cell = cell;
+	hash->nbuckets = VERT_HASH_BLOCK;
+	hash->buckets = (size_t *)bu_calloc( hash->nbuckets, sizeof( size_t ), "vert hash buckets" );
+	hash->max_next = tree->max_vert > 0 ? tree->max_vert : VERT_BLOCK;
+	hash->next = (size_t *)bu_malloc( hash->max_next * sizeof( size_t ), "vert hash next" );
+	tree->the_tree = hash;
+    } else if ( cell > hash->cell ) {
+	vert_hash_rebuild( tree, stride, cell, hash->nbuckets );
+    }
+
+    return hash;
+}
+
+
+/**
+ * Search the 27 cells around "vertex" for the closest stored vertex
+ * within tolerance.  Returns its index + 1, or 0 if there is none.
+ */
+static size_t
+vert_hash_find( const struct bg_vert_tree *tree, const struct bg_vert_hash *hash, size_t stride, const fastf_t *vertex, fastf_t local_tol_sq )
+{
+    int64_t cell[3];
+    int64_t dx, dy, dz;
+    size_t found = 0;
+    fastf_t best = local_tol_sq;
+
+    vert_hash_cell( hash, vertex, cell );
+
+    for ( dx=-1; dx<=1; dx++ ) {
+	for ( dy=-1; dy<=1; dy++ ) {
+	    for ( dz=-1; dz<=1; dz++ ) {
+		size_t ptr = hash->buckets[vert_hash_bucket( hash, cell[0]+dx, cell[1]+dy, cell[2]+dz )];
+
+		while ( ptr ) {
+		    const fastf_t *v = &tree->the_array[(ptr-1)*stride];
+		    vect_t diff;
+		    fastf_t d1_sq;
+
+		    VSUB2( diff, vertex, v );
+		    d1_sq = MAGSQ( diff );
+		    if ( d1_sq <= best && (found == 0 || d1_sq < best || ptr < found) ) {
+			if ( stride == 6 ) {
+			    VSUB2( diff, &vertex[3], &v[3] );
+			    if ( MAGSQ( diff ) > 0.0001 ) {
+				ptr = hash->next[ptr-1];
+				continue;
+			    }
+			}
+			/* closest so far, ties go to the oldest vertex */
+			best = d1_sq;
+			found = ptr;
+		    }
+		    ptr = hash->next[ptr-1];
+		}
+	    }
+	}
+    }
+
+    return found;
+}
+
+
+/**
+ * Append "vertex" (and its normal, for a stride of 6) to the array,
+ * link it into the hash and return its index.
+ */
+static size_t
+vert_hash_append( struct bg_vert_tree *tree, struct bg_vert_hash *hash, size_t stride, const fastf_t *vertex )
+{
+    size_t index;
+
+    if ( tree->curr_vert >= tree->max_vert ) {
+	/* allocate more memory for vertices, doubling keeps large imports linear */
+	tree->max_vert = tree->max_vert ? tree->max_vert * 2 : VERT_BLOCK;
+
+	tree->the_array = (fastf_t *)bu_realloc( tree->the_array, sizeof( fastf_t ) * tree->max_vert * stride,
+						 "tree->the_array" );
+    }
+
+    index = tree->curr_vert++;
+    memcpy( &tree->the_array[index*stride], vertex, stride * sizeof( fastf_t ) );
+
+    vert_hash_link( hash, vertex, index );
+
+    /* keep chains short by growing the table along with the vertex count */
+    if ( tree->curr_vert > hash->nbuckets ) {
+	vert_hash_rebuild( tree, stride, hash->cell, hash->nbuckets * 2 );
+    }
+
+    return index;
+}
+
+
+static void
+vert_hash_free( struct bg_vert_hash *hash )
+{
+    bu_free( hash->buckets, "vert hash buckets" );
+    bu_free( hash->next, "vert hash next" );
+    bu_free( hash, "vert hash" );
+}
 
 
 struct bg_vert_tree *
@@ -87,7 +278,7 @@ bg_vert_tree_create(void)
     BU_ALLOC(tree, struct bg_vert_tree);
     tree->magic = BN_VERT_TREE_MAGIC;
     tree->tree_type = BN_VERT_TREE_TYPE_VERTS;
-    tree->the_tree = (union vert_tree *)NULL;
+    tree->the_tree = (struct bg_vert_hash *)NULL;
     tree->curr_vert = 0;
     tree->max_vert = VERT_BLOCK;
     tree->the_array = (fastf_t *)bu_malloc( tree->max_vert * 3 * sizeof( fastf_t ), "vert tree array" );
@@ -103,7 +294,7 @@ bg_vert_tree_create_w_norms(void)
     BU_ALLOC(tree, struct bg_vert_tree);
     tree->magic = BN_VERT_TREE_MAGIC;
     tree->tree_type = BN_VERT_TREE_TYPE_VERTS_AND_NORMS;
-    tree->the_tree = (union vert_tree *)NULL;
+    tree->the_tree = (struct bg_vert_hash *)NULL;
     tree->curr_vert = 0;
     tree->max_vert = VERT_BLOCK;
     tree->the_array = (fastf_t *)bu_malloc( tree->max_vert * 6 * sizeof( fastf_t ), "vert tree array" );
@@ -111,22 +302,6 @@ bg_vert_tree_create_w_norms(void)
     return tree;
 }
 
-
-/**
- * static recursion routine used by "clean_vert_tree"
- */
-static void
-clean_vert_tree_recurse( union vert_tree *ptr )
-{
-    if ( ptr->type == VERT_NODE ) {
-	clean_vert_tree_recurse( ptr->vnode.higher );
-	clean_vert_tree_recurse( ptr->vnode.lower );
-    }
-
-    bu_free( (char *)ptr, "vert_tree" );
-
-}
-
 void
 bg_vert_tree_clean( struct bg_vert_tree *tree )
 {
@@ -134,45 +309,26 @@ bg_vert_tree_clean( struct bg_vert_tree *tree )
 
     if ( !tree->the_tree ) return;
 
-    clean_vert_tree_recurse( tree->the_tree );
-    tree->the_tree = (union vert_tree *)NULL;
+    vert_hash_free( tree->the_tree );
+    tree->the_tree = (struct bg_vert_hash *)NULL;
     tree->curr_vert = 0;
 }
 
-/**
- * static recursive routine used by "free_vert_tree"
- */
-static void
-free_vert_tree_recurse( union vert_tree *ptr )
-{
-    if ( ptr->type == VERT_NODE ) {
-	free_vert_tree_recurse( ptr->vnode.higher );
-	free_vert_tree_recurse( ptr->vnode.lower );
-    }
-
-    bu_free( (char *)ptr, "vert_tree" );
-
-}
-
 void
 bg_vert_tree_destroy( struct bg_vert_tree *tree )
 {
-    union vert_tree *ptr;
-
     if ( !tree )
 	return;
 
     BN_CK_VERT_TREE( tree );
 
-    ptr = tree->the_tree;
-    if ( !ptr )
-	return;
-
-    free_vert_tree_recurse( ptr );
+    if ( tree->the_tree )
+	vert_hash_free( tree->the_tree );
 
-    bu_free( (char *)tree->the_array, "vertex array" );
+    if ( tree->the_array )
+	bu_free( (char *)tree->the_array, "vertex array" );
 
-    tree->the_tree = (union vert_tree *)NULL;
+    tree->the_tree = (struct bg_vert_hash *)NULL;
     tree->the_array = (fastf_t *)NULL;
     tree->curr_vert = 0;
     tree->max_vert = 0;
@@ -181,9 +337,9 @@ bg_vert_tree_destroy( struct bg_vert_tree *tree )
 size_t
 bg_vert_tree_add( struct bg_vert_tree *tree, double x, double y, double z, fastf_t local_tol_sq )
 {
-    union vert_tree *ptr, *prev=NULL, *new_leaf, *new_node;
-    vect_t diff = VINIT_ZERO;
+    struct bg_vert_hash *hash;
     vect_t vertex;
+    size_t found;
 
     BN_CK_VERT_TREE( tree );
 
@@ -194,116 +350,23 @@ bg_vert_tree_add( struct bg_vert_tree *tree, double x, double y, double z, fastf
     VSET( vertex, x, y, z );
 
     /* look for this vertex already in the list */
-    ptr = tree->the_tree;
-    while ( ptr ) {
-	if ( ptr->type == VERT_NODE ) {
-	    prev = ptr;
-	    if ( vertex[ptr->vnode.coord] >= ptr->vnode.cut_val ) {
-		ptr = ptr->vnode.higher;
-	    } else {
-		ptr = ptr->vnode.lower;
-	    }
-	} else {
-	    size_t ij;
-
-	    ij = ptr->vleaf.index*3;
-	    diff[0] = fabs( vertex[0] - tree->the_array[ij] );
-	    diff[1] = fabs( vertex[1] - tree->the_array[ij+1] );
-	    diff[2] = fabs( vertex[2] - tree->the_array[ij+2] );
-	    if ( (diff[0]*diff[0] + diff[1]*diff[1] + diff[2]*diff[2]) <= local_tol_sq ) {
-		/* close enough, use this vertex again */
-		return ptr->vleaf.index;
-	    }
-	    break;
-	}
+    hash = vert_hash_prep( tree, 3, local_tol_sq );
+    found = vert_hash_find( tree, hash, 3, vertex, local_tol_sq );
+    if ( found ) {
+	/* close enough, use this vertex again */
+	return found - 1;
     }
 
-    /* add this vertex to the list */
-    if ( tree->curr_vert >= tree->max_vert ) {
-	/* allocate more memory for vertices */
-	tree->max_vert += VERT_BLOCK;
-
-	tree->the_array = (fastf_t *)bu_realloc( tree->the_array, sizeof( fastf_t ) * tree->max_vert * 3,
-						 "tree->the_array" );
-    }
-
-    VMOVE( &tree->the_array[tree->curr_vert*3], vertex );
-
-    /* add to the tree also */
-    BU_ALLOC(new_leaf, union vert_tree);
-    new_leaf->vleaf.type = VERT_LEAF;
-    new_leaf->vleaf.index = tree->curr_vert++;
-    if ( !tree->the_tree ) {
-	/* first vertex, it becomes the root */
-	tree->the_tree = new_leaf;
-    } else if ( ptr && ptr->type == VERT_LEAF ) {
-	/* search above ended at a leaf, need to add a node above this leaf and the new leaf */
-	BU_ALLOC(new_node, union vert_tree);
-	new_node->vnode.type = VERT_NODE;
-
-	/* select the cutting coord based on the biggest difference */
-	if ( diff[0] >= diff[1] && diff[0] >= diff[2] ) {
-	    new_node->vnode.coord = 0;
-	} else if ( diff[1] >= diff[2] && diff[1] >= diff[0] ) {
-	    new_node->vnode.coord = 1;
-	} else if ( diff[2] >= diff[1] && diff[2] >= diff[0] ) {
-	    new_node->vnode.coord = 2;
-	}
-
-	/* set the cut value to the mid value between the two vertices */
-	new_node->vnode.cut_val = (vertex[new_node->vnode.coord] +
-				   tree->the_array[ptr->vleaf.index * 3 + new_node->vnode.coord]) * 0.5;
-
-	/* set the node "lower" and "higher" pointers */
-	if ( vertex[new_node->vnode.coord] >=
-	     tree->the_array[ptr->vleaf.index * 3 + new_node->vnode.coord] ) {
-	    new_node->vnode.higher = new_leaf;
-	    new_node->vnode.lower = ptr;
-	} else {
-	    new_node->vnode.higher = ptr;
-	    new_node->vnode.lower = new_leaf;
-	}
-
-	if ( ptr == tree->the_tree ) {
-	    /* if the above search ended at the root, redefine the root */
-	    tree->the_tree =  new_node;
-	} else {
-	    /* set the previous node to point to our new one */
-	    if ( prev->vnode.higher == ptr ) {
-		prev->vnode.higher = new_node;
-	    } else {
-		prev->vnode.lower = new_node;
-	    }
-	}
-    } else if ( ptr && ptr->type == VERT_NODE ) {
-	/* above search ended at a node, just add the new leaf */
-	prev = ptr;
-	if ( vertex[prev->vnode.coord] >= prev->vnode.cut_val ) {
-	    if ( prev->vnode.higher ) {
-		bu_bomb("higher vertex node already exists in bg_vert_tree_add()?\n");
-	    }
-	    prev->vnode.higher = new_leaf;
-	} else {
-	    if ( prev->vnode.lower ) {
-		bu_bomb("lower vertex node already exists in bg_vert_tree_add()?\n");
-	    }
-	    prev->vnode.lower = new_leaf;
-	}
-    } else {
-	fprintf( stderr, "*********ERROR********\n" );
-    }
-
-    /* return the index into the vertex array */
-    return new_leaf->vleaf.index;
+    /* add this vertex to the list, and return the index into the vertex array */
+    return vert_hash_append( tree, hash, 3, vertex );
 }
 
 size_t
 bg_vert_tree_add_w_norm( struct bg_vert_tree *tree, double x, double y, double z, double nx, double ny, double nz, fastf_t local_tol_sq )
 {
-    union vert_tree *ptr, *prev=NULL, *new_leaf, *new_node;
-    fastf_t diff[6];
+    struct bg_vert_hash *hash;
     fastf_t vertex[6];
-    double d1_sq=0.0, d2_sq=0.0;
+    size_t found;
 
     BN_CK_VERT_TREE( tree );
 
@@ -315,122 +378,15 @@ bg_vert_tree_add_w_norm( struct bg_vert_tree *tree, double x, double y, double z
     VSET( &vertex[3], nx, ny, nz );
 
     /* look for this vertex and normal already in the list */
-    ptr = tree->the_tree;
-    while ( ptr ) {
-	size_t i;
-
-	if ( ptr->type == VERT_NODE ) {
-	    prev = ptr;
-	    if ( vertex[ptr->vnode.coord] >= ptr->vnode.cut_val ) {
-		ptr = ptr->vnode.higher;
-	    } else {
-		ptr = ptr->vnode.lower;
-	    }
-	} else {
-	    size_t ij;
-
-	    ij = ptr->vleaf.index*6;
-	    for ( i=0; i<6; i++ ) {
-		diff[i] = fabs( vertex[i] - tree->the_array[ij+i] );
-	    }
-	    d1_sq = VDOT( diff, diff );
-	    d2_sq = VDOT( &diff[3], &diff[3] );
-	    if ( d1_sq <= local_tol_sq && d2_sq <= 0.0001 ) {
-		/* close enough, use this vertex and normal again */
-		return ptr->vleaf.index;
-	    }
-	    break;
-	}
-    }
-
-    /* add this vertex and normal to the list */
-    if ( tree->curr_vert >= tree->max_vert ) {
-	/* allocate more memory for vertices */
-	tree->max_vert += VERT_BLOCK;
-
-	tree->the_array = (fastf_t *)bu_realloc( tree->the_array,
-						 sizeof( fastf_t ) * tree->max_vert * 6,
-						 "tree->the_array" );
-    }
-
-    VMOVE( &tree->the_array[tree->curr_vert*6], vertex );
-    VMOVE( &tree->the_array[tree->curr_vert*6+3], &vertex[3] );
-
-    /* add to the tree also */
-    BU_ALLOC(new_leaf, union vert_tree);
-    new_leaf->vleaf.type = VERT_LEAF;
-    new_leaf->vleaf.index = tree->curr_vert++;
-    if ( !tree->the_tree ) {
-	/* first vertex, it becomes the root */
-	tree->the_tree = new_leaf;
-    } else if ( ptr && ptr->type == VERT_LEAF ) {
-	fastf_t max;
-	size_t i;
-
-	/* search above ended at a leaf, need to add a node above this leaf and the new leaf */
-	BU_ALLOC(new_node, union vert_tree);
-	new_node->vnode.type = VERT_NODE;
-
-	/* select the cutting coord based on the biggest difference */
-	if ( d1_sq <= local_tol_sq ) {
-	    /* cut based on normal */
-	    new_node->vnode.coord = 3;
-	} else {
-	    new_node->vnode.coord = 0;
-	}
-	max = diff[new_node->vnode.coord];
-	for ( i=new_node->vnode.coord+1; i<6; i++ ) {
-	    if ( diff[i] > max ) {
-		new_node->vnode.coord = i;
-		max = diff[i];
-	    }
-	}
-
-	/* set the cut value to the mid value between the two vertices or normals */
-	new_node->vnode.cut_val = (vertex[new_node->vnode.coord] +
-				   tree->the_array[ptr->vleaf.index * 3 + new_node->vnode.coord]) * 0.5;
-
-	/* set the node "lower" and "higher" pointers */
-	if ( vertex[new_node->vnode.coord] >=
-	     tree->the_array[ptr->vleaf.index * 3 + new_node->vnode.coord] ) {
-	    new_node->vnode.higher = new_leaf;
-	    new_node->vnode.lower = ptr;
-	} else {
-	    new_node->vnode.higher = ptr;
-	    new_node->vnode.lower = new_leaf;
-	}
-
-	if ( ptr == tree->the_tree ) {
-	    /* if the above search ended at the root, redefine the root */
-	    tree->the_tree =  new_node;
-	} else {
-	    /* set the previous node to point to our new one */
-	    if ( prev->vnode.higher == ptr ) {
-		prev->vnode.higher = new_node;
-	    } else {
-		prev->vnode.lower = new_node;
-	    }
-	}
-    } else if ( ptr && ptr->type == VERT_NODE ) {
-	/* above search ended at a node, just add the new leaf */
-	prev = ptr;
-	if ( vertex[prev->vnode.coord] >= prev->vnode.cut_val ) {
-	    if ( prev->vnode.higher ) {
-		bu_bomb("higher vertex node already exists in bg_vert_tree_add_w_norm()?\n");
-	    }
-	    prev->vnode.higher = new_leaf;
-	} else {
-	    if ( prev->vnode.lower ) {
-		bu_bomb("lower vertex node already exists in bg_vert_tree_add_w_norm()?\n");
-	    }
-	    prev->vnode.lower = new_leaf;
-	}
-    } else {
-	fprintf( stderr, "*********ERROR********\n" );
+    hash = vert_hash_prep( tree, 6, local_tol_sq );
+    found = vert_hash_find( tree, hash, 6, vertex, local_tol_sq );
+    if ( found ) {
+	/* close enough, use this vertex and normal again */
+	return found - 1;
     }
 
-    /* return the index into the vertex array */
-    return new_leaf->vleaf.index;
+    /* add this vertex and normal to the list, and return the index into the vertex array */
+    return vert_hash_append( tree, hash, 6, vertex );
 }
 /** @} */
 /*
@@ -72,7 +72,7 @@
  * introducing periodicity. -FKM 4/93
  */
 static void
-filter_args(fastf_t *src, fastf_t *p, fastf_t *f, int *ip)
+filter_args(const fastf_t *src, fastf_t *p, fastf_t *f, int *ip)
 {
     static unsigned long max2x = ~((unsigned long)0);
     static unsigned long max = (~((unsigned long)0)) >> 1;
@@ -222,8 +222,11 @@ bn_noise_init(void)
 }
 
 
-double
-bn_noise_perlin(point_t point)
+/**
+ * Perlin noise at point, the noise tables having been initialized.
+ */
+static double
+noise_perlin(const fastf_t *point)
 {
     register int jx, jy, jz;
     int ix, iy, iz;	/* lower integer lattice point */
@@ -235,9 +238,6 @@ bn_noise_perlin(point_t point)
     point_t p, f;
     int ip[3];
 
-    if (!ht.hashTableValid)
-	bn_noise_init();
-
     /* IS: const fastf_t *, point_t, point_t, int[3] */
     /* NE: fastf_t *, fastf_t *, fastf_t *, int * */
     filter_args(point, p, f, ip);
@@ -299,6 +299,29 @@ bn_noise_perlin(point_t point)
 }
 
 
+double
+bn_noise_perlin(point_t point)
+{
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    return noise_perlin(point);
+}
+
+
+void
+bn_noise_perlin_n(size_t n, point_t *points, double *values)
+{
+    size_t i;
+
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    for (i = 0; i < n; i++)
+	values[i] = noise_perlin(points[i]);
+}
+
+
 void
 bn_noise_vec(point_t point, point_t result)
 {
@@ -412,28 +435,45 @@ bn_noise_vec(point_t point, point_t result)
  * freq
  * Which on some systems is rather expensive to compute.
  */
-struct fbm_spec {
+struct bn_noise_spec {
     uint32_t magic;
     double octaves;
     double lacunarity;
     double h_val;
     double remainder;
     double *spec_wgts;
+    struct bn_noise_spec *next;
 };
 #define MAGIC_fbm_spec_wgt 0x837592
 
-static struct fbm_spec *etbl = (struct fbm_spec *)NULL;
-static int etbl_next = 0;
-static int etbl_size = 0;
+#define SPEC_MATCH(_ep, _h, _l, _o) \
+    (EQUAL((_ep)->lacunarity, (_l)) && EQUAL((_ep)->h_val, (_h)) && EQUAL((_ep)->octaves, (_o)))
+
+/* Tables are never moved or freed once built, so a pointer to one
+ * stays good for the life of the process.  The list itself is only
+ * walked and extended with sem_noise held.
+ */
+static struct bn_noise_spec *etbl = (struct bn_noise_spec *)NULL;
+
+/* The last few tables each thread looked up, so that callers passing
+ * the same parameters on every sample find their table without
+ * taking the semaphore.
+ */
+#define SPEC_CACHE_SIZE 4
+static THREADLOCAL const struct bn_noise_spec *spec_cache[SPEC_CACHE_SIZE] = {NULL, NULL, NULL, NULL};
+static THREADLOCAL int spec_cache_next = 0;
+
+/* points evaluated together by the batched functions */
+#define NOISE_BATCH 64
 
 #define PSCALE(_p, _s) _p[0] *= _s; _p[1] *= _s; _p[2] *= _s
 #define PCOPY(_d, _s) _d[0] = _s[0]; _d[1] = _s[1]; _d[2] = _s[2]
 
 
-static struct fbm_spec *
+static struct bn_noise_spec *
 build_spec_tbl(double h_val, double lacunarity, double octaves)
 {
-    struct fbm_spec *ep = NULL;
+    struct bn_noise_spec *ep = NULL;
     double frequency;
     int i;
 
@@ -442,27 +482,11 @@ build_spec_tbl(double h_val, double lacunarity, double octaves)
      * save it with the knowledge that we'll likely want it again
      * later.
      */
-
-    /* allocate storage for new tables if needed */
-    if (etbl_next >= etbl_size) {
-	if (etbl_size) {
-	    etbl_size *= 2;
-	    etbl = (struct fbm_spec *)bu_realloc((void *)etbl,
-						 etbl_size*sizeof(struct fbm_spec),
-						 "spectral weights table");
-	} else {
-	    etbl_size = 128;
-	    etbl = (struct fbm_spec *)bu_calloc(etbl_size,
-						sizeof(struct fbm_spec),
-						"spectral weights table");
-	}
-    }
-
-    /* set up the next available table */
-    ep = &etbl[etbl_next];
+    BU_ALLOC(ep, struct bn_noise_spec);
     ep->h_val = h_val;
     ep->lacunarity = lacunarity;
     ep->octaves = octaves;
+    ep->remainder = octaves - (int)octaves;
     ep->spec_wgts = (double *)bu_calloc(((int)(octaves+1)), sizeof(double), "spectral weights");
     ep->magic = MAGIC_fbm_spec_wgt;
 
@@ -473,7 +497,34 @@ build_spec_tbl(double h_val, double lacunarity, double octaves)
 	frequency *= lacunarity;
     }
 
-    etbl_next++; /* saved for last in case we're running multi-threaded */
+    ep->next = etbl;
+    etbl = ep;
+    return ep;
+}
+
+
+const struct bn_noise_spec *
+bn_noise_spec_get(double h_val, double lacunarity, double octaves)
+{
+    struct bn_noise_spec *ep;
+
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    bu_semaphore_acquire(sem_noise);
+
+    for (ep = etbl; ep; ep = ep->next) {
+	if (ep->magic != MAGIC_fbm_spec_wgt)
+	    bu_bomb("bn_noise_spec_get");
+	if (SPEC_MATCH(ep, h_val, lacunarity, octaves))
+	    break;
+    }
+
+    if (!ep)
+	ep = build_spec_tbl(h_val, lacunarity, octaves);
+
+    bu_semaphore_release(sem_noise);
+
     return ep;
 }
 
@@ -484,72 +535,38 @@ build_spec_tbl(double h_val, double lacunarity, double octaves)
  * invocation.  If not, then we compute them and save them for possible
  * future use
  */
-struct fbm_spec *
+static const struct bn_noise_spec *
 find_spec_wgt(double h, double l, double o)
 {
-    struct fbm_spec *ep = NULL;
+    const struct bn_noise_spec *ep;
     int i;
 
-    for (i=0; i < etbl_next; i++) {
-	ep = &etbl[i];
-	if (ep->magic != MAGIC_fbm_spec_wgt)
-	    bu_bomb("find_spec_wgt");
-	if (EQUAL(ep->lacunarity, l)
-	    && EQUAL(ep->h_val, h)
-	    && (ep->octaves > o || EQUAL(ep->octaves, o)))
-	{
+    for (i = 0; i < SPEC_CACHE_SIZE; i++) {
+	ep = spec_cache[i];
+	if (ep && SPEC_MATCH(ep, h, l, o))
 	    return ep;
-	}
-    }
-
-    /* we didn't find the table we wanted so we've got to semaphore on
-     * the list to wait our turn to add what we want to the table.
-     */
-
-    bu_semaphore_acquire(sem_noise);
-
-    /* We search the list one more time in case the last process to
-     * hold the semaphore just created the table we were about to add
-     */
-    for (i=0; i < etbl_next; i++) {
-	ep = &etbl[i];
-	if (ep->magic != MAGIC_fbm_spec_wgt)
-	    bu_bomb("find_spec_wgt");
-	if (EQUAL(ep->lacunarity, l)
-	    && EQUAL(ep->h_val, h)
-	    && (ep->octaves > o || EQUAL(ep->octaves, o)))
-	{
-	    break;
-	}
     }
 
-    if (i >= etbl_next)
-	ep = build_spec_tbl(h, l, o);
-
-    bu_semaphore_release(sem_noise);
+    ep = bn_noise_spec_get(h, l, o);
+    spec_cache[spec_cache_next] = ep;
+    spec_cache_next = (spec_cache_next + 1) % SPEC_CACHE_SIZE;
 
     return ep;
 }
 
 
-double
-bn_noise_fbm(point_t point, double h_val, double lacunarity, double octaves)
+/**
+ * fBm at point from the weights in ep, with the noise tables
+ * initialized.
+ */
+static double
+spec_fbm(const struct bn_noise_spec *ep, const fastf_t *point, double lacunarity, double octaves)
 {
-    struct fbm_spec *ep;
-    double value, noise_remainder, *spec_wgts;
+    double value, noise_remainder;
+    const double *spec_wgts;
     point_t pt;
     int i, oct;
 
-    /* The first order of business is to see if we have pre-computed
-     * the spectral weights table for these parameters in a previous
-     * invocation.  If not, then we compute them and save them for
-     * possible future use
-     */
-
-    ep = find_spec_wgt(h_val, lacunarity, octaves);
-
-    /* now we're ready to compute the fBm value */
-
     value = 0.0;            /* initialize vars to proper values */
     /* copy the point so we don't corrupt the caller's version */
     PCOPY(pt, point);
@@ -559,7 +576,7 @@ bn_noise_fbm(point_t point, double h_val, double lacunarity, double octaves)
     /* inner loop of spectral construction */
     oct=(int)octaves; /* save repeating double->int cast */
     for (i=0; i < oct; i++) {
-	value += bn_noise_perlin(pt) * spec_wgts[i];
+	value += noise_perlin(pt) * spec_wgts[i];
 	PSCALE(pt, lacunarity);
     }
 
@@ -568,33 +585,25 @@ bn_noise_fbm(point_t point, double h_val, double lacunarity, double octaves)
 	/* add in ``octaves'' noise_remainder ``i'' and spatial freq. are
 	 * preset in loop above
 	 */
-	value += noise_remainder * bn_noise_perlin(pt) * spec_wgts[i];
+	value += noise_remainder * noise_perlin(pt) * spec_wgts[i];
     }
 
     return value;
-
 }
 
 
-double
-bn_noise_turb(point_t point, double h_val, double lacunarity, double octaves)
+/**
+ * Turbulence at point from the weights in ep, with the noise tables
+ * initialized.
+ */
+static double
+spec_turb(const struct bn_noise_spec *ep, const fastf_t *point, double lacunarity, double octaves)
 {
-    struct fbm_spec *ep;
-    double value, noise_remainder, *spec_wgts;
+    double value, noise_remainder;
+    const double *spec_wgts;
     point_t pt;
     int i, oct;
 
-
-    /* The first order of business is to see if we have pre-computed
-     * the spectral weights table for these parameters in a previous
-     * invocation.  If not, then we compute them and save them for
-     * possible future use
-     */
-
-    ep = find_spec_wgt(h_val, lacunarity, octaves);
-
-    /* now we're ready to compute the fBm value */
-
     value = 0.0;            /* initialize vars to proper values */
     /* not cached: frequency = 1.0; */
 
@@ -611,7 +620,7 @@ bn_noise_turb(point_t point, double h_val, double lacunarity, double octaves)
 	 * value += fabs(bn_noise_perlin(pt)) * pow(frequency, -h_val);
 	 * frequency *= lacunarity;
 	 */
-	value += fabs(bn_noise_perlin(pt)) * spec_wgts[i];
+	value += fabs(noise_perlin(pt)) * spec_wgts[i];
 	PSCALE(pt, lacunarity);
     }
 
@@ -620,20 +629,142 @@ bn_noise_turb(point_t point, double h_val, double lacunarity, double octaves)
 	/* add in ``octaves'' noise_remainder ``i'' and spatial freq. are
 	 * preset in loop above
 	 */
-	value += noise_remainder * bn_noise_perlin(pt) * spec_wgts[i];
+	value += noise_remainder * noise_perlin(pt) * spec_wgts[i];
 	/* not cached: value += noise_remainder * bn_noise_perlin(pt) * pow(frequency, -h_val); */
     }
 
     return value;
+}
+
 
+/**
+ * Sum the octaves of fBm (turb == 0) or turbulence (turb != 0) over n
+ * points.  The octave loop is outermost so each weight and frequency
+ * is applied across a run of points at once instead of per point.
+ */
+static void
+spec_sum_n(const struct bn_noise_spec *ep, size_t n, point_t *points, double *values, int turb)
+{
+    point_t pt[NOISE_BATCH];
+    double wgt, lacunarity = ep->lacunarity;
+    size_t i, j, m;
+    int o, oct = (int)ep->octaves;
+
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    for (i = 0; i < n; i += m) {
+	m = FMIN(n - i, NOISE_BATCH);
+	for (j = 0; j < m; j++) {
+	    PCOPY(pt[j], points[i+j]);
+	    values[i+j] = 0.0;
+	}
+
+	for (o = 0; o < oct; o++) {
+	    wgt = ep->spec_wgts[o];
+	    if (turb) {
+		for (j = 0; j < m; j++)
+		    values[i+j] += fabs(noise_perlin(pt[j])) * wgt;
+	    } else {
+		for (j = 0; j < m; j++)
+		    values[i+j] += noise_perlin(pt[j]) * wgt;
+	    }
+	    for (j = 0; j < m; j++) {
+		PSCALE(pt[j], lacunarity);
+	    }
+	}
+
+	/* the partial octave is signed for both, as in spec_turb() */
+	if (!ZERO(ep->remainder)) {
+	    for (j = 0; j < m; j++)
+		values[i+j] += ep->remainder * noise_perlin(pt[j]) * ep->spec_wgts[o];
+	}
+    }
+}
+
+
+double
+bn_noise_fbm(point_t point, double h_val, double lacunarity, double octaves)
+{
+    const struct bn_noise_spec *ep;
+
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    /* The first order of business is to see if we have pre-computed
+     * the spectral weights table for these parameters in a previous
+     * invocation.  If not, then we compute them and save them for
+     * possible future use
+     */
+
+    ep = find_spec_wgt(h_val, lacunarity, octaves);
+
+    /* now we're ready to compute the fBm value */
+    return spec_fbm(ep, point, lacunarity, octaves);
+}
+
+
+double
+bn_noise_turb(point_t point, double h_val, double lacunarity, double octaves)
+{
+    const struct bn_noise_spec *ep;
+
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    /* The first order of business is to see if we have pre-computed
+     * the spectral weights table for these parameters in a previous
+     * invocation.  If not, then we compute them and save them for
+     * possible future use
+     */
+
+    ep = find_spec_wgt(h_val, lacunarity, octaves);
+
+    /* now we're ready to compute the turbulence value */
+    return spec_turb(ep, point, lacunarity, octaves);
+}
+
+
+double
+bn_noise_spec_fbm(const struct bn_noise_spec *spec, point_t point)
+{
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    return spec_fbm(spec, point, spec->lacunarity, spec->octaves);
+}
+
+
+double
+bn_noise_spec_turb(const struct bn_noise_spec *spec, point_t point)
+{
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    return spec_turb(spec, point, spec->lacunarity, spec->octaves);
+}
+
+
+void
+bn_noise_spec_fbm_n(const struct bn_noise_spec *spec, size_t n, point_t *points, double *values)
+{
+    spec_sum_n(spec, n, points, values, 0);
+}
+
+
+void
+bn_noise_spec_turb_n(const struct bn_noise_spec *spec, size_t n, point_t *points, double *values)
+{
+    spec_sum_n(spec, n, points, values, 1);
 }
 
 
 double
 bn_noise_ridged(point_t point, double h_val, double lacunarity, double octaves, double offset)
 {
-    struct fbm_spec *ep;
-    double result, weight, noise_signal, *spec_wgts;
+    const struct bn_noise_spec *ep;
+    double result, weight, noise_signal;
+    const double *spec_wgts;
     point_t pt;
     int i;
 
@@ -687,8 +818,9 @@ bn_noise_ridged(point_t point, double h_val, double lacunarity, double octaves,
 double
 bn_noise_mf(point_t point, double h_val, double lacunarity, double octaves, double offset)
 {
-    struct fbm_spec *ep;
-    double result, *spec_wgts;
+    const struct bn_noise_spec *ep;
+    double result;
+    const double *spec_wgts;
     point_t pt;
 
     /* The first order of business is to see if we have pre-computed
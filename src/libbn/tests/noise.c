@@ -0,0 +1,109 @@
+/*                         N O I S E . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+
+#include "common.h"
+
+#include <stdio.h>
+#include <math.h>
+
+#include "bu.h"
+#include "bn.h"
+
+
+#define NOISE_POINTS 200
+
+
+/* compare the spectral weight and batched functions against the
+ * scalar per-call ones for one set of parameters
+ */
+static int
+noise_check(point_t *pts, double h_val, double lacunarity, double octaves)
+{
+    const struct bn_noise_spec *spec;
+    double perlin[NOISE_POINTS], fbm[NOISE_POINTS], turb[NOISE_POINTS];
+    double v;
+    size_t i;
+    int ret = 0;
+
+    spec = bn_noise_spec_get(h_val, lacunarity, octaves);
+    if (spec != bn_noise_spec_get(h_val, lacunarity, octaves)) {
+	printf("FAILED: spectral weights for %g %g %g not shared\n", h_val, lacunarity, octaves);
+	ret = 1;
+    }
+
+    bn_noise_perlin_n(NOISE_POINTS, pts, perlin);
+    bn_noise_spec_fbm_n(spec, NOISE_POINTS, pts, fbm);
+    bn_noise_spec_turb_n(spec, NOISE_POINTS, pts, turb);
+
+    for (i = 0; i < NOISE_POINTS; i++) {
+	v = bn_noise_perlin(pts[i]);
+	if (!NEAR_EQUAL(perlin[i], v, 1.0e-12)) {
+	    printf("FAILED: perlin %zu: batched %.17g, scalar %.17g\n", i, perlin[i], v);
+	    ret = 1;
+	}
+
+	v = bn_noise_fbm(pts[i], h_val, lacunarity, octaves);
+	if (!NEAR_EQUAL(fbm[i], v, 1.0e-12) || !NEAR_EQUAL(bn_noise_spec_fbm(spec, pts[i]), v, 1.0e-12)) {
+	    printf("FAILED: fbm %zu (%g %g %g): batched %.17g, scalar %.17g\n", i, h_val, lacunarity, octaves, fbm[i], v);
+	    ret = 1;
+	}
+
+	v = bn_noise_turb(pts[i], h_val, lacunarity, octaves);
+	if (!NEAR_EQUAL(turb[i], v, 1.0e-12) || !NEAR_EQUAL(bn_noise_spec_turb(spec, pts[i]), v, 1.0e-12)) {
+	    printf("FAILED: turb %zu (%g %g %g): batched %.17g, scalar %.17g\n", i, h_val, lacunarity, octaves, turb[i], v);
+	    ret = 1;
+	}
+    }
+
+    return ret;
+}
+
+
+int
+noise_main(int UNUSED(argc), char **UNUSED(argv))
+{
+    point_t pts[NOISE_POINTS];
+    size_t i;
+    int ret = 0;
+
+    for (i = 0; i < NOISE_POINTS; i++) {
+	VSET(pts[i], i * 0.731 - 40.0, i * 0.277 + 1000.0, sin((double)i) * 25.0);
+    }
+
+    ret |= noise_check(pts, 1.0, 2.1753974, 4.0);
+    ret |= noise_check(pts, 0.5, 2.0, 3.5);
+    ret |= noise_check(pts, 1.0, 2.1753974, 2.0);
+
+    if (!ret)
+	printf("noise: batched and scalar evaluation agree\n");
+
+    return ret;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
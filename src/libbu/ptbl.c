@@ -26,16 +26,274 @@
 #include "bu/debug.h"
 #include "bu/log.h"
 #include "bu/malloc.h"
+#include "bu/parallel.h"
 #include "bu/ptbl.h"
 
 static const size_t BU_PTBL_DEFAULT_LEN = 16;
 
+/**
+ * Open addressed pointer hash over the entries of a table.  Each
+ * bucket maps an entry value to the highest table slot holding it,
+ * which is what the reverse scans in bu_ptbl_locate() and
+ * bu_ptbl_ins_unique() have always returned.  Only the table entries
+ * [0, end) have been added; later entries are picked up lazily.
+ *
+ * Indexes are kept here rather than in struct bu_ptbl, chained by the
+ * address of their table, so the struct keeps its layout and a copy
+ * of an indexed table is simply unindexed.
+ */
+struct bu_ptbl_index {
+    const struct bu_ptbl *tbl;	/* the table indexed */
+    struct bu_ptbl_index *next;	/* next index in the same chain */
+    size_t nbuckets;	/* always a power of two */
+    size_t cnt;		/* number of occupied buckets */
+    size_t end;		/* table entries [0, end) are indexed */
+    const long **keys;
+    size_t *slots;	/* table slot + 1, or 0 for an empty bucket */
+};
+
+
+static size_t
+ptbl_hash(const long *p, size_t nbuckets)
+{
+    uint64_t h = (uint64_t)(uintptr_t)p;
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (size_t)h & (nbuckets - 1);
+}
+
+
+#define PTBL_INDEX_CHAINS 256
+#define PTBL_INDEX_LOCKS 8
+
+static struct bu_ptbl_index *ptbl_index_chains[PTBL_INDEX_CHAINS];
+static int ptbl_index_sem[PTBL_INDEX_LOCKS];
+static const char *ptbl_index_sem_names[PTBL_INDEX_LOCKS] = {
+    "SEM_PTBL_INDEX0", "SEM_PTBL_INDEX1", "SEM_PTBL_INDEX2", "SEM_PTBL_INDEX3",
+    "SEM_PTBL_INDEX4", "SEM_PTBL_INDEX5", "SEM_PTBL_INDEX6", "SEM_PTBL_INDEX7"
+};
+/* tables with an index; while there are none, nothing is looked up */
+static size_t ptbl_index_tables = 0;
+
+
+/* The index of table b, or NULL. */
+static struct bu_ptbl_index *
+ptbl_index_get(const struct bu_ptbl *b)
+{
+    struct bu_ptbl_index *idx;
+    size_t c;
+
+    if (!ptbl_index_tables)
+	return NULL;
+
+    c = ptbl_hash((const long *)b, PTBL_INDEX_CHAINS);
+    bu_semaphore_acquire(ptbl_index_sem[c % PTBL_INDEX_LOCKS]);
+    for (idx = ptbl_index_chains[c]; idx && idx->tbl != b; idx = idx->next)
+	;
+    bu_semaphore_release(ptbl_index_sem[c % PTBL_INDEX_LOCKS]);
+
+    return idx;
+}
+
+
+/* Release the index of table b, if it has one. */
+static void
+ptbl_index_drop(const struct bu_ptbl *b)
+{
+    struct bu_ptbl_index *idx, **prev;
+    size_t c;
+
+    if (!ptbl_index_tables)
+	return;
+
+    c = ptbl_hash((const long *)b, PTBL_INDEX_CHAINS);
+    bu_semaphore_acquire(ptbl_index_sem[c % PTBL_INDEX_LOCKS]);
+    for (prev = &ptbl_index_chains[c]; *prev && (*prev)->tbl != b; prev = &(*prev)->next)
+	;
+    idx = *prev;
+    if (idx)
+	*prev = idx->next;
+    bu_semaphore_release(ptbl_index_sem[c % PTBL_INDEX_LOCKS]);
+
+    if (!idx)
+	return;
+
+    bu_free((void *)idx->keys, "bu_ptbl_index keys");
+    bu_free(idx->slots, "bu_ptbl_index slots");
+    BU_PUT(idx, struct bu_ptbl_index);
+
+    bu_semaphore_acquire(BU_SEM_GENERAL);
+    ptbl_index_tables--;
+    bu_semaphore_release(BU_SEM_GENERAL);
+}
+
+
+static void
+ptbl_index_clear(struct bu_ptbl_index *idx)
+{
+    memset(idx->slots, 0, idx->nbuckets * sizeof(size_t));
+    idx->cnt = 0;
+    idx->end = 0;
+}
+
+
+static void
+ptbl_index_put(struct bu_ptbl_index *idx, const long *p, size_t slot)
+{
+    size_t h;
+
+    if ((idx->cnt + 1) * 2 > idx->nbuckets) {
+	/* grow and rehash */
+	size_t i;
+	size_t onbuckets = idx->nbuckets;
+	const long **okeys = idx->keys;
+	size_t *oslots = idx->slots;
+
+	idx->nbuckets *= 2;
+	idx->keys = (const long **)bu_malloc(idx->nbuckets * sizeof(long *), "bu_ptbl_index keys");
+	idx->slots = (size_t *)bu_calloc(idx->nbuckets, sizeof(size_t), "bu_ptbl_index slots");
+	for (i = 0; i < onbuckets; i++) {
+	    if (!oslots[i])
+		continue;
+	    h = ptbl_hash(okeys[i], idx->nbuckets);
+	    while (idx->slots[h])
+		h = (h + 1) & (idx->nbuckets - 1);
+	    idx->keys[h] = okeys[i];
+	    idx->slots[h] = oslots[i];
+	}
+	bu_free((void *)okeys, "bu_ptbl_index keys");
+	bu_free(oslots, "bu_ptbl_index slots");
+    }
+
+    h = ptbl_hash(p, idx->nbuckets);
+    while (idx->slots[h]) {
+	if (idx->keys[h] == p) {
+	    idx->slots[h] = slot + 1;
+	    return;
+	}
+	h = (h + 1) & (idx->nbuckets - 1);
+    }
+    idx->keys[h] = p;
+    idx->slots[h] = slot + 1;
+    idx->cnt++;
+}
+
+
+/**
+ * Bring the index up to date with the table and look up p.
+ */
+static intmax_t
+ptbl_index_find(const struct bu_ptbl *b, struct bu_ptbl_index *idx, const long *p)
+{
+    size_t h;
+    int rebuilt = 0;
+
+    /* the table was shortened behind our back */
+    if (idx->end > b->end)
+	ptbl_index_clear(idx);
+
+again:
+    while (idx->end < b->end) {
+	ptbl_index_put(idx, b->buffer[idx->end], idx->end);
+	idx->end++;
+    }
+
+    h = ptbl_hash(p, idx->nbuckets);
+    while (idx->slots[h]) {
+	if (idx->keys[h] == p) {
+	    size_t slot = idx->slots[h] - 1;
+	    if (slot < b->end && b->buffer[slot] == p)
+		return (intmax_t)slot;
+	    /* stale, the entry was changed in place; rebuild once */
+	    if (rebuilt)
+		break;
+	    rebuilt = 1;
+	    ptbl_index_clear(idx);
+	    goto again;
+	}
+	h = (h + 1) & (idx->nbuckets - 1);
+    }
+
+    return -1;
+}
+
+
+/**
+ * Look up p without changing the index: entries past the indexed
+ * ones are scanned, and an index that no longer matches the table
+ * returns -2 so the caller scans instead.
+ */
+static intmax_t
+ptbl_index_peek(const struct bu_ptbl *b, const struct bu_ptbl_index *idx, const long *p)
+{
+    intmax_t k;
+    size_t h;
+
+    if (idx->end > b->end)
+	return -2;
+
+    for (k = (intmax_t)b->end-1; k >= (intmax_t)idx->end; k--) {
+	if (b->buffer[k] == p)
+	    return k;
+    }
+
+    h = ptbl_hash(p, idx->nbuckets);
+    while (idx->slots[h]) {
+	if (idx->keys[h] == p) {
+	    size_t slot = idx->slots[h] - 1;
+	    return (b->buffer[slot] == p) ? (intmax_t)slot : -2;
+	}
+	h = (h + 1) & (idx->nbuckets - 1);
+    }
+
+    return -1;
+}
+
+
 void
-bu_ptbl_init(struct bu_ptbl *b, size_t len, const char *str)
+bu_ptbl_index(struct bu_ptbl *b)
 {
-    if (UNLIKELY(bu_debug & BU_DEBUG_PTBL))
-	bu_log("bu_ptbl_init(%p, len=%zu, %s)\n", (void *)b, len, str);
+    struct bu_ptbl_index *idx;
+    size_t c, i;
+
+    BU_CK_PTBL(b);
+
+    if ((idx = ptbl_index_get(b)) != NULL) {
+	ptbl_index_clear(idx);
+	return;
+    }
+
+    bu_semaphore_acquire(BU_SEM_GENERAL);
+    if (!ptbl_index_sem[0]) {
+	for (i = 0; i < PTBL_INDEX_LOCKS; i++)
+	    ptbl_index_sem[i] = bu_semaphore_register(ptbl_index_sem_names[i]);
+    }
+    ptbl_index_tables++;
+    bu_semaphore_release(BU_SEM_GENERAL);
+
+    BU_GET(idx, struct bu_ptbl_index);
+    idx->tbl = b;
+    idx->nbuckets = 64;
+    while (idx->nbuckets < b->end * 2)
+	idx->nbuckets *= 2;
+    idx->keys = (const long **)bu_malloc(idx->nbuckets * sizeof(long *), "bu_ptbl_index keys");
+    idx->slots = (size_t *)bu_calloc(idx->nbuckets, sizeof(size_t), "bu_ptbl_index slots");
+    idx->cnt = 0;
+    idx->end = 0;
+
+    c = ptbl_hash((const long *)b, PTBL_INDEX_CHAINS);
+    bu_semaphore_acquire(ptbl_index_sem[c % PTBL_INDEX_LOCKS]);
+    idx->next = ptbl_index_chains[c];
+    ptbl_index_chains[c] = idx;
+    bu_semaphore_release(ptbl_index_sem[c % PTBL_INDEX_LOCKS]);
+}
 
+
+static void
+ptbl_init(struct bu_ptbl *b, size_t len, const char *str)
+{
     BU_LIST_INIT_MAGIC(&b->l, BU_PTBL_MAGIC);
 
     if (UNLIKELY(len <= (size_t)0))
@@ -46,22 +304,38 @@ bu_ptbl_init(struct bu_ptbl *b, size_t len, const char *str)
     b->end = 0;
 }
 
+void
+bu_ptbl_init(struct bu_ptbl *b, size_t len, const char *str)
+{
+    if (UNLIKELY(bu_debug & BU_DEBUG_PTBL))
+	bu_log("bu_ptbl_init(%p, len=%zu, %s)\n", (void *)b, len, str);
+
+    /* a table set up again at the same address starts unindexed */
+    ptbl_index_drop(b);
+    ptbl_init(b, len, str);
+}
+
 
 void
 bu_ptbl_reset(struct bu_ptbl *b)
 {
+    struct bu_ptbl_index *idx;
+
     BU_CK_PTBL(b);
 
     if (UNLIKELY(bu_debug & BU_DEBUG_PTBL))
 	bu_log("bu_ptbl_reset(%p)\n", (void *)b);
     b->end = 0;
     memset((char *)b->buffer, 0, b->blen*sizeof(long *));	/* no peeking */
+    if ((idx = ptbl_index_get(b)) != NULL)
+	ptbl_index_clear(idx);
 }
 
 
 size_t
 bu_ptbl_ins(struct bu_ptbl *b, long int *p)
 {
+    struct bu_ptbl_index *idx;
     size_t i;
 
     BU_CK_PTBL(b);
@@ -70,7 +344,7 @@ bu_ptbl_ins(struct bu_ptbl *b, long int *p)
 	bu_log("bu_ptbl_ins(%p, %p)\n", (void *)b, (void *)p);
 
     if (b->blen == 0)
-	bu_ptbl_init(b, BU_PTBL_DEFAULT_LEN, "bu_ptbl_ins() buffer");
+	ptbl_init(b, BU_PTBL_DEFAULT_LEN, "bu_ptbl_ins() buffer");
 
     if (b->end >= b->blen) {
 	b->buffer = (long **)bu_realloc((char *)b->buffer,
@@ -80,6 +354,15 @@ bu_ptbl_ins(struct bu_ptbl *b, long int *p)
 
     i = b->end++;
     b->buffer[i] = p;
+    if ((idx = ptbl_index_get(b)) != NULL) {
+	if (idx->end == i) {
+	    ptbl_index_put(idx, p, i);
+	    idx->end++;
+	} else if (idx->end > i) {
+	    /* the table was shortened behind our back */
+	    ptbl_index_clear(idx);
+	}
+    }
     return i;
 }
 
@@ -87,11 +370,18 @@ bu_ptbl_ins(struct bu_ptbl *b, long int *p)
 intmax_t
 bu_ptbl_locate(const struct bu_ptbl *b, const long int *p)
 {
+    struct bu_ptbl_index *idx;
     intmax_t k;
     const long **pp;
 
     BU_CK_PTBL(b);
 
+    if ((idx = ptbl_index_get(b)) != NULL) {
+	k = ptbl_index_peek(b, idx, p);
+	if (k != -2)
+	    return k;
+    }
+
     pp = (const long **)b->buffer;
     for (k = (intmax_t)b->end-1; k >= 0; k--) {
 	if (pp[k] == p) {
@@ -106,6 +396,7 @@ bu_ptbl_locate(const struct bu_ptbl *b, const long int *p)
 void
 bu_ptbl_zero(struct bu_ptbl *b, const long int *p)
 {
+    struct bu_ptbl_index *idx;
     intmax_t k;
     const long **pp;
 
@@ -117,46 +408,56 @@ bu_ptbl_zero(struct bu_ptbl *b, const long int *p)
 	    pp[k] = (long *)0;
 	}
     }
+    if ((idx = ptbl_index_get(b)) != NULL)
+	ptbl_index_clear(idx);
 }
 
 
-intmax_t
-bu_ptbl_ins_unique(struct bu_ptbl *b, long int *p)
+static intmax_t
+ptbl_ins_unique(struct bu_ptbl *b, struct bu_ptbl_index *idx, long int *p)
 {
     register intmax_t k;
     register long **pp;
 
-    BU_CK_PTBL(b);
-
     pp = b->buffer;
 
     /* search for existing */
-    for (k = (intmax_t)b->end-1; k >= 0; k--) {
-	if (pp[k] == p) {
+    if (idx) {
+	k = ptbl_index_find(b, idx, p);
+	if (k >= 0)
 	    return k;
+    } else {
+	for (k = (intmax_t)b->end-1; k >= 0; k--) {
+	    if (pp[k] == p) {
+		return k;
+	    }
 	}
     }
 
     if (UNLIKELY(bu_debug & BU_DEBUG_PTBL))
 	bu_log("bu_ptbl_ins_unique(%p, %p)\n", (void *)b, (void *)p);
 
-    if (b->blen <= 0 || (size_t)b->end >= b->blen) {
-	/* Table needs to grow */
-	bu_ptbl_ins(b, p);
-	return -1;	/* To signal that it was added */
-    }
-
-    b->buffer[b->end++] = p;
+    bu_ptbl_ins(b, p);
     return -1;		/* To signal that it was added */
 }
 
 
+intmax_t
+bu_ptbl_ins_unique(struct bu_ptbl *b, long int *p)
+{
+    BU_CK_PTBL(b);
+
+    return ptbl_ins_unique(b, ptbl_index_get(b), p);
+}
+
+
 size_t
 bu_ptbl_rm(struct bu_ptbl *b, const long int *p)
 {
     register intmax_t end, j, k, l;
     register long **pp;
     size_t ndel = 0;
+    struct bu_ptbl_index *idx;
 
     BU_CK_PTBL(b);
 
@@ -178,6 +479,8 @@ bu_ptbl_rm(struct bu_ptbl *b, const long int *p)
 	    b->end = end;
 	}
     }
+    if (ndel && (idx = ptbl_index_get(b)) != NULL)
+	ptbl_index_clear(idx);
     if (UNLIKELY(bu_debug & BU_DEBUG_PTBL))
 	bu_log("bu_ptbl_rm(%p, %p) ndel=%zd\n", (void *)b, (void *)p, ndel);
     return ndel;
@@ -208,6 +511,7 @@ void
 bu_ptbl_cat_uniq(struct bu_ptbl *dest, const struct bu_ptbl *src)
 {
     register long **p;
+    struct bu_ptbl_index *idx;
 
     BU_CK_PTBL(dest);
     BU_CK_PTBL(src);
@@ -221,8 +525,9 @@ bu_ptbl_cat_uniq(struct bu_ptbl *dest, const struct bu_ptbl *src)
 					   sizeof(long *)*(dest->blen += src->blen + 8),
 					   "bu_ptbl.buffer[] (cat_uniq)");
     }
+    idx = ptbl_index_get(dest);
     for (BU_PTBL_FOR(p, (long **), src)) {
-	bu_ptbl_ins_unique(dest, *p);
+	ptbl_ins_unique(dest, idx, *p);
     }
 }
 
@@ -235,6 +540,7 @@ bu_ptbl_free(struct bu_ptbl *b)
 
     BU_CK_PTBL(b);
 
+    ptbl_index_drop(b);
     bu_free((void *)b->buffer, "bu_ptbl.buffer[]");
     memset((char *)b, 0, sizeof(struct bu_ptbl));	/* sanity */
 
@@ -269,6 +575,8 @@ bu_pr_ptbl(const char *title, const struct bu_ptbl *tbl, int verbose)
 void
 bu_ptbl_trunc(struct bu_ptbl *tbl, size_t end)
 {
+    struct bu_ptbl_index *idx;
+
     BU_CK_PTBL(tbl);
 
     if (end > tbl->blen) {
@@ -278,6 +586,8 @@ bu_ptbl_trunc(struct bu_ptbl *tbl, size_t end)
 
     /* expand or reduce accordingly */
     tbl->end = end;
+    if ((idx = ptbl_index_get(tbl)) != NULL)
+	ptbl_index_clear(idx);
     return;
 }
 
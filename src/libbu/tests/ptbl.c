@@ -211,6 +211,83 @@ test_bu_ptbl_trunc(void)
 }
 
 
+/**
+ * Test that an indexed table answers every lookup exactly as the
+ * plain table does, across the routines that change the table.
+ */
+static size_t
+test_bu_ptbl_index(void)
+{
+    struct bu_ptbl plain, indexed, copy;
+    long vals[1000];
+    size_t i, how_many = sizeof(vals) / sizeof(vals[0]);
+    size_t result = BRLCAD_OK;
+
+    bu_ptbl_init(&plain, 0, "test_bu_ptbl_index plain");
+    bu_ptbl_init(&indexed, 0, "test_bu_ptbl_index indexed");
+    bu_ptbl_index(&indexed);
+
+    /* insert with repeats */
+    for (i = 0; i < how_many * 3; i++) {
+	long *p = &vals[(i * 7919) % how_many];
+	if (bu_ptbl_ins_unique(&plain, p) != bu_ptbl_ins_unique(&indexed, p))
+	    result = BRLCAD_ERROR;
+    }
+    if (BU_PTBL_LEN(&plain) != how_many || BU_PTBL_LEN(&indexed) != how_many)
+	result = BRLCAD_ERROR;
+
+    /* duplicates, removal, zeroing, direct appends and truncation */
+    bu_ptbl_ins(&plain, &vals[5]);
+    bu_ptbl_ins(&indexed, &vals[5]);
+    bu_ptbl_rm(&plain, &vals[17]);
+    bu_ptbl_rm(&indexed, &vals[17]);
+    bu_ptbl_zero(&plain, &vals[23]);
+    bu_ptbl_zero(&indexed, &vals[23]);
+    bu_ptbl_cat(&plain, &indexed);
+    bu_ptbl_cat(&indexed, &indexed);
+    bu_ptbl_trunc(&plain, how_many + 100);
+    bu_ptbl_trunc(&indexed, how_many + 100);
+    BU_PTBL_SET(&plain, 3, &vals[17]);
+    BU_PTBL_SET(&indexed, 3, &vals[17]);
+    bu_ptbl_index(&indexed);
+
+    for (i = 0; i < how_many; i++) {
+	if (bu_ptbl_locate(&plain, &vals[i]) != bu_ptbl_locate(&indexed, &vals[i]))
+	    result = BRLCAD_ERROR;
+    }
+    if (bu_ptbl_locate(&plain, NULL) != bu_ptbl_locate(&indexed, NULL))
+	result = BRLCAD_ERROR;
+
+    /* a struct copy shares the entries but not the index */
+    copy = indexed;
+    bu_ptbl_ins(&copy, &vals[0]);
+    indexed.buffer = copy.buffer;	/* in case the insert moved it */
+    indexed.blen = copy.blen;
+    if (bu_ptbl_locate(&copy, &vals[0]) != (intmax_t)BU_PTBL_LEN(&copy) - 1
+	|| bu_ptbl_locate(&indexed, &vals[0]) != bu_ptbl_locate(&plain, &vals[0]))
+	result = BRLCAD_ERROR;
+
+    bu_ptbl_reset(&indexed);
+    if (bu_ptbl_locate(&indexed, &vals[0]) != -1)
+	result = BRLCAD_ERROR;
+
+    /* a new table at the same address starts out unindexed */
+    bu_ptbl_free(&indexed);
+    bu_ptbl_init(&indexed, 0, "test_bu_ptbl_index again");
+    for (i = 0; i < 10; i++)
+	bu_ptbl_ins(&indexed, &vals[i]);
+    if (bu_ptbl_locate(&indexed, &vals[9]) != 9 || bu_ptbl_locate(&indexed, &vals[10]) != -1)
+	result = BRLCAD_ERROR;
+
+    bu_ptbl_free(&plain);
+    bu_ptbl_free(&indexed);
+
+    printf("\nbu_ptbl_index ");
+    printf(result == BRLCAD_OK ? "PASSED" : "FAILED");
+    return result;
+}
+
+
 int
 main(int argc, char *argv[])
 {
@@ -223,7 +300,7 @@ main(int argc, char *argv[])
 	bu_setprogname(argv[0]);
 
     if (argc < 2) {
-	bu_exit(1, "Usage: %s (init|reset|ins|locate|rm|cat|trunc) [test_args...]\n", argv[0]);
+	bu_exit(1, "Usage: %s (init|reset|ins|locate|rm|cat|trunc|index) [test_args...]\n", argv[0]);
     }
 
     if (BU_STR_EQUAL(argv[1], "init")) {
@@ -247,6 +324,8 @@ main(int argc, char *argv[])
 	ret = test_bu_ptbl_cat(argc > 2 ? BU_STR_EQUAL(argv[2], "uniq") : 0);
     } else if (BU_STR_EQUAL(argv[1], "trunc")) {
 	ret = test_bu_ptbl_trunc();
+    } else if (BU_STR_EQUAL(argv[1], "index")) {
+	ret = test_bu_ptbl_index();
     }
 
     return ret;
@@ -54,6 +54,7 @@
 #include "wdb.h"
 #include "bu/sort.h"
 #include "bu/units.h"
+#include "bg/vert_tree.h"
 #include "bv/plot3.h"
 #include "obj_parser.h"
 #include "tri_face.h"
@@ -1909,14 +1910,16 @@ populate_fuse_map(struct ga_t *ga,
 		  int vertex_type)   /* FUSE_VERT or FUSE_TEX_VERT */
 {
     size_t idx1 = 0;
-    size_t idx2 = 0;
     size_t fuse_count = 0;
     fastf_t tmp_v1[3];
-    fastf_t tmp_v2[3];
+    fastf_t *tmp_v2;
     fastf_t distance_between_vertices = 0.0;
+    fastf_t tol_sq;
     size_t *fuse_map = (size_t *)NULL;
     short int *fuse_flag = (short int *)NULL;
     size_t fuse_offset = 0;
+    size_t *rep_list = (size_t *)NULL;
+    struct bg_vert_tree *tree;
 
     if (vertex_type == FUSE_TEX_VERT) {
 	fuse_map = gfi->texture_vertex_fuse_map;
@@ -1928,41 +1931,50 @@ populate_fuse_map(struct ga_t *ga,
 	fuse_offset = gfi->vertex_fuse_offset;
     }
 
-    /* the loop below is the expensive part of the fusing operation. */
+    tol_sq = (compare_type == FUSE_EQUAL) ? 0.0 : tol->dist_sq;
+
+    /* weld the vertices through a spatial hash so each one is only
+     * compared against the vertices in neighboring tolerance cells.
+     * the first vertex (in index order) of each welded set is the one
+     * the others are fused to, rep_list maps welded index to it.
+     */
+    tree = bg_vert_tree_create();
+    if (num_unique_index_list > 0)
+	rep_list = (size_t *)bu_malloc(sizeof(size_t) * num_unique_index_list, "rep_list");
+
+    for (idx1 = 0 ; idx1 < num_unique_index_list ; idx1++) {
+	size_t prev_vert = tree->curr_vert;
+	size_t k;
 
-    /* only set the flag for duplicates */
-    idx1 = 0;
-    while (idx1 < num_unique_index_list) {
-	if (fuse_flag[unique_index_list[idx1] - fuse_offset] == 0) {
-	    /* true if current vertex has not already been identified as a duplicate */
-	    idx2 = idx1 + 1;
-	    VMOVE(tmp_v1, ga->vert_list[unique_index_list[idx1]]);
-	    VSCALE(tmp_v1, tmp_v1, conv_factor);
+	VMOVE(tmp_v1, ga->vert_list[unique_index_list[idx1]]);
+	VSCALE(tmp_v1, tmp_v1, conv_factor);
+	k = bg_vert_tree_add(tree, V3ARGS(tmp_v1), tol_sq);
+
+	if (tree->curr_vert > prev_vert) {
+	    rep_list[k] = unique_index_list[idx1];
 	    fuse_map[unique_index_list[idx1] - fuse_offset] = unique_index_list[idx1];
-	    while (idx2 < num_unique_index_list) {
-		if (fuse_flag[unique_index_list[idx2] - fuse_offset] == 0) {
-		    VMOVE(tmp_v2, ga->vert_list[unique_index_list[idx2]]);
-		    VSCALE(tmp_v2, tmp_v2, conv_factor);
-		    if ((compare_type == FUSE_EQUAL) ? VEQUAL(tmp_v1, tmp_v2) :
-			bg_pnt3_pnt3_equal(tmp_v1, tmp_v2, tol)) {
-			if (ga->gcv_options->debug_mode) {
-			    distance_between_vertices = DIST_PNT_PNT(tmp_v1, tmp_v2);
-			    bu_log("found equal i1=(%zu)vi1=(%zu)v1=(%f)(%f)(%f), i2=(%zu)vi2=(%zu)v2=(%f)(%f)(%f), dist = (%lu mm)\n",
-				   idx1, unique_index_list[idx1], tmp_v1[0], tmp_v1[1], tmp_v1[2],
-				   idx2, unique_index_list[idx2], tmp_v2[0], tmp_v2[1], tmp_v2[2],
-				   (unsigned long)distance_between_vertices);
-			}
-			fuse_map[unique_index_list[idx2] - fuse_offset] = unique_index_list[idx1];
-			fuse_flag[unique_index_list[idx2] - fuse_offset] = 1;
-			fuse_count++;
-		    }
-		}
-		idx2++;
-	    }
+	    continue;
+	}
+
+	/* only set the flag for duplicates */
+	if (ga->gcv_options->debug_mode) {
+	    tmp_v2 = &tree->the_array[k*3];
+	    distance_between_vertices = DIST_PNT_PNT(tmp_v1, tmp_v2);
+	    bu_log("found equal vi1=(%zu)v1=(%f)(%f)(%f), i2=(%zu)vi2=(%zu)v2=(%f)(%f)(%f), dist = (%lu mm)\n",
+		   rep_list[k], tmp_v2[0], tmp_v2[1], tmp_v2[2],
+		   idx1, unique_index_list[idx1], tmp_v1[0], tmp_v1[1], tmp_v1[2],
+		   (unsigned long)distance_between_vertices);
 	}
-	idx1++;
+	fuse_map[unique_index_list[idx1] - fuse_offset] = rep_list[k];
+	fuse_flag[unique_index_list[idx1] - fuse_offset] = 1;
+	fuse_count++;
     }
 
+    if (rep_list)
+	bu_free(rep_list, "rep_list");
+    bg_vert_tree_destroy(tree);
+    bu_free(tree, "tree");
+
     if (ga->gcv_options->debug_mode) {
 	for (idx1 = 0 ; idx1 < num_unique_index_list ; idx1++) {
 	    bu_log("fused unique_index_list = (%zu)->(%zu)\n", unique_index_list[idx1],
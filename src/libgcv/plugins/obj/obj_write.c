@@ -34,6 +34,7 @@
 
 #include "raytrace.h"
 #include "gcv/api.h"
+#include "gcv/util.h"
 
 #define V3ARGS_SCALE(v, factor)       (v)[X] * (factor), (v)[Y] * (factor), (v)[Z] * (factor)
 
@@ -284,14 +285,18 @@ nmg_to_obj(struct conversion_state *pstate, struct nmgregion *r, const struct db
 }
 
 
-static void
+static int
 process_triangulation(struct conversion_state *pstate, struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *tsp)
 {
+    int ret = 0;
+
     if (!BU_SETJUMP) {
 	/* try */
 
-	/* Write the region to the TANKILL file */
-	nmg_to_obj(pstate, r, pathp, tsp->ts_regionid, tsp->ts_aircode, tsp->ts_los, tsp->ts_gmater, pstate->vlfree);
+	/* Triangulate while other regions are still being evaluated,
+	 * leaving nmg_to_obj() nothing to do but write.
+	 */
+	nmg_triangulate_model(r->m_p, pstate->vlfree, tsp->ts_tol);
 
     } else {
 	/* catch */
@@ -319,21 +324,25 @@ process_triangulation(struct conversion_state *pstate, struct nmgregion *r, cons
 
 	/* Now, make a new, clean model structure for next pass. */
 	*tsp->ts_m = nmg_mm();
+
+	ret = -1;
     }  BU_UNSETJUMP;
+
+    return ret;
 }
 
 
 static union tree *
 obj_write_process_boolean(const struct conversion_state *pstate, union tree *curtree, struct db_tree_state *tsp, const struct db_full_path *pathp, struct bu_list *vlfree)
 {
-    static union tree *ret_tree = TREE_NULL;
+    union tree *ret_tree = TREE_NULL;
 
     /* Begin bomb protection */
     if (!BU_SETJUMP) {
 	/* try */
 
 	(void)nmg_model_fuse(*tsp->ts_m, vlfree, tsp->ts_tol);
-	ret_tree = nmg_booltree_evaluate(curtree, vlfree, tsp->ts_tol, &rt_uniresource);
+	ret_tree = nmg_booltree_evaluate(curtree, vlfree, tsp->ts_tol, tsp->ts_resp);
 
     } else {
 	/* catch */
@@ -351,7 +360,7 @@ obj_write_process_boolean(const struct conversion_state *pstate, union tree *cur
 	nmg_isect2d_final_cleanup();
 
 	/* Release the tree memory & input regions */
-	db_free_tree(curtree, &rt_uniresource);/* Does an nmg_kr() */
+	db_free_tree(curtree, tsp->ts_resp);/* Does an nmg_kr() */
 
 	/* Get rid of (m)any other intermediate structures */
 	if ((*tsp->ts_m)->magic == NMG_MODEL_MAGIC) {
@@ -370,7 +379,47 @@ obj_write_process_boolean(const struct conversion_state *pstate, union tree *cur
 
 
 /*
- * Called from db_walk_tree().
+ * Called through gcv_region_emit() for one region at a time, in tree
+ * order.  r is NULL for regions that did not survive evaluation.
+ */
+static void
+obj_write_region(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *tsp, void *client_data)
+{
+    struct conversion_state *pstate = (struct conversion_state *)client_data;
+
+    if (RT_G_DEBUG&RT_DEBUG_TREEWALK || pstate->gcv_options->verbosity_level) {
+	char *sofar = db_path_to_string(pathp);
+	bu_log("\ndo_region_end(%zu %zu%%) %s\n",
+	       pstate->regions_tried,
+	       (pstate->regions_tried>0) ? (pstate->regions_converted * 100) / pstate->regions_tried : 0,
+	       sofar);
+	bu_free(sofar, "path string");
+    }
+
+    pstate->regions_tried++;
+    pstate->regions_converted++;
+
+    if (r) {
+	/* Write the region to the TANKILL file */
+	nmg_to_obj(pstate, r, pathp, tsp->ts_regionid, tsp->ts_aircode, tsp->ts_los, tsp->ts_gmater, pstate->vlfree);
+
+	pstate->regions_written++;
+    }
+
+    if (pstate->regions_tried) {
+	float npercent;
+	float tpercent;
+
+	npercent = (float)(pstate->regions_converted * 100) / pstate->regions_tried;
+	tpercent = (float)(pstate->regions_written * 100) / pstate->regions_tried;
+	bu_log("Tried %zu regions; %zu conv. to NMG's, %zu conv. to tri.; nmgper = %.2f%%, triper = %.2f%%\n",
+	       pstate->regions_tried, pstate->regions_converted, pstate->regions_written, npercent, tpercent);
+    }
+}
+
+
+/*
+ * Called from gcv_walk_regions().
  *
  * This routine must be prepared to run in parallel.
  */
@@ -390,20 +439,9 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
 
     BU_LIST_INIT(&vhead);
 
-    if (RT_G_DEBUG&RT_DEBUG_TREEWALK || pstate->gcv_options->verbosity_level) {
-	char *sofar = db_path_to_string(pathp);
-	bu_log("\ndo_region_end(%zu %zu%%) %s\n",
-	       pstate->regions_tried,
-	       (pstate->regions_tried>0) ? (pstate->regions_converted * 100) / pstate->regions_tried : 0,
-	       sofar);
-	bu_free(sofar, "path string");
-    }
-
     if (curtree->tr_op == OP_NOP)
 	return curtree;
 
-    pstate->regions_tried++;
-
     ret_tree = obj_write_process_boolean(pstate, curtree, tsp, pathp, pstate->vlfree);
 
     if (ret_tree)
@@ -411,8 +449,6 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
     else
 	r = (struct nmgregion *)NULL;
 
-    pstate->regions_converted++;
-
     if (r != 0) {
 	struct shell *s;
 	int empty_region=0;
@@ -438,18 +474,18 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
 	    empty_model = nmg_kill_zero_length_edgeuses(*tsp->ts_m);
 	}
 
-	if (!empty_region && !empty_model) {
-	    process_triangulation(pstate, r, pathp, tsp);
-
-	    pstate->regions_written++;
-
-	    BU_UNSETJUMP;
+	if (empty_region || empty_model || process_triangulation(pstate, r, pathp, tsp) < 0) {
+	    if (!empty_model)
+		nmg_kr(r);
+	    r = (struct nmgregion *)NULL;
 	}
 
-	if (!empty_model)
-	    nmg_kr(r);
+	/* the writer disposes of the region from here on */
+	ret_tree->tr_d.td_r = (struct nmgregion *)NULL;
     }
 
+    gcv_region_emit(tsp, pathp, r, obj_write_region, pstate);
+
     /* Dispose of original tree, so that all associated dynamic memory
      * is released now, not at the end of all regions.  A return of
      * TREE_NULL from this routine signals an error, and there is no
@@ -458,17 +494,7 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
      */
 
 
-    db_free_tree(curtree, &rt_uniresource);		/* Does an nmg_kr() */
-
-    if (pstate->regions_tried) {
-	float npercent;
-	float tpercent;
-
-	npercent = (float)(pstate->regions_converted * 100) / pstate->regions_tried;
-	tpercent = (float)(pstate->regions_written * 100) / pstate->regions_tried;
-	bu_log("Tried %zu regions; %zu conv. to NMG's, %zu conv. to tri.; nmgper = %.2f%%, triper = %.2f%%\n",
-	       pstate->regions_tried, pstate->regions_converted, pstate->regions_written, npercent, tpercent);
-    }
+    db_free_tree(curtree, tsp->ts_resp);		/* Does an nmg_kr() */
 
     BU_ALLOC(curtree, union tree);
     RT_TREE_INIT(curtree);
@@ -545,8 +571,8 @@ obj_write(struct gcv_context *context, const struct gcv_opts *gcv_options, const
     fprintf(state.fp, "\n");
 
     /* Walk indicated tree(s).  Each region will be output separately */
-    (void) db_walk_tree(context->dbip, state.gcv_options->num_objects, (const char **)state.gcv_options->object_names,
-	    1, &tree_state, NULL, do_region_end, rt_booltree_leaf_tess, (void *)&state);
+    (void) gcv_walk_regions(context->dbip, state.gcv_options->num_objects, (const char **)state.gcv_options->object_names,
+	    state.gcv_options->max_cpus, &tree_state, do_region_end, rt_booltree_leaf_tess, (void *)&state);
 
     if (state.regions_tried) {
 	double percent = ((double)state.regions_converted * 100.0) / state.regions_tried;
@@ -54,6 +54,14 @@ struct conversion_state
     struct wmember wm;                  /* handle for in-memory combinations */
 };
 
+/* face_cb() state, one per file read */
+struct face_state
+{
+    struct rt_bot_internal *bot;        /* bot the faces go into */
+    size_t max_faces;                   /* allocated length of the BOT face array, in faces */
+    int cur_face;                       /* face being filled in */
+};
+
 /* log_elements
  *
  * helper function which prints properties and instances to console when converting
@@ -137,12 +145,11 @@ color_cb(p_ply_argument argument)
 static int
 face_cb(p_ply_argument argument)
 {
-    static int cur_face = -1;
-    
     long list_len, vert_index;
-    struct rt_bot_internal bot;
-    struct rt_bot_internal *pbot = &bot;
+    struct face_state *fstate = NULL;
+    struct rt_bot_internal *pbot;
     int botval;
+    int cur_face;
     if (!ply_get_argument_property(argument, NULL, &list_len, &vert_index)) {
 	bu_bomb("Unable to import face lists");
     }
@@ -150,7 +157,9 @@ face_cb(p_ply_argument argument)
 	bu_log("ignoring face with %ld vertices\n", list_len);
 	return 1;
     }
-    ply_get_argument_user_data(argument, (void **)&pbot, NULL);
+    ply_get_argument_user_data(argument, (void **)&fstate, NULL);
+    pbot = fstate->bot;
+    cur_face = fstate->cur_face;
     botval = ply_get_argument_value(argument);
 
     switch (vert_index) {
@@ -165,9 +174,13 @@ face_cb(p_ply_argument argument)
 	    pbot->faces[cur_face*3+2] = botval;
 	    break;
 	case 3:
-	    /* need to break this into two BOT faces */
+	    /* need to break this into two BOT faces, growing geometrically
+	     * so meshes with many quads don't realloc once per quad */
 	    pbot->num_faces++;
-	    pbot->faces = (int *)bu_realloc(pbot->faces, pbot->num_faces * 3 * sizeof(int), "bot_faces");
+	    if (pbot->num_faces > fstate->max_faces) {
+		fstate->max_faces = fstate->max_faces * 2 > pbot->num_faces ? fstate->max_faces * 2 : pbot->num_faces;
+		pbot->faces = (int *)bu_realloc(pbot->faces, fstate->max_faces * 3 * sizeof(int), "bot_faces");
+	    }
 	    pbot->faces[cur_face*3+3] = botval;
 	    pbot->faces[cur_face*3+4] = pbot->faces[cur_face*3];
 	    pbot->faces[cur_face*3+5] = pbot->faces[cur_face*3+2];
@@ -177,6 +190,7 @@ face_cb(p_ply_argument argument)
 	    /* will never execute because lists of length > 4 are not allowed */
 	    break;
     }
+    fstate->cur_face = cur_face;
     return 1;
 }
 
@@ -186,6 +200,7 @@ convert_input(struct conversion_state* pstate)
     p_ply ply_fp;
     unsigned char rgb[3];
     int irgb[4] = {-1, -1, -1, 0};
+    struct face_state fstate = {NULL, 0, -1};
     struct bu_vls bot_name = BU_VLS_INIT_ZERO;
     struct bu_vls region_name = BU_VLS_INIT_ZERO;
     char* periodpos = NULL;
@@ -219,13 +234,15 @@ convert_input(struct conversion_state* pstate)
     ply_set_read_cb(ply_fp, "face", "red", color_cb, &irgb, 0);
     ply_set_read_cb(ply_fp, "face", "green", color_cb, &irgb, 1);
     ply_set_read_cb(ply_fp, "face", "blue", color_cb, &irgb, 2);
-    pstate->bot->num_faces = ply_set_read_cb(ply_fp, "face", "vertex_indices", face_cb, pstate->bot, 0);
+    fstate.bot = pstate->bot;
+    pstate->bot->num_faces = ply_set_read_cb(ply_fp, "face", "vertex_indices", face_cb, &fstate, 0);
 
     if (pstate->bot->num_faces < 1 || pstate->bot->num_vertices < 1) {
 	bu_log("This PLY file appears to contain no geometry!\n");
 	goto free_bot;
     }
     pstate->bot->faces = (int *)bu_calloc(pstate->bot->num_faces * 3, sizeof(int), "bot faces");
+    fstate.max_faces = pstate->bot->num_faces;
     pstate->bot->vertices = (fastf_t *)bu_calloc(pstate->bot->num_vertices * 3, sizeof(fastf_t), "bot vertices");
 
     if (!ply_read(ply_fp)) {
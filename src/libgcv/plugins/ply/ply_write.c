@@ -368,14 +368,18 @@ free_nmg:
 }
 
 
-static void
+static int
 process_triangulation(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *tsp, struct conversion_state* pstate)
 {
+    int ret = 0;
+
     if (!BU_SETJUMP) {
 	/* try */
 
-	/* Write the facetized region to the output file */
-	nmg_to_ply(r, pathp, tsp->ts_regionid, tsp->ts_gmater, tsp, pstate);
+	/* Triangulate while other regions are still being evaluated,
+	 * leaving nmg_to_ply() nothing to do but write.
+	 */
+	nmg_triangulate_model(r->m_p, pstate->vlfree, tsp->ts_tol);
     } else {
 	/* catch */
 
@@ -397,21 +401,25 @@ process_triangulation(struct nmgregion *r, const struct db_full_path *pathp, str
 
 	/* Now, make a new, clean model structure for next pass. */
 	*tsp->ts_m = nmg_mm();
+
+	ret = -1;
     }  BU_UNSETJUMP;
+
+    return ret;
 }
 
 
 static union tree *
 process_boolean(union tree *curtree, struct db_tree_state *tsp, const struct db_full_path *pathp, struct bu_list *vlfree)
 {
-    static union tree *ret_tree = TREE_NULL;
+    union tree *ret_tree = TREE_NULL;
 
     /* Begin bomb protection */
     if (!BU_SETJUMP) {
 	/* try */
 
 	(void)nmg_model_fuse(*tsp->ts_m, vlfree, tsp->ts_tol);
-	ret_tree = nmg_booltree_evaluate(curtree, vlfree, tsp->ts_tol, &rt_uniresource);
+	ret_tree = nmg_booltree_evaluate(curtree, vlfree, tsp->ts_tol, tsp->ts_resp);
     } else {
 	/* catch */
 	char *name = db_path_to_string(pathp);
@@ -423,7 +431,7 @@ process_boolean(union tree *curtree, struct db_tree_state *tsp, const struct db_
 	nmg_isect2d_final_cleanup();
 
 	/* Release the tree memory & input regions */
-	db_free_tree(curtree, &rt_uniresource);/* Does an nmg_kr() */
+	db_free_tree(curtree, tsp->ts_resp);/* Does an nmg_kr() */
 
 	/* Get rid of (m)any other intermediate structures */
 	if ((*tsp->ts_m)->magic == NMG_MODEL_MAGIC) {
@@ -441,8 +449,59 @@ process_boolean(union tree *curtree, struct db_tree_state *tsp, const struct db_
 }
 
 
+static void
+count_region(const struct db_full_path *pathp, struct conversion_state* pstate)
+{
+    if (pstate->ply_write_options->verbose || pstate->gcv_options->verbosity_level) {
+	char *sofar = db_path_to_string(pathp);
+	bu_log("\ndo_region_end(%d %d%%) %s\n",
+	       pstate->regions_tried,
+	       pstate->regions_tried>0 ? (pstate->regions_converted * 100) / pstate->regions_tried : 100,
+	       sofar);
+	bu_free(sofar, "path string");
+    }
+
+    pstate->regions_tried++;
+    pstate->regions_converted++;
+}
+
+
 /*
- * Called from db_walk_tree().
+ * Called through gcv_region_emit() for one region at a time, in tree
+ * order.  r is NULL for regions that failed to evaluate.
+ */
+static void
+write_region(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *tsp, void *client_data)
+{
+    struct conversion_state* pstate = (struct conversion_state*)client_data;
+
+    count_region(pathp, pstate);
+
+    if (r) {
+	/* Write the facetized region to the output file */
+	nmg_to_ply(r, pathp, tsp->ts_regionid, tsp->ts_gmater, tsp, pstate);
+
+	pstate->regions_written++;
+    }
+}
+
+
+/*
+ * As write_region(), for regions with nothing left after Boolean
+ * evaluation.
+ */
+static void
+write_empty_region(struct nmgregion *UNUSED(r), const struct db_full_path *pathp, struct db_tree_state *UNUSED(tsp), void *client_data)
+{
+    struct conversion_state* pstate = (struct conversion_state*)client_data;
+
+    count_region(pathp, pstate);
+    pstate->regions_written++; /* don't count as a failure */
+}
+
+
+/*
+ * Called from gcv_walk_regions().
  *
  * This routine must be prepared to run in parallel.
  */
@@ -462,23 +521,15 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
 
     BU_LIST_INIT(&vhead);
 
+    if (curtree->tr_op == OP_NOP)
+	return curtree;
+
     if (pstate->ply_write_options->verbose || pstate->gcv_options->verbosity_level) {
 	char *sofar = db_path_to_string(pathp);
-	bu_log("\ndo_region_end(%d %d%%) %s\n",
-	       pstate->regions_tried,
-	       pstate->regions_tried>0 ? (pstate->regions_converted * 100) / pstate->regions_tried : 100,
-	       sofar);
+	bu_log("Attempting to process region %s\n", sofar);
 	bu_free(sofar, "path string");
     }
 
-    if (curtree->tr_op == OP_NOP)
-	return curtree;
-
-    pstate->regions_tried++;
-
-    if (pstate->ply_write_options->verbose || pstate->gcv_options->verbosity_level)
-	bu_log("Attempting to process region %s\n", db_path_to_string(pathp));
-
     ret_tree = process_boolean(curtree, tsp, pathp, pstate->vlfree);
 
     if (ret_tree) {
@@ -486,12 +537,10 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
     } else {
 	if (pstate->ply_write_options->verbose || pstate->gcv_options->verbosity_level)
 	    bu_log("\tNothing left of this region after Boolean evaluation\n");
-	pstate->regions_written++; /* don't count as a failure */
+	gcv_region_emit(tsp, pathp, NULL, write_empty_region, pstate);
 	r = (struct nmgregion *)NULL;
     }
 
-    pstate->regions_converted++;
-
     if (r != (struct nmgregion *)NULL) {
 	struct shell *s;
 	int empty_region=0;
@@ -517,14 +566,15 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
 	    empty_model = nmg_kill_zero_length_edgeuses(*tsp->ts_m);
 	}
 
-	if (!empty_region && !empty_model) {
-	    process_triangulation(r, pathp, tsp, pstate);
-
-	    pstate->regions_written++;
+	if (empty_region || empty_model || process_triangulation(r, pathp, tsp, pstate) < 0) {
+	    if (!empty_model)
+		nmg_kr(r);
+	    r = (struct nmgregion *)NULL;
 	}
 
-	if (!empty_model)
-	    nmg_kr(r);
+	/* the writer disposes of the region from here on */
+	ret_tree->tr_d.td_r = (struct nmgregion *)NULL;
+	gcv_region_emit(tsp, pathp, r, write_region, pstate);
     }
 
     /*
@@ -535,7 +585,7 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
      * cons up an OP_NOP node to return.
      */
 
-    db_free_tree(curtree, &rt_uniresource); /* Does an nmg_kr() */
+    db_free_tree(curtree, tsp->ts_resp); /* Does an nmg_kr() */
 
     BU_ALLOC(curtree, union tree);
     RT_TREE_INIT(curtree);
@@ -718,12 +768,11 @@ ply_write_gcv(struct gcv_context* context, const struct gcv_opts* gcv_options, c
     state.v_tbl_regs = (struct bu_hash_tbl **) bu_calloc(state.tot_regions, sizeof(struct bu_hash_tbl*), "v_tbl_regs");
 
     /* Walk indicated tree(s).  Each region will be output separately */
-    (void) db_walk_tree(state.dbip, 
-    			gcv_options->num_objects, 
+    (void) gcv_walk_regions(state.dbip,
+			gcv_options->num_objects,
 			(const char**)gcv_options->object_names,
-			1,		/* ncpu */
+			gcv_options->max_cpus,
 			&tree_state,
-			0,		/* take all regions */
 			do_region_end,
 			rt_booltree_leaf_tess,
 			(void*)&state);
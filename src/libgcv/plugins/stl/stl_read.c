@@ -40,6 +40,8 @@
 
 #include "bu/cv.h"
 #include "bu/getopt.h"
+#include "bu/mapped_file.h"
+#include "bu/parallel.h"
 #include "bu/path.h"
 #include "bu/units.h"
 #include "bu/vls.h"
@@ -66,9 +68,20 @@ struct conversion_state
     const struct stl_read_options *stl_read_options;
 
     const char *input_file;	/* name of the input file */
-    FILE *fd_in;		/* input file */
+    struct bu_mapped_file *fd_in;	/* input file, mapped */
+    const char *buf;		/* contents of the input file */
+    size_t buflen;		/* length of buf */
+    size_t curr;		/* offset of the next unread byte in buf */
     struct rt_wdb *fd_out;	/* Resulting BRL-CAD file */
 
+    /* ASCII vertex coordinates are parsed ahead of the line reader, in
+     * parallel, one batch of lines at a time */
+    double *ascii_verts;	/* unscaled coordinates, three per vertex line */
+    size_t ascii_max;		/* capacity of ascii_verts, in vertices */
+    size_t ascii_next;		/* next vertex of the batch to hand out */
+    size_t batch_end;		/* offset where the parsed batch ends */
+    const double *vertex;	/* coordinates of the last line read, if it was a vertex line */
+
     struct wmember all_head;
     struct bg_vert_tree *tree;
     int *bot_faces;	        /* array of ints (indices into tree->the_array array) three per face */
@@ -84,6 +97,218 @@ struct conversion_state
 
 #define MAX_LINE_SIZE 512
 
+/* Binary files are decoded this many facets at a time */
+#define STL_BIN_BLOCK 4096
+
+/* ASCII files are parsed in batches of this many bytes, split into
+ * chunks that are handed out to the parsing threads */
+#define STL_ASCII_CHUNK (1024*1024)
+#define STL_ASCII_BATCH (64*STL_ASCII_CHUNK)
+
+
+struct stl_ascii_chunk
+{
+    size_t start;		/* offset of the first line of the chunk */
+    size_t end;			/* offset just past the last line of the chunk */
+    double *verts;		/* coordinates of the chunk's vertex lines */
+    size_t nverts;
+    size_t max_verts;
+};
+
+
+struct stl_ascii_batch
+{
+    const char *buf;
+    struct stl_ascii_chunk *chunks;
+    size_t nchunks;
+    size_t next;		/* next chunk to hand out */
+    int sem;
+};
+
+
+/* Returns the offset just past the end of the line containing "start" */
+static size_t
+stl_line_end(const char *buf, size_t buflen, size_t start)
+{
+    const char *nl = (const char *)memchr(buf + start, '\n', buflen - start);
+
+    return nl ? (size_t)(nl - buf) + 1 : buflen;
+}
+
+
+/* If the line in buf[start, end) is a vertex line, returns the offset
+ * of its coordinates, otherwise 0 */
+static size_t
+stl_vertex_line(const char *buf, size_t start, size_t end)
+{
+    while (start < end && isspace((int)buf[start]))
+	start++;
+
+    if (end - start < 6)
+	return 0;
+    if (bu_strncmp(&buf[start], "vertex", 6) && bu_strncmp(&buf[start], "VERTEX", 6))
+	return 0;
+
+    return start + 6;
+}
+
+
+static void
+stl_ascii_parse_chunk(const char *buf, struct stl_ascii_chunk *chunk)
+{
+    char line[MAX_LINE_SIZE];
+    size_t start = chunk->start;
+
+    while (start < chunk->end) {
+	size_t end = stl_line_end(buf, chunk->end, start);
+	size_t coords = stl_vertex_line(buf, start, end);
+
+	if (coords) {
+	    size_t len = end - coords;
+	    double *v;
+
+	    if (len > MAX_LINE_SIZE - 1)
+		len = MAX_LINE_SIZE - 1;
+	    memcpy(line, &buf[coords], len);
+	    line[len] = '\0';
+
+	    if (chunk->nverts >= chunk->max_verts) {
+		chunk->max_verts = chunk->max_verts ? chunk->max_verts * 2 : 1024;
+		chunk->verts = (double *)bu_realloc(chunk->verts, chunk->max_verts * 3 * sizeof(double), "stl chunk verts");
+	    }
+	    v = &chunk->verts[chunk->nverts * 3];
+	    VSETALL(v, 0.0);
+	    sscanf(line, "%lf%lf%lf", &v[0], &v[1], &v[2]);
+	    chunk->nverts++;
+	}
+	start = end;
+    }
+}
+
+
+static void
+stl_ascii_parse_worker(int UNUSED(cpu), void *data)
+{
+    struct stl_ascii_batch *batch = (struct stl_ascii_batch *)data;
+
+    while (1) {
+	size_t i;
+
+	bu_semaphore_acquire(batch->sem);
+	i = batch->next++;
+	bu_semaphore_release(batch->sem);
+
+	if (i >= batch->nchunks)
+	    return;
+
+	stl_ascii_parse_chunk(batch->buf, &batch->chunks[i]);
+    }
+}
+
+
+/* Parse the vertex lines of the next batch of lines, starting at the
+ * current read offset.  The line reader then hands out the results in
+ * file order, so the conversion itself stays serial. */
+static void
+stl_ascii_parse_batch(struct conversion_state *pstate)
+{
+    struct stl_ascii_batch batch;
+    size_t start = pstate->curr;
+    size_t end, total = 0, i;
+    size_t ncpu = pstate->gcv_options->max_cpus;
+
+    end = start + STL_ASCII_BATCH;
+    if (end >= pstate->buflen)
+	end = pstate->buflen;
+    else
+	end = stl_line_end(pstate->buf, pstate->buflen, end - 1);
+
+    batch.buf = pstate->buf;
+    batch.nchunks = (end - start) / STL_ASCII_CHUNK + 1;
+    batch.chunks = (struct stl_ascii_chunk *)bu_calloc(batch.nchunks, sizeof(struct stl_ascii_chunk), "stl chunks");
+    batch.next = 0;
+    batch.sem = bu_semaphore_register("gcv_sem_stl_read");
+
+    /* split at line boundaries, so every line belongs to exactly one chunk */
+    for (i = 0; i < batch.nchunks; i++) {
+	size_t cend = start + STL_ASCII_CHUNK;
+
+	if (cend >= end || i == batch.nchunks - 1)
+	    cend = end;
+	else
+	    cend = stl_line_end(pstate->buf, end, cend - 1);
+
+	batch.chunks[i].start = start;
+	batch.chunks[i].end = cend;
+	start = cend;
+    }
+
+    if (ncpu < 1)
+	ncpu = 1;
+    if (ncpu > batch.nchunks)
+	ncpu = batch.nchunks;
+
+    if (ncpu > 1)
+	bu_parallel(stl_ascii_parse_worker, ncpu, &batch);
+    else
+	stl_ascii_parse_worker(0, &batch);
+
+    for (i = 0; i < batch.nchunks; i++)
+	total += batch.chunks[i].nverts;
+
+    if (total > pstate->ascii_max) {
+	pstate->ascii_max = total;
+	pstate->ascii_verts = (double *)bu_realloc(pstate->ascii_verts, total * 3 * sizeof(double), "stl ascii verts");
+    }
+
+    total = 0;
+    for (i = 0; i < batch.nchunks; i++) {
+	struct stl_ascii_chunk *chunk = &batch.chunks[i];
+
+	if (chunk->nverts)
+	    memcpy(&pstate->ascii_verts[total * 3], chunk->verts, chunk->nverts * 3 * sizeof(double));
+	total += chunk->nverts;
+	if (chunk->verts)
+	    bu_free(chunk->verts, "stl chunk verts");
+    }
+    bu_free(batch.chunks, "stl chunks");
+
+    pstate->ascii_next = 0;
+    pstate->batch_end = end;
+}
+
+
+/* Reads the next line of an ASCII file into "line", truncating it to
+ * MAX_LINE_SIZE.  If it is a vertex line, pstate->vertex is set to
+ * its already parsed coordinates.  Returns NULL at end of file. */
+static char *
+stl_read_getline(struct conversion_state *pstate, char line[MAX_LINE_SIZE])
+{
+    size_t start = pstate->curr;
+    size_t end, len;
+
+    pstate->vertex = NULL;
+
+    if (start >= pstate->buflen)
+	return NULL;
+
+    if (start >= pstate->batch_end)
+	stl_ascii_parse_batch(pstate);
+
+    end = stl_line_end(pstate->buf, pstate->buflen, start);
+    len = end - start;
+    if (len > MAX_LINE_SIZE - 1)
+	len = MAX_LINE_SIZE - 1;
+    memcpy(line, &pstate->buf[start], len);
+    line[len] = '\0';
+    pstate->curr = end;
+
+    if (stl_vertex_line(pstate->buf, start, end))
+	pstate->vertex = &pstate->ascii_verts[3 * pstate->ascii_next++];
+
+    return line;
+}
+
 
 static void
 Add_face(struct conversion_state *pstate, int face[3])
@@ -205,7 +430,7 @@ Convert_part_ascii(struct conversion_state *pstate, char line[MAX_LINE_SIZE])
     if (pstate->gcv_options->verbosity_level)
 	bu_log("\tUsing solid name: %s\n", bu_vls_cstr(&solid_name));
 
-    while (bu_fgets(line1, MAX_LINE_SIZE, pstate->fd_in) != NULL) {
+    while (stl_read_getline(pstate, line1) != NULL) {
 	start = (-1);
 	while (isspace((int)line1[++start]));
 	if (!bu_strncmp(&line1[start], "endsolid", 8) || !bu_strncmp(&line1[start], "ENDSOLID", 8)) {
@@ -241,7 +466,7 @@ Convert_part_ascii(struct conversion_state *pstate, char line[MAX_LINE_SIZE])
 	    int tmp_face[3] = {0, 0, 0};
 
 	    while (!endloop) {
-		if (bu_fgets(line1, MAX_LINE_SIZE, pstate->fd_in) == NULL)
+		if (stl_read_getline(pstate, line1) == NULL)
 		    bu_exit(EXIT_FAILURE, "Unexpected EOF while reading a loop in a part!\n");
 
 		start = (-1);
@@ -249,10 +474,11 @@ Convert_part_ascii(struct conversion_state *pstate, char line[MAX_LINE_SIZE])
 
 		if (!bu_strncmp(&line1[start], "endloop", 7) || !bu_strncmp(&line1[start], "ENDLOOP", 7))
 		    endloop = 1;
-		else if (!bu_strncmp(&line1[start], "vertex", 6) || !bu_strncmp(&line1[start], "VERTEX", 6)) {
-		    double x, y, z;
-
-		    sscanf(&line1[start+6], "%lf%lf%lf", &x, &y, &z);
+		else if (pstate->vertex) {
+		    /* parsed ahead by stl_ascii_parse_batch() */
+		    double x = pstate->vertex[X];
+		    double y = pstate->vertex[Y];
+		    double z = pstate->vertex[Z];
 
 		    if (vert_no > 2) {
 			int n;
@@ -362,9 +588,11 @@ static void stl_read_lswap(unsigned int *v)
 static void
 Convert_part_binary(struct conversion_state *pstate)
 {
-    unsigned char buf[51];
+    unsigned char buf[4];
+    unsigned char *raw;
     unsigned long num_facets=0;
-    float flts[12];
+    size_t num_records, rec, nblock;
+    float *flts;
     vect_t normal;
     int tmp_face[3];
     struct wmember head;
@@ -372,16 +600,19 @@ Convert_part_binary(struct conversion_state *pstate)
     struct bu_vls region_name = BU_VLS_INIT_ZERO;
     int face_count=0;
     int degenerate_count=0;
-    size_t ret;
 
     bu_vls_strcat(&solid_name, "s.stl");
     bu_vls_strcat(&region_name, "r.stl");
     bu_log("\tUsing solid name: %s\n", bu_vls_cstr(&solid_name));
 
-
-    ret = fread(buf, 4, 1, pstate->fd_in);
-    if (ret != 1)
-	perror("fread");
+    if (pstate->buflen < pstate->curr + 4) {
+	bu_log("Unexpected EOF reading the facet count\n");
+	bu_vls_free(&region_name);
+	bu_vls_free(&solid_name);
+	return;
+    }
+    memcpy(buf, &pstate->buf[pstate->curr], 4);
+    pstate->curr += 4;
 
     /* swap bytes to convert from Little-endian to network order (big-endian) */
     stl_read_lswap((unsigned int *)buf);
@@ -390,29 +621,44 @@ Convert_part_binary(struct conversion_state *pstate)
     num_facets = ntohl(*(uint32_t *)buf);
 
     bu_log("\t%ld facets\n", num_facets);
-    while (fread(buf, 48, 1, pstate->fd_in)) {
-	int i;
+
+    /* each record is a normal and three vertices (48 bytes), followed
+     * by an unused 2 byte attribute count.  The last record may lack
+     * its attribute count. */
+    num_records = (pstate->buflen - pstate->curr + 2) / 50;
+
+    /* decode a block of records at a time straight from the mapped file */
+    raw = (unsigned char *)bu_malloc(STL_BIN_BLOCK * 48, "stl raw block");
+    flts = (float *)bu_malloc(STL_BIN_BLOCK * 12 * sizeof(float), "stl float block");
+
+    for (rec = 0; rec < num_records; rec++) {
+	size_t i = rec % STL_BIN_BLOCK;
 	double pt[3];
 
-	/* swap bytes to convert from Little-endian to network order (big-endian) */
-	for (i=0; i<12; i++) {
-	    stl_read_lswap((unsigned int *)&buf[i*4]);
-	}
+	if (i == 0) {
+	    size_t j;
+
+	    nblock = num_records - rec;
+	    if (nblock > STL_BIN_BLOCK)
+		nblock = STL_BIN_BLOCK;
+
+	    for (j = 0; j < nblock; j++)
+		memcpy(&raw[j*48], &pstate->buf[pstate->curr + (rec + j)*50], 48);
 
-	/* now use our network to native host format conversion tools */
-	bu_cv_ntohf((unsigned char *)flts, buf, 12);
+	    /* swap bytes to convert from Little-endian to network order (big-endian) */
+	    for (j = 0; j < nblock*12; j++)
+		stl_read_lswap((unsigned int *)&raw[j*4]);
 
-	/* unused attribute byte count */
-	ret = fread(buf, 2, 1, pstate->fd_in);
-	if (ret != 1)
-	    perror("fread");
+	    /* now use our network to native host format conversion tools */
+	    bu_cv_ntohf((unsigned char *)flts, raw, nblock*12);
+	}
 
-	VMOVE(normal, flts);
-	VSCALE(pt, &flts[3], pstate->gcv_options->scale_factor);
+	VMOVE(normal, &flts[i*12]);
+	VSCALE(pt, &flts[i*12+3], pstate->gcv_options->scale_factor);
 	tmp_face[0] = bg_vert_tree_add(pstate->tree, V3ARGS(pt), pstate->gcv_options->calculational_tolerance.dist_sq);
-	VSCALE(pt, &flts[6], pstate->gcv_options->scale_factor);
+	VSCALE(pt, &flts[i*12+6], pstate->gcv_options->scale_factor);
 	tmp_face[1] = bg_vert_tree_add(pstate->tree, V3ARGS(pt), pstate->gcv_options->calculational_tolerance.dist_sq);
-	VSCALE(pt, &flts[9], pstate->gcv_options->scale_factor);
+	VSCALE(pt, &flts[i*12+9], pstate->gcv_options->scale_factor);
 	tmp_face[2] = bg_vert_tree_add(pstate->tree, V3ARGS(pt), pstate->gcv_options->calculational_tolerance.dist_sq);
 
 	/* check for degenerate faces */
@@ -444,11 +690,17 @@ Convert_part_binary(struct conversion_state *pstate)
 	face_count++;
     }
 
+    bu_free(raw, "stl raw block");
+    bu_free(flts, "stl float block");
+    pstate->curr = pstate->buflen;
+
     /* Check if this part has any solid parts */
     if (face_count == 0) {
 	bu_log("\tpart has no solid parts, ignoring\n");
 	if (degenerate_count)
 	    bu_log("\t%d faces were degenerate\n", degenerate_count);
+	bu_vls_free(&region_name);
+	bu_vls_free(&solid_name);
 	return;
     } else {
 	if (degenerate_count)
@@ -483,6 +735,9 @@ Convert_part_binary(struct conversion_state *pstate)
 	pstate->id_no++;
     }
 
+    bu_vls_free(&region_name);
+    bu_vls_free(&solid_name);
+
     return;
 }
 
@@ -493,20 +748,16 @@ Convert_input(struct conversion_state *pstate)
     char line[ MAX_LINE_SIZE ];
 
     if (pstate->stl_read_options->binary) {
-	if (fread(line, 80, 1, pstate->fd_in) < 1) {
-	    if (feof(pstate->fd_in)) {
-		bu_exit(EXIT_FAILURE, "Unexpected EOF in input file!\n");
-	    } else {
-		bu_log("Error reading input file\n");
-		perror("gcv-stl");
-		bu_exit(EXIT_FAILURE, "Error reading input file\n");
-	    }
+	if (pstate->buflen < 80) {
+	    bu_exit(EXIT_FAILURE, "Unexpected EOF in input file!\n");
 	}
+	memcpy(line, pstate->buf, 80);
 	line[80] = '\0';
+	pstate->curr = 80;
 	bu_log("header data:\n%s\n\n", line);
 	Convert_part_binary(pstate);
     } else {
-	while (bu_fgets(line, MAX_LINE_SIZE, pstate->fd_in) != NULL) {
+	while (stl_read_getline(pstate, line) != NULL) {
 	    int start = 0;
 	    while (line[start] != '\0' && isspace((int)line[start])) {
 		start++;
@@ -575,11 +826,13 @@ stl_read(struct gcv_context *context, const struct gcv_opts *gcv_options, const
     struct rt_wdb *wdbp = wdb_dbopen(context->dbip, RT_WDB_TYPE_DB_INMEM);
     state.fd_out = wdbp;
 
-    if ((state.fd_in = fopen(source_path, "rb")) == NULL) {
+    if ((state.fd_in = bu_open_mapped_file(source_path, NULL)) == NULL) {
 	bu_log("Cannot open input file (%s)\n", source_path);
 	perror("libgcv");
 	bu_exit(1, NULL);
     }
+    state.buf = (const char *)state.fd_in->buf;
+    state.buflen = state.fd_in->buflen;
 
     mk_id_units(state.fd_out, "Conversion from Stereolithography format", "mm");
 
@@ -593,7 +846,9 @@ stl_read(struct gcv_context *context, const struct gcv_opts *gcv_options, const
     /* make a top level group */
     mk_lcomb(wdbp, "all", &state.all_head, 0, (char *)NULL, (char *)NULL, (unsigned char *)NULL, 0);
 
-    fclose(state.fd_in);
+    bu_close_mapped_file(state.fd_in);
+    if (state.ascii_verts)
+	bu_free(state.ascii_verts, "stl ascii verts");
 
     return 1;
 }
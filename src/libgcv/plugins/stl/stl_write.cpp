@@ -363,6 +363,7 @@ stl_write(struct gcv_context *context, const struct gcv_opts *gcv_options, const
     struct gcv_region_end_data gcvwriter;
 
     gcvwriter.write_region = nmg_to_stl;
+    gcvwriter.vlfree = &rt_vlfree;
     gcvwriter.client_data = &state;
 
     memset(&state, 0, sizeof(state));
@@ -420,13 +421,22 @@ stl_write(struct gcv_context *context, const struct gcv_opts *gcv_options, const
     state.vlfree = &rt_vlfree;
 
     /* Walk indicated tree(s).  Each region will be output separately */
-    (void) db_walk_tree(state.dbip, gcv_options->num_objects, (const char **)gcv_options->object_names,
-	    1,
-	    &tree_state,
-	    0,			/* take all regions */
-	    (gcv_options->tessellation_algorithm == GCV_TESS_MARCHING_CUBES)?gcv_region_end_mc:gcv_region_end,
-	    (gcv_options->tessellation_algorithm == GCV_TESS_MARCHING_CUBES)?NULL:rt_booltree_leaf_tess,
-	    (void *)&gcvwriter);
+    if (gcv_options->tessellation_algorithm == GCV_TESS_MARCHING_CUBES) {
+	(void) db_walk_tree(state.dbip, gcv_options->num_objects, (const char **)gcv_options->object_names,
+		1,
+		&tree_state,
+		0,			/* take all regions */
+		gcv_region_end_mc,
+		NULL,
+		(void *)&gcvwriter);
+    } else {
+	(void) gcv_walk_regions(state.dbip, gcv_options->num_objects, (const char **)gcv_options->object_names,
+		gcv_options->max_cpus,
+		&tree_state,
+		gcv_region_end,
+		rt_booltree_leaf_tess,
+		(void *)&gcvwriter);
+    }
 
     if (state.regions_tried>0) {
 	percent = ((double)state.regions_converted * 100) / state.regions_tried;
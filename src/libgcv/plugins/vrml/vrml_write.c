@@ -41,6 +41,7 @@
 #include "bu/getopt.h"
 #include "bu/units.h"
 #include "gcv/api.h"
+#include "gcv/util.h"
 #include "nmg.h"
 #include "rt/geom.h"
 #include "raytrace.h"
@@ -1051,19 +1052,21 @@ do_region_end2(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
 static union tree *
 vrml_write_process_boolean(struct conversion_state *pstate, union tree *curtree, struct db_tree_state *tsp, const struct db_full_path *pathp, struct bu_list *vlfree)
 {
-    static union tree *ret_tree = TREE_NULL;
+    union tree *ret_tree = TREE_NULL;
 
     /* Begin bomb protection */
     if (!BU_SETJUMP) {
 	/* try */
-	ret_tree = nmg_booltree_evaluate(curtree, vlfree, tsp->ts_tol, &rt_uniresource);
+	ret_tree = nmg_booltree_evaluate(curtree, vlfree, tsp->ts_tol, tsp->ts_resp);
     } else {
 	/* catch */
 	char *name = db_path_to_string(pathp);
 
 	bu_log("Conversion of %s FAILED due to error!!!\n", name);
 
+	bu_semaphore_acquire(BU_SEM_GENERAL);
 	pstate->bomb_cnt++;
+	bu_semaphore_release(BU_SEM_GENERAL);
 
 	/* Sometimes the NMG library adds debugging bits when
 	 * it detects an internal error, before before bombing out.
@@ -1080,6 +1083,31 @@ vrml_write_process_boolean(struct conversion_state *pstate, union tree *curtree,
 }
 
 
+/*
+ * Called through gcv_region_emit() for one region at a time, in tree
+ * order.  r is NULL for regions with nothing left to write.
+ */
+static void
+nmg_region_write(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *tsp, void *client_data)
+{
+    const struct region_end_data * const data = (struct region_end_data *)client_data;
+
+    if (RT_G_DEBUG&RT_DEBUG_TREEWALK || data->pstate->gcv_options->verbosity_level) {
+	bu_log("\nConverted %d%% so far (%d of %d)\n",
+	       data->pstate->regions_tried > 0 ? (data->pstate->regions_converted * 100) / data->pstate->regions_tried : 0,
+	       data->pstate->regions_converted, data->pstate->regions_tried);
+    }
+
+    data->pstate->regions_tried++;
+
+    if (r) {
+	/* Write the nmgregion to the output file */
+	nmg_2_vrml(data->pstate, tsp, pathp, r->m_p, data->vlfree);
+	data->pstate->regions_converted++;
+    }
+}
+
+
 static union tree *
 nmg_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union tree *curtree, void *client_data)
 {
@@ -1096,12 +1124,6 @@ nmg_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
 
     BU_LIST_INIT(&vhead);
 
-    if (RT_G_DEBUG&RT_DEBUG_TREEWALK || data->pstate->gcv_options->verbosity_level) {
-	bu_log("\nConverted %d%% so far (%d of %d)\n",
-	       data->pstate->regions_tried > 0 ? (data->pstate->regions_converted * 100) / data->pstate->regions_tried : 0,
-	       data->pstate->regions_converted, data->pstate->regions_tried);
-    }
-
     if (curtree->tr_op == OP_NOP) {
 	return curtree;
     }
@@ -1111,7 +1133,6 @@ nmg_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
     if (data->pstate->gcv_options->verbosity_level)
 	bu_log("Attempting %s\n", name);
 
-    data->pstate->regions_tried++;
     ret_tree = vrml_write_process_boolean(data->pstate, curtree, tsp, pathp, data->vlfree);
 
     if (ret_tree) {
@@ -1142,17 +1163,20 @@ nmg_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
 	}
 
 	if (!empty_region) {
-	    /* Write the nmgregion to the output file */
-	    nmg_2_vrml(data->pstate, tsp, pathp, r->m_p, data->vlfree);
-	    data->pstate->regions_converted++;
+	    /* the writer disposes of the region from here on */
+	    ret_tree->tr_d.td_r = (struct nmgregion *)NULL;
 	} else {
 	    bu_log("WARNING: Nothing left after Boolean evaluation of %s (due to cleanup)\n", name);
+	    r = (struct nmgregion *)NULL;
 	}
 
     } else {
 	bu_log("WARNING: Nothing left after Boolean evaluation of %s (due to error or null result)\n", name);
     }
 
+    /* nmg_2_vrml() triangulates as it writes, except for lights */
+    gcv_region_emit(tsp, pathp, r, nmg_region_write, client_data);
+
     NMG_CK_MODEL(*tsp->ts_m);
 
     /* Dispose of original tree, so that all associated dynamic
@@ -1160,7 +1184,7 @@ nmg_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
      * A return of TREE_NULL from this routine signals an error,
      * so we need to cons up an OP_NOP node to return.
      */
-    db_free_tree(curtree, &rt_uniresource); /* does a nmg_kr (i.e. kill nmg region) */
+    db_free_tree(curtree, tsp->ts_resp); /* does a nmg_kr (i.e. kill nmg region) */
     bu_free(name, "db_path_to_string");
 
     BU_ALLOC(curtree, union tree);
@@ -1244,8 +1268,7 @@ vrml_write(struct gcv_context *context, const struct gcv_opts *gcv_options, cons
 	return 0;
     }
 
-    struct db_tree_state initial_tree_state;
-    RT_DBTS_INIT(&initial_tree_state);
+    RT_DBTS_INIT(&tree_state);
     tree_state.ts_tol = &gcv_options->calculational_tolerance;
     tree_state.ts_ttol = &gcv_options->tessellation_tolerance;
     tree_state.ts_m = &the_model;
@@ -1297,16 +1320,19 @@ vrml_write(struct gcv_context *context, const struct gcv_opts *gcv_options, cons
     }
 
     if (state.vrml_write_options->eval_all) {
-	(void)db_walk_tree(context->dbip, gcv_options->num_objects, (const char **)gcv_options->object_names,
-			   1,		/* ncpu */
-			   &tree_state,
-			   0,
-			   nmg_region_end,
-			   rt_booltree_leaf_tess,
-			   (void *)&region_end_data);	/* in librt/nmg_bool.c */
+	(void)gcv_walk_regions(context->dbip, gcv_options->num_objects, (const char **)gcv_options->object_names,
+			       gcv_options->max_cpus,
+			       &tree_state,
+			       nmg_region_end,
+			       rt_booltree_leaf_tess,
+			       (void *)&region_end_data);	/* in librt/nmg_bool.c */
 	goto out;
     }
 
+    /* The modes below gather BoTs into the shared plate_mode as they
+     * go, so they walk serially.
+     */
+
     if (state.vrml_write_options->bot_dump) {
 	(void)db_walk_tree(context->dbip, gcv_options->num_objects, (const char **)gcv_options->object_names,
 			   1,		/* ncpu */
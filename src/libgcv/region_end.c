@@ -25,19 +25,86 @@
 
 #include "common.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "bu/avs.h"
+#include "bu/hash.h"
 #include "bu/parallel.h"
 #include "rt/wdb.h"
 #include "rt/global.h"
 #include "rt/resource.h"
 #include "rt/nmg_conv.h"
+#include "rt/rt_instance.h"
 #include "gcv.h"
 
 
+/* Attribute carrying a region's position in the tree from the first
+ * pass of db_walk_tree() to its region end callback.
+ */
+#define GCV_REGION_SEQ_ATTR "gcv_region_seq"
+
+/* A region waiting for its turn to be written. */
+struct gcv_region_write {
+    struct gcv_region_write *more;	/* next region that matched no slot */
+    struct nmgregion *r;
+    struct db_full_path path;
+    struct db_tree_state ts;
+    void (*write_region)(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *tsp, void *client_data);
+    void *client_data;
+};
+
+/* Leaves one thread of the second pass has seen in its current region. */
+struct gcv_region_cpu {
+    unsigned long long sig;	/* hash of the leaf paths so far */
+    int busy;			/* set from a region's first leaf to its end */
+};
+
+/* One region end call of the counting walk.  db_non_union_push() can
+ * give a region several subtrees, so a seq may own several slots; the
+ * leaf paths tell them apart.
+ */
+struct gcv_region_slot {
+    size_t seq;
+    unsigned long long sig;
+    int taken;			/* claimed by a region end call */
+};
+
+struct gcv_region_walk {
+    union tree *(*reg_end_func)(struct db_tree_state *, const struct db_full_path *, union tree *, void *);
+    union tree *(*leaf_func)(struct db_tree_state *, const struct db_full_path *, struct rt_db_internal *, void *);
+    void *client_data;
+    int sem;
+    size_t nregions;		/* sequence numbers handed out in the first pass */
+    size_t nslots;		/* region end calls, in the order a serial walk makes them */
+    struct gcv_region_slot *slots;
+    size_t *seq_first;		/* slots of seq i are seq_slots[seq_first[i]] on */
+    size_t *seq_slots;		/* slot numbers grouped by seq */
+    size_t next;		/* slots before this one have all been written */
+    int writing;		/* set while some thread is draining the queue */
+    struct gcv_region_write **pending;	/* queued regions, indexed by slot */
+    struct gcv_region_write *late;	/* regions that matched no slot */
+    struct gcv_region_cpu *cpus;	/* indexed by bu_parallel_id() */
+    struct model **models;	/* per-thread scratch models for tsp->ts_m */
+    struct model *write_model;	/* scratch model for deferred writes */
+};
+
+/* Region being processed by each thread under gcv_walk_regions() */
+static struct gcv_region_thread {
+    struct gcv_region_walk *walk;
+    size_t slot;
+    int emitted;
+} gcv_region_threads[MAX_PSW];
+
+
 union tree *
-_gcv_cleanup(int state, union tree *tp)
+_gcv_cleanup(struct db_tree_state *tsp, int state, union tree *tp)
 {
-    /* restore previous debug state */
-    nmg_debug = state;
+    /* restore previous debug state; gcv_walk_regions() does this
+     * once for all of its threads
+     */
+    if (!gcv_region_threads[bu_parallel_id()].walk)
+	nmg_debug = state;
 
     /* Dispose of original tree, so that all associated dynamic memory
      * is released now, not at the end of all regions.  A return of
@@ -45,7 +112,7 @@ _gcv_cleanup(int state, union tree *tp)
      * point to adding _another_ message to our output, so we need to
      * cons up an OP_NOP node to return.
      */
-    db_free_tree(tp, &rt_uniresource); /* Does an nmg_kr() */
+    db_free_tree(tp, tsp->ts_resp); /* Does an nmg_kr() */
 
     BU_ALLOC(tp, union tree);
     RT_TREE_INIT(tp);
@@ -95,7 +162,7 @@ gcv_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
     /* get a copy to play with as the parameters might get clobbered
      * by a longjmp.  FIXME: db_dup_subtree() doesn't create real copies
      */
-    tp = db_dup_subtree(curtree, &rt_uniresource);
+    tp = db_dup_subtree(curtree, tsp->ts_resp);
 
     /* FIXME: we can't free curtree until we get a "real" copy form
      * db_dup_subtree().  right now we get a fake copy just so we can
@@ -114,7 +181,7 @@ gcv_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
 	 * curtree to an evaluated result and returns it if the evaluation
 	 * is successful.
 	 */
-	ret_tree = nmg_booltree_evaluate(tp, vlfree, tsp->ts_tol, &rt_uniresource);
+	ret_tree = nmg_booltree_evaluate(tp, vlfree, tsp->ts_tol, tsp->ts_resp);
     } else {
 	/* catch */
 	/* Error, bail out */
@@ -139,7 +206,7 @@ gcv_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
 	/* Now, make a new, clean model structure for next pass. */
 	*tsp->ts_m = nmg_mm();
 
-	return _gcv_cleanup(NMG_debug_state, tp);
+	return _gcv_cleanup(tsp, NMG_debug_state, tp);
     } BU_UNSETJUMP; /* Relinquish bomb protection */
 
     r = (struct nmgregion *)NULL;
@@ -147,7 +214,7 @@ gcv_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
 	r = ret_tree->tr_d.td_r;
 
     if (r == (struct nmgregion *)NULL)
-	return _gcv_cleanup(NMG_debug_state, tp);
+	return _gcv_cleanup(tsp, NMG_debug_state, tp);
 
     /* Kill cracks */
     s = BU_LIST_FIRST(shell, &r->s_hd);
@@ -164,12 +231,12 @@ gcv_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
 	s = next_s;
     }
     if (empty_region)
-	return _gcv_cleanup(NMG_debug_state, tp);
+	return _gcv_cleanup(tsp, NMG_debug_state, tp);
 
     /* kill zero length edgeuses */
     empty_model = nmg_kill_zero_length_edgeuses(*tsp->ts_m);
     if (empty_model)
-	return _gcv_cleanup(NMG_debug_state, tp);
+	return _gcv_cleanup(tsp, NMG_debug_state, tp);
 
     if (BU_SETJUMP) {
 	/* Error, bail out */
@@ -195,17 +262,494 @@ gcv_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
 	*tsp->ts_m = nmg_mm();
 	nmg_kr(r);
 
-	return _gcv_cleanup(NMG_debug_state, tp);
+	return _gcv_cleanup(tsp, NMG_debug_state, tp);
+    } else {
+
+	/* Under gcv_walk_regions() the writer runs serially, so do
+	 * the triangulation here while other regions are in flight.
+	 */
+	if (gcv_region_threads[bu_parallel_id()].walk)
+	    nmg_triangulate_model(r->m_p, vlfree, tsp->ts_tol);
+
+    } BU_UNSETJUMP; /* Relinquish bomb protection */
+
+    /* Write the region out, which also disposes of it */
+    ret_tree->tr_d.td_r = (struct nmgregion *)NULL;
+    gcv_region_emit(tsp, pathp, r, data->write_region, data->client_data);
+
+    return _gcv_cleanup(tsp, NMG_debug_state, tp);
+}
+
+
+/* Write one region, with bomb protection, and release it. */
+static void
+_gcv_region_write(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *tsp,
+		  void (*write_region)(struct nmgregion *, const struct db_full_path *, struct db_tree_state *, void *),
+		  void *client_data)
+{
+    struct model *m;
+
+    if (!BU_SETJUMP) {
+	/* try */
+	if (write_region)
+	    write_region(r, pathp, tsp, client_data);
     } else {
+	/* catch */
+	char *sofar;
 
-	/* Write the region out */
-        data->write_region(r, pathp, tsp, data->client_data);
+	/* Relinquish bomb protection */
+	BU_UNSETJUMP;
+
+	sofar = db_path_to_string(pathp);
+	bu_log("FAILED in triangulator: %s\n", sofar);
+	bu_free((char *)sofar, "sofar");
+
+	/* Release any intersector 2d tables */
+	nmg_isect2d_final_cleanup();
+
+	/* Get rid of (m)any other intermediate structures */
+	if ((*tsp->ts_m)->magic == NMG_MODEL_MAGIC)
+	    nmg_km(*tsp->ts_m);
+	else
+	    bu_log("WARNING: tsp->ts_m pointer corrupted, ignoring it.\n");
 
+	/* Now, make a new, clean model structure for next pass. */
+	*tsp->ts_m = nmg_mm();
     } BU_UNSETJUMP; /* Relinquish bomb protection */
 
-    nmg_kr(r);
+    if (!r)
+	return;
+
+    /* rt_booltree_leaf_tess() gives every region a model of its own */
+    m = r->m_p;
+    if (nmg_kr(r) && m != *tsp->ts_m)
+	nmg_km(m);
+}
+
+
+static void
+_gcv_region_write_free(struct gcv_region_write *w)
+{
+    db_free_full_path(&w->path);
+    db_free_db_tree_state(&w->ts);
+    BU_PUT(w, struct gcv_region_write);
+}
+
+
+/* Fold the path of a leaf into the signature of its thread's region. */
+static void
+_gcv_walk_sign(struct gcv_region_walk *walk, const struct db_full_path *pathp)
+{
+    struct gcv_region_cpu *c = &walk->cpus[bu_parallel_id()];
+    char *str = db_path_to_string(pathp);
+
+    if (!c->busy) {
+	c->busy = 1;
+	c->sig = 0;
+    }
+    c->sig = c->sig * 1000003ULL ^ bu_data_hash(str, strlen(str));
+    bu_free(str, "path string");
+}
+
+
+/* Signature of the region a thread is ending, 0 if it had no leaves. */
+static unsigned long long
+_gcv_walk_sig(struct gcv_region_walk *walk)
+{
+    struct gcv_region_cpu *c = &walk->cpus[bu_parallel_id()];
+    unsigned long long sig = c->busy ? c->sig : 0;
+
+    c->busy = 0;
+    return sig;
+}
+
+
+/*
+ * Called with walk->sem held.  Find the slot of the counting walk
+ * this region end call corresponds to: the first free one with the
+ * same seq and leaves, else any free one with the same seq.  Returns
+ * walk->nslots if there is none.
+ */
+static size_t
+_gcv_walk_slot(struct gcv_region_walk *walk, size_t seq, unsigned long long sig)
+{
+    size_t i, any = walk->nslots;
+
+    if (seq >= walk->nregions)
+	return walk->nslots;
+
+    for (i = walk->seq_first[seq]; i < walk->seq_first[seq + 1]; i++) {
+	struct gcv_region_slot *sp = &walk->slots[walk->seq_slots[i]];
+
+	if (sp->taken)
+	    continue;
+	if (sp->sig == sig) {
+	    sp->taken = 1;
+	    return walk->seq_slots[i];
+	}
+	if (any == walk->nslots)
+	    any = walk->seq_slots[i];
+    }
+    if (any < walk->nslots)
+	walk->slots[any].taken = 1;
+    return any;
+}
+
+
+/* Remove and return the region due next, if it is queued. */
+static struct gcv_region_write *
+_gcv_walk_pop(struct gcv_region_walk *walk)
+{
+    struct gcv_region_write *w;
+
+    if (walk->next >= walk->nslots || !walk->pending[walk->next])
+	return NULL;
+    w = walk->pending[walk->next];
+    walk->pending[walk->next++] = NULL;
+    return w;
+}
+
+
+static struct gcv_region_write *
+_gcv_walk_queue(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *tsp,
+		void (*write_region)(struct nmgregion *, const struct db_full_path *, struct db_tree_state *, void *),
+		void *client_data)
+{
+    struct gcv_region_write *w;
+
+    BU_GET(w, struct gcv_region_write);
+    w->more = NULL;
+    w->r = r;
+    db_full_path_init(&w->path);
+    db_dup_full_path(&w->path, pathp);
+    db_dup_db_tree_state(&w->ts, tsp);
+    w->write_region = write_region;
+    w->client_data = client_data;
+    return w;
+}
+
+
+/*
+ * Write the region in slot now if every slot before it has been
+ * written and no other thread is busy writing, otherwise queue a copy
+ * of it for whichever thread gets there first.  The thread that
+ * writes also drains everything in the queue whose turn has come, so
+ * the output stays in the order of a serial walk.  A slot whose call
+ * never comes holds back everything after it until the walk is over.
+ */
+static void
+_gcv_walk_emit(struct gcv_region_walk *walk, size_t slot, struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *tsp,
+	       void (*write_region)(struct nmgregion *, const struct db_full_path *, struct db_tree_state *, void *),
+	       void *client_data)
+{
+    struct gcv_region_write *w;
+
+    if (!walk->slots) {
+	/* a serial walk makes the calls in order */
+	_gcv_region_write(r, pathp, tsp, write_region, client_data);
+	return;
+    }
+
+    bu_semaphore_acquire(walk->sem);
+
+    if (slot >= walk->nslots) {
+	/* the counting walk never saw this one, so it goes last */
+	w = _gcv_walk_queue(r, pathp, tsp, write_region, client_data);
+	w->more = walk->late;
+	walk->late = w;
+	bu_semaphore_release(walk->sem);
+	return;
+    }
+
+    if (walk->writing || slot != walk->next) {
+	/* a thread writing now drains this too, and with nobody
+	 * writing the slots before this one are not all in yet
+	 */
+	walk->pending[slot] = _gcv_walk_queue(r, pathp, tsp, write_region, client_data);
+	bu_semaphore_release(walk->sem);
+	return;
+    }
+
+    walk->writing = 1;
+    bu_semaphore_release(walk->sem);
+
+    _gcv_region_write(r, pathp, tsp, write_region, client_data);
+
+    bu_semaphore_acquire(walk->sem);
+    walk->next = slot + 1;
+    while ((w = _gcv_walk_pop(walk)) != NULL) {
+	bu_semaphore_release(walk->sem);
+
+	/* the thread that queued it may be using its own model and
+	 * resource for another region by now
+	 */
+	w->ts.ts_m = &walk->write_model;
+	w->ts.ts_resp = tsp->ts_resp;
+	_gcv_region_write(w->r, &w->path, &w->ts, w->write_region, w->client_data);
+	_gcv_region_write_free(w);
+
+	bu_semaphore_acquire(walk->sem);
+    }
+    walk->writing = 0;
+    bu_semaphore_release(walk->sem);
+}
+
+
+void
+gcv_region_emit(struct db_tree_state *tsp, const struct db_full_path *pathp, struct nmgregion *r,
+		void (*write_region)(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *tsp, void *client_data),
+		void *client_data)
+{
+    struct gcv_region_thread *t = &gcv_region_threads[bu_parallel_id()];
+
+    RT_CK_FULL_PATH(pathp);
+    if (r)
+	NMG_CK_REGION(r);
+
+    if (!t->walk) {
+	/* not under gcv_walk_regions(), nothing to wait for */
+	_gcv_region_write(r, pathp, tsp, write_region, client_data);
+	return;
+    }
+
+    t->emitted = 1;
+    _gcv_walk_emit(t->walk, t->slot, r, pathp, tsp, write_region, client_data);
+}
+
+
+static int
+_gcv_walk_region_start(struct db_tree_state *tsp, const struct db_full_path *UNUSED(pathp), const struct rt_comb_internal *UNUSED(combp), void *client_data)
+{
+    struct gcv_region_walk *walk = (struct gcv_region_walk *)client_data;
+    char seq[32];
+
+    /* the first pass runs serially, in tree order */
+    snprintf(seq, sizeof(seq), "%zu", walk->nregions++);
+    (void)bu_avs_add(&tsp->ts_attrs, GCV_REGION_SEQ_ATTR, seq);
+
+    return 0;
+}
+
+
+/* Read the sequence number the first pass gave a region. */
+static size_t
+_gcv_walk_seq(struct gcv_region_walk *walk, const struct db_tree_state *tsp)
+{
+    const char *seq = bu_avs_get(&tsp->ts_attrs, GCV_REGION_SEQ_ATTR);
+    size_t n = seq ? (size_t)strtoul(seq, NULL, 10) : 0;
+
+    return (n < walk->nregions) ? n : 0;
+}
+
+
+static union tree *
+_gcv_walk_leaf(struct db_tree_state *tsp, const struct db_full_path *pathp, struct rt_db_internal *ip, void *client_data)
+{
+    struct gcv_region_walk *walk = (struct gcv_region_walk *)client_data;
+
+    if (walk->slots)
+	_gcv_walk_sign(walk, pathp);
+
+    return walk->leaf_func(tsp, pathp, ip, walk->client_data);
+}
+
+
+static union tree *
+_gcv_walk_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union tree *curtree, void *client_data)
+{
+    struct gcv_region_walk *walk = (struct gcv_region_walk *)client_data;
+    struct gcv_region_thread *t = &gcv_region_threads[bu_parallel_id()];
+    struct gcv_region_thread saved = *t;
+    size_t seq = _gcv_walk_seq(walk, tsp);
+    union tree *ret;
+
+    t->walk = walk;
+    t->emitted = 0;
+    (void)bu_avs_remove(&tsp->ts_attrs, GCV_REGION_SEQ_ATTR);
+
+    if (walk->slots) {
+	unsigned long long sig = _gcv_walk_sig(walk);
+
+	bu_semaphore_acquire(walk->sem);
+	t->slot = _gcv_walk_slot(walk, seq, sig);
+	bu_semaphore_release(walk->sem);
+    } else {
+	t->slot = 0;
+    }
+
+    /* never let threads share the caller's model */
+    if (!walk->models[bu_parallel_id()])
+	walk->models[bu_parallel_id()] = nmg_mm();
+    tsp->ts_m = &walk->models[bu_parallel_id()];
+
+    ret = walk->reg_end_func(tsp, pathp, curtree, walk->client_data);
+
+    /* regions the callback dropped still take their turn */
+    if (!t->emitted)
+	_gcv_walk_emit(walk, t->slot, NULL, pathp, tsp, NULL, NULL);
+
+    *t = saved;
+    return ret;
+}
+
+
+/* The counting walk only needs the leaf paths, not the leaves. */
+static union tree *
+_gcv_count_leaf(struct db_tree_state *UNUSED(tsp), const struct db_full_path *pathp, struct rt_db_internal *UNUSED(ip), void *client_data)
+{
+    struct gcv_region_walk *walk = (struct gcv_region_walk *)client_data;
+    union tree *tp;
+
+    _gcv_walk_sign(walk, pathp);
+
+    BU_GET(tp, union tree);
+    RT_TREE_INIT(tp);
+    tp->tr_op = OP_NOP;
+    return tp;
+}
+
+
+static union tree *
+_gcv_count_region_end(struct db_tree_state *tsp, const struct db_full_path *UNUSED(pathp), union tree *curtree, void *client_data)
+{
+    struct gcv_region_walk *walk = (struct gcv_region_walk *)client_data;
+    struct gcv_region_slot *sp;
+
+    if (walk->nslots % 64 == 0)
+	walk->slots = (struct gcv_region_slot *)bu_realloc(walk->slots, (walk->nslots + 64) * sizeof(struct gcv_region_slot), "walk.slots");
+    sp = &walk->slots[walk->nslots++];
+    sp->seq = _gcv_walk_seq(walk, tsp);
+    sp->sig = _gcv_walk_sig(walk);
+    sp->taken = 0;
+
+    return curtree;
+}
+
+
+/*
+ * Walk the tree once on a single thread without evaluating anything,
+ * to learn the order db_walk_tree() makes its region end calls in.
+ * That order is not the order of the regions: db_non_union_push() may
+ * split a region into subtrees that are handed out apart.
+ */
+static void
+_gcv_walk_count(struct db_i *dbip, int argc, const char **argv, const struct db_tree_state *init_state, struct gcv_region_walk *walk)
+{
+    size_t i;
+
+    (void)db_walk_tree(dbip, argc, argv, 1, init_state, _gcv_walk_region_start, _gcv_count_region_end, _gcv_count_leaf, walk);
+
+    /* group the slots by seq, keeping their order within each */
+    walk->seq_first = (size_t *)bu_calloc(walk->nregions + 2, sizeof(size_t), "walk.seq_first");
+    walk->seq_slots = (size_t *)bu_calloc(walk->nslots + 1, sizeof(size_t), "walk.seq_slots");
+    for (i = 0; i < walk->nslots; i++)
+	walk->seq_first[walk->slots[i].seq + 2]++;
+    for (i = 2; i < walk->nregions + 2; i++)
+	walk->seq_first[i] += walk->seq_first[i - 1];
+    for (i = 0; i < walk->nslots; i++)
+	walk->seq_slots[walk->seq_first[walk->slots[i].seq + 1]++] = i;
+
+    walk->pending = (struct gcv_region_write **)bu_calloc(walk->nslots + 1, sizeof(struct gcv_region_write *), "walk.pending");
+}
+
+
+int
+gcv_walk_regions(struct db_i *dbip, int argc, const char **argv, size_t ncpu,
+		 const struct db_tree_state *init_state,
+		 union tree *(*reg_end_func)(struct db_tree_state *, const struct db_full_path *, union tree *, void *),
+		 union tree *(*leaf_func)(struct db_tree_state *, const struct db_full_path *, struct rt_db_internal *, void *),
+		 void *client_data)
+{
+    struct gcv_region_walk walk;
+    struct db_tree_state ts;
+    struct rt_i *rtip = NULL;
+    struct resource *resources = NULL;
+    size_t i;
+    int ret;
+    int nmg_debug_state = nmg_debug;
+
+    RT_CK_DBI(dbip);
+    RT_CK_DBTS(init_state);
+
+    if (ncpu == 0)
+	ncpu = bu_avail_cpus();
+    if (ncpu > MAX_PSW)
+	ncpu = MAX_PSW;
+
+    memset(&walk, 0, sizeof(walk));
+    walk.reg_end_func = reg_end_func;
+    walk.leaf_func = leaf_func;
+    walk.client_data = client_data;
+    walk.sem = bu_semaphore_register("gcv_sem_walk");
+    walk.cpus = (struct gcv_region_cpu *)bu_calloc(MAX_PSW, sizeof(struct gcv_region_cpu), "walk.cpus");
+    walk.models = (struct model **)bu_calloc(MAX_PSW, sizeof(struct model *), "walk.models");
+    walk.write_model = nmg_mm();
+
+    ts = *init_state; /* struct copy */
+    if (ncpu > 1) {
+	_gcv_walk_count(dbip, argc, argv, init_state, &walk);
+	walk.nregions = 0;
+
+	rtip = rt_new_rti(dbip);
+	resources = (struct resource *)bu_calloc(ncpu, sizeof(struct resource), "resources");
+	for (i = 0; i < ncpu; i++)
+	    rt_init_resource(&resources[i], (int)i, rtip);
+	ts.ts_rtip = rtip;
+    }
+
+    /* NMG may set debugging bits when it bombs; the region end
+     * callbacks leave them to be put back here, once all threads are
+     * done, rather than race over them
+     */
+    ret = db_walk_tree(dbip, argc, argv, (int)ncpu, &ts, _gcv_walk_region_start, _gcv_walk_region_end, _gcv_walk_leaf, &walk);
+    nmg_debug = nmg_debug_state;
+
+    /* Anything still queued was waiting on a slot whose call never
+     * came.  Write it out in order, then whatever matched no slot.
+     */
+    if (walk.pending) {
+	for (i = 0; i < walk.nslots; i++) {
+	    struct gcv_region_write *w = walk.pending[i];
+
+	    if (!w)
+		continue;
+	    walk.pending[i] = NULL;
+	    w->ts.ts_m = &walk.write_model;
+	    w->ts.ts_resp = &rt_uniresource;
+	    _gcv_region_write(w->r, &w->path, &w->ts, w->write_region, w->client_data);
+	    _gcv_region_write_free(w);
+	}
+	bu_free(walk.pending, "walk.pending");
+    }
+    while (walk.late) {
+	struct gcv_region_write *w = walk.late;
+
+	walk.late = w->more;
+	w->ts.ts_m = &walk.write_model;
+	w->ts.ts_resp = &rt_uniresource;
+	_gcv_region_write(w->r, &w->path, &w->ts, w->write_region, w->client_data);
+	_gcv_region_write_free(w);
+    }
+    if (walk.slots) {
+	bu_free(walk.slots, "walk.slots");
+	bu_free(walk.seq_first, "walk.seq_first");
+	bu_free(walk.seq_slots, "walk.seq_slots");
+    }
+    bu_free(walk.cpus, "walk.cpus");
+
+    for (i = 0; i < MAX_PSW; i++) {
+	if (walk.models[i])
+	    nmg_km(walk.models[i]);
+    }
+    bu_free(walk.models, "walk.models");
+    nmg_km(walk.write_model);
+
+    if (rtip) {
+	rt_free_rti(rtip);
+	bu_free(resources, "resources");
+    }
 
-    return _gcv_cleanup(NMG_debug_state, tp);
+    return ret;
 }
 
 
@@ -34,7 +34,7 @@
 
 
 /* in region_end.c */
-union tree * _gcv_cleanup(int state, union tree *tp);
+union tree * _gcv_cleanup(struct db_tree_state *tsp, int state, union tree *tp);
 
 union tree *
 gcv_region_end_mc(struct db_tree_state *tsp, const struct db_full_path *pathp, union tree *curtree, void *client_data)
@@ -134,12 +134,12 @@ gcv_region_end_mc(struct db_tree_state *tsp, const struct db_full_path *pathp, u
 	s = next_s;
     }
     if (empty_region)
-	return _gcv_cleanup(NMG_debug_state, tp);
+	return _gcv_cleanup(tsp, NMG_debug_state, tp);
 
     /* kill zero length edgeuses */
     empty_model = nmg_kill_zero_length_edgeuses(*tsp->ts_m);
     if (empty_model)
-	return _gcv_cleanup(NMG_debug_state, tp);
+	return _gcv_cleanup(tsp, NMG_debug_state, tp);
 
     if (!BU_SETJUMP) {
 	/* try */
@@ -170,13 +170,13 @@ gcv_region_end_mc(struct db_tree_state *tsp, const struct db_full_path *pathp, u
 	*tsp->ts_m = nmg_mm();
 	nmg_kr(r);
 
-	return _gcv_cleanup(NMG_debug_state, tp);
+	return _gcv_cleanup(tsp, NMG_debug_state, tp);
 
     } BU_UNSETJUMP; /* Relinquish bomb protection */
 
     nmg_kr(r);
 
-    return _gcv_cleanup(NMG_debug_state, tp);
+    return _gcv_cleanup(tsp, NMG_debug_state, tp);
 }
 
 
@@ -0,0 +1,216 @@
+/*                    W A L K _ O R D E R . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file libgcv/tests/walk_order.c
+ *
+ * Convert a tree of regions with gcv_walk_regions() on one thread and
+ * on several, and check that the written output is the same byte for
+ * byte.  Regions intersected and subtracted above the region level
+ * are split by db_non_union_push(), so some regions are written more
+ * than once and the pieces are handed to the threads apart.
+ */
+
+#include "common.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bu/app.h"
+#include "bu/log.h"
+#include "bu/ptbl.h"
+#include "bu/str.h"
+#include "bu/vls.h"
+#include "raytrace.h"
+#include "wdb.h"
+#include "gcv.h"
+
+#define NSPHERES 12
+#define NRUNS 4
+
+
+/* Record a region's path and the extent and size of its mesh. */
+static void
+walk_write_region(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree_state *UNUSED(tsp), void *client_data)
+{
+    struct bu_vls *out = (struct bu_vls *)client_data;
+    char *str = db_path_to_string(pathp);
+    struct bu_ptbl verts;
+    point_t min, max;
+    size_t i;
+
+    bu_vls_printf(out, "%s", str);
+    bu_free(str, "path string");
+
+    if (!r) {
+	bu_vls_printf(out, " empty\n");
+	return;
+    }
+
+    nmg_vertex_tabulate(&verts, &r->l.magic, &rt_vlfree);
+    VSETALL(min, MAX_FASTF);
+    VSETALL(max, -MAX_FASTF);
+    for (i = 0; i < BU_PTBL_LEN(&verts); i++) {
+	struct vertex *v = (struct vertex *)BU_PTBL_GET(&verts, i);
+
+	VMIN(min, v->vg_p->coord);
+	VMAX(max, v->vg_p->coord);
+    }
+    bu_vls_printf(out, " %zu (%.4f %.4f %.4f) (%.4f %.4f %.4f)\n", BU_PTBL_LEN(&verts), V3ARGS(min), V3ARGS(max));
+    bu_ptbl_free(&verts);
+}
+
+
+static void
+walk_convert(struct db_i *dbip, size_t ncpu, struct bu_vls *out)
+{
+    struct db_tree_state tree_state;
+    struct gcv_region_end_data data;
+    struct bn_tol tol = BN_TOL_INIT_TOL;
+    struct bg_tess_tol ttol = BG_TESS_TOL_INIT_TOL;
+    struct model *m = nmg_mm();
+    const char *top = "all";
+
+    RT_DBTS_INIT(&tree_state);
+    tree_state.ts_tol = &tol;
+    tree_state.ts_ttol = &ttol;
+    tree_state.ts_m = &m;
+
+    data.write_region = walk_write_region;
+    data.vlfree = &rt_vlfree;
+    data.client_data = (void *)out;
+
+    bu_vls_trunc(out, 0);
+    (void)gcv_walk_regions(dbip, 1, &top, ncpu, &tree_state, gcv_region_end, rt_booltree_leaf_tess, (void *)&data);
+
+    nmg_km(m);
+}
+
+
+static void
+walk_comb(struct rt_wdb *wdbp, const char *name, int region, const char *a, int op_b, const char *b, int op_c, const char *c)
+{
+    struct wmember head;
+
+    BU_LIST_INIT(&head.l);
+    (void)mk_addmember(a, &head.l, NULL, WMOP_UNION);
+    (void)mk_addmember(b, &head.l, NULL, op_b);
+    if (c)
+	(void)mk_addmember(c, &head.l, NULL, op_c);
+    if (mk_lcomb(wdbp, name, &head, region, NULL, NULL, NULL, 0) < 0)
+	bu_exit(1, "unable to make %s\n", name);
+}
+
+
+int
+main(int argc, char **argv)
+{
+    struct db_i *dbip;
+    struct rt_wdb *wdbp;
+    struct wmember all;
+    struct bu_vls serial = BU_VLS_INIT_ZERO;
+    struct bu_vls parallel = BU_VLS_INIT_ZERO;
+    const char *line, *next;
+    int i, fails = 0, repeated = 0;
+
+    bu_setprogname(argv[0]);
+
+    if (argc != 1)
+	bu_exit(1, "Usage: %s\n", argv[0]);
+
+    if ((dbip = db_open_inmem()) == DBI_NULL)
+	bu_exit(1, "Unable to create database instance\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+
+    /* a row of overlapping spheres of growing size, one region each,
+     * so the regions take different times to evaluate
+     */
+    for (i = 0; i < NSPHERES; i++) {
+	char sname[16], rname[16];
+	point_t center;
+
+	snprintf(sname, sizeof(sname), "s%d.s", i);
+	snprintf(rname, sizeof(rname), "r%d.r", i);
+	VSET(center, 1.5 * i, 0, 0);
+	mk_sph(wdbp, sname, center, 1.0 + 0.2 * i + ((i % 3) ? 0.0 : 0.7));
+	mk_comb1(wdbp, rname, sname, 1);
+    }
+
+    /* r0 + (r1 u r2) becomes (r0 + r1) u (r0 + r2), and
+     * (r5 u r6) - r7 becomes (r5 - r7) u (r6 - r7)
+     */
+    walk_comb(wdbp, "u12", 0, "r1.r", WMOP_UNION, "r2.r", 0, NULL);
+    walk_comb(wdbp, "split_i", 0, "r0.r", WMOP_INTERSECT, "u12", 0, NULL);
+    walk_comb(wdbp, "u56", 0, "r5.r", WMOP_UNION, "r6.r", 0, NULL);
+    walk_comb(wdbp, "split_s", 0, "u56", WMOP_SUBTRACT, "r7.r", 0, NULL);
+    walk_comb(wdbp, "u910", 0, "r9.r", WMOP_UNION, "r10.r", WMOP_UNION, "r11.r");
+    walk_comb(wdbp, "split_3", 0, "r8.r", WMOP_INTERSECT, "u910", 0, NULL);
+
+    BU_LIST_INIT(&all.l);
+    (void)mk_addmember("split_i", &all.l, NULL, WMOP_UNION);
+    (void)mk_addmember("r3.r", &all.l, NULL, WMOP_UNION);
+    (void)mk_addmember("split_s", &all.l, NULL, WMOP_UNION);
+    (void)mk_addmember("r4.r", &all.l, NULL, WMOP_UNION);
+    (void)mk_addmember("split_3", &all.l, NULL, WMOP_UNION);
+    if (mk_lcomb(wdbp, "all", &all, 0, NULL, NULL, NULL, 0) < 0)
+	bu_exit(1, "unable to make all\n");
+
+    walk_convert(dbip, 1, &serial);
+
+    /* the split regions must show up more than once */
+    for (line = bu_vls_cstr(&serial); (next = strchr(line, '\n')) != NULL; line = next + 1) {
+	const char *end = strchr(line, ' ');
+	size_t len = (end && end < next) ? (size_t)(end - line) : (size_t)(next - line);
+
+	if (strncmp(next + 1, line, len) == 0 && next[1 + len] == ' ')
+	    repeated++;
+    }
+    if (!repeated) {
+	bu_log("FAILED: no region was written more than once\n%s", bu_vls_cstr(&serial));
+	fails++;
+    }
+
+    for (i = 0; i < NRUNS; i++) {
+	walk_convert(dbip, 4, &parallel);
+	if (!BU_STR_EQUAL(bu_vls_cstr(&serial), bu_vls_cstr(&parallel))) {
+	    bu_log("FAILED: run %d on 4 threads differs from 1 thread\n1 thread:\n%s4 threads:\n%s",
+		   i, bu_vls_cstr(&serial), bu_vls_cstr(&parallel));
+	    fails++;
+	    break;
+	}
+    }
+
+    bu_log("%zu bytes written, %d regions repeated\n", bu_vls_strlen(&serial), repeated);
+
+    bu_vls_free(&serial);
+    bu_vls_free(&parallel);
+    db_close(dbip);
+
+    return fails != 0;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
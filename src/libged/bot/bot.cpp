@@ -573,7 +573,7 @@ extern "C" int
 _bot_cmd_isect(void *bs, int argc, const char **argv)
 {
     const char *usage_string = "bot [options] isect <objname> <objname2>";
-    const char *purpose_string = "(TODO) Test if BoT <objname> intersects with BoT <objname2>";
+    const char *purpose_string = "Test if BoT <objname> intersects with BoT <objname2>";
     if (_bot_cmd_msgs(bs, argc, argv, usage_string, purpose_string)) {
 	return BRLCAD_OK;
     }
@@ -613,8 +613,20 @@ _bot_cmd_isect(void *bs, int argc, const char **argv)
     int *faces_1 = bot->faces;
     int *faces_2 = bot_2->faces;
 
-    (void)bg_trimesh_isect(NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-			   faces_1, fc_1, verts_1, vc_1, faces_2, fc_2, verts_2, vc_2);
+    int *inside_1 = NULL, *inside_2 = NULL, *isect_1 = NULL, *isect_2 = NULL;
+    int n_inside_1 = 0, n_inside_2 = 0, n_isect_1 = 0, n_isect_2 = 0;
+    int isect = bg_trimesh_isect(&inside_1, &n_inside_1, &inside_2, &n_inside_2,
+				 &isect_1, &n_isect_1, &isect_2, &n_isect_2,
+				 faces_1, fc_1, verts_1, vc_1, faces_2, fc_2, verts_2, vc_2);
+
+    bu_vls_printf(gb->gedp->ged_result_str, "%s and %s %s\n", gb->dp->d_namep, bot_dp_2->d_namep, (isect) ? "intersect" : "do not intersect");
+    bu_vls_printf(gb->gedp->ged_result_str, "%s: %d intersecting faces, %d faces inside %s\n", gb->dp->d_namep, n_isect_1, n_inside_1, bot_dp_2->d_namep);
+    bu_vls_printf(gb->gedp->ged_result_str, "%s: %d intersecting faces, %d faces inside %s\n", bot_dp_2->d_namep, n_isect_2, n_inside_2, gb->dp->d_namep);
+
+    if (inside_1) bu_free(inside_1, "inside_1");
+    if (inside_2) bu_free(inside_2, "inside_2");
+    if (isect_1) bu_free(isect_1, "isect_1");
+    if (isect_2) bu_free(isect_2, "isect_2");
 
     rt_db_free_internal(&intern_2);
 
@@ -2915,12 +2915,13 @@ BViewState::redraw(struct bv_obj_settings *vs, std::unordered_set<struct bview *
     // work for the "top level" object used for adaptive cases, since shared
     // views will be using a shared object pool for anything other than their
     // view specific geometry sub-objects.
+    //
+    // The objects are independent of each other, so hand them to draw_scenes
+    // as a batch and let it spread the view independent work across threads.
+    std::vector<struct bv_scene_obj *> dobjs(objs.begin(), objs.end());
     for (v_it = views.begin(); v_it != views.end(); v_it++) {
-	std::unordered_set<struct bv_scene_obj *>::iterator o_it;
-	for (o_it = objs.begin(); o_it != objs.end(); o_it++) {
-	    bv_log(3, "redraw %s[%s]", bu_vls_cstr(&((*(*o_it)).s_name)), bu_vls_cstr(&((*(*v_it)).gv_name)));
-	    draw_scene(*o_it, *v_it);
-	}
+	bv_log(3, "redraw %zu objects[%s]", dobjs.size(), bu_vls_cstr(&((*(*v_it)).gv_name)));
+	draw_scenes(dobjs.data(), dobjs.size(), *v_it);
     }
 
     // We need to check if any drawn solids are selected.  If so, we need
@@ -27,6 +27,7 @@
 
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 #include <stdlib.h>
 #include <ctype.h>
@@ -37,6 +38,7 @@
 #include "bu/cmd.h"
 #include "bu/hash.h"
 #include "bu/opt.h"
+#include "bu/parallel.h"
 #include "bu/sort.h"
 #include "bu/str.h"
 #include "bv/defines.h"
@@ -50,7 +52,7 @@
 #include "./ged_private.h"
 
 static int
-prim_tess(struct bv_scene_obj *s, struct rt_db_internal *ip)
+prim_tess(struct bv_scene_obj *s, struct rt_db_internal *ip, struct bu_list *vlfree)
 {
     struct draw_update_data_t *d = (struct draw_update_data_t *)s->s_i_data;
     struct db_full_path *fp = (struct db_full_path *)s->s_path;
@@ -74,7 +76,7 @@ prim_tess(struct bv_scene_obj *s, struct rt_db_internal *ip)
     }
 
     NMG_CK_REGION(r);
-    nmg_r_to_vlist(&s->s_vlist, r, NMG_VLIST_STYLE_POLYGON, s->vlfree);
+    nmg_r_to_vlist(&s->s_vlist, r, NMG_VLIST_STYLE_POLYGON, vlfree);
     nmg_km(m);
 
     s->current = 1;
@@ -598,6 +600,126 @@ wireframe_plot(struct bv_scene_obj *s, struct bview *v, struct rt_db_internal *i
 }
 
 
+/* Crack the internal and generate the standard (non-LoD) geometry for s,
+ * per its drawing mode.  Only s is written to, so different objects may be
+ * processed concurrently as long as each thread supplies its own res and
+ * vlfree (installed with rt_vlfree_set for the librt plotting routines.)
+ * Returns 1 if geometry was generated and s needs draw_commit. */
+static int
+draw_geom(struct bv_scene_obj *s, struct bview *v, struct directory *dp, struct resource *res, struct bu_list *vlfree)
+{
+    struct draw_update_data_t *d = (struct draw_update_data_t *)s->s_i_data;
+    const struct bn_tol *tol = d->tol;
+    const struct bg_tess_tol *ttol = d->ttol;
+    struct rt_db_internal dbintern;
+    RT_DB_INTERNAL_INIT(&dbintern);
+    struct rt_db_internal *ip = &dbintern;
+    int ret = rt_db_get_internal(ip, dp, d->dbip, s->s_mat, res);
+    if (ret < 0)
+	return 0;
+
+    // If we don't have a BRL-CAD type, see if we've got a plot routine
+    if (ip->idb_major_type != DB5_MAJORTYPE_BRLCAD) {
+	wireframe_plot(s, v, ip);
+	goto geom_done;
+    }
+
+    // At least for the moment, we don't try anything fancy with pipes - they
+    // get a wireframe, regardless of mode settings
+    if (ip->idb_minor_type == DB5_MINORTYPE_BRLCAD_PIPE) {
+	wireframe_plot(s, v, ip);
+	goto geom_done;
+    }
+
+    // For anything other than mode 0, we call specific routines for
+    // some of the primitives.
+    if (s->s_os->s_dmode > 0) {
+	switch (ip->idb_minor_type) {
+	    case DB5_MINORTYPE_BRLCAD_BOT:
+		(void)rt_bot_plot_poly(&s->s_vlist, ip, ttol, tol);
+		goto geom_done;
+		break;
+	    case DB5_MINORTYPE_BRLCAD_POLY:
+		(void)rt_pg_plot_poly(&s->s_vlist, ip, ttol, tol);
+		goto geom_done;
+		break;
+	    case DB5_MINORTYPE_BRLCAD_BREP:
+		(void)rt_brep_plot_poly(&s->s_vlist, dp, ip, ttol, tol, NULL);
+		goto geom_done;
+		break;
+	    default:
+		break;
+	}
+    }
+
+    // Now the more general cases
+    switch (s->s_os->s_dmode) {
+	case 0:
+	case 1:
+	    // Get wireframe (for mode 1, all the non-wireframes are handled
+	    // by the above BOT/POLY/BREP cases
+	    wireframe_plot(s, v, ip);
+	    s->s_os->s_dmode = 0;
+	    break;
+	case 2:
+	    // Shade everything except pipe, don't evaluate, fall
+	    // back to wireframe in case of failure
+	    if (prim_tess(s, ip, vlfree) < 0) {
+		wireframe_plot(s, v, ip);
+		s->s_os->s_dmode = 0;
+	    } else {
+		s->current = 1;
+	    }
+	    break;
+	case 3:
+	    // Evaluated wireframes
+	    bu_log("Error - got too deep into _scene_obj_draw routine with drawing mode 3 - wireframe drawing with evaluated booleans\n");
+	    rt_db_free_internal(&dbintern);
+	    return 0;
+	    break;
+	case 4:
+	    // Hidden line - generate polygonal forms, fall back to
+	    // un-hidden wireframe in case of failure
+	    if (prim_tess(s, ip, vlfree) < 0) {
+		wireframe_plot(s, v, ip);
+		s->s_os->s_dmode = 0;
+	    } else {
+		s->current = 1;
+	    }
+	    break;
+	case 5:
+	    // Triangles at sampled points
+	    bu_log("Error - got too deep into _scene_obj_draw routine with drawing mode 5 - triangles at ray-sampled points\n");
+	    rt_db_free_internal(&dbintern);
+	    return 0;
+	    break;
+	default:
+	    // Default to wireframe
+	    wireframe_plot(s, v, ip);
+	    break;
+    }
+
+geom_done:
+    rt_db_free_internal(&dbintern);
+    return 1;
+}
+
+/* Record the bounds of freshly generated geometry and the view settings it
+ * was generated with.  Looks at the view objects, so this stays serial. */
+static void
+draw_commit(struct bv_scene_obj *s, struct bview *v)
+{
+    // Update s_size and s_center
+    bv_scene_obj_bound(s, v);
+
+    // Store current view info, in case of adaptive plotting
+    s->adaptive_wireframe = s->s_v->gv_s->adaptive_plot_csg;
+    s->view_scale = s->s_v->gv_scale;
+    s->bot_threshold= s->s_v->gv_s->bot_threshold;
+    s->curve_scale = s->s_v->gv_s->curve_scale;
+    s->point_scale = s->s_v->gv_s->point_scale;
+}
+
 extern "C" int draw_m3(struct bv_scene_obj *s);
 extern "C" int draw_points(struct bv_scene_obj *s);
 
@@ -657,7 +779,6 @@ draw_scene(struct bv_scene_obj *s, struct bview *v)
      * A couple of the object types will also have unique logic, typically for
      * special handling of difficult drawing cases.  Look for those as well.
      **************************************************************************/
-    struct db_i *dbip = d->dbip;
     struct db_full_path *fp = (struct db_full_path *)s->s_path;
     if (fp && fp->fp_len <= 0)
 	return;
@@ -683,109 +804,128 @@ draw_scene(struct bv_scene_obj *s, struct bview *v)
 
     /**************************************************************************
      * For the remainder of the options we're into more standard wireframe
-     * callback modes - crack the internal and stage the tolerances
+     * callback modes
      **************************************************************************/
-    const struct bn_tol *tol = d->tol;
-    const struct bg_tess_tol *ttol = d->ttol;
-    struct rt_db_internal dbintern;
-    RT_DB_INTERNAL_INIT(&dbintern);
-    struct rt_db_internal *ip = &dbintern;
-    int ret = rt_db_get_internal(ip, dp, dbip, s->s_mat, d->res);
-    if (ret < 0)
-	return;
+    if (draw_geom(s, v, dp, d->res, s->vlfree))
+	draw_commit(s, v);
+}
 
-    // If we don't have a BRL-CAD type, see if we've got a plot routine
-    if (ip->idb_major_type != DB5_MAJORTYPE_BRLCAD) {
-	wireframe_plot(s, v, ip);
-	goto geom_done;
-    }
+struct draw_scenes_state {
+    std::vector<struct bv_scene_obj *> *objs;
+    std::vector<struct directory *> *dps;
+    std::vector<int> *done;
+    struct resource *res;
+    struct bu_list *vlfree;
+    size_t next;	/* first object not yet handed out */
+    int sem;
+};
 
-    // At least for the moment, we don't try anything fancy with pipes - they
-    // get a wireframe, regardless of mode settings
-    if (ip->idb_minor_type == DB5_MINORTYPE_BRLCAD_PIPE) {
-	wireframe_plot(s, v, ip);
-	goto geom_done;
+static void
+draw_scenes_worker(int cpu, void *ptr)
+{
+    struct draw_scenes_state *state = (struct draw_scenes_state *)ptr;
+
+    // The librt plotting routines pull vlist entries from whichever free
+    // list this thread has installed - give each thread its own.
+    rt_vlfree_set(&state->vlfree[cpu]);
+
+    while (1) {
+	bu_semaphore_acquire(state->sem);
+	size_t i = state->next++;
+	bu_semaphore_release(state->sem);
+
+	if (i >= state->objs->size())
+	    break;
+
+	struct bv_scene_obj *s = (*state->objs)[i];
+	(*state->done)[i] = draw_geom(s, NULL, (*state->dps)[i], &state->res[cpu], &state->vlfree[cpu]);
     }
 
-    // For anything other than mode 0, we call specific routines for
-    // some of the primitives.
-    if (s->s_os->s_dmode > 0) {
-	switch (ip->idb_minor_type) {
-	    case DB5_MINORTYPE_BRLCAD_BOT:
-		(void)rt_bot_plot_poly(&s->s_vlist, ip, ttol, tol);
-		goto geom_done;
-		break;
-	    case DB5_MINORTYPE_BRLCAD_POLY:
-		(void)rt_pg_plot_poly(&s->s_vlist, ip, ttol, tol);
-		goto geom_done;
-		break;
-	    case DB5_MINORTYPE_BRLCAD_BREP:
-		(void)rt_brep_plot_poly(&s->s_vlist, dp, ip, ttol, tol, NULL);
-		goto geom_done;
-		break;
-	    default:
-		break;
+    rt_vlfree_set(NULL);
+}
+
+/* Draw a set of scene objects for view v.  Objects whose geometry doesn't
+ * depend on the view are generated concurrently - each writes only its own
+ * vlists - and everything else (adaptive LoD, evaluated modes 3 and 5) goes
+ * through draw_scene in the calling thread. */
+extern "C" void
+draw_scenes(struct bv_scene_obj **objs, size_t cnt, struct bview *v)
+{
+    if (!objs || !cnt)
+	return;
+
+    bool adaptive = (v && (v->gv_s->adaptive_plot_csg || v->gv_s->adaptive_plot_mesh));
+
+    // Flatten containers down to the objects that actually carry drawing
+    // data, and pick out the ones we can do in parallel.
+    std::vector<struct bv_scene_obj *> pending(objs, objs + cnt);
+    std::vector<struct bv_scene_obj *> pobjs;
+    std::vector<struct directory *> pdps;
+    while (!pending.empty()) {
+	struct bv_scene_obj *s = pending.back();
+	pending.pop_back();
+	if (!s)
+	    continue;
+	struct draw_update_data_t *d = (struct draw_update_data_t *)s->s_i_data;
+	if (!d) {
+	    for (size_t i = 0; i < BU_PTBL_LEN(&s->children); i++)
+		pending.push_back((struct bv_scene_obj *)BU_PTBL_GET(&s->children, i));
+	    continue;
 	}
+	if (s->current && !adaptive)
+	    continue;
+	if (adaptive || s->s_os->s_dmode == 3 || s->s_os->s_dmode == 5) {
+	    draw_scene(s, v);
+	    continue;
+	}
+	struct db_full_path *fp = (struct db_full_path *)s->s_path;
+	if (fp && fp->fp_len <= 0)
+	    continue;
+	struct directory *dp = (fp) ? DB_FULL_PATH_CUR_DIR(fp) : (struct directory *)s->dp;
+	if (!dp)
+	    continue;
+	pobjs.push_back(s);
+	pdps.push_back(dp);
     }
 
-    // Now the more general cases
-    switch (s->s_os->s_dmode) {
-	case 0:
-	case 1:
-	    // Get wireframe (for mode 1, all the non-wireframes are handled
-	    // by the above BOT/POLY/BREP cases
-	    wireframe_plot(s, v, ip);
-	    s->s_os->s_dmode = 0;
-	    break;
-	case 2:
-	    // Shade everything except pipe, don't evaluate, fall
-	    // back to wireframe in case of failure
-	    if (prim_tess(s, ip) < 0) {
-		wireframe_plot(s, v, ip);
-		s->s_os->s_dmode = 0;
-	    } else {
-		s->current = 1;
-	    }
-	    break;
-	case 3:
-	    // Evaluated wireframes
-	    bu_log("Error - got too deep into _scene_obj_draw routine with drawing mode 3 - wireframe drawing with evaluated booleans\n");
-	    return;
-	    break;
-	case 4:
-	    // Hidden line - generate polygonal forms, fall back to
-	    // un-hidden wireframe in case of failure
-	    if (prim_tess(s, ip) < 0) {
-		wireframe_plot(s, v, ip);
-		s->s_os->s_dmode = 0;
-	    } else {
-		s->current = 1;
-	    }
-	    break;
-	case 5:
-	    // Triangles at sampled points
-	    bu_log("Error - got too deep into _scene_obj_draw routine with drawing mode 5 - triangles at ray-sampled points\n");
-	    return;
-	    break;
-	default:
-	    // Default to wireframe
-	    wireframe_plot(s, v, ip);
-	    break;
+    size_t ncpu = bu_avail_cpus();
+    if (ncpu > pobjs.size())
+	ncpu = pobjs.size();
+
+    if (ncpu < 2) {
+	for (size_t i = 0; i < pobjs.size(); i++)
+	    draw_scene(pobjs[i], NULL);
+	return;
     }
 
-geom_done:
+    std::vector<int> done(pobjs.size(), 0);
+    struct draw_scenes_state state;
+    state.objs = &pobjs;
+    state.dps = &pdps;
+    state.done = &done;
+    state.next = 0;
+    state.sem = bu_semaphore_register("draw_scenes_sem_worker");
+    state.res = (struct resource *)bu_calloc(ncpu, sizeof(struct resource), "draw_scenes resources");
+    state.vlfree = (struct bu_list *)bu_calloc(ncpu, sizeof(struct bu_list), "draw_scenes vlfree");
+    for (size_t i = 0; i < ncpu; i++) {
+	rt_init_resource(&state.res[i], (int)i, NULL);
+	BU_LIST_INIT(&state.vlfree[i]);
+    }
 
-    // Update s_size and s_center
-    bv_scene_obj_bound(s, v);
+    bu_parallel(draw_scenes_worker, ncpu, (void *)&state);
 
-    // Store current view info, in case of adaptive plotting
-    s->adaptive_wireframe = s->s_v->gv_s->adaptive_plot_csg;
-    s->view_scale = s->s_v->gv_scale;
-    s->bot_threshold= s->s_v->gv_s->bot_threshold;
-    s->curve_scale = s->s_v->gv_s->curve_scale;
-    s->point_scale = s->s_v->gv_s->point_scale;
+    // Bounds and view bookkeeping go back through the serial path
+    for (size_t i = 0; i < pobjs.size(); i++) {
+	if (done[i])
+	    draw_commit(pobjs[i], NULL);
+    }
 
-    rt_db_free_internal(&dbintern);
+    for (size_t i = 0; i < ncpu; i++) {
+	BU_LIST_APPEND_LIST(&rt_vlfree, &state.vlfree[i]);
+	rt_clean_resource_basic(NULL, &state.res[i]);
+    }
+    bu_free(state.vlfree, "draw_scenes vlfree");
+    bu_free(state.res, "draw_scenes resources");
 }
 
 static void
@@ -54,8 +54,8 @@ struct analyze_densities *_gd_densities;
 char *_gd_densities_source;
 
 /* bu_getopt() options */
-const char *options = "A:a:de:f:g:Gn:N:p:P:qrS:s:t:U:u:vV:W:h?";
-const char *options_str = "[-A A|a|b|c|e|g|m|o|v|w] [-a az] [-d] [-e el] [-f densityFile] [-g spacing|upper,lower|upper-lower] [-G] [-n nhits] [-N nviews] [-p plotPrefix] [-P ncpus] [-q] [-r] [-S nsamples] [-t overlap_tol] [-U useair] [-u len_units vol_units wt_units] [-v] [-V volume_tol] [-W weight_tol]";
+const char *options = "A:a:de:f:g:Gn:N:p:P:qRrS:s:t:U:u:vV:W:h?";
+const char *options_str = "[-A A|a|b|c|e|g|m|o|v|w] [-a az] [-d] [-e el] [-f densityFile] [-g spacing|upper,lower|upper-lower] [-G] [-n nhits] [-N nviews] [-p plotPrefix] [-P ncpus] [-q] [-R] [-r] [-S nsamples] [-t overlap_tol] [-U useair] [-u len_units vol_units wt_units] [-v] [-V volume_tol] [-W weight_tol]";
 
 #define ANALYSIS_VOLUMES          1
 #define ANALYSIS_WEIGHTS          2
@@ -86,6 +86,9 @@ static char *densityFileName;
 static double gridSpacing;
 static double gridSpacingLimit;
 static const double GRIDSPACING_STEP = 1.0 / 2.0;
+static int use_adaptive_grid;
+static double adaptive_spacing;	/* finest spacing the adaptive grid reached */
+static double adaptive_error;	/* estimated volume error of the adaptive grid, averaged over the views */
 
 static char makeOverlapAssemblies;
 static size_t require_num_hits;
@@ -127,6 +130,8 @@ static int debug = 0;
 #define A_LENDEN a_color[0]
 #define A_LEN a_color[1]
 #define A_STATE a_uptr
+#define A_WEIGHT a_dist        /* area weight of the ray's cell, see adaptive_grid_next_ray() */
+#define A_CELLSCALE a_color[2] /* squared cell size factor for moments across the ray */
 
 
 struct cstate {
@@ -164,6 +169,10 @@ struct cstate {
     fastf_t *m_moi;       /* one vector per view for collecting the partial moments of inertia calculation */
     fastf_t *m_poi;       /* one vector per view for collecting the partial products of inertia calculation */
 
+    double cell_area;     /* area of a grid cell before the ray weight is applied */
+    struct adaptive_grid *grid;            /* non-NULL when shooting an adaptive grid */
+    struct adaptive_grid_sample *samples;  /* one per cpu, filled in by the hit routines */
+
     struct resource *resp;
 };
 
@@ -651,6 +660,9 @@ parse_args(struct ged *gedp, int ac, char *av[])
 	    case 'q':
 		quiet_missed_report = 1;
 		break;
+	    case 'R':
+		use_adaptive_grid = 1;
+		break;
 	    case 'r':
 		print_per_region_stats = 1;
 		break;
@@ -793,6 +805,13 @@ _gqa_overlap(struct application *ap,
 	/* too small to matter, pick one or none */
 	return 1;
 
+    if (state->samples)
+	state->samples[ap->a_resource->re_cpu].overlap = 1;
+
+    /* already reported by the ray this one corrects */
+    if (ap->A_WEIGHT < 0.0)
+	return 1;
+
     VJOIN1(ihit, rp->r_pt, ihitp->hit_dist, rp->r_dir);
     VJOIN1(ohit, rp->r_pt, ohitp->hit_dist, rp->r_dir);
 
@@ -903,12 +922,21 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
     double val;
     struct cstate *state = (struct cstate *)ap->A_STATE;
     struct ged *gedp = state->gedp;
+    struct adaptive_grid_sample *sample = NULL;
+
+    /* a negative weight takes back part of a ray that was already
+     * reported, so only the weighted sums are updated
+     */
+    int correction = (ap->A_WEIGHT < 0.0);
 
     if (!segs) /* unexpected */
 	return 0;
 
     if (PartHeadp->pt_forw == PartHeadp) return 1;
 
+    if (state->samples)
+	sample = &state->samples[ap->a_resource->re_cpu];
+
 
     /* examine each partition until we get back to the head */
     for (pp=PartHeadp->pt_forw; pp != PartHeadp; pp = pp->pt_forw) {
@@ -921,6 +949,11 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
 	VJOIN1(pt, ap->a_ray.r_pt, pp->pt_inhit->hit_dist, ap->a_ray.r_dir);
 	VJOIN1(opt, ap->a_ray.r_pt, pp->pt_outhit->hit_dist, ap->a_ray.r_dir);
 
+	if (sample) {
+	    sample->regions = sample->regions * 31 + (unsigned long)pp->pt_regionp->reg_bit + 1;
+	    sample->thickness += dist;
+	}
+
 	if (debug) {
 	    bu_semaphore_acquire(state->sem_worker);
 	    bu_vls_printf(gedp->ged_result_str, "%s %g->%g\n",
@@ -936,7 +969,7 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
 	 * tests the front exposure; and a second test below checks
 	 * the exit exposure.
 	 */
-	if (analysis_flags & ANALYSIS_EXP_AIR) {
+	if (!correction && (analysis_flags & ANALYSIS_EXP_AIR)) {
 
 	    /* FIXME: verify that the next partition is never
 	     * overlapping numerically with the current partition.
@@ -961,7 +994,7 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
 	}
 
 	/* looking for voids in the model */
-	if (analysis_flags & ANALYSIS_GAPS) {
+	if (!correction && (analysis_flags & ANALYSIS_GAPS)) {
 	    if (pp->pt_back != PartHeadp) {
 		double gap_dist;
 
@@ -1019,26 +1052,27 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
 		fastf_t Lx_sq;
 		fastf_t Ly_sq;
 		fastf_t Lz_sq;
-		fastf_t cell_area = gridSpacing*gridSpacing;
+		fastf_t cell_area = state->cell_area;
+		fastf_t cell_sq = cell_area * ap->A_CELLSCALE;
 		int los;
 
 		switch (state->i_axis) {
 		    case 0:
 			Lx_sq = dist*pp->pt_regionp->reg_los*0.01;
 			Lx_sq *= Lx_sq;
-			Ly_sq = cell_area;
-			Lz_sq = cell_area;
+			Ly_sq = cell_sq;
+			Lz_sq = cell_sq;
 			break;
 		    case 1:
-			Lx_sq = cell_area;
+			Lx_sq = cell_sq;
 			Ly_sq = dist*pp->pt_regionp->reg_los*0.01;
 			Ly_sq *= Ly_sq;
-			Lz_sq = cell_area;
+			Lz_sq = cell_sq;
 			break;
 		    case 2:
 		    default:
-			Lx_sq = cell_area;
-			Ly_sq = cell_area;
+			Lx_sq = cell_sq;
+			Ly_sq = cell_sq;
 			Lz_sq = dist*pp->pt_regionp->reg_los*0.01;
 			Lz_sq *= Lz_sq;
 			break;
@@ -1050,7 +1084,7 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
 		 */
 		los = pp->pt_regionp->reg_los;
 
-		if (los < 1) {
+		if (los < 1 && !correction) {
 		    const int MAX_PRINT = 10;
 		    static int printed = 0;
 		    static int warned = 0;
@@ -1066,7 +1100,7 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
 		}
 
 		/* accumulate the total weight values */
-		val = grams_per_cu_mm * dist * (pp->pt_regionp->reg_los * 0.01);
+		val = grams_per_cu_mm * dist * (pp->pt_regionp->reg_los * 0.01) * ap->A_WEIGHT;
 		ap->A_LENDEN += val;
 
 		prd = ((struct per_region_data *)pp->pt_regionp->reg_udata);
@@ -1141,7 +1175,8 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
 	/* compute the volume of the object */
 	if (analysis_flags & ANALYSIS_VOLUMES) {
 	    struct per_region_data *prd = ((struct per_region_data *)pp->pt_regionp->reg_udata);
-	    ap->A_LEN += dist; /* add to total volume */
+	    double wdist = dist * ap->A_WEIGHT;
+	    ap->A_LEN += wdist; /* add to total volume */
 	    {
 		// ensure we have an object and minimize reporting when we have errors
 		if (prd->optr == NULL) {
@@ -1158,10 +1193,10 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
 		bu_semaphore_acquire(state->sem_stats);
 
 		/* add to region volume */
-		prd->r_len[state->curr_view] += dist;
+		prd->r_len[state->curr_view] += wdist;
 
 		/* add to object volume */
-		prd->optr->o_len[state->curr_view] += dist;
+		prd->optr->o_len[state->curr_view] += wdist;
 
 		bu_semaphore_release(state->sem_stats);
 	    }
@@ -1172,7 +1207,7 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
 		bu_semaphore_release(state->sem_worker);
 	    }
 
-	    if (plot_volume) {
+	    if (plot_volume && !correction) {
 		VJOIN1(opt, ap->a_ray.r_pt, pp->pt_outhit->hit_dist, ap->a_ray.r_dir);
 
 		bu_semaphore_acquire(state->sem_plot);
@@ -1189,7 +1224,7 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
 
 
 	/* look for two adjacent air regions */
-	if (analysis_flags & ANALYSIS_ADJ_AIR) {
+	if (!correction && (analysis_flags & ANALYSIS_ADJ_AIR)) {
 	    if (last_air && pp->pt_regionp->reg_aircode &&
 		pp->pt_regionp->reg_aircode != last_air) {
 
@@ -1211,7 +1246,8 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
 	}
 
 	/* note that this region has been seen */
-	((struct per_region_data *)pp->pt_regionp->reg_udata)->hits++;
+	if (!correction)
+	    ((struct per_region_data *)pp->pt_regionp->reg_udata)->hits++;
 
 	last_air = pp->pt_regionp->reg_aircode;
 	last_out_dist = pp->pt_outhit->hit_dist;
@@ -1222,7 +1258,7 @@ _gqa_hit(struct application *ap, struct partition *PartHeadp, struct seg *segs)
     /* This checks the last partition was exposed air.  A check above
      * checks the partition entry for exposed air.
      */
-    if (analysis_flags & ANALYSIS_EXP_AIR && last_air) {
+    if (analysis_flags & ANALYSIS_EXP_AIR && last_air && !correction) {
 	pp = PartHeadp->pt_back;
 	_gqa_exposed_air(ap, pp, last_out_point, pt, opt);
     }
@@ -1295,6 +1331,8 @@ plane_worker(int cpu, void *ptr)
     ap.a_resource = &state->resp[cpu];
     ap.A_LENDEN = 0.0; /* really the cumulative length*density for weight computation*/
     ap.A_LEN = 0.0;    /* really the cumulative length for volume computation */
+    ap.A_WEIGHT = 1.0;
+    ap.A_CELLSCALE = 1.0;
 
     /* gross hack */
     ap.a_ray.r_dir[state->u_axis] = ap.a_ray.r_dir[state->v_axis] = 0.0;
@@ -1396,6 +1434,61 @@ plane_worker(int cpu, void *ptr)
 }
 
 
+/**
+ * Shoots the current round of rays of an adaptive grid.
+ *
+ * This routine must be prepared to run in parallel
+ */
+void
+adaptive_worker(int cpu, void *ptr)
+{
+    struct application ap;
+    struct cstate *state = (struct cstate *)ptr;
+    struct adaptive_grid_sample *sample;
+    size_t idx;
+
+    if (aborted)
+	return;
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = (struct rt_i *)state->rtip;	/* application uses this instance */
+    ap.a_hit = _gqa_hit;    /* where to go on a hit */
+    ap.a_miss = _gqa_miss;  /* where to go on a miss */
+    ap.a_logoverlap = logoverlap;
+    ap.a_overlap = _gqa_overlap;
+    ap.a_resource = &state->resp[cpu];
+    ap.A_LENDEN = 0.0; /* really the cumulative length*density for weight computation*/
+    ap.A_LEN = 0.0;    /* really the cumulative length for volume computation */
+    ap.A_STATE = ptr; /* really copying the state ptr to the a_uptr */
+
+    sample = &state->samples[ap.a_resource->re_cpu];
+
+    while (1) {
+	bu_semaphore_acquire(state->sem_worker);
+	if (adaptive_grid_next_ray(state->grid, &ap.a_ray, &idx, &ap.A_WEIGHT, &ap.A_CELLSCALE)) {
+	    bu_semaphore_release(state->sem_worker);
+	    break;
+	}
+	bu_semaphore_release(state->sem_worker);
+
+	ap.a_user = (int)idx;
+	memset(sample, 0, sizeof(struct adaptive_grid_sample));
+	(void)rt_shootray(&ap);
+
+	if (aborted)
+	    return;
+
+	adaptive_grid_record(state->grid, idx, sample);
+    }
+
+    /* shots are counted in top level cells once the view is done */
+    bu_semaphore_acquire(state->sem_stats);
+    state->m_lenDensity[state->curr_view] += ap.A_LENDEN; /* add our length*density value */
+    state->m_len[state->curr_view] += ap.A_LEN; /* add our volume value */
+    bu_semaphore_release(state->sem_stats);
+}
+
+
 struct per_obj_data*
 find_cmd_line_obj(struct ged *gedp, int objc, struct per_obj_data *obj_rpt, const char *name)
 {
@@ -2166,6 +2259,115 @@ terminate_check(struct ged *gedp, struct cstate *state)
 }
 
 
+/**
+ * Point the U, V and invariant axes of the state at the given view.
+ */
+static void
+set_view(struct cstate *state, int view)
+{
+    /* gross hack.  By assuming we have <= 3 views, we can let
+     * the view # indicate a coordinate axis.  Note this is
+     * used as an index into state.area[]
+     */
+    state->i_axis = state->curr_view = view;
+    state->u_axis = (state->curr_view+1) % 3;
+    state->v_axis = (state->curr_view+2) % 3;
+
+    state->u_dir[state->u_axis] = 1;
+    state->u_dir[state->v_axis] = 0;
+    state->u_dir[state->i_axis] = 0;
+
+    state->v_dir[state->u_axis] = 0;
+    state->v_dir[state->v_axis] = 1;
+    state->v_dir[state->i_axis] = 0;
+}
+
+
+/**
+ * Shoot every view once on an adaptive grid, refining only the cells
+ * whose neighboring rays differ in the regions they hit, their
+ * thickness or their overlap status.
+ */
+static void
+adaptive_views(struct ged *gedp, struct cstate *state)
+{
+    int axis, view;
+
+    for (axis = 0; axis < 3; axis++) {
+	state->steps[axis] = (long)ceil(state->span[axis] / gridSpacing);
+	if (state->steps[axis] < 1)
+	    state->steps[axis] = 1;
+    }
+
+    bu_log("Processing with adaptive grid spacing %g %s down to %g %s, %ld x %ld x %ld\n",
+	   gridSpacing / units[LINE]->val, units[LINE]->name,
+	   gridSpacingLimit / units[LINE]->val, units[LINE]->name,
+	   state->steps[0],
+	   state->steps[1],
+	   state->steps[2]);
+
+    adaptive_spacing = gridSpacing;
+    adaptive_error = 0.0;
+    state->samples = (struct adaptive_grid_sample *)bu_calloc(MAX_PSW, sizeof(struct adaptive_grid_sample), "adaptive samples");
+
+    for (view = 0; view < num_views; view++) {
+	struct adaptive_grid_stats stats;
+	vect_t ray_dir = VINIT_ZERO;
+	fastf_t thickness_tol = INFINITY;
+	double spacing;
+
+	if (verbose)
+	    bu_vls_printf(gedp->ged_result_str, "  view %d\n", view);
+
+	set_view(state, view);
+	ray_dir[state->i_axis] = 1.0;
+
+	/* keep the midpoint rule error of every cell within its share
+	 * of the volume tolerance, (area/view area) * tol
+	 */
+	if ((analysis_flags & ANALYSIS_VOLUMES) && volume_tolerance > 0.0)
+	    thickness_tol = 24.0 * volume_tolerance / state->area[view];
+
+	state->cell_area = (state->span[state->u_axis] / state->steps[state->u_axis]) *
+	    (state->span[state->v_axis] / state->steps[state->v_axis]);
+	state->grid = adaptive_grid_create(state->rtip->mdl_min, state->u_dir, state->v_dir, ray_dir,
+					   state->span[state->u_axis], state->span[state->v_axis],
+					   (size_t)state->steps[state->u_axis], (size_t)state->steps[state->v_axis],
+					   gridSpacingLimit, thickness_tol);
+	do {
+	    bu_parallel(adaptive_worker, ncpu, (void *)state);
+	} while (!aborted && adaptive_grid_refine(state->grid));
+
+	adaptive_grid_stats(state->grid, &stats);
+	adaptive_grid_destroy(state->grid);
+	state->grid = NULL;
+
+	if (aborted)
+	    break;
+
+	state->shots[view] += stats.cells;
+	spacing = FMIN(stats.u_size, stats.v_size) / pow(3.0, stats.level);
+	V_MIN(adaptive_spacing, spacing);
+	adaptive_error += stats.error / num_views;
+
+	if (verbose)
+	    bu_vls_printf(gedp->ged_result_str, "\t%zu rays, %zu cells down to level %d of %d, %zu unresolved, estimated volume error %g %s\n",
+			  stats.rays, stats.leaves, stats.level, stats.max_level, stats.unresolved,
+			  stats.error / units[VOL]->val, units[VOL]->name);
+
+	view_reports(gedp, state);
+    }
+
+    bu_free(state->samples, "adaptive samples");
+    state->samples = NULL;
+
+    if (!aborted) {
+	/* fills in the per-view values used in the summaries */
+	(void)weight_volume_terminate(gedp, state);
+    }
+}
+
+
 /**
  * summary_reports
  */
@@ -2177,7 +2379,14 @@ summary_reports(struct ged *gedp, struct cstate *state)
     double avg_mass;
     struct region *regp;
 
-    if (multiple_analyses)
+    if (use_adaptive_grid) {
+	if (multiple_analyses)
+	    bu_vls_printf(gedp->ged_result_str, "Summaries (%gmm grid spacing, adaptively refined to %gmm):\n", gridSpacing, adaptive_spacing);
+	else
+	    bu_vls_printf(gedp->ged_result_str, "Summary (%gmm grid spacing, adaptively refined to %gmm):\n", gridSpacing, adaptive_spacing);
+	bu_vls_printf(gedp->ged_result_str, "Estimated volume error: %g %s\n",
+		      adaptive_error / units[VOL]->val, units[VOL]->name);
+    } else if (multiple_analyses)
 	bu_vls_printf(gedp->ged_result_str, "Summaries (%gmm grid spacing):\n", gridSpacing / GRIDSPACING_STEP);
     else
 	bu_vls_printf(gedp->ged_result_str, "Summary (%gmm grid spacing):\n", gridSpacing / GRIDSPACING_STEP);
@@ -2544,6 +2753,7 @@ ged_gqa_core(struct ged *gedp, int argc, const char *argv[])
     num_views = 3;
     verbose = 0;
     quiet_missed_report = 0;
+    use_adaptive_grid = 0;
     plot_prefix = NULL;
     plot_weight = (FILE *)0;
     plot_volume = (FILE *)0;
@@ -2651,60 +2861,54 @@ ged_gqa_core(struct ged *gedp, int argc, const char *argv[])
     state.sem_plot = bu_semaphore_register("gqa_sem_plot");
     state.rtip = rtip;
     state.first = 1;
+    state.grid = NULL;
+    state.samples = NULL;
     allocate_per_region_data(gedp, &state, start_objs, argc, argv);
 
-    /* compute */
-    do {
-	double inv_spacing = 1.0/gridSpacing;
-	int view;
-
-	VSCALE(state.steps, state.span, inv_spacing);
-	state.steps[0] += 1;
-	state.steps[1] += 1;
-	state.steps[2] += 1;
-
-	bu_log("Processing with grid spacing %g %s %ld x %ld x %ld\n",
-	       gridSpacing / units[LINE]->val,
-	       units[LINE]->name,
-	       state.steps[0]-1,
-	       state.steps[1]-1,
-	       state.steps[2]-1);
+    if (use_adaptive_grid) {
+	adaptive_views(gedp, &state);
+	if (aborted)
+	    goto aborted;
+    } else {
+	do {
+	    double inv_spacing = 1.0/gridSpacing;
+	    int view;
 
+	    VSCALE(state.steps, state.span, inv_spacing);
+	    state.steps[0] += 1;
+	    state.steps[1] += 1;
+	    state.steps[2] += 1;
 
-	for (view=0; view < num_views; view++) {
+	    bu_log("Processing with grid spacing %g %s %ld x %ld x %ld\n",
+		   gridSpacing / units[LINE]->val,
+		   units[LINE]->name,
+		   state.steps[0]-1,
+		   state.steps[1]-1,
+		   state.steps[2]-1);
 
-	    if (verbose)
-		bu_vls_printf(gedp->ged_result_str, "  view %d\n", view);
+	    state.cell_area = gridSpacing*gridSpacing;
 
-	    /* gross hack.  By assuming we have <= 3 views, we can let
-	     * the view # indicate a coordinate axis.  Note this is
-	     * used as an index into state.area[]
-	     */
-	    state.i_axis = state.curr_view = view;
-	    state.u_axis = (state.curr_view+1) % 3;
-	    state.v_axis = (state.curr_view+2) % 3;
+	    for (view=0; view < num_views; view++) {
 
-	    state.u_dir[state.u_axis] = 1;
-	    state.u_dir[state.v_axis] = 0;
-	    state.u_dir[state.i_axis] = 0;
+		if (verbose)
+		    bu_vls_printf(gedp->ged_result_str, "  view %d\n", view);
 
-	    state.v_dir[state.u_axis] = 0;
-	    state.v_dir[state.v_axis] = 1;
-	    state.v_dir[state.i_axis] = 0;
-	    state.v = 1;
+		set_view(&state, view);
+		state.v = 1;
 
-	    bu_parallel(plane_worker, ncpu, (void *)&state);
+		bu_parallel(plane_worker, ncpu, (void *)&state);
 
-	    if (aborted)
-		goto aborted;
+		if (aborted)
+		    goto aborted;
 
-	    view_reports(gedp, &state);
-	}
+		view_reports(gedp, &state);
+	    }
 
-	state.first = 0;
-	gridSpacing *= GRIDSPACING_STEP;
+	    state.first = 0;
+	    gridSpacing *= GRIDSPACING_STEP;
 
-    } while (terminate_check(gedp, &state));
+	} while (terminate_check(gedp, &state));
+    }
 
 aborted:
     if (plot_overlaps) fclose(plot_overlaps);
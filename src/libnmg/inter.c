@@ -61,6 +61,8 @@
 
 #include "vmath.h"
 #include "bu/malloc.h"
+#include "bu/parallel.h"
+#include "bu/sort.h"
 #include "bn/mat.h"
 #include "bg/plane.h"
 #include "bv/plot3.h"
@@ -85,7 +87,8 @@ static int nmg_isect_edge2p_face2p(struct nmg_inter_struct *is,
 				   struct faceuse *eu_fu, struct bu_list *vlfree);
 
 
-static struct nmg_inter_struct *nmg_hack_last_is;	/* see nmg_isect2d_final_cleanup() */
+/* one per thread, see nmg_isect2d_final_cleanup() */
+static struct nmg_inter_struct *nmg_hack_last_is[MAX_PSW];
 
 struct vertexuse *
 nmg_make_dualvu(struct vertex *v, struct faceuse *fu, const struct bn_tol *tol)
@@ -546,7 +549,7 @@ nmg_isect2d_prep(struct nmg_inter_struct *is, const uint32_t *assoc_use)
     }
 
     nmg_isect2d_cleanup(is);
-    nmg_hack_last_is = is;
+    nmg_hack_last_is[bu_parallel_id()] = is;
 
     m = nmg_find_model(assoc_use);
 
@@ -627,7 +630,7 @@ nmg_isect2d_cleanup(struct nmg_inter_struct *is)
 {
     NMG_CK_INTER_STRUCT(is);
 
-    nmg_hack_last_is = (struct nmg_inter_struct *)NULL;
+    nmg_hack_last_is[bu_parallel_id()] = (struct nmg_inter_struct *)NULL;
 
     if (!is->vert2d) return;
     bu_free((char *)is->vert2d, "vert2d");
@@ -647,8 +650,10 @@ nmg_isect2d_cleanup(struct nmg_inter_struct *is)
 void
 nmg_isect2d_final_cleanup(void)
 {
-    if (nmg_hack_last_is && nmg_hack_last_is->magic == NMG_INTER_STRUCT_MAGIC)
-	nmg_isect2d_cleanup(nmg_hack_last_is);
+    struct nmg_inter_struct *is = nmg_hack_last_is[bu_parallel_id()];
+
+    if (is && is->magic == NMG_INTER_STRUCT_MAGIC)
+	nmg_isect2d_cleanup(is);
 }
 
 
@@ -2247,6 +2252,8 @@ nmg_isect_edge2p_face2p(struct nmg_inter_struct *is, struct edgeuse *eu1, struct
 
     bu_ptbl_init(&vert_list1, 64, "vert_list1 buffer");
     bu_ptbl_init(&vert_list2, 64, "vert_list1 buffer");
+    bu_ptbl_index(&vert_list1);
+    bu_ptbl_index(&vert_list2);
     bu_ptbl_init(&eu1_list, 64, "eu1_list1 buffer");
     bu_ptbl_init(&eu2_list, 64, "eu2_list1 buffer");
 
@@ -2292,6 +2299,8 @@ nmg_isect_edge2p_face2p(struct nmg_inter_struct *is, struct edgeuse *eu1, struct
 	nmg_edgeuse_tabulate(&eu1_list, &eu1->l.magic, vlfree);
     }
     nmg_edgeuse_tabulate(&eu2_list, &fu2->l.magic, vlfree);
+    bu_ptbl_index(&eu1_list);
+    bu_ptbl_index(&eu2_list);
 
     is->mag_len = 2 * (BU_PTBL_LEN(&eu1_list) + BU_PTBL_LEN(&eu2_list));
     mag1 = (fastf_t *)bu_calloc(is->mag_len, sizeof(fastf_t), "mag1");
@@ -2431,6 +2440,7 @@ nmg_coplanar_face_vertex_fuse(struct faceuse *fu1, struct faceuse *fu2, struct b
     size_t i;
 
     bu_ptbl_init(&verts, 128, "&verts");
+    bu_ptbl_index(&verts);
 
     faces[0] = fu1;
     faces[1] = fu1->fumate_p;
@@ -2794,6 +2804,8 @@ nmg_isect_two_face2p_jra(struct nmg_inter_struct *is, struct faceuse *fu1, struc
 
     bu_ptbl_init(&vert_list1, 64, " &vert_list1");
     bu_ptbl_init(&vert_list2, 64, " &vert_list2");
+    bu_ptbl_index(&vert_list1);
+    bu_ptbl_index(&vert_list2);
     is->l1 = &vert_list1;
     is->l2 = &vert_list2;
 
@@ -3768,6 +3780,7 @@ nmg_isect_eu_fu(struct nmg_inter_struct *is, struct bu_ptbl *verts, struct edgeu
 
     /* create a list of intersection vertices */
     bu_ptbl_init(&inters, 64, " &inters");
+    bu_ptbl_index(&inters);
 
     /* add vertices from fu to list */
     nmg_isect_eu_verts(eu, vg1, vg2, verts, &inters, &is->tol);
@@ -4045,6 +4058,7 @@ nmg_isect_fu_jra(struct nmg_inter_struct *is, struct faceuse *fu1, struct faceus
      */
     nmg_vertex_tabulate(&verts1, &fu1->l.magic, vlfree);
     nmg_vertex_tabulate(&verts2, &fu2->l.magic, vlfree);
+    bu_ptbl_index(&verts1);
 
     /* merge the two lists */
     for (i=0; i<BU_PTBL_LEN(&verts2); i++) {
@@ -5045,10 +5059,14 @@ nmg_isect_two_face3p(struct nmg_inter_struct *is, struct faceuse *fu1, struct fa
 
     bu_ptbl_init(&vert_list1, 64, "vert_list1 buffer");
     bu_ptbl_init(&vert_list2, 64, "vert_list2 buffer");
+    bu_ptbl_index(&vert_list1);
+    bu_ptbl_index(&vert_list2);
 
     /* Build list of all edgeuses in fu1 and fu2 */
     nmg_edgeuse_tabulate(&eu1_list, &fu1->l.magic, vlfree);
     nmg_edgeuse_tabulate(&eu2_list, &fu2->l.magic, vlfree);
+    bu_ptbl_index(&eu1_list);
+    bu_ptbl_index(&eu2_list);
 
     is->mag_len = 2 * (BU_PTBL_LEN(&eu1_list) + BU_PTBL_LEN(&eu2_list));
     mag1 = (fastf_t *)bu_calloc(is->mag_len, sizeof(fastf_t), "mag1");
@@ -6384,6 +6402,238 @@ out:
 }
 
 
+/* A face of one of the shells in nmg_crackshells(), for the face pair sweep */
+struct crack_face {
+    struct face *fp;
+    size_t idx;		/* index in the face table */
+};
+
+
+/* compare function for bu_sort of crack_face entries by X extent */
+static int
+crack_face_xcomp(const void *p1, const void *p2, void *UNUSED(arg))
+{
+    const struct crack_face *c1 = (const struct crack_face *)p1;
+    const struct crack_face *c2 = (const struct crack_face *)p2;
+
+    if (c1->fp->min_pt[X] > c2->fp->min_pt[X])
+	return 1;
+    if (c1->fp->min_pt[X] < c2->fp->min_pt[X])
+	return -1;
+    return (c1->idx > c2->idx) - (c1->idx < c2->idx);
+}
+
+
+/* compare function for bu_sort of (idx1, idx2) face pairs */
+static int
+crack_pair_comp(const void *p1, const void *p2, void *UNUSED(arg))
+{
+    const size_t *a = (const size_t *)p1;
+    const size_t *b = (const size_t *)p2;
+
+    if (a[0] != b[0])
+	return (a[0] > b[0]) ? 1 : -1;
+    return (a[1] > b[1]) - (a[1] < b[1]);
+}
+
+
+/**
+ * Collect the faces in table 'faces' whose extents reach into the
+ * box (min_pt, max_pt), sorted by the X minimum of their extents.
+ * Returns the number of faces stored into 'out'.
+ */
+static size_t
+crack_face_collect(struct crack_face *out, struct bu_ptbl *faces, const point_t min_pt, const point_t max_pt, fastf_t dist)
+{
+    size_t i;
+    size_t n = 0;
+
+    for (i = 0; i < BU_PTBL_LEN(faces); i++) {
+	struct face *fp = (struct face *)BU_PTBL_GET(faces, i);
+	NMG_CK_FACE(fp);
+	if (V3RPP_DISJOINT_TOL(fp->min_pt, fp->max_pt, min_pt, max_pt, dist))
+	    continue;
+	out[n].fp = fp;
+	out[n].idx = i;
+	n++;
+    }
+    if (n > 1)
+	bu_sort(out, n, sizeof(struct crack_face), crack_face_xcomp, NULL);
+    return n;
+}
+
+
+/**
+ * Sweep the X-sorted face lists 'a' and 'b' and record the face table
+ * index pair of each face of 'a' whose extents overlap a face of 'b'
+ * within 'dist'.  Each face scans forward only over the faces of the
+ * other list that start at or after it along X, so every overlapping
+ * pair is seen exactly once.  Pairs are appended to 'pairs' as
+ * (a idx, b idx), which is grown as needed.
+ *
+ * Returns the number of pairs.
+ */
+static size_t
+crack_face_sweep(size_t **pairs, size_t *pairs_max, const struct crack_face *a, size_t na, const struct crack_face *b, size_t nb, fastf_t dist)
+{
+    size_t ia = 0, ib = 0;
+    size_t npairs = 0;
+
+    while (ia < na || ib < nb) {
+	const struct crack_face *c;
+	const struct crack_face *other;
+	size_t nother, k;
+	int from_a;
+
+	/* take the next face in X order; ties go to list 'a' */
+	if (ib >= nb || (ia < na && a[ia].fp->min_pt[X] <= b[ib].fp->min_pt[X])) {
+	    c = &a[ia++];
+	    other = b;
+	    nother = nb;
+	    k = ib;
+	    from_a = 1;
+	} else {
+	    c = &b[ib++];
+	    other = a;
+	    nother = na;
+	    k = ia;
+	    from_a = 0;
+	}
+
+	for (; k < nother; k++) {
+	    const struct face *ofp = other[k].fp;
+	    if (ofp->min_pt[X] > c->fp->max_pt[X] + dist)
+		break;
+	    if (V3RPP_DISJOINT_TOL(c->fp->min_pt, c->fp->max_pt, ofp->min_pt, ofp->max_pt, dist))
+		continue;
+	    if (npairs >= *pairs_max) {
+		*pairs_max = (*pairs_max) ? *pairs_max * 2 : 64;
+		*pairs = (size_t *)bu_realloc(*pairs, *pairs_max * 2 * sizeof(size_t), "crack pairs");
+	    }
+	    (*pairs)[npairs*2] = (from_a) ? c->idx : other[k].idx;
+	    (*pairs)[npairs*2+1] = (from_a) ? other[k].idx : c->idx;
+	    npairs++;
+	}
+    }
+
+    return npairs;
+}
+
+
+/**
+ * Find the pairs of faces from tables faces1 and faces2 whose extents
+ * overlap each other and the box (min_pt, max_pt), sorted into the
+ * (faces1 index, faces2 index) order of a full double loop.
+ *
+ * Returns the number of pairs stored into 'pairs'.
+ */
+static size_t
+crack_face_pairs(size_t **pairs, size_t *pairs_max, struct bu_ptbl *faces1, struct bu_ptbl *faces2, const point_t min_pt, const point_t max_pt, fastf_t dist)
+{
+    struct crack_face *cf1, *cf2;
+    size_t ncf1, ncf2;
+    size_t npairs;
+
+    cf1 = (struct crack_face *)bu_malloc((BU_PTBL_LEN(faces1) + 1) * sizeof(struct crack_face), "cf1");
+    cf2 = (struct crack_face *)bu_malloc((BU_PTBL_LEN(faces2) + 1) * sizeof(struct crack_face), "cf2");
+    ncf1 = crack_face_collect(cf1, faces1, min_pt, max_pt, dist);
+    ncf2 = crack_face_collect(cf2, faces2, min_pt, max_pt, dist);
+    npairs = crack_face_sweep(pairs, pairs_max, cf1, ncf1, cf2, ncf2, dist);
+    if (npairs > 1)
+	bu_sort(*pairs, npairs, 2 * sizeof(size_t), crack_pair_comp, NULL);
+    bu_free(cf1, "cf1");
+    bu_free(cf2, "cf2");
+
+    return npairs;
+}
+
+
+/**
+ * Cutting the pair (i, j) grew face i of faces1 (if grew1) and/or face
+ * j of faces2 (if grew2).  Sweep just the grown faces against the
+ * other table for the pairs after (i, j) that they now overlap, and
+ * merge those into the sorted pairs remaining from index 'p' on.
+ *
+ * Returns the new number of pairs.
+ */
+static size_t
+crack_face_regrow(size_t **pairs, size_t *pairs_max, size_t p, size_t npairs, struct bu_ptbl *faces1, struct bu_ptbl *faces2, size_t i, size_t j, int grew1, int grew2, const point_t min_pt, const point_t max_pt, fastf_t dist)
+{
+    struct face *fp1 = (struct face *)BU_PTBL_GET(faces1, i);
+    struct face *fp2 = (struct face *)BU_PTBL_GET(faces2, j);
+    size_t *add, *merged;
+    size_t start = p;
+    size_t nadd = 0, nmerged = 0, a = 0, k;
+
+    add = (size_t *)bu_malloc((BU_PTBL_LEN(faces1) + BU_PTBL_LEN(faces2)) * 2 * sizeof(size_t), "crack added pairs");
+
+    /* the rest of row i, then column j below row i, already in pair order */
+    if (grew1 && !V3RPP_DISJOINT_TOL(fp1->min_pt, fp1->max_pt, min_pt, max_pt, dist)) {
+	for (k = j + 1; k < (size_t)BU_PTBL_LEN(faces2); k++) {
+	    const struct face *ofp = (const struct face *)BU_PTBL_GET(faces2, k);
+	    if (V3RPP_DISJOINT_TOL(ofp->min_pt, ofp->max_pt, min_pt, max_pt, dist)
+		|| V3RPP_DISJOINT_TOL(fp1->min_pt, fp1->max_pt, ofp->min_pt, ofp->max_pt, dist))
+		continue;
+	    add[nadd*2] = i;
+	    add[nadd*2+1] = k;
+	    nadd++;
+	}
+    }
+    if (grew2 && !V3RPP_DISJOINT_TOL(fp2->min_pt, fp2->max_pt, min_pt, max_pt, dist)) {
+	for (k = i + 1; k < (size_t)BU_PTBL_LEN(faces1); k++) {
+	    const struct face *ofp = (const struct face *)BU_PTBL_GET(faces1, k);
+	    if (V3RPP_DISJOINT_TOL(ofp->min_pt, ofp->max_pt, min_pt, max_pt, dist)
+		|| V3RPP_DISJOINT_TOL(fp2->min_pt, fp2->max_pt, ofp->min_pt, ofp->max_pt, dist))
+		continue;
+	    add[nadd*2] = k;
+	    add[nadd*2+1] = j;
+	    nadd++;
+	}
+    }
+    if (!nadd) {
+	bu_free(add, "crack added pairs");
+	return npairs;
+    }
+
+    merged = (size_t *)bu_malloc((npairs - p + nadd) * 2 * sizeof(size_t), "crack merged pairs");
+    while (p < npairs || a < nadd) {
+	const size_t *next;
+	int cmp;
+
+	if (a >= nadd)
+	    cmp = -1;
+	else if (p >= npairs)
+	    cmp = 1;
+	else
+	    cmp = crack_pair_comp(&(*pairs)[p*2], &add[a*2], NULL);
+
+	if (cmp <= 0) {
+	    next = &(*pairs)[p*2];
+	    p++;
+	    if (!cmp)
+		a++;
+	} else {
+	    next = &add[a*2];
+	    a++;
+	}
+	merged[nmerged*2] = next[0];
+	merged[nmerged*2+1] = next[1];
+	nmerged++;
+    }
+
+    /* the pairs before 'start' have been visited, keep them in place */
+    if (start + nmerged > *pairs_max) {
+	*pairs_max = start + nmerged;
+	*pairs = (size_t *)bu_realloc(*pairs, *pairs_max * 2 * sizeof(size_t), "crack pairs");
+    }
+    memcpy(&(*pairs)[start*2], merged, nmerged * 2 * sizeof(size_t));
+    bu_free(merged, "crack merged pairs");
+    bu_free(add, "crack added pairs");
+
+    return start + nmerged;
+}
+
+
 /**
  * Split the components of two shells wherever they may intersect,
  * in preparation for performing boolean operations on the shells.
@@ -6401,6 +6651,11 @@ nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, cons
     struct shell_a *sa1, *sa2;
     size_t i, j;
     point_t isect_min_pt, isect_max_pt;
+    point_t fp1_min, fp1_max, fp2_min, fp2_max;
+    size_t *pairs = NULL;
+    size_t pairs_max = 0;
+    size_t npairs, p;
+    int grew1, grew2;
 
     if (UNLIKELY(nmg_debug & NMG_DEBUG_POLYSECT)) {
 	bu_log("nmg_crackshells(s1=%p, s2=%p)\n", (void *)s1, (void *)s2);
@@ -6458,12 +6713,25 @@ nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, cons
 
     (void)bu_ptbl_init(&vert_list1, 64, "&vert_list1");
     (void)bu_ptbl_init(&vert_list2, 64, "&vert_list2");
+    bu_ptbl_index(&vert_list1);
+    bu_ptbl_index(&vert_list2);
 
     if (UNLIKELY(nmg_debug & NMG_DEBUG_VERIFY)) {
 	nmg_vshell(&s1->r_p->s_hd, s1->r_p);
 	nmg_vshell(&s2->r_p->s_hd, s2->r_p);
     }
 
+    /* Rather than trying every face of s1 against every face of s2,
+     * sweep the faces inside the common box along X and keep only the
+     * pairs whose extents overlap, visiting them in the same (i, j)
+     * order as the full double loop.  Cutting a pair of faces can add
+     * vertices to them, so their extents are brought up to date after
+     * each pair, and a face that has grown is swept again against the
+     * other table for the pairs still to come.
+     */
+    npairs = crack_face_pairs(&pairs, &pairs_max, &faces1, &faces2, isect_min_pt, isect_max_pt, tol->dist);
+
+    p = 0;
     for (i = 0; i < (size_t)BU_PTBL_LEN(&faces1); i++) {
 	fp1 = (struct face *)BU_PTBL_GET(&faces1, i);
 	NMG_CK_FACE(fp1);
@@ -6477,7 +6745,11 @@ nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, cons
 	    continue;
 	}
 
-	for (j = 0; j < (size_t)BU_PTBL_LEN(&faces2); j++) {
+	while (p < npairs && pairs[p*2] < i)
+	    p++;
+	while (p < npairs && pairs[p*2] == i) {
+	    j = pairs[p*2+1];
+	    p++;
 	    fp2 = (struct face *)BU_PTBL_GET(&faces2, j);
 	    NMG_CK_FACE(fp2);
 	    fu2 = fp2->fu_p;
@@ -6486,10 +6758,25 @@ nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, cons
 	    if (fu2->orientation == OT_OPPOSITE) {
 		fu2 = fu2->fumate_p;
 	    }
-	    if (V3RPP_DISJOINT_TOL(fp2->min_pt, fp2->max_pt, isect_min_pt, isect_max_pt, tol->dist)) {
-		continue;
-	    }
+
+	    VMOVE(fp1_min, fp1->min_pt);
+	    VMOVE(fp1_max, fp1->max_pt);
+	    VMOVE(fp2_min, fp2->min_pt);
+	    VMOVE(fp2_max, fp2->max_pt);
+
 	    nmg_isect_two_generic_faces(fu1, fu2, vlfree, tol);
+
+	    nmg_face_bb(fp1, tol);
+	    nmg_face_bb(fp2, tol);
+	    grew1 = !V3RPP1_IN_RPP2(fp1->min_pt, fp1->max_pt, fp1_min, fp1_max);
+	    grew2 = !V3RPP1_IN_RPP2(fp2->min_pt, fp2->max_pt, fp2_min, fp2_max);
+
+	    /* a face grew, so pairs after (i, j) it was culled from may
+	     * overlap now
+	     */
+	    if (grew1 || grew2)
+		npairs = crack_face_regrow(&pairs, &pairs_max, p, npairs, &faces1, &faces2, i, j, grew1, grew2,
+					   isect_min_pt, isect_max_pt, tol->dist);
 	}
 
 	/*
@@ -6529,6 +6816,8 @@ nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, cons
 	}
     }
 
+    if (pairs)
+	bu_free(pairs, "crack pairs");
     bu_ptbl_free(&faces1);
     bu_ptbl_free(&faces2);
 
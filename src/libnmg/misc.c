@@ -876,6 +876,7 @@ nmg_tabulate_face_g_verts(struct bu_ptbl *tab, const struct face_g_plane *fg)
     NMG_CK_FACE_G_PLANE(fg);
 
     bu_ptbl_init(tab, 64, " tab");
+    bu_ptbl_index(tab);
 
     /* loop through all faces using fg */
     for (BU_LIST_FOR (f, face, &fg->f_hd)) {
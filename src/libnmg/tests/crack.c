@@ -0,0 +1,277 @@
+/*                         C R A C K . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file crack.c
+ *
+ * Crack two shells with nmg_crackshells(), which culls the face pairs
+ * by their extents, and a clone of them with the full double loop over
+ * the faces, and check that every loop of both results has the same
+ * vertices in the same order.
+ */
+
+#include "common.h"
+
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/malloc.h"
+#include "bu/ptbl.h"
+#include "nmg.h"
+
+#define CRACK_GRID 6
+
+static struct faceuse *
+crack_quad(struct shell *s, const fastf_t *p0, const fastf_t *p1, const fastf_t *p2, const fastf_t *p3, const struct bn_tol *tol)
+{
+    struct vertex *verts[4] = {NULL, NULL, NULL, NULL};
+    struct faceuse *fu;
+
+    fu = nmg_cface(s, verts, 4);
+    nmg_vertex_gv(verts[0], p0);
+    nmg_vertex_gv(verts[1], p1);
+    nmg_vertex_gv(verts[2], p2);
+    nmg_vertex_gv(verts[3], p3);
+    if (nmg_fu_planeeqn(fu, tol) < 0)
+	bu_exit(1, "crack: degenerate face\n");
+    return fu;
+}
+
+
+/* a flat grid of unit squares, and tilted and coplanar faces through it */
+static struct model *
+crack_model(const struct bn_tol *tol)
+{
+    struct model *m = nmg_mm();
+    struct nmgregion *r1 = nmg_mrsv(m);
+    struct nmgregion *r2 = nmg_mrsv(m);
+    struct shell *s1 = BU_LIST_FIRST(shell, &r1->s_hd);
+    struct shell *s2 = BU_LIST_FIRST(shell, &r2->s_hd);
+    point_t p0, p1, p2, p3;
+    int i, j;
+
+    for (i = 0; i < CRACK_GRID; i++) {
+	for (j = 0; j < CRACK_GRID; j++) {
+	    VSET(p0, i, j, 0);
+	    VSET(p1, i + 1, j, 0);
+	    VSET(p2, i + 1, j + 1, 0);
+	    VSET(p3, i, j + 1, 0);
+	    (void)crack_quad(s1, p0, p1, p2, p3, tol);
+	}
+    }
+
+    /* strips slanting down through the grid along Y */
+    for (i = 0; i < CRACK_GRID; i++) {
+	VSET(p0, i + 0.3, -0.5, -1);
+	VSET(p1, i + 0.7, -0.5, 1);
+	VSET(p2, i + 0.7, CRACK_GRID + 0.5, 1);
+	VSET(p3, i + 0.3, CRACK_GRID + 0.5, -1);
+	(void)crack_quad(s2, p0, p1, p2, p3, tol);
+    }
+
+    /* a strip along the diagonal, through the grid vertices */
+    VSET(p0, -0.5, -0.5, -1);
+    VSET(p1, CRACK_GRID + 0.5, CRACK_GRID + 0.5, -1);
+    VSET(p2, CRACK_GRID + 0.5, CRACK_GRID + 0.5, 1);
+    VSET(p3, -0.5, -0.5, 1);
+    (void)crack_quad(s2, p0, p1, p2, p3, tol);
+
+    /* a diamond lying in the plane of the grid */
+    VSET(p0, 3, 0.5, 0);
+    VSET(p1, 5.5, 3, 0);
+    VSET(p2, 3, 5.5, 0);
+    VSET(p3, 0.5, 3, 0);
+    (void)crack_quad(s2, p0, p1, p2, p3, tol);
+
+    nmg_region_a(r1, tol);
+    nmg_region_a(r2, tol);
+    return m;
+}
+
+
+/* the double loop nmg_crackshells() used before culling face pairs */
+static void
+crack_unculled(struct shell *s1, struct shell *s2, struct bu_list *vlfree, const struct bn_tol *tol)
+{
+    struct bu_ptbl faces1, faces2;
+    point_t isect_min_pt, isect_max_pt;
+    size_t i, j;
+
+    bu_ptbl_init(&faces1, 64, "faces1");
+    bu_ptbl_init(&faces2, 64, "faces2");
+    nmg_face_tabulate(&faces1, &s1->l.magic, vlfree);
+    nmg_face_tabulate(&faces2, &s2->l.magic, vlfree);
+
+    VMOVE(isect_min_pt, s1->sa_p->min_pt);
+    VMAX(isect_min_pt, s2->sa_p->min_pt);
+    VMOVE(isect_max_pt, s1->sa_p->max_pt);
+    VMIN(isect_max_pt, s2->sa_p->max_pt);
+
+    for (i = 0; i < BU_PTBL_LEN(&faces1); i++) {
+	struct face *fp1 = (struct face *)BU_PTBL_GET(&faces1, i);
+	struct faceuse *fu1 = fp1->fu_p;
+
+	if (fu1->orientation == OT_OPPOSITE)
+	    fu1 = fu1->fumate_p;
+	if (V3RPP_DISJOINT_TOL(fp1->min_pt, fp1->max_pt, isect_min_pt, isect_max_pt, tol->dist))
+	    continue;
+
+	for (j = 0; j < BU_PTBL_LEN(&faces2); j++) {
+	    struct face *fp2 = (struct face *)BU_PTBL_GET(&faces2, j);
+	    struct faceuse *fu2 = fp2->fu_p;
+
+	    if (fu2->orientation == OT_OPPOSITE)
+		fu2 = fu2->fumate_p;
+	    if (V3RPP_DISJOINT_TOL(fp2->min_pt, fp2->max_pt, isect_min_pt, isect_max_pt, tol->dist))
+		continue;
+	    nmg_isect_two_generic_faces(fu1, fu2, vlfree, tol);
+	}
+    }
+
+    bu_ptbl_free(&faces1);
+    bu_ptbl_free(&faces2);
+
+    (void)nmg_unbreak_region_edges(&s1->l.magic, vlfree);
+    (void)nmg_unbreak_region_edges(&s2->l.magic, vlfree);
+}
+
+
+/* compare the loops of the faceuses of two shells, vertex by vertex */
+static int
+crack_compare_shells(struct shell *sa, struct shell *sb, const struct bn_tol *tol)
+{
+    struct faceuse *fua, *fub;
+    int nverts = 0;
+
+    fub = BU_LIST_FIRST(faceuse, &sb->fu_hd);
+    for (BU_LIST_FOR(fua, faceuse, &sa->fu_hd)) {
+	struct loopuse *lua, *lub;
+
+	if (BU_LIST_IS_HEAD(fub, &sb->fu_hd) || fua->orientation != fub->orientation) {
+	    bu_log("crack: faceuses differ\n");
+	    return -1;
+	}
+	lub = BU_LIST_FIRST(loopuse, &fub->lu_hd);
+	for (BU_LIST_FOR(lua, loopuse, &fua->lu_hd)) {
+	    struct edgeuse *eua, *eub;
+
+	    if (BU_LIST_IS_HEAD(lub, &fub->lu_hd)
+		|| BU_LIST_FIRST_MAGIC(&lua->down_hd) != NMG_EDGEUSE_MAGIC
+		|| BU_LIST_FIRST_MAGIC(&lub->down_hd) != NMG_EDGEUSE_MAGIC) {
+		bu_log("crack: loopuses differ\n");
+		return -1;
+	    }
+	    eub = BU_LIST_FIRST(edgeuse, &lub->down_hd);
+	    for (BU_LIST_FOR(eua, edgeuse, &lua->down_hd)) {
+		if (BU_LIST_IS_HEAD(eub, &lub->down_hd)) {
+		    bu_log("crack: a loop of the culled result is longer\n");
+		    return -1;
+		}
+		if (!VNEAR_EQUAL(eua->vu_p->v_p->vg_p->coord, eub->vu_p->v_p->vg_p->coord, tol->dist)) {
+		    bu_log("crack: vertex (%g %g %g) of the culled result is (%g %g %g) unculled\n",
+			   V3ARGS(eua->vu_p->v_p->vg_p->coord), V3ARGS(eub->vu_p->v_p->vg_p->coord));
+		    return -1;
+		}
+		nverts++;
+		eub = BU_LIST_PNEXT(edgeuse, eub);
+	    }
+	    if (!BU_LIST_IS_HEAD(eub, &lub->down_hd)) {
+		bu_log("crack: a loop of the unculled result is longer\n");
+		return -1;
+	    }
+	    lub = BU_LIST_PNEXT(loopuse, lub);
+	}
+	fub = BU_LIST_PNEXT(faceuse, fub);
+    }
+    if (!BU_LIST_IS_HEAD(fub, &sb->fu_hd)) {
+	bu_log("crack: the unculled result has more faceuses\n");
+	return -1;
+    }
+
+    return nverts;
+}
+
+
+int
+main(int argc, char **argv)
+{
+    struct bn_tol tol = BN_TOL_INIT_TOL;
+    struct bu_list vlfree;
+    struct model *culled, *unculled;
+    struct nmgregion *ra, *rb;
+    struct shell *s1 = NULL, *s2 = NULL, *u1 = NULL, *u2 = NULL;
+    int n, nverts = 0;
+
+    // Normally this file is part of nmg_test, so only set this if it looks like
+    // the program name is still unset.
+    if (bu_getprogname()[0] == '\0')
+	bu_setprogname(argv[0]);
+
+    if (argc > 1) {
+	bu_exit(1, "Usage: %s\n", argv[0]);
+    }
+
+    BU_LIST_INIT(&vlfree);
+
+    culled = crack_model(&tol);
+    unculled = nmg_clone_model(culled);
+
+    /* the clone keeps the regions, and so the shells, in order */
+    rb = BU_LIST_FIRST(nmgregion, &unculled->r_hd);
+    for (BU_LIST_FOR(ra, nmgregion, &culled->r_hd)) {
+	if (!s1) {
+	    s1 = BU_LIST_FIRST(shell, &ra->s_hd);
+	    u1 = BU_LIST_FIRST(shell, &rb->s_hd);
+	} else {
+	    s2 = BU_LIST_FIRST(shell, &ra->s_hd);
+	    u2 = BU_LIST_FIRST(shell, &rb->s_hd);
+	}
+	rb = BU_LIST_PNEXT(nmgregion, rb);
+    }
+
+    nmg_crackshells(s1, s2, &vlfree, &tol);
+    crack_unculled(u1, u2, &vlfree, &tol);
+
+    if ((n = crack_compare_shells(s1, u1, &tol)) < 0)
+	bu_exit(1, "Test for nmg_crackshells failed on the first shell!\n");
+    nverts += n;
+    if ((n = crack_compare_shells(s2, u2, &tol)) < 0)
+	bu_exit(1, "Test for nmg_crackshells failed on the second shell!\n");
+    nverts += n;
+
+    /* uncracked, both faceuses of each quad have 4 vertex uses */
+    if (nverts <= 2 * 4 * (CRACK_GRID * CRACK_GRID + CRACK_GRID + 2))
+	bu_exit(1, "Test for nmg_crackshells failed: only %d vertex uses, nothing was cracked\n", nverts);
+
+    nmg_km(culled);
+    nmg_km(unculled);
+
+    bu_log("All unit tests succeeded.\n");
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
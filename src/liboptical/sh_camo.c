@@ -63,6 +63,7 @@ struct camo_specific {
     point_t c2;	/* color 2 */
     point_t c3;	/* color 3 */
     mat_t xform;	/* model->region coord sys matrix */
+    const struct bn_noise_spec *noise_spec;	/* spectral weights for the noise parameters */
 };
 #define CK_camo_SP(_p) BU_CKMAG(_p, camo_MAGIC, "camo_specific")
 
@@ -188,6 +189,8 @@ setup(register struct region *rp, struct bu_vls *matparm, void **dpp, struct rt_
     if (bu_struct_parse(matparm, camo_parse, (char *)camo_sp, NULL) < 0)
 	return -1;
 
+    camo_sp->noise_spec = bn_noise_spec_get(camo_sp->noise_h_val, camo_sp->noise_lacunarity, camo_sp->noise_octaves);
+
     /* Optional:  get the matrix which maps model space into
      * "region" or "shader" space
      */
@@ -246,7 +249,8 @@ camo_setup(register struct region *rp, struct bu_vls *matparm, void **dpp, const
 	{ .38, .29, .16 },	/* darker color c1 (97/74/41) */
 	{ .1, .30, .04 },	/* basic color c2 (26/77/10) */
 	VINITALL(0.15),		/* dark black (38/38/38) */
-	MAT_INIT_IDN
+	MAT_INIT_IDN,
+	NULL			/* noise_spec */
     };
 
     return setup(rp, matparm, dpp, rtip, "camouflage parameters = ", &camo_defaults);
@@ -293,8 +297,7 @@ camo_render(struct application *ap, const struct partition *pp, struct shadework
     /* bn_noise_fbm returns a value in the approximate range of
      * -1.0 ~<= bn_noise_fbm() ~<= 1.0
      */
-    val = bn_noise_fbm(pt, camo_sp->noise_h_val,
-		       camo_sp->noise_lacunarity, camo_sp->noise_octaves);
+    val = bn_noise_spec_fbm(camo_sp->noise_spec, pt);
 
     if (val < camo_sp->t1) {
 	VMOVE(swp->sw_color, camo_sp->c1);
@@ -327,7 +330,8 @@ marble_setup(register struct region *rp, struct bu_vls *matparm, void **dpp, con
 	{ .8, .2, .16 },	/* darker color c1 (97/74/41) */
 	{ .9, .9, .8 },		/* basic color c2 (26/77/10) */
 	VINITALL(0.15),		/* dark black (38/38/38) */
-	MAT_INIT_IDN
+	MAT_INIT_IDN,
+	NULL			/* noise_spec */
     };
 
     return setup(rp, matparm, dpp, rtip, "marble parameters = ", &marble_defaults);
@@ -360,8 +364,7 @@ marble_render(struct application *ap, const struct partition *pp, struct shadewo
     /* bn_noise_turb returns a value in the approximate range of
      * 0.0 ~<= bn_noise_turb() ~<= 1.0
      */
-    val = bn_noise_turb(pt, camo_sp->noise_h_val,
-			camo_sp->noise_lacunarity, camo_sp->noise_octaves);
+    val = bn_noise_spec_turb(camo_sp->noise_spec, pt);
 
     val = sin(val*M_PI);
 
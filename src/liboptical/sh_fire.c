@@ -71,6 +71,11 @@
 #define fire_MAGIC 0x46697265   /* ``Fire'' */
 #define CK_fire_SP(_p) BU_CKMAG(_p, fire_MAGIC, "fire_specific")
 
+/* samples along the ray whose turbulence is evaluated together; small
+ * since the march usually stops early once the flame saturates
+ */
+#define FIRE_BATCH 16
+
 /*
  * the shader specific structure contains all variables which are unique
  * to any particular use of the shader.
@@ -92,6 +97,7 @@ struct fire_specific {
     mat_t fire_m_to_sh;		/* model to shader space matrix */
     mat_t fire_sh_to_noise;	/* shader to noise space matrix */
     mat_t fire_colorspline_mat;
+    const struct bn_noise_spec *noise_spec;	/* spectral weights for the noise parameters */
 };
 
 
@@ -112,7 +118,8 @@ struct fire_specific fire_defaults = {
     VINIT_ZERO,		/* fire_max */
     MAT_INIT_IDN,	/* fire_m_to_sh */
     MAT_INIT_IDN,	/* fire_sh_to_noise */
-    MAT_INIT_ZERO	/* fire_colorspline_mat */
+    MAT_INIT_ZERO,	/* fire_colorspline_mat */
+    NULL		/* noise_spec */
 };
 
 
@@ -234,6 +241,8 @@ fire_setup(register struct region *rp, struct bu_vls *matparm, void **dpp, const
 	VSETALL(fire_sp->noise_vscale, fire_sp->noise_size);
     }
 
+    fire_sp->noise_spec = bn_noise_spec_get(fire_sp->noise_h_val, fire_sp->noise_lacunarity, fire_sp->noise_octaves);
+
     /*
      * The shader needs to operate in a coordinate system which stays
      * fixed on the region when the region is moved (as in animation).
@@ -316,14 +325,14 @@ fire_render(struct application *ap, const struct partition *pp, struct shadework
     point_t m_i_pt, m_o_pt;	/* model space in/out points */
     point_t sh_i_pt, sh_o_pt;	/* shader space in/out points */
     point_t noise_i_pt, noise_o_pt;	/* shader space in/out points */
-    point_t noise_pt;
+    point_t noise_pt[FIRE_BATCH];
     double color[3];
     vect_t noise_r_dir;
     double noise_r_thick;
-    int i;
+    int i, j, n;
     double samples_per_unit_noise;
     double noise_dist_per_sample;
-    point_t shader_pt;
+    point_t shader_pt[FIRE_BATCH];
     vect_t shader_r_dir;
     double shader_r_thick;
     double shader_dist_per_sample;
@@ -331,7 +340,7 @@ fire_render(struct application *ap, const struct partition *pp, struct shadework
 
     int samples;
     double dist;
-    double noise_val;
+    double noise_val[FIRE_BATCH];
     double lumens;
 
     /* check the validity of the arguments we got */
@@ -420,44 +429,48 @@ fire_render(struct application *ap, const struct partition *pp, struct shadework
     shader_dist_per_sample = shader_r_thick / samples;
 
     lumens = 0.0;
-    for (i = 0; i < samples; i++) {
-	dist = (double)i * shader_dist_per_sample;
-	VJOIN1(shader_pt, sh_i_pt, dist, shader_r_dir);
-
-	SHADER_TO_NOISE(noise_pt, shader_pt, fire_sp, noise_zdelta);
-
-	noise_val = bn_noise_turb(noise_pt, fire_sp->noise_h_val,
-				  fire_sp->noise_lacunarity, fire_sp->noise_octaves);
-
-	if (optical_debug&OPTICAL_DEBUG_SHADE || fire_sp->fire_debug)
-	    bu_log("bn_noise_turb(%g %g %g) = %g\n",
-		   V3ARGS(noise_pt),
-		   noise_val);
-
-	/* XXX
-	 * When doing the exponential stretch, we scale the noise
-	 * value by the height in shader space
-	 */
-
-	if (NEAR_ZERO(fire_sp->fire_stretch, SQRT_SMALL_FASTF))
-	    lumens += noise_val * 0.025;
-	else {
-	    register double t;
-	    t = lumens;
-	    lumens += noise_val * 0.025 * (1.0 -shader_pt[Z]);
-	    if (optical_debug&OPTICAL_DEBUG_SHADE || fire_sp->fire_debug)
-		bu_log("lumens:%g = %g + %g * %g\n",
-		       lumens, t, noise_val,
-		       0.025 * (1.0 - shader_pt[Z]));
-
+    for (i = 0; i < samples && lumens < 1.0; i += n) {
+	/* turbulence is evaluated for a run of samples at a time */
+	n = FMIN(samples - i, FIRE_BATCH);
+	for (j = 0; j < n; j++) {
+	    dist = (double)(i + j) * shader_dist_per_sample;
+	    VJOIN1(shader_pt[j], sh_i_pt, dist, shader_r_dir);
+
+	    SHADER_TO_NOISE(noise_pt[j], shader_pt[j], fire_sp, noise_zdelta);
 	}
-	if (lumens >= 1.0) {
-	    lumens = 1.0;
+
+	bn_noise_spec_turb_n(fire_sp->noise_spec, (size_t)n, noise_pt, noise_val);
+
+	for (j = 0; j < n; j++) {
 	    if (optical_debug&OPTICAL_DEBUG_SHADE || fire_sp->fire_debug)
-		bu_log("early exit from lumens loop\n");
-	    break;
+		bu_log("bn_noise_turb(%g %g %g) = %g\n",
+		       V3ARGS(noise_pt[j]),
+		       noise_val[j]);
+
+	    /* XXX
+	     * When doing the exponential stretch, we scale the noise
+	     * value by the height in shader space
+	     */
+
+	    if (NEAR_ZERO(fire_sp->fire_stretch, SQRT_SMALL_FASTF))
+		lumens += noise_val[j] * 0.025;
+	    else {
+		register double t;
+		t = lumens;
+		lumens += noise_val[j] * 0.025 * (1.0 -shader_pt[j][Z]);
+		if (optical_debug&OPTICAL_DEBUG_SHADE || fire_sp->fire_debug)
+		    bu_log("lumens:%g = %g + %g * %g\n",
+			   lumens, t, noise_val[j],
+			   0.025 * (1.0 - shader_pt[j][Z]));
+
+	    }
+	    if (lumens >= 1.0) {
+		lumens = 1.0;
+		if (optical_debug&OPTICAL_DEBUG_SHADE || fire_sp->fire_debug)
+		    bu_log("early exit from lumens loop\n");
+		break;
+	    }
 	}
-
     }
 
     if (optical_debug&OPTICAL_DEBUG_SHADE || fire_sp->fire_debug)
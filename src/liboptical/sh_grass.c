@@ -132,6 +132,7 @@ struct grass_specific {
 
     mat_t m_to_sh;	/* model to shader space matrix */
     mat_t sh_to_m;	/* model to shader space matrix */
+    const struct bn_noise_spec *noise_spec;	/* fBm weights for the noise parameters */
 };
 
 
@@ -176,7 +177,8 @@ static const struct grass_specific grass_defaults = {
 	VINIT_ZERO		/* pmax */
     },
     MAT_INIT_IDN,		/* m_to_sh */
-    MAT_INIT_IDN		/* sh_to_m */
+    MAT_INIT_IDN,		/* sh_to_m */
+    NULL			/* noise_spec */
 };
 
 #define SHDR_NULL ((struct grass_specific *)0)
@@ -247,8 +249,7 @@ plants_this_cell(long int *cell, struct grass_specific *grass_sp)
     VSCALE(c, cell, grass_sp->size);  /* int/float conv */
     VADD2(c, c, grass_sp->delta);
 
-    val = fabs(bn_noise_fbm(c, grass_sp->h_val, grass_sp->lacunarity,
-			    grass_sp->octaves));
+    val = fabs(bn_noise_spec_fbm(grass_sp->noise_spec, c));
 
     CLAMP(val, 0.0, 1.0);
 
@@ -520,6 +521,8 @@ grass_setup(register struct region *rp, struct bu_vls *matparm, void **dpp, cons
     if (bu_struct_parse(matparm, grass_parse_tab, (char *)grass_sp, NULL) < 0)
 	return -1;
 
+    grass_sp->noise_spec = bn_noise_spec_get(grass_sp->h_val, grass_sp->lacunarity, grass_sp->octaves);
+
     /* The shader needs to operate in a coordinate system which stays
      * fixed on the region when the region is moved (as in animation).
      * We need to get a matrix to perform the appropriate transform(s).
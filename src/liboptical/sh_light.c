@@ -607,6 +607,7 @@ light_setup(register struct region *rp, struct bu_vls *matparm, void **dpp, cons
 	stp = rp->reg_treetop->tr_a.tu_stp;
 	VMOVE(lsp->lt_pos, stp->st_center);
 	lsp->lt_radius = stp->st_aradius;
+	lsp->lt_bradius = stp->st_bradius;
     } else {
 	vect_t min_rpp, max_rpp;
 	vect_t rad;
@@ -631,6 +632,7 @@ light_setup(register struct region *rp, struct bu_vls *matparm, void **dpp, cons
 	    lsp->lt_radius = rad[Y];
 	if (rad[Z] < lsp->lt_radius)
 	    lsp->lt_radius = rad[Z];
+	lsp->lt_bradius = MAGNITUDE(rad);
 
 	/* Find first leaf node on left of tree */
 	tp = rp->reg_treetop;
@@ -1130,6 +1132,42 @@ light_miss(register struct application *ap)
 }
 
 
+/**
+ * Region test for rt_occluded(): a shadow ray is stopped outright only
+ * by a region known to let no light through - a solid region shaded by
+ * the phong family (plastic, mirror, glass) with no transmission, for
+ * which light_hit() would get a zero sw_transmit back from viewshade().
+ * Any other shader may set sw_transmit as it renders, so its regions
+ * are left to light_hit().
+ */
+static int
+light_opaque(struct application *UNUSED(ap), const struct region *regp)
+{
+    static const char *opaque_shaders[] = {"default", "phong", "plastic", "mirror", "glass", NULL};
+    const struct mfuncs *mfp = (const struct mfuncs *)regp->reg_mfuncs;
+    struct light_specific *lsp;
+    int i;
+
+    if (regp->reg_aircode != 0 || regp->reg_transmit != 0)
+	return 0;
+    if (!mfp || !mfp->mf_name || (mfp->mf_flags & MFF_PROC))
+	return 0;
+
+    for (i = 0; opaque_shaders[i]; i++) {
+	if (BU_STR_EQUAL(mfp->mf_name, opaque_shaders[i]))
+	    break;
+    }
+    if (!opaque_shaders[i])
+	return 0;
+
+    for (BU_LIST_FOR(lsp, light_specific, &(LightHead.l))) {
+	if (lsp->lt_rp == regp)
+	    return 0;
+    }
+    return 1;
+}
+
+
 #define VF_SEEN 1
 #define VF_BACKFACE 2
 
@@ -1148,6 +1186,9 @@ light_vis(struct light_obs_stuff *los, char *flags)
     point_t shoot_pt;
     vect_t shoot_dir;
     int shot_status;
+    fastf_t maxdist;
+    int clipped = 0;		/* maxdist stops short of another light */
+    struct light_specific *lspi;
     vect_t dir, rdir;
     int idx;
     int k = 0;
@@ -1413,8 +1454,65 @@ light_vis(struct light_obs_stuff *los, char *flags)
     if (optical_debug & OPTICAL_DEBUG_LIGHT)
 	bu_log("shooting level %d from %d\n", sub_ap.a_level, __LINE__);
 
-    /* see if we are in the dark. */
-    shot_status = rt_shootray(&sub_ap);
+    /* Only look as far as the light, stopping short of its bounding
+     * sphere so that nothing the light region itself encloses can be
+     * mistaken for an obstruction.
+     */
+    if (los->lsp->lt_infinite) {
+	maxdist = INFINITY;
+    } else {
+	vect_t tolight;
+	VSUB2(tolight, los->lsp->lt_pos, sub_ap.a_ray.r_pt);
+	maxdist = MAGNITUDE(tolight);
+	if (!los->lsp->lt_invisible)
+	    maxdist -= los->lsp->lt_bradius;
+    }
+
+    /* light_hit() counts the ray as reaching the light as soon as it
+     * hits any light region, whatever lies behind it, so the search
+     * for an occluder must also stop short of every other modeled
+     * light.
+     */
+    for (BU_LIST_FOR(lspi, light_specific, &(LightHead.l))) {
+	vect_t tolight;
+	fastf_t along, perp_sq, near;
+
+	if (lspi == los->lsp || lspi->lt_rp == REGION_NULL)
+	    continue;
+	VSUB2(tolight, lspi->lt_pos, sub_ap.a_ray.r_pt);
+	along = VDOT(tolight, sub_ap.a_ray.r_dir);
+	perp_sq = MAGSQ(tolight) - along * along;
+	if (perp_sq >= lspi->lt_bradius * lspi->lt_bradius || along + lspi->lt_bradius <= 0.0)
+	    continue;
+	near = MAGNITUDE(tolight) - lspi->lt_bradius;
+	if (near < maxdist) {
+	    maxdist = near;
+	    clipped = 1;
+	}
+    }
+
+    /* see if we are in the dark.  Most shadow rays end on something
+     * opaque, which rt_occluded() finds without building partitions.
+     * Only rays it cannot settle, through air, filtering or shaded
+     * regions or toward a modeled light, need the full light_hit()
+     * treatment.
+     */
+    switch (rt_occluded(&sub_ap, los->ap->a_rt_i->rti_tol.dist, maxdist, light_opaque)) {
+	case 1:
+	    shot_status = 0;
+	    break;
+	case 0:
+	    if (!clipped && (los->lsp->lt_infinite || los->lsp->lt_invisible)) {
+		/* nothing between us and a light with no geometry */
+		VSETALL(sub_ap.a_color, 1);
+		shot_status = 1;
+		break;
+	    }
+	    /* fall through */
+	default:
+	    shot_status = rt_shootray(&sub_ap);
+	    break;
+    }
 
     if (shot_status > 0) {
 	/* light visible */
@@ -1652,6 +1750,7 @@ light_maker(int num, mat_t v2m)
 	VSET(lsp->lt_aim, 0, 0, -1);	/* any direction: spherical */
 	lsp->lt_intensity = 1.0;
 	lsp->lt_radius = 0.1;		/* mm, "point" source */
+	lsp->lt_bradius = lsp->lt_radius;
 	lsp->lt_visible = 0;		/* NOT explicitly modeled */
 	lsp->lt_invisible = 1;		/* NOT explicitly modeled */
 	lsp->lt_shadows = 0;		/* no shadows for speed */
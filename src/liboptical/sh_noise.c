@@ -115,6 +115,7 @@ struct noise_specific {
     double nsd;
     double minval;		/* don't use noise value less than this */
     int shader_number;
+    const struct bn_noise_spec *spec;	/* fBm weights for the noise parameters */
 };
 
 
@@ -134,7 +135,8 @@ struct noise_specific noise_defaults = {
     0.0,				/* max_delta */
     0.0,				/* nsd */
     0.0,				/* minval */
-    0				/* shader_number */
+    0,				/* shader_number */
+    NULL			/* spec */
 };
 
 
@@ -257,6 +259,8 @@ found:
     noise_sp->nsd = 1.0 /
 	pow(noise_sp->lacunarity, noise_sp->octaves);
 
+    noise_sp->spec = bn_noise_spec_get(noise_sp->h_val, noise_sp->lacunarity, noise_sp->octaves);
+
     if (optical_debug&OPTICAL_DEBUG_SHADE) {
 	bu_struct_print(" Parameters:", noise_print_tab, (char *)noise_sp);
 	bn_mat_print("m_to_sh", noise_sp->m_to_sh);
@@ -281,18 +285,12 @@ noise_free(void *cp)
 #define RESCALE_NOISE(n) n += 1.0
 
 /*
- * Apply a noise function to the surface normal
+ * Get the surface normal in shader space, and a U, V coordinate system
+ * perpendicular to it
  */
 static void
-norm_noise(fastf_t *pt, double val, struct noise_specific *noise_sp, double (*func)(point_t, double, double, double), struct shadework *swp, int rescale)
-/* defined in material.h */
+norm_basis(struct noise_specific *noise_sp, struct shadework *swp, vect_t N, vect_t u_vec, vect_t v_vec)
 {
-    vect_t N, tmp;
-    point_t u_pt, v_pt;
-    vect_t u_vec, v_vec;
-    double u_val, v_val;
-    mat_t u_mat, v_mat;
-
     /* dork the normal around
      * Convert the normal to shader space, get u, v coordinate system
      */
@@ -309,21 +307,19 @@ norm_noise(fastf_t *pt, double val, struct noise_specific *noise_sp, double (*fu
     /* construct coordinate system from vectors perpendicular to normal */
     bn_vec_perp(u_vec, N);
     VCROSS(v_vec, N, u_vec);
+}
 
-    /* compute noise function at position slightly off pt in both
-     * U and V directions to get change in values
-     */
-    VJOIN1(u_pt, pt, noise_sp->nsd, u_vec);
-    u_val = func(u_pt, noise_sp->h_val, noise_sp->lacunarity,
-		 noise_sp->octaves);
-
-    if (rescale) RESCALE_NOISE(u_val);
-
-    VJOIN1(v_pt, pt, noise_sp->nsd, v_vec);
-    v_val = func(v_pt, noise_sp->h_val, noise_sp->lacunarity,
-		 noise_sp->octaves);
 
-    if (rescale) RESCALE_NOISE(v_val);
+/*
+ * Apply a noise function to the surface normal.  u_val and v_val are
+ * the noise at positions slightly off pt in the U and V directions of
+ * norm_basis().
+ */
+static void
+norm_noise(fastf_t *pt, double val, double u_val, double v_val, struct noise_specific *noise_sp, vect_t N, const vect_t u_vec, const vect_t v_vec, struct shadework *swp)
+{
+    vect_t tmp;
+    mat_t u_mat, v_mat;
 
     /* construct normal rotation about U and V vectors based upon
      * variation in surface in each direction.  Apply the result to
@@ -362,6 +358,12 @@ fractal_render(struct application *ap, const struct partition *pp, struct shadew
 	(struct noise_specific *)dp;
     point_t pt;
     double val;
+    point_t pts[3];
+    double vals[3];
+    vect_t N, u_vec, v_vec;
+    size_t npts = 1;
+    int turb = 0;
+    int bump = 0;
 
     /* check the validity of the arguments we got */
     RT_AP_CHECK(ap);
@@ -385,54 +387,78 @@ fractal_render(struct application *ap, const struct partition *pp, struct shadew
 	       V3ARGS(pt));
     }
 
+    switch (noise_sp->shader_number) {
+	case 0:	/* gravel */
+	case 2:	/* turbump */
+	case 4:	/* turcolor */
+	case 6: /* turcombo */
+	    turb = 1;
+	    break;
+    }
+    switch (noise_sp->shader_number) {
+	case 0:	/* gravel */
+	case 1:	/* fbmbump */
+	case 2:	/* turbump */
+	case 5: /* grunge */
+	case 6: /* turcombo */
+	case 7: /* fbmcombo */
+	    bump = 1;
+	    break;
+    }
+
+    /* evaluate the noise at pt, and for the bump shaders at the
+     * points slightly off it in U and V, in one batch
+     */
+    VMOVE(pts[0], pt);
+    if (bump) {
+	norm_basis(noise_sp, swp, N, u_vec, v_vec);
+	VJOIN1(pts[1], pt, noise_sp->nsd, u_vec);
+	VJOIN1(pts[2], pt, noise_sp->nsd, v_vec);
+	npts = 3;
+    }
+    if (turb) {
+	bn_noise_spec_turb_n(noise_sp->spec, npts, pts, vals);
+    } else {
+	bn_noise_spec_fbm_n(noise_sp->spec, npts, pts, vals);
+	if (bump) {
+	    RESCALE_NOISE(vals[1]);
+	    RESCALE_NOISE(vals[2]);
+	}
+    }
+    val = vals[0];
+
     switch (noise_sp->shader_number) {
 	case 0:	/* gravel */
 	case 6: /* turcombo */
-	    val = bn_noise_turb(pt, noise_sp->h_val,
-				noise_sp->lacunarity, noise_sp->octaves);
 	    if (val < noise_sp->minval) val = noise_sp->minval;
 	    VSCALE(swp->sw_color, swp->sw_color, val);
-	    norm_noise(pt, val, noise_sp, bn_noise_turb, swp, 0);
+	    norm_noise(pt, val, vals[1], vals[2], noise_sp, N, u_vec, v_vec, swp);
 	    break;
 	case 1:	/* fbmbump */
-	    val = bn_noise_fbm(pt, noise_sp->h_val,
-			       noise_sp->lacunarity, noise_sp->octaves);
 	    RESCALE_NOISE(val);
-	    norm_noise(pt, val, noise_sp, bn_noise_fbm, swp, 1);
+	    norm_noise(pt, val, vals[1], vals[2], noise_sp, N, u_vec, v_vec, swp);
 	    break;
 	case 2:	/* turbump */
-	    val = bn_noise_turb(pt, noise_sp->h_val,
-				noise_sp->lacunarity, noise_sp->octaves);
-
-	    norm_noise(pt, val, noise_sp, bn_noise_turb, swp, 0);
+	    norm_noise(pt, val, vals[1], vals[2], noise_sp, N, u_vec, v_vec, swp);
 	    break;
 	case 3:	/* fbmcolor */
-	    val = bn_noise_fbm(pt, noise_sp->h_val,
-			       noise_sp->lacunarity, noise_sp->octaves);
 	    RESCALE_NOISE(val);
 	    if (val < noise_sp->minval) val = noise_sp->minval;
 	    VSCALE(swp->sw_color, swp->sw_color, val);
 	    break;
 	case 4:	/* turcolor */
-	    val = bn_noise_turb(pt, noise_sp->h_val,
-				noise_sp->lacunarity, noise_sp->octaves);
 	    if (val < noise_sp->minval) val = noise_sp->minval;
 	    VSCALE(swp->sw_color, swp->sw_color, val);
 	    break;
 	case 5: /* grunge */
 	case 7: /* fbmcombo */
-	    val = bn_noise_fbm(pt, noise_sp->h_val,
-			       noise_sp->lacunarity, noise_sp->octaves);
 	    RESCALE_NOISE(val);
 	    if (val < noise_sp->minval) val = noise_sp->minval;
 	    VSCALE(swp->sw_color, swp->sw_color, val);
-	    norm_noise(pt, val, noise_sp, bn_noise_fbm, swp, 1);
+	    norm_noise(pt, val, vals[1], vals[2], noise_sp, N, u_vec, v_vec, swp);
 	    break;
 
 	case 8: /* flash */
-	    val = bn_noise_fbm(pt, noise_sp->h_val,
-			       noise_sp->lacunarity, noise_sp->octaves);
-
 	    val = 1.0 - val;
 	    if (val < noise_sp->minval) val = noise_sp->minval;
 
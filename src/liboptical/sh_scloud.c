@@ -50,6 +50,7 @@ struct scloud_specific {
     double min_d_p_mm;	/* background density per millimeter */
     mat_t mtos;		/* model to shader */
     mat_t stom;		/* shader to model */
+    const struct bn_noise_spec *spec;	/* spectral weights for the noise parameters */
 };
 
 
@@ -63,7 +64,8 @@ static struct scloud_specific scloud_defaults = {
     0.01,		/* max_d_p_mm */
     0.0,		/* min_d_p_mm */
     MAT_INIT_IDN,	/* mtos */
-    MAT_INIT_IDN	/* stom */
+    MAT_INIT_IDN,	/* stom */
+    NULL		/* spec */
 };
 
 
@@ -146,6 +148,8 @@ scloud_setup(register struct region *rp, struct bu_vls *matparm, void **dpp, con
     if (bu_struct_parse(matparm, scloud_parse, (char *)scloud, NULL) < 0)
 	return -1;
 
+    scloud->spec = bn_noise_spec_get(scloud->h_val, scloud->lacunarity, scloud->octaves);
+
     if (optical_debug&OPTICAL_DEBUG_SHADE)
 	(void)bu_struct_print(rp->reg_name, scloud_parse, (char *)scloud);
 
@@ -219,8 +223,7 @@ tsplat_render(struct application *ap, const struct partition *pp, struct shadewo
 
     /* just shade the surface with a transparency */
     MAT4X3PNT(in_pt, scloud_sp->mtos, swp->sw_hit.hit_point);
-    val = bn_noise_fbm(in_pt, scloud_sp->h_val,
-		       scloud_sp->lacunarity, scloud_sp->octaves);
+    val = bn_noise_spec_fbm(scloud_sp->spec, in_pt);
     CLAMP(val, 0.0, 1.0);
     swp->sw_transmit = 1.0 - val;
 
@@ -308,8 +311,7 @@ scloud_render(struct application *ap, const struct partition *pp, struct shadewo
 	VJOIN1(pt, in_pt, i*step_delta, v_cloud);
 
 	/* get turbulence value (0 .. 1) */
-	val = bn_noise_turb(pt, scloud_sp->h_val,
-			    scloud_sp->lacunarity, scloud_sp->octaves);
+	val = bn_noise_spec_turb(scloud_sp->spec, pt);
 
 	density = scloud_sp->min_d_p_mm + val * delta_dpmm;
 
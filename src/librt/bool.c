@@ -36,6 +36,8 @@
 
 #include "common.h"
 
+#include <limits.h>
+#include <stdlib.h>
 #include <string.h>
 #include "bio.h"
 
@@ -43,6 +45,7 @@
 #include "bu/parallel.h"
 #include "vmath.h"
 #include "raytrace.h"
+#include "./librt_private.h"
 
 
 /* Boolean values.  Not easy to change, but defined symbolically */
@@ -50,6 +53,76 @@
 #define BOOL_TRUE 1
 
 
+/**
+ * rt_boolweave() keeps an in-order array of the partitions on the
+ * list it is weaving into (res->re_ptidx), so that each new segment
+ * can find the first partition it touches by binary search instead
+ * of walking the list from its head.  The array is rebuilt on entry,
+ * since rt_boolfinal() and the application may have changed the list
+ * since the last call, and then kept in step with every partition
+ * that is linked in.
+ */
+static void
+bool_ptidx_build(struct resource *res, struct partition *PartHdp)
+{
+    register struct partition *pp;
+
+    res->re_ptidx_len = 0;
+    for (pp = PartHdp->pt_forw; pp != PartHdp; pp = pp->pt_forw) {
+	if (res->re_ptidx_len >= res->re_ptidx_max) {
+	    res->re_ptidx_max = res->re_ptidx_max ? res->re_ptidx_max * 2 : 64;
+	    res->re_ptidx = (struct partition **)bu_realloc(res->re_ptidx, res->re_ptidx_max * sizeof(struct partition *), "re_ptidx");
+	}
+	res->re_ptidx[res->re_ptidx_len++] = pp;
+    }
+}
+
+
+/**
+ * Record that pp was linked in at list position i.
+ */
+static void
+bool_ptidx_insert(struct resource *res, size_t i, struct partition *pp)
+{
+    if (res->re_ptidx_len >= res->re_ptidx_max) {
+	res->re_ptidx_max = res->re_ptidx_max ? res->re_ptidx_max * 2 : 64;
+	res->re_ptidx = (struct partition **)bu_realloc(res->re_ptidx, res->re_ptidx_max * sizeof(struct partition *), "re_ptidx");
+    }
+    if (i < res->re_ptidx_len)
+	memmove(&res->re_ptidx[i+1], &res->re_ptidx[i], (res->re_ptidx_len - i) * sizeof(struct partition *));
+    res->re_ptidx[i] = pp;
+    res->re_ptidx_len++;
+}
+
+
+/**
+ * Return the position of the first partition that does not end more
+ * than tol_dist before dist, i.e. the first one the weave loop in
+ * rt_boolweave() would not skip.  Partition end points are in
+ * ascending order along the list, up to fusing within tolerance, so
+ * after the search we back up over any neighbors that the loop would
+ * also have stopped at.
+ */
+static size_t
+bool_ptidx_find(const struct resource *res, fastf_t dist, fastf_t tol_dist)
+{
+    size_t lo = 0;
+    size_t hi = res->re_ptidx_len;
+
+    while (lo < hi) {
+	size_t mid = lo + (hi - lo) / 2;
+	if (dist - res->re_ptidx[mid]->pt_outhit->hit_dist > tol_dist)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+    }
+    while (lo > 0 && !(dist - res->re_ptidx[lo-1]->pt_outhit->hit_dist > tol_dist))
+	lo--;
+
+    return lo;
+}
+
+
 /**
  * If a zero thickness segment abuts another partition, it will be
  * fused in, later.
@@ -65,6 +138,7 @@ bool_weave0seg(struct seg *segp, struct partition *PartHdp, struct application *
     struct resource *res = ap->a_resource;
     struct rt_i *rtip = ap->a_rt_i;
     register fastf_t tol_dist;
+    size_t i;
 
     tol_dist = rtip->rti_tol.dist;
 
@@ -94,6 +168,7 @@ bool_weave0seg(struct seg *segp, struct partition *PartHdp, struct application *
 	pp->pt_outseg = segp;
 	pp->pt_outhit = &segp->seg_out;
 	APPEND_PT(pp, PartHdp);
+	bool_ptidx_insert(res, 0, pp);
 	if (RT_G_DEBUG&RT_DEBUG_PARTITION) bu_log("0-len segment ends before start of first partition.\n");
 	return;
     }
@@ -106,7 +181,7 @@ bool_weave0seg(struct seg *segp, struct partition *PartHdp, struct application *
      * pt, XXX especially as the NMG ray-tracer starts reporting wire
      * hits.
      */
-    for (pp=PartHdp->pt_forw; pp != PartHdp; pp=pp->pt_forw) {
+    for (pp=PartHdp->pt_forw, i = 0; pp != PartHdp; pp=pp->pt_forw, i++) {
 	if (NEAR_EQUAL(segp->seg_in.hit_dist, pp->pt_inhit->hit_dist, tol_dist) ||
 	    NEAR_EQUAL(segp->seg_out.hit_dist, pp->pt_inhit->hit_dist, tol_dist)
 	    ) {
@@ -135,6 +210,7 @@ bool_weave0seg(struct seg *segp, struct partition *PartHdp, struct application *
 	    npp->pt_outseg = segp;
 	    npp->pt_outhit = &segp->seg_out;
 	    APPEND_PT(npp, pp);
+	    bool_ptidx_insert(res, i + 1, npp);
 	    return;
 	}
     }
@@ -152,6 +228,7 @@ rt_boolweave(struct seg *out_hd, struct seg *in_hd, struct partition *PartHdp, s
 
     register fastf_t diff, diff_se;
     register fastf_t tol_dist;
+    size_t i;
 
     RT_CK_PT_HD(PartHdp);
     RT_CK_RTI(ap->a_rt_i);
@@ -160,6 +237,12 @@ rt_boolweave(struct seg *out_hd, struct seg *in_hd, struct partition *PartHdp, s
 
     tol_dist = rtip->rti_tol.dist;
 
+    /* Partitions need not be ordered by their end points without
+     * booleans, and that mode never searches the list anyway.
+     */
+    if (!ap->a_no_booleans)
+	bool_ptidx_build(res, PartHdp);
+
     if (RT_G_DEBUG&RT_DEBUG_PARTITION) {
 	bu_log("In rt_boolweave, tol_dist = %g\n", tol_dist);
 	rt_pr_partitions(rtip, PartHdp, "-----------------BOOL_WEAVE");
@@ -256,6 +339,8 @@ rt_boolweave(struct seg *out_hd, struct seg *in_hd, struct partition *PartHdp, s
 	    pp->pt_outseg = segp;
 	    pp->pt_outhit = &segp->seg_out;
 	    APPEND_PT(pp, PartHdp);
+	    if (!ap->a_no_booleans)
+		bool_ptidx_insert(res, 0, pp);
 	    if (RT_G_DEBUG&RT_DEBUG_PARTITION) bu_log("No partitions yet, segment forms first partition\n");
 	} else if (ap->a_no_booleans) {
 	    lasthit = &segp->seg_in;
@@ -301,6 +386,7 @@ rt_boolweave(struct seg *out_hd, struct seg *in_hd, struct partition *PartHdp, s
 	    pp->pt_outseg = segp;
 	    pp->pt_outhit = &segp->seg_out;
 	    APPEND_PT(pp, PartHdp->pt_back);
+	    bool_ptidx_insert(res, res->re_ptidx_len, pp);
 	} else {
 	    /* Loop through current partition list weaving the current
 	     * input segment into the list. The following three
@@ -312,7 +398,9 @@ rt_boolweave(struct seg *out_hd, struct seg *in_hd, struct partition *PartHdp, s
 	    lastseg = segp;
 	    lasthit = &segp->seg_in;
 	    lastflip = 0;
-	    for (pp=PartHdp->pt_forw; pp != PartHdp; pp=pp->pt_forw) {
+	    i = bool_ptidx_find(res, lasthit->hit_dist, tol_dist);
+	    pp = (i < res->re_ptidx_len) ? res->re_ptidx[i] : PartHdp;
+	    for (; pp != PartHdp; pp=pp->pt_forw, i++) {
 
 		if (RT_G_DEBUG&RT_DEBUG_PARTITION) {
 		    bu_log("At start of loop:\n");
@@ -384,6 +472,7 @@ rt_boolweave(struct seg *out_hd, struct seg *in_hd, struct partition *PartHdp, s
 		    newpp->pt_outhit = &segp->seg_in;
 		    newpp->pt_outflip = 1;
 		    INSERT_PT(newpp, pp);
+		    bool_ptidx_insert(res, i++, newpp);
 		    if (RT_G_DEBUG&RT_DEBUG_PARTITION) {
 			bu_log("seg starts within p. Split p at seg start, advance. (diff = %g)\n", diff);
 			bu_log("newpp starts at %.12e, pp starts at %.12e\n",
@@ -449,6 +538,7 @@ rt_boolweave(struct seg *out_hd, struct seg *in_hd, struct partition *PartHdp, s
 			newpp->pt_outhit = &segp->seg_out;
 			newpp->pt_outflip = 0;
 			INSERT_PT(newpp, pp);
+			bool_ptidx_insert(res, i++, newpp);
 			if (RT_G_DEBUG&RT_DEBUG_PARTITION) bu_log("seg between 2 partitions\n");
 			break;
 		    } else if (diff < tol_dist) {
@@ -470,6 +560,7 @@ rt_boolweave(struct seg *out_hd, struct seg *in_hd, struct partition *PartHdp, s
 			newpp->pt_outhit->hit_dist = pp->pt_inhit->hit_dist;
 			newpp->pt_outflip = 0;
 			INSERT_PT(newpp, pp);
+			bool_ptidx_insert(res, i++, newpp);
 			if (RT_G_DEBUG&RT_DEBUG_PARTITION) bu_log("seg ends at partition start, fuse\n");
 			break;
 		    }
@@ -488,6 +579,7 @@ rt_boolweave(struct seg *out_hd, struct seg *in_hd, struct partition *PartHdp, s
 		    lasthit = pp->pt_inhit;
 		    lastflip = newpp->pt_outflip;
 		    INSERT_PT(newpp, pp);
+		    bool_ptidx_insert(res, i++, newpp);
 		    if (RT_G_DEBUG&RT_DEBUG_PARTITION) bu_log("insert seg before p start, ends after p ends.  Making new partition for initial portion.\n");
 		}
 
@@ -546,6 +638,7 @@ rt_boolweave(struct seg *out_hd, struct seg *in_hd, struct partition *PartHdp, s
 		    pp->pt_inhit = &segp->seg_out;
 		    pp->pt_inflip = 1;
 		    INSERT_PT(newpp, pp);
+		    bool_ptidx_insert(res, i++, newpp);
 		    if (RT_G_DEBUG&RT_DEBUG_PARTITION) {
 			bu_log("start together, seg shorter than partition\n");
 			bu_log("newpp starts at %.12e, pp starts at %.12e\n",
@@ -574,6 +667,7 @@ rt_boolweave(struct seg *out_hd, struct seg *in_hd, struct partition *PartHdp, s
 		newpp->pt_outseg = segp;
 		newpp->pt_outhit = &segp->seg_out;
 		APPEND_PT(newpp, PartHdp->pt_back);
+		bool_ptidx_insert(res, res->re_ptidx_len, newpp);
 	    }
 	}
 
@@ -1154,6 +1248,252 @@ bool_equal_overlap_tables(struct region *const*a, struct region *const*b)
 }
 
 
+/**
+ * Region boolean trees compiled for rt_boolfinal().
+ *
+ * Each region's tree is flattened into "jump code": one instruction
+ * per solid leaf, which tests whether that solid has a segment in
+ * the partition and names the instruction to run next for either
+ * answer.  The operators are folded into the jump targets when the
+ * tree is compiled, so evaluation is a short loop over a contiguous
+ * array with no stack, and it stops as soon as the answer is known.
+ * Negative targets end the program with a result.
+ *
+ * The leaf test reads a per-resource array indexed by st_bit, which
+ * rt_boolfinal() stamps for the solids of the partition at hand.
+ *
+ * XOR needs its right operand in both outcomes of the left one, so
+ * nested XORs double in size at each level.  Regions that would
+ * take more than BOOL_PROG_MAX_INSN instructions are left to
+ * bool_eval().  Setting LIBRT_BOOL_COMPILE=0 leaves all of them
+ * there, for comparison.
+ */
+#define BOOL_PROG_FALSE (-1)
+#define BOOL_PROG_TRUE (-2)
+#define BOOL_PROG_GUARD (-3)
+#define BOOL_PROG_MAX_INSN 4096
+
+struct bool_insn {
+    size_t bit;		/**< @brief st_bit of the solid tested */
+    int t;		/**< @brief next instruction if the solid is present */
+    int f;		/**< @brief next instruction if it is not */
+};
+
+struct bool_prog_region {
+    size_t off;		/**< @brief first instruction in insn[] */
+    size_t n;		/**< @brief # of instructions */
+    int entry;		/**< @brief first instruction to run, relative to off */
+    int compiled;	/**< @brief 0 if left to bool_eval() */
+};
+
+struct bool_progs {
+    size_t nregions;
+    struct bool_prog_region *reg;	/**< @brief [reg_bit] */
+    struct bool_insn *insn;
+    size_t ninsn;
+    size_t maxinsn;
+};
+
+
+/**
+ * Emit code for tp that continues at t when tp is true and at f
+ * when it is false.  The right operand is emitted first so its entry
+ * point is known when the left one is.  Returns the entry point, or
+ * INT_MIN if the tree holds something we can't compile or the
+ * program would get too long.
+ */
+static int
+bool_prog_emit(struct bool_progs *bp, size_t off, const union tree *tp, int t, int f)
+{
+    int r0, r1;
+
+    switch (tp->tr_op) {
+	case OP_NOP:
+	    return f;
+	case OP_SOLID:
+	    if (bp->ninsn - off >= BOOL_PROG_MAX_INSN)
+		return INT_MIN;
+	    if (bp->ninsn >= bp->maxinsn) {
+		bp->maxinsn = bp->maxinsn ? bp->maxinsn * 2 : 256;
+		bp->insn = (struct bool_insn *)bu_realloc(bp->insn, bp->maxinsn * sizeof(struct bool_insn), "bool_insn");
+	    }
+	    bp->insn[bp->ninsn].bit = tp->tr_a.tu_stp->st_bit;
+	    bp->insn[bp->ninsn].t = t;
+	    bp->insn[bp->ninsn].f = f;
+	    return (int)(bp->ninsn++ - off);
+	case OP_NOT:
+	    return bool_prog_emit(bp, off, tp->tr_b.tb_left, f, t);
+	case OP_UNION:
+	    r0 = bool_prog_emit(bp, off, tp->tr_b.tb_right, t, f);
+	    if (r0 == INT_MIN)
+		return INT_MIN;
+	    return bool_prog_emit(bp, off, tp->tr_b.tb_left, t, r0);
+	case OP_INTERSECT:
+	    r0 = bool_prog_emit(bp, off, tp->tr_b.tb_right, t, f);
+	    if (r0 == INT_MIN)
+		return INT_MIN;
+	    return bool_prog_emit(bp, off, tp->tr_b.tb_left, r0, f);
+	case OP_SUBTRACT:
+	    r0 = bool_prog_emit(bp, off, tp->tr_b.tb_right, f, t);
+	    if (r0 == INT_MIN)
+		return INT_MIN;
+	    return bool_prog_emit(bp, off, tp->tr_b.tb_left, r0, f);
+	case OP_XOR:
+	    /* The rhs is needed in both outcomes of the lhs.  If both
+	     * are true, bool_eval() reports a GUARD error.
+	     */
+	    r1 = bool_prog_emit(bp, off, tp->tr_b.tb_right, BOOL_PROG_GUARD, t);
+	    if (r1 == INT_MIN)
+		return INT_MIN;
+	    r0 = bool_prog_emit(bp, off, tp->tr_b.tb_right, t, f);
+	    if (r0 == INT_MIN)
+		return INT_MIN;
+	    return bool_prog_emit(bp, off, tp->tr_b.tb_left, r1, r0);
+	default:
+	    return INT_MIN;
+    }
+}
+
+
+void
+rt_bool_compile(struct rt_i *rtip)
+{
+    struct bool_progs *bp;
+    const char *benv = getenv("LIBRT_BOOL_COMPILE");
+    size_t i;
+
+    RT_CK_RTI(rtip);
+
+    rt_bool_free(rtip);
+    if (!rtip->Regions || rtip->nregions == 0)
+	return;
+    if (benv && atoi(benv) == 0)
+	return;
+
+    BU_ALLOC(bp, struct bool_progs);
+    bp->nregions = rtip->nregions;
+    bp->reg = (struct bool_prog_region *)bu_calloc(bp->nregions, sizeof(struct bool_prog_region), "bool_prog_region");
+
+    for (i = 0; i < rtip->nregions; i++) {
+	struct region *regp = rtip->Regions[i];
+	struct bool_prog_region *pr = &bp->reg[i];
+	size_t j;
+	int entry;
+
+	if (!regp || regp->reg_all_unions || !regp->reg_treetop)
+	    continue;
+
+	pr->off = bp->ninsn;
+	entry = bool_prog_emit(bp, pr->off, regp->reg_treetop, BOOL_PROG_TRUE, BOOL_PROG_FALSE);
+	if (entry == INT_MIN) {
+	    /* Leave this one to bool_eval() */
+	    bp->ninsn = pr->off;
+	    continue;
+	}
+	pr->n = bp->ninsn - pr->off;
+
+	/* Operands were emitted right to left, so flip the block to
+	 * make the common fall-through path run forwards in memory.
+	 */
+	for (j = 0; j < pr->n / 2; j++) {
+	    struct bool_insn tmp = bp->insn[pr->off + j];
+	    bp->insn[pr->off + j] = bp->insn[pr->off + pr->n - 1 - j];
+	    bp->insn[pr->off + pr->n - 1 - j] = tmp;
+	}
+	for (j = 0; j < pr->n; j++) {
+	    struct bool_insn *ip = &bp->insn[pr->off + j];
+	    if (ip->t >= 0)
+		ip->t = (int)pr->n - 1 - ip->t;
+	    if (ip->f >= 0)
+		ip->f = (int)pr->n - 1 - ip->f;
+	}
+	pr->entry = (entry >= 0) ? (int)pr->n - 1 - entry : entry;
+	pr->compiled = 1;
+    }
+
+    rtip->rti_boolprogs = bp;
+}
+
+
+void
+rt_bool_free(struct rt_i *rtip)
+{
+    struct bool_progs *bp;
+
+    RT_CK_RTI(rtip);
+
+    bp = rtip->rti_boolprogs;
+    if (!bp)
+	return;
+    if (bp->insn)
+	bu_free(bp->insn, "bool_insn");
+    bu_free(bp->reg, "bool_prog_region");
+    bu_free(bp, "bool_progs");
+    rtip->rti_boolprogs = NULL;
+}
+
+
+/**
+ * Return the compiled program for regp, or NULL if there is none.
+ */
+static const struct bool_prog_region *
+bool_prog_find(const struct rt_i *rtip, const struct region *regp)
+{
+    const struct bool_progs *bp = rtip->rti_boolprogs;
+
+    if (!bp || regp->reg_bit < 0 || (size_t)regp->reg_bit >= bp->nregions)
+	return NULL;
+    if (!bp->reg[regp->reg_bit].compiled)
+	return NULL;
+    return &bp->reg[regp->reg_bit];
+}
+
+
+/**
+ * Stamp the solids that have a segment in pp, for bool_prog_eval().
+ */
+static void
+bool_prog_mark(struct resource *resp, const struct rt_i *rtip, const struct partition *pp)
+{
+    struct seg **segpp;
+
+    if (resp->re_boolmark_len < rtip->nsolids) {
+	resp->re_boolmark = (unsigned int *)bu_realloc(resp->re_boolmark, rtip->nsolids * sizeof(unsigned int), "re_boolmark");
+	memset(resp->re_boolmark + resp->re_boolmark_len, 0, (rtip->nsolids - resp->re_boolmark_len) * sizeof(unsigned int));
+	resp->re_boolmark_len = rtip->nsolids;
+    }
+    if (++resp->re_boolstamp == 0) {
+	memset(resp->re_boolmark, 0, resp->re_boolmark_len * sizeof(unsigned int));
+	resp->re_boolstamp = 1;
+    }
+    for (BU_PTBL_FOR(segpp, (struct seg **), &pp->pt_seglist))
+	resp->re_boolmark[(*segpp)->seg_stp->st_bit] = resp->re_boolstamp;
+}
+
+
+/**
+ * Run a compiled region program against the solids stamped by
+ * bool_prog_mark().  Same return values as bool_eval().
+ */
+static int
+bool_prog_eval(const struct bool_progs *bp, const struct bool_prog_region *pr, const struct resource *resp)
+{
+    const struct bool_insn *insn = bp->insn + pr->off;
+    const unsigned int *mark = resp->re_boolmark;
+    const unsigned int stamp = resp->re_boolstamp;
+    int pc = pr->entry;
+
+    while (pc >= 0)
+	pc = (mark[insn[pc].bit] == stamp) ? insn[pc].t : insn[pc].f;
+
+    if (pc == BOOL_PROG_FALSE)
+	return BOOL_FALSE;
+    if (pc == BOOL_PROG_TRUE)
+	return BOOL_TRUE;
+    return -1;
+}
+
+
 /**
  * Test to see if a region is ready to be evaluated over a given
  * partition, i.e. if all the prerequisites have been satisfied.
@@ -1213,7 +1553,7 @@ bool_test_tree(register const union tree *tp, register const struct bu_bitv *sol
  *  0 Partition is not ready
  */
 static int
-bool_partition_eligible(register const struct bu_ptbl *regiontable, register const struct bu_bitv *solidbits, register const struct partition *pp)
+bool_partition_eligible(const struct rt_i *rtip, register const struct bu_ptbl *regiontable, register const struct bu_bitv *solidbits, register const struct partition *pp)
 {
     struct region **regpp;
 
@@ -1223,11 +1563,24 @@ bool_partition_eligible(register const struct bu_ptbl *regiontable, register con
 
     for (BU_PTBL_FOR(regpp, (struct region **), regiontable)) {
 	register struct region *regp;
+	const struct bool_prog_region *pr;
 
 	regp = *regpp;
 	RT_CK_REGION(regp);
 
-	/* Check region prerequisites */
+	/* Check region prerequisites.  A compiled region lists every
+	 * solid leaf of its tree, so scan that instead of the tree.
+	 */
+	pr = bool_prog_find(rtip, regp);
+	if (pr) {
+	    const struct bool_insn *insn = rtip->rti_boolprogs->insn + pr->off;
+	    size_t j;
+	    for (j = 0; j < pr->n; j++) {
+		if (!BU_BITTEST(solidbits, insn[j].bit))
+		    return 0;
+	    }
+	    continue;
+	}
 	if (!bool_test_tree(regp->reg_treetop, solidbits, regp, pp)) {
 	    return 0;
 	}
@@ -1300,6 +1653,7 @@ stack:
 		ret = 0;
 	    }
 	    goto pop;
+	case OP_NOT:
 	case OP_UNION:
 	case OP_INTERSECT:
 	case OP_SUBTRACT:
@@ -1351,7 +1705,9 @@ pop:
 	    treep = treep->tr_b.tb_right;
 	    goto stack;
 	case OP_NOT:
-	    /* Special operation for subtraction */
+	    /* A NOT node of the tree, or the special operation for
+	     * subtraction
+	     */
 	    ret = !ret;
 	    goto pop;
 	case OP_XOR:
@@ -1630,7 +1986,7 @@ rt_boolfinal(struct partition *InputHdp, struct partition *FinalHdp, fastf_t sta
 	     * in every region participating in this partition has
 	     * been intersected, then it is OK to evaluate it now.
 	     */
-	    if (!bool_partition_eligible(regiontable, solidbits, pp)) {
+	    if (!bool_partition_eligible(ap->a_rt_i, regiontable, solidbits, pp)) {
 		ret = 0;
 		reason = "Partition not yet eligible for evaluation";
 		goto out;
@@ -1642,8 +1998,11 @@ rt_boolfinal(struct partition *InputHdp, struct partition *FinalHdp, fastf_t sta
 	/* Evaluate the boolean trees of any regions involved */
 	{
 	    struct region **regpp;
+	    int marked = 0;
 	    for (BU_PTBL_FOR(regpp, (struct region **), regiontable)) {
 		register struct region *regp;
+		const struct bool_prog_region *pr;
+		int val;
 
 		regp = *regpp;
 		RT_CK_REGION(regp);
@@ -1660,7 +2019,17 @@ rt_boolfinal(struct partition *InputHdp, struct partition *FinalHdp, fastf_t sta
 		    lastregion = regp;
 		    continue;
 		}
-		if (bool_eval(regp->reg_treetop, pp, ap->a_resource) == BOOL_FALSE) {
+		pr = bool_prog_find(ap->a_rt_i, regp);
+		if (pr) {
+		    if (!marked) {
+			bool_prog_mark(ap->a_resource, ap->a_rt_i, pp);
+			marked = 1;
+		    }
+		    val = bool_prog_eval(ap->a_rt_i->rti_boolprogs, pr, ap->a_resource);
+		} else {
+		    val = bool_eval(regp->reg_treetop, pp, ap->a_resource);
+		}
+		if (val == BOOL_FALSE) {
 		    if (RT_G_DEBUG&RT_DEBUG_PARTITION)
 			bu_log("BOOL_FALSE\n");
 		    /* Null out non-claiming region's pointer */
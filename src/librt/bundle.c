@@ -441,8 +441,8 @@ weave:
 	else
 	    ap->a_return = 0;
 	status = "MISS bool";
-	RT_FREE_PT_LIST(&InitialPart, resp);
-	RT_FREE_SEG_LIST(&finished_segs, resp);
+	rt_pt_list_release(&InitialPart, resp);
+	rt_seg_list_release(&finished_segs, resp);
 	goto out;
     }
 
@@ -466,7 +466,7 @@ hitit:
      * partitions.  finished_segs can not be released yet, because
      * FinalPart partitions will point to hits in those segments.
      */
-    RT_FREE_PT_LIST(&InitialPart, resp);
+    rt_pt_list_release(&InitialPart, resp);
 
     /*
      * finished_segs is only used by special hit routines which don't
@@ -479,8 +479,8 @@ hitit:
 	ap->a_return = 0;
     status = "HIT";
 
-    RT_FREE_SEG_LIST(&finished_segs, resp);
-    RT_FREE_PT_LIST(&FinalPart, resp);
+    rt_seg_list_release(&finished_segs, resp);
+    rt_pt_list_release(&FinalPart, resp);
 
     /*
      * Processing of this ray is complete.
@@ -706,8 +706,8 @@ rt_shootrays(struct application_bundle *bundle)
     if (pb->list != NULL) {
 	while (BU_LIST_WHILE(pl, partition_list, &(pb->list->l))) {
 	    BU_LIST_DEQUEUE(&(pl->l));
-	    RT_FREE_SEG_LIST(&pl->segHeadp, resource);
-	    RT_FREE_PT_LIST(&pl->PartHeadp, resource);
+	    rt_seg_list_release(&pl->segHeadp, resource);
+	    rt_pt_list_release(&pl->PartHeadp, resource);
 	    bu_free(pl, "free partition_list pl");
 	}
 	bu_free(pb->list, "free partition_list header");
@@ -1235,7 +1235,7 @@ rt_comb_tess(struct nmgregion **r, struct model *m, struct rt_db_internal *ip, c
     if (!r || !m  || !ip || !ttol || !tol)
 	return BRLCAD_ERROR;
 
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
    /* validate it's a comb */
     if (ip->idb_type != ID_COMBINATION) bu_bomb("rt_comb_tess() type not ID_COMBINATION");
     struct rt_comb_internal *comb = (struct rt_comb_internal *)ip->idb_ptr;
@@ -32,6 +32,10 @@
  *				rt_ct_populate_box()
  *					rt_ck_overlap()
  *
+ * When rti_space_partition is RT_PART_HLBVH, rt_ct_optim() is skipped
+ * and cut_bvh_build() instead builds a flattened HLBVH over the
+ * bounding RPPs of all finite solids, which rt_shootray() traverses.
+ *
  */
 /** @} */
 
@@ -49,6 +53,16 @@
 #include "bg/plane.h"
 #include "bv/plot3.h"
 
+#include "./librt_private.h"
+#include "./cut_hlbvh.h"
+
+/* solids per scene BVH leaf, same as the OpenCL scene BVH */
+#define CUT_BVH_MAX_PRIMS_IN_NODE 4
+
+/* a refit hierarchy whose cost grows past this factor of the built
+ * one is rebuilt instead */
+#define CUT_BVH_REFIT_COST 1.5
+
 
 static int rt_ck_overlap(const vect_t min, const vect_t max, const struct soltab *stp, const struct rt_i *rtip);
 static int rt_ct_box(struct rt_i *rtip, union cutter *cutp, int axis, double where, int force);
@@ -263,6 +277,13 @@ rt_cut_it(register struct rt_i *rtip, int UNUSED(ncpu))
 	rtip->rti_cutdepth = 6;
     }
 
+    if (rtip->rti_space_partition == RT_PART_HLBVH && rtip->rti_nsolids_with_pieces > 0) {
+	/* Solid pieces are tracked per cell, so they need the NUBSP tree */
+	bu_log("rt_cut_it: %zu solids use pieces, using NUBSP space partitioning instead of HLBVH\n",
+	       rtip->rti_nsolids_with_pieces);
+	rtip->rti_space_partition = RT_PART_NUBSPT;
+    }
+
     switch (rtip->rti_space_partition) {
 	case RT_PART_NUBSPT: {
 	    rtip->rti_CutHead = *finp;	/* union copy */
@@ -274,6 +295,14 @@ rt_cut_it(register struct rt_i *rtip, int UNUSED(ncpu))
 		bu_log("split_mostly_empty_cells(): split %zu cells\n", num_splits);
 	    }
 
+	    break; }
+	case RT_PART_HLBVH: {
+	    /* Keep the unrefined root box so cell based callers
+	     * (rt_shootray_bundle, rt_cell_n_on_ray) still see every
+	     * solid, but do all the real work in the BVH.
+	     */
+	    rtip->rti_CutHead = *finp;	/* union copy */
+	    cut_bvh_build(rtip);
 	    break; }
 	default:
 	    bu_bomb("rt_cut_it: unknown space partitioning method\n");
@@ -310,6 +339,228 @@ rt_cut_it(register struct rt_i *rtip, int UNUSED(ncpu))
 }
 
 
+void
+cut_bvh_free(struct rt_i *rtip)
+{
+    RT_CK_RTI(rtip);
+
+    if (rtip->rti_bvh_nodes)
+	bu_free(rtip->rti_bvh_nodes, "bvh flat nodes");
+    if (rtip->rti_bvh_solids)
+	bu_free(rtip->rti_bvh_solids, "rti_bvh_solids");
+    rtip->rti_bvh_nodes = NULL;
+    rtip->rti_bvh_nnodes = 0;
+    rtip->rti_bvh_solids = NULL;
+    rtip->rti_bvh_nsolids = 0;
+}
+
+
+static fastf_t
+cut_bvh_area(const fastf_t b[6])
+{
+    vect_t d;
+
+    VSUB2(d, &b[3], &b[0]);
+    if (d[X] < 0.0 || d[Y] < 0.0 || d[Z] < 0.0)
+	return 0.0;
+    return 2.0 * (d[X] * d[Y] + d[Y] * d[Z] + d[Z] * d[X]);
+}
+
+
+/**
+ * Surface area of all nodes over that of the root, which is the
+ * expected number of nodes a ray through the root visits.
+ */
+static fastf_t
+cut_bvh_cost(const struct rt_i *rtip)
+{
+    fastf_t root, sum = 0.0;
+    long i;
+
+    if (!rtip->rti_bvh_nodes)
+	return 0.0;
+
+    root = cut_bvh_area(rtip->rti_bvh_nodes[0].bounds);
+    if (root <= 0.0)
+	return 0.0;
+
+    for (i = 0; i < rtip->rti_bvh_nnodes; i++)
+	sum += cut_bvh_area(rtip->rti_bvh_nodes[i].bounds);
+    return sum / root;
+}
+
+
+void
+cut_bvh_build(struct rt_i *rtip)
+{
+    struct soltab *stp;
+    struct soltab **solids;
+    fastf_t *centroids;
+    fastf_t *bounds;
+    long *ordered_prims = NULL;
+    long nodes_created = 0;
+    size_t nprims = 0;
+    size_t i;
+    struct bu_pool *pool;
+    struct bvh_build_node *root;
+
+    RT_CK_RTI(rtip);
+
+    cut_bvh_free(rtip);
+
+    if (rtip->nsolids == 0)
+	return;
+
+    solids = (struct soltab **)bu_calloc(rtip->nsolids, sizeof(struct soltab *), "cut_bvh_build solids");
+    RT_VISIT_ALL_SOLTABS_START(stp, rtip) {
+	/* Dead solids failed prep, infinite ones live in rti_inf_box */
+	if (stp->st_aradius <= 0 || stp->st_aradius >= INFINITY)
+	    continue;
+	if (nprims >= rtip->nsolids)
+	    continue;
+	solids[nprims++] = stp;
+    } RT_VISIT_ALL_SOLTABS_END;
+
+    if (nprims == 0) {
+	bu_free(solids, "cut_bvh_build solids");
+	return;
+    }
+
+    centroids = (fastf_t *)bu_malloc(nprims * sizeof(fastf_t) * 3, "cut_bvh_build centroids");
+    bounds = (fastf_t *)bu_malloc(nprims * sizeof(fastf_t) * 6, "cut_bvh_build bounds");
+    for (i = 0; i < nprims; i++) {
+	VADD2SCALE(&centroids[i*3], solids[i]->st_min, solids[i]->st_max, 0.5);
+	VMOVE(&bounds[i*6+0], solids[i]->st_min);
+	VMOVE(&bounds[i*6+3], solids[i]->st_max);
+    }
+
+    pool = hlbvh_init_pool(nprims);
+    root = hlbvh_create(CUT_BVH_MAX_PRIMS_IN_NODE, pool, centroids, bounds,
+			&nodes_created, (long)nprims, &ordered_prims);
+    bu_free(centroids, "cut_bvh_build centroids");
+    bu_free(bounds, "cut_bvh_build bounds");
+
+    rtip->rti_bvh_nodes = hlbvh_flatten(root, nodes_created);
+    rtip->rti_bvh_nnodes = nodes_created;
+    bu_pool_delete(pool);
+
+    /* Store the solids in leaf order so leaves index them directly */
+    rtip->rti_bvh_solids = (struct soltab **)bu_calloc(nprims, sizeof(struct soltab *), "rti_bvh_solids");
+    for (i = 0; i < nprims; i++)
+	rtip->rti_bvh_solids[i] = solids[ordered_prims[i]];
+    rtip->rti_bvh_nsolids = nprims;
+
+    bu_free(ordered_prims, "hlbvh_create");
+    bu_free(solids, "cut_bvh_build solids");
+    rtip->rti_bvh_cost = cut_bvh_cost(rtip);
+
+    if (RT_G_DEBUG&RT_DEBUG_CUT) {
+	bu_log("HLBVH: %ld nodes, %zu solids (%.2f KB)\n",
+	       rtip->rti_bvh_nnodes, rtip->rti_bvh_nsolids,
+	       (double)(sizeof(struct bvh_flat_node) * rtip->rti_bvh_nnodes) / 1024.0);
+    }
+}
+
+
+void
+cut_bvh_remove(struct rt_i *rtip, const struct soltab *stp)
+{
+    size_t i;
+
+    RT_CK_RTI(rtip);
+
+    if (!rtip->rti_bvh_solids)
+	return;
+
+    for (i = 0; i < rtip->rti_bvh_nsolids; i++) {
+	if (rtip->rti_bvh_solids[i] == stp)
+	    rtip->rti_bvh_solids[i] = NULL;
+    }
+}
+
+
+int
+cut_bvh_refit(struct rt_i *rtip, const struct bu_ptbl *solids)
+{
+    struct bvh_flat_node *node;
+    struct soltab *stp;
+    size_t i, j, nfree = 0, nnew = 0;
+    long n, k;
+
+    RT_CK_RTI(rtip);
+    BU_CK_PTBL(solids);
+
+    if (!rtip->rti_bvh_nodes)
+	return -1;
+
+    for (j = 0; j < BU_PTBL_LEN(solids); j++) {
+	stp = (struct soltab *)BU_PTBL_GET(solids, j);
+	if (stp->st_aradius > 0 && stp->st_aradius < INFINITY)
+	    nnew++;
+    }
+    for (i = 0; i < rtip->rti_bvh_nsolids; i++) {
+	if (!rtip->rti_bvh_solids[i])
+	    nfree++;
+    }
+    if (nnew > nfree)
+	return -1;
+
+    /* Hand the leaf slots emptied by cut_bvh_remove() to the new
+     * solids in the order they were made.  A poor placement shows up
+     * in the cost check below.
+     */
+    i = 0;
+    for (j = 0; j < BU_PTBL_LEN(solids); j++) {
+	stp = (struct soltab *)BU_PTBL_GET(solids, j);
+	if (stp->st_aradius <= 0 || stp->st_aradius >= INFINITY)
+	    continue;
+	while (rtip->rti_bvh_solids[i])
+	    i++;
+	rtip->rti_bvh_solids[i] = stp;
+    }
+
+    /* Children follow their parent in the depth-first node order, so
+     * a reverse pass sees both children before the parent.  Leaves
+     * left empty keep their old bounds.
+     */
+    for (n = rtip->rti_bvh_nnodes - 1; n >= 0; n--) {
+	node = &rtip->rti_bvh_nodes[n];
+	if (node->n_primitives > 0) {
+	    struct soltab **stpp = &rtip->rti_bvh_solids[node->data.first_prim_offset];
+	    fastf_t b[6];
+
+	    VSETALL(&b[0], INFINITY);
+	    VSETALL(&b[3], -INFINITY);
+	    for (k = 0; k < node->n_primitives; k++) {
+		if (!stpp[k])
+		    continue;
+		VMIN(&b[0], stpp[k]->st_min);
+		VMAX(&b[3], stpp[k]->st_max);
+	    }
+	    if (b[0] <= b[3]) {
+		VMOVE(&node->bounds[0], &b[0]);
+		VMOVE(&node->bounds[3], &b[3]);
+	    }
+	} else {
+	    const struct bvh_flat_node *c0 = node + 1;
+	    const struct bvh_flat_node *c1 = node->data.other_child;
+
+	    VMOVE(&node->bounds[0], &c0->bounds[0]);
+	    VMOVE(&node->bounds[3], &c0->bounds[3]);
+	    VMIN(&node->bounds[0], &c1->bounds[0]);
+	    VMAX(&node->bounds[3], &c1->bounds[3]);
+	}
+    }
+
+    if (cut_bvh_cost(rtip) > CUT_BVH_REFIT_COST * rtip->rti_bvh_cost)
+	return -1;
+
+    if (RT_G_DEBUG&RT_DEBUG_CUT)
+	bu_log("HLBVH: refit around %zu new solids\n", nnew);
+    return 0;
+}
+
+
 void
 rt_cut_extend(register union cutter *cutp, struct soltab *stp, const struct rt_i *rtip)
 {
@@ -1119,6 +1370,8 @@ rt_cut_clean(struct rt_i *rtip)
 
     RT_CK_RTI(rtip);
 
+    cut_bvh_free(rtip);
+
     if (rtip->rti_cuts_waiting.l.magic)
 	bu_ptbl_free(&rtip->rti_cuts_waiting);
 
@@ -1141,6 +1394,12 @@ rt_pr_cut_info(const struct rt_i *rtip, const char *str)
 {
     RT_CK_RTI(rtip);
 
+    if (rtip->rti_space_partition == RT_PART_HLBVH) {
+	bu_log("%s HLBVH: %ld nodes, %zu solids\n",
+	       str, rtip->rti_bvh_nnodes, rtip->rti_bvh_nsolids);
+	return;
+    }
+
     bu_log("%s %s: %zu cut, %zu box (%zu empty)\n",
 	   str,
 	   rtip->rti_space_partition == RT_PART_NUBSPT ?
@@ -991,6 +991,7 @@ rt_db_get_internal5(
     struct resource *resp)
 {
     struct bu_external ext = BU_EXTERNAL_INIT_ZERO;
+    int borrowed;
     int ret;
 
     RT_DB_INTERNAL_INIT(ip);
@@ -1000,11 +1001,14 @@ rt_db_get_internal5(
 
     BU_ASSERT(dbip->dbi_version == 5);
 
-    if (db_get_external(&ext, dp, dbip) < 0)
+    /* importers only read the external form, so borrow it */
+    borrowed = db_get_external_view(&ext, dp, dbip);
+    if (borrowed < 0)
 	return -2;		/* FAIL */
 
     ret = rt_db_external5_to_internal5(ip, &ext, dp->d_namep, dbip, mat, resp);
-    bu_free_external(&ext);
+    if (!borrowed)
+	bu_free_external(&ext);
     return ret;
 }
 
@@ -1056,6 +1060,7 @@ db5_get_attributes(const struct db_i *dbip, struct bu_attribute_value_set *avs,
 {
     struct bu_external ext = BU_EXTERNAL_INIT_ZERO;
     struct db5_raw_internal raw;
+    int borrowed;
 
     RT_CK_DBI(dbip);
 
@@ -1066,22 +1071,26 @@ db5_get_attributes(const struct db_i *dbip, struct bu_attribute_value_set *avs,
 
     BU_AVS_INIT(avs);
 
-    if (db_get_external(&ext, dp, dbip) < 0)
+    borrowed = db_get_external_view(&ext, dp, dbip);
+    if (borrowed < 0)
 	return -1;		/* FAIL */
 
     if (db5_get_raw_internal_ptr(&raw, ext.ext_buf) == NULL) {
-	bu_free_external(&ext);
+	if (!borrowed)
+	    bu_free_external(&ext);
 	return -2;
     }
 
     if (raw.attributes.ext_buf) {
 	if (db5_import_attributes(avs, &raw.attributes) < 0) {
-	    bu_free_external(&ext);
+	    if (!borrowed)
+		bu_free_external(&ext);
 	    return -3;
 	}
     }
 
-    bu_free_external(&ext);
+    if (!borrowed)
+	bu_free_external(&ext);
     return 0;
 }
 
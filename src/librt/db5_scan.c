@@ -227,6 +227,7 @@ db_diradd5(
     dp->d_uses = 0;
     dp->d_forw = *headp;
     *headp = dp;
+    _db_dirindex_add(dbip->i, dp, _db_dirindex_hash(dp->d_namep));
 
     if (BU_PTBL_IS_INITIALIZED(&dbip->dbi_changed_clbks)) {
 	for (size_t i = 0; i < BU_PTBL_LEN(&dbip->dbi_changed_clbks); i++) {
@@ -240,39 +241,15 @@ db_diradd5(
 
 
 /**
- * Add a raw internal to the database.  If client_data is 1, the entry
- * will be marked as in-mem.
+ * Directory flags for a raw object, cracking open the attributes of
+ * combinations to check for the "region=" attribute.  Safe to call
+ * from multiple threads.
  */
-struct directory *
-db5_diradd(struct db_i *dbip,
-	   const struct db5_raw_internal *rip,
-	   b_off_t laddr,
-	   void *client_data)
+static int
+db5_dir_flags(const struct db5_raw_internal *rip)
 {
-    struct directory **headp;
-    register struct directory *dp;
-    struct bu_vls local = BU_VLS_INIT_ZERO;
-
-    RT_CK_DBI(dbip);
-
-    bu_vls_strcpy(&local, (const char *)rip->name.ext_buf);
-    if (db_dircheck(dbip, &local, 0, &headp) < 0) {
-	bu_vls_free(&local);
-	return RT_DIR_NULL;
-    }
+    int flags = 0;
 
-    if (rt_uniresource.re_magic == 0)
-	rt_init_resource(&rt_uniresource, 0, NULL);
-
-    /* Duplicates the guts of db_diradd() */
-    RT_GET_DIRECTORY(dp, &rt_uniresource); /* allocates a new dir */
-    RT_CK_DIR(dp);
-    BU_LIST_INIT(&dp->d_use_hd);
-    RT_DIR_SET_NAMEP(dp, bu_vls_addr(&local));	/* sets d_namep */
-    bu_vls_free(&local);
-    dp->d_addr = laddr;
-    dp->d_major_type = rip->major_type;
-    dp->d_minor_type = rip->minor_type;
     switch (rip->major_type) {
 	case DB5_MAJORTYPE_BRLCAD:
 	    if (rip->minor_type == ID_COMBINATION) {
@@ -280,7 +257,7 @@ db5_diradd(struct db_i *dbip,
 
 		bu_avs_init_empty(&avs);
 
-		dp->d_flags = RT_DIR_COMB;
+		flags = RT_DIR_COMB;
 		if (rip->attributes.ext_nbytes == 0) break;
 		/*
 		 * Crack open the attributes to
@@ -292,31 +269,76 @@ db5_diradd(struct db_i *dbip,
 		    break;
 		}
 		if (bu_avs_get(&avs, "region") != NULL)
-		    dp->d_flags = RT_DIR_COMB|RT_DIR_REGION;
+		    flags = RT_DIR_COMB|RT_DIR_REGION;
 		bu_avs_free(&avs);
 	    } else {
-		dp->d_flags = RT_DIR_SOLID;
+		flags = RT_DIR_SOLID;
 	    }
 	    break;
 	case DB5_MAJORTYPE_BINARY_UNIF:
 	case DB5_MAJORTYPE_BINARY_MIME:
 	    /* XXX Do we want to define extra flags for this? */
-	    dp->d_flags = RT_DIR_NON_GEOM;
+	    flags = RT_DIR_NON_GEOM;
 	    break;
 	case DB5_MAJORTYPE_ATTRIBUTE_ONLY:
-	    dp->d_flags = 0;
+	    flags = 0;
     }
     if (rip->h_name_hidden)
-	dp->d_flags |= RT_DIR_HIDDEN;
-    if (client_data && (*((int*)client_data) == 1))
-	dp->d_flags |= RT_DIR_INMEM;
-    dp->d_len = rip->object_length;		/* in bytes */
+	flags |= RT_DIR_HIDDEN;
+
+    return flags;
+}
+
+
+/**
+ * Enter a v5 object into the directory.  hash and chain are the name
+ * index and dbi_Head hashes of name.  Names that are already taken
+ * are handed to db_dircheck() for a temporary replacement.
+ */
+static struct directory *
+db5_dir_enter(struct db_i *dbip,
+	      const char *name,
+	      uint64_t hash,
+	      int chain,
+	      b_off_t laddr,
+	      unsigned char major_type,
+	      unsigned char minor_type,
+	      int flags,
+	      size_t object_length)
+{
+    struct directory **headp;
+    register struct directory *dp;
+    struct bu_vls local = BU_VLS_INIT_ZERO;
+
+    if (dbip->i && _db_dirindex_find(dbip->i, name, hash) == RT_DIR_NULL) {
+	headp = &(dbip->dbi_Head[chain]);
+    } else {
+	bu_vls_strcpy(&local, name);
+	if (db_dircheck(dbip, &local, 0, &headp) < 0) {
+	    bu_vls_free(&local);
+	    return RT_DIR_NULL;
+	}
+	name = bu_vls_addr(&local);
+	hash = _db_dirindex_hash(name);
+    }
+
+    /* Duplicates the guts of db_diradd() */
+    RT_GET_DIRECTORY(dp, &rt_uniresource); /* allocates a new dir */
+    RT_CK_DIR(dp);
     BU_LIST_INIT(&dp->d_use_hd);
+    RT_DIR_SET_NAMEP(dp, name);	/* sets d_namep */
+    bu_vls_free(&local);
+    dp->d_addr = laddr;
+    dp->d_major_type = major_type;
+    dp->d_minor_type = minor_type;
+    dp->d_flags = flags;
+    dp->d_len = object_length;		/* in bytes */
     dp->d_animate = NULL;
     dp->d_nref = 0;
     dp->d_uses = 0;
     dp->d_forw = *headp;
     *headp = dp;
+    _db_dirindex_add(dbip->i, dp, hash);
 
     if (BU_PTBL_IS_INITIALIZED(&dbip->dbi_changed_clbks)) {
 	for (size_t i = 0; i < BU_PTBL_LEN(&dbip->dbi_changed_clbks); i++) {
@@ -329,6 +351,33 @@ db5_diradd(struct db_i *dbip,
 }
 
 
+/**
+ * Add a raw internal to the database.  If client_data is 1, the entry
+ * will be marked as in-mem.
+ */
+struct directory *
+db5_diradd(struct db_i *dbip,
+	   const struct db5_raw_internal *rip,
+	   b_off_t laddr,
+	   void *client_data)
+{
+    const char *name = (const char *)rip->name.ext_buf;
+    int flags;
+
+    RT_CK_DBI(dbip);
+
+    if (rt_uniresource.re_magic == 0)
+	rt_init_resource(&rt_uniresource, 0, NULL);
+
+    flags = db5_dir_flags(rip);
+    if (client_data && (*((int*)client_data) == 1))
+	flags |= RT_DIR_INMEM;
+
+    return db5_dir_enter(dbip, name, _db_dirindex_hash(name), db_dirhash(name),
+			 laddr, rip->major_type, rip->minor_type, flags, rip->object_length);
+}
+
+
 /**
  * In support of db5_scan(), this helper function adds a named entry
  * to the directory.  If client_data is 1, it entry will be added as
@@ -363,6 +412,235 @@ db5_diradd_handler(
     return;
 }
 
+/*
+ * Parallel directory build for v5 databases.
+ *
+ * A serial pass over the mapped file finds the record boundaries,
+ * which only requires the leading bytes of each header.  The headers
+ * and names are then decoded and hashed and the "region" attribute
+ * of combinations is checked in parallel, and finally the entries are
+ * entered into the directory in file order so the result (including
+ * the handling of duplicate names) matches db5_scan() exactly.
+ */
+
+/* below this many records the thread startup isn't worth it */
+#define DB5_DIRBUILD_PARALLEL_MIN 4096
+#define DB5_DIRBUILD_CHUNK 1024
+
+struct db5_dirent {
+    b_off_t addr;
+    size_t len;
+    unsigned char dli;
+    unsigned char major_type;
+    unsigned char minor_type;
+    int flags;
+    int chain;			/**< @brief db_dirhash() of name */
+    uint64_t hash;		/**< @brief _db_dirindex_hash() of name */
+    const char *name;		/**< @brief NULL if not a named object */
+};
+
+struct db5_dirbuild_state {
+    const unsigned char *buf;
+    struct db5_dirent *ents;
+    size_t nents;
+    size_t next;
+};
+
+
+static void
+db5_dirbuild_decode(int UNUSED(cpu), void *data)
+{
+    struct db5_dirbuild_state *s = (struct db5_dirbuild_state *)data;
+
+    while (1) {
+	size_t start, end, j;
+
+	bu_semaphore_acquire(RT_SEM_WORKER);
+	start = s->next;
+	s->next += DB5_DIRBUILD_CHUNK;
+	bu_semaphore_release(RT_SEM_WORKER);
+
+	if (start >= s->nents)
+	    break;
+	end = (start + DB5_DIRBUILD_CHUNK < s->nents) ? start + DB5_DIRBUILD_CHUNK : s->nents;
+
+	for (j = start; j < end; j++) {
+	    struct db5_dirent *e = &s->ents[j];
+	    struct db5_raw_internal raw;
+
+	    e->name = NULL;
+	    if (e->dli == DB5HDR_HFLAGS_DLI_HEADER_OBJECT || e->dli == DB5HDR_HFLAGS_DLI_FREE_STORAGE)
+		continue;
+
+	    raw.magic = DB5_RAW_INTERNAL_MAGIC;
+	    if (db5_get_raw_internal_ptr(&raw, s->buf + e->addr) == NULL)
+		continue;
+
+	    /* If somehow it doesn't have a name, ignore it */
+	    if (raw.name.ext_buf == NULL)
+		continue;
+
+	    e->name = (const char *)raw.name.ext_buf;
+	    e->major_type = raw.major_type;
+	    e->minor_type = raw.minor_type;
+	    e->flags = db5_dir_flags(&raw);
+	    e->chain = db_dirhash(e->name);
+	    e->hash = _db_dirindex_hash(e->name);
+	}
+    }
+}
+
+
+/**
+ * Build the directory of a v5 database from the in-memory image buf
+ * of eof bytes.  Returns 0 on success and -1 if a corrupt record was
+ * found, in which case the records before it are still entered.
+ */
+static int
+db5_dirbuild_parallel(struct db_i *dbip, const unsigned char *buf, b_off_t eof)
+{
+    struct db5_dirbuild_state state;
+    struct db5_dirent *ents = NULL;
+    size_t nents = 0;
+    size_t cap = 0;
+    size_t nnamed = 0;
+    size_t j;
+    b_off_t addr;
+    int ret = 0;
+
+    if (eof < (b_off_t)8 || db5_header_is_valid(buf) == 0) {
+	bu_log("db5_scan ERROR:  %s is lacking a proper BRL-CAD v5 database header\n", dbip->dbi_filename);
+	dbip->dbi_read_only = 1;	/* Writing could corrupt it worse */
+	return -1;
+    }
+
+    /* Pass 1: record boundaries */
+    addr = (b_off_t)8;
+    while (addr < eof) {
+	const unsigned char *cp = buf + addr;
+	size_t avail = (size_t)(eof - addr);
+	size_t len = 0;
+	int width;
+
+	if (avail < sizeof(struct db5_ondisk_header) + 1 || cp[0] != DB5HDR_MAGIC1) {
+	    bu_log("db5_scan ERROR:  %s has a bad object header at offset %jd\n", dbip->dbi_filename, (intmax_t)addr);
+	    ret = -1;
+	    break;
+	}
+	width = (cp[1] & DB5HDR_HFLAGS_OBJECT_WIDTH_MASK) >> DB5HDR_HFLAGS_OBJECT_WIDTH_SHIFT;
+	if (avail < sizeof(struct db5_ondisk_header) + ((size_t)1 << width)) {
+	    bu_log("db5_scan ERROR:  %s is truncated at offset %jd\n", dbip->dbi_filename, (intmax_t)addr);
+	    ret = -1;
+	    break;
+	}
+	db5_decode_length(&len, cp + sizeof(struct db5_ondisk_header), width);
+	if (len > avail / 8 || len * 8 < sizeof(struct db5_ondisk_header) + ((size_t)1 << width)) {
+	    bu_log("db5_scan ERROR:  %s has a bad object length at offset %jd\n", dbip->dbi_filename, (intmax_t)addr);
+	    ret = -1;
+	    break;
+	}
+	len <<= 3;	/* cvt 8-byte chunks to byte count */
+	if (cp[len-1] != DB5HDR_MAGIC2) {
+	    bu_log("db5_scan ERROR:  %s bad magic2 at offset %jd\n", dbip->dbi_filename, (intmax_t)addr);
+	    ret = -1;
+	    break;
+	}
+
+	if (nents == cap) {
+	    cap = (cap) ? cap * 2 : 4096;
+	    ents = (struct db5_dirent *)bu_realloc(ents, cap * sizeof(struct db5_dirent), "db5_dirent");
+	}
+	ents[nents].addr = addr;
+	ents[nents].len = len;
+	ents[nents].dli = cp[1] & DB5HDR_HFLAGS_DLI_MASK;
+	nents++;
+
+	addr += (b_off_t)len;
+    }
+
+    /* Pass 2: decode */
+    state.buf = buf;
+    state.ents = ents;
+    state.nents = nents;
+    state.next = 0;
+    bu_parallel(db5_dirbuild_decode, (nents < DB5_DIRBUILD_PARALLEL_MIN) ? 1 : 0, &state);
+
+    /* Pass 3: enter in file order */
+    if (rt_uniresource.re_magic == 0)
+	rt_init_resource(&rt_uniresource, 0, NULL);
+
+    for (j = 0; j < nents; j++) {
+	if (ents[j].name)
+	    nnamed++;
+    }
+    _db_dirindex_reserve(dbip->i, nnamed);
+
+    for (j = 0; j < nents; j++) {
+	struct db5_dirent *e = &ents[j];
+
+	if (e->dli == DB5HDR_HFLAGS_DLI_FREE_STORAGE) {
+	    /* Record available free storage */
+	    rt_memfree(&(dbip->dbi_freep), e->len, e->addr);
+	    continue;
+	}
+	if (!e->name)
+	    continue;
+
+	if (RT_G_DEBUG&RT_DEBUG_DB) {
+	    bu_log("db5_diradd_handler(dbip=%p, name='%s', addr=%jd, len=%zu)\n",
+		   (void *)dbip, e->name, (intmax_t)e->addr, e->len);
+	}
+
+	db5_dir_enter(dbip, e->name, e->hash, e->chain, e->addr,
+		      e->major_type, e->minor_type, e->flags, e->len);
+    }
+
+    if (ents)
+	bu_free(ents, "db5_dirent");
+
+    if (ret < 0) {
+	dbip->dbi_read_only = 1;	/* Writing could corrupt it worse */
+	return -1;
+    }
+
+    dbip->dbi_eof = addr;
+    dbip->dbi_nrec = nents;		/* # obj in db, not inc. header */
+    return 0;
+}
+
+
+/**
+ * Build the v5 directory, using the parallel builder over a mapping
+ * of the file when one can be had and db5_scan() otherwise.
+ */
+static int
+db5_dirbuild(struct db_i *dbip)
+{
+    struct bu_mapped_file *mfp;
+    int ret;
+
+    if (dbip->dbi_mf)
+	return db5_dirbuild_parallel(dbip, (const unsigned char *)dbip->dbi_inmem, (b_off_t)dbip->dbi_mf->buflen);
+
+    /* Read-write databases are opened with stdio only, so map the
+     * file just for the scan.  Flush first so that the mapping sees
+     * anything already written through dbi_fp. */
+    if (!dbip->dbi_filename || fflush(dbip->dbi_fp) != 0)
+	return db5_scan(dbip, db5_diradd_handler, NULL);
+    mfp = bu_open_mapped_file(dbip->dbi_filename, "db_dirbuild");
+    if (!mfp)
+	return db5_scan(dbip, db5_diradd_handler, NULL);
+
+    ret = db5_dirbuild_parallel(dbip, (const unsigned char *)mfp->buf, (b_off_t)mfp->buflen);
+
+    /* entry names were copied, the mapping is no longer needed */
+    bu_close_mapped_file(mfp);
+    rewind(dbip->dbi_fp);
+
+    return ret;
+}
+
+
 static int
 db_diradd4(struct db_i *dbi, const char *s, b_off_t o,  size_t st,  int i,  void *v)
 {
@@ -399,7 +677,7 @@ db_dirbuild(struct db_i *dbip)
 	bu_avs_init_empty(&avs);
 
 	/* File is v5 format */
-	if (db5_scan(dbip, db5_diradd_handler, NULL) < 0) {
+	if (db5_dirbuild(dbip) < 0) {
 	    bu_log("db_dirbuild(%s): db5_scan() failed\n", dbip->dbi_filename);
 	    return -1;
 	}
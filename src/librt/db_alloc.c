@@ -33,6 +33,7 @@
 #include "vmath.h"
 #include "rt/db4.h"
 #include "raytrace.h"
+#include "./librt_private.h"
 
 
 /**
@@ -260,6 +261,74 @@ rt_alloc_seg_block(register struct resource *res)
 }
 
 
+void
+rt_alloc_pt_block(register struct resource *res)
+{
+    register struct partition *pp;
+    size_t bytes;
+
+    RT_CK_RESOURCE(res);
+
+    if (!BU_LIST_IS_INITIALIZED(&res->re_parthead))
+	BU_LIST_INIT(&res->re_parthead);
+    if (!BU_LIST_IS_INITIALIZED(&res->re_part_blocks.l))
+	bu_ptbl_init(&res->re_part_blocks, 64, "re_part_blocks ptbl");
+
+    bytes = bu_malloc_len_roundup(64*sizeof(struct partition));
+    pp = (struct partition *)bu_malloc(bytes, "rt_alloc_pt_block()");
+    bu_ptbl_ins(&res->re_part_blocks, (long *)pp);
+    while (bytes >= sizeof(struct partition)) {
+	pp->pt_magic = PT_MAGIC;
+	pp->pt_overlap_reg = NULL;
+	bu_ptbl_init(&pp->pt_seglist, 8, "pt_seglist ptbl");
+	BU_LIST_INSERT(&(res->re_parthead), (struct bu_list *)pp);
+	res->re_partlen++;
+	pp++;
+	bytes -= sizeof(struct partition);
+    }
+}
+
+
+void
+rt_pt_list_release(struct partition *headp, struct resource *res)
+{
+    register struct partition *pp;
+    long n = 0;
+
+    if (headp->pt_forw == headp)
+	return;
+
+    /* Only overlap partitions own anything beyond their block slot */
+    for (pp = headp->pt_forw; pp != headp; pp = pp->pt_forw) {
+	if (pp->pt_overlap_reg) {
+	    bu_free((void *)pp->pt_overlap_reg, "pt_overlap_reg");
+	    pp->pt_overlap_reg = NULL;
+	}
+	n++;
+    }
+
+    BU_LIST_INSERT_LIST(&res->re_parthead, (struct bu_list *)headp);
+    res->re_partfree += n;
+}
+
+
+void
+rt_seg_list_release(struct seg *segheadp, struct resource *res)
+{
+    register struct bu_list *lp;
+    long n = 0;
+
+    if (BU_LIST_IS_EMPTY(&segheadp->l))
+	return;
+
+    for (BU_LIST_FOR(lp, bu_list, &segheadp->l))
+	n++;
+
+    BU_LIST_INSERT_LIST(&res->re_seg, &segheadp->l);
+    res->re_segfree += n;
+}
+
+
 /** @} */
 
 /*
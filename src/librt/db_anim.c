@@ -74,6 +74,41 @@ db_add_anim(struct db_i *dbip, register struct animate *anp, int root)
 }
 
 
+int
+db_anim_on_path(const struct animate *anp, const struct db_full_path *pathp)
+{
+    struct directory *dp;
+    long i, j;
+    size_t k;
+
+    RT_CK_ANIMATE(anp);
+    RT_CK_FULL_PATH(pathp);
+
+    dp = DB_FULL_PATH_CUR_DIR(&anp->an_path);
+    if (!dp)
+	return 0;
+
+    /* Try every node where the animated arc could end, comparing
+     * right-to-left the way db_apply_anims() does.
+     */
+    for (k = 0; k < pathp->fp_len; k++) {
+	if (pathp->fp_names[k] != dp)
+	    continue;
+
+	i = (long)anp->an_path.fp_len - 1;
+	j = (long)k;
+	for (; i >= 0 && j >= 0; i--, j--) {
+	    if (anp->an_path.fp_names[i] != pathp->fp_names[j])
+		break;
+	}
+	if (i < 0 || j < 0)
+	    return 1;
+    }
+
+    return 0;
+}
+
+
 static char *db_anim_matrix_strings[] = {
     "(nope)",
     "ANM_RSTACK",
@@ -28,6 +28,7 @@
 #include "common.h"
 
 #include <string.h>
+#include <errno.h>
 #ifdef HAVE_SYS_TYPES_H
 #  include <sys/types.h>
 #endif
@@ -79,6 +80,26 @@ db_read(const struct db_i *dbip, void *addr, size_t count, b_off_t offset)
 	memcpy(addr, ((char *)dbip->dbi_inmem) + offset, count);
 	return 0;
     }
+#ifdef HAVE_PREAD
+    /* Positional reads leave the shared file offset alone, so
+     * concurrent readers need not serialize on BU_SEM_SYSCALL.
+     * db_write() flushes stdio after every write, so the descriptor
+     * always sees current data.
+     */
+    {
+	int fd = fileno(dbip->dbi_fp);
+	got = 0;
+	while (got < count) {
+	    ssize_t n = pread(fd, (char *)addr + got, count - got, (off_t)(offset + got));
+	    if (n < 0 && errno == EINTR)
+		continue;
+	    if (n <= 0)
+		break;
+	    got += (size_t)n;
+	}
+    }
+    (void)ret;
+#else
     bu_semaphore_acquire(BU_SEM_SYSCALL);
 
     ret = bu_fseek(dbip->dbi_fp, offset, 0);
@@ -87,6 +108,7 @@ db_read(const struct db_i *dbip, void *addr, size_t count, b_off_t offset)
     got = (size_t)fread(addr, 1, count, dbip->dbi_fp);
 
     bu_semaphore_release(BU_SEM_SYSCALL);
+#endif
 
     if (got != count) {
 	perror(dbip->dbi_filename);
@@ -286,6 +308,44 @@ db_get_external(register struct bu_external *ep, const struct directory *dp, con
 }
 
 
+int
+db_get_external_view(struct bu_external *ep, const struct directory *dp, const struct db_i *dbip)
+{
+    size_t nbytes;
+
+    RT_CK_DBI(dbip);
+    RT_CK_DIR(dp);
+
+    if ((dp->d_flags & RT_DIR_INMEM) == 0 && dp->d_addr == RT_DIR_PHONY_ADDR)
+	return -1;		/* was dummy DB entry */
+
+    if (db_version(dbip) < 5)
+	nbytes = dp->d_len * sizeof(union record);
+    else
+	nbytes = dp->d_len;
+
+    if (dp->d_flags & RT_DIR_INMEM) {
+	BU_EXTERNAL_INIT(ep);
+	ep->ext_nbytes = nbytes;
+	ep->ext_buf = (uint8_t *)dp->d_un.ptr;
+	return 1;
+    }
+
+    if (dbip->dbi_inmem && nbytes > 0 && dp->d_addr >= 0
+	&& dp->d_addr + nbytes <= (size_t)dbip->dbi_eof) {
+	BU_EXTERNAL_INIT(ep);
+	ep->ext_nbytes = nbytes;
+	ep->ext_buf = ((uint8_t *)dbip->dbi_inmem) + dp->d_addr;
+	return 1;
+    }
+
+    /* not mapped, fall back to an owned copy */
+    if (db_get_external(ep, dp, dbip) < 0)
+	return -1;
+    return 0;
+}
+
+
 int
 db_put_external(struct bu_external *ep, struct directory *dp, struct db_i *dbip)
 {
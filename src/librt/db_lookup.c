@@ -102,6 +102,182 @@ db_dirhash(const char *str)
 }
 
 
+/*
+ * Directory name index.
+ *
+ * Open addressing with linear probing over a power-of-two table that
+ * doubles when it becomes half full, so lookups stay O(1) however
+ * many objects a database holds.  The slots carry the full 64-bit
+ * hash so probes rarely need to touch the directory entries.
+ */
+
+#define DIRINDEX_MIN_SLOTS 64
+
+
+uint64_t
+_db_dirindex_hash(const char *name)
+{
+    const unsigned char *s = (const unsigned char *)name;
+    uint64_t h = 0xcbf29ce484222325ULL;	/* FNV-1a */
+
+    while (*s) {
+	h ^= (uint64_t)*s++;
+	h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+
+static void
+dirindex_resize(struct db_i_internal *i, size_t nslots)
+{
+    struct db_dirindex_slot *old = i->dir_slots;
+    size_t oldn = i->dir_nslots;
+    size_t mask = nslots - 1;
+    size_t j;
+
+    i->dir_slots = (struct db_dirindex_slot *)bu_calloc(nslots, sizeof(struct db_dirindex_slot), "dir index");
+    i->dir_nslots = nslots;
+
+    for (j = 0; j < oldn; j++) {
+	size_t k;
+	if (old[j].dp == RT_DIR_NULL)
+	    continue;
+	k = (size_t)old[j].hash & mask;
+	while (i->dir_slots[k].dp != RT_DIR_NULL)
+	    k = (k + 1) & mask;
+	i->dir_slots[k] = old[j];
+    }
+
+    if (old)
+	bu_free(old, "dir index");
+}
+
+
+void
+_db_dirindex_reserve(struct db_i_internal *i, size_t n)
+{
+    size_t nslots;
+
+    if (!i)
+	return;
+
+    nslots = (i->dir_nslots) ? i->dir_nslots : DIRINDEX_MIN_SLOTS;
+    while ((i->dir_count + n) * 2 > nslots)
+	nslots *= 2;
+    if (nslots != i->dir_nslots)
+	dirindex_resize(i, nslots);
+}
+
+
+struct directory *
+_db_dirindex_find(const struct db_i_internal *i, const char *name, uint64_t hash)
+{
+    size_t mask, k;
+
+    if (!i || !i->dir_count)
+	return RT_DIR_NULL;
+
+    mask = i->dir_nslots - 1;
+    for (k = (size_t)hash & mask; i->dir_slots[k].dp != RT_DIR_NULL; k = (k + 1) & mask) {
+	if (i->dir_slots[k].hash == hash && BU_STR_EQUAL(name, i->dir_slots[k].dp->d_namep))
+	    return i->dir_slots[k].dp;
+    }
+    return RT_DIR_NULL;
+}
+
+
+void
+_db_dirindex_add(struct db_i_internal *i, struct directory *dp, uint64_t hash)
+{
+    size_t mask, k;
+
+    if (!i)
+	return;
+
+    _db_dirindex_reserve(i, 1);
+
+    mask = i->dir_nslots - 1;
+    k = (size_t)hash & mask;
+    while (i->dir_slots[k].dp != RT_DIR_NULL)
+	k = (k + 1) & mask;
+    i->dir_slots[k].hash = hash;
+    i->dir_slots[k].dp = dp;
+    i->dir_count++;
+}
+
+
+void
+_db_dirindex_remove(struct db_i_internal *i, const struct directory *dp)
+{
+    size_t mask, k, hole;
+
+    if (!i || !i->dir_count)
+	return;
+
+    mask = i->dir_nslots - 1;
+    k = (size_t)_db_dirindex_hash(dp->d_namep) & mask;
+    while (i->dir_slots[k].dp != dp) {
+	if (i->dir_slots[k].dp == RT_DIR_NULL)
+	    return;		/* not indexed */
+	k = (k + 1) & mask;
+    }
+
+    /* Backward-shift deletion keeps every probe sequence unbroken
+     * without tombstones. */
+    hole = k;
+    for (k = (hole + 1) & mask; i->dir_slots[k].dp != RT_DIR_NULL; k = (k + 1) & mask) {
+	size_t home = (size_t)i->dir_slots[k].hash & mask;
+	if (((k - home) & mask) >= ((k - hole) & mask)) {
+	    i->dir_slots[hole] = i->dir_slots[k];
+	    hole = k;
+	}
+    }
+    i->dir_slots[hole].dp = RT_DIR_NULL;
+    i->dir_slots[hole].hash = 0;
+    i->dir_count--;
+}
+
+
+void
+_db_dirindex_free(struct db_i_internal *i)
+{
+    if (!i)
+	return;
+
+    if (i->dir_slots)
+	bu_free(i->dir_slots, "dir index");
+    i->dir_slots = NULL;
+    i->dir_nslots = 0;
+    i->dir_count = 0;
+}
+
+
+/**
+ * Exact name match in the directory, through the name index when the
+ * database has one and by walking the hash chain otherwise.
+ */
+static struct directory *
+dir_find(const struct db_i *dbip, const char *name)
+{
+    struct directory *dp;
+    char n0 = name[0];
+    char n1 = name[1];
+
+    if (dbip->i)
+	return _db_dirindex_find(dbip->i, name, _db_dirindex_hash(name));
+
+    for (dp = dbip->dbi_Head[db_dirhash(name)]; dp != RT_DIR_NULL; dp = dp->d_forw) {
+	char *this_obj;
+
+	/* first two checks are for speed */
+	if ((n0 == *(this_obj=dp->d_namep)) && (n1 == this_obj[1]) && (BU_STR_EQUAL(name, this_obj)))
+	    return dp;
+    }
+    return RT_DIR_NULL;
+}
+
+
 int
 db_dircheck(struct db_i *dbip,
 	    struct bu_vls *ret_name,
@@ -110,41 +286,35 @@ db_dircheck(struct db_i *dbip,
 {
     struct directory *dp;
     char *cp = bu_vls_addr(ret_name);
-    char n0 = cp[0];
-    char n1 = cp[1];
 
     /* Compute hash only once (almost always the case) */
     *headp = &(dbip->dbi_Head[db_dirhash(cp)]);
 
-    for (dp = **headp; dp != RT_DIR_NULL; dp=dp->d_forw) {
-	char *this_obj;
-	if (n0 == *(this_obj=dp->d_namep)  &&	/* speed */
-	    n1 == this_obj[1]  &&			/* speed */
-	    BU_STR_EQUAL(cp, this_obj)) {
-	    /* Name exists in directory already */
-	    int c;
-
-	    bu_vls_strcpy(ret_name, "A_");
-	    bu_vls_strcat(ret_name, this_obj);
-	    cp = bu_vls_addr(ret_name);
-
-	    for (c = 'A'; c <= 'Z'; c++) {
-		*cp = c;
-		if (db_lookup(dbip, cp, noisy) == RT_DIR_NULL)
-		    break;
-	    }
-	    if (c > 'Z') {
-		bu_log("db_dircheck: Duplicate of name '%s', ignored\n",
-		       cp);
-		return -1;	/* fail */
-	    }
-	    bu_log("db_dircheck: Duplicate of '%s', given temporary name '%s'\n",
-		   cp+2, cp);
+    dp = dir_find(dbip, cp);
+    if (dp != RT_DIR_NULL) {
+	/* Name exists in directory already */
+	char *this_obj = dp->d_namep;
+	int c;
+
+	bu_vls_strcpy(ret_name, "A_");
+	bu_vls_strcat(ret_name, this_obj);
+	cp = bu_vls_addr(ret_name);
 
-	    /* no need to recurse, simply recompute the hash and break */
-	    *headp = &(dbip->dbi_Head[db_dirhash(cp)]);
-	    break;
+	for (c = 'A'; c <= 'Z'; c++) {
+	    *cp = c;
+	    if (db_lookup(dbip, cp, noisy) == RT_DIR_NULL)
+		break;
+	}
+	if (c > 'Z') {
+	    bu_log("db_dircheck: Duplicate of name '%s', ignored\n",
+		   cp);
+	    return -1;	/* fail */
 	}
+	bu_log("db_dircheck: Duplicate of '%s', given temporary name '%s'\n",
+	       cp+2, cp);
+
+	/* no need to recurse, simply recompute the hash */
+	*headp = &(dbip->dbi_Head[db_dirhash(cp)]);
     }
 
     return 0;	/* success */
@@ -157,8 +327,6 @@ db_lookup(const struct db_i *dbip, const char *name, int noisy)
     int is_path = 0;
     const char *pc = name;
     struct directory *dp = RT_DIR_NULL;
-    char n0;
-    char n1;
 
     /* No string, no lookup */
     if (UNLIKELY(!name || name[0] == '\0')) {
@@ -172,22 +340,14 @@ db_lookup(const struct db_i *dbip, const char *name, int noisy)
     }
 
 
-    n0 = name[0];
-    n1 = name[1];
-
     RT_CK_DBI(dbip);
 
-    dp = dbip->dbi_Head[db_dirhash(name)];
-    for (; dp != RT_DIR_NULL; dp=dp->d_forw) {
-	char *this_obj;
-
-	/* first two checks are for speed */
-	if ((n0 == *(this_obj=dp->d_namep)) && (n1 == this_obj[1]) && (BU_STR_EQUAL(name, this_obj))) {
-	    if (UNLIKELY(RT_G_DEBUG&RT_DEBUG_DB)) {
-		bu_log("db_lookup(%s) %p\n", name, (void *)dp);
-	    }
-	    return dp;
+    dp = dir_find(dbip, name);
+    if (dp != RT_DIR_NULL) {
+	if (UNLIKELY(RT_G_DEBUG&RT_DEBUG_DB)) {
+	    bu_log("db_lookup(%s) %p\n", name, (void *)dp);
 	}
+	return dp;
     }
 
     /* Anything with a forward slash is potentially a path, rather than an object
@@ -296,6 +456,7 @@ db_diradd(struct db_i *dbip, const char *name, b_off_t laddr, size_t len, int fl
     dp->d_forw = *headp;
     BU_LIST_INIT(&dp->d_use_hd);
     *headp = dp;
+    _db_dirindex_add(dbip->i, dp, _db_dirindex_hash(dp->d_namep));
     dp->d_animate = NULL;
     dp->d_nref = 0;
     dp->d_uses = 0;
@@ -353,6 +514,7 @@ db_dirdelete(struct db_i *dbip, struct directory *dp)
 	    }
 	}
 
+	_db_dirindex_remove(dbip->i, dp);
 	RT_DIR_FREE_NAMEP(dp);	/* frees d_namep */
 	*headp = dp->d_forw;
 
@@ -375,6 +537,7 @@ db_dirdelete(struct db_i *dbip, struct directory *dp)
 	    }
 	}
 
+	_db_dirindex_remove(dbip->i, dp);
 	RT_DIR_FREE_NAMEP(dp);	/* frees d_namep */
 	findp->d_forw = dp->d_forw;
 
@@ -413,6 +576,8 @@ db_rename(struct db_i *dbip, struct directory *dp, const char *newname)
     }
 
 out:
+    _db_dirindex_remove(dbip->i, dp);
+
     /* Effect new name */
     RT_DIR_FREE_NAMEP(dp);			/* frees d_namep */
     RT_DIR_SET_NAMEP(dp, newname);	/* sets d_namep */
@@ -421,6 +586,7 @@ out:
     headp = &(dbip->dbi_Head[db_dirhash(newname)]);
     dp->d_forw = *headp;
     *headp = dp;
+    _db_dirindex_add(dbip->i, dp, _db_dirindex_hash(dp->d_namep));
     return 0;
 }
 
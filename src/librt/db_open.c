@@ -644,6 +644,12 @@ db_i_internal_create(void)
     struct db_i_internal *i;
     BU_GET(i, struct db_i_internal);
     i->dbi_magic = DBI_MAGIC;
+    i->mesh_c = NULL;
+    i->mesh_c_completed = 0;
+    i->mesh_c_target = 0;
+    i->dir_slots = NULL;
+    i->dir_nslots = 0;
+    i->dir_count = 0;
 
     return i;
 }
@@ -657,6 +663,8 @@ db_i_internal_destroy(struct db_i_internal *i)
     if (i->mesh_c)
 	bv_mesh_lod_context_destroy(i->mesh_c);
 
+    _db_dirindex_free(i);
+
     BU_PUT(i, struct db_i_internal);
 }
 
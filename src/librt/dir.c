@@ -116,6 +116,7 @@ rt_db_get_internal(
     struct resource *resp)
 {
     struct bu_external ext;
+    int borrowed;
     int id;
     int ret;
 
@@ -126,7 +127,9 @@ rt_db_get_internal(
 
     BU_EXTERNAL_INIT(&ext);
 
-    if (db_get_external(&ext, dp, dbip) < 0)
+    /* importers only read the external form, so borrow it */
+    borrowed = db_get_external_view(&ext, dp, dbip);
+    if (borrowed < 0)
 	return -2;		/* FAIL */
 
     if (dp->d_flags & RT_DIR_COMB) {
@@ -147,10 +150,12 @@ rt_db_get_internal(
 	bu_log("rt_db_get_internal(%s):  import failure\n",
 	       dp->d_namep);
 	rt_db_free_internal(ip);
-	bu_free_external(&ext);
+	if (!borrowed)
+	    bu_free_external(&ext);
 	return -1;		/* FAIL */
     }
-    bu_free_external(&ext);
+    if (!borrowed)
+	bu_free_external(&ext);
     RT_CK_DB_INTERNAL(ip);
     ip->idb_meth = &OBJ[id];
 
@@ -76,6 +76,14 @@ struct db_i_internal {
     int mesh_c_completed;
     int mesh_c_target;
 
+    /* Name index over the directory (see db_lookup.c).  dbi_Head is
+     * still maintained for code that walks the directory, but lookups
+     * go through this table, which grows with the database instead of
+     * being fixed at RT_DBNHASH buckets. */
+    struct db_dirindex_slot *dir_slots;
+    size_t dir_nslots;
+    size_t dir_count;
+
     // TODO - really need to get the rt prep cache container
     // in here and add a pointer slot to it for rt_db_internal
     // so the librt point generation routines can take advantage
@@ -143,7 +151,77 @@ extern const union cutter *rt_advance_to_next_cell(struct rt_shootray_status *ss
  * used by rt_shootray_bundle()
  * FIXME: non-public API shouldn't be using rt_ prefix
  */
-extern void rt_plot_cell(const union cutter *cutp, struct rt_shootray_status *ssp, struct bu_list *waiting_segs_hd, struct rt_i *rtip);
+extern void rt_plot_cell(const union cutter *cutp, const struct rt_shootray_status *ssp, struct bu_list *waiting_segs_hd, struct rt_i *rtip);
+
+/* cut.c */
+
+/**
+ * Build the RT_PART_HLBVH scene hierarchy over the bounding RPPs of
+ * all finite solids in the model.  Any previous hierarchy is released
+ * first.  Infinite solids are left to rtip->rti_inf_box.
+ */
+extern void cut_bvh_build(struct rt_i *rtip);
+
+/**
+ * Release the RT_PART_HLBVH scene hierarchy, if any.
+ */
+extern void cut_bvh_free(struct rt_i *rtip);
+
+/**
+ * Drop a solid that is about to be freed from the scene hierarchy
+ * leaves.  The node bounds are left as they are (conservative).
+ */
+extern void cut_bvh_remove(struct rt_i *rtip, const struct soltab *stp);
+
+/**
+ * Put the given newly prepped solids into the leaf slots emptied by
+ * cut_bvh_remove() and recompute the node bounds bottom up, keeping
+ * the hierarchy's shape.  Returns 0 on success, or -1 when the solids
+ * do not fit the empty slots or the refit hierarchy has become too
+ * loose, in which case the caller should cut_bvh_build() instead.
+ */
+extern int cut_bvh_refit(struct rt_i *rtip, const struct bu_ptbl *solids);
+
+/* primitives/bot/bot.c */
+
+/**
+ * Intersect n (at most RT_PACKET_MAX) rays with a BoT in one pass over
+ * its hierarchy, for rt_shootray_packet().  ret[i] and seghead[i]
+ * receive what rt_bot_shot() would have produced for rp[i].
+ */
+extern void rt_bot_shot_packet(struct soltab *stp, int n, struct xray *rp[], struct application *ap[], struct seg *seghead[], int ret[]);
+
+/* bool.c */
+
+/**
+ * Compile the boolean tree of every region in rtip->Regions[] into
+ * the flat form rt_boolfinal() evaluates, replacing any earlier
+ * compilation.  Must be redone whenever regions or solids are
+ * renumbered.
+ */
+extern void rt_bool_compile(struct rt_i *rtip);
+
+/**
+ * Release the compiled region trees.  rt_boolfinal() falls back to
+ * walking reg_treetop.
+ */
+extern void rt_bool_free(struct rt_i *rtip);
+
+/* db_alloc.c */
+
+/**
+ * Return every partition on the list headed by headp to the resource
+ * freelist in one splice, leaving headp empty.  Equivalent to
+ * RT_FREE_PT_LIST, used at the end of each ray.
+ */
+extern void rt_pt_list_release(struct partition *headp, struct resource *res);
+
+/**
+ * Return every seg on the list headed by segheadp to the resource
+ * freelist in one splice, leaving segheadp empty.  Equivalent to
+ * RT_FREE_SEG_LIST, used at the end of each ray.
+ */
+extern void rt_seg_list_release(struct seg *segheadp, struct resource *res);
 
 /* db_fullpath.c */
 
@@ -158,6 +236,43 @@ extern void rt_plot_cell(const union cutter *cutp, struct rt_shootray_status *ss
 extern int cyclic_path(const struct db_full_path *fp, const char *test_name, long int depth);
 
 
+/* db_lookup.c */
+
+struct db_dirindex_slot {
+    uint64_t hash;
+    struct directory *dp;	/**< @brief RT_DIR_NULL when empty */
+};
+
+/**
+ * Hash of an object name for the directory name index.
+ */
+extern uint64_t _db_dirindex_hash(const char *name);
+
+/**
+ * Find the directory entry named name, which hashes to hash, in the
+ * name index.  Returns RT_DIR_NULL if there is none.
+ */
+extern struct directory *_db_dirindex_find(const struct db_i_internal *i, const char *name, uint64_t hash);
+
+/**
+ * Make room for n more names in the index without rehashing.
+ */
+extern void _db_dirindex_reserve(struct db_i_internal *i, size_t n);
+
+/**
+ * Add or remove a directory entry.  dp->d_namep must be set (and, for
+ * removal, still be the name dp was added under).  All of these are
+ * no-ops if i is NULL.
+ */
+extern void _db_dirindex_add(struct db_i_internal *i, struct directory *dp, uint64_t hash);
+extern void _db_dirindex_remove(struct db_i_internal *i, const struct directory *dp);
+
+/**
+ * Release the index storage.
+ */
+extern void _db_dirindex_free(struct db_i_internal *i);
+
+
 /* db_diff.c */
 
 /**
@@ -260,10 +375,64 @@ extern void plot_ellipse(
 extern int _rt_tcl_list_to_int_array(const char *list, int **array, int *array_len);
 extern int _rt_tcl_list_to_fastf_array(const char *list, fastf_t **array, int *array_len);
 
+/* primitives/obj_prep.c */
+
+/**
+ * Cursor over a bu_external for the ft_prep_serialize() callbacks.
+ * Values are stored in network order so a cache may be shared across
+ * architectures.  Reads past the end of the buffer set err and yield
+ * zeros, so a loader may decode a whole record and check err once.
+ */
+struct rt_prep_stream {
+    struct bu_external *ext;
+    size_t pos;
+    size_t cap;
+    int err;
+};
+
+/**
+ * Begin reading from or appending to ext, which must have been
+ * initialized.  When writing, call rt_prep_stream_finish() to set the
+ * final byte count.
+ */
+extern void rt_prep_stream_init(struct rt_prep_stream *s, struct bu_external *ext);
+extern void rt_prep_stream_finish(struct rt_prep_stream *s);
+
+extern void rt_prep_put_uint32(struct rt_prep_stream *s, uint32_t v);
+extern void rt_prep_put_fastf(struct rt_prep_stream *s, const fastf_t *v, size_t n);
+extern void rt_prep_put_bytes(struct rt_prep_stream *s, const void *v, size_t n);
+extern uint32_t rt_prep_get_uint32(struct rt_prep_stream *s);
+extern void rt_prep_get_fastf(struct rt_prep_stream *s, fastf_t *v, size_t n);
+extern void rt_prep_get_bytes(struct rt_prep_stream *s, void *v, size_t n);
+
 /* view.c */
 extern fastf_t solid_point_spacing(const struct bview *gvp, fastf_t solid_width);
 extern fastf_t view_avg_sample_spacing(const struct bview *gvp);
 
+/* vshoot.c */
+
+/**
+ * Number of ray/solid pairs the ft_vshot() kernels work through per
+ * pass over their structure-of-arrays scratch space.
+ */
+#define RT_VSHOT_BLOCK 32
+
+/**
+ * Move the segments an ft_shot() style routine left on seghead into
+ * one slot of an ft_vshot() result array.  The first segment is
+ * copied into *segp and any others are moved onto segp->l, which the
+ * caller must have initialized as an empty list head.  segp->seg_stp
+ * is left NULL if seghead was empty.
+ */
+extern void rt_vshot_store(struct seg *segp, struct seg *seghead, struct resource *resp);
+
+/**
+ * Intersect n rays with one solid through its ft_vshot() method,
+ * RT_VSHOT_BLOCK rays at a time.  ret[i] and seghead[i] receive what
+ * ft_shot() would have produced for rp[i].
+ */
+extern void rt_vshot_solid(struct soltab *stp, int n, struct xray *rp[], struct application *ap, struct seg *seghead[], int ret[]);
+
 
 #ifdef USE_OPENCL
 extern cl_device_id clt_get_cl_device(void);
@@ -47,6 +47,8 @@
 #include "optical.h"
 #include "optical/plastic.h"
 
+#include "./librt_private.h"
+
 
 extern void rt_ck(struct rt_i *rtip);
 
@@ -191,6 +193,50 @@ rt_free_rti(struct rt_i *rtip)
 }
 
 
+/**
+ * (Re)build the tables of soltab pointers by solid type from the
+ * current soltab lists.
+ */
+static void
+rt_sol_by_type_build(struct rt_i *rtip)
+{
+    struct soltab *stp;
+    int i;
+
+    for (i=0; i <= ID_MAX_SOLID; i++) {
+	if (rtip->rti_sol_by_type[i])
+	    bu_free((char *)rtip->rti_sol_by_type[i], "sol_by_type");
+	rtip->rti_sol_by_type[i] = (struct soltab **)0;
+	rtip->rti_nsol_by_type[i] = 0;
+    }
+
+    RT_VISIT_ALL_SOLTABS_START(stp, rtip) {
+	rtip->rti_nsol_by_type[stp->st_id]++;
+    } RT_VISIT_ALL_SOLTABS_END;
+
+    /* Find solid type with maximum length (for rt_shootray) */
+    rtip->rti_maxsol_by_type = 0;
+    for (i=0; i <= ID_MAX_SOLID; i++) {
+	if (rtip->rti_nsol_by_type[i] > rtip->rti_maxsol_by_type) {
+	    rtip->rti_maxsol_by_type = rtip->rti_nsol_by_type[i];
+	}
+    }
+    /* Malloc the storage and zero the counts */
+    for (i=0; i <= ID_MAX_SOLID; i++) {
+	if (rtip->rti_nsol_by_type[i] <= 0)
+	    continue;
+	rtip->rti_sol_by_type[i] = (struct soltab **)bu_calloc(rtip->rti_nsol_by_type[i], sizeof(struct soltab *), "rti_sol_by_type[]");
+	rtip->rti_nsol_by_type[i] = 0;
+    }
+    /* Fill in the array and rebuild the count (aka index) */
+    RT_VISIT_ALL_SOLTABS_START(stp, rtip) {
+	int id;
+	id = stp->st_id;
+	rtip->rti_sol_by_type[id][rtip->rti_nsol_by_type[id]++] = stp;
+    } RT_VISIT_ALL_SOLTABS_END;
+}
+
+
 /**
  * This routine should be called just before the first call to
  * rt_shootray().  It should only be called ONCE per execution, unless
@@ -343,29 +389,9 @@ rt_prep_parallel(struct rt_i *rtip, int ncpu)
 	}
 	BU_ASSERT(*ssp == SOLTAB_NULL);
 	*ssp = stp;
-	rtip->rti_nsol_by_type[stp->st_id]++;
     } RT_VISIT_ALL_SOLTABS_END;
 
-    /* Find solid type with maximum length (for rt_shootray) */
-    rtip->rti_maxsol_by_type = 0;
-    for (i=0; i <= ID_MAX_SOLID; i++) {
-	if (rtip->rti_nsol_by_type[i] > rtip->rti_maxsol_by_type) {
-	    rtip->rti_maxsol_by_type = rtip->rti_nsol_by_type[i];
-	}
-    }
-    /* Malloc the storage and zero the counts */
-    for (i=0; i <= ID_MAX_SOLID; i++) {
-	if (rtip->rti_nsol_by_type[i] <= 0)
-	    continue;
-	rtip->rti_sol_by_type[i] = (struct soltab **)bu_calloc(rtip->rti_nsol_by_type[i], sizeof(struct soltab *), "rti_sol_by_type[]");
-	rtip->rti_nsol_by_type[i] = 0;
-    }
-    /* Fill in the array and rebuild the count (aka index) */
-    RT_VISIT_ALL_SOLTABS_START(stp, rtip) {
-	int id;
-	id = stp->st_id;
-	rtip->rti_sol_by_type[id][rtip->rti_nsol_by_type[id]++] = stp;
-    } RT_VISIT_ALL_SOLTABS_END;
+    rt_sol_by_type_build(rtip);
     if (RT_G_DEBUG & (RT_DEBUG_DB|RT_DEBUG_SOLIDS)) {
 	bu_log("rt_prep_parallel(%s, %d) printing number of primitives by type\n",
 	       rtip->rti_dbip->dbi_filename,
@@ -444,6 +470,9 @@ rt_prep_parallel(struct rt_i *rtip, int ncpu)
 	    (void)fclose(plotfp);
 	}
     }
+    /* Flatten the region trees for rt_boolfinal() */
+    rt_bool_compile(rtip);
+
     rtip->needprep = 0;		/* prep is done */
     bu_semaphore_release(RT_SEM_RESULTS);	/* end critical section */
 
@@ -796,7 +825,7 @@ rt_plot_solid(
 {
     struct bu_list vhead;
     struct region *regp;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     RT_CK_RTI(rtip);
     RT_CK_SOLTAB(stp);
@@ -883,6 +912,9 @@ rt_init_resource(struct resource *resp, int cpu_num, struct rt_i *rtip)
     if (!BU_LIST_IS_INITIALIZED(&resp->re_parthead))
 	BU_LIST_INIT(&resp->re_parthead);
 
+    if (!BU_LIST_IS_INITIALIZED(&resp->re_part_blocks.l))
+	bu_ptbl_init(&resp->re_part_blocks, 64, "re_part_blocks ptbl");
+
     if (!BU_LIST_IS_INITIALIZED(&resp->re_solid_bitv))
 	BU_LIST_INIT(&resp->re_solid_bitv);
 
@@ -897,6 +929,12 @@ rt_init_resource(struct resource *resp, int cpu_num, struct rt_i *rtip)
     resp->re_boolstack = NULL;
     resp->re_boolslen = 0;
 
+    resp->re_ptidx = NULL;
+    resp->re_ptidx_len = resp->re_ptidx_max = 0;
+    resp->re_boolmark = NULL;
+    resp->re_boolmark_len = 0;
+    resp->re_boolstamp = 0;
+
     resp->re_cpu = cpu_num;
     resp->re_magic = RESOURCE_MAGIC;
 
@@ -959,17 +997,30 @@ rt_clean_resource_basic(struct rt_i *rtip, struct resource *resp)
 	re_nmgfree.forw = BU_LIST_NULL;
     }
 
-    /* The 'struct partition' guys are individually malloc()ed */
-    if (BU_LIST_IS_INITIALIZED(&resp->re_parthead)) {
-	struct partition *pp;
-	while (BU_LIST_WHILE(pp, partition, &resp->re_parthead)) {
-	    RT_CK_PT(pp);
-	    BU_LIST_DEQUEUE((struct bu_list *)pp);
-	    bu_ptbl_free(&pp->pt_seglist);
-	    bu_free((void *)pp, "struct partition");
+    /* The 'struct partition' guys are malloc()ed in blocks too, see
+     * rt_alloc_pt_block().
+     */
+    resp->re_parthead.forw = BU_LIST_NULL;
+    if (BU_LIST_IS_INITIALIZED(&resp->re_part_blocks.l)) {
+	struct partition **ppp;
+	size_t nper = bu_malloc_len_roundup(64*sizeof(struct partition)) / sizeof(struct partition);
+	BU_CK_PTBL(&resp->re_part_blocks);
+	for (BU_PTBL_FOR(ppp, (struct partition **), &resp->re_part_blocks)) {
+	    struct partition *pp = *ppp;
+	    for (size_t i = 0; i < nper; i++) {
+		RT_CK_PT(&pp[i]);
+		bu_ptbl_free(&pp[i].pt_seglist);
+	    }
+	    bu_free((void *)pp, "struct partition block");
 	}
-	resp->re_parthead.forw = BU_LIST_NULL;
+	bu_ptbl_free(&resp->re_part_blocks);
+	resp->re_part_blocks.l.forw = BU_LIST_NULL;
+    }
+    if (resp->re_ptidx) {
+	bu_free((void *)resp->re_ptidx, "re_ptidx");
+	resp->re_ptidx = NULL;
     }
+    resp->re_ptidx_len = resp->re_ptidx_max = 0;
 
     /* The 'struct bu_bitv' guys on re_solid_bitv are individually malloc()ed */
     if (BU_LIST_IS_INITIALIZED(&resp->re_solid_bitv)) {
@@ -1007,6 +1058,13 @@ rt_clean_resource_basic(struct rt_i *rtip, struct resource *resp)
 	}
     }
 
+    /* 're_boolmark' is a simple pointer too */
+    if (resp->re_boolmark) {
+	bu_free((void *)resp->re_boolmark, "re_boolmark");
+	resp->re_boolmark = NULL;
+    }
+    resp->re_boolmark_len = 0;
+
     /* 're_boolstack' is a simple pointer */
     if (resp->re_boolstack) {
 	bu_free((void *)resp->re_boolstack, "boolstack");
@@ -1176,6 +1234,8 @@ rt_clean(struct rt_i *rtip)
     }
     rtip->nsolids = 0;
 
+    rt_bool_free(rtip);
+
     /* Clean out the array of pointers to regions, if any */
     if (rtip->Regions) {
 	bu_free((char *)rtip->Regions, "rtip->Regions[]");
@@ -1677,6 +1737,7 @@ unprep_leaf(struct db_tree_state *tsp,
 		    /* soltab structure will actually be freed */
 		    remove_from_bsp(stp, &rtip->rti_inf_box, &rtip->rti_tol);
 		    remove_from_bsp(stp, &rtip->rti_CutHead, &rtip->rti_tol);
+		    cut_bvh_remove(rtip, stp);
 		    rtip->rti_Solids[bit] = (struct soltab *)NULL;
 		}
 		rt_free_soltab(stp);
@@ -1690,6 +1751,98 @@ unprep_leaf(struct db_tree_state *tsp,
 }
 
 
+/**
+ * Close the gaps left in rtip->Regions[] and rtip->rti_Solids[] by
+ * unprepped regions and solids, renumbering the ones that remain.
+ */
+static void
+unprep_compact(struct rt_i *rtip, struct rt_reprep_obj_list *objs)
+{
+    size_t i, j;
+
+    /* eliminate NULL region structures */
+    objs->old_nregions = rtip->nregions;
+    i = 0;
+    while (i < rtip->nregions) {
+	int nulls=0;
+
+	while (i < rtip->nregions && !rtip->Regions[i]) {
+	    i++;
+	    nulls++;
+	}
+
+	if (nulls) {
+	    rtip->nregions -= nulls;
+	    for (j=i-nulls; j<rtip->nregions; j++) {
+		rtip->Regions[j] = rtip->Regions[j+nulls];
+		if (rtip->Regions[j]) {
+		    rtip->Regions[j]->reg_bit = j;
+		}
+	    }
+	    i -= nulls;
+	} else {
+	    i++;
+	}
+    }
+
+    /* eliminate NULL soltabs */
+    objs->old_nsolids = rtip->nsolids;
+    objs->nsolids_unprepped = 0;
+    i = 0;
+    while (i < rtip->nsolids) {
+	int nulls=0;
+
+	while (i < rtip->nsolids && !rtip->rti_Solids[i]) {
+	    objs->nsolids_unprepped++;
+	    i++;
+	    nulls++;
+	}
+	if (nulls) {
+	    for (j=i-nulls; j+nulls<rtip->nsolids; j++) {
+		rtip->rti_Solids[j] = rtip->rti_Solids[j+nulls];
+		if (rtip->rti_Solids[j]) {
+		    rtip->rti_Solids[j]->st_bit = j;
+		}
+	    }
+	    rtip->nsolids -= nulls;
+	    i -= nulls;
+	} else {
+	    i++;
+	}
+    }
+}
+
+
+/**
+ * Release the solid pieces state of every resource that
+ * reprep_paths() will initialize again.
+ */
+static void
+res_pieces_clean_all(struct rt_i *rtip, struct resource *resp)
+{
+    size_t i;
+    size_t npieces = rtip->rti_nsolids_with_pieces;
+
+    /* rt_res_pieces_clean() zeroes the count, which it needs to walk
+     * each resource's table.
+     */
+    for (i = 0; i < BU_PTBL_LEN(&rtip->rti_resources); i++) {
+	struct resource *re = (struct resource *)BU_PTBL_GET(&rtip->rti_resources, i);
+	if (!re || re == resp)
+	    continue;
+	rtip->rti_nsolids_with_pieces = npieces;
+	rt_res_pieces_clean(re, rtip);
+    }
+    if (!BU_PTBL_LEN(&rtip->rti_resources) && resp != &rt_uniresource) {
+	rtip->rti_nsolids_with_pieces = npieces;
+	rt_res_pieces_clean(&rt_uniresource, rtip);
+    }
+
+    rtip->rti_nsolids_with_pieces = npieces;
+    rt_res_pieces_clean(resp, rtip);
+}
+
+
 /**
  * This routine "unpreps" the list of object names that appears in the
  * "unprepped" list of the "objs" structure.
@@ -1701,7 +1854,10 @@ rt_unprep(struct rt_i *rtip, struct rt_reprep_obj_list *objs, struct resource *r
     struct db_full_path *path;
     size_t i, j, k;
 
-    rt_res_pieces_clean(resp, rtip);
+    res_pieces_clean_all(rtip, resp);
+
+    /* Region and solid bits are about to be renumbered */
+    rt_bool_free(rtip);
 
     /* find all paths from top objects to objects being unprepped */
     bu_ptbl_init(&objs->paths, 5, "paths");
@@ -1841,67 +1997,19 @@ rt_unprep(struct rt_i *rtip, struct rt_reprep_obj_list *objs, struct resource *r
 	bu_free((void *)rp, "struct region");
     }
 
-    /* eliminate NULL region structures */
-    objs->old_nregions = rtip->nregions;
-    i = 0;
-    while (i < rtip->nregions) {
-	int nulls=0;
-
-	while (i < rtip->nregions && !rtip->Regions[i]) {
-	    i++;
-	    nulls++;
-	}
-
-	if (nulls) {
-	    rtip->nregions -= nulls;
-	    for (j=i-nulls; j<rtip->nregions; j++) {
-		rtip->Regions[j] = rtip->Regions[j+nulls];
-		if (rtip->Regions[j]) {
-		    rtip->Regions[j]->reg_bit = j;
-		}
-	    }
-	} else {
-	    i++;
-	}
-    }
-
-    /* eliminate NULL soltabs */
-    objs->old_nsolids = rtip->nsolids;
-    objs->nsolids_unprepped = 0;
-    i = 0;
-    while (i < rtip->nsolids) {
-	int nulls=0;
-
-	while (i < rtip->nsolids && !rtip->rti_Solids[i]) {
-	    objs->nsolids_unprepped++;
-	    i++;
-	    nulls++;
-	}
-	if (nulls) {
-	    for (j=i-nulls; j+nulls<rtip->nsolids; j++) {
-		rtip->rti_Solids[j] = rtip->rti_Solids[j+nulls];
-		if (rtip->rti_Solids[j]) {
-		    rtip->rti_Solids[j]->st_bit = j;
-		}
-	    }
-	    rtip->nsolids -= nulls;
-	    i -= nulls;
-	} else {
-	    i++;
-	}
-    }
+    unprep_compact(rtip, objs);
 
     return 0;
 }
 
 
 /**
- * This routine "re-preps" the list of objects specified in the
- * "unprepped" list of the "objs" structure. This structure must
- * previously have been passed to "rt_unprep"
+ * Walk the paths of objs again and prep what they hold, with ncpu
+ * threads, updating the region and solid tables and the space
+ * partition of an already prepped rt_i.
  */
-int
-rt_reprep(struct rt_i *rtip, struct rt_reprep_obj_list *objs, struct resource *resp)
+static int
+reprep_paths(struct rt_i *rtip, struct rt_reprep_obj_list *objs, size_t ncpu, struct resource *resp)
 {
     size_t i;
     char **argv;
@@ -1922,7 +2030,7 @@ rt_reprep(struct rt_i *rtip, struct rt_reprep_obj_list *objs, struct resource *r
 
     rtip->rti_add_to_new_solids_list = 1;
     bu_ptbl_init(&rtip->rti_new_solids, 128, "rti_new_solids");
-    if (rt_gettrees(rtip, BU_PTBL_LEN(&(objs->paths)), (const char **)argv, 1)) {
+    if (rt_gettrees(rtip, BU_PTBL_LEN(&(objs->paths)), (const char **)argv, ncpu)) {
 	return 1;
     }
     rtip->rti_add_to_new_solids_list = 0;
@@ -1958,6 +2066,7 @@ rt_reprep(struct rt_i *rtip, struct rt_reprep_obj_list *objs, struct resource *r
 		VMINMAX(rtip->mdl_min, rtip->mdl_max, region_min);
 		VMINMAX(rtip->mdl_min, rtip->mdl_max, region_max);
 	    }
+	    rt_optim_tree(rp->reg_treetop, resp);
 	    rt_solid_bitfinder(rp->reg_treetop, rp, resp);
 	}
 	bitno++;
@@ -1978,6 +2087,8 @@ rt_reprep(struct rt_i *rtip, struct rt_reprep_obj_list *objs, struct resource *r
 
     } RT_VISIT_ALL_SOLTABS_END;
 
+    rt_sol_by_type_build(rtip);
+
     for (i=0; i<BU_PTBL_LEN(&rtip->rti_new_solids); i++) {
 	stp = (struct soltab *)BU_PTBL_GET(&rtip->rti_new_solids, i);
 	if (stp->st_aradius >= INFINITY) {
@@ -1987,8 +2098,6 @@ rt_reprep(struct rt_i *rtip, struct rt_reprep_obj_list *objs, struct resource *r
 	}
     }
 
-    bu_ptbl_free(&rtip->rti_new_solids);
-
     if (!VNEAR_EQUAL(rtip->mdl_min, old_min, SMALL_FASTF)
 	|| !VNEAR_EQUAL(rtip->mdl_max, old_max, SMALL_FASTF))
     {
@@ -2000,6 +2109,17 @@ rt_reprep(struct rt_i *rtip, struct rt_reprep_obj_list *objs, struct resource *r
 	fill_out_bsp(rtip, &rtip->rti_CutHead, resp, bb);
     }
 
+    /* Refit the BVH around the new solids, rebuilding it only when
+     * they do not fit or have loosened it too much.
+     */
+    if (rtip->rti_space_partition == RT_PART_HLBVH
+	&& cut_bvh_refit(rtip, &rtip->rti_new_solids) < 0)
+	cut_bvh_build(rtip);
+
+    bu_ptbl_free(&rtip->rti_new_solids);
+
+    rt_bool_compile(rtip);
+
     if (BU_PTBL_LEN(&rtip->rti_resources)) {
 	for (i=0; i<BU_PTBL_LEN(&rtip->rti_resources); i++) {
 	    struct resource *re;
@@ -2016,6 +2136,239 @@ rt_reprep(struct rt_i *rtip, struct rt_reprep_obj_list *objs, struct resource *r
 }
 
 
+/**
+ * This routine "re-preps" the list of objects specified in the
+ * "unprepped" list of the "objs" structure. This structure must
+ * previously have been passed to "rt_unprep"
+ */
+int
+rt_reprep(struct rt_i *rtip, struct rt_reprep_obj_list *objs, struct resource *resp)
+{
+    return reprep_paths(rtip, objs, 1, resp);
+}
+
+
+/**
+ * Drop the solids of a region being unprepped, taking the ones that
+ * are about to be freed out of the space partition.  Leaves become
+ * OP_NOP so the tree itself can then be freed.
+ */
+static void
+unprep_region_tree(struct rt_i *rtip, union tree *tp, struct region *regp)
+{
+    struct soltab *stp;
+
+    switch (tp->tr_op) {
+	case OP_SOLID:
+	    stp = tp->tr_a.tu_stp;
+	    RT_CK_SOLTAB(stp);
+	    bu_ptbl_rm(&stp->st_regions, (long *)regp);
+	    if (stp->st_uses <= 1) {
+		/* soltab structure will actually be freed */
+		remove_from_bsp(stp, &rtip->rti_inf_box, &rtip->rti_tol);
+		remove_from_bsp(stp, &rtip->rti_CutHead, &rtip->rti_tol);
+		cut_bvh_remove(rtip, stp);
+		rtip->rti_Solids[stp->st_bit] = (struct soltab *)NULL;
+	    }
+	    rt_free_soltab(stp);
+	    tp->tr_op = OP_NOP;
+	    break;
+	case OP_UNION:
+	case OP_INTERSECT:
+	case OP_SUBTRACT:
+	case OP_XOR:
+	    unprep_region_tree(rtip, tp->tr_b.tb_right, regp);
+	    /* fall through */
+	case OP_NOT:
+	case OP_GUARD:
+	case OP_XNOP:
+	    unprep_region_tree(rtip, tp->tr_b.tb_left, regp);
+	    break;
+	default:
+	    break;
+    }
+}
+
+
+/**
+ * Returns 1 if dp is referenced anywhere below the combination top,
+ * using and filling memo (combination -> answer) for the same dp.
+ */
+static int
+anim_dir_below(struct db_i *dbip, struct directory *top, struct directory *dp, struct resource *resp, std::unordered_map<struct directory *, int> &memo);
+
+static int
+anim_tree_has_dir(struct db_i *dbip, const union tree *tp, struct directory *dp, struct resource *resp, std::unordered_map<struct directory *, int> &memo)
+{
+    struct directory *mdp;
+
+    if (!tp)
+	return 0;
+
+    switch (tp->tr_op) {
+	case OP_DB_LEAF:
+	    mdp = db_lookup(dbip, tp->tr_l.tl_name, LOOKUP_QUIET);
+	    if (mdp == RT_DIR_NULL)
+		return 0;
+	    return mdp == dp || anim_dir_below(dbip, mdp, dp, resp, memo);
+	case OP_UNION:
+	case OP_INTERSECT:
+	case OP_SUBTRACT:
+	case OP_XOR:
+	    if (anim_tree_has_dir(dbip, tp->tr_b.tb_left, dp, resp, memo))
+		return 1;
+	    return anim_tree_has_dir(dbip, tp->tr_b.tb_right, dp, resp, memo);
+	case OP_NOT:
+	case OP_GUARD:
+	case OP_XNOP:
+	    return anim_tree_has_dir(dbip, tp->tr_b.tb_left, dp, resp, memo);
+	default:
+	    return 0;
+    }
+}
+
+static int
+anim_dir_below(struct db_i *dbip, struct directory *top, struct directory *dp, struct resource *resp, std::unordered_map<struct directory *, int> &memo)
+{
+    struct rt_db_internal intern;
+    struct rt_comb_internal *comb;
+    int found;
+
+    if (!(top->d_flags & RT_DIR_COMB))
+	return 0;
+
+    std::unordered_map<struct directory *, int>::iterator it = memo.find(top);
+    if (it != memo.end())
+	return it->second;
+    memo[top] = 0;		/* guards against cyclic references */
+
+    if (rt_db_get_internal(&intern, top, dbip, NULL, resp) < 0)
+	return 0;
+    comb = (struct rt_comb_internal *)intern.idb_ptr;
+    RT_CK_COMB(comb);
+    found = anim_tree_has_dir(dbip, comb->tree, dp, resp, memo);
+    rt_db_free_internal(&intern);
+
+    memo[top] = found;
+    return found;
+}
+
+
+int
+rt_reprep_anim(struct rt_i *rtip, const struct bu_ptbl *anims, size_t ncpu, struct resource *resp)
+{
+    struct rt_reprep_obj_list objs;
+    std::unordered_map<struct directory *, std::unordered_map<struct directory *, int> > below;
+    struct db_full_path *path;
+    struct region *rp;
+    size_t i, nregions;
+    int ret;
+
+    RT_CK_RTI(rtip);
+    RT_CK_RESOURCE(resp);
+    BU_CK_PTBL(anims);
+
+    if (rtip->needprep || !rtip->Regions)
+	return -1;
+    if (!BU_PTBL_LEN(anims))
+	return 0;
+
+    memset(&objs, 0, sizeof(objs));
+    bu_ptbl_init(&objs.paths, 8, "paths");
+    bu_ptbl_init(&objs.unprep_regions, 8, "unprep_regions");
+
+    /* Find the regions with a changed animation on their path, or
+     * on an arc inside them.
+     */
+    ret = 0;
+    for (BU_LIST_FOR(rp, region, &(rtip->HeadRegion))) {
+	struct directory *rdp;
+	int hit = 0;
+
+	BU_ALLOC(path, struct db_full_path);
+	db_full_path_init(path);
+	if (db_string_to_path(path, rtip->rti_dbip, rp->reg_name) || path->fp_len < 1) {
+	    /* can't be walked again on its own */
+	    db_free_full_path(path);
+	    bu_free(path, "path");
+	    ret = -1;
+	    break;
+	}
+	rdp = DB_FULL_PATH_CUR_DIR(path);
+
+	for (i = 0; i < BU_PTBL_LEN(anims) && !hit; i++) {
+	    struct animate *anp = (struct animate *)BU_PTBL_GET(anims, i);
+	    struct directory *adp = DB_FULL_PATH_CUR_DIR(&anp->an_path);
+
+	    RT_CK_ANIMATE(anp);
+	    if (!adp) {
+		/* rooted animations move everything */
+		ret = -1;
+		break;
+	    }
+	    hit = db_anim_on_path(anp, path)
+		|| anim_dir_below(rtip->rti_dbip, rdp, adp, resp, below[adp]);
+	}
+
+	if (ret < 0 || !hit) {
+	    db_free_full_path(path);
+	    bu_free(path, "path");
+	    if (ret < 0)
+		break;
+	    continue;
+	}
+	bu_ptbl_ins(&objs.paths, (long *)path);
+	bu_ptbl_ins(&objs.unprep_regions, (long *)rp);
+    }
+
+    nregions = BU_PTBL_LEN(&objs.unprep_regions);
+    if (ret < 0 || !nregions)
+	goto done;
+
+    res_pieces_clean_all(rtip, resp);
+
+    /* Region and solid bits are about to be renumbered */
+    rt_bool_free(rtip);
+
+    /* Release the regions, their trees and the solids only they use */
+    for (i = 0; i < nregions; i++) {
+	rp = (struct region *)BU_PTBL_GET(&objs.unprep_regions, i);
+	BU_LIST_DEQUEUE(&rp->l);
+	rtip->Regions[rp->reg_bit] = (struct region *)NULL;
+
+	unprep_region_tree(rtip, rp->reg_treetop, rp);
+	db_free_tree(rp->reg_treetop, resp);
+	rp->reg_treetop = TREE_NULL;
+	bu_free((void *)rp->reg_name, "region name str");
+	rp->reg_name = (char *)0;
+	if (rp->reg_mater.ma_shader) {
+	    bu_free((void *)rp->reg_mater.ma_shader, "ma_shader");
+	    rp->reg_mater.ma_shader = (char *)NULL;
+	}
+	bu_avs_free(&(rp->attr_values));
+	bu_free((void *)rp, "struct region");
+    }
+    objs.nregions_unprepped = nregions;
+    unprep_compact(rtip, &objs);
+
+    if (reprep_paths(rtip, &objs, ncpu, resp))
+	ret = -1;
+    else
+	ret = (int)nregions;
+
+done:
+    for (i = 0; i < BU_PTBL_LEN(&objs.paths); i++) {
+	path = (struct db_full_path *)BU_PTBL_GET(&objs.paths, i);
+	db_free_full_path(path);
+	bu_free(path, "path");
+    }
+    bu_ptbl_free(&objs.paths);
+    bu_ptbl_free(&objs.unprep_regions);
+
+    return ret;
+}
+
+
 /** @} */
 
 
@@ -839,7 +839,7 @@ rt_annot_plot(struct bu_list *vhead, struct rt_db_internal *ip, const struct bg_
     struct rt_annot_internal *annot_ip;
     int ret;
     int myret=0;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
@@ -1185,9 +1185,11 @@ rt_arb_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 }
 
 
-#define RT_ARB8_SEG_MISS(SEG)	(SEG).seg_stp=RT_SOLTAB_NULL
 /**
- * This is the Becker vector version
+ * Vectorized version of rt_arb_shot().  The faces are visited in the
+ * same (descending) order as the scalar routine, each one against a
+ * whole block of ray/arb pairs, with the slab state of every pair kept
+ * in flat arrays.  A pair drops out as soon as it is known to miss.
  */
 void
 rt_arb_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struct application *ap)
@@ -1197,77 +1199,108 @@ rt_arb_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, str
 /* Number of ray/object pairs */
 
 {
-    register int j, i;
-    register struct arb_specific *arbp;
-    fastf_t dn;		/* Direction dot Normal */
-    fastf_t dxbdn;
-    fastf_t s;
+    fastf_t in[RT_VSHOT_BLOCK], out[RT_VSHOT_BLOCK];	/* ray in/out distances */
+    int iplane[RT_VSHOT_BLOCK], oplane[RT_VSHOT_BLOCK];
+    int nmfaces[RT_VSHOT_BLOCK];	/* 0 once the pair has missed */
+    int base, m, i, j;
 
-    if (ap) RT_CK_APPLICATION(ap);
+    if (!stp || !rp || !segp || !ap)
+	return;
+    RT_CK_APPLICATION(ap);
 
-    /* Initialize return values */
-    for (i = 0; i < n; i++) {
-	segp[i].seg_stp = stp[i];	/* Assume hit, if 0 then miss */
-	segp[i].seg_in.hit_dist = -INFINITY;    /* used as in */
-	segp[i].seg_in.hit_surfno = -1;		/* used as iplane */
-	segp[i].seg_out.hit_dist = INFINITY;    /* used as out */
-	segp[i].seg_out.hit_surfno = -1;	/* used as oplane */
-/* segp[i].seg_next = SEG_NULL;*/
-    }
+    if (RT_G_DEBUG & RT_DEBUG_ARB8) {
+	/* keep the per-face diagnostics of the scalar routine */
+	struct seg seghead;
 
-    /* consider each face */
-    for (j = 0; j < 6; j++) {
-	/* for each ray/arb_face pair */
+	BU_LIST_INIT(&(seghead.l));
 	for (i = 0; i < n; i++) {
 	    if (stp[i] == 0) continue;	/* skip this ray */
-	    if (segp[i].seg_stp == 0) continue;	/* miss */
-
-	    arbp= (struct arb_specific *) stp[i]->st_specific;
-	    if (arbp->arb_nmfaces <= j)
-		continue; /* faces of this ARB are done */
-
-	    dxbdn = VDOT(arbp->arb_face[j].peqn, rp[i]->r_pt) -
-		arbp->arb_face[j].peqn[W];
-	    if ((dn = -VDOT(arbp->arb_face[j].peqn, rp[i]->r_dir)) < -SQRT_SMALL_FASTF) {
-		/* exit point, when dir.N < 0.  out = min(out, s) */
-		if (segp[i].seg_out.hit_dist > (s = dxbdn/dn)) {
-		    segp[i].seg_out.hit_dist = s;
-		    segp[i].seg_out.hit_surfno = j;
-		}
-	    } else if (dn > SQRT_SMALL_FASTF) {
-		/* entry point, when dir.N > 0.  in = max(in, s) */
-		if (segp[i].seg_in.hit_dist < (s = dxbdn/dn)) {
-		    segp[i].seg_in.hit_dist = s;
-		    segp[i].seg_in.hit_surfno = j;
-		}
-	    } else {
-		/* ray is parallel to plane when dir.N == 0.
-		 * If it is outside the solid, stop now */
-		if (dxbdn > SQRT_SMALL_FASTF) {
-		    RT_ARB8_SEG_MISS(segp[i]);		/* MISS */
+	    (void)rt_arb_shot(stp[i], rp[i], ap, &seghead);
+	    rt_vshot_store(&segp[i], &seghead, ap->a_resource);
+	}
+	return;
+    }
+
+    for (base = 0; base < n; base += RT_VSHOT_BLOCK) {
+	struct soltab **bstp = &stp[base];
+	struct xray **brp = &rp[base];
+	struct seg *bsegp = &segp[base];
+
+	m = n - base;
+	if (m > RT_VSHOT_BLOCK)
+	    m = RT_VSHOT_BLOCK;
+
+	for (i = 0; i < m; i++) {
+	    in[i] = -INFINITY;
+	    out[i] = INFINITY;
+	    iplane[i] = oplane[i] = -1;
+	    if (bstp[i] == 0)
+		nmfaces[i] = 0;	/* skip this ray */
+	    else
+		nmfaces[i] = ((struct arb_specific *)bstp[i]->st_specific)->arb_nmfaces;
+	}
+
+	/* consider each face, for each ray/arb pair */
+	for (j = 5; j >= 0; j--) {
+	    for (i = 0; i < m; i++) {
+		const struct aface *afp;
+		fastf_t dn;		/* Direction dot Normal */
+		fastf_t dxbdn;
+		fastf_t s;
+
+		if (nmfaces[i] <= j)
+		    continue;	/* missed, or face not present */
+
+		afp = &((struct arb_specific *)bstp[i]->st_specific)->arb_face[j];
+		dxbdn = VDOT(afp->peqn, brp[i]->r_pt) - afp->peqn[W];
+		dn = -VDOT(afp->peqn, brp[i]->r_dir);
+
+		if (dn < -SQRT_SMALL_FASTF) {
+		    /* exit point, when dir.N < 0.  out = min(out, s) */
+		    if (out[i] > (s = dxbdn/dn)) {
+			out[i] = s;
+			oplane[i] = j;
+		    }
+		} else if (dn > SQRT_SMALL_FASTF) {
+		    /* entry point, when dir.N > 0.  in = max(in, s) */
+		    if (in[i] < (s = dxbdn/dn)) {
+			in[i] = s;
+			iplane[i] = j;
+		    }
+		} else if (dxbdn > SQRT_SMALL_FASTF) {
+		    /* ray is parallel to plane and outside the solid */
+		    nmfaces[i] = 0;	/* MISS */
 		}
+		if (in[i] > out[i])
+		    nmfaces[i] = 0;	/* MISS */
 	    }
-	    if (segp[i].seg_in.hit_dist > segp[i].seg_out.hit_dist) {
-		RT_ARB8_SEG_MISS(segp[i]);		/* MISS */
-	    }
-	} /* for each ray/arb_face pair */
-    } /* for each arb_face */
+	}
 
-    /*
-     * Validate for each ray/arb_face pair
-     * Segment was initialized as "good" (seg_stp set valid);
-     * that is revoked here on misses.
-     */
-    for (i = 0; i < n; i++) {
-	if (stp[i] == 0) continue;		/* skip this ray */
-	if (segp[i].seg_stp == 0) continue;	/* missed */
-
-	if (segp[i].seg_in.hit_surfno == -1 ||
-	    segp[i].seg_out.hit_surfno == -1) {
-	    RT_ARB8_SEG_MISS(segp[i]);		/* MISS */
-	} else if (segp[i].seg_in.hit_dist >= segp[i].seg_out.hit_dist ||
-		   segp[i].seg_out.hit_dist >= INFINITY) {
-	    RT_ARB8_SEG_MISS(segp[i]);		/* MISS */
+	/* Validate */
+	for (i = 0; i < m; i++) {
+	    if (bstp[i] == 0)
+		continue;	/* skip this ray */
+	    bsegp[i].seg_stp = RT_SOLTAB_NULL;
+	    if (nmfaces[i] == 0)
+		continue;	/* MISS */
+
+	    if (iplane[i] == -1 || oplane[i] == -1) {
+		const char *name = NULL;
+		if (bstp[i]->st_dp && bstp[i]->st_name)
+		    name = bstp[i]->st_name;
+		else
+		    name = "_unnamed_";
+		bu_log("rt_arb_shoot(%s): 1 hit => MISS\n", name);
+		continue;	/* MISS */
+	    }
+	    if (in[i] >= out[i] || out[i] >= INFINITY)
+		continue;	/* MISS */
+
+	    bsegp[i].seg_stp = bstp[i];
+	    bsegp[i].seg_in.hit_dist = in[i];
+	    bsegp[i].seg_in.hit_surfno = iplane[i];
+	    bsegp[i].seg_out.hit_dist = out[i];
+	    bsegp[i].seg_out.hit_surfno = oplane[i];
 	}
     }
 }
@@ -1423,7 +1456,7 @@ rt_arb_plot(struct bu_list *vhead, struct rt_db_internal *ip, const struct bg_te
 {
     point_t *pts;
     struct rt_arb_internal *aip;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
@@ -1780,7 +1813,7 @@ rt_arb_tess(struct nmgregion **r, struct model *m, struct rt_db_internal *ip, co
     struct faceuse *fu[6];
     struct vertex *verts[8];
     struct vertex **vertp[4];
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     RT_CK_DB_INTERNAL(ip);
     aip = (struct rt_arb_internal *)ip->idb_ptr;
@@ -1888,7 +1921,7 @@ rt_arb_tnurb(struct nmgregion **r, struct model *m, struct rt_db_internal *ip, c
     struct vertex **vertp[4];
     struct edgeuse *eu;
     struct loopuse *lu;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     RT_CK_DB_INTERNAL(ip);
     aip = (struct rt_arb_internal *)ip->idb_ptr;
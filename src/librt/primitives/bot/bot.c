@@ -39,11 +39,10 @@
 
 /* private implementation headers */
 #include "./bot_edge.h"
+#include "./bot_wide.h"
 #include "../../librt_private.h"
 #include "../../cut_hlbvh.h" /* for hlbvh functions */
 
-#define BOT_MIN_DN 1.0e-9
-#define HLBVH_STACK_SIZE 256
 #define RT_DEFAULT_MAX_PRIMS_IN_NODE 8
 
 #define BOT_UNORIENTED_NORM(_ap, _hitp, _norm, _out) {		    \
@@ -308,53 +307,100 @@ rt_bot_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
     return bg_trimesh_aabb(min, max, bot_ip->faces, bot_ip->num_faces, (const point_t *)bot_ip->vertices, bot_ip->num_vertices);
 }
 
-typedef struct _hit_da {
-    size_t count;
-    size_t capacity;
-    struct hit *items;
-} hit_da;
-
 const struct hit zeroed_hit_s = RT_HIT_INIT_ZERO;
 
-#define DA_INIT_CAPACITY 128
-
-// We include itemtype in DA_APPEND because
-// the options are:
-// 1. Get a -Wc++-compat warning
-// 2. Push a diagnostic that ignores that warning
-// 3. Do some sort of decltype shenanigans
-// 4. Pass in the type of the dynamic array
-
-// Append one item to a dynamic array
-// This supports the use case of appending a compile
-// time value to a dynamic array
-// Ex. DA_APPEND(da_ints, 42, int)
-#define DA_APPEND(da, item, itemtype)							\
-    do {										\
-	if ((da)->count >= (da)->capacity) {						\
-	    if ((da)->capacity == 0) {							\
-		(da)->items = (itemtype*)bu_calloc(DA_INIT_CAPACITY, sizeof(struct hit),\
-						   "DA calloc __FILE__: __LINE__" );	\
-		(da)->capacity = DA_INIT_CAPACITY;					\
-	    } else {                                                                    \
-		(da)->items = (itemtype*)bu_realloc((da)->items, 			\
-						    (da)->capacity*2*sizeof(struct hit),\
-						    "DA realloc __FILE__: __LINE__" );	\
-		(da)->capacity *= 2;							\
-	    }                                                                           \
-	    BU_ASSERT((da)->items != NULL);						\
-	}										\
-											\
-	(da)->items[(da)->count++] = (item); /* struct copy */				\
-    } while (0)
-
 struct spatial_partition_s {
     struct bvh_flat_node *root;
+    long nnodes;
+    struct bot_wide_bvh *wide; /* NULL unless the wide traversal is enabled */
     triangle_s *tris;
     fastf_t *vertex_normals; /* for deallocation, access normals
 				through triangle_s */
 };
 
+
+/**
+ * Copy the per-solid settings that rt_bot_shot() needs out of the
+ * internal form, leaving the spatial partition for the caller.
+ */
+static struct bot_specific *
+bot_prep_specific(struct soltab *stp, const struct rt_bot_internal *bot_ip)
+{
+    struct bot_specific *bot;
+
+    BU_GET(bot, struct bot_specific);
+    stp->st_specific = (void *)bot;
+    bot->bot_mode = bot_ip->mode;
+    bot->bot_orientation = bot_ip->orientation;
+    bot->bot_flags = bot_ip->bot_flags;
+    bot->bot_ntri = bot_ip->num_faces;
+
+    // set up thickness if requested
+    if (bot_ip->thickness) {
+	bot->bot_thickness = (fastf_t *)bu_calloc(bot_ip->num_faces, sizeof(fastf_t), "bot_thickness");
+	for (size_t bot_ip_index = 0; bot_ip_index < bot_ip->num_faces; bot_ip_index++)
+	    bot->bot_thickness[bot_ip_index] = bot_ip->thickness[bot_ip_index];
+    } else {
+	bot->bot_thickness = NULL;
+    }
+
+    // set up face_mode and facelist
+    if (bot_ip->face_mode) {
+	bot->bot_facemode = bu_bitv_dup(bot_ip->face_mode);
+    } else {
+	bot->bot_facemode = BU_BITV_NULL;
+    }
+    bot->bot_facelist = NULL;
+    bot->tie = NULL;
+
+    return bot;
+}
+
+
+/**
+ * Attach a finished spatial partition to the BoT and derive the
+ * solid's bounds from its root node.
+ */
+static void
+bot_prep_partition(struct soltab *stp, struct spatial_partition_s *sps, size_t ntri, const struct bn_tol *tolp)
+{
+    struct bot_specific *bot = (struct bot_specific *)stp->st_specific;
+
+    sps->wide = NULL;
+    if (bot_wide_enabled())
+	sps->wide = bot_wide_build(sps->root, sps->tris, ntri);
+
+    bot->tie = (void *)sps;
+
+    // struct bvh_build_node and struct bvh_flat_node are puns for fastf_t[6] which are the bounds
+    fastf_t *min = (fastf_t *)sps->root;
+    fastf_t *max = &min[3];
+
+    VMOVE(stp->st_min, min);
+    VMOVE(stp->st_max, max);
+
+    /* zero thickness will get missed by the raytracer */
+    BBOX_NONDEGEN(stp->st_min, stp->st_max, tolp->dist);
+
+    VADD2SCALE(stp->st_center, min, max, 0.5);
+    point_t dist_vec;
+    VSUB2SCALE(dist_vec, max, min, 0.5);
+    stp->st_aradius = FMAX(dist_vec[0], FMAX(dist_vec[1], dist_vec[2]));
+    stp->st_bradius = MAGNITUDE(dist_vec);
+}
+
+
+static size_t
+bot_max_prims_in_node(void)
+{
+    // look for a requested bundle size
+    size_t bot_max_prims_in_node = RT_DEFAULT_MAX_PRIMS_IN_NODE ;
+    const char *bmintie = getenv("LIBRT_BOT_MINTIE");
+    if (bmintie)
+	bot_max_prims_in_node = atoi(bmintie);
+    return bot_max_prims_in_node;
+}
+
 /**
  * Given a pointer to a GED database record, and a transformation
  * matrix, determine if this is a valid BOT, and if so, precompute
@@ -389,36 +435,9 @@ rt_bot_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 
     // Copy settings over to bot, because we won't have access to
     // bot_ip in the shot function
-    struct bot_specific *bot;
-    BU_GET(bot, struct bot_specific);
-    stp->st_specific = (void *)bot;
-    bot->bot_mode = bot_ip->mode;
-    bot->bot_orientation = bot_ip->orientation;
-    bot->bot_flags = bot_ip->bot_flags;
-    bot->bot_ntri = bot_ip->num_faces;
+    (void)bot_prep_specific(stp, bot_ip);
 
-    // set up thickness if requested
-    if (bot_ip->thickness) {
-	bot->bot_thickness = (fastf_t *)bu_calloc(bot_ip->num_faces, sizeof(fastf_t), "bot_thickness");
-	for (size_t bot_ip_index = 0; bot_ip_index < bot_ip->num_faces; bot_ip_index++)
-	    bot->bot_thickness[bot_ip_index] = bot_ip->thickness[bot_ip_index];
-    } else {
-	bot->bot_thickness = NULL;
-    }
-
-    // set up face_mode and facelist
-    if (bot_ip->face_mode) {
-	bot->bot_facemode = bu_bitv_dup(bot_ip->face_mode);
-    } else {
-	bot->bot_facemode = BU_BITV_NULL;
-    }
-    bot->bot_facelist = NULL;
-
-    // look for a requested bundle size
-    size_t bot_max_prims_in_node = RT_DEFAULT_MAX_PRIMS_IN_NODE ;
-    const char *bmintie = getenv("LIBRT_BOT_MINTIE");
-    if (bmintie)
-	bot_max_prims_in_node = atoi(bmintie);
+    size_t max_prims_in_node = bot_max_prims_in_node();
 
     // set up centroids and bounds for hlbvh call
     fastf_t *centroids = (fastf_t*)bu_malloc(bot_ip->num_faces * sizeof(fastf_t)*3, "bot centroids");
@@ -441,7 +460,7 @@ rt_bot_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     // implicit return values
     long nodes_created = 0;
     long *ordered_faces = NULL;
-    struct bvh_build_node *build_root = hlbvh_create(bot_max_prims_in_node, pool, centroids, bounds, &nodes_created,
+    struct bvh_build_node *build_root = hlbvh_create(max_prims_in_node, pool, centroids, bounds, &nodes_created,
 					       bot_ip->num_faces, &ordered_faces);
 
     bu_free(centroids, "bot centroids");
@@ -522,31 +541,168 @@ rt_bot_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     struct spatial_partition_s *sps;
     BU_GET(sps, struct spatial_partition_s);
     sps->root = flat_root;
+    sps->nnodes = nodes_created;
     sps->tris = tris;
     sps->vertex_normals = tri_norms;
+    bot_prep_partition(stp, sps, bot_ip->num_faces, tolp);
 
-    bot->tie = (void *)sps;
+#ifdef USE_OPENCL
+    clt_bot_prep(stp, bot_ip, rtip);
+#endif
+    return 0;
+}
 
-    // struct bvh_build_node and struct bvh_flat_node are puns for fastf_t[6] which are the bounds
-    fastf_t *min = (fastf_t *)sps->root;
-    fastf_t *max = &min[3];
 
-    VMOVE(stp->st_min, min);
-    VMOVE(stp->st_max, max);
+/**
+ * Save or restore the hierarchy and the reordered triangles built by
+ * rt_bot_prep(), which dominate prep time for large meshes.  The
+ * remaining per-solid settings are cheap and are taken from the
+ * internal form on load.
+ */
+int
+rt_bot_prep_serialize(struct soltab *stp, const struct rt_db_internal *ip, struct bu_external *external, size_t *version)
+{
+    const size_t current_version = 0;
+    struct rt_prep_stream s;
 
-    /* zero thickness will get missed by the raytracer */
-    BBOX_NONDEGEN(stp->st_min, stp->st_max, tolp->dist);
+    RT_CK_SOLTAB(stp);
+    RT_CK_DB_INTERNAL(ip);
+    BU_CK_EXTERNAL(external);
 
-    VADD2SCALE(stp->st_center, min, max, 0.5);
-    point_t dist_vec;
-    VSUB2SCALE(dist_vec, max, min, 0.5);
-    stp->st_aradius = FMAX(dist_vec[0], FMAX(dist_vec[1], dist_vec[2]));
-    stp->st_bradius = MAGNITUDE(dist_vec);
+    rt_prep_stream_init(&s, external);
+
+    if (stp->st_specific) {
+	/* export to external */
+	struct bot_specific *bot = (struct bot_specific *)stp->st_specific;
+	struct spatial_partition_s *sps = (struct spatial_partition_s *)bot->tie;
+
+	if (!sps || sps->nnodes <= 0 || bot->bot_ntri > UINT32_MAX || sps->nnodes > UINT32_MAX)
+	    return 1;
+
+	rt_prep_put_uint32(&s, (uint32_t)bot_max_prims_in_node());
+	rt_prep_put_uint32(&s, (uint32_t)bot->bot_ntri);
+	rt_prep_put_uint32(&s, (uint32_t)sps->nnodes);
+
+	for (long i = 0; i < sps->nnodes; i++) {
+	    const struct bvh_flat_node *node = &sps->root[i];
+	    rt_prep_put_fastf(&s, node->bounds, 6);
+	    rt_prep_put_uint32(&s, (uint32_t)node->n_primitives);
+	    if (node->n_primitives > 0)
+		rt_prep_put_uint32(&s, (uint32_t)node->data.first_prim_offset);
+	    else
+		rt_prep_put_uint32(&s, (uint32_t)(node->data.other_child - sps->root));
+	}
+
+	for (size_t i = 0; i < bot->bot_ntri; i++) {
+	    const triangle_s *tri = &sps->tris[i];
+	    rt_prep_put_fastf(&s, tri->A, 3);
+	    rt_prep_put_fastf(&s, tri->AB, 3);
+	    rt_prep_put_fastf(&s, tri->AC, 3);
+	    rt_prep_put_fastf(&s, tri->face_norm, 3);
+	    rt_prep_put_fastf(&s, &tri->face_norm_scalar, 1);
+	    rt_prep_put_uint32(&s, (uint32_t)tri->face_id);
+	    rt_prep_put_uint32(&s, tri->norms ? 1 : 0);
+	    if (tri->norms)
+		rt_prep_put_fastf(&s, tri->norms, 9);
+	}
+
+	rt_prep_stream_finish(&s);
+	*version = current_version;
+	return 0;
+    } else {
+	/* load from external */
+	const struct rt_bot_internal *bot_ip = (const struct rt_bot_internal *)ip->idb_ptr;
+	struct bn_tol defaults = BN_TOL_INIT_TOL;
+	const struct bn_tol *tolp = &defaults;
+	struct spatial_partition_s *sps;
+	size_t ntri, nnodes;
+	int has_norms = 0;
+
+	if (*version != current_version)
+	    return 1;
+
+	RT_BOT_CK_MAGIC(bot_ip);
+	if (!bot_ip->num_faces || !bot_ip->num_vertices)
+	    return 1;
+
+	/* the hierarchy depends on the leaf size it was built with */
+	if (rt_prep_get_uint32(&s) != bot_max_prims_in_node())
+	    return 1;
+	ntri = rt_prep_get_uint32(&s);
+	nnodes = rt_prep_get_uint32(&s);
+	if (s.err || ntri != bot_ip->num_faces || nnodes == 0)
+	    return 1;
+
+	BU_GET(sps, struct spatial_partition_s);
+	sps->nnodes = (long)nnodes;
+	sps->wide = NULL;
+	sps->root = (struct bvh_flat_node *)bu_malloc(nnodes * sizeof(struct bvh_flat_node), "bvh flat nodes");
+	sps->tris = (triangle_s *)bu_malloc(ntri * sizeof(triangle_s), "ordered triangles");
+	sps->vertex_normals = (fastf_t *)bu_malloc(ntri * 9 * sizeof(fastf_t), "bot norms");
+
+	for (size_t i = 0; i < nnodes && !s.err; i++) {
+	    struct bvh_flat_node *node = &sps->root[i];
+	    uint32_t idx;
+
+	    rt_prep_get_fastf(&s, node->bounds, 6);
+	    node->n_primitives = rt_prep_get_uint32(&s);
+	    idx = rt_prep_get_uint32(&s);
+	    if (node->n_primitives > 0) {
+		if ((size_t)idx + (size_t)node->n_primitives > ntri)
+		    s.err = 1;
+		node->data.first_prim_offset = idx;
+	    } else {
+		if (idx <= i || idx >= nnodes)
+		    s.err = 1;
+		node->data.other_child = &sps->root[idx];
+	    }
+	}
+
+	for (size_t i = 0; i < ntri && !s.err; i++) {
+	    triangle_s *tri = &sps->tris[i];
+
+	    rt_prep_get_fastf(&s, tri->A, 3);
+	    rt_prep_get_fastf(&s, tri->AB, 3);
+	    rt_prep_get_fastf(&s, tri->AC, 3);
+	    rt_prep_get_fastf(&s, tri->face_norm, 3);
+	    rt_prep_get_fastf(&s, &tri->face_norm_scalar, 1);
+	    tri->face_id = rt_prep_get_uint32(&s);
+	    if (tri->face_id >= ntri)
+		s.err = 1;
+	    tri->norms = NULL;
+	    if (rt_prep_get_uint32(&s)) {
+		tri->norms = &sps->vertex_normals[i*9];
+		rt_prep_get_fastf(&s, tri->norms, 9);
+		has_norms = 1;
+	    }
+	}
+
+	if (s.err) {
+	    bu_free(sps->root, "bvh flat nodes");
+	    bu_free(sps->tris, "ordered triangles");
+	    bu_free(sps->vertex_normals, "bot norms");
+	    BU_PUT(sps, struct spatial_partition_s);
+	    return 1;
+	}
+
+	if (!has_norms) {
+	    bu_free(sps->vertex_normals, "bot norms");
+	    sps->vertex_normals = NULL;
+	}
+
+	if (stp->st_rtip)
+	    tolp = &stp->st_rtip->rti_tol;
+	else
+	    rt_tol_default(&defaults);
+
+	(void)bot_prep_specific(stp, bot_ip);
+	bot_prep_partition(stp, sps, ntri, tolp);
 
 #ifdef USE_OPENCL
-    clt_bot_prep(stp, bot_ip, rtip);
+	clt_bot_prep(stp, (struct rt_bot_internal *)bot_ip, stp->st_rtip);
 #endif
-    return 0;
+	return 0;
+    }
 }
 
 
@@ -685,6 +841,42 @@ bot_shot_hlbvh_flat(struct bvh_flat_node *root, struct xray* rp, triangle_s *tri
 
 
 THREADLOCAL hit_da hits_per_cpu = {0};
+THREADLOCAL hit_da hits_per_packet[RT_PACKET_MAX] = {{0}};
+
+
+static fastf_t
+bot_shot_toldist(const struct soltab *stp, const struct bot_specific *bot)
+{
+    if (bot->bot_orientation != RT_BOT_UNORIENTED && bot->bot_mode == RT_BOT_SOLID) {
+	// approximate ULP-derived tolerance, scaled by the object size
+	// NOTE: the x10 is largely arbitrary, but serves to adjust the tolerance to a
+	// practical value
+	return DBL_EPSILON * stp->st_aradius * 10;
+    }
+    return 0.0;
+}
+
+
+/* insertion sort, hits are mostly in order already */
+static void
+bot_sort_hits(hit_da *hda)
+{
+    size_t nhits = hda->count;
+    struct hit *hits = hda->items;
+    for (size_t i = 1; i < nhits; i++) {
+	fastf_t i_dist = hits[i].hit_dist;
+	struct hit swap = hits[i];
+	int j;
+	for (j = i-1; j >= 0; j--) {
+	    fastf_t j_dist = hits[j].hit_dist;
+	    if (j_dist < i_dist) {
+		break;
+	    }
+	    hits[j+1] = hits[j];
+	}
+	hits[j+1] = swap;
+    }
+}
 
 
 /**
@@ -717,43 +909,63 @@ rt_bot_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 
     hits_per_cpu.count = 0; // New ray, new result count
 
-    fastf_t toldist = 0.0;
-    if (bot->bot_orientation != RT_BOT_UNORIENTED && bot->bot_mode == RT_BOT_SOLID) {
-	// approximate ULP-derived tolerance, scaled by the object size
-	// NOTE: the x10 is largely arbitrary, but serves to adjust the tolerance to a
-	// practical value
-	toldist = (DBL_EPSILON * stp->st_aradius * 10);
-    }
+    fastf_t toldist = bot_shot_toldist(stp, bot);
 
-    bot_shot_hlbvh_flat(sps->root, rp, sps->tris, bot->bot_ntri, &hits_per_cpu, toldist);
+    if (sps->wide)
+	bot_wide_shot(sps->wide, rp, sps->tris, &hits_per_cpu, toldist);
+    else
+	bot_shot_hlbvh_flat(sps->root, rp, sps->tris, bot->bot_ntri, &hits_per_cpu, toldist);
 
     if (hits_per_cpu.count == 0) {
 	return 0;
     }
-    // sort the hits
-    // insertion sort
-    {
-	size_t nhits = hits_per_cpu.count;
-	struct hit *hits = hits_per_cpu.items;
-	for (size_t i = 1; i < nhits; i++) {
-	    fastf_t i_dist = hits[i].hit_dist;
-	    struct hit swap = hits[i];
-	    int j;
-	    for (j = i-1; j >= 0; j--) {
-		fastf_t j_dist = hits[j].hit_dist;
-		if (j_dist < i_dist) {
-		    break;
-		}
-		hits[j+1] = hits[j];
-	    }
-	    hits[j+1] = swap;
-	}
-    }
+    bot_sort_hits(&hits_per_cpu);
 
     return rt_bot_makesegs(&hits_per_cpu, stp, rp, ap, seghead, NULL);
 }
 
 
+/**
+ * Intersect a packet of n rays with a bot, as n calls to rt_bot_shot()
+ * would, but walking the wide BVH once for the whole packet.  ret[i]
+ * receives the rt_bot_shot() return value for rp[i].
+ */
+void
+rt_bot_shot_packet(struct soltab *stp, int n, struct xray *rp[], struct application *ap[], struct seg *seghead[], int ret[])
+{
+    struct bot_specific *bot;
+    struct spatial_partition_s *sps;
+    fastf_t toldist;
+    int i;
+
+    if (UNLIKELY(!stp || n <= 0))
+	return;
+
+    bot = (struct bot_specific *)stp->st_specific;
+    sps = bot ? (struct spatial_partition_s *)bot->tie : NULL;
+    if (!sps || !sps->wide || n > RT_PACKET_MAX) {
+	for (i = 0; i < n; i++)
+	    ret[i] = rt_bot_shot(stp, rp[i], ap[i], seghead[i]);
+	return;
+    }
+
+    toldist = bot_shot_toldist(stp, bot);
+    for (i = 0; i < n; i++)
+	hits_per_packet[i].count = 0;
+
+    bot_wide_shot_packet(sps->wide, rp, n, sps->tris, hits_per_packet, toldist);
+
+    for (i = 0; i < n; i++) {
+	if (hits_per_packet[i].count == 0) {
+	    ret[i] = 0;
+	    continue;
+	}
+	bot_sort_hits(&hits_per_packet[i]);
+	ret[i] = rt_bot_makesegs(&hits_per_packet[i], stp, rp[i], ap[i], seghead[i], NULL);
+    }
+}
+
+
 /**
  * Given ONE ray distance, return the normal and entry/exit point.
  */
@@ -879,6 +1091,7 @@ rt_bot_free(struct soltab *stp)
 
     if (bot && bot->tie) {
 	struct spatial_partition_s *sps = (struct spatial_partition_s*)bot->tie;
+	bot_wide_free(sps->wide);
 	bu_free(sps->root, "bot bvh flat nodes");
 	bu_free(sps->tris, "bot triangles");
 	bu_free(sps->vertex_normals, "bot normals");
@@ -891,6 +1104,13 @@ rt_bot_free(struct soltab *stp)
 	hits_per_cpu.capacity = 0;
 	hits_per_cpu.items = NULL;
     }
+    for (int i = 0; i < RT_PACKET_MAX; i++) {
+	if (hits_per_packet[i].capacity) {
+	    bu_free(hits_per_packet[i].items, "DA free");
+	    hits_per_packet[i].capacity = 0;
+	    hits_per_packet[i].items = NULL;
+	}
+    }
 
     if (bot) {
 	BU_PUT(bot, struct bot_specific);
@@ -1557,7 +1777,7 @@ rt_bot_tess(struct nmgregion **r, struct model *m, struct rt_db_internal *ip, co
     struct shell *s;
     struct vertex **verts;
     size_t i;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     RT_CK_DB_INTERNAL(ip);
     bot_ip = (struct rt_bot_internal *)ip->idb_ptr;
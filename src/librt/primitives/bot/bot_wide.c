@@ -0,0 +1,586 @@
+/*                      B O T _ W I D E . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2024-2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @addtogroup primitives */
+/** @{ */
+/** @file primitives/bot/bot_wide.c
+ *
+ * Wide BVH traversal for BoT primitives.
+ *
+ * The binary HLBVH built by rt_bot_prep() is collapsed into nodes with
+ * four children each.  Child bounds are stored as single precision
+ * structure-of-arrays, rounded outward so that the float boxes always
+ * contain the double precision ones, and are tested against a ray
+ * four at a time.  Triangles of each leaf are packed in groups of four
+ * (double precision, structure-of-arrays) and intersected with the
+ * same arithmetic as the scalar test in bot.c, so the hits produced
+ * are the same.
+ *
+ * The vector code uses the GCC/Clang vector extensions, which lower to
+ * SSE/AVX on x86 and NEON on ARM.  Other compilers get the binary
+ * traversal only.
+ *
+ */
+
+#include "common.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bu/malloc.h"
+#include "bu/simd.h"
+#include "vmath.h"
+#include "raytrace.h"
+
+#include "./bot_wide.h"
+#include "../../cut_hlbvh.h"
+
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define BOT_WIDE_VECTOR 1
+#endif
+
+#define BOT_WIDE_N 4
+
+struct bot_wide_node {
+    float bmin[3][BOT_WIDE_N];
+    float bmax[3][BOT_WIDE_N];
+    int32_t child[BOT_WIDE_N];		/**< @brief wide node index, first packet index for leaves, -1 if unused */
+    int32_t npackets[BOT_WIDE_N];	/**< @brief number of triangle packets for leaves, 0 for interior children */
+};
+
+struct bot_wide_tri4 {
+    fastf_t A[3][BOT_WIDE_N];
+    fastf_t AB[3][BOT_WIDE_N];
+    fastf_t AC[3][BOT_WIDE_N];
+    fastf_t wn[3][BOT_WIDE_N];		/**< @brief non-unitized face normal */
+    long tri[BOT_WIDE_N];		/**< @brief index into the ordered triangles, -1 for padding */
+};
+
+struct bot_wide_bvh {
+    struct bot_wide_node *nodes;
+    size_t nnodes;
+    struct bot_wide_tri4 *packets;
+    size_t npackets;
+    fastf_t extent;			/**< @brief largest absolute bound coordinate */
+};
+
+
+int
+bot_wide_enabled(void)
+{
+#ifdef BOT_WIDE_VECTOR
+    const char *benv = getenv("LIBRT_BOT_WIDE");
+    if (benv && atoi(benv) == 0)
+	return 0;
+#  if defined(__aarch64__) || defined(_M_ARM64)
+    /* NEON is part of the base ARMv8 instruction set */
+    return 1;
+#  else
+    return bu_simd_supported(BU_SIMD_SSE2);
+#  endif
+#else
+    return 0;
+#endif
+}
+
+
+#ifdef BOT_WIDE_VECTOR
+
+typedef float bot_v4sf __attribute__((vector_size(16)));
+typedef int32_t bot_v4si __attribute__((vector_size(16)));
+typedef double bot_v4df __attribute__((vector_size(32)));
+typedef int64_t bot_v4di __attribute__((vector_size(32)));
+
+struct wide_builder {
+    struct bot_wide_node *nodes;
+    size_t nnodes;
+    size_t nodes_alloc;
+    struct bot_wide_tri4 *packets;
+    size_t npackets;
+    size_t packets_alloc;
+    const triangle_s *tris;
+    size_t ntris;
+};
+
+
+static fastf_t
+wide_half_area(const struct bvh_flat_node *n)
+{
+    fastf_t dx = n->bounds[3] - n->bounds[0];
+    fastf_t dy = n->bounds[4] - n->bounds[1];
+    fastf_t dz = n->bounds[5] - n->bounds[2];
+    return dx*dy + dy*dz + dz*dx;
+}
+
+
+/* float bounds that are guaranteed to contain the double ones */
+static float
+wide_float_down(fastf_t d)
+{
+    float f = (float)d;
+    if ((fastf_t)f > d)
+	f = nextafterf(f, -FLT_MAX);
+    return f;
+}
+
+
+static float
+wide_float_up(fastf_t d)
+{
+    float f = (float)d;
+    if ((fastf_t)f < d)
+	f = nextafterf(f, FLT_MAX);
+    return f;
+}
+
+
+static int32_t
+wide_pack_leaf(struct wide_builder *wb, const struct bvh_flat_node *leaf)
+{
+    size_t first = (size_t)leaf->data.first_prim_offset;
+    size_t end = first + (size_t)leaf->n_primitives;
+    size_t npk = (leaf->n_primitives + BOT_WIDE_N - 1) / BOT_WIDE_N;
+    int32_t ind = (int32_t)wb->npackets;
+
+    BU_ASSERT(end <= wb->ntris);
+
+    if (wb->npackets + npk > wb->packets_alloc) {
+	while (wb->npackets + npk > wb->packets_alloc)
+	    wb->packets_alloc *= 2;
+	wb->packets = (struct bot_wide_tri4 *)bu_realloc(wb->packets, wb->packets_alloc * sizeof(struct bot_wide_tri4), "bot wide packets");
+    }
+
+    for (size_t p = 0; p < npk; p++) {
+	struct bot_wide_tri4 *pk = &wb->packets[wb->npackets++];
+	memset(pk, 0, sizeof(struct bot_wide_tri4));
+	for (size_t k = 0; k < BOT_WIDE_N; k++) {
+	    size_t i = first + p * BOT_WIDE_N + k;
+	    if (i >= end) {
+		/* zero normal, rejected by the BOT_MIN_DN test */
+		pk->tri[k] = -1;
+		continue;
+	    }
+	    const triangle_s *tri = &wb->tris[i];
+	    vect_t wn;
+	    VSCALE(wn, tri->face_norm, tri->face_norm_scalar);
+	    for (int a = 0; a < 3; a++) {
+		pk->A[a][k] = tri->A[a];
+		pk->AB[a][k] = tri->AB[a];
+		pk->AC[a][k] = tri->AC[a];
+		pk->wn[a][k] = wn[a];
+	    }
+	    pk->tri[k] = (long)i;
+	}
+    }
+
+    return ind;
+}
+
+
+/*
+ * Build the wide node for the subtree rooted at bn, pulling up
+ * grandchildren (largest surface area first) until the node has
+ * BOT_WIDE_N children or only leaves remain.  Nodes are emitted in
+ * depth first order so the root is index zero.
+ */
+static int32_t
+wide_collapse(struct wide_builder *wb, const struct bvh_flat_node *bn)
+{
+    const struct bvh_flat_node *kids[BOT_WIDE_N];
+    int nkids = 0;
+
+    if (bn->n_primitives > 0) {
+	kids[nkids++] = bn;
+    } else {
+	kids[nkids++] = bn + 1;
+	kids[nkids++] = bn->data.other_child;
+	while (nkids < BOT_WIDE_N) {
+	    int best = -1;
+	    fastf_t best_area = -1.0;
+	    for (int k = 0; k < nkids; k++) {
+		if (kids[k]->n_primitives > 0)
+		    continue;
+		fastf_t area = wide_half_area(kids[k]);
+		if (area > best_area) {
+		    best_area = area;
+		    best = k;
+		}
+	    }
+	    if (best < 0)
+		break;
+	    const struct bvh_flat_node *expand = kids[best];
+	    kids[best] = expand + 1;
+	    kids[nkids++] = expand->data.other_child;
+	}
+    }
+
+    if (wb->nnodes >= wb->nodes_alloc) {
+	wb->nodes_alloc *= 2;
+	wb->nodes = (struct bot_wide_node *)bu_realloc(wb->nodes, wb->nodes_alloc * sizeof(struct bot_wide_node), "bot wide nodes");
+    }
+    int32_t ind = (int32_t)wb->nnodes++;
+
+    /* wb->nodes may move during recursion, so always index it */
+    for (int k = 0; k < BOT_WIDE_N; k++) {
+	struct bot_wide_node *wn = &wb->nodes[ind];
+	if (k >= nkids) {
+	    for (int a = 0; a < 3; a++) {
+		wn->bmin[a][k] = FLT_MAX;
+		wn->bmax[a][k] = -FLT_MAX;
+	    }
+	    wn->child[k] = -1;
+	    wn->npackets[k] = 0;
+	    continue;
+	}
+	for (int a = 0; a < 3; a++) {
+	    wn->bmin[a][k] = wide_float_down(kids[k]->bounds[a]);
+	    wn->bmax[a][k] = wide_float_up(kids[k]->bounds[a+3]);
+	}
+	if (kids[k]->n_primitives > 0) {
+	    int32_t first = wide_pack_leaf(wb, kids[k]);
+	    wn = &wb->nodes[ind];
+	    wn->child[k] = first;
+	    wn->npackets[k] = (int32_t)((kids[k]->n_primitives + BOT_WIDE_N - 1) / BOT_WIDE_N);
+	} else {
+	    int32_t child = wide_collapse(wb, kids[k]);
+	    wn = &wb->nodes[ind];
+	    wn->child[k] = child;
+	    wn->npackets[k] = 0;
+	}
+    }
+
+    return ind;
+}
+
+
+struct bot_wide_bvh *
+bot_wide_build(const struct bvh_flat_node *root, const triangle_s *tris, size_t ntris)
+{
+    struct wide_builder wb;
+    struct bot_wide_bvh *wbvh;
+
+    if (!root || !tris || !ntris)
+	return NULL;
+
+    wb.nodes_alloc = ntris / BOT_WIDE_N + 1;
+    wb.nodes = (struct bot_wide_node *)bu_malloc(wb.nodes_alloc * sizeof(struct bot_wide_node), "bot wide nodes");
+    wb.nnodes = 0;
+    wb.packets_alloc = ntris / BOT_WIDE_N + 1;
+    wb.packets = (struct bot_wide_tri4 *)bu_malloc(wb.packets_alloc * sizeof(struct bot_wide_tri4), "bot wide packets");
+    wb.npackets = 0;
+    wb.tris = tris;
+    wb.ntris = ntris;
+
+    (void)wide_collapse(&wb, root);
+
+    BU_GET(wbvh, struct bot_wide_bvh);
+    wbvh->nodes = (struct bot_wide_node *)bu_realloc(wb.nodes, wb.nnodes * sizeof(struct bot_wide_node), "bot wide nodes");
+    wbvh->nnodes = wb.nnodes;
+    wbvh->packets = (struct bot_wide_tri4 *)bu_realloc(wb.packets, wb.npackets * sizeof(struct bot_wide_tri4), "bot wide packets");
+    wbvh->npackets = wb.npackets;
+    wbvh->extent = 0.0;
+    for (int i = 0; i < 6; i++)
+	V_MAX(wbvh->extent, fabs(root->bounds[i]));
+
+    return wbvh;
+}
+
+
+static inline bot_v4sf
+v4sf_select(bot_v4si m, bot_v4sf a, bot_v4sf b)
+{
+    return (bot_v4sf)(((bot_v4si)a & m) | ((bot_v4si)b & ~m));
+}
+
+
+/* a macro rather than a function, passing 32 byte vectors by value
+ * changes the ABI depending on whether AVX is enabled */
+#define V4DF_SELECT(m, a, b) ((bot_v4df)(((bot_v4di)(a) & (m)) | ((bot_v4di)(b) & ~(m))))
+
+
+static inline void
+wide_shoot_packet(const struct bot_wide_tri4 *pk, struct xray *rp, triangle_s *tris, hit_da *hits, fastf_t toldist,
+		  const bot_v4df pt[3], const bot_v4df dir[3])
+{
+    bot_v4df A[3], AB[3], AC[3], wn[3];
+    memcpy(A, pk->A, sizeof(A));
+    memcpy(AB, pk->AB, sizeof(AB));
+    memcpy(AC, pk->AC, sizeof(AC));
+    memcpy(wn, pk->wn, sizeof(wn));
+
+    const bot_v4df zero = {0.0, 0.0, 0.0, 0.0};
+    const bot_v4df one = {1.0, 1.0, 1.0, 1.0};
+    const bot_v4df min_dn = {BOT_MIN_DN, BOT_MIN_DN, BOT_MIN_DN, BOT_MIN_DN};
+    const bot_v4df tol = {toldist, toldist, toldist, toldist};
+
+    /* same operations, in the same order, as bot_shot_hlbvh_flat() */
+    bot_v4df dn = wn[X]*dir[X] + wn[Y]*dir[Y] + wn[Z]*dir[Z];
+    bot_v4df abs_dn = V4DF_SELECT((bot_v4di)(dn >= zero), dn, -dn);
+    bot_v4di ok = ~(bot_v4di)(abs_dn < min_dn);
+    if (!(ok[0] | ok[1] | ok[2] | ok[3]))
+	return;
+
+    bot_v4df tol_multiplier = one / (one + abs_dn);
+    bot_v4df dn_plus_tol = abs_dn + (tol * tol_multiplier);
+
+    bot_v4df wxb[3], xp[3];
+    wxb[X] = A[X] - pt[X];
+    wxb[Y] = A[Y] - pt[Y];
+    wxb[Z] = A[Z] - pt[Z];
+    xp[X] = wxb[Y]*dir[Z] - wxb[Z]*dir[Y];
+    xp[Y] = wxb[Z]*dir[X] - wxb[X]*dir[Z];
+    xp[Z] = wxb[X]*dir[Y] - wxb[Y]*dir[X];
+    bot_v4df beta = AB[X]*xp[X] + AB[Y]*xp[Y] + AB[Z]*xp[Z];
+    bot_v4df gamma = AC[X]*xp[X] + AC[Y]*xp[Y] + AC[Z]*xp[Z];
+    beta = V4DF_SELECT((bot_v4di)(dn > zero), -beta, beta);
+    gamma = V4DF_SELECT((bot_v4di)(dn < zero), -gamma, gamma);
+
+    ok &= ~(bot_v4di)(beta + gamma > dn_plus_tol);
+    ok &= ~(bot_v4di)(beta < -tol);
+    ok &= ~(bot_v4di)(gamma < -tol);
+    if (!(ok[0] | ok[1] | ok[2] | ok[3]))
+	return;
+
+    bot_v4df dist = (wxb[X]*wn[X] + wxb[Y]*wn[Y] + wxb[Z]*wn[Z]) / dn;
+
+    for (int k = 0; k < BOT_WIDE_N; k++) {
+	if (!ok[k] || pk->tri[k] < 0)
+	    continue;
+	triangle_s *tri = &tris[pk->tri[k]];
+
+	// Fill out hitdata
+	struct hit cur_hit = {0};
+	cur_hit.hit_magic = RT_HIT_MAGIC;
+	cur_hit.hit_dist = dist[k];
+	cur_hit.hit_vpriv[X] = VDOT(tri->face_norm, rp->r_dir);
+	cur_hit.hit_vpriv[Y] = gamma[k] / abs_dn[k];
+	cur_hit.hit_vpriv[Z] =  beta[k] / abs_dn[k];
+	cur_hit.hit_private = tri;
+	cur_hit.hit_surfno = tri->face_id;
+	cur_hit.hit_rayp = rp;
+	DA_APPEND(hits, cur_hit, struct hit);
+    }
+}
+
+
+/* ray state shared by the node and triangle tests */
+struct wide_ray {
+    bot_v4sf o[3], inv[3], pad;
+    bot_v4df pt[3], dir[3];
+};
+
+
+static void
+wide_ray_init(struct wide_ray *wr, const struct bot_wide_bvh *wbvh, struct xray *rp)
+{
+    vect_t inverse_r_dir;
+
+    VINVDIR(inverse_r_dir, rp->r_dir);
+
+    /* Slop covering the error of doing the slab test in single
+     * precision relative to a ray origin rounded to float.
+     */
+    fastf_t mag = FMAX(fabs(rp->r_pt[X]), FMAX(fabs(rp->r_pt[Y]), fabs(rp->r_pt[Z]))) + wbvh->extent;
+    float pad = (float)(mag * 8.0 * FLT_EPSILON);
+    bot_v4sf padv = {pad, pad, pad, pad};
+    wr->pad = padv;
+
+    for (int a = 0; a < 3; a++) {
+	float of = (float)rp->r_pt[a];
+	float invf = (float)inverse_r_dir[a];
+	bot_v4sf ov = {of, of, of, of};
+	bot_v4sf iv = {invf, invf, invf, invf};
+	bot_v4df pv = {rp->r_pt[a], rp->r_pt[a], rp->r_pt[a], rp->r_pt[a]};
+	bot_v4df dv = {rp->r_dir[a], rp->r_dir[a], rp->r_dir[a], rp->r_dir[a]};
+	wr->o[a] = ov;
+	wr->inv[a] = iv;
+	wr->pt[a] = pv;
+	wr->dir[a] = dv;
+    }
+}
+
+
+/* slab test of one ray against the four children of a node */
+static inline bot_v4si
+wide_node_hit(const struct bot_wide_node *node, const struct wide_ray *wr)
+{
+    bot_v4sf tnear = {-1.0f, -1.0f, -1.0f, -1.0f};
+    bot_v4sf tfar = {FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX};
+
+    for (int a = 0; a < 3; a++) {
+	bot_v4sf bmin, bmax;
+	memcpy(&bmin, node->bmin[a], sizeof(bmin));
+	memcpy(&bmax, node->bmax[a], sizeof(bmax));
+	bot_v4sf t0 = (bmin - wr->o[a] - wr->pad) * wr->inv[a];
+	bot_v4sf t1 = (bmax - wr->o[a] + wr->pad) * wr->inv[a];
+	bot_v4si lt = (bot_v4si)(t0 < t1);
+	bot_v4sf lo = v4sf_select(lt, t0, t1);
+	bot_v4sf hi = v4sf_select(lt, t1, t0);
+	tnear = v4sf_select((bot_v4si)(lo > tnear), lo, tnear);
+	tfar = v4sf_select((bot_v4si)(hi < tfar), hi, tfar);
+    }
+    return (bot_v4si)(tnear <= tfar);
+}
+
+
+void
+bot_wide_shot(const struct bot_wide_bvh *wbvh, struct xray *rp, triangle_s *tris, hit_da *hits, fastf_t toldist)
+{
+    int32_t stack[HLBVH_STACK_SIZE];
+    int stack_ind = 0;
+    struct wide_ray wr;
+
+    if (UNLIKELY(!wbvh || !wbvh->nnodes))
+	return;
+
+    wide_ray_init(&wr, wbvh, rp);
+
+    stack[stack_ind++] = 0;
+    while (stack_ind > 0) {
+	const struct bot_wide_node *node = &wbvh->nodes[stack[--stack_ind]];
+	bot_v4si hit = wide_node_hit(node, &wr);
+
+	for (int k = 0; k < BOT_WIDE_N; k++) {
+	    if (!hit[k] || node->child[k] < 0)
+		continue;
+	    if (node->npackets[k]) {
+		const struct bot_wide_tri4 *pk = &wbvh->packets[node->child[k]];
+		for (int32_t p = 0; p < node->npackets[k]; p++)
+		    wide_shoot_packet(&pk[p], rp, tris, hits, toldist, wr.pt, wr.dir);
+		continue;
+	    }
+	    if (UNLIKELY(stack_ind >= HLBVH_STACK_SIZE))
+		bu_bomb("Stack size exceeded in bot wide shot");
+	    stack[stack_ind++] = node->child[k];
+	}
+    }
+}
+
+
+void
+bot_wide_shot_packet(const struct bot_wide_bvh *wbvh, struct xray *rps[], int n, triangle_s *tris, hit_da hits[], fastf_t toldist)
+{
+    int32_t stack[HLBVH_STACK_SIZE];
+    uint32_t stack_mask[HLBVH_STACK_SIZE];
+    int stack_ind = 0;
+    struct wide_ray wr[RT_PACKET_MAX];
+
+    if (UNLIKELY(!wbvh || !wbvh->nnodes || n <= 0))
+	return;
+    if (UNLIKELY(n > RT_PACKET_MAX))
+	bu_bomb("bot_wide_shot_packet: too many rays");
+
+    for (int i = 0; i < n; i++)
+	wide_ray_init(&wr[i], wbvh, rps[i]);
+
+    stack[stack_ind] = 0;
+    stack_mask[stack_ind++] = (1U << n) - 1;
+    while (stack_ind > 0) {
+	stack_ind--;
+	const struct bot_wide_node *node = &wbvh->nodes[stack[stack_ind]];
+	uint32_t mask = stack_mask[stack_ind];
+	uint32_t child_mask[BOT_WIDE_N] = {0};
+
+	/* each ray is tested against all four children at once, and
+	 * the children are only fetched for the rays that enter them */
+	for (int i = 0; i < n; i++) {
+	    if (!(mask & (1U << i)))
+		continue;
+	    bot_v4si hit = wide_node_hit(node, &wr[i]);
+	    for (int k = 0; k < BOT_WIDE_N; k++) {
+		if (hit[k])
+		    child_mask[k] |= 1U << i;
+	    }
+	}
+
+	for (int k = 0; k < BOT_WIDE_N; k++) {
+	    if (!child_mask[k] || node->child[k] < 0)
+		continue;
+	    if (node->npackets[k]) {
+		const struct bot_wide_tri4 *pk = &wbvh->packets[node->child[k]];
+		for (int i = 0; i < n; i++) {
+		    if (!(child_mask[k] & (1U << i)))
+			continue;
+		    for (int32_t p = 0; p < node->npackets[k]; p++)
+			wide_shoot_packet(&pk[p], rps[i], tris, &hits[i], toldist, wr[i].pt, wr[i].dir);
+		}
+		continue;
+	    }
+	    if (UNLIKELY(stack_ind >= HLBVH_STACK_SIZE))
+		bu_bomb("Stack size exceeded in bot wide shot");
+	    stack[stack_ind] = node->child[k];
+	    stack_mask[stack_ind++] = child_mask[k];
+	}
+    }
+}
+
+
+void
+bot_wide_free(struct bot_wide_bvh *wbvh)
+{
+    if (!wbvh)
+	return;
+    bu_free(wbvh->nodes, "bot wide nodes");
+    bu_free(wbvh->packets, "bot wide packets");
+    BU_PUT(wbvh, struct bot_wide_bvh);
+}
+
+#else /* BOT_WIDE_VECTOR */
+
+struct bot_wide_bvh *
+bot_wide_build(const struct bvh_flat_node *UNUSED(root), const triangle_s *UNUSED(tris), size_t UNUSED(ntris))
+{
+    return NULL;
+}
+
+
+void
+bot_wide_shot(const struct bot_wide_bvh *UNUSED(wbvh), struct xray *UNUSED(rp), triangle_s *UNUSED(tris), hit_da *UNUSED(hits), fastf_t UNUSED(toldist))
+{
+}
+
+
+void
+bot_wide_shot_packet(const struct bot_wide_bvh *UNUSED(wbvh), struct xray *UNUSED(rps[]), int UNUSED(n), triangle_s *UNUSED(tris), hit_da *UNUSED(hits), fastf_t UNUSED(toldist))
+{
+}
+
+
+void
+bot_wide_free(struct bot_wide_bvh *UNUSED(wbvh))
+{
+}
+
+#endif /* BOT_WIDE_VECTOR */
+
+
+/** @} */
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,132 @@
+/*                      B O T _ W I D E . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2024-2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file primitives/bot/bot_wide.h
+ *
+ * Private interface between bot.c and the wide (4-way) BVH traversal
+ * in bot_wide.c.
+ *
+ */
+
+#ifndef LIBRT_PRIMITIVES_BOT_BOT_WIDE_H
+#define LIBRT_PRIMITIVES_BOT_BOT_WIDE_H
+
+#include "common.h"
+
+#include "vmath.h"
+#include "raytrace.h"
+#include "rt/primitives/bot.h"
+
+__BEGIN_DECLS
+
+#define BOT_MIN_DN 1.0e-9
+#define HLBVH_STACK_SIZE 256
+
+typedef struct _hit_da {
+    size_t count;
+    size_t capacity;
+    struct hit *items;
+} hit_da;
+
+#define DA_INIT_CAPACITY 128
+
+// We include itemtype in DA_APPEND because
+// the options are:
+// 1. Get a -Wc++-compat warning
+// 2. Push a diagnostic that ignores that warning
+// 3. Do some sort of decltype shenanigans
+// 4. Pass in the type of the dynamic array
+
+// Append one item to a dynamic array
+// This supports the use case of appending a compile
+// time value to a dynamic array
+// Ex. DA_APPEND(da_ints, 42, int)
+#define DA_APPEND(da, item, itemtype)							\
+    do {										\
+	if ((da)->count >= (da)->capacity) {						\
+	    if ((da)->capacity == 0) {							\
+		(da)->items = (itemtype*)bu_calloc(DA_INIT_CAPACITY, sizeof(struct hit),\
+						   "DA calloc __FILE__: __LINE__" );	\
+		(da)->capacity = DA_INIT_CAPACITY;					\
+	    } else {                                                                    \
+		(da)->items = (itemtype*)bu_realloc((da)->items, 			\
+						    (da)->capacity*2*sizeof(struct hit),\
+						    "DA realloc __FILE__: __LINE__" );	\
+		(da)->capacity *= 2;							\
+	    }                                                                           \
+	    BU_ASSERT((da)->items != NULL);						\
+	}										\
+											\
+	(da)->items[(da)->count++] = (item); /* struct copy */				\
+    } while (0)
+
+
+struct bvh_flat_node;
+
+/* opaque, see bot_wide.c */
+struct bot_wide_bvh;
+
+/**
+ * Returns non-zero if the wide BVH kernel was compiled in and the
+ * running CPU supports the vector instructions it needs (as reported
+ * by bu_simd_supported()).  Setting LIBRT_BOT_WIDE=0 in the
+ * environment forces the binary BVH traversal.
+ */
+extern int bot_wide_enabled(void);
+
+/**
+ * Collapse the binary flat BVH produced by hlbvh_flatten() into
+ * 4-wide nodes with single precision SoA bounds, and pack the
+ * (already ordered) triangles of each leaf into groups of four for
+ * the vectorized intersection test.  The tris array must outlive the
+ * returned structure.  Returns NULL if the kernel is not available.
+ */
+extern struct bot_wide_bvh *bot_wide_build(const struct bvh_flat_node *root, const triangle_s *tris, size_t ntris);
+
+/**
+ * Intersect a ray with every triangle reachable through the wide BVH,
+ * appending one hit per intersected triangle to hits.  Hits are
+ * identical to those produced by the binary traversal, but are not
+ * sorted.
+ */
+extern void bot_wide_shot(const struct bot_wide_bvh *wbvh, struct xray *rp, triangle_s *tris, hit_da *hits, fastf_t toldist);
+
+/**
+ * Intersect up to RT_PACKET_MAX rays with the triangles reachable
+ * through the wide BVH, sharing each node fetch between the rays that
+ * enter it.  The hits of rps[i] are appended to hits[i], exactly as
+ * bot_wide_shot() would produce them.
+ */
+extern void bot_wide_shot_packet(const struct bot_wide_bvh *wbvh, struct xray *rps[], int n, triangle_s *tris, hit_da hits[], fastf_t toldist);
+
+extern void bot_wide_free(struct bot_wide_bvh *wbvh);
+
+__END_DECLS
+
+#endif /* LIBRT_PRIMITIVES_BOT_BOT_WIDE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,262 @@
+/*                     B R I C K _ M A P . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @addtogroup primitives */
+/** @{ */
+/** @file primitives/brick_map.c
+ *
+ * Min/max pyramid over the cells of the grid based primitives.  See
+ * brick_map.h.
+ */
+/** @} */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "bu/malloc.h"
+#include "vmath.h"
+
+#include "./brick_map.h"
+#include "../librt_private.h"
+
+
+/* values go through the prep cache in chunks of this many nodes */
+#define BRICK_MAP_CHUNK 4096
+
+
+/**
+ * Compute the node counts and offsets of every level for a grid of
+ * the given size.
+ */
+static int
+brick_map_layout(struct brick_map *bm, size_t xdim, size_t ydim, size_t zdim)
+{
+    int l, i;
+
+    memset(bm, 0, sizeof(struct brick_map));
+    if (!xdim || !ydim || !zdim)
+	return -1;
+
+    bm->dim[0][X] = xdim;
+    bm->dim[0][Y] = ydim;
+    bm->dim[0][Z] = zdim;
+    bm->levels = 1;
+
+    for (l = 1; bm->dim[l-1][X] > 1 || bm->dim[l-1][Y] > 1 || bm->dim[l-1][Z] > 1; l++) {
+	if (l >= BRICK_MAP_MAX_LEVELS)
+	    return -1;
+	for (i = X; i <= Z; i++)
+	    bm->dim[l][i] = (bm->dim[l-1][i] + BRICK_MAP_DIM - 1) >> BRICK_MAP_SHIFT;
+	bm->offset[l] = bm->nodes;
+	bm->nodes += bm->dim[l][X] * bm->dim[l][Y] * bm->dim[l][Z];
+	bm->levels++;
+    }
+
+    return 0;
+}
+
+
+int
+brick_map_build(struct brick_map *bm, size_t xdim, size_t ydim, size_t zdim, brick_map_cell_t cell, void *data)
+{
+    size_t i, x, y, z;
+    unsigned short cmin, cmax;
+    unsigned short *node, *child;
+    int l;
+
+    if (brick_map_layout(bm, xdim, ydim, zdim))
+	return -1;
+    if (!bm->nodes)
+	return 0;
+
+    bm->range = (unsigned short *)bu_malloc(bm->nodes * 2 * sizeof(unsigned short), "brick map");
+    for (i = 0; i < bm->nodes; i++) {
+	bm->range[2*i] = 0xffff;
+	bm->range[2*i+1] = 0;
+    }
+
+    /* level 1 from the cells, walked in data order */
+    for (z = 0; z < zdim; z++) {
+	for (y = 0; y < ydim; y++) {
+	    for (x = 0; x < xdim; x++) {
+		cell(data, x, y, z, &cmin, &cmax);
+		node = BRICK_MAP_NODE(bm, 1, x >> BRICK_MAP_SHIFT, y >> BRICK_MAP_SHIFT, z >> BRICK_MAP_SHIFT);
+		V_MIN(node[0], cmin);
+		V_MAX(node[1], cmax);
+	    }
+	}
+    }
+
+    /* each further level from the one below it */
+    for (l = 2; l < bm->levels; l++) {
+	for (z = 0; z < bm->dim[l-1][Z]; z++) {
+	    for (y = 0; y < bm->dim[l-1][Y]; y++) {
+		for (x = 0; x < bm->dim[l-1][X]; x++) {
+		    child = BRICK_MAP_NODE(bm, l-1, x, y, z);
+		    node = BRICK_MAP_NODE(bm, l, x >> BRICK_MAP_SHIFT, y >> BRICK_MAP_SHIFT, z >> BRICK_MAP_SHIFT);
+		    V_MIN(node[0], child[0]);
+		    V_MAX(node[1], child[1]);
+		}
+	    }
+	}
+    }
+
+    return 0;
+}
+
+
+void
+brick_map_free(struct brick_map *bm)
+{
+    if (bm->range)
+	bu_free(bm->range, "brick map");
+    memset(bm, 0, sizeof(struct brick_map));
+}
+
+
+int
+brick_map_empty_level(const struct brick_map *bm, size_t x, size_t y, size_t z)
+{
+    int l;
+
+    if (x >= bm->dim[0][X] || y >= bm->dim[0][Y] || z >= bm->dim[0][Z])
+	return 0;
+
+    /* a brick can only be empty if the brick it sits in below is */
+    for (l = 1; l < bm->levels; l++) {
+	x >>= BRICK_MAP_SHIFT;
+	y >>= BRICK_MAP_SHIFT;
+	z >>= BRICK_MAP_SHIFT;
+	if (BRICK_MAP_NODE(bm, l, x, y, z)[1] != 0)
+	    break;
+    }
+
+    return l - 1;
+}
+
+
+int
+brick_map_skip(const struct brick_map *bm, int level, const size_t cell[3], const vect_t dir, vect_t t, const vect_t delta, size_t steps[3], fastf_t *t_exit)
+{
+    size_t span = (size_t)1 << (level * BRICK_MAP_SHIFT);
+    size_t remain[3] = {0, 0, 0};
+    size_t lo, hi;
+    fastf_t t1 = INFINITY;
+    int out_axis = X;
+    int i;
+
+    /* cells left along each axis before the brick face */
+    for (i = X; i <= Z; i++) {
+	steps[i] = 0;
+	if (delta[i] <= 0.0)
+	    continue;
+
+	lo = cell[i] & ~(span - 1);
+	hi = FMIN(lo + span, bm->dim[0][i]) - 1;
+	remain[i] = dir[i] > 0.0 ? hi - cell[i] : cell[i] - lo;
+
+	if (t[i] + remain[i] * delta[i] < t1) {
+	    t1 = t[i] + remain[i] * delta[i];
+	    out_axis = i;
+	}
+    }
+
+    /* planes crossed before the exit along the other axes */
+    for (i = X; i <= Z; i++) {
+	if (delta[i] <= 0.0)
+	    continue;
+
+	if (i == out_axis) {
+	    steps[i] = remain[i] + 1;
+	} else if (t[i] < t1) {
+	    steps[i] = (size_t)ceil((t1 - t[i]) / delta[i]);
+	    if (steps[i] > remain[i])
+		steps[i] = remain[i];
+	}
+	t[i] += steps[i] * delta[i];
+    }
+
+    *t_exit = t1;
+    return out_axis;
+}
+
+
+void
+brick_map_put(struct rt_prep_stream *s, const struct brick_map *bm)
+{
+    unsigned char buf[BRICK_MAP_CHUNK * 4];
+    size_t i, j, n;
+
+    rt_prep_put_uint32(s, (uint32_t)bm->dim[0][X]);
+    rt_prep_put_uint32(s, (uint32_t)bm->dim[0][Y]);
+    rt_prep_put_uint32(s, (uint32_t)bm->dim[0][Z]);
+    rt_prep_put_uint32(s, (uint32_t)bm->nodes);
+
+    /* network order, like the rest of the stream */
+    for (i = 0; i < bm->nodes; i += n) {
+	n = FMIN(bm->nodes - i, BRICK_MAP_CHUNK);
+	for (j = 0; j < 2 * n; j++) {
+	    buf[2*j] = (unsigned char)(bm->range[2*i + j] >> 8);
+	    buf[2*j+1] = (unsigned char)(bm->range[2*i + j] & 0xff);
+	}
+	rt_prep_put_bytes(s, buf, 4 * n);
+    }
+}
+
+
+int
+brick_map_get(struct rt_prep_stream *s, struct brick_map *bm, size_t xdim, size_t ydim, size_t zdim)
+{
+    unsigned char buf[BRICK_MAP_CHUNK * 4];
+    size_t i, j, n;
+
+    if (rt_prep_get_uint32(s) != xdim || rt_prep_get_uint32(s) != ydim || rt_prep_get_uint32(s) != zdim)
+	return -1;
+    if (brick_map_layout(bm, xdim, ydim, zdim) || rt_prep_get_uint32(s) != bm->nodes || s->err)
+	return -1;
+    if (!bm->nodes)
+	return 0;
+
+    bm->range = (unsigned short *)bu_malloc(bm->nodes * 2 * sizeof(unsigned short), "brick map");
+    for (i = 0; i < bm->nodes && !s->err; i += n) {
+	n = FMIN(bm->nodes - i, BRICK_MAP_CHUNK);
+	rt_prep_get_bytes(s, buf, 4 * n);
+	for (j = 0; j < 2 * n; j++)
+	    bm->range[2*i + j] = (unsigned short)((buf[2*j] << 8) | buf[2*j+1]);
+    }
+
+    if (s->err) {
+	brick_map_free(bm);
+	return -1;
+    }
+    return 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,123 @@
+/*                     B R I C K _ M A P . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @addtogroup librt */
+/** @{ */
+/** @file brick_map.h
+ *
+ * Multi-level min/max pyramid over a regular grid of cells, shared by
+ * the grid based primitives (dsp, ebm, vol) to skip empty or
+ * uninteresting regions without visiting every cell.
+ *
+ * Level 0 is the grid itself and is not stored; the primitive reads
+ * its own data for that.  Each node of level L (L >= 1) covers a
+ * brick of BRICK_MAP_DIM^L cells along each axis and records the
+ * smallest and largest value of the cells beneath it.  The topmost
+ * level is a single node.
+ */
+/** @} */
+
+#ifndef LIBRT_PRIMITIVES_BRICK_MAP_H
+#define LIBRT_PRIMITIVES_BRICK_MAP_H seen
+
+#include "common.h"
+
+#include <stddef.h>
+
+#include "vmath.h"
+
+#define BRICK_MAP_SHIFT 2	/* log2 of the cells along a brick edge */
+#define BRICK_MAP_DIM (1 << BRICK_MAP_SHIFT)
+#define BRICK_MAP_MAX_LEVELS 17	/* enough for 2^32 cells along an axis */
+
+struct rt_prep_stream;
+
+/**
+ * Report the range of values in cell (x, y, z) of the grid.
+ */
+typedef void (*brick_map_cell_t)(void *data, size_t x, size_t y, size_t z, unsigned short *min, unsigned short *max);
+
+struct brick_map {
+    int levels;				/* number of levels, including level 0 */
+    size_t dim[BRICK_MAP_MAX_LEVELS][3];	/* nodes along each axis per level */
+    size_t offset[BRICK_MAP_MAX_LEVELS];	/* first node of each level in range */
+    size_t nodes;			/* nodes stored, levels 1 and up */
+    unsigned short *range;		/* min, max pairs of the stored nodes */
+};
+#define BRICK_MAP_INIT_ZERO {0, {{0, 0, 0}}, {0}, 0, NULL}
+
+/**
+ * Pointer to the min, max pair of the node (x, y, z) of level, which
+ * must be at least 1.
+ */
+#define BRICK_MAP_NODE(_bm, _level, _x, _y, _z) \
+    (&(_bm)->range[2 * ((_bm)->offset[_level] + \
+			((_z) * (_bm)->dim[_level][Y] + (_y)) * (_bm)->dim[_level][X] + (_x))])
+
+/**
+ * Build the pyramid over an xdim by ydim by zdim grid, asking cell()
+ * for the range of each cell once.  Two dimensional grids use a zdim
+ * of 1.
+ *
+ * Returns 0 on success, -1 on an empty or oversized grid.
+ */
+extern int brick_map_build(struct brick_map *bm, size_t xdim, size_t ydim, size_t zdim, brick_map_cell_t cell, void *data);
+
+extern void brick_map_free(struct brick_map *bm);
+
+/**
+ * Return the highest level whose brick containing cell (x, y, z) is
+ * entirely zero, or 0 when there is none or the cell lies outside the
+ * grid.
+ */
+extern int brick_map_empty_level(const struct brick_map *bm, size_t x, size_t y, size_t z);
+
+/**
+ * Carry a cell stepping DDA across the brick of the given level that
+ * contains cell.  On entry t[] holds the distances along the ray at
+ * which it leaves that cell across each axis and delta[] the distance
+ * between cell planes; axes with a zero delta are never crossed.  On
+ * return steps[] holds how many cells to move along each axis (in the
+ * direction of dir) to reach the first cell past the brick, t[] holds
+ * the exit distances of that cell, and *t_exit the distance at which
+ * the ray leaves the brick.
+ *
+ * Returns the axis the ray leaves the brick through.
+ */
+extern int brick_map_skip(const struct brick_map *bm, int level, const size_t cell[3], const vect_t dir, vect_t t, const vect_t delta, size_t steps[3], fastf_t *t_exit);
+
+/**
+ * Save a pyramid to, or restore one for an xdim by ydim by zdim grid
+ * from, a prep cache stream.  brick_map_get() returns 0 on success and
+ * -1 when the stream does not hold a matching pyramid.
+ */
+extern void brick_map_put(struct rt_prep_stream *s, const struct brick_map *bm);
+extern int brick_map_get(struct rt_prep_stream *s, struct brick_map *bm, size_t xdim, size_t ydim, size_t zdim);
+
+#endif /* LIBRT_PRIMITIVES_BRICK_MAP_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -65,14 +65,15 @@
 
 /* private header */
 #include "./dsp.h"
+#include "../brick_map.h"
+#include "../../librt_private.h"
 
 
 #define FULL_DSP_DEBUGGING 1
 
 #define ORDERED_ISECT 1
 
-#define DIM_BB_CHILDREN 4
-#define NUM_BB_CHILDREN (DIM_BB_CHILDREN*DIM_BB_CHILDREN)
+#define DIM_BB_CHILDREN BRICK_MAP_DIM
 
 #define IMPORT_FAIL(_s) \
     if (dsp_ip) { \
@@ -93,35 +94,28 @@ struct dsp_rpp {
 /**
  * This structure contains a bounding box for a portion of the DSP
  * along with information about sub-bounding boxes, and what layer
- * (resolution) of the DSP this box bounds
+ * (resolution) of the DSP this box bounds.  They are not stored, but
+ * filled in from the brick map by dsp_bb_node() as a ray descends.
  */
 struct dsp_bb {
     uint32_t magic;
     struct dsp_rpp dspb_rpp;	/* our bounding box */
     /*
-     * the next two elements indicate the number and locations of
+     * the next two elements indicate the number and size of
      * sub-bounding rpps.
      *
      * dsp_b_ch_dim is typically DIM_BB_CHILDREN, DIM_BB_CHILDREN
      * except for "border" areas of the array
      */
-    unsigned short dspb_subcell_size;/* XXX This is not yet computed */
-    unsigned short dspb_ch_dim[2];	/* dimensions of children[] */
-    struct dsp_bb *dspb_children[NUM_BB_CHILDREN];
+    unsigned int dspb_subcell_size;	/* cells along a child edge, 4^(level-1) */
+    unsigned short dspb_ch_dim[2];	/* number of children in X, Y */
+    int dspb_level;			/* brick map level, 0 for a single cell */
+    unsigned int dspb_node[2];		/* node coordinates within the level */
 };
 
 
 #define MAGIC_dsp_bb 234
 #define DSP_BB_CK(_p) BU_CKMAG(_p, MAGIC_dsp_bb, "dsp_bb")
-/*
- * This structure provides a handle to all of the bounding boxes for
- * the DSP at a particular resolution.
- */
-#define LAYER(l, x, y) l->p[l->dim[1]*y+x]
-struct dsp_bb_layer {
-    unsigned int dim[2]; /* the dimensions of the array at element p */
-    struct dsp_bb *p; /* array of dsp_bb's for this level */
-};
 
 # define XCNT(_p) (((struct rt_dsp_internal *)_p)->dsp_xcnt)
 # define YCNT(_p) (((struct rt_dsp_internal *)_p)->dsp_ycnt)
@@ -160,9 +154,7 @@ struct dsp_specific {
     double dsp_pl_dist[BBOX_PLANES];
     int xsiz;
     int ysiz;
-    int layers;
-    struct dsp_bb_layer *layer;
-    struct dsp_bb *bb_array;
+    struct brick_map bricks;	/* elevation range of the cells, by level */
 };
 
 
@@ -396,6 +388,9 @@ draw_dsp_bb(int *plotnum,
 #ifdef PLOT_LAYERS
 
 
+static void dsp_bb_node(const struct dsp_specific *dsp, int level, unsigned int x, unsigned int y, struct dsp_bb *dsp_bb);
+
+
 /**
  * Plot the bounding box layers for a dsp
  */
@@ -403,7 +398,7 @@ static void
 plot_layers(struct dsp_specific *dsp_sp)
 {
     FILE *fp;
-    int l, n;
+    int l;
     unsigned int x, y;
     char buf[32];
     static int colors[7][3] = {
@@ -416,9 +411,9 @@ plot_layers(struct dsp_specific *dsp_sp)
 	{255, 255, 255}
     };
     int r, g, b, c;
-    struct dsp_bb *d_bb;
+    struct dsp_bb d_bb;
 
-    for (l = 0; l < dsp_sp->layers; l++) {
+    for (l = 0; l < dsp_sp->bricks.levels; l++) {
 	bu_semaphore_acquire(BU_SEM_SYSCALL);
 	sprintf(buf, "Dsp_layer%d.plot3", l);
 	fp=fopen(buf, "wb");
@@ -428,19 +423,18 @@ plot_layers(struct dsp_specific *dsp_sp)
 		   buf);
 	    return;
 	} else
-	    bu_log("plotting \"%s\" dim:%d, %d\n", buf,
-		   dsp_sp->layer[l].dim[X],
-		   dsp_sp->layer[l].dim[Y]);
+	    bu_log("plotting \"%s\" dim:%zu, %zu\n", buf,
+		   dsp_sp->bricks.dim[l][X],
+		   dsp_sp->bricks.dim[l][Y]);
 	c = l % 6;
 	r = colors[c][0];
 	g = colors[c][1];
 	b = colors[c][2];
 
-	for (y = 0; y < dsp_sp->layer[l].dim[Y]; y+= 2) {
-	    for (x = 0; x < dsp_sp->layer[l].dim[X]; x+= 2) {
-		n = y * dsp_sp->layer[l].dim[X] + x;
-		d_bb = &dsp_sp->layer[l].p[n];
-		plot_dsp_bb(fp, d_bb, dsp_sp, r, g, b, 0);
+	for (y = 0; y < dsp_sp->bricks.dim[l][Y]; y+= 2) {
+	    for (x = 0; x < dsp_sp->bricks.dim[l][X]; x+= 2) {
+		dsp_bb_node(dsp_sp, l, x, y, &d_bb);
+		plot_dsp_bb(fp, &d_bb, dsp_sp, r, g, b, 0);
 
 	    }
 	}
@@ -621,213 +615,101 @@ rt_dsp_print(register const struct soltab *stp)
 
 
 /**
- * compute bounding boxes for each cell, then compute bounding boxes
- * for collections of bounding boxes
+ * elevation range of a cell, from its four corners
  */
 static void
-dsp_layers(struct dsp_specific *dsp, unsigned short *d_min, unsigned short *d_max)
+dsp_cell_range(void *data, size_t x, size_t y, size_t UNUSED(z), unsigned short *min, unsigned short *max)
 {
-    int idx, curr_layer, xs, ys, xv, yv, tot;
-    unsigned int x, y, i, j, k;
-    unsigned short dsp_min, dsp_max;
+    struct rt_dsp_internal *dsp_ip = (struct rt_dsp_internal *)data;
     unsigned short elev;
-    struct dsp_bb *dsp_bb;
-    struct dsp_rpp *t;
-    struct dsp_bb_layer *curr, *prev;
-    unsigned short subcell_size;
-
-    /* First we compute the total number of struct dsp_bb's we will need */
-    xs = dsp->xsiz;
-    ys = dsp->ysiz;
-    tot = xs * ys;
-    /*    bu_log("layer %d   %dx%d\n", 0, xs, ys); */
-    dsp->layers = 1;
-    while (xs > 1 || ys > 1) {
-	xv = xs / DIM_BB_CHILDREN;
-	yv = ys / DIM_BB_CHILDREN;
-	if (xs % DIM_BB_CHILDREN) xv++;
-	if (ys % DIM_BB_CHILDREN) yv++;
-
-#ifdef FULL_DSP_DEBUGGING
-	if (RT_G_DEBUG & RT_DEBUG_HF)
-	    bu_log("layer %d   %dx%d\n", dsp->layers, xv, yv);
-#endif
-	tot += xv * yv;
-
-	if (xv > 0) xs = xv;
-	else xs = 1;
-
-	if (yv > 0) ys = yv;
-	else ys = 1;
-	dsp->layers++;
-    }
-
-
-#ifdef FULL_DSP_DEBUGGING
-    if (RT_G_DEBUG & RT_DEBUG_HF)
-	bu_log("%d layers total\n", dsp->layers);
-#endif
-
-    /* allocate the struct dsp_bb's we will need */
-    dsp->layer = (struct dsp_bb_layer *)bu_malloc(dsp->layers * sizeof(struct dsp_bb_layer),
-			   "dsp_bb_layers array");
-    dsp->bb_array = (struct dsp_bb *)bu_malloc(tot * sizeof(struct dsp_bb), "dsp_bb array");
-
-    /* now we fill in the "lowest" layer of struct dsp_bb's from the
-     * raw data
-     */
-    dsp->layer[0].dim[X] = dsp->xsiz;
-    dsp->layer[0].dim[Y] = dsp->ysiz;
-    dsp->layer[0].p = dsp->bb_array;
-
-    dsp_min = 0xffff;
-    dsp_max = 0;
 
-    for (y = 0; y < YSIZ(dsp); y++) {
+    elev = DSP(dsp_ip, x, y);
+    *min = *max = elev;
 
-	unsigned short cell_min = 0xffff;
-	unsigned short cell_max = 0;
+    elev = DSP(dsp_ip, x+1, y);
+    V_MIN(*min, elev);
+    V_MAX(*max, elev);
 
-	for (x = 0; x < XSIZ(dsp); x++) {
+    elev = DSP(dsp_ip, x, y+1);
+    V_MIN(*min, elev);
+    V_MAX(*max, elev);
 
-	    elev = DSP(&dsp->dsp_i, x, y);
-	    cell_min = cell_max = elev;
-
-	    elev = DSP(&dsp->dsp_i, x+1, y);
-	    V_MIN(cell_min, elev);
-	    V_MAX(cell_max, elev);
-
-	    elev = DSP(&dsp->dsp_i, x, y+1);
-	    V_MIN(cell_min, elev);
-	    V_MAX(cell_max, elev);
-
-	    elev = DSP(&dsp->dsp_i, x+1, y+1);
-	    V_MIN(cell_min, elev);
-	    V_MAX(cell_max, elev);
-
-	    /* factor the cell min/max into the overall min/max */
-	    V_MIN(dsp_min, cell_min);
-	    V_MAX(dsp_max, cell_max);
-
-	    /* fill in the dsp_rpp cell min/max */
-	    i = y*XSIZ(dsp) + x;
-	    dsp_bb = &dsp->layer[0].p[i];
-	    VSET(dsp_bb->dspb_rpp.dsp_min, x, y, cell_min);
-	    VSET(dsp_bb->dspb_rpp.dsp_max, x+1, y+1, cell_max);
-
-	    dsp_bb->dspb_subcell_size = 0;
+    elev = DSP(dsp_ip, x+1, y+1);
+    V_MIN(*min, elev);
+    V_MAX(*max, elev);
+}
 
-	    /* There are no "children" of a layer 0 element */
-	    dsp_bb->dspb_ch_dim[X] = 0;
-	    dsp_bb->dspb_ch_dim[Y] = 0;
-	    for (k = 0; k < NUM_BB_CHILDREN; k++) {
-		dsp_bb->dspb_children[k] =
-		    (struct dsp_bb *)NULL;
-	    }
-	    dsp_bb->magic = MAGIC_dsp_bb;
 
-	    /* XXX should we compute the triangle orientation and
-	     * save it here too?
-	     */
-	}
+/**
+ * Fill in the bounding box of node (x, y) of the given level.  Level
+ * 0 nodes are single cells and are computed from the data, the others
+ * come from the brick map.
+ */
+static void
+dsp_bb_node(const struct dsp_specific *dsp, int level, unsigned int x, unsigned int y, struct dsp_bb *dsp_bb)
+{
+    unsigned int n = 1U << (level * BRICK_MAP_SHIFT);
+    const unsigned short *range;
+
+    dsp_bb->magic = MAGIC_dsp_bb;
+    dsp_bb->dspb_level = level;
+    dsp_bb->dspb_node[X] = x;
+    dsp_bb->dspb_node[Y] = y;
+
+    dsp_bb->dspb_rpp.dsp_min[X] = x * n;
+    dsp_bb->dspb_rpp.dsp_min[Y] = y * n;
+    dsp_bb->dspb_rpp.dsp_max[X] = FMIN((x + 1) * n, (unsigned int)dsp->xsiz);
+    dsp_bb->dspb_rpp.dsp_max[Y] = FMIN((y + 1) * n, (unsigned int)dsp->ysiz);
+
+    if (level == 0) {
+	/* There are no "children" of a layer 0 element */
+	dsp_cell_range((void *)&dsp->dsp_i, x, y, 0, &dsp_bb->dspb_rpp.dsp_min[Z], &dsp_bb->dspb_rpp.dsp_max[Z]);
+	dsp_bb->dspb_subcell_size = 0;
+	dsp_bb->dspb_ch_dim[X] = 0;
+	dsp_bb->dspb_ch_dim[Y] = 0;
+	return;
     }
 
-    *d_min = dsp_min;
-    *d_max = dsp_max;
-
-
-    if (RT_G_DEBUG & RT_DEBUG_HF)
-	bu_log("layer 0 filled\n");
-
-    subcell_size = 1;
-
-    /* now we compute successive layers from the initial layer */
-    for (curr_layer = 1; curr_layer < dsp->layers; curr_layer++) {
-	/* compute the number of cells in each direction for this layer */
-
-	xs = dsp->layer[curr_layer-1].dim[X];
-	if (xs % DIM_BB_CHILDREN)
-	    dsp->layer[curr_layer].dim[X] =
-		xs / DIM_BB_CHILDREN + 1;
-	else
-	    dsp->layer[curr_layer].dim[X] =
-		xs / DIM_BB_CHILDREN;
-
-	ys = dsp->layer[curr_layer-1].dim[Y];
-	if (ys % DIM_BB_CHILDREN)
-	    dsp->layer[curr_layer].dim[Y] =
-		ys / DIM_BB_CHILDREN + 1;
-	else
-	    dsp->layer[curr_layer].dim[Y] =
-		ys / DIM_BB_CHILDREN;
-
-	/* set the start of the array for this layer */
-	dsp->layer[curr_layer].p =
-	    &dsp->layer[curr_layer-1].p[dsp->layer[curr_layer-1].dim[X] * dsp->layer[curr_layer-1].dim[Y] ];
-
-	curr = &dsp->layer[curr_layer];
-	prev = &dsp->layer[curr_layer-1];
-
-	if (RT_G_DEBUG & RT_DEBUG_HF)
-	    bu_log("layer %d  subcell size %d\n", curr_layer, subcell_size);
-
-	/* walk the grid and fill in the values for this layer */
-	for (y = 0; y < curr->dim[Y]; y++) {
-	    for (x = 0; x < curr->dim[X]; x++) {
-		int n, xp, yp;
-		/* x, y are in the coordinates in the current
-		 * layer.  xp, yp are the coordinates of the
-		 * same area in the previous (lower) layer.
-		 */
-		xp = x * DIM_BB_CHILDREN;
-		yp = y * DIM_BB_CHILDREN;
-
-		/* initialize the current dsp_bb cell */
-		dsp_bb = &curr->p[y*curr->dim[X]+x];
-		dsp_bb->magic = MAGIC_dsp_bb;
-		n = lrint(pow((double)DIM_BB_CHILDREN, (double)curr_layer));
-		VSET(dsp_bb->dspb_rpp.dsp_min,
-		     x * n, y * n, 0x0ffff);
-		VSET(dsp_bb->dspb_rpp.dsp_max,
-		     x * n, y * n, 0);
-
-		/* record the dimensions of our children */
-		dsp_bb->dspb_subcell_size = subcell_size;
-
+    range = BRICK_MAP_NODE(&dsp->bricks, level, x, y, 0);
+    dsp_bb->dspb_rpp.dsp_min[Z] = range[0];
+    dsp_bb->dspb_rpp.dsp_max[Z] = range[1];
 
-		tot = 0;
-		i = 0;
-		for (j = 0; j < DIM_BB_CHILDREN && (yp+j)<prev->dim[Y]; j++) {
-		    for (i = 0; i < DIM_BB_CHILDREN && (xp+i)<prev->dim[X]; i++) {
-
-			idx = (yp+j) * prev->dim[X] + xp+i;
+    /* record the size and number of our children */
+    n >>= BRICK_MAP_SHIFT;
+    dsp_bb->dspb_subcell_size = n;
+    dsp_bb->dspb_ch_dim[X] = (dsp_bb->dspb_rpp.dsp_max[X] - dsp_bb->dspb_rpp.dsp_min[X] + n - 1) / n;
+    dsp_bb->dspb_ch_dim[Y] = (dsp_bb->dspb_rpp.dsp_max[Y] - dsp_bb->dspb_rpp.dsp_min[Y] + n - 1) / n;
+}
 
-			t = &prev->p[ idx ].dspb_rpp;
 
-			VMINMAX(dsp_bb->dspb_rpp.dsp_min,
-				dsp_bb->dspb_rpp.dsp_max, t->dsp_min);
-			VMINMAX(dsp_bb->dspb_rpp.dsp_min,
-				dsp_bb->dspb_rpp.dsp_max, t->dsp_max);
+/**
+ * compute the elevation range of each cell, then of successively
+ * larger bricks of cells up to the whole DSP.  Only the bricks are
+ * stored; single cells are read from the data as they are needed.
+ */
+static int
+dsp_layers(struct dsp_specific *dsp, unsigned short *d_min, unsigned short *d_max)
+{
+    struct dsp_bb top;
 
-			dsp_bb->dspb_children[tot++] = &prev->p[ idx ];
+    if (brick_map_build(&dsp->bricks, dsp->xsiz, dsp->ysiz, 1, dsp_cell_range, &dsp->dsp_i))
+	return -1;
 
-		    }
-		}
+    dsp_bb_node(dsp, dsp->bricks.levels - 1, 0, 0, &top);
+    *d_min = top.dspb_rpp.dsp_min[Z];
+    *d_max = top.dspb_rpp.dsp_max[Z];
 
-		dsp_bb->dspb_ch_dim[X] = i;
-		dsp_bb->dspb_ch_dim[Y] = j;
-	    }
-	}
-	subcell_size *= DIM_BB_CHILDREN;
-    }
+    if (RT_G_DEBUG & RT_DEBUG_HF)
+	bu_log("%d layers total\n", dsp->bricks.levels);
 
 #ifdef PLOT_LAYERS
     if (RT_G_DEBUG & RT_DEBUG_HF) {
 	plot_layers(dsp);
 	bu_log("_  x:%u y:%u min %d max %d\n",
-	       XCNT(dsp), YCNT(dsp), dsp_min, dsp_max);
+	       XCNT(dsp), YCNT(dsp), *d_min, *d_max);
     }
 #endif
+    return 0;
 }
 
 /**
@@ -836,8 +718,8 @@ dsp_layers(struct dsp_specific *dsp, unsigned short *d_min, unsigned short *d_ma
 int
 rt_dsp_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct bn_tol *UNUSED(tol)) {
     struct rt_dsp_internal *dsp_ip;
-    struct dsp_specific ds;
-    unsigned short dsp_min, dsp_max;
+    unsigned short dsp_max, elev;
+    unsigned int x, y;
     point_t pt, bbpt;
 
     RT_CK_DB_INTERNAL(ip);
@@ -852,13 +734,6 @@ rt_dsp_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
 		bu_log("dsp(%s): no data file or data file empty\n", bu_vls_addr(&dsp_ip->dsp_name));
 		return 1; /* BAD */
 	    }
-
-	    /* we do this here and now because we will need it for the
-	     * dsp_specific structure in a few lines
-	     */
-	    bu_semaphore_acquire(RT_SEM_MODEL);
-	    ++dsp_ip->dsp_mp->uses;
-	    bu_semaphore_release(RT_SEM_MODEL);
 	    break;
 	case RT_DSP_SRC_OBJ:
 	    if (!dsp_ip->dsp_bip) {
@@ -870,34 +745,14 @@ rt_dsp_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
 	    break;
     }
 
-    memset(&ds, 0, sizeof(struct dsp_specific));
-
-    /* this works ok, because the mapped file keeps track of the
-     * number of uses.  However, the binunif interface does not.
-     * We'll have to copy the data for that one.
-     */
-    ds.dsp_i = *dsp_ip;		/* struct copy */
-
-    /* this keeps the binary internal object from being freed */
-    dsp_ip->dsp_bip = (struct rt_db_internal *)NULL;
-
-
-    ds.xsiz = dsp_ip->dsp_xcnt-1;	/* size is # cells or values-1 */
-    ds.ysiz = dsp_ip->dsp_ycnt-1;	/* size is # cells or values-1 */
-
-
-    /* compute the multi-resolution bounding boxes */
-    dsp_layers(&ds, &dsp_min, &dsp_max);
-
-
-    /* record the distance to each of the bounding planes */
-    ds.dsp_pl_dist[XMIN] = 0.0;
-    ds.dsp_pl_dist[XMAX] = (fastf_t)ds.xsiz;
-    ds.dsp_pl_dist[YMIN] = 0.0;
-    ds.dsp_pl_dist[YMAX] = (fastf_t)ds.ysiz;
-    ds.dsp_pl_dist[ZMIN] = 0.0;
-    ds.dsp_pl_dist[ZMAX] = (fastf_t)dsp_max;
-    ds.dsp_pl_dist[ZMID] = (fastf_t)dsp_min;
+    /* only the highest elevation is needed, no need for the bricks */
+    dsp_max = 0;
+    for (y = 0; y < dsp_ip->dsp_ycnt; y++) {
+	for (x = 0; x < dsp_ip->dsp_xcnt; x++) {
+	    elev = DSP(dsp_ip, x, y);
+	    V_MAX(dsp_max, elev);
+	}
+    }
 
     /* compute enlarged bounding box and sphere */
     VSETALL((*min), INFINITY);
@@ -919,63 +774,22 @@ rt_dsp_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
 
 #undef BBOX_PT
 
-    switch (dsp_ip->dsp_datasrc) {
-	case RT_DSP_SRC_V4_FILE:
-	case RT_DSP_SRC_FILE:
-	    bu_semaphore_acquire(RT_SEM_MODEL);
-	    --dsp_ip->dsp_mp->uses;
-	    bu_semaphore_release(RT_SEM_MODEL);
-	    break;
-    }
-
     return 0;
 }
 
+
 /**
- * Given a pointer to a GED database record, and a transformation
- * matrix, determine if this is a valid DSP, and if so, precompute
- * various terms of the formula.
- *
- * Returns -
- * 0 DSP is OK
- * !0 Error in description
- *
- * Implicit return -
- * A struct dsp_specific is created, and its address is stored in
- * stp->st_specific for use by dsp_shot().
- *
- * Note:  because the stand-along bbox calculation requires much
- * of the prep logic, the in-prep bbox calculations are left
- * in to avoid duplication rather than calling rt_dsp_bbox.
+ * Take over the data of the internal form and set up the parts of
+ * the dsp_specific that do not depend on the elevations.
  */
-int
-rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+static struct dsp_specific *
+dsp_prep_specific(struct soltab *stp, struct rt_dsp_internal *dsp_ip)
 {
-    struct rt_dsp_internal *dsp_ip;
     register struct dsp_specific *dsp;
-    unsigned short dsp_min, dsp_max;
-    point_t pt, bbpt;
-    vect_t work;
-    fastf_t f;
-
-    if (RT_G_DEBUG & RT_DEBUG_HF)
-	bu_log("rt_dsp_prep()\n");
-
-    if (rtip) RT_CK_RTI(rtip);
-
-    RT_CK_DB_INTERNAL(ip);
-    dsp_ip = (struct rt_dsp_internal *)ip->idb_ptr;
-    RT_DSP_CK_MAGIC(dsp_ip);
-    BU_CK_VLS(&dsp_ip->dsp_name);
 
     switch (dsp_ip->dsp_datasrc) {
 	case RT_DSP_SRC_V4_FILE:
 	case RT_DSP_SRC_FILE:
-	    if (!dsp_ip->dsp_mp) {
-		bu_log("dsp(%s): no data file or data file empty\n", bu_vls_addr(&dsp_ip->dsp_name));
-		return 1; /* BAD */
-	    }
-
 	    /* we do this here and now because we will need it for the
 	     * dsp_specific structure in a few lines
 	     */
@@ -983,17 +797,8 @@ rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 	    ++dsp_ip->dsp_mp->uses;
 	    bu_semaphore_release(RT_SEM_MODEL);
 	    break;
-	case RT_DSP_SRC_OBJ:
-	    if (!dsp_ip->dsp_bip) {
-		bu_log("dsp(%s): no data\n", bu_vls_addr(&dsp_ip->dsp_name));
-		return 1; /* BAD */
-	    }
-	    RT_CK_DB_INTERNAL(dsp_ip->dsp_bip);
-	    RT_CK_BINUNIF(dsp_ip->dsp_bip->idb_ptr);
-	    break;
     }
 
-
     BU_GET(dsp, struct dsp_specific);
     stp->st_specific = (void *) dsp;
 
@@ -1002,6 +807,7 @@ rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
      * We'll have to copy the data for that one.
      */
     dsp->dsp_i = *dsp_ip;		/* struct copy */
+    memset(&dsp->bricks, 0, sizeof(struct brick_map));
 
     /* this keeps the binary internal object from being freed */
     dsp_ip->dsp_bip = (struct rt_db_internal *)NULL;
@@ -1010,10 +816,21 @@ rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     dsp->xsiz = dsp_ip->dsp_xcnt-1;	/* size is # cells or values-1 */
     dsp->ysiz = dsp_ip->dsp_ycnt-1;	/* size is # cells or values-1 */
 
+    return dsp;
+}
 
-    /* compute the multi-resolution bounding boxes */
-    dsp_layers(dsp, &dsp_min, &dsp_max);
 
+/**
+ * Record the bounding planes and the bounding box and sphere, given
+ * the elevation range of the whole DSP.
+ */
+static void
+dsp_prep_bounds(struct soltab *stp, struct dsp_specific *dsp, unsigned short dsp_min, unsigned short dsp_max)
+{
+    struct rt_dsp_internal *dsp_ip = &dsp->dsp_i;
+    point_t pt, bbpt;
+    vect_t work;
+    fastf_t f;
 
     /* record the distance to each of the bounding planes */
     dsp->dsp_pl_dist[XMIN] = 0.0;
@@ -1056,11 +873,149 @@ rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 	       V3ARGS(stp->st_min),
 	       V3ARGS(stp->st_max));
     }
+}
+
+
+/**
+ * Given a pointer to a GED database record, and a transformation
+ * matrix, determine if this is a valid DSP, and if so, precompute
+ * various terms of the formula.
+ *
+ * Returns -
+ * 0 DSP is OK
+ * !0 Error in description
+ *
+ * Implicit return -
+ * A struct dsp_specific is created, and its address is stored in
+ * stp->st_specific for use by dsp_shot().
+ */
+int
+rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    struct rt_dsp_internal *dsp_ip;
+    register struct dsp_specific *dsp;
+    unsigned short dsp_min, dsp_max;
+
+    if (RT_G_DEBUG & RT_DEBUG_HF)
+	bu_log("rt_dsp_prep()\n");
+
+    if (rtip) RT_CK_RTI(rtip);
+
+    RT_CK_DB_INTERNAL(ip);
+    dsp_ip = (struct rt_dsp_internal *)ip->idb_ptr;
+    RT_DSP_CK_MAGIC(dsp_ip);
+    BU_CK_VLS(&dsp_ip->dsp_name);
+
+    switch (dsp_ip->dsp_datasrc) {
+	case RT_DSP_SRC_V4_FILE:
+	case RT_DSP_SRC_FILE:
+	    if (!dsp_ip->dsp_mp) {
+		bu_log("dsp(%s): no data file or data file empty\n", bu_vls_addr(&dsp_ip->dsp_name));
+		return 1; /* BAD */
+	    }
+	    break;
+	case RT_DSP_SRC_OBJ:
+	    if (!dsp_ip->dsp_bip) {
+		bu_log("dsp(%s): no data\n", bu_vls_addr(&dsp_ip->dsp_name));
+		return 1; /* BAD */
+	    }
+	    RT_CK_DB_INTERNAL(dsp_ip->dsp_bip);
+	    RT_CK_BINUNIF(dsp_ip->dsp_bip->idb_ptr);
+	    break;
+    }
+
+    if (dsp_ip->dsp_xcnt < 2 || dsp_ip->dsp_ycnt < 2) {
+	bu_log("dsp(%s): needs at least 2x2 elevations\n", bu_vls_addr(&dsp_ip->dsp_name));
+	return 1; /* BAD */
+    }
+
+    dsp = dsp_prep_specific(stp, dsp_ip);
+
+    /* compute the multi-resolution bounding boxes */
+    if (dsp_layers(dsp, &dsp_min, &dsp_max)) {
+	bu_log("dsp(%s): unable to build brick map\n", bu_vls_addr(&dsp_ip->dsp_name));
+	return 1; /* BAD */
+    }
+
+    dsp_prep_bounds(stp, dsp, dsp_min, dsp_max);
 
     return 0;
 }
 
 
+/**
+ * Save or restore the brick map built by rt_dsp_prep(), which reads
+ * every elevation of the DSP.  Only elevations read from a file are
+ * cached; the file size and modification time are stored with the
+ * map so an edited file is not matched with a stale one.  Elevations
+ * held in a binunif object are not part of the cache key and are
+ * always prepped.
+ */
+int
+rt_dsp_prep_serialize(struct soltab *stp, const struct rt_db_internal *ip, struct bu_external *external, size_t *version)
+{
+    const size_t current_version = 0;
+    struct rt_dsp_internal *dsp_ip;
+    const struct bu_mapped_file *mp;
+    struct rt_prep_stream s;
+
+    RT_CK_SOLTAB(stp);
+    RT_CK_DB_INTERNAL(ip);
+    BU_CK_EXTERNAL(external);
+
+    rt_prep_stream_init(&s, external);
+
+    if (stp->st_specific) {
+	/* export to external */
+	struct dsp_specific *dsp = (struct dsp_specific *)stp->st_specific;
+
+	mp = dsp->dsp_i.dsp_mp;
+	if (dsp->dsp_i.dsp_datasrc == RT_DSP_SRC_OBJ || !mp || mp->buflen > UINT32_MAX)
+	    return 1;
+
+	rt_prep_put_uint32(&s, (uint32_t)mp->buflen);
+	rt_prep_put_uint32(&s, (uint32_t)((uint64_t)mp->modtime >> 32));
+	rt_prep_put_uint32(&s, (uint32_t)((uint64_t)mp->modtime & 0xffffffff));
+	brick_map_put(&s, &dsp->bricks);
+
+	rt_prep_stream_finish(&s);
+	*version = current_version;
+	return 0;
+    } else {
+	/* load from external */
+	struct dsp_specific *dsp;
+	struct brick_map bricks;
+	struct dsp_bb top;
+	uint32_t hi, lo;
+
+	if (*version != current_version)
+	    return 1;
+
+	dsp_ip = (struct rt_dsp_internal *)ip->idb_ptr;
+	RT_DSP_CK_MAGIC(dsp_ip);
+	mp = dsp_ip->dsp_mp;
+	if (dsp_ip->dsp_datasrc == RT_DSP_SRC_OBJ || !mp || dsp_ip->dsp_xcnt < 2 || dsp_ip->dsp_ycnt < 2)
+	    return 1;
+
+	if (rt_prep_get_uint32(&s) != mp->buflen)
+	    return 1;
+	hi = rt_prep_get_uint32(&s);
+	lo = rt_prep_get_uint32(&s);
+	if (s.err || (((uint64_t)hi << 32) | lo) != (uint64_t)mp->modtime)
+	    return 1;
+	if (brick_map_get(&s, &bricks, dsp_ip->dsp_xcnt - 1, dsp_ip->dsp_ycnt - 1, 1))
+	    return 1;
+
+	dsp = dsp_prep_specific(stp, dsp_ip);
+	dsp->bricks = bricks;	/* struct copy */
+
+	dsp_bb_node(dsp, dsp->bricks.levels - 1, 0, 0, &top);
+	dsp_prep_bounds(stp, dsp, top.dspb_rpp.dsp_min[Z], top.dspb_rpp.dsp_max[Z]);
+	return 0;
+    }
+}
+
+
 static void
 plot_seg(struct isect_stuff *isect,
 	 struct hit *in_hit,
@@ -2164,11 +2119,10 @@ recurse_dsp_bb(struct isect_stuff *isect,
     fastf_t tX, tY;	/* dist from hit pt. to next cell boundary */
     fastf_t curr_dist;
     short cX, cY;	/* coordinates of current cell */
-    short cs;		/* cell X, Y dimension */
+    int cs;		/* cell X, Y dimension */
     short stepX, stepY;	/* dist to step in child array for each dir */
-    short stepPX, stepPY;
     fastf_t out_dist;
-    struct dsp_bb **p;
+    struct dsp_bb child;
     fastf_t *stom = &isect->dsp->dsp_i.dsp_stom[0];
     point_t pt, v;
     int loop = 0;
@@ -2198,7 +2152,7 @@ recurse_dsp_bb(struct isect_stuff *isect,
     tX = tY = curr_dist = isect->r.r_min;
 
     if (isect->r.r_dir[X] < 0.0) {
-	stepPX = stepX = -1;
+	stepX = -1;
 	/* tDX is the distance along the ray we have to travel to
 	 * traverse a cell (travel a unit distance) along the X axis
 	 * of the grid
@@ -2210,7 +2164,7 @@ recurse_dsp_bb(struct isect_stuff *isect,
 	 */
 	tX += ((bbmin[X] + (cX * cs)) - minpt[X]) / isect->r.r_dir[X];
     } else {
-	stepPX = stepX = 1;
+	stepX = 1;
 	tDX = cs / isect->r.r_dir[X];
 
 	if (isect->r.r_dir[X] > 0.0)
@@ -2220,15 +2174,11 @@ recurse_dsp_bb(struct isect_stuff *isect,
     }
 
     if (isect->r.r_dir[Y] < 0) {
-	/* distance in dspb_children we have to move to step in Y dir
-	 */
 	stepY = -1;
-	stepPY = -dsp_bb->dspb_ch_dim[X];
 	tDY = -cs / isect->r.r_dir[Y];
 	tY += ((bbmin[Y] + (cY * cs)) - minpt[Y]) / isect->r.r_dir[Y];
     } else {
 	stepY = 1;
-	stepPY = dsp_bb->dspb_ch_dim[X];
 	tDY = cs / isect->r.r_dir[Y];
 
 	if (isect->r.r_dir[Y] > 0.0)
@@ -2240,7 +2190,6 @@ recurse_dsp_bb(struct isect_stuff *isect,
     /* factor in the tolerance to the out-distance */
     out_dist = isect->r.r_max - isect->tol->dist;
 
-    p = &dsp_bb->dspb_children[dsp_bb->dspb_ch_dim[X] * cY + cX];
 #ifdef FULL_DSP_DEBUGGING
     dlog("tX:%g tY:%g\n", tX, tY);
 
@@ -2262,33 +2211,29 @@ recurse_dsp_bb(struct isect_stuff *isect,
 	    bu_log("pt %g %g %g\n", V3ARGS(v));
 	}
 
-	/* get pointer to the current child cell.  Note the extra
-	 * level of indirection.  We want to march p through
-	 * dspb_children using pointer addition, but dspb_children
-	 * contains pointers.  We need to be sure to increment the
-	 * offset in the array, not the child pointer.
-	 */
+	/* fill in the current child cell from the level below */
+	dsp_bb_node(isect->dsp, dsp_bb->dspb_level - 1,
+		    dsp_bb->dspb_node[X] * DIM_BB_CHILDREN + cX,
+		    dsp_bb->dspb_node[Y] * DIM_BB_CHILDREN + cY, &child);
 
 	if (RT_G_DEBUG & RT_DEBUG_HF)
 	    bu_log_indent_delta(4);
 
-	if (isect_ray_dsp_bb(isect, *p)) return 1;
+	if (isect_ray_dsp_bb(isect, &child)) return 1;
 
 	if (RT_G_DEBUG & RT_DEBUG_HF)
 	    bu_log_indent_delta(-4);
 
 	/* figure out which cell is next */
 	if (tX < tY) {
-	    cX += stepX;  /* track cell offset for debugging */
-	    p += stepPX;
+	    cX += stepX;
 #ifdef FULL_DSP_DEBUGGING
 	    dlog("stepping X to %d because %g < %g\n", cX, tX, tY);
 #endif
 	    curr_dist = tX;
 	    tX += tDX;
 	} else {
-	    cY += stepY;  /* track cell offset for debugging */
-	    p += stepPY;
+	    cY += stepY;
 #ifdef FULL_DSP_DEBUGGING
 	    dlog("stepping Y to %d because %g >= %g\n", cY, tX, tY);
 #endif
@@ -2442,13 +2387,18 @@ isect_ray_dsp_bb(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 	return recurse_dsp_bb(isect, dsp_bb, minpt, maxpt, bbmin, bbmax);
 #else
 	int i;
+	struct dsp_bb child;
 	/* there are children, so we recurse */
 	i = dsp_bb->dspb_ch_dim[X] * dsp_bb->dspb_ch_dim[Y] - 1;
 	if (RT_G_DEBUG & RT_DEBUG_HF)
 	    bu_log_indent_delta(4);
 
-	for (; i >= 0; i--)
-	    isect_ray_dsp_bb(isect, dsp_bb->dspb_children[i]);
+	for (; i >= 0; i--) {
+	    dsp_bb_node(isect->dsp, dsp_bb->dspb_level - 1,
+			dsp_bb->dspb_node[X] * DIM_BB_CHILDREN + i % dsp_bb->dspb_ch_dim[X],
+			dsp_bb->dspb_node[Y] * DIM_BB_CHILDREN + i / dsp_bb->dspb_ch_dim[X], &child);
+	    isect_ray_dsp_bb(isect, &child);
+	}
 
 	if (RT_G_DEBUG & RT_DEBUG_HF)
 	    bu_log_indent_delta(-4);
@@ -2534,6 +2484,7 @@ rt_dsp_shot(struct soltab *stp, register struct xray *rp, struct application *ap
     vect_t dir;	/* temp storage */
     vect_t v;
     struct isect_stuff isect;
+    struct dsp_bb top;
     fastf_t delta;
 
     RT_DSP_CK_MAGIC(dsp);
@@ -2583,19 +2534,13 @@ rt_dsp_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 	       V3ARGS(isect.r.r_dir));
     }
 
-    /* We look at the topmost layer of the bounding-box tree and make
-     * sure that it has dimension 1.  Otherwise, something is wrong
+    /* the topmost layer of the brick map is a single node covering
+     * the whole DSP
      */
-    if (isect.dsp->layer[isect.dsp->layers-1].dim[X] != 1 ||
-	isect.dsp->layer[isect.dsp->layers-1].dim[Y] != 1) {
-	bu_log("%s:%d how do i find the topmost layer?\n",
-	       __FILE__, __LINE__);
-	bu_bomb("");
-    }
-
+    dsp_bb_node(isect.dsp, isect.dsp->bricks.levels - 1, 0, 0, &top);
 
     /* intersect the ray with the bounding rpps */
-    (void)isect_ray_dsp_bb(&isect, isect.dsp->layer[isect.dsp->layers-1].p);
+    (void)isect_ray_dsp_bb(&isect, &top);
 
     /* if we missed it all, give up now */
     if (BU_LIST_IS_EMPTY(&isect.seglist))
@@ -3088,6 +3033,7 @@ rt_dsp_free(register struct soltab *stp)
 	    break;
     }
 
+    brick_map_free(&dsp->bricks);
     BU_PUT(dsp, struct dsp_specific);
 }
 
@@ -3095,7 +3041,7 @@ rt_dsp_free(register struct soltab *stp)
 int
 rt_dsp_plot(struct bu_list *vhead, struct rt_db_internal *ip, const struct bg_tess_tol *ttol, const struct bn_tol *UNUSED(tol), const struct bview *UNUSED(info))
 {
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     struct rt_dsp_internal *dsp_ip =
 	(struct rt_dsp_internal *)ip->idb_ptr;
     point_t m_pt;
@@ -43,6 +43,7 @@
 #include "rt/geom.h"
 #include "raytrace.h"
 #include "../fixpt.h"
+#include "../brick_map.h"
 #include "../../librt_private.h"
 
 
@@ -55,6 +56,7 @@ struct rt_ebm_specific {
     vect_t ebm_origin;	/* local coords of grid origin (0, 0, 0) for now */
     vect_t ebm_large;	/* local coords of XYZ max */
     mat_t ebm_mat;	/* model to ideal space */
+    struct brick_map ebm_bricks;	/* occupied cells, for skipping empty space */
 };
 
 
@@ -341,6 +343,7 @@ rt_ebm_dda(register struct xray *rp, struct soltab *stp, struct application *ap,
     int inside;		/* inside/outside a solid flag */
     int in_index;
     int out_index;
+    int level;
     int j;
 
     /* Compute inverse of the direction cosines */
@@ -429,6 +432,9 @@ rt_ebm_dda(register struct xray *rp, struct soltab *stp, struct application *ap,
 		rp->r_pt[Y]) * invdir[Y];
 	delta[Y] = ebmp->ebm_cellsize[Y] * fabs(invdir[Y]);
     }
+    /* the extrusion is clipped later, the grid has no Z planes */
+    t[Z] = INFINITY;
+    delta[Z] = 0;
 
     /* The delta[] elements *must* be positive, as t must increase */
     if (RT_G_DEBUG&RT_DEBUG_EBM)bu_log("t[X] = %g, delta[X] = %g\n", t[X], delta[X]);
@@ -550,6 +556,23 @@ rt_ebm_dda(register struct xray *rp, struct soltab *stp, struct application *ap,
 	    }
 	}
 
+	/* Jump over the largest empty brick around a void cell */
+	if (!inside && val == 0
+	    && (level = brick_map_empty_level(&ebmp->ebm_bricks, igrid[X], igrid[Y], 0)) > 0)
+	{
+	    size_t steps[3];
+
+	    in_index = brick_map_skip(&ebmp->ebm_bricks, level, igrid, rp->r_dir, t, delta, steps, &t0);
+	    for (j = X; j <= Y; j++) {
+		if (rp->r_dir[j] > 0) {
+		    igrid[j] += steps[j];
+		} else {
+		    igrid[j] -= steps[j];
+		}
+	    }
+	    continue;
+	}
+
 	/* Take next step */
 	t0 = t1;
 	in_index = out_index;
@@ -1135,17 +1158,19 @@ rt_ebm_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
 }
 
 
+static void
+ebm_cell_range(void *data, size_t x, size_t y, size_t UNUSED(z), unsigned short *min, unsigned short *max)
+{
+    *min = *max = (*bit((struct rt_ebm_internal *)data, x, y) != 0);
+}
+
+
 /**
- * Returns -
- * 0 OK
- * !0 Failure
- *
- * Implicit return -
- * A struct rt_ebm_specific is created, and its address is stored
- * in stp->st_specific for use by rt_ebm_shot().
+ * Set up everything in the ebm_specific except the brick map, taking
+ * over the bitmap storage of the internal form.
  */
-int
-rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+static struct rt_ebm_specific *
+ebm_prep_specific(struct soltab *stp, struct rt_db_internal *ip)
 {
     struct rt_ebm_internal *eip;
     register struct rt_ebm_specific *ebmp;
@@ -1153,13 +1178,12 @@ rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     vect_t radvec;
     vect_t diam;
 
-    if (rtip) RT_CK_RTI(rtip);
-
     eip = (struct rt_ebm_internal *)ip->idb_ptr;
     RT_EBM_CK_MAGIC(eip);
 
     BU_GET(ebmp, struct rt_ebm_specific);
     ebmp->ebm_i = *eip;		/* struct copy */
+    memset(&ebmp->ebm_bricks, 0, sizeof(struct brick_map));
 
     /* "steal" the bitmap storage */
     eip->mp = (struct bu_mapped_file *)0;	/* "steal" the mapped file */
@@ -1178,7 +1202,7 @@ rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     stp->st_specific = (void *)ebmp;
 
     /* Find bounding RPP of rotated local RPP */
-    rt_ebm_bbox(ip, &(stp->st_min), &(stp->st_max), &rtip->rti_tol);
+    rt_ebm_bbox(ip, &(stp->st_min), &(stp->st_max), NULL);
     VSET(ebmp->ebm_large, ebmp->ebm_i.xdim, ebmp->ebm_i.ydim, ebmp->ebm_i.tallness);
 
     /* for now, EBM origin in ideal coordinates is at origin */
@@ -1193,10 +1217,105 @@ rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     VSCALE(radvec, diam, 0.5);
     stp->st_aradius = stp->st_bradius = MAGNITUDE(radvec);
 
+    return ebmp;
+}
+
+
+/**
+ * Returns -
+ * 0 OK
+ * !0 Failure
+ *
+ * Implicit return -
+ * A struct rt_ebm_specific is created, and its address is stored
+ * in stp->st_specific for use by rt_ebm_shot().
+ */
+int
+rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    register struct rt_ebm_specific *ebmp;
+
+    if (rtip) RT_CK_RTI(rtip);
+
+    ebmp = ebm_prep_specific(stp, ip);
+
+    /* occupancy pyramid, so the DDA can jump over empty bricks */
+    if (brick_map_build(&ebmp->ebm_bricks, ebmp->ebm_i.xdim, ebmp->ebm_i.ydim, 1, ebm_cell_range, &ebmp->ebm_i))
+	bu_log("ebm(%s): unable to build brick map\n", ebmp->ebm_i.name);
+
     return 0;		/* OK */
 }
 
 
+/**
+ * Save or restore the brick map built by rt_ebm_prep(), which walks
+ * every cell of the bitmap.  Only bitmaps read from a file are
+ * cached; the file size and modification time are stored with the
+ * map so an edited bitmap is not matched with a stale one.  Bitmaps
+ * held in a binunif object are not part of the cache key and are
+ * always prepped.
+ */
+int
+rt_ebm_prep_serialize(struct soltab *stp, const struct rt_db_internal *ip, struct bu_external *external, size_t *version)
+{
+    const size_t current_version = 0;
+    struct rt_ebm_internal *eip;
+    const struct bu_mapped_file *mp;
+    struct rt_prep_stream s;
+
+    RT_CK_SOLTAB(stp);
+    RT_CK_DB_INTERNAL(ip);
+    BU_CK_EXTERNAL(external);
+
+    rt_prep_stream_init(&s, external);
+
+    if (stp->st_specific) {
+	/* export to external */
+	struct rt_ebm_specific *ebmp = (struct rt_ebm_specific *)stp->st_specific;
+
+	mp = ebmp->ebm_i.mp;
+	if (ebmp->ebm_i.datasrc != RT_EBM_SRC_FILE || !mp || mp->buflen > UINT32_MAX)
+	    return 1;
+
+	rt_prep_put_uint32(&s, (uint32_t)mp->buflen);
+	rt_prep_put_uint32(&s, (uint32_t)((uint64_t)mp->modtime >> 32));
+	rt_prep_put_uint32(&s, (uint32_t)((uint64_t)mp->modtime & 0xffffffff));
+	brick_map_put(&s, &ebmp->ebm_bricks);
+
+	rt_prep_stream_finish(&s);
+	*version = current_version;
+	return 0;
+    } else {
+	/* load from external */
+	struct rt_ebm_specific *ebmp;
+	struct brick_map bricks;
+	uint32_t hi, lo;
+
+	if (*version != current_version)
+	    return 1;
+
+	eip = (struct rt_ebm_internal *)ip->idb_ptr;
+	RT_EBM_CK_MAGIC(eip);
+	mp = eip->mp;
+	if (eip->datasrc != RT_EBM_SRC_FILE || !mp)
+	    return 1;
+
+	if (rt_prep_get_uint32(&s) != mp->buflen)
+	    return 1;
+	hi = rt_prep_get_uint32(&s);
+	lo = rt_prep_get_uint32(&s);
+	if (s.err || (((uint64_t)hi << 32) | lo) != (uint64_t)mp->modtime)
+	    return 1;
+	if (brick_map_get(&s, &bricks, eip->xdim, eip->ydim, 1))
+	    return 1;
+
+	ebmp = ebm_prep_specific(stp, (struct rt_db_internal *)ip);
+	ebmp->ebm_bricks = bricks;	/* struct copy */
+	return 0;
+    }
+}
+
+
 void
 rt_ebm_print(register const struct soltab *stp)
 {
@@ -1330,6 +1449,7 @@ rt_ebm_free(struct soltab *stp)
 	(struct rt_ebm_specific *)stp->st_specific;
 
     bu_close_mapped_file(ebmp->ebm_i.mp);
+    brick_map_free(&ebmp->ebm_bricks);
 
     BU_PUT(ebmp, struct rt_ebm_specific);
 }
@@ -1373,7 +1493,7 @@ rt_ebm_plot(struct bu_list *vhead, struct rt_db_internal *ip, const struct bg_te
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     eip = (struct rt_ebm_internal *)ip->idb_ptr;
     RT_EBM_CK_MAGIC(eip);
 
@@ -1610,7 +1730,7 @@ rt_ebm_tess(struct nmgregion **r, struct model *m, struct rt_db_internal *ip, co
     size_t max_loop_length;
     size_t loop_length;
     vect_t height, h;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     BN_CK_TOL(tol);
     NMG_CK_MODEL(m);
@@ -455,9 +455,11 @@ rt_ell_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 }
 
 
-#define RT_ELL_SEG_MISS(SEG)	(SEG).seg_stp=RT_SOLTAB_NULL
 /**
- * This is the Becker vector version.
+ * Vectorized version of rt_ell_shot().  The ray of each pair is taken
+ * into unit sphere space and reduced to its quadratic in one pass
+ * over a block of pairs, the radicals are solved in a second pass, and
+ * the segments are written out in a third.
  */
 void
 rt_ell_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struct application *ap)
@@ -467,49 +469,71 @@ rt_ell_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, str
 /* Number of ray/object pairs */
 
 {
-    register int i;
-    register struct ell_specific *ell;
-
-    vect_t dprime;		/* D' */
-    vect_t pprime;		/* P' */
-    vect_t xlated;		/* translated vector */
-    fastf_t dp, dd;		/* D' dot P', D' dot D' */
-    fastf_t k1, k2;		/* distance constants of solution */
-    fastf_t root;		/* root of radical */
+    fastf_t dp[RT_VSHOT_BLOCK];		/* D' dot P' */
+    fastf_t dd[RT_VSHOT_BLOCK];		/* D' dot D' */
+    fastf_t root[RT_VSHOT_BLOCK];	/* root of radical */
+    int base, m, i;
 
     if (ap) RT_CK_APPLICATION(ap);
 
-    /* for each ray/ellipse pair */
-    for (i = 0; i < n; i++) {
-	if (stp[i] == 0) continue; /* stp[i] == 0 signals skip ray */
+    for (base = 0; base < n; base += RT_VSHOT_BLOCK) {
+	struct soltab **bstp = &stp[base];
+	struct xray **brp = &rp[base];
+	struct seg *bsegp = &segp[base];
+
+	m = n - base;
+	if (m > RT_VSHOT_BLOCK)
+	    m = RT_VSHOT_BLOCK;
+
+	/* gather the quadratic for each ray/ellipsoid pair */
+	for (i = 0; i < m; i++) {
+	    const struct ell_specific *ell;
+	    vect_t dprime;	/* D' */
+	    vect_t pprime;	/* P' */
+	    vect_t xlated;	/* translated vector */
+
+	    if (bstp[i] == 0) {
+		/* stp[i] == 0 signals skip ray */
+		dp[i] = root[i] = 0.0;
+		dd[i] = 1.0;
+		continue;
+	    }
+	    ell = (const struct ell_specific *)bstp[i]->st_specific;
 
-	ell = (struct ell_specific *)stp[i]->st_specific;
+	    MAT4X3VEC(dprime, ell->ell_SoR, brp[i]->r_dir);
+	    VSUB2(xlated, brp[i]->r_pt, ell->ell_V);
+	    MAT4X3VEC(pprime, ell->ell_SoR, xlated);
 
-	MAT4X3VEC(dprime, ell->ell_SoR, rp[i]->r_dir);
-	VSUB2(xlated, rp[i]->r_pt, ell->ell_V);
-	MAT4X3VEC(pprime, ell->ell_SoR, xlated);
+	    dp[i] = VDOT(dprime, pprime);
+	    dd[i] = VDOT(dprime, dprime);
+	    root[i] = dp[i]*dp[i] - dd[i] * (VDOT(pprime, pprime)-1.0);
+	}
 
-	dp = VDOT(dprime, pprime);
-	dd = VDOT(dprime, dprime);
+	for (i = 0; i < m; i++)
+	    root[i] = root[i] < 0 ? -1.0 : sqrt(root[i]);
 
-	if ((root = dp*dp - dd * (VDOT(pprime, pprime)-1.0)) < 0) {
-	    RT_ELL_SEG_MISS(segp[i]);		/* No hit */
-	} else {
-	    root = sqrt(root);
+	for (i = 0; i < m; i++) {
+	    fastf_t k1, k2;	/* distance constants of solution */
 
-	    segp[i].seg_stp = stp[i];
+	    if (bstp[i] == 0)
+		continue;
+	    if (root[i] < 0) {
+		bsegp[i].seg_stp = RT_SOLTAB_NULL;	/* No hit */
+		continue;
+	    }
+	    bsegp[i].seg_stp = bstp[i];
 
-	    if ((k1=(-dp+root)/dd) <= (k2=(-dp-root)/dd)) {
+	    if ((k1=(-dp[i]+root[i])/dd[i]) <= (k2=(-dp[i]-root[i])/dd[i])) {
 		/* k1 is entry, k2 is exit */
-		segp[i].seg_in.hit_dist = k1;
-		segp[i].seg_out.hit_dist = k2;
+		bsegp[i].seg_in.hit_dist = k1;
+		bsegp[i].seg_out.hit_dist = k2;
 	    } else {
 		/* k2 is entry, k1 is exit */
-		segp[i].seg_in.hit_dist = k2;
-		segp[i].seg_out.hit_dist = k1;
+		bsegp[i].seg_in.hit_dist = k2;
+		bsegp[i].seg_out.hit_dist = k1;
 	    }
-	    segp[i].seg_in.hit_surfno = 0;
-	    segp[i].seg_out.hit_surfno = 0;
+	    bsegp[i].seg_in.hit_surfno = 0;
+	    bsegp[i].seg_out.hit_surfno = 0;
 	}
     }
 }
@@ -781,7 +805,7 @@ rt_ell_adaptive_plot(struct bu_list *vhead, struct rt_db_internal *ip, const str
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     eip = (struct rt_ell_internal *)ip->idb_ptr;
     RT_ELL_CK_MAGIC(eip);
 
@@ -831,7 +855,7 @@ rt_ell_plot(struct bu_list *vhead, struct rt_db_internal *ip, const struct bg_te
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     eip = (struct rt_ell_internal *)ip->idb_ptr;
     RT_ELL_CK_MAGIC(eip);
 
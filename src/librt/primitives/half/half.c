@@ -189,10 +189,10 @@ rt_hlf_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 }
 
 
-#define RT_HALF_SEG_MISS(SEG)	(SEG).seg_stp=RT_SOLTAB_NULL
-
 /**
- * This is the Becker vector version
+ * Vectorized version of rt_hlf_shot().  The plane distances of a
+ * block of pairs are computed in one pass and classified into in/out
+ * distances in a second, so both loops are free of per-pair calls.
  */
 void
 rt_hlf_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struct application *ap)
@@ -202,48 +202,74 @@ rt_hlf_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, str
     /* Number of ray/object pairs */
 
 {
-    register int i;
-    register struct half_specific *halfp;
-
-    fastf_t in, out;	/* ray in/out distances */
-    fastf_t slant_factor;	/* Direction dot Normal */
-    fastf_t norm_dist;
+    fastf_t norm_dist[RT_VSHOT_BLOCK];
+    fastf_t slant_factor[RT_VSHOT_BLOCK];	/* Direction dot Normal */
+    fastf_t in[RT_VSHOT_BLOCK], out[RT_VSHOT_BLOCK];	/* ray in/out distances */
+    int hit[RT_VSHOT_BLOCK];
+    int base, m, i;
 
     if (ap) RT_CK_APPLICATION(ap);
 
-    /* for each ray/halfspace pair */
-    for (i = 0; i < n; i++) {
-	if (stp[i] == 0) continue; /* indicates "skip this pair" */
-
-	halfp = (struct half_specific *)stp[i]->st_specific;
+    for (base = 0; base < n; base += RT_VSHOT_BLOCK) {
+	struct soltab **bstp = &stp[base];
+	struct xray **brp = &rp[base];
+	struct seg *bsegp = &segp[base];
 
-	in = -INFINITY;
-	out = INFINITY;
+	m = n - base;
+	if (m > RT_VSHOT_BLOCK)
+	    m = RT_VSHOT_BLOCK;
 
-	norm_dist = VDOT(halfp->half_eqn, rp[i]->r_pt) - halfp->half_eqn[W];
+	for (i = 0; i < m; i++) {
+	    const struct half_specific *halfp;
 
-	if ((slant_factor = -VDOT(halfp->half_eqn, rp[i]->r_dir)) <
-	    -1.0e-10) {
-	    /* exit point, when dir.N < 0.  out = min(out, s) */
-	    out = norm_dist/slant_factor;
-	} else if (slant_factor > 1.0e-10) {
-	    /* entry point, when dir.N > 0.  in = max(in, s) */
-	    in = norm_dist/slant_factor;
-	} else {
-	    /* ray is parallel to plane when dir.N == 0.
-	     * If it is outside the solid, stop now */
-	    if (norm_dist > 0.0) {
-		RT_HALF_SEG_MISS(segp[i]);	/* No hit */
+	    if (bstp[i] == 0) {
+		/* indicates "skip this pair" */
+		norm_dist[i] = slant_factor[i] = 0.0;
 		continue;
 	    }
+	    halfp = (const struct half_specific *)bstp[i]->st_specific;
+	    norm_dist[i] = VDOT(halfp->half_eqn, brp[i]->r_pt) - halfp->half_eqn[W];
+	    slant_factor[i] = -VDOT(halfp->half_eqn, brp[i]->r_dir);
+	}
+
+	for (i = 0; i < m; i++) {
+	    in[i] = -INFINITY;
+	    out[i] = INFINITY;
+	    if (slant_factor[i] < -1.0e-10) {
+		/* exit point, when dir.N < 0.  out = min(out, s) */
+		out[i] = norm_dist[i]/slant_factor[i];
+		/* ensure a legal distance between +inf/-inf */
+		hit[i] = NEAR_ZERO(out[i], INFINITY);
+	    } else if (slant_factor[i] > 1.0e-10) {
+		/* entry point, when dir.N > 0.  in = max(in, s) */
+		in[i] = norm_dist[i]/slant_factor[i];
+		/* ensure a legal distance between +inf/-inf */
+		hit[i] = NEAR_ZERO(in[i], INFINITY);
+	    } else {
+		/* ray is parallel to plane when dir.N == 0.  If it is
+		 * outside the solid, stop now
+		 */
+		hit[i] = !(norm_dist[i] > 0.0);
+	    }
 	}
 
-	/* HIT */
-	segp[i].seg_stp = stp[i];
-	segp[i].seg_in.hit_dist = in;
-	segp[i].seg_out.hit_dist = out;
-	segp[i].seg_in.hit_surfno = 0;
-	segp[i].seg_out.hit_surfno = 0;
+	for (i = 0; i < m; i++) {
+	    if (bstp[i] == 0)
+		continue;
+	    if (!hit[i]) {
+		bsegp[i].seg_stp = RT_SOLTAB_NULL;	/* No hit */
+		continue;
+	    }
+	    if (RT_G_DEBUG & RT_DEBUG_ARB8)
+		bu_log("half: in=%f, out=%f\n", in[i], out[i]);
+
+	    /* HIT */
+	    bsegp[i].seg_stp = bstp[i];
+	    bsegp[i].seg_in.hit_dist = in[i];
+	    bsegp[i].seg_out.hit_dist = out[i];
+	    bsegp[i].seg_in.hit_surfno = 0;
+	    bsegp[i].seg_out.hit_surfno = 0;
+	}
     }
 }
 
@@ -400,7 +426,7 @@ rt_hlf_plot(struct bu_list *vhead, struct rt_db_internal *ip, const struct bg_te
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     hip = (struct rt_half_internal *)ip->idb_ptr;
     RT_HALF_CK_MAGIC(hip);
 
@@ -187,6 +187,7 @@ int
 rt_metaball_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 {
     struct rt_metaball_internal *mb, *nmb;
+    struct metaball_specific *ms;
     struct wdb_metaball_pnt *mbpt, *nmbpt;
     fastf_t minfstr = +INFINITY;
 
@@ -196,7 +197,8 @@ rt_metaball_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rti
     RT_METABALL_CK_MAGIC(mb);
 
     /* generate a copy of the metaball */
-    BU_ALLOC(nmb, struct rt_metaball_internal);
+    BU_ALLOC(ms, struct metaball_specific);
+    nmb = &ms->mb;
     nmb->magic = RT_METABALL_INTERNAL_MAGIC;
     BU_LIST_INIT(&nmb->metaball_ctrl_head);
     nmb->threshold = mb->threshold;
@@ -213,9 +215,25 @@ rt_metaball_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rti
 	BU_LIST_INSERT(&nmb->metaball_ctrl_head, &nmbpt->l);
     }
 
-    /* find the bounding sphere */
-    stp->st_aradius = rt_metaball_get_bounding_sphere(&stp->st_center, mb->threshold, mb);
-    stp->st_bradius = stp->st_aradius * 1.01;
+    ms->accel = NULL;
+    if (metaball_accel_enabled(nmb))
+	ms->accel = metaball_accel_build(nmb);
+
+    if (ms->accel) {
+	/* the influence bounds are tight and avoid the O(n^2)
+	 * bounding sphere */
+	vect_t work;
+
+	metaball_accel_bounds(ms->accel, stp->st_min, stp->st_max);
+	VADD2SCALE(stp->st_center, stp->st_min, stp->st_max, 0.5);
+	VSUB2SCALE(work, stp->st_max, stp->st_min, 0.5);
+	stp->st_aradius = FMAX(work[X], FMAX(work[Y], work[Z]));
+	stp->st_bradius = MAGNITUDE(work);
+    } else {
+	/* find the bounding sphere */
+	stp->st_aradius = rt_metaball_get_bounding_sphere(&stp->st_center, mb->threshold, mb);
+	stp->st_bradius = stp->st_aradius * 1.01;
+    }
 
     /* XXX magic numbers, increase if scalloping is observed. :(*/
     nmb->initstep = minfstr / 2.0;
@@ -225,10 +243,16 @@ rt_metaball_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rti
 	nmb->initstep = (stp->st_aradius / 10.0);
     nmb->finalstep = /*stp->st_aradius * */minfstr / 1e5;
 
+    if (ms->accel) {
+	metaball_accel_set_steps(ms->accel, nmb->initstep, nmb->finalstep);
+	stp->st_specific = (void *)ms;
+	return 0;
+    }
+
     /* generate a bounding box around the sphere...
      * XXX this can be optimized greatly to reduce the BSP presence... */
     if (rt_metaball_bbox(ip, &(stp->st_min), &(stp->st_max), &rtip->rti_tol)) return 1;
-    stp->st_specific = (void *)nmb;
+    stp->st_specific = (void *)ms;
     return 0;
 }
 
@@ -371,6 +395,9 @@ rt_metaball_shot(struct soltab *stp, register struct xray *rp, struct applicatio
     point_t p, inc;
     const point_t *cp = (const point_t *)&p;
 
+    if (((struct metaball_specific *)stp->st_specific)->accel)
+	return metaball_accel_shot(((struct metaball_specific *)stp->st_specific)->accel, stp, rp, ap, seghead);
+
     /* switching behavior to retain old code for performance and correctness
      * comparisons. */
 #define SHOOTALGO 3
@@ -541,7 +568,13 @@ rt_metaball_norm_internal(vect_t *n, point_t *p, struct rt_metaball_internal *mb
 void
 rt_metaball_norm(register struct hit *hitp, struct soltab *stp, register struct xray *rp)
 {
+    struct metaball_specific *ms = (struct metaball_specific *)stp->st_specific;
+
     if (rp) RT_CK_RAY(rp);	/* unused. */
+    if (ms->accel) {
+	metaball_accel_norm(ms->accel, hitp->hit_point, hitp->hit_normal);
+	return;
+    }
     rt_metaball_norm_internal(&(hitp->hit_normal), &(hitp->hit_point), (struct rt_metaball_internal *)(stp->st_specific));
     return;
 }
@@ -611,9 +644,15 @@ rt_metaball_uv(struct application *ap, struct soltab *stp, struct hit *hitp, str
 void
 rt_metaball_free(register struct soltab *stp)
 {
-    struct rt_metaball_internal *metaball = (struct rt_metaball_internal *)stp->st_specific;
+    struct metaball_specific *ms = (struct metaball_specific *)stp->st_specific;
+    struct wdb_metaball_pnt *mbpt;
 
-    bu_free((char *)metaball, "rt_metaball_internal");
+    while (BU_LIST_WHILE(mbpt, wdb_metaball_pnt, &ms->mb.metaball_ctrl_head)) {
+	BU_LIST_DEQUEUE(&mbpt->l);
+	bu_free(mbpt, "wdb_metaball_pnt");
+    }
+    metaball_accel_free(ms->accel);
+    bu_free((char *)ms, "metaball_specific");
 }
 
 
@@ -652,7 +691,7 @@ rt_metaball_plot(struct bu_list *vhead, struct rt_db_internal *ip, const struct
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     mb = (struct rt_metaball_internal *)ip->idb_ptr;
     RT_METABALL_CK_MAGIC(mb);
     rad = rt_metaball_get_bounding_sphere(&bsc, mb->threshold, mb);
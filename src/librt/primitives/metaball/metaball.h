@@ -26,6 +26,25 @@ fastf_t rt_metaball_get_bounding_sphere(point_t *center, fastf_t threshold, stru
 int rt_metaball_find_intersection(point_t *intersect, const struct rt_metaball_internal *mb, const point_t *a, const point_t *b, fastf_t step, const fastf_t finalstep);
 void rt_metaball_norm_internal(vect_t *n, point_t *p, struct rt_metaball_internal *mb);
 
+/* accelerated intersection for metaballs with many control points,
+ * see metaball_accel.c */
+struct metaball_accel;
+
+/* what a prepped metaball keeps in st_specific.  mb comes first so
+ * st_specific can still be used as an rt_metaball_internal. */
+struct metaball_specific {
+    struct rt_metaball_internal mb;
+    struct metaball_accel *accel;	/* NULL when not accelerated */
+};
+
+int metaball_accel_enabled(const struct rt_metaball_internal *mb);
+struct metaball_accel *metaball_accel_build(const struct rt_metaball_internal *mb);
+void metaball_accel_bounds(const struct metaball_accel *acc, point_t min, point_t max);
+void metaball_accel_set_steps(struct metaball_accel *acc, fastf_t minstep, fastf_t finalstep);
+void metaball_accel_free(struct metaball_accel *acc);
+int metaball_accel_shot(const struct metaball_accel *acc, struct soltab *stp, struct xray *rp, struct application *ap, struct seg *seghead);
+void metaball_accel_norm(const struct metaball_accel *acc, const point_t p, vect_t n);
+
 #endif /* LIBRT_PRIMITIVES_METABALL_METABALL_H */
 
 /*
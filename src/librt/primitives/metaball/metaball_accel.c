@@ -0,0 +1,481 @@
+/*                 M E T A B A L L _ A C C E L . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @addtogroup primitives */
+/** @{ */
+/** @file primitives/metaball/metaball_accel.c
+ *
+ * Accelerated ray intersection for metaballs with many control
+ * points.
+ *
+ * Each control point only contributes within an influence radius,
+ * beyond which its field is below METABALL_ACCEL_CUTOFF times the
+ * threshold, divided among the points.  The field of each point is
+ * shifted down by its value at that radius so the truncated sum stays
+ * continuous, and an HLBVH is built over the influence spheres so a
+ * field evaluation only visits the points that reach it.  Since no
+ * point is off by more than its share, the field as a whole never
+ * differs from the exact sum by more than METABALL_ACCEL_CUTOFF times
+ * the threshold, however many points there are.
+ *
+ * The ray is walked by sphere tracing.  Along with the field at a
+ * sample, the traversal sums a bound on the field gradient over a
+ * ball around the sample, which limits how far the field can move
+ * toward the threshold within that ball.  Steps are the largest that
+ * bound allows, but never below the fixed step of the plain walk, so
+ * empty space is crossed in a few large steps while the sampling
+ * density near the surface is unchanged.  Crossings are refined by
+ * bisection as before.
+ *
+ * Strict metaballs and blobs with a non-positive 'goo' are not
+ * accelerated.
+ */
+/** @} */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "vmath.h"
+#include "raytrace.h"
+#include "rt/geom.h"
+
+#include "metaball.h"
+#include "../../cut_hlbvh.h" /* for hlbvh functions */
+
+
+/* fraction of the threshold the truncated field may be off by in
+ * total; each of n points gets 1/n of it */
+#define METABALL_ACCEL_CUTOFF 1.0e-3
+
+/* control point count at and above which prep accelerates by default */
+#define METABALL_ACCEL_MIN_POINTS 64
+
+#define METABALL_ACCEL_MAX_PRIMS_IN_NODE 4
+#define METABALL_ACCEL_STACK_SIZE 256
+#define METABALL_ACCEL_MAX_BISECT 64
+
+
+struct metaball_ball {
+    point_t c;
+    fastf_t R;		/* influence radius */
+    fastf_t k;		/* isopotential: |fldstr|*fldstr, blob: goo */
+    fastf_t a;		/* blob: goo/fldstr^2 */
+    fastf_t gR;		/* field at the influence radius */
+    fastf_t r_peak;	/* blob: radius of the steepest field slope */
+    fastf_t gp_max;	/* blob: steepest field slope */
+};
+
+
+struct metaball_accel {
+    int method;
+    fastf_t threshold;
+    fastf_t minstep;
+    fastf_t finalstep;
+    size_t count;
+    struct metaball_ball *balls;	/* in BVH leaf order */
+    struct bvh_flat_node *root;
+};
+
+
+int
+metaball_accel_enabled(const struct rt_metaball_internal *mb)
+{
+    const char *menv = getenv("LIBRT_METABALL_ACCEL");
+    size_t count = 0;
+    struct wdb_metaball_pnt *mbpt;
+
+    if (mb->method != METABALL_ISOPOTENTIAL && mb->method != METABALL_BLOB)
+	return 0;
+    if (!(mb->threshold > 0.0))
+	return 0;
+
+    if (menv)
+	return atoi(menv) != 0;
+
+    for (BU_LIST_FOR(mbpt, wdb_metaball_pnt, &mb->metaball_ctrl_head))
+	count++;
+    return count >= METABALL_ACCEL_MIN_POINTS;
+}
+
+
+/* set up the field terms of one control point, returns 0 if it can
+ * never reach the cutoff */
+static int
+metaball_ball_init(struct metaball_ball *b, const struct wdb_metaball_pnt *mbpt, int method, fastf_t cutoff)
+{
+
+    VMOVE(b->c, mbpt->coord);
+    b->a = b->r_peak = b->gp_max = 0.0;
+
+    if (method == METABALL_ISOPOTENTIAL) {
+	/* g(r) = k/r^2 */
+	b->k = fabs(mbpt->fldstr) * mbpt->fldstr;
+	if (ZERO(b->k))
+	    return 0;
+	b->R = fabs(mbpt->fldstr) / sqrt(cutoff);
+	b->gR = b->k / (b->R * b->R);
+	return 1;
+    }
+
+    /* g(r) = exp(k - a*r^2) */
+    if (!(mbpt->sweat > 0.0) || ZERO(mbpt->fldstr))
+	return -1;
+    b->k = mbpt->sweat;
+    b->a = mbpt->sweat / (mbpt->fldstr * mbpt->fldstr);
+    if (b->k - log(cutoff) <= 0.0)
+	return 0;
+    b->R = sqrt((b->k - log(cutoff)) / b->a);
+    b->gR = cutoff;
+    b->r_peak = 1.0 / sqrt(2.0 * b->a);
+    b->gp_max = 2.0 * b->a * b->r_peak * exp(b->k - 0.5);
+    return 1;
+}
+
+
+struct metaball_accel *
+metaball_accel_build(const struct rt_metaball_internal *mb)
+{
+    struct metaball_accel *acc;
+    struct metaball_ball *balls;
+    struct wdb_metaball_pnt *mbpt;
+    struct bu_pool *pool;
+    struct bvh_build_node *build_root;
+    fastf_t *centroids, *bounds;
+    long nodes_created = 0;
+    long *ordered_prims = NULL;
+    size_t count = 0, i;
+    fastf_t cutoff;
+
+    RT_METABALL_CK_MAGIC(mb);
+
+    for (BU_LIST_FOR(mbpt, wdb_metaball_pnt, &mb->metaball_ctrl_head))
+	count++;
+    if (!count)
+	return NULL;
+
+    /* the error of each truncated point is at most the cutoff */
+    cutoff = METABALL_ACCEL_CUTOFF * mb->threshold / (fastf_t)count;
+
+    balls = (struct metaball_ball *)bu_malloc(count * sizeof(struct metaball_ball), "metaball balls");
+    i = 0;
+    for (BU_LIST_FOR(mbpt, wdb_metaball_pnt, &mb->metaball_ctrl_head)) {
+	int ret = metaball_ball_init(&balls[i], mbpt, mb->method, cutoff);
+	if (ret < 0) {
+	    bu_free(balls, "metaball balls");
+	    return NULL;
+	}
+	if (ret)
+	    i++;
+    }
+    count = i;
+    if (!count) {
+	bu_free(balls, "metaball balls");
+	return NULL;
+    }
+
+    centroids = (fastf_t *)bu_malloc(count * sizeof(fastf_t) * 3, "metaball centroids");
+    bounds = (fastf_t *)bu_malloc(count * sizeof(fastf_t) * 6, "metaball bounds");
+    for (i = 0; i < count; i++) {
+	VMOVE(&centroids[i*3], balls[i].c);
+	VSETALL(&bounds[i*6+0], -balls[i].R);
+	VSETALL(&bounds[i*6+3], balls[i].R);
+	VADD2(&bounds[i*6+0], &bounds[i*6+0], balls[i].c);
+	VADD2(&bounds[i*6+3], &bounds[i*6+3], balls[i].c);
+    }
+
+    pool = hlbvh_init_pool(count);
+    build_root = hlbvh_create(METABALL_ACCEL_MAX_PRIMS_IN_NODE, pool, centroids, bounds, &nodes_created,
+			      count, &ordered_prims);
+    bu_free(centroids, "metaball centroids");
+    bu_free(bounds, "metaball bounds");
+
+    BU_GET(acc, struct metaball_accel);
+    acc->method = mb->method;
+    acc->threshold = mb->threshold;
+    acc->minstep = mb->initstep;
+    acc->finalstep = mb->finalstep;
+    acc->count = count;
+    acc->root = hlbvh_flatten(build_root, nodes_created);
+    bu_pool_delete(pool);
+
+    acc->balls = (struct metaball_ball *)bu_malloc(count * sizeof(struct metaball_ball), "metaball ordered balls");
+    for (i = 0; i < count; i++)
+	acc->balls[i] = balls[ordered_prims[i]];
+    bu_free(ordered_prims, "ordered prims");
+    bu_free(balls, "metaball balls");
+
+    return acc;
+}
+
+
+void
+metaball_accel_bounds(const struct metaball_accel *acc, point_t min, point_t max)
+{
+    VMOVE(min, &acc->root->bounds[0]);
+    VMOVE(max, &acc->root->bounds[3]);
+}
+
+
+void
+metaball_accel_set_steps(struct metaball_accel *acc, fastf_t minstep, fastf_t finalstep)
+{
+    acc->minstep = minstep;
+    acc->finalstep = finalstep;
+}
+
+
+void
+metaball_accel_free(struct metaball_accel *acc)
+{
+    if (!acc)
+	return;
+    bu_free(acc->balls, "metaball ordered balls");
+    bu_free(acc->root, "bvh flat nodes");
+    BU_PUT(acc, struct metaball_accel);
+}
+
+
+/* steepest slope of the field of b anywhere at or beyond radius r0 */
+static fastf_t
+metaball_ball_slope(const struct metaball_accel *acc, const struct metaball_ball *b, fastf_t r0)
+{
+    if (acc->method == METABALL_ISOPOTENTIAL) {
+	if (r0 <= SMALL_FASTF)
+	    return INFINITY;
+	return 2.0 * fabs(b->k) / (r0 * r0 * r0);
+    }
+    if (r0 <= b->r_peak)
+	return b->gp_max;
+    return 2.0 * b->a * r0 * exp(b->k - b->a * r0 * r0);
+}
+
+
+/**
+ * Evaluate the truncated field at p.  If slope is non-NULL, also bound
+ * the magnitude of the field gradient over the ball of radius h
+ * around p.  If grad is non-NULL, accumulate the outward normal
+ * direction at p.
+ */
+static fastf_t
+metaball_accel_eval(const struct metaball_accel *acc, const point_t p, fastf_t h, fastf_t *slope, vect_t grad)
+{
+    const struct bvh_flat_node *stack[METABALL_ACCEL_STACK_SIZE];
+    int stack_ind = 0;
+    fastf_t value = 0.0;
+    fastf_t L = 0.0;
+
+    if (grad)
+	VSETALL(grad, 0.0);
+
+    stack[0] = acc->root;
+    while (stack_ind >= 0) {
+	const struct bvh_flat_node *node = stack[stack_ind--];
+	fastf_t d_sq = 0.0;
+	int i;
+
+	/* distance from p to the node box */
+	for (i = 0; i < 3; i++) {
+	    fastf_t d = 0.0;
+	    if (p[i] < node->bounds[i])
+		d = node->bounds[i] - p[i];
+	    else if (p[i] > node->bounds[i+3])
+		d = p[i] - node->bounds[i+3];
+	    d_sq += d * d;
+	}
+	if (d_sq > h * h)
+	    continue;
+
+	if (node->n_primitives > 0) {
+	    size_t end = node->data.first_prim_offset + node->n_primitives;
+	    size_t j;
+
+	    for (j = node->data.first_prim_offset; j < end; j++) {
+		const struct metaball_ball *b = &acc->balls[j];
+		vect_t v;
+		fastf_t r_sq, r;
+
+		VSUB2(v, p, b->c);
+		r_sq = MAGSQ(v);
+		if (r_sq >= (b->R + h) * (b->R + h))
+		    continue;
+		r = sqrt(r_sq);
+
+		if (slope)
+		    L += metaball_ball_slope(acc, b, r > h ? r - h : 0.0);
+
+		if (r >= b->R)
+		    continue;
+
+		if (acc->method == METABALL_ISOPOTENTIAL) {
+		    value += b->k / r_sq - b->gR;
+		    if (grad)
+			VJOIN1(grad, grad, b->k / (r_sq * r_sq), v);
+		} else {
+		    fastf_t g = exp(b->k - b->a * r_sq);
+		    value += g - b->gR;
+		    if (grad)
+			VJOIN1(grad, grad, 2.0 * b->a * g, v);
+		}
+	    }
+	    continue;
+	}
+
+	if (UNLIKELY(stack_ind + 2 >= METABALL_ACCEL_STACK_SIZE))
+	    bu_bomb("Stack size exceeded in metaball shot");
+	stack[++stack_ind] = node->data.other_child;
+	stack[++stack_ind] = node + 1;
+    }
+
+    if (slope)
+	*slope = L;
+    return value;
+}
+
+
+void
+metaball_accel_norm(const struct metaball_accel *acc, const point_t p, vect_t n)
+{
+    (void)metaball_accel_eval(acc, p, 0.0, NULL, n);
+    VUNITIZE(n);
+}
+
+
+/* refine a threshold crossing between distances a and b along the ray */
+static fastf_t
+metaball_accel_bisect(const struct metaball_accel *acc, const struct xray *rp, fastf_t a, fastf_t b, int a_inside)
+{
+    int i;
+
+    for (i = 0; i < METABALL_ACCEL_MAX_BISECT && b - a > acc->finalstep; i++) {
+	fastf_t mid = 0.5 * (a + b);
+	point_t p;
+
+	VJOIN1(p, rp->r_pt, mid, rp->r_dir);
+	if ((metaball_accel_eval(acc, p, 0.0, NULL, NULL) >= acc->threshold) == a_inside)
+	    a = mid;
+	else
+	    b = mid;
+    }
+    return 0.5 * (a + b);
+}
+
+
+int
+metaball_accel_shot(const struct metaball_accel *acc, struct soltab *stp, struct xray *rp, struct application *ap, struct seg *seghead)
+{
+    const struct bvh_flat_node *root = acc->root;
+    struct seg *segp = NULL;
+    fastf_t t0 = -INFINITY, t1 = INFINITY;
+    fastf_t t, t_prev, h;
+    int inside = 0, nhits = 0, i;
+
+    /* clip the ray to the influence bounds, outside of which the
+     * field is zero */
+    for (i = 0; i < 3; i++) {
+	if (ZERO(rp->r_dir[i])) {
+	    if (rp->r_pt[i] < root->bounds[i] || rp->r_pt[i] > root->bounds[i+3])
+		return 0;
+	} else {
+	    fastf_t ta = (root->bounds[i] - rp->r_pt[i]) / rp->r_dir[i];
+	    fastf_t tb = (root->bounds[i+3] - rp->r_pt[i]) / rp->r_dir[i];
+	    if (ta > tb) {
+		fastf_t swap = ta;
+		ta = tb;
+		tb = swap;
+	    }
+	    if (ta > t0) t0 = ta;
+	    if (tb < t1) t1 = tb;
+	}
+    }
+    if (t0 >= t1)
+	return 0;
+
+    t_prev = t = t0;
+    h = t1 - t0;
+    while (1) {
+	fastf_t value, slope, step;
+	point_t p;
+	int in;
+
+	VJOIN1(p, rp->r_pt, t, rp->r_dir);
+	value = metaball_accel_eval(acc, p, h, &slope, NULL);
+	in = value >= acc->threshold;
+
+	if (in != inside) {
+	    fastf_t dist = metaball_accel_bisect(acc, rp, t_prev, t, inside);
+
+	    if (!inside) {
+		RT_GET_SEG(segp, ap->a_resource);
+		segp->seg_stp = stp;
+		segp->seg_in.hit_dist = dist;
+		VJOIN1(segp->seg_in.hit_point, rp->r_pt, dist, rp->r_dir);
+		segp->seg_in.hit_surfno = 0;
+		BU_LIST_INSERT(&(seghead->l), &(segp->l));
+	    } else {
+		segp->seg_out.hit_dist = dist;
+		VJOIN1(segp->seg_out.hit_point, rp->r_pt, dist, rp->r_dir);
+		segp->seg_out.hit_surfno = 0;
+	    }
+	    inside = in;
+	    nhits++;
+	    if (!inside && ap->a_onehit != 0 && nhits >= abs(ap->a_onehit))
+		break;
+	}
+
+	if (t >= t1)
+	    break;
+
+	/* the field can't reach the threshold within the ball of
+	 * radius h before it has moved |value - threshold| */
+	step = (slope > 0.0) ? fabs(value - acc->threshold) / slope : h;
+	if (step > h)
+	    step = h;
+	if (step < acc->minstep)
+	    step = acc->minstep;
+	if (t + step > t1)
+	    step = t1 - t;
+
+	t_prev = t;
+	t += step;
+	h = 2.0 * step;
+    }
+
+    /* the field is zero on the bounds, but be safe about round-off */
+    if (inside) {
+	segp->seg_out.hit_dist = t1;
+	VJOIN1(segp->seg_out.hit_point, rp->r_pt, t1, rp->r_dir);
+	segp->seg_out.hit_surfno = 0;
+	nhits++;
+    }
+
+    return nhits;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
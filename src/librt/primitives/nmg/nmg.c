@@ -149,6 +149,79 @@ rt_nmg_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 }
 
 
+/**
+ * Save or restore the manifold table built by rt_nmg_prep().  The
+ * table is indexed by the model's element indices, which import
+ * assigns deterministically, so it is only reused for a model with
+ * the same index count.
+ */
+int
+rt_nmg_prep_serialize(struct soltab *stp, const struct rt_db_internal *ip, struct bu_external *external, size_t *version)
+{
+    const size_t current_version = 0;
+    struct rt_prep_stream s;
+    struct model *m;
+    struct nmg_specific *nmg_s;
+    vect_t work;
+
+    RT_CK_SOLTAB(stp);
+    RT_CK_DB_INTERNAL(ip);
+    BU_CK_EXTERNAL(external);
+
+    rt_prep_stream_init(&s, external);
+
+    if (stp->st_specific) {
+	/* export to external */
+	nmg_s = (struct nmg_specific *)stp->st_specific;
+	m = nmg_s->nmg_model;
+	NMG_CK_MODEL(m);
+
+	if (!nmg_s->manifolds || m->maxindex > UINT32_MAX)
+	    return 1;
+
+	rt_prep_put_uint32(&s, (uint32_t)m->maxindex);
+	rt_prep_put_fastf(&s, stp->st_min, 3);
+	rt_prep_put_fastf(&s, stp->st_max, 3);
+	rt_prep_put_bytes(&s, nmg_s->manifolds, m->maxindex);
+
+	rt_prep_stream_finish(&s);
+	*version = current_version;
+	return 0;
+    }
+
+    /* load from external */
+    if (*version != current_version)
+	return 1;
+
+    m = (struct model *)ip->idb_ptr;
+    NMG_CK_MODEL(m);
+
+    if (rt_prep_get_uint32(&s) != m->maxindex)
+	return 1;
+    rt_prep_get_fastf(&s, stp->st_min, 3);
+    rt_prep_get_fastf(&s, stp->st_max, 3);
+    if (s.err || s.pos + m->maxindex != external->ext_nbytes)
+	return 1;
+
+    VADD2SCALE(stp->st_center, stp->st_min, stp->st_max, 0.5);
+    VSUB2SCALE(work, stp->st_max, stp->st_min, 0.5);
+    stp->st_aradius = stp->st_bradius = MAGNITUDE(work);
+
+    BU_GET(nmg_s, struct nmg_specific);
+    stp->st_specific = (void *)nmg_s;
+    nmg_s->nmg_model = m;
+    nmg_s->nmg_smagic = NMG_SPEC_START_MAGIC;
+    nmg_s->nmg_emagic = NMG_SPEC_END_MAGIC;
+    nmg_s->manifolds = (char *)bu_malloc(m->maxindex, "manifold table");
+    rt_prep_get_bytes(&s, nmg_s->manifolds, m->maxindex);
+
+    /* like prep, the solid now owns the model */
+    ((struct rt_db_internal *)ip)->idb_ptr = (void *)NULL;
+
+    return 0;
+}
+
+
 void
 rt_nmg_print(const struct soltab *stp)
 {
@@ -1314,7 +1387,7 @@ rt_nmg_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 
 /* intersection w/ ray */
 {
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     struct ray_data rd;
     int status;
     struct nmg_specific *nmg =
@@ -1457,7 +1530,7 @@ rt_nmg_free(struct soltab *stp)
 int
 rt_nmg_plot(struct bu_list *vhead, struct rt_db_internal *ip, const struct bg_tess_tol *UNUSED(ttol), const struct bn_tol *UNUSED(tol), const struct bview *UNUSED(info))
 {
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     struct model *m;
 
     BU_CK_LIST_HEAD(vhead);
@@ -1767,7 +1840,7 @@ rt_nmg_get(struct bu_vls *logstr, const struct rt_db_internal *intern, const cha
     struct vertex *v;
     struct vertex_g *vg;
     size_t i;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     NMG_CK_MODEL(m);
 
@@ -1879,7 +1952,7 @@ rt_nmg_adjust(struct bu_vls *logstr, struct rt_db_internal *intern, int argc, co
     struct tmp_v *verts;
     fastf_t *tmp;
     struct bn_tol tol;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     RT_CK_DB_INTERNAL(intern);
     m = (struct model *)intern->idb_ptr;
@@ -2088,7 +2161,7 @@ rt_nmg_surf_area(fastf_t *area, const struct rt_db_internal *ip)
 {
     struct model *m;
     struct nmgregion* r;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     /*Iterate through all regions and shells */
     m = (struct model *)ip->idb_ptr;
@@ -2134,7 +2207,7 @@ rt_nmg_centroid(point_t *cent, const struct rt_db_internal *ip)
     point_t arbit_point = VINIT_ZERO;
     size_t num_faces = 0;
     size_t i = 0;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     *cent[0] = 0.0;
     *cent[1] = 0.0;
@@ -2197,7 +2270,7 @@ rt_nmg_volume(fastf_t *volume, const struct rt_db_internal *ip)
 {
     struct model *m;
     struct nmgregion* r;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     /*Iterate through all regions and shells */
     m = (struct model *)ip->idb_ptr;
@@ -2784,7 +2857,7 @@ nmg_to_arb(const struct model *m, struct rt_arb_internal *arb_int)
     int i, j;
     int found;
     int ret_val = 0;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     NMG_CK_MODEL(m);
 
@@ -20,8 +20,13 @@
 
 #include "common.h"
 
+#include <string.h>
+#include "bnetwork.h"
+
+#include "bu/cv.h"
 #include "raytrace.h"
 #include "rt/func.h"
+#include "../librt_private.h"
 
 
 int
@@ -82,6 +87,133 @@ rt_obj_prep_serialize(struct soltab *stp, const struct rt_db_internal *ip, struc
 }
 
 
+void
+rt_prep_stream_init(struct rt_prep_stream *s, struct bu_external *ext)
+{
+    BU_CK_EXTERNAL(ext);
+
+    s->ext = ext;
+    s->pos = 0;
+    s->cap = ext->ext_nbytes;
+    s->err = 0;
+}
+
+
+void
+rt_prep_stream_finish(struct rt_prep_stream *s)
+{
+    s->ext->ext_nbytes = s->pos;
+}
+
+
+static uint8_t *
+prep_stream_extend(struct rt_prep_stream *s, size_t n)
+{
+    uint8_t *dest;
+
+    if (s->pos + n > s->cap) {
+	size_t cap = s->cap ? s->cap : 4096;
+	while (cap < s->pos + n)
+	    cap *= 2;
+	s->ext->ext_buf = (uint8_t *)bu_realloc(s->ext->ext_buf, cap, "prep stream");
+	s->cap = cap;
+    }
+
+    dest = s->ext->ext_buf + s->pos;
+    s->pos += n;
+    return dest;
+}
+
+
+static const uint8_t *
+prep_stream_consume(struct rt_prep_stream *s, size_t n)
+{
+    const uint8_t *src;
+
+    if (s->err || s->pos + n > s->ext->ext_nbytes) {
+	s->err = 1;
+	return NULL;
+    }
+
+    src = s->ext->ext_buf + s->pos;
+    s->pos += n;
+    return src;
+}
+
+
+void
+rt_prep_put_uint32(struct rt_prep_stream *s, uint32_t v)
+{
+    uint32_t nv = htonl(v);
+    memcpy(prep_stream_extend(s, SIZEOF_NETWORK_LONG), &nv, SIZEOF_NETWORK_LONG);
+}
+
+
+void
+rt_prep_put_fastf(struct rt_prep_stream *s, const fastf_t *v, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+	double d = v[i];
+	bu_cv_htond(prep_stream_extend(s, SIZEOF_NETWORK_DOUBLE), (unsigned char *)&d, 1);
+    }
+}
+
+
+void
+rt_prep_put_bytes(struct rt_prep_stream *s, const void *v, size_t n)
+{
+    if (n)
+	memcpy(prep_stream_extend(s, n), v, n);
+}
+
+
+uint32_t
+rt_prep_get_uint32(struct rt_prep_stream *s)
+{
+    uint32_t nv;
+    const uint8_t *src = prep_stream_consume(s, SIZEOF_NETWORK_LONG);
+
+    if (!src)
+	return 0;
+
+    memcpy(&nv, src, SIZEOF_NETWORK_LONG);
+    return ntohl(nv);
+}
+
+
+void
+rt_prep_get_fastf(struct rt_prep_stream *s, fastf_t *v, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+	double d;
+	const uint8_t *src = prep_stream_consume(s, SIZEOF_NETWORK_DOUBLE);
+
+	if (!src) {
+	    v[i] = 0.0;
+	    continue;
+	}
+	bu_cv_ntohd((unsigned char *)&d, (unsigned char *)src, 1);
+	v[i] = d;
+    }
+}
+
+
+void
+rt_prep_get_bytes(struct rt_prep_stream *s, void *v, size_t n)
+{
+    const uint8_t *src = prep_stream_consume(s, n);
+
+    if (src)
+	memcpy(v, src, n);
+    else
+	memset(v, 0, n);
+}
+
+
 /*
  * Local Variables:
  * mode: C
@@ -41,7 +41,7 @@ rt_obj_vshot(struct soltab *stp[], struct xray *rp[], struct seg *segp, int n, s
 	    RT_CK_RAY(rp[i]);
     }
     if (segp)
-	RT_CK_SEG(segp);
+	BU_CK_LIST_HEAD(&segp->l);
     if (ap)
 	RT_CK_APPLICATION(ap);
 
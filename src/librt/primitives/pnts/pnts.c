@@ -26,15 +26,19 @@
 #include "common.h"
 
 /* system headers */
+#include <math.h>
 #include "bnetwork.h"
 
 /* common headers */
 #include "bu/cv.h"
+#include "bu/sort.h"
 #include "bn.h"
 
 #include "raytrace.h"
 #include "rt/geom.h"
 #include "vmath.h"
+#include "../../librt_private.h"
+#include "../../cut_hlbvh.h" /* for hlbvh functions */
 
 
 extern int rt_ell_plot(struct bu_list *, struct rt_db_internal *, const struct bg_tess_tol *, const struct bn_tol *, const struct bview *);
@@ -126,7 +130,7 @@ rt_pnts_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
 	    point_scale = (struct pnt_scale *)pnts->point;
 	    head = &point_scale->l;
 	    for (BU_LIST_FOR(point_scale, pnt_scale, head)) {
-		_pnts_calc_bbox(min, max, &(point_scale->v), pnts->scale);
+		_pnts_calc_bbox(min, max, &(point_scale->v), point_scale->s > 0 ? point_scale->s : pnts->scale);
 	    }
 	    break;
 	case RT_PNT_TYPE_NRM:
@@ -140,7 +144,7 @@ rt_pnts_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
 	    point_color_scale = (struct pnt_color_scale *)pnts->point;
 	    head = &point_color_scale->l;
 	    for (BU_LIST_FOR(point_color_scale, pnt_color_scale, head)) {
-		_pnts_calc_bbox(min, max, &(point_color_scale->v), pnts->scale);
+		_pnts_calc_bbox(min, max, &(point_color_scale->v), point_color_scale->s > 0 ? point_color_scale->s : pnts->scale);
 	    }
 	    break;
 	case RT_PNT_TYPE_COL_NRM:
@@ -154,14 +158,14 @@ rt_pnts_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
 	    point_scale_normal = (struct pnt_scale_normal *)pnts->point;
 	    head = &point_scale_normal->l;
 	    for (BU_LIST_FOR(point_scale_normal, pnt_scale_normal, head)) {
-		_pnts_calc_bbox(min, max, &(point_scale_normal->v), pnts->scale);
+		_pnts_calc_bbox(min, max, &(point_scale_normal->v), point_scale_normal->s > 0 ? point_scale_normal->s : pnts->scale);
 	    }
 	    break;
 	case RT_PNT_TYPE_COL_SCA_NRM:
 	    point_color_scale_normal = (struct pnt_color_scale_normal *)pnts->point;
 	    head = &point_color_scale_normal->l;
 	    for (BU_LIST_FOR(point_color_scale_normal, pnt_color_scale_normal, head)) {
-		_pnts_calc_bbox(min, max, &(point_color_scale_normal->v), pnts->scale);
+		_pnts_calc_bbox(min, max, &(point_color_scale_normal->v), point_color_scale_normal->s > 0 ? point_color_scale_normal->s : pnts->scale);
 	    }
 	    break;
 	default:
@@ -171,16 +175,241 @@ rt_pnts_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
     return 0;
 }
 
+#define PNTS_MAX_PRIMS_IN_NODE 8
+#define PNTS_STACK_SIZE 256
+#define PNTS_MIN_DN 1.0e-9
+
+
+/**
+ * One splat of the raytraced point cloud.  A point with a normal is
+ * an oriented disc of radius r, a point without one is a sphere.
+ */
+struct pnts_splat {
+    point_t v;
+    vect_t n;		/* unit normal, zero for a sphere */
+    fastf_t r;
+};
+
+
+struct pnts_specific {
+    size_t count;
+    struct pnts_splat *splats;	/* in BVH leaf order */
+    struct bvh_flat_node *root;
+    fastf_t half_thick;		/* half thickness of the disc splats */
+};
+
+
+/* one splat interval along a ray, or several merged together */
+struct pnts_hit {
+    fastf_t in;
+    fastf_t out;
+    const struct pnts_splat *in_splat;
+    const struct pnts_splat *out_splat;
+};
+
+
+struct pnts_hit_da {
+    size_t count;
+    size_t capacity;
+    struct pnts_hit *items;
+};
+
+
+static THREADLOCAL struct pnts_hit_da pnts_hits = {0, 0, NULL};
+
+
+/**
+ * Fetch the position, scale and normal of the point at lp, whatever
+ * the point type of the collection.  Missing values are zeroed.
+ */
+static void
+pnts_get_point(const struct rt_pnts_internal *pnts, const struct bu_list *lp, point_t v, fastf_t *s, vect_t n)
+{
+    *s = 0.0;
+    VSETALL(n, 0.0);
+
+    switch (pnts->type) {
+	case RT_PNT_TYPE_PNT:
+	    VMOVE(v, ((const struct pnt *)lp)->v);
+	    break;
+	case RT_PNT_TYPE_COL:
+	    VMOVE(v, ((const struct pnt_color *)lp)->v);
+	    break;
+	case RT_PNT_TYPE_SCA:
+	    VMOVE(v, ((const struct pnt_scale *)lp)->v);
+	    *s = ((const struct pnt_scale *)lp)->s;
+	    break;
+	case RT_PNT_TYPE_NRM:
+	    VMOVE(v, ((const struct pnt_normal *)lp)->v);
+	    VMOVE(n, ((const struct pnt_normal *)lp)->n);
+	    break;
+	case RT_PNT_TYPE_COL_SCA:
+	    VMOVE(v, ((const struct pnt_color_scale *)lp)->v);
+	    *s = ((const struct pnt_color_scale *)lp)->s;
+	    break;
+	case RT_PNT_TYPE_COL_NRM:
+	    VMOVE(v, ((const struct pnt_color_normal *)lp)->v);
+	    VMOVE(n, ((const struct pnt_color_normal *)lp)->n);
+	    break;
+	case RT_PNT_TYPE_SCA_NRM:
+	    VMOVE(v, ((const struct pnt_scale_normal *)lp)->v);
+	    *s = ((const struct pnt_scale_normal *)lp)->s;
+	    VMOVE(n, ((const struct pnt_scale_normal *)lp)->n);
+	    break;
+	case RT_PNT_TYPE_COL_SCA_NRM:
+	    VMOVE(v, ((const struct pnt_color_scale_normal *)lp)->v);
+	    *s = ((const struct pnt_color_scale_normal *)lp)->s;
+	    VMOVE(n, ((const struct pnt_color_scale_normal *)lp)->n);
+	    break;
+	default:
+	    VSETALL(v, 0.0);
+	    break;
+    }
+}
+
+
+/**
+ * Splat radius for points that carry no scale of their own and sit
+ * in a collection without one either.  Discs of this radius add up
+ * to the surface area of the bounding box of the points, which
+ * covers a scanned surface with some overlap to spare.
+ */
+static fastf_t
+pnts_default_radius(const struct rt_pnts_internal *pnts, const struct bn_tol *tol)
+{
+    point_t min, max;
+    vect_t diag;
+    struct bu_list *head, *lp;
+    fastf_t area, s;
+    vect_t n;
+    point_t v;
+
+    VSETALL(min, INFINITY);
+    VSETALL(max, -INFINITY);
+    head = &((struct pnt *)pnts->point)->l;
+    for (lp = head->forw; lp != head; lp = lp->forw) {
+	pnts_get_point(pnts, lp, v, &s, n);
+	VMINMAX(min, max, v);
+    }
+    VSUB2(diag, max, min);
+    area = 2.0 * (diag[X]*diag[Y] + diag[Y]*diag[Z] + diag[Z]*diag[X]);
+    s = sqrt(area / (M_PI * pnts->count));
+
+    return (s > tol->dist) ? s : tol->dist;
+}
+
+
+/**
+ * Given a pointer to a GED database record, build the splats of the
+ * point collection and a BVH over them.
+ *
+ * Returns -
+ * 0 pnts is OK
+ * !0 Error in description
+ *
+ * Implicit return -
+ * A struct pnts_specific is created, and its address is stored in
+ * stp->st_specific for use by rt_pnts_shot().
+ */
 int
 rt_pnts_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 {
     struct rt_pnts_internal *pnts_ip;
+    struct pnts_specific *pnts;
+    struct pnts_splat *splats;
+    struct bn_tol defaults = BN_TOL_INIT_TOL;
+    struct bn_tol *tolp;
+    struct bu_list *head, *lp;
+    struct bu_pool *pool;
+    struct bvh_build_node *build_root;
+    fastf_t *centroids, *bounds;
+    fastf_t default_radius = 0.0;
+    long nodes_created = 0;
+    long *ordered_prims = NULL;
+    size_t i;
 
     RT_CK_DB_INTERNAL(ip);
     pnts_ip = (struct rt_pnts_internal *)ip->idb_ptr;
     RT_PNTS_CK_MAGIC(pnts_ip);
 
-    if (rt_pnts_bbox(ip, &(stp->st_min), &(stp->st_max), &(rtip->rti_tol))) return 1;
+    if (pnts_ip->count <= 0 || !pnts_ip->point)
+	return 1;
+
+    if (rtip) {
+	tolp = &rtip->rti_tol;
+    } else {
+	rt_tol_default(&defaults);
+	tolp = &defaults;
+    }
+
+    /* flatten the point list into splats */
+    splats = (struct pnts_splat *)bu_malloc(pnts_ip->count * sizeof(struct pnts_splat), "pnts splats");
+    centroids = (fastf_t *)bu_malloc(pnts_ip->count * sizeof(fastf_t) * 3, "pnts centroids");
+    bounds = (fastf_t *)bu_malloc(pnts_ip->count * sizeof(fastf_t) * 6, "pnts bounds");
+
+    i = 0;
+    head = &((struct pnt *)pnts_ip->point)->l;
+    for (lp = head->forw; lp != head && i < pnts_ip->count; lp = lp->forw, i++) {
+	struct pnts_splat *sp = &splats[i];
+	fastf_t s;
+
+	pnts_get_point(pnts_ip, lp, sp->v, &s, sp->n);
+	if (s <= 0.0)
+	    s = pnts_ip->scale;
+	if (s <= 0.0) {
+	    if (default_radius <= 0.0)
+		default_radius = pnts_default_radius(pnts_ip, tolp);
+	    s = default_radius;
+	}
+	sp->r = s;
+
+	if (MAGSQ(sp->n) > SMALL_FASTF) {
+	    VUNITIZE(sp->n);
+	} else {
+	    VSETALL(sp->n, 0.0);
+	}
+
+	VMOVE(&centroids[i*3], sp->v);
+	VSETALL(&bounds[i*6+0], -s);
+	VSETALL(&bounds[i*6+3], s);
+	VADD2(&bounds[i*6+0], &bounds[i*6+0], sp->v);
+	VADD2(&bounds[i*6+3], &bounds[i*6+3], sp->v);
+    }
+    if (i != pnts_ip->count) {
+	bu_log("rt_pnts_prep(%s): expected %lu points, found %zu\n",
+	       stp->st_dp ? stp->st_name : "_unnamed_", pnts_ip->count, i);
+	bu_free(splats, "pnts splats");
+	bu_free(centroids, "pnts centroids");
+	bu_free(bounds, "pnts bounds");
+	return 1;
+    }
+
+    pool = hlbvh_init_pool(pnts_ip->count);
+    build_root = hlbvh_create(PNTS_MAX_PRIMS_IN_NODE, pool, centroids, bounds, &nodes_created,
+			      pnts_ip->count, &ordered_prims);
+    bu_free(centroids, "pnts centroids");
+    bu_free(bounds, "pnts bounds");
+
+    BU_GET(pnts, struct pnts_specific);
+    pnts->count = pnts_ip->count;
+    pnts->root = hlbvh_flatten(build_root, nodes_created);
+    pnts->half_thick = tolp->dist;
+    bu_pool_delete(pool);
+
+    /* store the splats in the order the BVH leaves reference them */
+    pnts->splats = (struct pnts_splat *)bu_malloc(pnts->count * sizeof(struct pnts_splat), "pnts ordered splats");
+    for (i = 0; i < pnts->count; i++)
+	pnts->splats[i] = splats[ordered_prims[i]];
+    bu_free(ordered_prims, "ordered prims");
+    bu_free(splats, "pnts splats");
+
+    stp->st_specific = (void *)pnts;
+
+    VMOVE(stp->st_min, &pnts->root->bounds[0]);
+    VMOVE(stp->st_max, &pnts->root->bounds[3]);
+
+    /* zero thickness will get missed by the raytracer */
+    BBOX_NONDEGEN(stp->st_min, stp->st_max, tolp->dist);
 
     /* Compute bounding sphere which contains the bounding RPP.*/
     {
@@ -200,6 +429,289 @@ rt_pnts_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     return 0;
 }
 
+
+static void
+pnts_hit_append(struct pnts_hit_da *hits, fastf_t in, fastf_t out, const struct pnts_splat *sp)
+{
+    struct pnts_hit *h;
+
+    if (hits->count >= hits->capacity) {
+	hits->capacity = hits->capacity ? hits->capacity * 2 : 128;
+	hits->items = (struct pnts_hit *)bu_realloc(hits->items, hits->capacity * sizeof(struct pnts_hit), "pnts hits");
+    }
+    h = &hits->items[hits->count++];
+    h->in = in;
+    h->out = out;
+    h->in_splat = h->out_splat = sp;
+}
+
+
+/**
+ * Intersect the ray with the splats of the leaves of the BVH it
+ * passes through, appending one interval per splat hit.
+ */
+static void
+pnts_shot_bvh(const struct pnts_specific *pnts, struct xray *rp, struct pnts_hit_da *hits)
+{
+    const struct bvh_flat_node *stack_node[PNTS_STACK_SIZE];
+    unsigned char stack_child_index[PNTS_STACK_SIZE];
+    int stack_ind = 0;
+    vect_t inverse_r_dir;
+
+    stack_node[stack_ind] = pnts->root;
+    stack_child_index[stack_ind] = 0;
+    VINVDIR(inverse_r_dir, rp->r_dir);
+
+    while (stack_ind >= 0) {
+	const struct bvh_flat_node *node;
+
+	if (UNLIKELY(stack_ind >= PNTS_STACK_SIZE))
+	    bu_bomb("Stack size exceeded in pnts shot");
+
+	if (stack_child_index[stack_ind] >= 2) {
+	    stack_ind--;
+	    continue;
+	}
+	node = stack_node[stack_ind];
+
+	/* check bounds if it's the first time in this node */
+	if (!stack_child_index[stack_ind]) {
+	    point_t lows_t, highs_t, low_ts, high_ts;
+	    fastf_t low_t, high_t;
+
+	    VSUB2(lows_t, &node->bounds[0], rp->r_pt);
+	    VSUB2(highs_t, &node->bounds[3], rp->r_pt);
+	    VELMUL(lows_t, lows_t, inverse_r_dir);
+	    VELMUL(highs_t, highs_t, inverse_r_dir);
+	    VMOVE(low_ts, lows_t);
+	    VMOVE(high_ts, lows_t);
+	    VMINMAX(low_ts, high_ts, highs_t);
+
+	    high_t = FMIN(high_ts[0], FMIN(high_ts[1], high_ts[2]));
+	    low_t = FMAX(low_ts[0], FMAX(low_ts[1], low_ts[2]));
+
+	    /* splats entirely behind the ray start can't contribute */
+	    if (high_t < 0.0 || low_t > high_t) {
+		stack_ind--;
+		continue;
+	    }
+	}
+
+	if (node->n_primitives > 0) {
+	    size_t end = node->data.first_prim_offset + node->n_primitives;
+	    size_t i;
+
+	    BU_ASSERT(end <= pnts->count);
+	    for (i = node->data.first_prim_offset; i < end; i++) {
+		const struct pnts_splat *sp = &pnts->splats[i];
+		vect_t w;
+
+		VSUB2(w, sp->v, rp->r_pt);
+
+		if (ZERO(sp->n[X]) && ZERO(sp->n[Y]) && ZERO(sp->n[Z])) {
+		    /* sphere */
+		    fastf_t b = VDOT(w, rp->r_dir);
+		    fastf_t root = b * b - (MAGSQ(w) - sp->r * sp->r);
+
+		    if (root <= 0.0)
+			continue;
+		    root = sqrt(root);
+		    pnts_hit_append(hits, b - root, b + root, sp);
+		} else {
+		    /* disc, given a small thickness so it yields a segment */
+		    fastf_t dn = VDOT(sp->n, rp->r_dir);
+		    fastf_t abs_dn = dn >= 0.0 ? dn : -dn;
+		    fastf_t t, half;
+		    point_t pt;
+		    vect_t d;
+
+		    if (abs_dn < PNTS_MIN_DN)
+			continue;
+
+		    t = VDOT(w, sp->n) / dn;
+		    VJOIN1(pt, rp->r_pt, t, rp->r_dir);
+		    VSUB2(d, pt, sp->v);
+		    if (MAGSQ(d) > sp->r * sp->r)
+			continue;
+
+		    half = pnts->half_thick / abs_dn;
+		    if (half > sp->r)
+			half = sp->r;
+		    pnts_hit_append(hits, t - half, t + half, sp);
+		}
+	    }
+	    stack_ind--;
+	    continue;
+	}
+
+	/* we hit the bounds and are not in a leaf, do the next child */
+	stack_node[stack_ind+1] = (stack_child_index[stack_ind]) ? (node->data.other_child) : (node + 1);
+	stack_child_index[stack_ind] += 1;
+	stack_child_index[stack_ind+1] = 0;
+	stack_ind++;
+    }
+}
+
+
+static int
+pnts_hit_compare(const void *a, const void *b, void *UNUSED(context))
+{
+    const struct pnts_hit *ha = (const struct pnts_hit *)a;
+    const struct pnts_hit *hb = (const struct pnts_hit *)b;
+
+    if (ha->in < hb->in)
+	return -1;
+    if (ha->in > hb->in)
+	return 1;
+    return 0;
+}
+
+
+/**
+ * Intersect a ray with a pnts.  Splat intervals that overlap along
+ * the ray are merged, and one struct seg is acquired and filled in
+ * for each resulting interval.
+ *
+ * Notes for rt_pnts_norm(): hit_private points to the pnts_splat
+ * that was hit, hit_vpriv[X] is -1 for an entry and +1 for an exit.
+ *
+ * Returns -
+ * 0 MISS
+ * >0 HIT
+ */
+int
+rt_pnts_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct seg *seghead)
+{
+    struct pnts_specific *pnts = (struct pnts_specific *)stp->st_specific;
+    struct pnts_hit *hits;
+    struct pnts_hit cur;
+    size_t i, nseg = 0;
+
+    if (UNLIKELY(!pnts || !pnts->root))
+	return 0;
+
+    pnts_hits.count = 0; /* new ray, new result count */
+    pnts_shot_bvh(pnts, rp, &pnts_hits);
+    if (pnts_hits.count == 0)
+	return 0;
+
+    hits = pnts_hits.items;
+    bu_sort(hits, pnts_hits.count, sizeof(struct pnts_hit), pnts_hit_compare, NULL);
+
+    cur = hits[0];
+    for (i = 1; i <= pnts_hits.count; i++) {
+	struct seg *segp;
+
+	if (i < pnts_hits.count && hits[i].in <= cur.out) {
+	    if (hits[i].out > cur.out) {
+		cur.out = hits[i].out;
+		cur.out_splat = hits[i].out_splat;
+	    }
+	    continue;
+	}
+
+	RT_GET_SEG(segp, ap->a_resource);
+	segp->seg_stp = stp;
+
+	segp->seg_in.hit_dist = cur.in;
+	segp->seg_in.hit_private = (void *)cur.in_splat;
+	segp->seg_in.hit_surfno = (int)(cur.in_splat - pnts->splats);
+	segp->seg_in.hit_vpriv[X] = -1.0;
+	segp->seg_in.hit_rayp = rp;
+
+	segp->seg_out.hit_dist = cur.out;
+	segp->seg_out.hit_private = (void *)cur.out_splat;
+	segp->seg_out.hit_surfno = (int)(cur.out_splat - pnts->splats);
+	segp->seg_out.hit_vpriv[X] = 1.0;
+	segp->seg_out.hit_rayp = rp;
+
+	BU_LIST_INSERT(&(seghead->l), &(segp->l));
+	nseg++;
+
+	if (i < pnts_hits.count)
+	    cur = hits[i];
+    }
+
+    return (int)nseg;
+}
+
+
+/**
+ * Given ONE ray distance, return the normal and entry/exit point.
+ */
+void
+rt_pnts_norm(struct hit *hitp, struct soltab *UNUSED(stp), struct xray *rp)
+{
+    const struct pnts_splat *sp = (const struct pnts_splat *)hitp->hit_private;
+
+    VJOIN1(hitp->hit_point, rp->r_pt, hitp->hit_dist, rp->r_dir);
+
+    if (ZERO(sp->n[X]) && ZERO(sp->n[Y]) && ZERO(sp->n[Z])) {
+	VSUB2(hitp->hit_normal, hitp->hit_point, sp->v);
+	VSCALE(hitp->hit_normal, hitp->hit_normal, 1.0 / sp->r);
+	return;
+    }
+
+    /* a disc faces against the ray on entry and along it on exit */
+    VMOVE(hitp->hit_normal, sp->n);
+    if (VDOT(sp->n, rp->r_dir) * hitp->hit_vpriv[X] < 0.0) {
+	VREVERSE(hitp->hit_normal, hitp->hit_normal);
+    }
+}
+
+
+/**
+ * Return the UV coordinates of the hit on its splat: azimuth and
+ * elevation for a sphere, the position across the square the disc is
+ * inscribed in for a disc.
+ */
+void
+rt_pnts_uv(struct application *ap, struct soltab *UNUSED(stp), struct hit *hitp, struct uvcoord *uvp)
+{
+    const struct pnts_splat *sp = (const struct pnts_splat *)hitp->hit_private;
+    vect_t work;
+    fastf_t r;
+
+    VSUB2(work, hitp->hit_point, sp->v);
+    r = ap->a_rbeam + ap->a_diverge * hitp->hit_dist;
+
+    if (ZERO(sp->n[X]) && ZERO(sp->n[Y]) && ZERO(sp->n[Z])) {
+	VSCALE(work, work, 1.0 / sp->r);
+	uvp->uv_u = bn_atan2(work[Y], work[X]) * M_1_2PI;
+	if (uvp->uv_u < 0)
+	    uvp->uv_u += 1.0;
+	uvp->uv_v = bn_atan2(work[Z], sqrt(work[X] * work[X] + work[Y] * work[Y])) * M_1_PI + 0.5;
+	uvp->uv_du = uvp->uv_dv = M_1_2PI * r / sp->r;
+    } else {
+	vect_t u_axis, v_axis;
+
+	bn_vec_ortho(u_axis, sp->n);
+	VCROSS(v_axis, sp->n, u_axis);
+	uvp->uv_u = 0.5 + VDOT(work, u_axis) / (2.0 * sp->r);
+	uvp->uv_v = 0.5 + VDOT(work, v_axis) / (2.0 * sp->r);
+	uvp->uv_du = uvp->uv_dv = r / (2.0 * sp->r);
+    }
+
+    CLAMP(uvp->uv_u, 0.0, 1.0);
+    CLAMP(uvp->uv_v, 0.0, 1.0);
+}
+
+
+void
+rt_pnts_free(struct soltab *stp)
+{
+    struct pnts_specific *pnts = (struct pnts_specific *)stp->st_specific;
+
+    if (!pnts)
+	return;
+
+    bu_free(pnts->splats, "pnts ordered splats");
+    bu_free(pnts->root, "bvh flat nodes");
+    BU_PUT(pnts, struct pnts_specific);
+    stp->st_specific = NULL;
+}
+
+
 /**
  * Export a pnts collection from the internal structure to the
  * database format
@@ -891,71 +1403,20 @@ rt_pnts_ifree(struct rt_db_internal *internal)
 void
 rt_pnts_print(register const struct soltab *stp)
 {
-    register struct rt_pnts_internal *pnts;
-
-    pnts = (struct rt_pnts_internal *)stp->st_specific;
-    RT_PNTS_CK_MAGIC(pnts);
-
-    switch (pnts->type) {
-	case RT_PNT_TYPE_PNT: {
-	    register struct pnt *point;
-	    for (BU_LIST_FOR(point, pnt, &(((struct pnt *)pnts->point)->l))) {
-	    }
+    const struct pnts_specific *pnts = (const struct pnts_specific *)stp->st_specific;
+    size_t i, discs = 0;
 
-	    break;
-	}
-	case RT_PNT_TYPE_COL: {
-	    register struct pnt_color *point;
-	    for (BU_LIST_FOR(point, pnt_color, &(((struct pnt_color *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_SCA: {
-	    register struct pnt_scale *point;
-	    for (BU_LIST_FOR(point, pnt_scale, &(((struct pnt_scale *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_NRM: {
-	    register struct pnt_normal *point;
-	    for (BU_LIST_FOR(point, pnt_normal, &(((struct pnt_normal *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_COL_SCA: {
-	    register struct pnt_color_scale *point;
-	    for (BU_LIST_FOR(point, pnt_color_scale, &(((struct pnt_color_scale *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_COL_NRM: {
-	    register struct pnt_color_normal *point;
-	    for (BU_LIST_FOR(point, pnt_color_normal, &(((struct pnt_color_normal *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_SCA_NRM: {
-	    register struct pnt_scale_normal *point;
-	    for (BU_LIST_FOR(point, pnt_scale_normal, &(((struct pnt_scale_normal *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_COL_SCA_NRM: {
-	    register struct pnt_color_scale_normal *point;
-	    for (BU_LIST_FOR(point, pnt_color_scale_normal, &(((struct pnt_color_scale_normal *)pnts->point)->l))) {
-	    }
+    if (!pnts) {
+	bu_log("pnts: not prepped\n");
+	return;
+    }
 
-	    break;
-	}
-	default:
-	    bu_log("ERROR: unknown points primitive type (type=%d)\n", pnts->type);
+    for (i = 0; i < pnts->count; i++) {
+	if (!ZERO(pnts->splats[i].n[X]) || !ZERO(pnts->splats[i].n[Y]) || !ZERO(pnts->splats[i].n[Z]))
+	    discs++;
     }
+    bu_log("pnts: %zu splats, %zu discs and %zu spheres, disc thickness %g\n",
+	   pnts->count, discs, pnts->count - discs, 2.0 * pnts->half_thick);
 }
 
 
@@ -976,7 +1437,7 @@ rt_pnts_plot(struct bu_list *vhead, struct rt_db_internal *internal, const struc
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(internal);
 
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     pnts = (struct rt_pnts_internal *)internal->idb_ptr;
     RT_PNTS_CK_MAGIC(pnts);
 
@@ -655,9 +655,9 @@ rt_rec_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 }
 
 
-#define RT_REC_SEG_MISS(SEG)		(SEG).seg_stp=(struct soltab *) 0;
 /**
- * This is the Becker vector version
+ * Vectorized entry point, intersecting each ray/right elliptical cylinder pair with
+ * rt_rec_shot() so that both paths always agree.
  */
 void
 rt_rec_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struct application *ap)
@@ -667,118 +667,18 @@ rt_rec_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, str
     /* Number of ray/object pairs */
 
 {
+    struct seg seghead;
     int i;
-    struct rec_specific *rec;
-    vect_t dprime;		/* D' */
-    vect_t pprime;		/* P' */
-    fastf_t k1, k2;		/* distance constants of solution */
-    vect_t xlated;		/* translated vector */
-    struct hit hits[4] = {RT_HIT_INIT_ZERO, RT_HIT_INIT_ZERO, RT_HIT_INIT_ZERO, RT_HIT_INIT_ZERO};	/* 4 potential hit points */
-    struct hit *hitp;	/* pointer to hit point */
-    fastf_t b;		/* coeff of polynomial */
-    fastf_t root;		/* root of radical */
-    fastf_t dx2dy2;
-
-    /* FIXME: this vectorized version logic is now substantially out
-     * of sync with the non-vectorized implementation.
-     */
 
-    if (ap) RT_CK_APPLICATION(ap);
+    if (!stp || !rp || !segp || !ap)
+	return;
+
+    BU_LIST_INIT(&(seghead.l));
 
-    /* for each ray/right_elliptical_cylinder pair */
     for (i = 0; i < n; i++) {
 	if (stp[i] == 0) continue; /* stp[i] == 0 signals skip ray */
-
-	rec = (struct rec_specific *)stp[i]->st_specific;
-	hitp = &hits[0];
-
-	/* out, Mat, vect */
-	MAT4X3VEC(dprime, rec->rec_SoR, rp[i]->r_dir);
-	VSUB2(xlated, rp[i]->r_pt, rec->rec_V);
-	MAT4X3VEC(pprime, rec->rec_SoR, xlated);
-
-	if (ZERO(dprime[X]) && ZERO(dprime[Y]))
-	    goto check_plates;
-
-	/* Find roots of eqn, using formula for quadratic w/ a=1 */
-	b = 2 * (dprime[X]*pprime[X] + dprime[Y]*pprime[Y]) *
-	    (dx2dy2 = 1 / (dprime[X]*dprime[X] + dprime[Y]*dprime[Y]));
-	root = b*b - 4 * dx2dy2 *
-	    (pprime[X]*pprime[X] + pprime[Y]*pprime[Y] - 1);
-	if (root < SMALL_FASTF)
-	    goto check_plates;
-
-	root = sqrt(root);
-	k1 = (root-b) * 0.5;
-	k2 = (root+b) * (-0.5);
-
-	/*
-	 * k1 and k2 are potential solutions to intersection with side.
-	 * See if they fall in range.
-	 */
-	VJOIN1(hitp->hit_vpriv, pprime, k1, dprime);	/* hit' */
-	if (hitp->hit_vpriv[Z] >= 0.0 && hitp->hit_vpriv[Z] <= 1.0) {
-	    hitp->hit_dist = k1;
-	    hitp->hit_surfno = REC_NORM_BODY;	/* compute N */
-	    hitp++;
-	}
-
-	VJOIN1(hitp->hit_vpriv, pprime, k2, dprime);		/* hit' */
-	if (hitp->hit_vpriv[Z] >= 0.0 && hitp->hit_vpriv[Z] <= 1.0) {
-	    hitp->hit_dist = k2;
-	    hitp->hit_surfno = REC_NORM_BODY;	/* compute N */
-	    hitp++;
-	}
-
-	/*
-	 * Check for hitting the end plates.
-	 */
-    check_plates:
-	if (hitp < &hits[2]  &&  !ZERO(dprime[Z])) {
-	    /* 0 or 1 hits so far, this is worthwhile */
-	    k1 = -pprime[Z] / dprime[Z];	/* bottom plate */
-	    k2 = (1.0 - pprime[Z]) / dprime[Z];	/* top plate */
-
-	    VJOIN1(hitp->hit_vpriv, pprime, k1, dprime);/* hit' */
-	    if (hitp->hit_vpriv[X] * hitp->hit_vpriv[X] +
-		hitp->hit_vpriv[Y] * hitp->hit_vpriv[Y] <= 1.0) {
-		hitp->hit_dist = k1;
-		hitp->hit_surfno = REC_NORM_BOT;	/* -H */
-		hitp++;
-	    }
-
-	    VJOIN1(hitp->hit_vpriv, pprime, k2, dprime);/* hit' */
-	    if (hitp->hit_vpriv[X] * hitp->hit_vpriv[X] +
-		hitp->hit_vpriv[Y] * hitp->hit_vpriv[Y] <= 1.0) {
-		hitp->hit_dist = k2;
-		hitp->hit_surfno = REC_NORM_TOP;	/* +H */
-		hitp++;
-	    }
-	}
-
-	if (hitp != &hits[2]) {
-	    RT_REC_SEG_MISS(segp[i]);		/* MISS */
-	} else {
-	    segp[i].seg_stp = stp[i];
-
-	    if (hits[0].hit_dist < hits[1].hit_dist) {
-		/* entry is [0], exit is [1] */
-		VMOVE(segp[i].seg_in.hit_vpriv, hits[0].hit_vpriv);
-		segp[i].seg_in.hit_dist = hits[0].hit_dist;
-		segp[i].seg_in.hit_surfno = hits[0].hit_surfno;
-		VMOVE(segp[i].seg_out.hit_vpriv, hits[1].hit_vpriv);
-		segp[i].seg_out.hit_dist = hits[1].hit_dist;
-		segp[i].seg_out.hit_surfno = hits[1].hit_surfno;
-	    } else {
-		/* entry is [1], exit is [0] */
-		VMOVE(segp[i].seg_in.hit_vpriv, hits[1].hit_vpriv);
-		segp[i].seg_in.hit_dist = hits[1].hit_dist;
-		segp[i].seg_in.hit_surfno = hits[1].hit_surfno;
-		VMOVE(segp[i].seg_out.hit_vpriv, hits[0].hit_vpriv);
-		segp[i].seg_out.hit_dist = hits[0].hit_dist;
-		segp[i].seg_out.hit_surfno = hits[0].hit_surfno;
-	    }
-	}
+	(void)rt_rec_shot(stp[i], rp[i], ap, &seghead);
+	rt_vshot_store(&segp[i], &seghead, ap->a_resource);
     }
 }
 
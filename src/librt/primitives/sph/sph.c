@@ -277,9 +277,11 @@ rt_sph_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 }
 
 
-#define RT_SPH_SEG_MISS(SEG)		(SEG).seg_stp=(struct soltab *) 0;
 /**
- * This is the Becker vectorized version
+ * Vectorized version of rt_sph_shot().  Pairs are processed a block
+ * at a time: the quadratic terms are gathered into flat arrays in one
+ * pass, the radicals solved in a second branch-free pass, and only
+ * then are the segments written out.
  */
 void
 rt_sph_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struct application *ap)
@@ -289,50 +291,63 @@ rt_sph_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, str
     /* Number of ray/object pairs */
 
 {
-    register struct sph_specific *sph;
-    register int i;
-
-    vect_t ov;		/* ray origin to center (V - P) */
-    fastf_t magsq_ov;	/* length squared of ov */
-    fastf_t b;		/* second term of quadratic eqn */
-    fastf_t root;		/* root of radical */
+    fastf_t b[RT_VSHOT_BLOCK];		/* second term of quadratic eqn */
+    fastf_t root[RT_VSHOT_BLOCK];	/* root of radical */
+    int hit[RT_VSHOT_BLOCK];
+    int base, m, i;
 
     if (ap) RT_CK_APPLICATION(ap);
 
-    /* for each ray/sphere pair */
-    for (i = 0; i < n; i++) {
-	if (stp[i] == 0) continue; /* stp[i] == 0 signals skip ray */
+    for (base = 0; base < n; base += RT_VSHOT_BLOCK) {
+	struct soltab **bstp = &stp[base];
+	struct xray **brp = &rp[base];
+	struct seg *bsegp = &segp[base];
+
+	m = n - base;
+	if (m > RT_VSHOT_BLOCK)
+	    m = RT_VSHOT_BLOCK;
+
+	/* gather the quadratic for each ray/sphere pair */
+	for (i = 0; i < m; i++) {
+	    const struct sph_specific *sph;
+	    vect_t ov;		/* ray origin to center (V - P) */
+	    fastf_t magsq_ov;	/* length squared of ov */
+
+	    if (bstp[i] == 0) {
+		/* stp[i] == 0 signals skip ray */
+		b[i] = root[i] = 0.0;
+		hit[i] = -1;
+		continue;
+	    }
+	    sph = (const struct sph_specific *)bstp[i]->st_specific;
+	    VSUB2(ov, sph->sph_V, brp[i]->r_pt);
+	    b[i] = VDOT(brp[i]->r_dir, ov);
+	    magsq_ov = MAGSQ(ov);
+	    root[i] = b[i]*b[i] - magsq_ov + sph->sph_radsq;
+
+	    /* origin inside, or outside and heading in with real roots */
+	    hit[i] = magsq_ov < sph->sph_radsq || (b[i] >= 0 && root[i] > 0);
+	}
 
-	sph = (struct sph_specific *)stp[i]->st_specific;
-	VSUB2(ov, sph->sph_V, rp[i]->r_pt);
-	b = VDOT(rp[i]->r_dir, ov);
-	magsq_ov = MAGSQ(ov);
+	/* we know root is positive for every hit */
+	for (i = 0; i < m; i++)
+	    root[i] = sqrt(root[i] > 0.0 ? root[i] : 0.0);
 
-	if (magsq_ov >= sph->sph_radsq) {
-	    /* ray origin is outside of sphere */
-	    if (b < 0) {
-		/* ray direction is away from sphere */
-		RT_SPH_SEG_MISS(segp[i]);		/* No hit */
+	for (i = 0; i < m; i++) {
+	    if (hit[i] < 0)
 		continue;
-	    }
-	    root = b*b - magsq_ov + sph->sph_radsq;
-	    if (root <= 0) {
-		/* no real roots */
-		RT_SPH_SEG_MISS(segp[i]);		/* No hit */
+	    if (!hit[i]) {
+		bsegp[i].seg_stp = RT_SOLTAB_NULL;	/* No hit */
 		continue;
 	    }
-	} else {
-	    root = b*b - magsq_ov + sph->sph_radsq;
-	}
-	root = sqrt(root);
-
-	segp[i].seg_stp = stp[i];
+	    bsegp[i].seg_stp = bstp[i];
 
-	/* we know root is positive, so we know the smaller t */
-	segp[i].seg_in.hit_dist = b - root;
-	segp[i].seg_out.hit_dist = b + root;
-	segp[i].seg_in.hit_surfno = 0;
-	segp[i].seg_out.hit_surfno = 0;
+	    /* we know root is positive, so we know the smaller t */
+	    bsegp[i].seg_in.hit_dist = b[i] - root[i];
+	    bsegp[i].seg_out.hit_dist = b[i] + root[i];
+	    bsegp[i].seg_in.hit_surfno = 0;
+	    bsegp[i].seg_out.hit_surfno = 0;
+	}
     }
 }
 
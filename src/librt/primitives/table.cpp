@@ -774,7 +774,7 @@ const struct rt_functab OBJ[] = {
 	NULL, /* find_selections */
 	NULL, /* evaluate_selection */
 	NULL, /* process_selection */
-	NULL, /* serialize */
+	RTFUNCTAB_FUNC_PREP_SERIALIZE_CAST(rt_nmg_prep_serialize),
 	NULL, /* label */
 	NULL, /* keypoint */
 	RTFUNCTAB_FUNC_MAT_CAST(rt_nmg_mat),
@@ -825,7 +825,7 @@ const struct rt_functab OBJ[] = {
 	NULL, /* find_selections */
 	NULL, /* evaluate_selection */
 	NULL, /* process_selection */
-	NULL, /* serialize */
+	RTFUNCTAB_FUNC_PREP_SERIALIZE_CAST(rt_ebm_prep_serialize),
 	NULL, /* label */
 	RTFUNCTAB_FUNC_KEYPOINT_CAST(rt_ebm_keypoint), /* keypoint */
 	RTFUNCTAB_FUNC_MAT_CAST(rt_ebm_mat),
@@ -876,7 +876,7 @@ const struct rt_functab OBJ[] = {
 	NULL, /* find_selections */
 	NULL, /* evaluate_selection */
 	NULL, /* process_selection */
-	NULL, /* serialize */
+	RTFUNCTAB_FUNC_PREP_SERIALIZE_CAST(rt_vol_prep_serialize),
 	NULL, /* label */
 	RTFUNCTAB_FUNC_KEYPOINT_CAST(rt_vol_keypoint), /* keypoint */
 	RTFUNCTAB_FUNC_MAT_CAST(rt_vol_mat),
@@ -1488,7 +1488,7 @@ const struct rt_functab OBJ[] = {
 	NULL, /* find_selections */
 	NULL, /* evaluate_selection */
 	NULL, /* process_selection */
-	NULL, /* serialize */
+	RTFUNCTAB_FUNC_PREP_SERIALIZE_CAST(rt_dsp_prep_serialize),
 	NULL, /* label */
 	RTFUNCTAB_FUNC_KEYPOINT_CAST(rt_dsp_keypoint), /* keypoint */
 	RTFUNCTAB_FUNC_MAT_CAST(rt_dsp_mat),
@@ -1743,7 +1743,7 @@ const struct rt_functab OBJ[] = {
 	NULL, /* find_selections */
 	NULL, /* evaluate_selection */
 	NULL, /* process_selection */
-	NULL, /* serialize */
+	RTFUNCTAB_FUNC_PREP_SERIALIZE_CAST(rt_bot_prep_serialize),
 	NULL, /* label */
 	RTFUNCTAB_FUNC_KEYPOINT_CAST(rt_bot_keypoint), /* keypoint */
 	RTFUNCTAB_FUNC_MAT_CAST(rt_bot_mat),
@@ -2270,15 +2270,15 @@ const struct rt_functab OBJ[] = {
 	RT_FUNCTAB_MAGIC, "ID_PNTS", "pnts",
 	0,
 	RTFUNCTAB_FUNC_PREP_CAST(rt_pnts_prep),
-	NULL, /* shot */
+	RTFUNCTAB_FUNC_SHOT_CAST(rt_pnts_shot),
 	RTFUNCTAB_FUNC_PRINT_CAST(rt_pnts_print),
-	NULL, /* norm */
+	RTFUNCTAB_FUNC_NORM_CAST(rt_pnts_norm),
 	NULL, /* piece_shot */
 	NULL, /* piece_hitsegs */
-	NULL, /* uv */
+	RTFUNCTAB_FUNC_UV_CAST(rt_pnts_uv),
 	NULL, /* curve */
 	NULL, /* class */
-	NULL, /* free */
+	RTFUNCTAB_FUNC_FREE_CAST(rt_pnts_free),
 	RTFUNCTAB_FUNC_PLOT_CAST(rt_pnts_plot),
 	NULL, /* adaptive_plot */
 	NULL, /* vshot */
@@ -551,49 +551,36 @@ rt_tgc_print(register const struct soltab *stp)
 
 
 /**
- * Intersect a ray with a truncated general cone, where all constant
- * terms have been computed by rt_tgc_prep().
- *
- * NOTE: All lines in this function are represented parametrically by
- * a point, P(Px, Py, Pz) and a unit direction vector, D = iDx + jDy +
- * kDz.  Any point on a line can be expressed by one variable 't',
- * where
- *
- * X = Dx*t + Px,
- * Y = Dy*t + Py,
- * Z = Dz*t + Pz.
- *
- * First, convert the line to the coordinate system of a "standard"
- * cone.  This is a cone whose base lies in the X-Y plane, and whose H
- * (now H') vector is lined up with the Z axis.
- *
- * Then find the equation of that line and the standard cone as an
- * equation in 't'.  Solve the equation using a general polynomial
- * root finder.  Use those values of 't' to compute the points of
- * intersection in the original coordinate system.
+ * Where a ray lands in the space of the standard cone, as computed by
+ * the first stage of rt_tgc_shot().
  */
-int
-rt_tgc_shot(struct soltab *stp, register struct xray *rp, struct application *ap, struct seg *seghead)
+struct tgc_shot_ray {
+    vect_t pprime;
+    vect_t dprime;
+    vect_t cor_pprime;	/* corrected P prime */
+    fastf_t cor_proj;	/* corrected projected dist */
+    fastf_t t_scale;
+    bn_poly_t C;	/* cone equation, a quadratic or a quartic */
+    fastf_t t_max;	/* side roots lie within +-t_max of cor_pprime */
+};
+
+
+/**
+ * First stage of rt_tgc_shot(): convert the ray to the coordinate
+ * system of the standard cone.  Returns 0 if the ray cannot hit.
+ */
+static int
+tgc_shot_setup(struct soltab *stp, const struct xray *rp, struct tgc_shot_ray *tr)
 {
     register const struct tgc_specific *tgc =
 	(struct tgc_specific *)stp->st_specific;
-    register struct seg *segp;
-    vect_t pprime;
-    vect_t dprime;
+    fastf_t *pprime = tr->pprime;
+    fastf_t *dprime = tr->dprime;
+    fastf_t *cor_pprime = tr->cor_pprime;
     vect_t work;
-#define MAX_TGC_HITS 4+2 /* 4 on side cylinder, 1 per end ellipse */
-    fastf_t k[MAX_TGC_HITS] = {0};
-    int hit_type[MAX_TGC_HITS] = {0};
-    fastf_t t, zval, dir;
     fastf_t t_scale;
-    int npts;
-    int intersect;
-    vect_t cor_pprime;	/* corrected P prime */
-    fastf_t cor_proj = 0;	/* corrected projected dist */
+    fastf_t cor_proj = 0;
     int i;
-    bn_poly_t C;	/* final equation */
-    bn_poly_t Xsqr, Ysqr;
-    bn_poly_t R, Rsqr;
 
     /* find rotated point and direction */
     MAT4X3VEC(dprime, tgc->tgc_ScShR, rp->r_dir);
@@ -644,12 +631,31 @@ rt_tgc_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 	}
     }
 
+    tr->cor_proj = cor_proj;
+    tr->t_scale = t_scale;
+    return 1;
+}
+
+
+/**
+ * Second stage of rt_tgc_shot(): the equation of the standard cone
+ * along a ray already in its space.  Equal eccentricities give a
+ * quadratic, anything else a quartic.
+ */
+static void
+tgc_shot_coef(struct soltab *stp, struct tgc_shot_ray *tr)
+{
+    register const struct tgc_specific *tgc =
+	(struct tgc_specific *)stp->st_specific;
+    const fastf_t *dprime = tr->dprime;
+    const fastf_t *cor_pprime = tr->cor_pprime;
+    bn_poly_t *C = &tr->C;	/* final equation */
+    bn_poly_t Xsqr, Ysqr;
+    bn_poly_t R, Rsqr;
+    fastf_t rc, rd;
+
     /* Given a line and the parameters for a standard cone, finds the
-     * roots of the equation for that cone and line.  Returns the
-     * number of real roots found.
-     *
-     * Given a line and the cone parameters, finds the equation of the
-     * cone in terms of the variable 't'.
+     * equation of the cone in terms of the variable 't'.
      *
      * The equation for the cone is:
      *
@@ -686,41 +692,25 @@ rt_tgc_shot(struct soltab *stp, register struct xray *rp, struct application *ap
     Rsqr.cf[1] = R.cf[0] * R.cf[1] * 2.0;
     Rsqr.cf[2] = R.cf[1] * R.cf[1];
 
+    C->magic = BN_POLY_MAGIC;
+
     /* If the eccentricities of the two ellipses are the same, then
      * the cone equation reduces to a much simpler quadratic form.
      * Otherwise it is a (gah!) quartic equation.
      *
      * this can only be done when C.cf[0] is not too small! (JRA)
      */
-    C.cf[0] = Xsqr.cf[0] + Ysqr.cf[0] - Rsqr.cf[0];
-    if (tgc->tgc_AD_CB && !NEAR_ZERO(C.cf[0], RT_PCOEF_TOL)) {
-	fastf_t roots;
-
+    C->cf[0] = Xsqr.cf[0] + Ysqr.cf[0] - Rsqr.cf[0];
+    if (tgc->tgc_AD_CB && !NEAR_ZERO(C->cf[0], RT_PCOEF_TOL)) {
 	/*
 	 * (void) bn_poly_add(&sum, &Xsqr, &Ysqr);
 	 * (void) bn_poly_sub(&C, &sum, &Rsqr);
 	 */
-	C.dgr = 2;
-	C.cf[1] = Xsqr.cf[1] + Ysqr.cf[1] - Rsqr.cf[1];
-	C.cf[2] = Xsqr.cf[2] + Ysqr.cf[2] - Rsqr.cf[2];
-
-	/* Find the real roots the easy way.  C.dgr==2 */
-	if ((roots = C.cf[1]*C.cf[1] - 4.0 * C.cf[0] * C.cf[2]) < 0) {
-	    npts = 0;	/* no real roots */
-	} else {
-	    register fastf_t f;
-	    roots = sqrt(roots);
-	    k[0] = (roots - C.cf[1]) * (f = 0.5 / C.cf[0]);
-	    hit_type[0] = TGC_NORM_BODY;
-	    k[1] = (roots + C.cf[1]) * -f;
-	    hit_type[1] = TGC_NORM_BODY;
-	    npts = 2;
-	}
+	C->dgr = 2;
+	C->cf[1] = Xsqr.cf[1] + Ysqr.cf[1] - Rsqr.cf[1];
+	C->cf[2] = Xsqr.cf[2] + Ysqr.cf[2] - Rsqr.cf[2];
     } else {
 	bn_poly_t Q, Qsqr;
-	bn_complex_t val[MAX_TGC_HITS-2]; /* roots of final equation */
-	register int l;
-	register int nroots;
 
 	Q.dgr = 1;
 	Q.cf[0] = dprime[Z] * tgc->tgc_DdBm1;
@@ -740,61 +730,91 @@ rt_tgc_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 	 * (void) bn_poly_add(&sum, &T1, &T2);
 	 * (void) bn_poly_sub(&C, &sum, &T3);
 	 */
-	C.dgr = 4;
-	C.cf[0] = Qsqr.cf[0] * Xsqr.cf[0] +
+	C->dgr = 4;
+	C->cf[0] = Qsqr.cf[0] * Xsqr.cf[0] +
 	    Rsqr.cf[0] * Ysqr.cf[0] -
 	    (Rsqr.cf[0] * Qsqr.cf[0]);
-	C.cf[1] = Qsqr.cf[0] * Xsqr.cf[1] + Qsqr.cf[1] * Xsqr.cf[0] +
+	C->cf[1] = Qsqr.cf[0] * Xsqr.cf[1] + Qsqr.cf[1] * Xsqr.cf[0] +
 	    Rsqr.cf[0] * Ysqr.cf[1] + Rsqr.cf[1] * Ysqr.cf[0] -
 	    (Rsqr.cf[0] * Qsqr.cf[1] + Rsqr.cf[1] * Qsqr.cf[0]);
-	C.cf[2] = Qsqr.cf[0] * Xsqr.cf[2] + Qsqr.cf[1] * Xsqr.cf[1] +
+	C->cf[2] = Qsqr.cf[0] * Xsqr.cf[2] + Qsqr.cf[1] * Xsqr.cf[1] +
 	    Qsqr.cf[2] * Xsqr.cf[0] +
 	    Rsqr.cf[0] * Ysqr.cf[2] + Rsqr.cf[1] * Ysqr.cf[1] +
 	    Rsqr.cf[2] * Ysqr.cf[0] -
 	    (Rsqr.cf[0] * Qsqr.cf[2] + Rsqr.cf[1] * Qsqr.cf[1] +
 	     Rsqr.cf[2] * Qsqr.cf[0]);
-	C.cf[3] = Qsqr.cf[1] * Xsqr.cf[2] + Qsqr.cf[2] * Xsqr.cf[1] +
+	C->cf[3] = Qsqr.cf[1] * Xsqr.cf[2] + Qsqr.cf[2] * Xsqr.cf[1] +
 	    Rsqr.cf[1] * Ysqr.cf[2] + Rsqr.cf[2] * Ysqr.cf[1] -
 	    (Rsqr.cf[1] * Qsqr.cf[2] + Rsqr.cf[2] * Qsqr.cf[1]);
-	C.cf[4] = Qsqr.cf[2] * Xsqr.cf[2] +
+	C->cf[4] = Qsqr.cf[2] * Xsqr.cf[2] +
 	    Rsqr.cf[2] * Ysqr.cf[2] -
 	    (Rsqr.cf[2] * Qsqr.cf[2]);
+    }
+
+    /* Between the end planes the cone lies within the ellipses of
+     * semi-axes max(1, |C/A|) and max(1, |D/B|), so side hits are
+     * within a sphere about the origin that cor_pprime is the closest
+     * point of the ray to.
+     */
+    rc = FMAX(1.0, fabs(tgc->tgc_CdAm1 + 1.0));
+    rd = FMAX(1.0, fabs(tgc->tgc_DdBm1 + 1.0));
+    tr->t_max = sqrt(rc * rc + rd * rd + 1.0) * (1.0 + 1.0e-9);
+}
 
+
+/**
+ * Third stage of rt_tgc_shot(): take the roots of the side equation,
+ * solved by the caller when it is a quartic, add the end ellipse
+ * hits, and build the segments.
+ */
+static int
+tgc_shot_hits(struct soltab *stp, struct xray *rp, struct application *ap, const struct tgc_shot_ray *tr, const fastf_t roots[], int nroots, struct seg *seghead)
+{
+    register const struct tgc_specific *tgc =
+	(struct tgc_specific *)stp->st_specific;
+    register struct seg *segp;
+    const fastf_t *pprime = tr->pprime;
+    const fastf_t *dprime = tr->dprime;
+    const fastf_t cor_proj = tr->cor_proj;
+    const fastf_t t_scale = tr->t_scale;
+    const bn_poly_t *C = &tr->C;
+    vect_t work;
+#define MAX_TGC_HITS 4+2 /* 4 on side cylinder, 1 per end ellipse */
+    fastf_t k[MAX_TGC_HITS] = {0};
+    int hit_type[MAX_TGC_HITS] = {0};
+    fastf_t t, zval, dir;
+    int npts;
+    int intersect;
+    int i;
+
+    if (C->dgr == 2) {
+	fastf_t disc;
+
+	/* Find the real roots the easy way.  C.dgr==2 */
+	if ((disc = C->cf[1]*C->cf[1] - 4.0 * C->cf[0] * C->cf[2]) < 0) {
+	    npts = 0;	/* no real roots */
+	} else {
+	    register fastf_t f;
+	    disc = sqrt(disc);
+	    k[0] = (disc - C->cf[1]) * (f = 0.5 / C->cf[0]);
+	    hit_type[0] = TGC_NORM_BODY;
+	    k[1] = (disc + C->cf[1]) * -f;
+	    hit_type[1] = TGC_NORM_BODY;
+	    npts = 2;
+	}
+    } else {
 	/* main 'sides' of a TGC (i.e., the cylindrical surface) is a
-	 * quartic equation, so we expect to find 0 to 4 roots.
-	 */
-	nroots = rt_poly_roots(&C, val, stp->st_dp->d_namep);
-
-	/* Retain real roots, ignore the rest.
-	 *
-	 * If the imaginary part is zero or sufficiently close, then
-	 * we pretend it's real since it could be a root solver or
-	 * floating point artifact.  we use rt_poly_root's internal
-	 * tolerance of 1e-5.
+	 * quartic equation, so we expect to find 0 to 4 roots.  Nearly
+	 * real ones, which could be a root solver or floating point
+	 * artifact, come in as double roots.
 	 */
-	for (l=0, npts=0; l < nroots; l++) {
-	    if (NEAR_ZERO(val[l].im, RT_ROOT_TOL)) {
-		hit_type[npts] = TGC_NORM_BODY;
-		k[npts++] = val[l].re;
-	    }
-	}
-
-	/* sane roots? */
-	if (npts > MAX_TGC_HITS-2) {
+	if (nroots > MAX_TGC_HITS-2) {
 	    /* shouldn't be possible, but ensure no overflow */
-	    npts = MAX_TGC_HITS-2;
-	} else if (npts < 0) {
-	    static size_t reported = 0;
-
-	    if (reported < 10) {
-		bu_log("Root solver failed to converge on a solution for %s\n", stp->st_dp->d_namep);
-		/* these are printed in 'mm' regardless of local units */
-		VPRINT("\tshooting point (units mm): ", rp->r_pt);
-		VPRINT("\tshooting direction:        ", rp->r_dir);
-	    } else if (reported == 10) {
-		bu_log("Too many convergence failures.  Suppressing further TGC root finder reports.\n");
-	    }
-	    reported++;
+	    nroots = MAX_TGC_HITS-2;
+	}
+	for (npts = 0; npts < nroots; npts++) {
+	    hit_type[npts] = TGC_NORM_BODY;
+	    k[npts] = roots[npts];
 	}
     }
 
@@ -979,439 +999,105 @@ rt_tgc_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 
 
 /**
- * The Homer vectorized version.
+ * Intersect a ray with a truncated general cone, where all constant
+ * terms have been computed by rt_tgc_prep().
+ *
+ * NOTE: All lines in this function are represented parametrically by
+ * a point, P(Px, Py, Pz) and a unit direction vector, D = iDx + jDy +
+ * kDz.  Any point on a line can be expressed by one variable 't',
+ * where
+ *
+ * X = Dx*t + Px,
+ * Y = Dy*t + Py,
+ * Z = Dz*t + Pz.
+ *
+ * First, convert the line to the coordinate system of a "standard"
+ * cone.  This is a cone whose base lies in the X-Y plane, and whose H
+ * (now H') vector is lined up with the Z axis.
+ *
+ * Then find the equation of that line and the standard cone as an
+ * equation in 't'.  Solve the equation using a general polynomial
+ * root finder.  Use those values of 't' to compute the points of
+ * intersection in the original coordinate system.
  */
-void
-rt_tgc_vshot(struct soltab **stp, register struct xray **rp, struct seg *segp, int n, struct application *ap)
+int
+rt_tgc_shot(struct soltab *stp, register struct xray *rp, struct application *ap, struct seg *seghead)
+{
+    struct tgc_shot_ray tr;
+    fastf_t roots[4];
+    int nroots = 0;
+
+    if (!tgc_shot_setup(stp, rp, &tr))
+	return 0;
+    tgc_shot_coef(stp, &tr);
+    if (tr.C.dgr == 4)
+	nroots = rt_poly_near_real_roots(&tr.C, -tr.t_max, tr.t_max, roots);
+    return tgc_shot_hits(stp, rp, ap, &tr, roots, nroots, seghead);
+}
 
 
+/**
+ * Vectorized version of rt_tgc_shot().  The side equations of a whole
+ * block of ray/cone pairs are built first, and the quartics among
+ * them solved together.
+ */
+void
+rt_tgc_vshot(struct soltab **stp, register struct xray **rp, struct seg *segp, int n, struct application *ap)
 /* array of segs (results returned) */
 /* Number of ray/object pairs */
 
 {
-    register struct tgc_specific *tgc;
-    register int ix;
-    vect_t pprime;
-    vect_t dprime;
-    vect_t work;
-    fastf_t k[4], pt[2];
-    fastf_t t, b, zval, dir;
-    fastf_t t_scale = 0;
-    fastf_t alf1, alf2;
-    int npts;
-    int intersect;
-    vect_t cor_pprime;	/* corrected P prime */
-    fastf_t cor_proj = 0;	/* corrected projected dist */
-    int i;
-    bn_poly_t *C;	/* final equation */
-    bn_poly_t Xsqr, Ysqr;
-    bn_poly_t R, Rsqr;
-
-    VSETALLN(k, 0, 4);
-    VSETALLN(pt, 0, 2);
-
-    if (ap) RT_CK_APPLICATION(ap);
-
-    /* Allocate space for polys and roots */
-    C = (bn_poly_t *)bu_malloc(n * sizeof(bn_poly_t), "tor bn_poly_t");
-
-    /* Initialize seg_stp to assume hit (zero will then flag miss) */
-    for (ix = 0; ix < n; ix++) segp[ix].seg_stp = stp[ix];
-
-    /* for each ray/cone pair */
-    for (ix = 0; ix < n; ix++) {
-	if (segp[ix].seg_stp == 0) continue; /* == 0 signals skip ray */
-
-	tgc = (struct tgc_specific *)stp[ix]->st_specific;
-
-	/* find rotated point and direction */
-	MAT4X3VEC(dprime, tgc->tgc_ScShR, rp[ix]->r_dir);
-
-	/*
-	 * A vector of unit length in model space (r_dir) changes length in
-	 * the special unit-tgc space.  This scale factor will restore
-	 * proper length after hit points are found.
-	 */
-	t_scale = 1/MAGNITUDE(dprime);
-	VSCALE(dprime, dprime, t_scale);	/* VUNITIZE(dprime); */
-
-	if (NEAR_ZERO(dprime[Z], RT_PCOEF_TOL))
-	    dprime[Z] = 0.0;	/* prevent rootfinder heartburn */
-
-	/* Use segp[ix].seg_in.hit_normal as tmp to hold dprime */
-	VMOVE(segp[ix].seg_in.hit_normal, dprime);
-
-	VSUB2(work, rp[ix]->r_pt, tgc->tgc_V);
-	MAT4X3VEC(pprime, tgc->tgc_ScShR, work);
-
-	/* Use segp[ix].seg_out.hit_normal as tmp to hold pprime */
-	VMOVE(segp[ix].seg_out.hit_normal, pprime);
-
-	/* Translating ray origin along direction of ray to closest
-	 * pt. to origin of solids coordinate system, new ray origin
-	 * is 'cor_pprime'.
-	 */
-	cor_proj = VDOT(pprime, dprime);
-	VSCALE(cor_pprime, dprime, cor_proj);
-	VSUB2(cor_pprime, pprime, cor_pprime);
-
-	/*
-	 * Given a line and the parameters for a standard cone, finds
-	 * the roots of the equation for that cone and line.  Returns
-	 * the number of real roots found.
-	 *
-	 * Given a line and the cone parameters, finds the equation of
-	 * the cone in terms of the variable 't'.
-	 *
-	 * The equation for the cone is:
-	 *
-	 * X**2 * Q**2 + Y**2 * R**2 - R**2 * Q**2 = 0
-	 *
-	 * where:
-	 * R = a + ((c - a)/|H'|)*Z
-	 * Q = b + ((d - b)/|H'|)*Z
-	 *
-	 * First, find X, Y, and Z in terms of 't' for this line, then
-	 * substitute them into the equation above.
-	 *
-	 * Express each variable (X, Y, and Z) as a linear equation in
-	 * 'k', e.g., (dprime[X] * k) + cor_pprime[X], and substitute
-	 * into the cone equation.
-	 */
-	Xsqr.dgr = 2;
-	Xsqr.cf[0] = dprime[X] * dprime[X];
-	Xsqr.cf[1] = 2.0 * dprime[X] * cor_pprime[X];
-	Xsqr.cf[2] = cor_pprime[X] * cor_pprime[X];
-
-	Ysqr.dgr = 2;
-	Ysqr.cf[0] = dprime[Y] * dprime[Y];
-	Ysqr.cf[1] = 2.0 * dprime[Y] * cor_pprime[Y];
-	Ysqr.cf[2] = cor_pprime[Y] * cor_pprime[Y];
-
-	R.dgr = 1;
-	R.cf[0] = dprime[Z] * tgc->tgc_CdAm1;
-	/* A vector is unitized (tgc->tgc_A == 1.0) */
-	R.cf[1] = (cor_pprime[Z] * tgc->tgc_CdAm1) + 1.0;
-
-	/* (void) bn_poly_mul(&Rsqr, &R, &R); manual expansion: */
-	Rsqr.dgr = 2;
-	Rsqr.cf[0] = R.cf[0] * R.cf[0];
-	Rsqr.cf[1] = R.cf[0] * R.cf[1] * 2;
-	Rsqr.cf[2] = R.cf[1] * R.cf[1];
-
-	/*
-	 * If the eccentricities of the two ellipses are the same,
-	 * then the cone equation reduces to a much simpler quadratic
-	 * form.  Otherwise it is a (gah!) quartic equation.
-	 */
-	if (tgc->tgc_AD_CB) {
-	    /* (void) bn_poly_add(&sum, &Xsqr, &Ysqr); and */
-	    /* (void) bn_poly_sub(&C, &sum, &Rsqr); manual expansion: */
-	    C[ix].dgr = 2;
-	    C[ix].cf[0] = Xsqr.cf[0] + Ysqr.cf[0] - Rsqr.cf[0];
-	    C[ix].cf[1] = Xsqr.cf[1] + Ysqr.cf[1] - Rsqr.cf[1];
-	    C[ix].cf[2] = Xsqr.cf[2] + Ysqr.cf[2] - Rsqr.cf[2];
-	} else {
-	    bn_poly_t Q, Qsqr;
-
-	    Q.dgr = 1;
-	    Q.cf[0] = dprime[Z] * tgc->tgc_DdBm1;
-	    /* B vector is unitized (tgc->tgc_B == 1.0) */
-	    Q.cf[1] = (cor_pprime[Z] * tgc->tgc_DdBm1) + 1.0;
-
-	    /* (void) bn_poly_mul(&Qsqr, &Q, &Q); manual expansion: */
-	    Qsqr.dgr = 2;
-	    Qsqr.cf[0] = Q.cf[0] * Q.cf[0];
-	    Qsqr.cf[1] = Q.cf[0] * Q.cf[1] * 2;
-	    Qsqr.cf[2] = Q.cf[1] * Q.cf[1];
-
-	    /* (void) bn_poly_mul(&T1, &Qsqr, &Xsqr); manual expansion: */
-	    C[ix].dgr = 4;
-	    C[ix].cf[0] = Qsqr.cf[0] * Xsqr.cf[0];
-	    C[ix].cf[1] = Qsqr.cf[0] * Xsqr.cf[1] +
-		Qsqr.cf[1] * Xsqr.cf[0];
-	    C[ix].cf[2] = Qsqr.cf[0] * Xsqr.cf[2] +
-		Qsqr.cf[1] * Xsqr.cf[1] +
-		Qsqr.cf[2] * Xsqr.cf[0];
-	    C[ix].cf[3] = Qsqr.cf[1] * Xsqr.cf[2] +
-		Qsqr.cf[2] * Xsqr.cf[1];
-	    C[ix].cf[4] = Qsqr.cf[2] * Xsqr.cf[2];
-
-	    /* (void) bn_poly_mul(&T2, &Rsqr, &Ysqr); and */
-	    /* (void) bn_poly_add(&sum, &T1, &T2); manual expansion: */
-	    C[ix].cf[0] += Rsqr.cf[0] * Ysqr.cf[0];
-	    C[ix].cf[1] += Rsqr.cf[0] * Ysqr.cf[1] +
-		Rsqr.cf[1] * Ysqr.cf[0];
-	    C[ix].cf[2] += Rsqr.cf[0] * Ysqr.cf[2] +
-		Rsqr.cf[1] * Ysqr.cf[1] +
-		Rsqr.cf[2] * Ysqr.cf[0];
-	    C[ix].cf[3] += Rsqr.cf[1] * Ysqr.cf[2] +
-		Rsqr.cf[2] * Ysqr.cf[1];
-	    C[ix].cf[4] += Rsqr.cf[2] * Ysqr.cf[2];
-
-	    /* (void) bn_poly_mul(&T3, &Rsqr, &Qsqr); and */
-	    /* (void) bn_poly_sub(&C, &sum, &T3); manual expansion: */
-	    C[ix].cf[0] -= Rsqr.cf[0] * Qsqr.cf[0];
-	    C[ix].cf[1] -= Rsqr.cf[0] * Qsqr.cf[1] +
-		Rsqr.cf[1] * Qsqr.cf[0];
-	    C[ix].cf[2] -= Rsqr.cf[0] * Qsqr.cf[2] +
-		Rsqr.cf[1] * Qsqr.cf[1] +
-		Rsqr.cf[2] * Qsqr.cf[0];
-	    C[ix].cf[3] -= Rsqr.cf[1] * Qsqr.cf[2] +
-		Rsqr.cf[2] * Qsqr.cf[1];
-	    C[ix].cf[4] -= Rsqr.cf[2] * Qsqr.cf[2];
-	}
-
-    }
-
-    /* It seems impractical to try to vectorize finding and sorting roots. */
-    for (ix = 0; ix < n; ix++) {
-	if (segp[ix].seg_stp == 0) continue; /* == 0 signals skip ray */
-
-	/* Again, check for the equal eccentricities case. */
-	if (C[ix].dgr == 2) {
-	    fastf_t roots;
-
-	    /* Find the real roots the easy way. */
-	    if ((roots = C[ix].cf[1]*C[ix].cf[1]-4*C[ix].cf[0]*C[ix].cf[2]
-		    ) < 0) {
-		npts = 0;	/* no real roots */
-	    } else {
-		roots = sqrt(roots);
-		k[0] = (roots - C[ix].cf[1]) * 0.5 / C[ix].cf[0];
-		k[1] = (roots + C[ix].cf[1]) * (-0.5) / C[ix].cf[0];
-		npts = 2;
-	    }
-	} else {
-	    bn_complex_t val[4];	/* roots of final equation */
-	    register int l;
-	    register int nroots;
-
-	    /* The equation is 4th order, so we expect 0 to 4 roots */
-	    nroots = rt_poly_roots(&C[ix], val, (*stp)->st_dp->d_namep);
-
-	    /* Only real roots indicate an intersection in real space.
-	     *
-	     * Look at each root returned; if the imaginary part is zero
-	     * or sufficiently close, then use the real part as one value
-	     * of 't' for the intersections
-	     */
-	    for (l=0, npts=0; l < nroots; l++) {
-		if (NEAR_ZERO(val[l].im, 0.0001))
-		    k[npts++] = val[l].re;
-	    }
-	    /* Here, 'npts' is number of points being returned */
-	    if (npts != 0 && npts != 2 && npts != 4 && npts > 0) {
-		bu_log("tgc:  reduced %d to %d roots\n", nroots, npts);
-		bn_pr_roots("tgc", val, nroots);
-	    } else if (nroots < 0) {
-		static size_t reported = 0;
-
-		if (reported < 10) {
-		    bu_log("Root solver failed to converge on a solution for %s\n", stp[ix]->st_dp->d_namep);
-		    /* these are printed in 'mm' regardless of local units */
-		    VPRINT("\tshooting point (units mm): ", rp[ix]->r_pt);
-		    VPRINT("\tshooting direction:        ", rp[ix]->r_dir);
-		} else if (reported == 10) {
-		    bu_log("Too many convergence failures.  Suppressing further TGC root finder reports.\n");
-		}
-		reported++;
-	    }
-	}
-
-	/*
-	 * Reverse above translation by adding distance to all 'k' values.
-	 */
-	for (i = 0; i < npts; ++i)
-	    k[i] -= cor_proj;
-
-	if (npts != 0 && npts != 2 && npts != 4) {
-	    bu_log("tgc(%s):  %d intersects != {0, 2, 4}\n",
-		   stp[ix]->st_name, npts);
-	    RT_TGC_SEG_MISS(segp[ix]);		/* No hit */
-	    continue;
-	}
-
-	/* Most distant to least distant */
-	rt_pnt_sort(k, npts);
-
-	/* Now, k[0] > k[npts-1] */
-
-	/* General Cone may have 4 intersections, but Truncated Cone
-	 * may only have 2.
-	 */
-
-	/* Truncation Procedure
-	 *
-	 * Determine whether any of the intersections found are
-	 * between the planes truncating the cone.
-	 */
-	intersect = 0;
-	for (i=0; i < npts; i++) {
-	    /* segp[ix].seg_in.hit_normal holds dprime */
-	    /* segp[ix].seg_out.hit_normal holds pprime */
-	    zval = k[i]*segp[ix].seg_in.hit_normal[Z] +
-		segp[ix].seg_out.hit_normal[Z];
-	    /* Height vector is unitized (tgc->tgc_sH == 1.0) */
-	    if (zval < 1.0 && zval > 0.0) {
-		if (++intersect == 2) {
-		    pt[T_IN] = k[i];
-		}  else
-		    pt[T_OUT] = k[i];
-	    }
-	}
-	/* Reuse C to hold values of intersect and k. */
-	C[ix].dgr = intersect;
-	C[ix].cf[T_OUT] = pt[T_OUT];
-	C[ix].cf[T_IN]  = pt[T_IN];
-    }
-
-    /* for each ray/cone pair */
-    for (ix = 0; ix < n; ix++) {
-	if (segp[ix].seg_stp == 0) continue; /* Skip */
-
-	tgc = (struct tgc_specific *)stp[ix]->st_specific;
-	intersect = C[ix].dgr;
-	pt[T_OUT] = C[ix].cf[T_OUT];
-	pt[T_IN]  = C[ix].cf[T_IN];
-	/* segp[ix].seg_out.hit_normal holds pprime */
-	VMOVE(pprime, segp[ix].seg_out.hit_normal);
-	/* segp[ix].seg_in.hit_normal holds dprime */
-	VMOVE(dprime, segp[ix].seg_in.hit_normal);
-
-	if (intersect == 2) {
-	    /* If two between-plane intersections exist, they are
-	     * the hit points for the ray.
-	     */
-	    segp[ix].seg_in.hit_dist = pt[T_IN] * t_scale;
-	    segp[ix].seg_in.hit_surfno = TGC_NORM_BODY;	/* compute N */
-	    VJOIN1(segp[ix].seg_in.hit_vpriv, pprime, pt[T_IN], dprime);
-
-	    segp[ix].seg_out.hit_dist = pt[T_OUT] * t_scale;
-	    segp[ix].seg_out.hit_surfno = TGC_NORM_BODY;	/* compute N */
-	    VJOIN1(segp[ix].seg_out.hit_vpriv, pprime, pt[T_OUT], dprime);
-	} else if (intersect == 1) {
-	    int nflag;
-	    /*
-	     * If only one between-plane intersection exists (pt[T_OUT]),
-	     * then the other intersection must be on
-	     * one of the planar surfaces (pt[T_IN]).
-	     *
-	     * Find which surface it lies on by calculating the
-	     * X and Y values of the line as it intersects each
-	     * plane (in the standard coordinate system), and test
-	     * whether this lies within the governing ellipse.
-	     */
-	    if (ZERO(dprime[Z])) {
-		RT_TGC_SEG_MISS(segp[ix]);
-		continue;
-	    }
-	    b = (-pprime[Z])/dprime[Z];
-	    /* Height vector is unitized (tgc->tgc_sH == 1.0) */
-	    t = (1.0 - pprime[Z])/dprime[Z];
-
-	    VJOIN1(work, pprime, b, dprime);
-	    /* A and B vectors are unitized (tgc->tgc_A == _B == 1.0) */
-	    /* alf1 = ALPHA(work[X], work[Y], 1.0, 1.0) */
-	    alf1 = work[X]*work[X] + work[Y]*work[Y];
-
-	    VJOIN1(work, pprime, t, dprime);
-	    /* Must scale C and D vectors */
-	    alf2 = ALPHA(work[X], work[Y], tgc->tgc_AAdCC, tgc->tgc_BBdDD);
-
-	    if (alf1 <= 1.0) {
-		pt[T_IN] = b;
-		nflag = TGC_NORM_BOT; /* copy reverse normal */
-	    } else if (alf2 <= 1.0) {
-		pt[T_IN] = t;
-		nflag = TGC_NORM_TOP;	/* copy normal */
-	    } else {
-		/* intersection apparently invalid */
-		RT_TGC_SEG_MISS(segp[ix]);
+    struct tgc_shot_ray tr[RT_VSHOT_BLOCK];
+    int ok[RT_VSHOT_BLOCK];
+    bn_poly_t C[RT_VSHOT_BLOCK];
+    fastf_t lo[RT_VSHOT_BLOCK], hi[RT_VSHOT_BLOCK];
+    fastf_t roots[RT_VSHOT_BLOCK * BN_MAX_POLY_DEGREE];
+    int nroots[RT_VSHOT_BLOCK];
+    struct seg seghead;
+    int base, m, i;
+
+    if (!stp || !rp || !segp || !ap)
+	return;
+    RT_CK_APPLICATION(ap);
+
+    BU_LIST_INIT(&(seghead.l));
+
+    for (base = 0; base < n; base += RT_VSHOT_BLOCK) {
+	m = n - base;
+	if (m > RT_VSHOT_BLOCK)
+	    m = RT_VSHOT_BLOCK;
+
+	for (i = 0; i < m; i++) {
+	    /* an empty interval has no roots */
+	    C[i].dgr = 0;
+	    lo[i] = 1.0;
+	    hi[i] = 0.0;
+	    if (stp[base+i] == 0) {
+		ok[i] = -1;	/* stp[i] == 0 signals skip ray */
 		continue;
 	    }
-
-	    /* pt[T_OUT] on skin, pt[T_IN] on end */
-	    if (pt[T_OUT] >= pt[T_IN]) {
-		segp[ix].seg_in.hit_dist = pt[T_IN] * t_scale;
-		segp[ix].seg_in.hit_surfno = nflag;
-
-		segp[ix].seg_out.hit_dist = pt[T_OUT] * t_scale;
-		segp[ix].seg_out.hit_surfno = TGC_NORM_BODY;	/* compute N */
-		/* transform-space vector needed for normal */
-		VJOIN1(segp[ix].seg_out.hit_vpriv, pprime, pt[T_OUT], dprime);
-	    } else {
-		segp[ix].seg_in.hit_dist = pt[T_OUT] * t_scale;
-		/* transform-space vector needed for normal */
-		segp[ix].seg_in.hit_surfno = TGC_NORM_BODY;	/* compute N */
-		VJOIN1(segp[ix].seg_in.hit_vpriv, pprime, pt[T_OUT], dprime);
-
-		segp[ix].seg_out.hit_dist = pt[T_IN] * t_scale;
-		segp[ix].seg_out.hit_surfno = nflag;
-	    }
-	} else {
-
-	    /* If all conic intersections lie outside the plane, then
-	     * check to see whether there are two planar intersections
-	     * inside the governing ellipses.
-	     *
-	     * But first, if the direction is parallel (or nearly so)
-	     * to the planes, it (obviously) won't intersect either of
-	     * them.
-	     */
-	    if (ZERO(dprime[Z])) {
-		RT_TGC_SEG_MISS(segp[ix]);
+	    ok[i] = tgc_shot_setup(stp[base+i], rp[base+i], &tr[i]);
+	    if (!ok[i])
 		continue;
+	    tgc_shot_coef(stp[base+i], &tr[i]);
+	    if (tr[i].C.dgr == 4) {
+		C[i] = tr[i].C;
+		lo[i] = -tr[i].t_max;
+		hi[i] = tr[i].t_max;
 	    }
+	}
 
-	    dir = VDOT(tgc->tgc_N, rp[ix]->r_dir);	/* direc */
-	    if (NEAR_ZERO(dir, RT_DOT_TOL)) {
-		RT_TGC_SEG_MISS(segp[ix]);
-		continue;
-	    }
+	rt_poly_near_real_roots_n((size_t)m, C, lo, hi, roots, nroots);
 
-	    b = (-pprime[Z])/dprime[Z];
-	    /* Height vector is unitized (tgc->tgc_sH == 1.0) */
-	    t = (1.0 - pprime[Z])/dprime[Z];
-
-	    VJOIN1(work, pprime, b, dprime);
-	    /* A and B vectors are unitized (tgc->tgc_A == _B == 1.0) */
-	    /* alpf = ALPHA(work[0], work[1], 1.0, 1.0) */
-	    alf1 = work[X]*work[X] + work[Y]*work[Y];
-
-	    VJOIN1(work, pprime, t, dprime);
-	    /* Must scale C and D vectors. */
-	    alf2 = ALPHA(work[X], work[Y], tgc->tgc_AAdCC, tgc->tgc_BBdDD);
-
-	    /* It should not be possible for one planar intersection
-	     * to be outside its ellipse while the other is inside ...
-	     * but I wouldn't take any chances.
-	     */
-	    if (alf1 > 1.0 || alf2 > 1.0) {
-		RT_TGC_SEG_MISS(segp[ix]);
+	for (i = 0; i < m; i++) {
+	    if (ok[i] < 0)
 		continue;
-	    }
-
-	    /* Use the dot product (found earlier) of the plane normal
-	     * with the direction vector to determine the orientation
-	     * of the intersections.
-	     */
-	    if (dir > 0.0) {
-		segp[ix].seg_in.hit_dist = b * t_scale;
-		segp[ix].seg_in.hit_surfno = TGC_NORM_BOT;	/* reverse normal */
-
-		segp[ix].seg_out.hit_dist = t * t_scale;
-		segp[ix].seg_out.hit_surfno = TGC_NORM_TOP;	/* normal */
-	    } else {
-		segp[ix].seg_in.hit_dist = t * t_scale;
-		segp[ix].seg_in.hit_surfno = TGC_NORM_TOP;	/* normal */
-
-		segp[ix].seg_out.hit_dist = b * t_scale;
-		segp[ix].seg_out.hit_surfno = TGC_NORM_BOT;	/* reverse normal */
-	    }
+	    if (ok[i])
+		(void)tgc_shot_hits(stp[base+i], rp[base+i], ap, &tr[i],
+				    &roots[i * BN_MAX_POLY_DEGREE], nroots[i], &seghead);
+	    rt_vshot_store(&segp[base+i], &seghead, ap->a_resource);
 	}
-    } /* end for each ray/cone pair */
-    bu_free((char *)C, "tor bn_poly_t");
+    }
 }
 
 
@@ -1923,7 +1609,7 @@ rt_tgc_tess(struct nmgregion **r, struct model *m, struct rt_db_internal *ip, co
     struct bu_ptbl verts;		/* table of vertices used for top and bottom faces */
     struct bu_ptbl faces;		/* table of faceuses for nmg_gluefaces */
     struct vertex **v[3];		/* array for making triangular faces */
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     size_t i;
 
@@ -3115,7 +2801,7 @@ rt_tgc_adaptive_plot(struct bu_list *vhead, struct rt_db_internal *ip, const str
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     tip = (struct rt_tgc_internal *)ip->idb_ptr;
     RT_TGC_CK_MAGIC(tip);
 
@@ -3219,7 +2905,7 @@ rt_tgc_plot(struct bu_list *vhead, struct rt_db_internal *ip, const struct bg_te
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     tip = (struct rt_tgc_internal *)ip->idb_ptr;
     RT_TGC_CK_MAGIC(tip);
 
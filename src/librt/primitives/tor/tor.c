@@ -372,47 +372,30 @@ inside_overlapping_region(struct tor_specific *tor, point_t hp)
 
 
 /**
- * Intersect a ray with an torus, where all constant terms have been
- * precomputed by rt_tor_prep().  If an intersection occurs, one or
- * two struct seg(s) will be acquired and filled in.
- *
- * NOTE: All lines in this function are represented parametrically by
- * a point, P(x0, y0, z0) and a direction normal, D = ax + by + cz.
- * Any point on a line can be expressed by one variable 't', where
- *
- * X = a*t + x0,	e.g., X = Dx*t + Px
- * Y = b*t + y0,
- * Z = c*t + z0.
- *
- * First, convert the line to the coordinate system of a "standard"
- * torus.  This is a torus which lies in the X-Y plane, circles the
- * origin, and whose primary radius is one.  The secondary radius is
- * alpha = (R2/R1) of the original torus where (0 < alpha <= 1).
- *
- * Then find the equation of that line and the standard torus, which
- * turns out to be a quartic equation in 't'.  Solve the equation
- * using a general polynomial root finder.  Use those values of 't' to
- * compute the points of intersection in the original coordinate
- * system.
- *
- * Returns -
- * 0 MISS
- * >0 HIT
+ * The quartic of a ray in the space of the unit torus, as computed by
+ * the first stage of rt_tor_shot().
  */
-int
-rt_tor_shot(struct soltab *stp, register struct xray *rp, struct application *ap, struct seg *seghead)
-{
-    register struct tor_specific *tor =
-	(struct tor_specific *)stp->st_specific;
-    register struct seg *segp;
+struct tor_shot_ray {
     vect_t dprime;		/* D' */
     vect_t pprime;		/* P' */
-    vect_t work;		/* temporary vector */
+    fastf_t cor_proj;
+    fastf_t t_max;		/* the hits lie within [-t_max, t_max] */
     bn_poly_t C;		/* The final equation */
-    bn_complex_t val[4];		/* The complex roots */
-    double k[4];		/* The real roots */
-    register int i;
-    int j;
+};
+
+
+/**
+ * First stage of rt_tor_shot(): convert the ray into the space of the
+ * unit torus and build the quartic whose roots are the hits.
+ */
+static void
+tor_shot_coef(const struct soltab *stp, const struct xray *rp, struct tor_shot_ray *tr)
+{
+    register const struct tor_specific *tor =
+	(struct tor_specific *)stp->st_specific;
+    fastf_t *dprime = tr->dprime;
+    fastf_t *pprime = tr->pprime;
+    vect_t work;		/* temporary vector */
     bn_poly_t A, Asqr;
     bn_poly_t X2_Y2;		/* X**2 + Y**2 */
     vect_t cor_pprime;	/* new ray origin */
@@ -476,43 +459,47 @@ rt_tor_shot(struct soltab *stp, register struct xray *rp, struct application *ap
     /* Inline expansion of bn_poly_scale(&X2_Y2, 4.0) and
      * bn_poly_sub(&C, &Asqr, &X2_Y2).
      */
-    C.dgr   = 4;
-    C.cf[0] = Asqr.cf[0];
-    C.cf[1] = Asqr.cf[1];
-    C.cf[2] = Asqr.cf[2] - X2_Y2.cf[0] * 4.0;
-    C.cf[3] = Asqr.cf[3] - X2_Y2.cf[1] * 4.0;
-    C.cf[4] = Asqr.cf[4] - X2_Y2.cf[2] * 4.0;
-
-    /* It is known that the equation is 4th order.  Therefore, if the
-     * root finder returns other than 4 roots, error.
+    tr->C.dgr   = 4;
+    tr->C.cf[0] = Asqr.cf[0];
+    tr->C.cf[1] = Asqr.cf[1];
+    tr->C.cf[2] = Asqr.cf[2] - X2_Y2.cf[0] * 4.0;
+    tr->C.cf[3] = Asqr.cf[3] - X2_Y2.cf[1] * 4.0;
+    tr->C.cf[4] = Asqr.cf[4] - X2_Y2.cf[2] * 4.0;
+
+    tr->cor_proj = cor_proj;
+
+    /* measured from the closest approach to the center, the unit
+     * torus lies within a sphere of radius 1 + alpha
      */
-    if ((i = rt_poly_roots(&C, val, stp->st_dp->d_namep)) != 4) {
-	if (i > 0) {
-	    bu_log("tor:  rt_poly_roots() 4!=%d\n", i);
-	    bn_pr_roots(stp->st_name, val, i);
-	} else if (i < 0) {
-	    static int reported=0;
-	    bu_log("The root solver failed to converge on a solution for %s\n", stp->st_dp->d_namep);
-	    if (!reported) {
-		VPRINT("while shooting from:\t", rp->r_pt);
-		VPRINT("while shooting at:\t", rp->r_dir);
-		bu_log("Additional torus convergence failure details will be suppressed.\n");
-		reported=1;
-	    }
-	}
-	return 0;		/* MISS */
-    }
+    tr->t_max = (1.0 + tor->tor_alpha) * (1.0 + 1.0e-9);
+}
 
-    /* Only real roots indicate an intersection in real space.
-     *
-     * Look at each root returned; if the imaginary part is zero or
-     * sufficiently close, then use the real part as one value of 't'
-     * for the intersections
+
+/**
+ * Second stage of rt_tor_shot(): build the segments from the real
+ * roots of the quartic, in ascending order.
+ */
+static int
+tor_shot_hits(struct soltab *stp, struct xray *rp, struct application *ap, struct tor_shot_ray *tr, const fastf_t roots[], int nroots, struct seg *seghead)
+{
+    register struct tor_specific *tor =
+	(struct tor_specific *)stp->st_specific;
+    register struct seg *segp;
+    const fastf_t *dprime = tr->dprime;
+    const fastf_t *pprime = tr->pprime;
+    const fastf_t cor_proj = tr->cor_proj;
+    double k[4];		/* The real roots */
+    register int i;
+    int j;
+
+    /* Only real roots indicate an intersection in real space.  A
+     * grazing ray touches the surface at a double root, which the
+     * solver reports twice.
      */
-    for (j=0, i=0; j < 4; j++) {
-	if (NEAR_ZERO(val[j].im, ap->a_rt_i->rti_tol.dist))
-	    k[i++] = val[j].re;
-    }
+
+    /* descending order, most distant first */
+    for (i = 0; i < nroots; i++)
+	k[i] = roots[nroots - 1 - i];
 
     /* reverse above translation by adding distance to all 'k' values.
      */
@@ -526,37 +513,10 @@ rt_tor_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 
 	default:
 	    bu_log("rt_tor_shot: reduced 4 to %d roots\n", i);
-	    bn_pr_roots(stp->st_name, val, 4);
 	    return 0;		/* No hit */
 
 	case 2:
-	    {
-		/* Sort most distant to least distant. */
-		fastf_t u;
-		if ((u=k[0]) < k[1]) {
-		    /* bubble larger towards [0] */
-		    k[0] = k[1];
-		    k[1] = u;
-		}
-	    }
-	    break;
 	case 4:
-	    {
-		register short n;
-		register short lim;
-
-		/* Inline rt_pnt_sort().  Sorts k[] into descending order. */
-		for (lim = i-1; lim > 0; lim--) {
-		    for (n = 0; n < lim; n++) {
-			fastf_t u;
-			if ((u=k[n]) < k[n+1]) {
-			    /* bubble larger towards [0] */
-			    k[n] = k[n+1];
-			    k[n+1] = u;
-			}
-		    }
-		}
-	    }
 	    break;
     }
 
@@ -599,9 +559,50 @@ rt_tor_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 }
 
 
-#define RT_TOR_SEG_MISS(SEG)		(SEG).seg_stp=(struct soltab *) 0;
 /**
- * This is the Becker vector version
+ * Intersect a ray with an torus, where all constant terms have been
+ * precomputed by rt_tor_prep().  If an intersection occurs, one or
+ * two struct seg(s) will be acquired and filled in.
+ *
+ * NOTE: All lines in this function are represented parametrically by
+ * a point, P(x0, y0, z0) and a direction normal, D = ax + by + cz.
+ * Any point on a line can be expressed by one variable 't', where
+ *
+ * X = a*t + x0,	e.g., X = Dx*t + Px
+ * Y = b*t + y0,
+ * Z = c*t + z0.
+ *
+ * First, convert the line to the coordinate system of a "standard"
+ * torus.  This is a torus which lies in the X-Y plane, circles the
+ * origin, and whose primary radius is one.  The secondary radius is
+ * alpha = (R2/R1) of the original torus where (0 < alpha <= 1).
+ *
+ * Then find the equation of that line and the standard torus, which
+ * turns out to be a quartic equation in 't'.  Solve the equation
+ * using a general polynomial root finder.  Use those values of 't' to
+ * compute the points of intersection in the original coordinate
+ * system.
+ *
+ * Returns -
+ * 0 MISS
+ * >0 HIT
+ */
+int
+rt_tor_shot(struct soltab *stp, register struct xray *rp, struct application *ap, struct seg *seghead)
+{
+    struct tor_shot_ray tr;
+    fastf_t roots[4];
+    int nroots;
+
+    tor_shot_coef(stp, rp, &tr);
+    nroots = rt_poly_real_roots(&tr.C, -tr.t_max, tr.t_max, roots);
+    return tor_shot_hits(stp, rp, ap, &tr, roots, nroots, seghead);
+}
+
+
+/**
+ * Vectorized version of rt_tor_shot().  The quartics of a whole block
+ * of ray/torus pairs are built first and then solved together.
  */
 void
 rt_tor_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struct application *ap)
@@ -611,242 +612,47 @@ rt_tor_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, str
     /* Number of ray/object pairs */
 
 {
-    register int i;
-    register struct tor_specific *tor;
-    vect_t dprime;		/* D' */
-    vect_t pprime;		/* P' */
-    vect_t work;		/* temporary vector */
-    bn_poly_t *C;		/* The final equation */
-    bn_complex_t (*val)[4];	/* The complex roots */
-    int num_roots;
-    int num_zero;
-    bn_poly_t A, Asqr;
-    bn_poly_t X2_Y2;		/* X**2 + Y**2 */
-    vect_t cor_pprime;	/* new ray origin */
-    fastf_t *cor_proj;
-
-    if (!stp || !(*stp) || !rp || !segp || !ap)
+    struct tor_shot_ray tr[RT_VSHOT_BLOCK];
+    bn_poly_t C[RT_VSHOT_BLOCK];
+    fastf_t lo[RT_VSHOT_BLOCK], hi[RT_VSHOT_BLOCK];
+    fastf_t roots[RT_VSHOT_BLOCK * BN_MAX_POLY_DEGREE];
+    int nroots[RT_VSHOT_BLOCK];
+    struct seg seghead;
+    int base, m, i;
+
+    if (!stp || !rp || !segp || !ap)
 	return;
 
-    /* Allocate space for polys and roots */
-    C = (bn_poly_t *)bu_malloc(n * sizeof(bn_poly_t), "tor bn_poly_t");
-    val = (bn_complex_t (*)[4])bu_malloc(n * sizeof(bn_complex_t) * 4,
-					 "tor bn_complex_t");
-    cor_proj = (fastf_t *)bu_malloc(n * sizeof(fastf_t), "tor proj");
-
-    /* Initialize seg_stp to assume hit (zero will then flag miss) */
-    for (i = 0; i < n; i++) segp[i].seg_stp = stp[i];
-
-    /* for each ray/torus pair */
-    for (i = 0; i < n; i++) {
-	if (segp[i].seg_stp == 0) continue;	/* Skip */
-	tor = (struct tor_specific *)stp[i]->st_specific;
-
-	/* Convert vector into the space of the unit torus */
-	MAT4X3VEC(dprime, tor->tor_SoR, rp[i]->r_dir);
-	VUNITIZE(dprime);
+    BU_LIST_INIT(&(seghead.l));
 
-	/* Use segp[i].seg_in.hit_normal as tmp to hold dprime */
-	VMOVE(segp[i].seg_in.hit_normal, dprime);
+    for (base = 0; base < n; base += RT_VSHOT_BLOCK) {
+	m = n - base;
+	if (m > RT_VSHOT_BLOCK)
+	    m = RT_VSHOT_BLOCK;
 
-	VSUB2(work, rp[i]->r_pt, tor->tor_V);
-	MAT4X3VEC(pprime, tor->tor_SoR, work);
-
-	/* Use segp[i].seg_out.hit_normal as tmp to hold pprime */
-	VMOVE(segp[i].seg_out.hit_normal, pprime);
-
-	/* normalize distance from torus.  substitute corrected pprime
-	 * which contains a translation along ray direction to closest
-	 * approach to vertex of torus.  Translating ray origin along
-	 * direction of ray to closest pt. to origin of solid's
-	 * coordinate system, new ray origin is 'cor_pprime'.
-	 */
-	cor_proj[i] = VDOT(pprime, dprime);
-	VSCALE(cor_pprime, dprime, cor_proj[i]);
-	VSUB2(cor_pprime, pprime, cor_pprime);
-
-	/*
-	 * Given a line and a ratio, alpha, finds the equation of the
-	 * unit torus in terms of the variable 't'.
-	 *
-	 * The equation for the torus is:
-	 *
-	 * [X**2 + Y**2 + Z**2 + (1 - alpha**2)]**2 - 4*(X**2 + Y**2) =0
-	 *
-	 * First, find X, Y, and Z in terms of 't' for this line, then
-	 * substitute them into the equation above.
-	 *
-	 * Wx = Dx*t + Px
-	 *
-	 * Wx**2 = Dx**2 * t**2  +  2 * Dx * Px  +  Px**2
-	 *		[0]             [1]           [2]    dgr=2
-	 */
-	X2_Y2.dgr = 2;
-	X2_Y2.cf[0] = dprime[X] * dprime[X] + dprime[Y] * dprime[Y];
-	X2_Y2.cf[1] = 2.0 * (dprime[X] * cor_pprime[X] +
-			     dprime[Y] * cor_pprime[Y]);
-	X2_Y2.cf[2] = cor_pprime[X] * cor_pprime[X] +
-	    cor_pprime[Y] * cor_pprime[Y];
-
-	/* A = X2_Y2 + Z2 */
-	A.dgr = 2;
-	A.cf[0] = X2_Y2.cf[0] + dprime[Z] * dprime[Z];
-	A.cf[1] = X2_Y2.cf[1] + 2.0 * dprime[Z] * cor_pprime[Z];
-	A.cf[2] = X2_Y2.cf[2] + cor_pprime[Z] * cor_pprime[Z] +
-	    1.0 - tor->tor_alpha * tor->tor_alpha;
-
-	/* Inline expansion of (void) bn_poly_mul(&Asqr, &A, &A) */
-	/* Both polys have degree two */
-	Asqr.dgr = 4;
-	Asqr.cf[0] = A.cf[0] * A.cf[0];
-	Asqr.cf[1] = A.cf[0] * A.cf[1] +
-	    A.cf[1] * A.cf[0];
-	Asqr.cf[2] = A.cf[0] * A.cf[2] +
-	    A.cf[1] * A.cf[1] +
-	    A.cf[2] * A.cf[0];
-	Asqr.cf[3] = A.cf[1] * A.cf[2] +
-	    A.cf[2] * A.cf[1];
-	Asqr.cf[4] = A.cf[2] * A.cf[2];
-
-	/* Inline expansion of (void) bn_poly_scale(&X2_Y2, 4.0) */
-	X2_Y2.cf[0] *= 4.0;
-	X2_Y2.cf[1] *= 4.0;
-	X2_Y2.cf[2] *= 4.0;
-
-	/* Inline expansion of (void) bn_poly_sub(&C, &Asqr, &X2_Y2) */
-	/* offset is known to be 2 */
-	C[i].dgr	= 4;
-	C[i].cf[0] = Asqr.cf[0];
-	C[i].cf[1] = Asqr.cf[1];
-	C[i].cf[2] = Asqr.cf[2] - X2_Y2.cf[0];
-	C[i].cf[3] = Asqr.cf[3] - X2_Y2.cf[1];
-	C[i].cf[4] = Asqr.cf[4] - X2_Y2.cf[2];
-    }
-
-    /* Unfortunately finding the 4th order roots are too ugly to
-     * expand the root solving manually.
-     */
-    for (i = 0; i < n; i++) {
-	if (segp[i].seg_stp == 0) continue;	/* Skip */
-
-	/* It is known that the equation is 4th order.  Therefore, if
-	 * the root finder returns other than 4 roots, error.
-	 */
-	if ((num_roots = rt_poly_roots(&(C[i]), &(val[i][0]), (*stp)->st_dp->d_namep)) != 4) {
-	    if (num_roots > 0) {
-		bu_log("tor:  rt_poly_roots() 4!=%d\n", num_roots);
-		bn_pr_roots("tor", val[i], num_roots);
-	    } else if (num_roots < 0) {
-		static int reported=0;
-		bu_log("The root solver failed to converge on a solution for %s\n", stp[i]->st_dp->d_namep);
-		if (!reported) {
-		    VPRINT("while shooting from:\t", rp[i]->r_pt);
-		    VPRINT("while shooting at:\t", rp[i]->r_dir);
-		    bu_log("Additional torus convergence failure details will be suppressed.\n");
-		    reported=1;
-		}
+	for (i = 0; i < m; i++) {
+	    if (stp[base+i] == 0) {
+		/* Skip; an empty interval has no roots */
+		C[i].dgr = 0;
+		lo[i] = 1.0;
+		hi[i] = 0.0;
+		continue;
 	    }
-	    RT_TOR_SEG_MISS(segp[i]);		/* MISS */
+	    tor_shot_coef(stp[base+i], rp[base+i], &tr[i]);
+	    C[i] = tr[i].C;
+	    lo[i] = -tr[i].t_max;
+	    hi[i] = tr[i].t_max;
 	}
-    }
-
-    /* for each ray/torus pair */
-    for (i = 0; i < n; i++) {
-	if (segp[i].seg_stp == 0) continue; /* Skip */
 
-	/* Only real roots indicate an intersection in real space.
-	 *
-	 * Look at each root returned; if the imaginary part is zero
-	 * or sufficiently close, then use the real part as one value
-	 * of 't' for the intersections
-	 */
-	/* Also reverse translation by adding distance to all 'k' values. */
-	/* Reuse C to hold k values */
-	num_zero = 0;
-	if (NEAR_ZERO(val[i][0].im, ap->a_rt_i->rti_tol.dist))
-	    C[i].cf[num_zero++] = val[i][0].re - cor_proj[i];
-	if (NEAR_ZERO(val[i][1].im, ap->a_rt_i->rti_tol.dist)) {
-	    C[i].cf[num_zero++] = val[i][1].re - cor_proj[i];
-	}
-	if (NEAR_ZERO(val[i][2].im, ap->a_rt_i->rti_tol.dist)) {
-	    C[i].cf[num_zero++] = val[i][2].re - cor_proj[i];
-	}
-	if (NEAR_ZERO(val[i][3].im, ap->a_rt_i->rti_tol.dist)) {
-	    C[i].cf[num_zero++] = val[i][3].re - cor_proj[i];
-	}
-	C[i].dgr   = num_zero;
-
-	/* Here, 'i' is number of points found */
-	if (num_zero == 0) {
-	    RT_TOR_SEG_MISS(segp[i]);		/* MISS */
-	} else if (num_zero != 2 && num_zero != 4) {
-	    RT_TOR_SEG_MISS(segp[i]);		/* MISS */
-	}
-    }
+	rt_poly_real_roots_n((size_t)m, C, lo, hi, roots, nroots);
 
-    /* Process each one segment hit */
-    for (i = 0; i < n; i++) {
-	if (segp[i].seg_stp == 0) continue; /* Skip */
-	if (C[i].dgr != 2) continue;  /* Not one segment */
-
-	tor = (struct tor_specific *)stp[i]->st_specific;
-
-	/* segp[i].seg_in.hit_normal holds dprime */
-	/* segp[i].seg_out.hit_normal holds pprime */
-	if (C[i].cf[1] < C[i].cf[0]) {
-	    /* C[i].cf[1] is entry point */
-	    segp[i].seg_in.hit_dist = C[i].cf[1]*tor->tor_r1;
-	    segp[i].seg_out.hit_dist = C[i].cf[0]*tor->tor_r1;
-	    /* Set aside vector for rt_tor_norm() later */
-	    VJOIN1(segp[i].seg_in.hit_vpriv,
-		   segp[i].seg_out.hit_normal,
-		   C[i].cf[1], segp[i].seg_in.hit_normal);
-	    VJOIN1(segp[i].seg_out.hit_vpriv,
-		   segp[i].seg_out.hit_normal,
-		   C[i].cf[0], segp[i].seg_in.hit_normal);
-	} else {
-	    /* C[i].cf[0] is entry point */
-	    segp[i].seg_in.hit_dist = C[i].cf[0]*tor->tor_r1;
-	    segp[i].seg_out.hit_dist = C[i].cf[1]*tor->tor_r1;
-	    /* Set aside vector for rt_tor_norm() later */
-	    VJOIN1(segp[i].seg_in.hit_vpriv,
-		   segp[i].seg_out.hit_normal,
-		   C[i].cf[0], segp[i].seg_in.hit_normal);
-	    VJOIN1(segp[i].seg_out.hit_vpriv,
-		   segp[i].seg_out.hit_normal,
-		   C[i].cf[1], segp[i].seg_in.hit_normal);
+	for (i = 0; i < m; i++) {
+	    if (stp[base+i] == 0) continue;	/* Skip */
+	    (void)tor_shot_hits(stp[base+i], rp[base+i], ap, &tr[i],
+				&roots[i * BN_MAX_POLY_DEGREE], nroots[i], &seghead);
+	    rt_vshot_store(&segp[base+i], &seghead, ap->a_resource);
 	}
     }
-
-    /* Process each two segment hit */
-    for (i = 0; i < n; i++) {
-
-	if (segp[i].seg_stp == 0) continue;	/* Skip */
-	if (C[i].dgr != 4) continue;  /* Not two segment */
-
-	tor = (struct tor_specific *)stp[i]->st_specific;
-
-	/* Sort most distant to least distant. */
-	rt_pnt_sort(C[i].cf, 4);
-	/* Now, t[0] > t[npts-1] */
-
-	/* segp[i].seg_in.hit_normal holds dprime */
-	VMOVE(dprime, segp[i].seg_in.hit_normal);
-	/* segp[i].seg_out.hit_normal holds pprime */
-	VMOVE(pprime, segp[i].seg_out.hit_normal);
-
-	/* C[i].cf[1] is entry point */
-	segp[i].seg_in.hit_dist =  C[i].cf[1]*tor->tor_r1;
-	segp[i].seg_out.hit_dist = C[i].cf[0]*tor->tor_r1;
-	/* Set aside vector for rt_tor_norm() later */
-	VJOIN1(segp[i].seg_in.hit_vpriv, pprime, C[i].cf[1], dprime);
-	VJOIN1(segp[i].seg_out.hit_vpriv, pprime, C[i].cf[0], dprime);
-    }
-
-    /* Free tmp space used */
-    bu_free((char *)C, "tor C");
-    bu_free((char *)val, "tor val");
-    bu_free((char *)cor_proj, "tor cor_proj");
 }
 
 
@@ -1070,7 +876,7 @@ rt_tor_adaptive_plot(struct bu_list *vhead, struct rt_db_internal *ip, const str
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     tor = (struct rt_tor_internal *)ip->idb_ptr;
     RT_TOR_CK_MAGIC(tor);
 
@@ -1175,7 +981,7 @@ rt_tor_plot(struct bu_list *vhead, struct rt_db_internal *ip, const struct bg_te
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     tip = (struct rt_tor_internal *)ip->idb_ptr;
     RT_TOR_CK_MAGIC(tip);
 
@@ -33,6 +33,7 @@
 #include <ctype.h>
 #include <math.h>
 #include <string.h>
+#include <sys/stat.h>
 #include "bio.h"
 
 #include "bu/parallel.h"
@@ -43,6 +44,8 @@
 #include "raytrace.h"
 
 #include "../fixpt.h"
+#include "../brick_map.h"
+#include "../../librt_private.h"
 
 
 /*
@@ -59,6 +62,7 @@ struct rt_vol_specific {
     mat_t vol_mat;	/* model to ideal space */
     vect_t vol_origin;	/* local coords of grid origin (0, 0, 0) for now */
     vect_t vol_large;	/* local coords of XYZ max */
+    struct brick_map vol_bricks;	/* cells within lo..hi, for skipping empty space */
 };
 #define VOL_NULL ((struct rt_vol_specific *)0)
 
@@ -141,6 +145,7 @@ rt_vol_shot(struct soltab *stp, register struct xray *rp, struct application *ap
     int in_axis = -INT_MAX;
     int axis_set = 0;
     int out_axis = -INT_MAX;
+    int level;
     int j;
     struct xray ideal_ray;
 
@@ -387,6 +392,24 @@ rt_vol_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 	    }
 	}
 
+	/* Jump over the largest empty brick around a void cell */
+	if (!inside && !OK(&volp->vol_i, (size_t)val)
+	    && (level = brick_map_empty_level(&volp->vol_bricks, igrid[X], igrid[Y], igrid[Z])) > 0)
+	{
+	    size_t cell[3], steps[3];
+
+	    VMOVE(cell, igrid);
+	    in_axis = brick_map_skip(&volp->vol_bricks, level, cell, rp->r_dir, t, delta, steps, &t0);
+	    for (j = X; j <= Z; j++) {
+		if (rp->r_dir[j] > 0) {
+		    igrid[j] += (int)steps[j];
+		} else {
+		    igrid[j] -= (int)steps[j];
+		}
+	    }
+	    continue;
+	}
+
 	/* Take next step */
 	t0 = t1;
 	in_axis = out_axis;
@@ -977,17 +1000,22 @@ rt_vol_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
 }
 
 
+static void
+vol_cell_range(void *data, size_t x, size_t y, size_t z, unsigned short *min, unsigned short *max)
+{
+    struct rt_vol_internal *vip = (struct rt_vol_internal *)data;
+    size_t val = VOL(vip, x, y, z);
+
+    *min = *max = OK(vip, val);
+}
+
+
 /**
- * Returns -
- * 0 OK
- * !0 Failure
- *
- * Implicit return -
- * A struct rt_vol_specific is created, and its address is stored
- * in stp->st_specific for use by rt_vol_shot().
+ * Set up everything in the vol_specific except the brick map, taking
+ * over the bitmap storage of the internal form.
  */
-int
-rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+static struct rt_vol_specific *
+vol_prep_specific(struct soltab *stp, struct rt_db_internal *ip)
 {
     struct rt_vol_internal *vip;
     register struct rt_vol_specific *volp;
@@ -995,16 +1023,13 @@ rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     vect_t radvec;
     vect_t diam;
 
-    RT_CK_SOLTAB(stp);
-    RT_CK_DB_INTERNAL(ip);
-    if (rtip) RT_CK_RTI(rtip);
-
     vip = (struct rt_vol_internal *)ip->idb_ptr;
     RT_VOL_CK_MAGIC(vip);
 
     BU_GET(volp, struct rt_vol_specific);
     volp->vol_i = *vip;		/* struct copy */
     vip->map = (unsigned char *)0;	/* "steal" the bitmap storage */
+    memset(&volp->vol_bricks, 0, sizeof(struct brick_map));
 
     /* build Xform matrix from model(world) to ideal(local) space */
     bn_mat_inv(volp->vol_mat, vip->mat);
@@ -1020,7 +1045,7 @@ rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     stp->st_specific = (void *)volp;
 
     /* Find bounding RPP of rotated local RPP */
-    if (rt_vol_bbox(ip, &(stp->st_min), &(stp->st_max), &rtip->rti_tol)) return 1;
+    (void)rt_vol_bbox(ip, &(stp->st_min), &(stp->st_max), NULL);
     VSET(volp->vol_large,
 	 volp->vol_i.xdim*vip->cellsize[0], volp->vol_i.ydim*vip->cellsize[1], volp->vol_i.zdim*vip->cellsize[2]);/* type conversion */
 
@@ -1033,10 +1058,112 @@ rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     VSCALE(radvec, diam, 0.5);
     stp->st_aradius = stp->st_bradius = MAGNITUDE(radvec);
 
+    return volp;
+}
+
+
+/**
+ * Returns -
+ * 0 OK
+ * !0 Failure
+ *
+ * Implicit return -
+ * A struct rt_vol_specific is created, and its address is stored
+ * in stp->st_specific for use by rt_vol_shot().
+ */
+int
+rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    register struct rt_vol_specific *volp;
+
+    RT_CK_SOLTAB(stp);
+    RT_CK_DB_INTERNAL(ip);
+    if (rtip) RT_CK_RTI(rtip);
+
+    volp = vol_prep_specific(stp, ip);
+    if (!volp->vol_i.map)
+	return 0;
+
+    /* occupancy pyramid, so the DDA can jump over empty bricks */
+    if (brick_map_build(&volp->vol_bricks, volp->vol_i.xdim, volp->vol_i.ydim, volp->vol_i.zdim, vol_cell_range, &volp->vol_i))
+	bu_log("vol(%s): unable to build brick map\n", volp->vol_i.name);
+
     return 0;		/* OK */
 }
 
 
+/**
+ * Save or restore the brick map built by rt_vol_prep(), which tests
+ * every voxel against the thresholds.  The thresholds are part of the
+ * record and so of the cache key.  Only volumes read from a file are
+ * cached, with the file size and modification time stored alongside
+ * so an edited file is not matched with a stale map.  Volumes held in
+ * a binunif object are not part of the cache key and are always
+ * prepped.
+ */
+int
+rt_vol_prep_serialize(struct soltab *stp, const struct rt_db_internal *ip, struct bu_external *external, size_t *version)
+{
+    const size_t current_version = 0;
+    struct rt_vol_internal *vip;
+    struct rt_prep_stream s;
+    struct stat sb;
+
+    RT_CK_SOLTAB(stp);
+    RT_CK_DB_INTERNAL(ip);
+    BU_CK_EXTERNAL(external);
+
+    rt_prep_stream_init(&s, external);
+
+    if (stp->st_specific) {
+	/* export to external */
+	struct rt_vol_specific *volp = (struct rt_vol_specific *)stp->st_specific;
+
+	if (volp->vol_i.datasrc != RT_VOL_SRC_FILE || !volp->vol_bricks.levels)
+	    return 1;
+	if (stat(volp->vol_i.name, &sb) || (uint64_t)sb.st_size > UINT32_MAX)
+	    return 1;
+
+	rt_prep_put_uint32(&s, (uint32_t)sb.st_size);
+	rt_prep_put_uint32(&s, (uint32_t)((uint64_t)sb.st_mtime >> 32));
+	rt_prep_put_uint32(&s, (uint32_t)((uint64_t)sb.st_mtime & 0xffffffff));
+	brick_map_put(&s, &volp->vol_bricks);
+
+	rt_prep_stream_finish(&s);
+	*version = current_version;
+	return 0;
+    } else {
+	/* load from external */
+	struct rt_vol_specific *volp;
+	struct brick_map bricks;
+	uint32_t hi, lo;
+
+	if (*version != current_version)
+	    return 1;
+
+	vip = (struct rt_vol_internal *)ip->idb_ptr;
+	RT_VOL_CK_MAGIC(vip);
+	if (vip->datasrc != RT_VOL_SRC_FILE || !vip->map)
+	    return 1;
+	if (stat(vip->name, &sb))
+	    return 1;
+
+	if (rt_prep_get_uint32(&s) != (uint64_t)sb.st_size)
+	    return 1;
+	hi = rt_prep_get_uint32(&s);
+	lo = rt_prep_get_uint32(&s);
+	if (s.err || (((uint64_t)hi << 32) | lo) != (uint64_t)sb.st_mtime)
+	    return 1;
+	if (brick_map_get(&s, &bricks, vip->xdim, vip->ydim, vip->zdim))
+	    return 1;
+
+	volp = vol_prep_specific(stp, (struct rt_db_internal *)ip);
+	volp->vol_bricks = bricks;	/* struct copy */
+	return 0;
+    }
+}
+
+
 void
 rt_vol_print(register const struct soltab *stp)
 {
@@ -1141,6 +1268,7 @@ rt_vol_free(struct soltab *stp)
 	bu_free((char *)volp->vol_i.map, "vol_map");
 	volp->vol_i.map = NULL; /* sanity */
     }
+    brick_map_free(&volp->vol_bricks);
     BU_PUT(volp, struct rt_vol_specific);
 }
 
@@ -1155,7 +1283,7 @@ rt_vol_plot(struct bu_list *vhead, struct rt_db_internal *ip, const struct bg_te
 
     BU_CK_LIST_HEAD(vhead);
     RT_CK_DB_INTERNAL(ip);
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
     vip = (struct rt_vol_internal *)ip->idb_ptr;
     RT_VOL_CK_MAGIC(vip);
 
@@ -1284,7 +1412,7 @@ rt_vol_tess(struct nmgregion **r, struct model *m, struct rt_db_internal *ip, co
     struct faceuse *fu;
     struct model *m_tmp;
     struct nmgregion *r_tmp;
-    struct bu_list *vlfree = &rt_vlfree;
+    struct bu_list *vlfree = rt_vlfree_get();
 
     NMG_CK_MODEL(m);
     BN_CK_TOL(tol);
@@ -352,6 +352,556 @@ rt_poly_roots(bn_poly_t *eqn,	/* equation to be solved */
 }
 
 
+/* Real root isolation.
+ *
+ * Polynomials are handled monic.  The Sturm sequence of p is p, p'
+ * and then the negated remainders of successive divisions; the number
+ * of sign changes along the sequence drops by one at each distinct
+ * real root as x increases, which makes the count of roots in an
+ * interval exact up to the rounding of the coefficients.
+ */
+
+#define ROOT_MAX_ITER 64
+#define ROOT_REL_TOL 1.0e-13	/* relative width at which a root is settled */
+#define STURM_ZERO_TOL 1.0e-12	/* remainder, relative to dividend, taken as zero */
+#define RT_POLY_ROOTS_BLOCK 64	/* polynomials per pass of rt_poly_real_roots_n() */
+
+struct sturm_chain {
+    int n;			/* number of polynomials in the chain */
+    bn_poly_t p[BN_MAX_POLY_DEGREE + 1];
+};
+
+
+static fastf_t
+poly_eval(const bn_poly_t *eqn, fastf_t x)
+{
+    fastf_t v = eqn->cf[0];
+    size_t i;
+
+    for (i = 1; i <= eqn->dgr; i++)
+	v = v * x + eqn->cf[i];
+    return v;
+}
+
+
+static void
+poly_eval_w_deriv(const bn_poly_t *eqn, fastf_t x, fastf_t *v, fastf_t *dv)
+{
+    fastf_t p = eqn->cf[0], d = 0.0;
+    size_t i;
+
+    for (i = 1; i <= eqn->dgr; i++) {
+	d = d * x + p;
+	p = p * x + eqn->cf[i];
+    }
+    *v = p;
+    *dv = d;
+}
+
+
+static void
+poly_deriv(bn_poly_t *d, const bn_poly_t *eqn)
+{
+    size_t i;
+
+    d->magic = BN_POLY_MAGIC;
+    d->dgr = eqn->dgr - 1;
+    for (i = 0; i < eqn->dgr; i++)
+	d->cf[i] = eqn->cf[i] * (fastf_t)(eqn->dgr - i);
+}
+
+
+static fastf_t
+poly_norm(const bn_poly_t *eqn)
+{
+    fastf_t m = 0.0;
+    size_t i;
+
+    for (i = 0; i <= eqn->dgr; i++)
+	V_MAX(m, fabs(eqn->cf[i]));
+    return m;
+}
+
+
+/**
+ * Build the Sturm sequence of the monic polynomial eqn.  When eqn has
+ * multiple roots the sequence ends at their greatest common divisor
+ * with p', which keeps the count of distinct roots correct.
+ */
+static void
+sturm_build(struct sturm_chain *sc, const bn_poly_t *eqn)
+{
+    bn_poly_t *a, *b, *r;
+    fastf_t q, scale;
+    size_t i, j;
+
+    sc->p[0] = *eqn;
+    poly_deriv(&sc->p[1], eqn);
+    sc->n = 2;
+
+    while (sc->p[sc->n - 1].dgr > 0) {
+	a = &sc->p[sc->n - 2];
+	b = &sc->p[sc->n - 1];
+	r = &sc->p[sc->n];
+
+	/* remainder of a / b, computed in place on a copy of a */
+	*r = *a;
+	for (i = 0; i + b->dgr <= a->dgr; i++) {
+	    q = r->cf[i] / b->cf[0];
+	    for (j = 0; j <= b->dgr; j++)
+		r->cf[i + j] -= q * b->cf[j];
+	}
+
+	/* shift out the quotient's terms, negate the rest */
+	r->dgr = b->dgr - 1;
+	scale = poly_norm(a);
+	for (j = 0; j <= r->dgr; j++)
+	    r->cf[j] = -r->cf[a->dgr - b->dgr + 1 + j];
+
+	/* drop leading coefficients lost in the rounding */
+	while (r->dgr > 0 && fabs(r->cf[0]) <= STURM_ZERO_TOL * scale) {
+	    for (j = 0; j < r->dgr; j++)
+		r->cf[j] = r->cf[j + 1];
+	    r->dgr--;
+	}
+	if (fabs(r->cf[0]) <= STURM_ZERO_TOL * scale)
+	    break;	/* b divides a: multiple roots */
+
+	sc->n++;
+    }
+}
+
+
+static int
+sturm_changes(const struct sturm_chain *sc, fastf_t x)
+{
+    fastf_t v, last = 0.0;
+    int i, changes = 0;
+
+    for (i = 0; i < sc->n; i++) {
+	v = poly_eval(&sc->p[i], x);
+	if (ZERO(v))
+	    continue;
+	if ((last < 0.0 && v > 0.0) || (last > 0.0 && v < 0.0))
+	    changes++;
+	last = v;
+    }
+    return changes;
+}
+
+
+/**
+ * Newton's method kept inside the bracket [a, b], across which
+ * eqn changes sign, falling back to bisection whenever a step would
+ * leave it or stalls.
+ */
+static fastf_t
+root_bracketed(const bn_poly_t *eqn, fastf_t a, fastf_t b, fastf_t fa)
+{
+    fastf_t x = 0.5 * (a + b);
+    fastf_t f, df, step, prev = b - a;
+    int i;
+
+    for (i = 0; i < ROOT_MAX_ITER; i++) {
+	poly_eval_w_deriv(eqn, x, &f, &df);
+	if (ZERO(f))
+	    return x;
+
+	/* shrink the bracket around the root */
+	if ((f < 0.0) == (fa < 0.0)) {
+	    a = x;
+	    fa = f;
+	} else {
+	    b = x;
+	}
+
+	step = ZERO(df) ? INFINITY : f / df;
+	if (x - step <= a || x - step >= b || fabs(step) > 0.5 * fabs(prev)) {
+	    step = x - 0.5 * (a + b);
+	}
+	prev = step;
+	x -= step;
+
+	if (fabs(step) <= ROOT_REL_TOL * (1.0 + fabs(x)) || b - a <= ROOT_REL_TOL * (1.0 + fabs(x)))
+	    break;
+    }
+    return x;
+}
+
+
+/**
+ * Settle the one distinct root isolated in [a, b], storing it once for
+ * odd multiplicity and twice for even, where the polynomial touches
+ * zero without changing sign.
+ */
+static int
+root_isolated(const struct sturm_chain *sc, fastf_t a, fastf_t b, fastf_t roots[])
+{
+    const bn_poly_t *eqn = &sc->p[0];
+    const bn_poly_t *g = &sc->p[sc->n - 1];
+    fastf_t fa = poly_eval(eqn, a);
+    fastf_t fb = poly_eval(eqn, b);
+    fastf_t m;
+    int i, ca, cm;
+
+    if (ZERO(fa)) {
+	roots[0] = a;
+	return 1;
+    }
+    if ((fa < 0.0) != (fb < 0.0) || ZERO(fb)) {
+	roots[0] = ZERO(fb) ? b : root_bracketed(eqn, a, b, fa);
+	return 1;
+    }
+
+    /* A multiple root is a simple root of the last polynomial of the
+     * sequence, the greatest common divisor of p and p'.
+     */
+    fa = poly_eval(g, a);
+    fb = poly_eval(g, b);
+    if (g->dgr > 0 && !ZERO(fa) && (fa < 0.0) != (fb < 0.0)) {
+	roots[0] = root_bracketed(g, a, b, fa);
+    } else {
+	/* rounding hid it; narrow in on it with the counts instead */
+	ca = sturm_changes(sc, a);
+	for (i = 0; i < ROOT_MAX_ITER && b - a > ROOT_REL_TOL * (1.0 + fabs(a)); i++) {
+	    m = 0.5 * (a + b);
+	    cm = sturm_changes(sc, m);
+	    if (cm < ca)
+		b = m;
+	    else
+		a = m;
+	}
+	roots[0] = 0.5 * (a + b);
+    }
+    roots[1] = roots[0];
+    return 2;
+}
+
+
+/**
+ * Find the roots in [a, b] where ca and cb are the Sturm sign changes
+ * at the ends.
+ */
+static int
+roots_sturm(const struct sturm_chain *sc, fastf_t a, fastf_t b, int ca, int cb, fastf_t roots[], int depth)
+{
+    fastf_t m;
+    int cm, n, i;
+
+    if (ca - cb <= 0)
+	return 0;
+    if (ca - cb == 1)
+	return root_isolated(sc, a, b, roots);
+
+    m = 0.5 * (a + b);
+    if (depth >= ROOT_MAX_ITER || b - a <= ROOT_REL_TOL * (1.0 + fabs(m))) {
+	/* a cluster closer than we can resolve */
+	for (i = 0; i < ca - cb; i++)
+	    roots[i] = m;
+	return ca - cb;
+    }
+
+    cm = sturm_changes(sc, m);
+    n = roots_sturm(sc, a, m, ca, cm, roots, depth + 1);
+    return n + roots_sturm(sc, m, b, cm, cb, roots + n, depth + 1);
+}
+
+
+/**
+ * Normalize eqn into p: leading coefficients too close to zero are
+ * dropped and the result scaled to be monic.  Returns the degree.
+ */
+static int
+poly_monic(bn_poly_t *p, const bn_poly_t *eqn)
+{
+    fastf_t factor;
+    size_t i, lead = 0;
+
+    while (lead < eqn->dgr && ZERO(eqn->cf[lead]))
+	lead++;
+
+    p->magic = BN_POLY_MAGIC;
+    p->dgr = eqn->dgr - lead;
+    if (p->dgr == 0)
+	return 0;
+
+    factor = 1.0 / eqn->cf[lead];
+    p->cf[0] = 1.0;
+    for (i = 1; i <= p->dgr; i++)
+	p->cf[i] = eqn->cf[lead + i] * factor;
+    return (int)p->dgr;
+}
+
+
+/**
+ * Closed form roots of one polynomial, split into the real ones and
+ * the complex ones close enough to the real axis to be a near miss or
+ * a graze.
+ */
+struct roots_cf {
+    int n;			/* real roots in re[], -1 if the closed form failed */
+    int nnear;			/* nearly real roots in near[] */
+    fastf_t re[4];
+    fastf_t near[4];
+};
+
+
+/* insertion sort, ascending */
+static void
+roots_insert(fastf_t roots[], int *n, fastf_t x)
+{
+    int j;
+
+    for (j = *n; j > 0 && roots[j - 1] > x; j--)
+	roots[j] = roots[j - 1];
+    roots[j] = x;
+    (*n)++;
+}
+
+
+/**
+ * Closed form roots of a monic quadratic, cubic or quartic: the
+ * candidates in [lo, hi], polished against p.  Nearly real roots are
+ * kept apart for the Sturm count to settle.
+ */
+static void
+roots_closed_form(const bn_poly_t *p, fastf_t lo, fastf_t hi, struct roots_cf *cf)
+{
+    bn_complex_t cx[4];
+    fastf_t x, f, df;
+    int i, j, ok;
+
+    cf->n = -1;
+    cf->nnear = 0;
+    switch (p->dgr) {
+	case 2:
+	    ok = bn_poly_quadratic_roots(cx, p);
+	    break;
+	case 3:
+	    ok = bn_poly_cubic_roots(cx, p);
+	    break;
+	case 4:
+	    ok = bn_poly_quartic_roots(cx, p);
+	    break;
+	default:
+	    return;
+    }
+    if (!ok)
+	return;
+
+    cf->n = 0;
+    for (i = 0; i < (int)p->dgr; i++) {
+	x = cx[i].re;
+	if (!ZERO(cx[i].im) && fabs(cx[i].im) > RT_ROOT_TOL * (1.0 + fabs(x)))
+	    continue;
+
+	/* a couple of Newton steps recover the digits the closed
+	 * form loses near multiple roots
+	 */
+	for (j = 0; j < 2; j++) {
+	    poly_eval_w_deriv(p, x, &f, &df);
+	    if (ZERO(df) || fabs(f) > RT_ROOT_TOL * (1.0 + fabs(x)) * fabs(df))
+		break;
+	    x -= f / df;
+	}
+
+	if (x < lo || x > hi)
+	    continue;
+
+	if (ZERO(cx[i].im))
+	    roots_insert(cf->re, &cf->n, x);
+	else
+	    roots_insert(cf->near, &cf->nnear, x);
+    }
+}
+
+
+/**
+ * Check closed form roots against the Sturm count of distinct roots
+ * in [lo, hi]; roots closer together than can be resolved count once.
+ */
+static int
+roots_certified(const fastf_t roots[], int n, int distinct)
+{
+    int i, d = (n > 0);
+
+    for (i = 1; i < n; i++) {
+	if (roots[i] - roots[i - 1] > RT_ROOT_TOL * (1.0 + fabs(roots[i])))
+	    d++;
+    }
+    return d == distinct;
+}
+
+
+/**
+ * Merge the ascending roots a[] and b[] into out[], keeping at most
+ * max of them.  Returns the count.
+ */
+static int
+roots_merge(fastf_t out[], const fastf_t a[], int na, const fastf_t b[], int nb, int max)
+{
+    int i = 0, j = 0, n = 0;
+
+    while (n < max && (i < na || j < nb)) {
+	if (j >= nb || (i < na && a[i] <= b[j]))
+	    out[n++] = a[i++];
+	else
+	    out[n++] = b[j++];
+    }
+    return n;
+}
+
+
+/**
+ * Solve one monic polynomial p given its closed form roots in cf,
+ * which are taken only if they agree with the Sturm count.  When
+ * keep_near is set the nearly real roots the count leaves out are
+ * stored too.
+ */
+static int
+roots_finish(const bn_poly_t *p, fastf_t lo, fastf_t hi, fastf_t roots[], const struct roots_cf *cf, int keep_near)
+{
+    struct sturm_chain sc;
+    fastf_t all[BN_MAX_POLY_DEGREE], missed[4];
+    int ca, cb, i, j, n, nall, nmissed = 0;
+
+    if (p->dgr == 1) {
+	roots[0] = -p->cf[1];
+	return (roots[0] >= lo && roots[0] <= hi);
+    }
+
+    sturm_build(&sc, p);
+    ca = sturm_changes(&sc, lo);
+    cb = sturm_changes(&sc, hi);
+
+    if (cf->n >= 0) {
+	nall = roots_merge(all, cf->re, cf->n, cf->near, cf->nnear, (int)p->dgr);
+
+	/* the nearly real roots are a graze the closed form put just
+	 * off the real axis
+	 */
+	if (roots_certified(all, nall, ca - cb)) {
+	    for (i = 0; i < nall; i++)
+		roots[i] = all[i];
+	    return nall;
+	}
+
+	/* they are near misses */
+	if (roots_certified(cf->re, cf->n, ca - cb)) {
+	    if (keep_near) {
+		for (i = 0; i < nall; i++)
+		    roots[i] = all[i];
+		return nall;
+	    }
+	    for (i = 0; i < cf->n; i++)
+		roots[i] = cf->re[i];
+	    return cf->n;
+	}
+    }
+
+    n = roots_sturm(&sc, lo, hi, ca, cb, roots, 0);
+    if (!keep_near || cf->n < 0 || !cf->nnear)
+	return n;
+
+    /* add the near misses the isolated roots do not already cover */
+    for (i = 0; i < cf->nnear; i++) {
+	for (j = 0; j < n; j++) {
+	    if (NEAR_EQUAL(roots[j], cf->near[i], RT_ROOT_TOL * (1.0 + fabs(roots[j]))))
+		break;
+	}
+	if (j == n)
+	    missed[nmissed++] = cf->near[i];
+    }
+    nall = roots_merge(all, roots, n, missed, nmissed, (int)p->dgr);
+    for (i = 0; i < nall; i++)
+	roots[i] = all[i];
+    return nall;
+}
+
+
+static int
+roots_solve(const bn_poly_t *eqn, fastf_t lo, fastf_t hi, fastf_t roots[], int keep_near)
+{
+    bn_poly_t p;
+    struct roots_cf cf;
+
+    if (poly_monic(&p, eqn) == 0 || hi < lo)
+	return 0;
+
+    cf.n = -1;
+    cf.nnear = 0;
+    if (p.dgr <= 4)
+	roots_closed_form(&p, lo, hi, &cf);
+
+    return roots_finish(&p, lo, hi, roots, &cf, keep_near);
+}
+
+
+static void
+roots_solve_n(size_t n, const bn_poly_t *eqns, const fastf_t lo[], const fastf_t hi[], fastf_t roots[], int nroots[], int keep_near)
+{
+    bn_poly_t p[RT_POLY_ROOTS_BLOCK];
+    struct roots_cf cf[RT_POLY_ROOTS_BLOCK];
+    size_t base, m, i;
+
+    for (base = 0; base < n; base += m) {
+	m = FMIN(n - base, RT_POLY_ROOTS_BLOCK);
+
+	/* closed forms for the whole block first; the per-polynomial
+	 * work below is left with only the checks and the rare
+	 * fallback
+	 */
+	for (i = 0; i < m; i++) {
+	    cf[i].n = -1;
+	    cf[i].nnear = 0;
+	    if (poly_monic(&p[i], &eqns[base + i]) == 0 || hi[base + i] < lo[base + i]) {
+		p[i].dgr = 0;
+		continue;
+	    }
+	    if (p[i].dgr <= 4)
+		roots_closed_form(&p[i], lo[base + i], hi[base + i], &cf[i]);
+	}
+
+	for (i = 0; i < m; i++) {
+	    if (p[i].dgr == 0) {
+		nroots[base + i] = 0;
+		continue;
+	    }
+	    nroots[base + i] = roots_finish(&p[i], lo[base + i], hi[base + i],
+					    &roots[(base + i) * BN_MAX_POLY_DEGREE], &cf[i], keep_near);
+	}
+    }
+}
+
+
+int
+rt_poly_real_roots(const bn_poly_t *eqn, fastf_t lo, fastf_t hi, fastf_t roots[])
+{
+    return roots_solve(eqn, lo, hi, roots, 0);
+}
+
+
+void
+rt_poly_real_roots_n(size_t n, const bn_poly_t *eqns, const fastf_t lo[], const fastf_t hi[], fastf_t roots[], int nroots[])
+{
+    roots_solve_n(n, eqns, lo, hi, roots, nroots, 0);
+}
+
+
+int
+rt_poly_near_real_roots(const bn_poly_t *eqn, fastf_t lo, fastf_t hi, fastf_t roots[])
+{
+    return roots_solve(eqn, lo, hi, roots, 1);
+}
+
+
+void
+rt_poly_near_real_roots_n(size_t n, const bn_poly_t *eqns, const fastf_t lo[], const fastf_t hi[], fastf_t roots[], int nroots[])
+{
+    roots_solve_n(n, eqns, lo, hi, roots, nroots, 1);
+}
+
+
 /*
  * Local Variables:
  * mode: C
@@ -44,12 +44,28 @@
 /* container holding reusable vlists */
 struct bu_list rt_vlfree = BU_LIST_INIT_ZERO;
 
+/* per-thread replacement for rt_vlfree, see rt_vlfree_set() */
+static THREADLOCAL struct bu_list *rt_vlfree_thread = NULL;
+
 /* uniprocessor pre-prepared resource */
 struct resource rt_uniresource = RT_RESOURCE_INIT_ZERO;
 
 /* Debug flags */
 unsigned int rt_debug = 0;
 
+struct bu_list *
+rt_vlfree_get(void)
+{
+    return (rt_vlfree_thread) ? rt_vlfree_thread : &rt_vlfree;
+}
+
+void
+rt_vlfree_set(struct bu_list *hd)
+{
+    rt_vlfree_thread = hd;
+}
+
+
 /*****************************************************************************
  * librt initialization logic
  *****************************************************************************/
@@ -30,6 +30,20 @@
 #include "raytrace.h"
 #include "bv/plot3.h"
 
+#include "./librt_private.h"
+#include "./cut_hlbvh.h"
+
+/* depth limit for the RT_PART_HLBVH traversal stack */
+#define SHOOT_BVH_STACK_SIZE 256
+
+/* depth limit for the ray packet traversal stack */
+#define SHOOT_PACKET_STACK_SIZE 128
+
+/* per-ray states in rt_shootray_packet() */
+#define SHOOT_PACKET_TRACE	0	/* still being traced */
+#define SHOOT_PACKET_DONE	1	/* enough partitions for a_onehit */
+#define SHOOT_PACKET_MISS	2	/* missed the model RPP */
+#define SHOOT_PACKET_SINGLE	3	/* handed to rt_shootray() */
 
 #define V3PT_DEPARTING_RPP(_step, _lo, _hi, _pt)			\
     PT_DEPARTING_RPP(_step, _lo, _hi, (_pt)[X], (_pt)[Y], (_pt)[Z])
@@ -640,11 +654,528 @@ rt_plot_cell(const union cutter *cutp, const struct rt_shootray_status *ssp, str
 }
 
 
+/**
+ * Compute the inverses of the ray's direction cosines and the step
+ * direction along each axis.  Direction components too small to
+ * invert are zeroed.
+ */
+static inline void
+shoot_inv_dir(struct rt_shootray_status *ss, struct xray *rp)
+{
+    if (rp->r_dir[X] < -SQRT_SMALL_FASTF) {
+	ss->abs_inv_dir[X] = -(ss->inv_dir[X]=1.0/rp->r_dir[X]);
+	ss->rstep[X] = -1;
+    } else if (rp->r_dir[X] > SQRT_SMALL_FASTF) {
+	ss->abs_inv_dir[X] =  (ss->inv_dir[X]=1.0/rp->r_dir[X]);
+	ss->rstep[X] = 1;
+    } else {
+	rp->r_dir[X] = 0.0;
+	ss->abs_inv_dir[X] = ss->inv_dir[X] = INFINITY;
+	ss->rstep[X] = 0;
+    }
+    if (rp->r_dir[Y] < -SQRT_SMALL_FASTF) {
+	ss->abs_inv_dir[Y] = -(ss->inv_dir[Y]=1.0/rp->r_dir[Y]);
+	ss->rstep[Y] = -1;
+    } else if (rp->r_dir[Y] > SQRT_SMALL_FASTF) {
+	ss->abs_inv_dir[Y] =  (ss->inv_dir[Y]=1.0/rp->r_dir[Y]);
+	ss->rstep[Y] = 1;
+    } else {
+	rp->r_dir[Y] = 0.0;
+	ss->abs_inv_dir[Y] = ss->inv_dir[Y] = INFINITY;
+	ss->rstep[Y] = 0;
+    }
+    if (rp->r_dir[Z] < -SQRT_SMALL_FASTF) {
+	ss->abs_inv_dir[Z] = -(ss->inv_dir[Z]=1.0/rp->r_dir[Z]);
+	ss->rstep[Z] = -1;
+    } else if (rp->r_dir[Z] > SQRT_SMALL_FASTF) {
+	ss->abs_inv_dir[Z] =  (ss->inv_dir[Z]=1.0/rp->r_dir[Z]);
+	ss->rstep[Z] = 1;
+    } else {
+	rp->r_dir[Z] = 0.0;
+	ss->abs_inv_dir[Z] = ss->inv_dir[Z] = INFINITY;
+	ss->rstep[Z] = 0;
+    }
+}
+
+
+/**
+ * Decide whether the ray needs to be intersected with a solid: it must
+ * not have been shot yet, and the ray must pass the solid's bounding
+ * RPP if the solid wants that check.  Marks the solid as shot.
+ *
+ * Returns -
+ * 1 if the solid should be shot
+ * 0 if it can be skipped
+ */
+static inline int
+shoot_solid_candidate(struct soltab *stp, struct rt_shootray_status *ssp, struct bu_bitv *solidbits)
+{
+    struct resource *resp = ssp->resp;
+    const int debug_shoot = RT_G_DEBUG & RT_DEBUG_SHOOT;
+
+    if (BU_BITTEST(solidbits, stp->st_bit)) {
+	resp->re_ndup++;
+	return 0;	/* already shot */
+    }
+
+    /* Shoot a ray */
+    BU_BITSET(solidbits, stp->st_bit);
+
+    /* Check against bounding RPP, if desired by solid */
+    if (stp->st_meth->ft_use_rpp) {
+	if (!rt_in_rpp(&ssp->newray, ssp->inv_dir,
+		       stp->st_min, stp->st_max)) {
+	    if (debug_shoot)bu_log("rpp miss %s\n", stp->st_name);
+	    resp->re_prune_solrpp++;
+	    return 0;	/* MISS */
+	}
+	if (ssp->dist_corr + ssp->newray.r_max < BACKING_DIST) {
+	    if (debug_shoot)bu_log("rpp skip %s, dist_corr=%g, r_max=%g\n", stp->st_name, ssp->dist_corr, ssp->newray.r_max);
+	    resp->re_prune_solrpp++;
+	    return 0;	/* MISS */
+	}
+    }
+
+    if (debug_shoot)bu_log("shooting %s\n", stp->st_name);
+    resp->re_shots++;
+    return 1;
+}
+
+
+/**
+ * Record the result of a solid intersection, moving any new segments
+ * to the list awaiting rt_boolweave().
+ */
+static inline void
+shoot_solid_segs(int ret, struct seg *new_segs, struct rt_shootray_status *ssp, struct seg *waiting_segs)
+{
+    struct application *ap = ssp->ap;
+    struct resource *resp = ssp->resp;
+    register struct seg *s2;
+
+    if (ret <= 0) {
+	resp->re_shot_miss++;
+	return;	/* MISS */
+    }
+
+    /* Add seg chain to list awaiting rt_boolweave() */
+    while (BU_LIST_WHILE(s2, seg, &(new_segs->l))) {
+	BU_LIST_DEQUEUE(&(s2->l));
+	/* Restore to original distance */
+	s2->seg_in.hit_dist += ssp->dist_corr;
+	s2->seg_out.hit_dist += ssp->dist_corr;
+	s2->seg_in.hit_rayp = s2->seg_out.hit_rayp = &ap->a_ray;
+	BU_LIST_INSERT(&(waiting_segs->l), &(s2->l));
+    }
+    resp->re_shot_hit++;
+}
+
+
+/**
+ * Intersect the ray with one solid that has not been shot yet and add
+ * any resulting segments to the waiting list.  Shared by the cell walk
+ * and the BVH walks.
+ */
+static inline void
+shoot_solid(struct soltab *stp, struct rt_shootray_status *ssp, struct bu_bitv *solidbits, struct seg *waiting_segs)
+{
+    struct seg new_segs;	/* from solid intersections */
+    int ret;
+
+    if (!shoot_solid_candidate(stp, ssp, solidbits))
+	return;
+
+    BU_LIST_INIT(&(new_segs.l));
+
+    ret = -1;
+    if (stp->st_meth->ft_shot) {
+	ret = stp->st_meth->ft_shot(stp, &ssp->newray, ssp->ap, &new_segs);
+    }
+    shoot_solid_segs(ret, &new_segs, ssp, waiting_segs);
+}
+
+
+/**
+ * Let every solid using pieces in this cell shoot its pieces, turning
+ * the hits of each solid the ray has finished passing through into
+ * segments on the waiting list.  Solids still being passed through
+ * are left on re_pieces_pending.
+ */
+static void
+shoot_pieces(const union cutter *cutp, struct rt_shootray_status *ssp, struct bu_bitv *solidbits, struct bu_bitv *backbits, struct seg *waiting_segs)
+{
+    struct application *ap = ssp->ap;
+    struct resource *resp = ssp->resp;
+    const int debug_shoot = RT_G_DEBUG & RT_DEBUG_SHOOT;
+    register struct rt_piecelist *plp;
+
+    plp = &(cutp->bn.bn_piecelist[cutp->bn.bn_piecelen-1]);
+    for (; plp >= cutp->bn.bn_piecelist; plp--) {
+	struct rt_piecestate *psp;
+	struct soltab *stp;
+	int ret;
+	int had_hits_before;
+
+	RT_CK_PIECELIST(plp);
+
+	/* Consider all pieces of this one solid in this
+	 * cell.
+	 */
+	stp = plp->stp;
+	RT_CK_SOLTAB(stp);
+
+	if (backbits && ssp->box_end < BACKING_DIST && BU_BITTEST(backbits, stp->st_bit) == 0) {
+	    /* we are behind the ray start point and this
+	     * primitive is not one that we need to intersect
+	     * back here.
+	     */
+	    continue;
+	}
+
+	psp = &(resp->re_pieces[stp->st_piecestate_num]);
+	RT_CK_PIECESTATE(psp);
+	if (psp->ray_seqno != resp->re_nshootray) {
+	    /* state is from an earlier ray, scrub */
+	    BU_BITV_ZEROALL(psp->shot);
+	    psp->ray_seqno = resp->re_nshootray;
+	    rt_htbl_reset(&psp->htab);
+
+	    /* Compute ray entry and exit to entire solid's
+	     * bounding box.
+	     */
+	    if (!rt_in_rpp(&ssp->newray, ssp->inv_dir,
+			   stp->st_min, stp->st_max)) {
+		if (debug_shoot)bu_log("rpp miss %s (all pieces)\n", stp->st_name);
+		resp->re_prune_solrpp++;
+		BU_BITSET(solidbits, stp->st_bit);
+		continue;   /* MISS */
+	    }
+	    psp->mindist = ssp->newray.r_min + ssp->dist_corr;
+	    psp->maxdist = ssp->newray.r_max + ssp->dist_corr;
+	    if (debug_shoot) bu_log("%s mindist=%g, maxdist=%g\n", stp->st_name, psp->mindist, psp->maxdist);
+	    had_hits_before = 0;
+	} else {
+	    if (BU_BITTEST(solidbits, stp->st_bit)) {
+		/* we missed the solid RPP in an earlier cell */
+		resp->re_ndup++;
+		continue;   /* already shot */
+	    }
+	    had_hits_before = psp->htab.end;
+	}
+
+	/*
+	 * Allow this solid to shoot at all of its 'pieces' in
+	 * this cell, all at once.  'newray' has been
+	 * transformed to be near to this cell, and
+	 * 'dist_corr' is the additive correction factor that
+	 * ft_piece_shot() must apply to hits calculated using
+	 * 'newray'.
+	 */
+	resp->re_piece_shots++;
+	psp->cutp = cutp;
+
+	ret = -1;
+	if (stp->st_meth->ft_piece_shot) {
+	    ret = stp->st_meth->ft_piece_shot(psp, plp, ssp->dist_corr, &ssp->newray, ap, waiting_segs);
+	}
+	if (ret <= 0) {
+	    /* No hits at all */
+	    resp->re_piece_shot_miss++;
+	} else {
+	    resp->re_piece_shot_hit++;
+	}
+	if (debug_shoot)bu_log("shooting %s pieces, nhit=%d\n", stp->st_name, ret);
+
+	/* See if this solid has been fully processed yet.  If
+	 * ray has passed through bounding volume, we're done.
+	 * ft_piece_hitsegs() will only be called once per
+	 * ray.
+	 */
+	if (ssp->box_end > psp->maxdist && psp->htab.end > 0) {
+	    /* Convert hits into segs */
+	    if (debug_shoot)bu_log("shooting %s pieces complete, making segs\n", stp->st_name);
+	    /* Distance correction was handled in ft_piece_shot */
+	    if (stp->st_meth->ft_piece_hitsegs)
+		stp->st_meth->ft_piece_hitsegs(psp, waiting_segs, ap);
+	    rt_htbl_reset(&psp->htab);
+	    BU_BITSET(solidbits, stp->st_bit);
+
+	    if (had_hits_before)
+		bu_ptbl_rm(&resp->re_pieces_pending, (long *)psp);
+	} else {
+	    if (!had_hits_before)
+		bu_ptbl_ins_unique(&resp->re_pieces_pending, (long *)psp);
+	}
+    }
+}
+
+
+/**
+ * Convert the hits of any solids still pending on re_pieces_pending
+ * into segments on the waiting list, emptying the table.
+ */
+static void
+shoot_pieces_flush(struct resource *resp, struct seg *waiting_segs, struct application *ap)
+{
+    struct rt_piecestate **psp;
+
+    if (BU_PTBL_LEN(&resp->re_pieces_pending) <= 0)
+	return;
+
+    for (BU_PTBL_FOR(psp, (struct rt_piecestate **), &resp->re_pieces_pending)) {
+	if ((*psp)->htab.end > 0) {
+	    /* Convert any pending hits into segs */
+	    /* Distance correction was handled in ft_piece_shot */
+	    (*psp)->stp->st_meth->ft_piece_hitsegs(*psp, waiting_segs, ap);
+	    rt_htbl_reset(&(*psp)->htab);
+	}
+	*psp = NULL;
+    }
+    bu_ptbl_reset(&resp->re_pieces_pending);
+}
+
+
+/**
+ * Compute the parametric interval over which the ray is inside a BVH
+ * node's bounds.  Axes the ray does not move along are handled
+ * explicitly so no 0*inf products are formed.
+ *
+ * Returns -
+ * 0 if the ray misses the node
+ * 1 if it hits, with the interval in *tminp and *tmaxp
+ */
+static inline int
+shoot_bvh_node_interval(const struct bvh_flat_node *node, const struct rt_shootray_status *ssp, fastf_t *tminp, fastf_t *tmaxp)
+{
+    const fastf_t *pt = ssp->ap->a_ray.r_pt;
+    fastf_t tmin = -INFINITY;
+    fastf_t tmax = INFINITY;
+    int i;
+
+    for (i = X; i <= Z; i++) {
+	fastf_t t0, t1;
+
+	if (ssp->rstep[i] == 0) {
+	    if (pt[i] < node->bounds[i] || pt[i] > node->bounds[3+i])
+		return 0;
+	    continue;
+	}
+	t0 = (node->bounds[i] - pt[i]) * ssp->inv_dir[i];
+	t1 = (node->bounds[3+i] - pt[i]) * ssp->inv_dir[i];
+	if (ssp->rstep[i] < 0) {
+	    fastf_t tt = t0;
+	    t0 = t1;
+	    t1 = tt;
+	}
+	if (t0 > tmin) tmin = t0;
+	if (t1 < tmax) tmax = t1;
+	if (tmin > tmax)
+	    return 0;
+    }
+
+    *tminp = tmin;
+    *tmaxp = tmax;
+    return 1;
+}
+
+
+/* what rt_occluded() is looking for along its ray */
+struct shoot_occlusion {
+    fastf_t mindist;
+    fastf_t maxdist;
+    int (*opaque)(struct application *, const struct region *);
+    int unresolved;	/* a segment in range was not provably opaque */
+};
+
+
+/**
+ * Consume the waiting segments, looking for one that enters the ray
+ * between mindist and maxdist on a solid that provably lies inside an
+ * opaque region.  A region whose boolean tree is all unions contains
+ * every point of each of its solids, so any segment of such a solid is
+ * inside the region without weaving or evaluating partitions.
+ *
+ * Returns -
+ * 1 if the ray is occluded
+ * 0 if not (yet)
+ */
+static int
+shoot_occlusion_scan(struct shoot_occlusion *occl, struct seg *waiting_segs, struct application *ap)
+{
+    struct seg *segp;
+    int occluded = 0;
+
+    while (BU_LIST_WHILE(segp, seg, &(waiting_segs->l))) {
+	BU_LIST_DEQUEUE(&(segp->l));
+
+	if (!occluded &&
+	    segp->seg_out.hit_dist > occl->mindist &&
+	    segp->seg_in.hit_dist < occl->maxdist) {
+	    struct region **regpp;
+
+	    if (segp->seg_in.hit_dist > occl->mindist) {
+		for (BU_PTBL_FOR(regpp, (struct region **), &segp->seg_stp->st_regions)) {
+		    if (!(*regpp)->reg_all_unions)
+			continue;
+		    if (occl->opaque && !occl->opaque(ap, *regpp))
+			continue;
+		    occluded = 1;
+		    break;
+		}
+	    }
+	    if (!occluded)
+		occl->unresolved = 1;
+	}
+
+	RT_FREE_SEG(segp, ap->a_resource);
+    }
+
+    return occluded;
+}
+
+
+struct shoot_bvh_entry {
+    const struct bvh_flat_node *node;
+    fastf_t tmin;
+};
+
+
+/**
+ * RT_PART_HLBVH counterpart of the cell walk in rt_shootray().  Nodes
+ * are visited nearest first.  When the application wants early
+ * termination (a_onehit != 0) the partitions are evaluated after each
+ * leaf up to the closest entry distance of any node still pending,
+ * since no solid beyond that point has been shot yet.  For
+ * rt_occluded() (occl non-NULL) the segments of each leaf are scanned
+ * instead and no partitions are built at all.
+ *
+ * Returns -
+ * 1 if enough final partitions were acquired (caller should go to hitit),
+ *   or with occl, if the ray was found to be occluded
+ * 0 when the ray has left the hierarchy
+ */
+static int
+shoot_bvh(struct rt_shootray_status *ssp, struct bu_bitv *solidbits, struct bu_ptbl *regionbits, struct seg *waiting_segs, struct partition *InitialPart, struct partition *FinalPart, fastf_t *last_bool_start, struct shoot_occlusion *occl)
+{
+    struct application *ap = ssp->ap;
+    struct rt_i *rtip = ap->a_rt_i;
+    const int debug_shoot = RT_G_DEBUG & RT_DEBUG_SHOOT;
+    struct shoot_bvh_entry stack[SHOOT_BVH_STACK_SIZE];
+    int sp = 0;
+    fastf_t tmin, tmax;
+    size_t i;
+
+    /* Infinite solids are not in the hierarchy, shoot them up front */
+    for (i = 0; i < rtip->rti_inf_box.bn.bn_len; i++)
+	shoot_solid(rtip->rti_inf_box.bn.bn_list[i], ssp, solidbits, waiting_segs);
+    if (occl && shoot_occlusion_scan(occl, waiting_segs, ap))
+	return 1;
+
+    if (!shoot_bvh_node_interval(rtip->rti_bvh_nodes, ssp, &tmin, &tmax) ||
+	tmax < ssp->box_start || tmin > ssp->box_end)
+	return 0;
+    stack[sp].node = rtip->rti_bvh_nodes;
+    stack[sp].tmin = FMAX(tmin, ssp->box_start);
+    sp++;
+
+    while (sp > 0) {
+	const struct bvh_flat_node *node;
+	fastf_t node_tmin;
+
+	sp--;
+	node = stack[sp].node;
+	node_tmin = stack[sp].tmin;
+
+	if (ap->a_ray_length > 0.0 && node_tmin > ap->a_ray_length)
+	    continue;
+	if (occl && node_tmin >= occl->maxdist)
+	    continue;
+
+	if (node->n_primitives > 0) {
+	    struct soltab **stpp = &rtip->rti_bvh_solids[node->data.first_prim_offset];
+	    long j;
+
+	    for (j = 0; j < node->n_primitives; j++) {
+		/* NULL if the solid was unprepped since the build */
+		if (stpp[j])
+		    shoot_solid(stpp[j], ssp, solidbits, waiting_segs);
+	    }
+
+	    if (occl) {
+		if (shoot_occlusion_scan(occl, waiting_segs, ap))
+		    return 1;
+		continue;
+	    }
+
+	    if (ap->a_onehit != 0 && BU_LIST_NON_EMPTY(&(waiting_segs->l))) {
+		fastf_t pending_hit = ssp->box_end;
+		int k;
+		int done;
+
+		if (debug_shoot) {
+		    struct seg *segp;
+		    bu_log("Waiting segs:\n");
+		    for (BU_LIST_FOR(segp, seg, &(waiting_segs->l))) {
+			rt_pr_seg(segp);
+		    }
+		}
+
+		rt_boolweave(ap->a_finished_segs_hdp, waiting_segs, InitialPart, ap);
+
+		/* Everything closer than the nearest pending node is final */
+		for (k = 0; k < sp; k++) {
+		    if (stack[k].tmin < pending_hit)
+			pending_hit = stack[k].tmin;
+		}
+		done = rt_boolfinal(InitialPart, FinalPart,
+				    *last_bool_start, pending_hit, regionbits, ap, solidbits);
+		*last_bool_start = pending_hit;
+
+		if (done > 0)
+		    return 1;
+	    }
+	    continue;
+	}
+
+	/* Interior node, push the farther child first */
+	{
+	    const struct bvh_flat_node *c[2];
+	    fastf_t cmin[2];
+	    int hit[2];
+	    int k, near_child;
+
+	    c[0] = node + 1;
+	    c[1] = node->data.other_child;
+	    for (k = 0; k < 2; k++) {
+		hit[k] = shoot_bvh_node_interval(c[k], ssp, &tmin, &tmax) &&
+		    tmax >= ssp->box_start && tmin <= ssp->box_end;
+		if (!hit[k])
+		    continue;
+		cmin[k] = FMAX(tmin, ssp->box_start);
+	    }
+
+	    near_child = (hit[0] && hit[1] && cmin[1] < cmin[0]) ? 1 : 0;
+	    if (UNLIKELY(sp + 2 > SHOOT_BVH_STACK_SIZE))
+		bu_bomb("shoot_bvh: stack size exceeded\n");
+	    for (k = 0; k < 2; k++) {
+		int idx = (k == 0) ? !near_child : near_child;
+		if (!hit[idx])
+		    continue;
+		stack[sp].node = c[idx];
+		stack[sp].tmin = cmin[idx];
+		sp++;
+	    }
+	}
+    }
+
+    return 0;
+}
+
+
 _BU_ATTR_FLATTEN int
 rt_shootray(register struct application *ap)
 {
     struct rt_shootray_status ss;
-    struct seg new_segs;	/* from solid intersections */
     struct seg waiting_segs;	/* awaiting rt_boolweave() */
     struct seg finished_segs;	/* processed by rt_boolweave() */
     fastf_t last_bool_start;
@@ -711,7 +1242,6 @@ rt_shootray(register struct application *ap)
     FinalPart.pt_magic = PT_HD_MAGIC;
     ap->a_Final_Part_hdp = &FinalPart;
 
-    BU_LIST_INIT(&new_segs.l);
     BU_LIST_INIT(&waiting_segs.l);
     BU_LIST_INIT(&finished_segs.l);
     ap->a_finished_segs_hdp = &finished_segs;
@@ -776,39 +1306,7 @@ rt_shootray(register struct application *ap)
     resp->re_nshootray++;
 
     /* Compute the inverse of the direction cosines */
-    if (ap->a_ray.r_dir[X] < -SQRT_SMALL_FASTF) {
-	ss.abs_inv_dir[X] = -(ss.inv_dir[X]=1.0/ap->a_ray.r_dir[X]);
-	ss.rstep[X] = -1;
-    } else if (ap->a_ray.r_dir[X] > SQRT_SMALL_FASTF) {
-	ss.abs_inv_dir[X] =  (ss.inv_dir[X]=1.0/ap->a_ray.r_dir[X]);
-	ss.rstep[X] = 1;
-    } else {
-	ap->a_ray.r_dir[X] = 0.0;
-	ss.abs_inv_dir[X] = ss.inv_dir[X] = INFINITY;
-	ss.rstep[X] = 0;
-    }
-    if (ap->a_ray.r_dir[Y] < -SQRT_SMALL_FASTF) {
-	ss.abs_inv_dir[Y] = -(ss.inv_dir[Y]=1.0/ap->a_ray.r_dir[Y]);
-	ss.rstep[Y] = -1;
-    } else if (ap->a_ray.r_dir[Y] > SQRT_SMALL_FASTF) {
-	ss.abs_inv_dir[Y] =  (ss.inv_dir[Y]=1.0/ap->a_ray.r_dir[Y]);
-	ss.rstep[Y] = 1;
-    } else {
-	ap->a_ray.r_dir[Y] = 0.0;
-	ss.abs_inv_dir[Y] = ss.inv_dir[Y] = INFINITY;
-	ss.rstep[Y] = 0;
-    }
-    if (ap->a_ray.r_dir[Z] < -SQRT_SMALL_FASTF) {
-	ss.abs_inv_dir[Z] = -(ss.inv_dir[Z]=1.0/ap->a_ray.r_dir[Z]);
-	ss.rstep[Z] = -1;
-    } else if (ap->a_ray.r_dir[Z] > SQRT_SMALL_FASTF) {
-	ss.abs_inv_dir[Z] =  (ss.inv_dir[Z]=1.0/ap->a_ray.r_dir[Z]);
-	ss.rstep[Z] = 1;
-    } else {
-	ap->a_ray.r_dir[Z] = 0.0;
-	ss.abs_inv_dir[Z] = ss.inv_dir[Z] = INFINITY;
-	ss.rstep[Z] = 0;
-    }
+    shoot_inv_dir(&ss, &ap->a_ray);
     VMOVE(ap->a_inv_dir, ss.inv_dir);
 
     /*
@@ -923,6 +1421,16 @@ rt_shootray(register struct application *ap)
 	    ss.box_start = BACKING_DIST; /* Only look a little bit behind */
     }
 
+    if (rtip->rti_space_partition == RT_PART_HLBVH && rtip->rti_bvh_nodes) {
+	/* Walk the scene BVH instead of the cut tree */
+	last_bool_start = BACKING_DIST;
+	shoot_setup_status(&ss, ap);
+	if (shoot_bvh(&ss, solidbits, regionbits, &waiting_segs,
+		      &InitialPart, &FinalPart, &last_bool_start, NULL))
+	    goto hitit;
+	goto weave;
+    }
+
     ss.lastcut = CUTTER_NULL;
     ss.old_status = (struct rt_shootray_status *)NULL;
     ss.curcut = &ap->a_rt_i->rti_CutHead;
@@ -959,165 +1467,14 @@ rt_shootray(register struct application *ap)
 
 	/* Consider all "pieces" of all solids within the box */
 	pending_hit = ss.box_end;
-	if (cutp->bn.bn_piecelen > 0) {
-	    register struct rt_piecelist *plp;
-
-	    plp = &(cutp->bn.bn_piecelist[cutp->bn.bn_piecelen-1]);
-	    for (; plp >= cutp->bn.bn_piecelist; plp--) {
-		struct rt_piecestate *psp;
-		struct soltab *stp;
-		int ret;
-		int had_hits_before;
-
-		RT_CK_PIECELIST(plp);
-
-		/* Consider all pieces of this one solid in this
-		 * cell.
-		 */
-		stp = plp->stp;
-		RT_CK_SOLTAB(stp);
-
-		if (backbits && ss.box_end < BACKING_DIST && BU_BITTEST(backbits, stp->st_bit) == 0) {
-		    /* we are behind the ray start point and this
-		     * primitive is not one that we need to intersect
-		     * back here.
-		     */
-		    continue;
-		}
-
-		psp = &(resp->re_pieces[stp->st_piecestate_num]);
-		RT_CK_PIECESTATE(psp);
-		if (psp->ray_seqno != resp->re_nshootray) {
-		    /* state is from an earlier ray, scrub */
-		    BU_BITV_ZEROALL(psp->shot);
-		    psp->ray_seqno = resp->re_nshootray;
-		    rt_htbl_reset(&psp->htab);
-
-		    /* Compute ray entry and exit to entire solid's
-		     * bounding box.
-		     */
-		    if (!rt_in_rpp(&ss.newray, ss.inv_dir,
-				   stp->st_min, stp->st_max)) {
-			if (debug_shoot)bu_log("rpp miss %s (all pieces)\n", stp->st_name);
-			resp->re_prune_solrpp++;
-			BU_BITSET(solidbits, stp->st_bit);
-			continue;	/* MISS */
-		    }
-		    psp->mindist = ss.newray.r_min + ss.dist_corr;
-		    psp->maxdist = ss.newray.r_max + ss.dist_corr;
-		    if (debug_shoot) bu_log("%s mindist=%g, maxdist=%g\n", stp->st_name, psp->mindist, psp->maxdist);
-		    had_hits_before = 0;
-		} else {
-		    if (BU_BITTEST(solidbits, stp->st_bit)) {
-			/* we missed the solid RPP in an earlier cell */
-			resp->re_ndup++;
-			continue;	/* already shot */
-		    }
-		    had_hits_before = psp->htab.end;
-		}
-
-		/*
-		 * Allow this solid to shoot at all of its 'pieces' in
-		 * this cell, all at once.  'newray' has been
-		 * transformed to be near to this cell, and
-		 * 'dist_corr' is the additive correction factor that
-		 * ft_piece_shot() must apply to hits calculated using
-		 * 'newray'.
-		 */
-		resp->re_piece_shots++;
-		psp->cutp = cutp;
-
-		ret = -1;
-		if (stp->st_meth->ft_piece_shot) {
-		    ret = stp->st_meth->ft_piece_shot(psp, plp, ss.dist_corr, &ss.newray, ap, &waiting_segs);
-		}
-		if (ret <= 0) {
-		    /* No hits at all */
-		    resp->re_piece_shot_miss++;
-		} else {
-		    resp->re_piece_shot_hit++;
-		}
-		if (debug_shoot)bu_log("shooting %s pieces, nhit=%d\n", stp->st_name, ret);
-
-		/* See if this solid has been fully processed yet.  If
-		 * ray has passed through bounding volume, we're done.
-		 * ft_piece_hitsegs() will only be called once per
-		 * ray.
-		 */
-		if (ss.box_end > psp->maxdist && psp->htab.end > 0) {
-		    /* Convert hits into segs */
-		    if (debug_shoot)bu_log("shooting %s pieces complete, making segs\n", stp->st_name);
-		    /* Distance correction was handled in ft_piece_shot */
-		    if (stp->st_meth->ft_piece_hitsegs)
-			stp->st_meth->ft_piece_hitsegs(psp, &waiting_segs, ap);
-		    rt_htbl_reset(&psp->htab);
-		    BU_BITSET(solidbits, stp->st_bit);
-
-		    if (had_hits_before)
-			bu_ptbl_rm(&resp->re_pieces_pending, (long *)psp);
-		} else {
-		    if (!had_hits_before)
-			bu_ptbl_ins_unique(&resp->re_pieces_pending, (long *)psp);
-		}
-	    }
-	}
+	if (cutp->bn.bn_piecelen > 0)
+	    shoot_pieces(cutp, &ss, solidbits, backbits, &waiting_segs);
 
 	/* Consider all solids within the box */
 	if (cutp->bn.bn_len > 0 && ss.box_end >= BACKING_DIST) {
 	    stpp = &(cutp->bn.bn_list[cutp->bn.bn_len-1]);
 	    for (; stpp >= cutp->bn.bn_list; stpp--) {
-		register struct soltab *stp = *stpp;
-		int ret;
-
-		if (BU_BITTEST(solidbits, stp->st_bit)) {
-		    resp->re_ndup++;
-		    continue;	/* already shot */
-		}
-
-		/* Shoot a ray */
-		BU_BITSET(solidbits, stp->st_bit);
-
-		/* Check against bounding RPP, if desired by solid */
-		if (stp->st_meth->ft_use_rpp) {
-		    if (!rt_in_rpp(&ss.newray, ss.inv_dir,
-				   stp->st_min, stp->st_max)) {
-			if (debug_shoot)bu_log("rpp miss %s\n", stp->st_name);
-			resp->re_prune_solrpp++;
-			continue;	/* MISS */
-		    }
-		    if (ss.dist_corr + ss.newray.r_max < BACKING_DIST) {
-			if (debug_shoot)bu_log("rpp skip %s, dist_corr=%g, r_max=%g\n", stp->st_name, ss.dist_corr, ss.newray.r_max);
-			resp->re_prune_solrpp++;
-			continue;	/* MISS */
-		    }
-		}
-
-		if (debug_shoot)bu_log("shooting %s\n", stp->st_name);
-		resp->re_shots++;
-		BU_LIST_INIT(&(new_segs.l));
-
-		ret = -1;
-		if (stp->st_meth->ft_shot) {
-		    ret = stp->st_meth->ft_shot(stp, &ss.newray, ap, &new_segs);
-		}
-		if (ret <= 0) {
-		    resp->re_shot_miss++;
-		    continue;	/* MISS */
-		}
-
-		/* Add seg chain to list awaiting rt_boolweave() */
-		{
-		    register struct seg *s2;
-		    while (BU_LIST_WHILE(s2, seg, &(new_segs.l))) {
-			BU_LIST_DEQUEUE(&(s2->l));
-			/* Restore to original distance */
-			s2->seg_in.hit_dist += ss.dist_corr;
-			s2->seg_out.hit_dist += ss.dist_corr;
-			s2->seg_in.hit_rayp = s2->seg_out.hit_rayp = &ap->a_ray;
-			BU_LIST_INSERT(&(waiting_segs.l), &(s2->l));
-		    }
-		}
-		resp->re_shot_hit++;
+		shoot_solid(*stpp, &ss, solidbits, &waiting_segs);
 	    }
 	}
 	if (RT_G_DEBUG & RT_DEBUG_ADVANCE)
@@ -1200,19 +1557,7 @@ weave:
 	bu_log("rt_shootray: ray has left known space\n");
 
     /* Process any pending hits into segs */
-    if (BU_PTBL_LEN(&resp->re_pieces_pending) > 0) {
-	struct rt_piecestate **psp;
-	for (BU_PTBL_FOR(psp, (struct rt_piecestate **), &resp->re_pieces_pending)) {
-	    if ((*psp)->htab.end > 0) {
-		/* Convert any pending hits into segs */
-		/* Distance correction was handled in ft_piece_shot */
-		(*psp)->stp->st_meth->ft_piece_hitsegs(*psp, &waiting_segs, ap);
-		rt_htbl_reset(&(*psp)->htab);
-	    }
-	    *psp = NULL;
-	}
-	bu_ptbl_reset(&resp->re_pieces_pending);
-    }
+    shoot_pieces_flush(resp, &waiting_segs, ap);
 
     if (BU_LIST_NON_EMPTY(&(waiting_segs.l))) {
 	rt_boolweave(&finished_segs, &waiting_segs, &InitialPart, ap);
@@ -1242,8 +1587,8 @@ weave:
 	else
 	    ap->a_return = 0;
 	status = "MISS bool";
-	RT_FREE_PT_LIST(&InitialPart, resp);
-	RT_FREE_SEG_LIST(&finished_segs, resp);
+	rt_pt_list_release(&InitialPart, resp);
+	rt_seg_list_release(&finished_segs, resp);
 	goto out;
     }
 
@@ -1256,7 +1601,7 @@ hitit:
      * partitions.  finished_segs can not be released yet, because
      * FinalPart partitions will point to hits in those segments.
      */
-    RT_FREE_PT_LIST(&InitialPart, resp);
+    rt_pt_list_release(&InitialPart, resp);
 
     /* finished_segs is only used by special hit routines which don't
      * follow the traditional solid modeling paradigm.
@@ -1272,8 +1617,8 @@ hitit:
 	status = "MISS (unexpected)";
     }
 
-    RT_FREE_SEG_LIST(&finished_segs, resp);
-    RT_FREE_PT_LIST(&FinalPart, resp);
+    rt_seg_list_release(&finished_segs, resp);
+    rt_pt_list_release(&FinalPart, resp);
 
     /*
      * Processing of this ray is complete.
@@ -1313,6 +1658,703 @@ out:
 }
 
 
+int
+rt_occluded(struct application *ap, fastf_t mindist, fastf_t maxdist, int (*opaque)(struct application *, const struct region *))
+{
+    struct rt_shootray_status ss;
+    struct shoot_occlusion occl;
+    struct seg waiting_segs;	/* awaiting the occlusion scan */
+    struct bu_bitv *solidbits;	/* bits for all solids shot so far */
+    struct bu_bitv *backbits = NULL;	/* pieces solids to intersect behind the ray start */
+    const union cutter *cutp;
+    struct soltab **stpp;
+    struct resource *resp;
+    struct rt_i *rtip;
+    int occluded = 0;
+
+    RT_AP_CHECK(ap);
+    if (ap->a_magic) {
+	RT_CK_AP(ap);
+    } else {
+	ap->a_magic = RT_AP_MAGIC;
+    }
+    if (ap->a_ray.magic) {
+	RT_CK_RAY(&(ap->a_ray));
+    } else {
+	ap->a_ray.magic = RT_RAY_MAGIC;
+    }
+    if (ap->a_resource == RESOURCE_NULL)
+	ap->a_resource = &rt_uniresource;
+
+    ss.ap = ap;
+    rtip = ap->a_rt_i;
+    RT_CK_RTI(rtip);
+    resp = ap->a_resource;
+    RT_CK_RESOURCE(resp);
+    ss.resp = resp;
+
+    if (rtip->needprep)
+	rt_prep_parallel(rtip, 1);	/* Stay on our CPU */
+
+    if (!BU_LIST_IS_INITIALIZED(&resp->re_parthead))
+	rt_init_resource(resp, resp->re_cpu, rtip);
+
+    occl.mindist = mindist;
+    occl.maxdist = maxdist;
+    occl.opaque = opaque;
+    occl.unresolved = 0;
+
+    BU_LIST_INIT(&waiting_segs.l);
+    solidbits = rt_get_solidbitv(rtip->nsolids, resp);
+
+    if (!resp->re_pieces && rtip->rti_nsolids_with_pieces > 0)
+	rt_res_pieces_init(resp, rtip);
+    if (UNLIKELY(!BU_LIST_MAGIC_EQUAL(&resp->re_pieces_pending.l, BU_PTBL_MAGIC)))
+	bu_ptbl_init(&resp->re_pieces_pending, 100, "re_pieces_pending");
+    bu_ptbl_reset(&resp->re_pieces_pending);
+
+    /* pieces state is keyed to the ray count */
+    resp->re_nshootray++;
+
+    shoot_inv_dir(&ss, &ap->a_ray);
+    VMOVE(ap->a_inv_dir, ss.inv_dir);
+
+    /* Same start up as rt_shootray(), see there */
+    if (!rt_in_rpp(&ap->a_ray, ss.inv_dir, rtip->mdl_min, rtip->mdl_max) ||
+	ap->a_ray.r_max < 0.0) {
+	cutp = &rtip->rti_inf_box;
+	if (cutp->bn.bn_len <= 0) {
+	    resp->re_nmiss_model++;
+	    goto out;
+	}
+	/* Model has infinite solids, need to fire at them. */
+	ss.box_start = BACKING_DIST;
+	ss.model_start = 0;
+	ss.box_end = ss.model_end = INFINITY;
+	ss.lastcut = CUTTER_NULL;
+	ss.old_status = (struct rt_shootray_status *)NULL;
+	ss.curcut = cutp;
+	ss.lastcell = ss.curcut;
+	VMOVE(ss.curmin, rtip->mdl_min);
+	VMOVE(ss.curmax, rtip->mdl_max);
+	shoot_setup_status(&ss, ap);
+	goto start_cell;
+    }
+
+    ss.box_start = ss.model_start = ap->a_ray.r_min;
+    ss.box_end = ss.model_end = ap->a_ray.r_max;
+
+    if (rtip->rti_nsolids_with_pieces > 0) {
+	if (ss.box_start < BACKING_DIST) {
+	    backbits = rt_get_solidbitv(rtip->nsolids, resp);
+	    ss.box_start = rt_find_backing_dist(&ss, backbits);
+	}
+    } else {
+	if (ss.box_start < BACKING_DIST)
+	    ss.box_start = BACKING_DIST;
+    }
+
+    if (rtip->rti_space_partition == RT_PART_HLBVH && rtip->rti_bvh_nodes) {
+	shoot_setup_status(&ss, ap);
+	occluded = shoot_bvh(&ss, solidbits, NULL, &waiting_segs,
+			     NULL, NULL, NULL, &occl);
+	goto out;
+    }
+
+    ss.lastcut = CUTTER_NULL;
+    ss.old_status = (struct rt_shootray_status *)NULL;
+    ss.curcut = &rtip->rti_CutHead;
+
+    if (ss.curcut->cut_type == CUT_CUTNODE || ss.curcut->cut_type == CUT_BOXNODE) {
+	ss.lastcell = ss.curcut;
+	VMOVE(ss.curmin, rtip->mdl_min);
+	VMOVE(ss.curmax, rtip->mdl_max);
+    }
+
+    shoot_setup_status(&ss, ap);
+
+    while ((cutp = rt_advance_to_next_cell(&ss)) != CUTTER_NULL) {
+    start_cell:
+	if (cutp->bn.bn_len <= 0 && cutp->bn.bn_piecelen <= 0) {
+	    ss.box_start = ss.box_end;
+	    resp->re_nempty_cells++;
+	    continue;
+	}
+
+	if (cutp->bn.bn_piecelen > 0)
+	    shoot_pieces(cutp, &ss, solidbits, backbits, &waiting_segs);
+
+	if (cutp->bn.bn_len > 0 && ss.box_end >= BACKING_DIST) {
+	    stpp = &(cutp->bn.bn_list[cutp->bn.bn_len-1]);
+	    for (; stpp >= cutp->bn.bn_list; stpp--) {
+		shoot_solid(*stpp, &ss, solidbits, &waiting_segs);
+	    }
+	}
+
+	if (shoot_occlusion_scan(&occl, &waiting_segs, ap)) {
+	    occluded = 1;
+	    goto out;
+	}
+
+	/* Pieces still pending need the ray to leave their bounds */
+	if (ss.box_end >= maxdist && BU_PTBL_LEN(&resp->re_pieces_pending) == 0)
+	    goto out;
+
+	ss.box_start = ss.box_end;
+    }
+
+    shoot_pieces_flush(resp, &waiting_segs, ap);
+    occluded = shoot_occlusion_scan(&occl, &waiting_segs, ap);
+
+out:
+    /* Anything left unscanned after an early exit */
+    RT_FREE_SEG_LIST(&waiting_segs, resp);
+
+    BU_CK_BITV(solidbits);
+    BU_LIST_APPEND(&resp->re_solid_bitv, &solidbits->l);
+    if (backbits) {
+	BU_CK_BITV(backbits);
+	BU_LIST_APPEND(&resp->re_solid_bitv, &backbits->l);
+    }
+
+    /* Clean up any pending hits */
+    if (BU_PTBL_LEN(&resp->re_pieces_pending) > 0) {
+	struct rt_piecestate **psp;
+	for (BU_PTBL_FOR(psp, (struct rt_piecestate **), &resp->re_pieces_pending)) {
+	    if ((*psp)->htab.end > 0)
+		rt_htbl_reset(&(*psp)->htab);
+	}
+	bu_ptbl_reset(&resp->re_pieces_pending);
+    }
+
+    if (occluded)
+	return 1;
+    return occl.unresolved ? -1 : 0;
+}
+
+
+struct shoot_packet_ray {
+    struct rt_shootray_status ss;
+    struct seg waiting_segs;		/* awaiting rt_boolweave() */
+    struct seg finished_segs;		/* processed by rt_boolweave() */
+    struct partition InitialPart;	/* Head of Initial Partitions */
+    struct partition FinalPart;		/* Head of Final Partitions */
+    struct bu_bitv *solidbits;		/* bits for all solids shot so far */
+    struct bu_ptbl *regionbits;		/* table of all involved regions */
+    fastf_t last_bool_start;
+    int state;
+};
+
+
+struct shoot_packet_entry {
+    const struct bvh_flat_node *node;
+    uint32_t mask;			/* rays entering the node */
+    fastf_t tmin[RT_PACKET_MAX];	/* entry distance of each of those rays */
+};
+
+
+/**
+ * Interval bounds on the origins and inverse directions of the rays
+ * in a packet.  Only axes along which every ray steps the same way
+ * are usable.
+ */
+struct shoot_packet_bounds {
+    int usable[3];
+    int sign[3];
+    fastf_t omin[3], omax[3];
+    fastf_t imin[3], imax[3];
+};
+
+
+static void
+shoot_packet_bounds_init(struct shoot_packet_bounds *b, const struct shoot_packet_ray *rays, uint32_t mask)
+{
+    int first = 1;
+    int i, a;
+
+    for (i = 0; i < RT_PACKET_MAX; i++) {
+	const struct rt_shootray_status *ssp = &rays[i].ss;
+	const fastf_t *pt;
+
+	if (!(mask & (1U << i)))
+	    continue;
+	pt = ssp->ap->a_ray.r_pt;
+	for (a = X; a <= Z; a++) {
+	    if (first) {
+		b->sign[a] = ssp->rstep[a];
+		b->usable[a] = (ssp->rstep[a] != 0);
+		b->omin[a] = b->omax[a] = pt[a];
+		b->imin[a] = b->imax[a] = ssp->inv_dir[a];
+		continue;
+	    }
+	    if (ssp->rstep[a] != b->sign[a])
+		b->usable[a] = 0;
+	    V_MIN(b->omin[a], pt[a]);
+	    V_MAX(b->omax[a], pt[a]);
+	    V_MIN(b->imin[a], ssp->inv_dir[a]);
+	    V_MAX(b->imax[a], ssp->inv_dir[a]);
+	}
+	first = 0;
+    }
+}
+
+
+/**
+ * Interval arithmetic version of the slab test.  Returns 1 when no ray
+ * with origin and inverse direction inside the packet bounds can
+ * enter the node, so the whole packet can skip it with one test.
+ */
+static inline int
+shoot_packet_bounds_miss(const struct bvh_flat_node *node, const struct shoot_packet_bounds *b)
+{
+    fastf_t lb = -INFINITY;
+    fastf_t ub = INFINITY;
+    int a;
+
+    for (a = X; a <= Z; a++) {
+	fastf_t near_plane, far_plane, d0, d1, lo, hi;
+
+	if (!b->usable[a])
+	    continue;
+	if (b->sign[a] > 0) {
+	    near_plane = node->bounds[a];
+	    far_plane = node->bounds[3+a];
+	} else {
+	    near_plane = node->bounds[3+a];
+	    far_plane = node->bounds[a];
+	}
+
+	/* t = (plane - pt) * inv_dir is monotonic in pt and inv_dir,
+	 * so its extremes are at the corners of the bounds */
+	d0 = near_plane - b->omax[a];
+	d1 = near_plane - b->omin[a];
+	lo = FMIN(FMIN(d0 * b->imin[a], d0 * b->imax[a]), FMIN(d1 * b->imin[a], d1 * b->imax[a]));
+	d0 = far_plane - b->omax[a];
+	d1 = far_plane - b->omin[a];
+	hi = FMAX(FMAX(d0 * b->imin[a], d0 * b->imax[a]), FMAX(d1 * b->imin[a], d1 * b->imax[a]));
+
+	V_MAX(lb, lo);
+	V_MIN(ub, hi);
+	if (lb > ub)
+	    return 1;
+    }
+    return 0;
+}
+
+
+/**
+ * Test the rays in mask against a node, storing the entry distance of
+ * each ray that enters it in tmin.  Returns the mask of those rays.
+ */
+static uint32_t
+shoot_packet_node(const struct bvh_flat_node *node, const struct shoot_packet_ray *rays, uint32_t mask, const struct shoot_packet_bounds *b, fastf_t *tmin)
+{
+    uint32_t hit = 0;
+    int i;
+
+    if (shoot_packet_bounds_miss(node, b))
+	return 0;
+
+    for (i = 0; i < RT_PACKET_MAX; i++) {
+	const struct rt_shootray_status *ssp = &rays[i].ss;
+	fastf_t t0, t1;
+
+	if (!(mask & (1U << i)))
+	    continue;
+	if (!shoot_bvh_node_interval(node, ssp, &t0, &t1) ||
+	    t1 < ssp->box_start || t0 > ssp->box_end)
+	    continue;
+	tmin[i] = FMAX(t0, ssp->box_start);
+	hit |= 1U << i;
+    }
+    return hit;
+}
+
+
+static fastf_t
+shoot_packet_near(const struct shoot_packet_entry *e)
+{
+    fastf_t t = INFINITY;
+    int i;
+
+    for (i = 0; i < RT_PACKET_MAX; i++) {
+	if (e->mask & (1U << i))
+	    V_MIN(t, e->tmin[i]);
+    }
+    return t;
+}
+
+
+/**
+ * Packet counterpart of shoot_solid().  Primitives with a packet or
+ * vectorized intersector get all the rays at once, everything else is
+ * shot one ray at a time.
+ */
+static void
+shoot_packet_solid(struct soltab *stp, struct shoot_packet_ray *rays, uint32_t mask)
+{
+    struct xray *rps[RT_PACKET_MAX];
+    struct application *aps[RT_PACKET_MAX];
+    struct seg new_segs[RT_PACKET_MAX];
+    struct seg *segps[RT_PACKET_MAX];
+    int ret[RT_PACKET_MAX];
+    int idx[RT_PACKET_MAX];
+    int n = 0;
+    int i;
+
+    for (i = 0; i < RT_PACKET_MAX; i++) {
+	struct shoot_packet_ray *r = &rays[i];
+
+	if (!(mask & (1U << i)))
+	    continue;
+	if (!shoot_solid_candidate(stp, &r->ss, r->solidbits))
+	    continue;
+	idx[n] = i;
+	rps[n] = &r->ss.newray;
+	aps[n] = r->ss.ap;
+	BU_LIST_INIT(&(new_segs[n].l));
+	segps[n] = &new_segs[n];
+	ret[n] = -1;
+	n++;
+    }
+    if (!n)
+	return;
+
+    if (n > 1 && stp->st_id == ID_BOT) {
+	rt_bot_shot_packet(stp, n, rps, aps, segps, ret);
+    } else if (n > 1 && stp->st_meth->ft_vshot) {
+	/* the rays of a packet share one resource */
+	rt_vshot_solid(stp, n, rps, aps[0], segps, ret);
+    } else if (stp->st_meth->ft_shot) {
+	for (i = 0; i < n; i++)
+	    ret[i] = stp->st_meth->ft_shot(stp, rps[i], aps[i], segps[i]);
+    }
+
+    for (i = 0; i < n; i++) {
+	struct shoot_packet_ray *r = &rays[idx[i]];
+	shoot_solid_segs(ret[i], segps[i], &r->ss, &r->waiting_segs);
+    }
+}
+
+
+/**
+ * After a leaf, evaluate the partitions of each ray that wants early
+ * termination, up to the nearest node that ray still has pending.
+ * Rays that have acquired enough partitions are removed from *alive.
+ */
+static void
+shoot_packet_evaluate(struct shoot_packet_ray *rays, uint32_t mask, const struct shoot_packet_entry *stack, int sp, uint32_t *alive)
+{
+    int i, k;
+
+    for (i = 0; i < RT_PACKET_MAX; i++) {
+	struct shoot_packet_ray *r = &rays[i];
+	struct application *ap = r->ss.ap;
+	uint32_t bit = 1U << i;
+	fastf_t pending_hit;
+	int done;
+
+	if (!(mask & bit))
+	    continue;
+	if (ap->a_onehit == 0 || BU_LIST_IS_EMPTY(&(r->waiting_segs.l)))
+	    continue;
+
+	rt_boolweave(&r->finished_segs, &r->waiting_segs, &r->InitialPart, ap);
+
+	/* Everything closer than the nearest pending node is final */
+	pending_hit = r->ss.box_end;
+	for (k = 0; k < sp; k++) {
+	    if ((stack[k].mask & bit) && stack[k].tmin[i] < pending_hit)
+		pending_hit = stack[k].tmin[i];
+	}
+	done = rt_boolfinal(&r->InitialPart, &r->FinalPart,
+			    r->last_bool_start, pending_hit, r->regionbits, ap, r->solidbits);
+	r->last_bool_start = pending_hit;
+
+	if (done > 0) {
+	    r->state = SHOOT_PACKET_DONE;
+	    *alive &= ~bit;
+	}
+    }
+}
+
+
+/**
+ * Trace the live rays of a packet through the scene BVH together.
+ * Each node is first tested against the packet as a whole, then
+ * against the individual rays, and children are visited nearest first
+ * for the packet.
+ */
+static void
+shoot_packet_bvh(struct rt_i *rtip, struct shoot_packet_ray *rays, uint32_t alive)
+{
+    struct shoot_packet_entry stack[SHOOT_PACKET_STACK_SIZE];
+    struct shoot_packet_bounds b;
+    int sp = 0;
+    int i;
+
+    shoot_packet_bounds_init(&b, rays, alive);
+
+    stack[0].node = rtip->rti_bvh_nodes;
+    stack[0].mask = shoot_packet_node(rtip->rti_bvh_nodes, rays, alive, &b, stack[0].tmin);
+    if (stack[0].mask)
+	sp = 1;
+
+    while (sp > 0) {
+	const struct bvh_flat_node *node;
+	struct shoot_packet_entry *e0, *e1;
+	uint32_t mask;
+
+	sp--;
+	node = stack[sp].node;
+	mask = stack[sp].mask & alive;
+	for (i = 0; i < RT_PACKET_MAX; i++) {
+	    struct application *ap = rays[i].ss.ap;
+	    if ((mask & (1U << i)) && ap->a_ray_length > 0.0 && stack[sp].tmin[i] > ap->a_ray_length)
+		mask &= ~(1U << i);
+	}
+	if (!mask)
+	    continue;
+
+	if (node->n_primitives > 0) {
+	    struct soltab **stpp = &rtip->rti_bvh_solids[node->data.first_prim_offset];
+	    long j;
+
+	    for (j = 0; j < node->n_primitives; j++) {
+		/* NULL if the solid was unprepped since the build */
+		if (stpp[j])
+		    shoot_packet_solid(stpp[j], rays, mask);
+	    }
+	    shoot_packet_evaluate(rays, mask, stack, sp, &alive);
+	    continue;
+	}
+
+	/* Interior node, the popped entry is reused for the children */
+	if (UNLIKELY(sp + 2 > SHOOT_PACKET_STACK_SIZE))
+	    bu_bomb("shoot_packet_bvh: stack size exceeded\n");
+	e0 = &stack[sp];
+	e1 = &stack[sp+1];
+	e0->node = node + 1;
+	e0->mask = shoot_packet_node(e0->node, rays, mask, &b, e0->tmin);
+	e1->node = node->data.other_child;
+	e1->mask = shoot_packet_node(e1->node, rays, mask, &b, e1->tmin);
+
+	if (!e0->mask) {
+	    if (e1->mask) {
+		*e0 = *e1;
+		sp++;
+	    }
+	    continue;
+	}
+	if (!e1->mask) {
+	    sp++;
+	    continue;
+	}
+	/* push the farther child first */
+	if (shoot_packet_near(e0) < shoot_packet_near(e1)) {
+	    struct shoot_packet_entry tmp = *e0;
+	    *e0 = *e1;
+	    *e1 = tmp;
+	}
+	sp += 2;
+    }
+}
+
+
+/**
+ * Hand the partitions of one packet ray to the application, as the
+ * tail end of rt_shootray() does, and release its resources.
+ */
+static void
+shoot_packet_finish(struct shoot_packet_ray *r, struct application *ap)
+{
+    struct resource *resp = ap->a_resource;
+
+    if (r->state == SHOOT_PACKET_SINGLE) {
+	(void)rt_shootray(ap);
+	return;
+    }
+    if (r->state == SHOOT_PACKET_MISS) {
+	if (ap->a_miss)
+	    ap->a_return = ap->a_miss(ap);
+	else
+	    ap->a_return = 0;
+	return;
+    }
+
+    if (r->state == SHOOT_PACKET_TRACE) {
+	if (BU_LIST_NON_EMPTY(&(r->waiting_segs.l))) {
+	    rt_boolweave(&r->finished_segs, &r->waiting_segs, &r->InitialPart, ap);
+	}
+
+	/* finished_segs chain now has all segments hit by this ray */
+	if (BU_LIST_IS_EMPTY(&(r->finished_segs.l))) {
+	    if (ap->a_miss)
+		ap->a_return = ap->a_miss(ap);
+	    else
+		ap->a_return = 0;
+	    goto out;
+	}
+
+	(void)rt_boolfinal(&r->InitialPart, &r->FinalPart, BACKING_DIST,
+			   INFINITY,
+			   r->regionbits, ap, r->solidbits);
+
+	if (r->FinalPart.pt_forw == &r->FinalPart) {
+	    if (ap->a_miss)
+		ap->a_return = ap->a_miss(ap);
+	    else
+		ap->a_return = 0;
+	    rt_pt_list_release(&r->InitialPart, resp);
+	    rt_seg_list_release(&r->finished_segs, resp);
+	    goto out;
+	}
+    }
+
+    /* Ray/model intersections exist */
+    rt_pt_list_release(&r->InitialPart, resp);
+    if (ap->a_hit) {
+	ap->a_return = ap->a_hit(ap, &r->FinalPart, &r->finished_segs);
+    } else {
+	ap->a_return = 0;
+    }
+    rt_seg_list_release(&r->finished_segs, resp);
+    rt_pt_list_release(&r->FinalPart, resp);
+
+out:
+    /* Return dynamic resources to their freelists.  */
+    BU_CK_BITV(r->solidbits);
+    BU_LIST_APPEND(&resp->re_solid_bitv, &r->solidbits->l);
+    BU_CK_PTBL(r->regionbits);
+    BU_LIST_APPEND(&resp->re_region_ptbl, &r->regionbits->l);
+}
+
+
+int
+rt_shootray_packet(struct application *aps, int nrays)
+{
+    struct shoot_packet_ray rays[RT_PACKET_MAX];
+    struct resource *resp;
+    struct rt_i *rtip;
+    uint32_t alive = 0;
+    int single;
+    int i;
+    size_t j;
+
+    if (!aps || nrays <= 0)
+	return 0;
+
+    if (nrays > RT_PACKET_MAX) {
+	for (i = 0; i < nrays; i += RT_PACKET_MAX)
+	    (void)rt_shootray_packet(&aps[i], (nrays - i < RT_PACKET_MAX) ? nrays - i : RT_PACKET_MAX);
+	return nrays;
+    }
+
+    rtip = aps[0].a_rt_i;
+    RT_CK_RTI(rtip);
+    resp = aps[0].a_resource;
+
+    if (rtip->needprep)
+	rt_prep_parallel(rtip, 1);	/* Stay on our CPU */
+
+    /* Packets are traced through the scene BVH.  Otherwise, or when
+     * debugging, every ray takes the regular path.
+     */
+    single = (nrays == 1 || RT_G_DEBUG ||
+	      rtip->rti_space_partition != RT_PART_HLBVH || !rtip->rti_bvh_nodes ||
+	      rtip->rti_nsolids_with_pieces > 0 ||
+	      resp == RESOURCE_NULL || !BU_LIST_IS_INITIALIZED(&resp->re_parthead));
+    for (i = 0; !single && i < nrays; i++) {
+	if (aps[i].a_rt_i != rtip || aps[i].a_resource != resp)
+	    single = 1;
+    }
+    if (single) {
+	for (i = 0; i < nrays; i++)
+	    (void)rt_shootray(&aps[i]);
+	return nrays;
+    }
+    RT_CK_RESOURCE(resp);
+
+    for (i = 0; i < nrays; i++) {
+	struct shoot_packet_ray *r = &rays[i];
+	struct application *ap = &aps[i];
+
+	RT_AP_CHECK(ap);
+	if (ap->a_magic) {
+	    RT_CK_AP(ap);
+	} else {
+	    ap->a_magic = RT_AP_MAGIC;
+	}
+	if (ap->a_ray.magic) {
+	    RT_CK_RAY(&(ap->a_ray));
+	} else {
+	    ap->a_ray.magic = RT_RAY_MAGIC;
+	}
+	r->ss.ap = ap;
+	r->ss.resp = resp;
+
+	shoot_inv_dir(&r->ss, &ap->a_ray);
+	VMOVE(ap->a_inv_dir, r->ss.inv_dir);
+
+	if (!rt_in_rpp(&ap->a_ray, r->ss.inv_dir, rtip->mdl_min, rtip->mdl_max) ||
+	    ap->a_ray.r_max < 0.0) {
+	    if (rtip->rti_inf_box.bn.bn_len > 0) {
+		/* Model has infinite solids, let rt_shootray() fire at them */
+		r->state = SHOOT_PACKET_SINGLE;
+		continue;
+	    }
+	    resp->re_nshootray++;
+	    resp->re_nmiss_model++;
+	    r->state = SHOOT_PACKET_MISS;
+	    continue;
+	}
+	resp->re_nshootray++;
+	r->state = SHOOT_PACKET_TRACE;
+
+	r->InitialPart.pt_forw = r->InitialPart.pt_back = &r->InitialPart;
+	r->InitialPart.pt_magic = PT_HD_MAGIC;
+	r->FinalPart.pt_forw = r->FinalPart.pt_back = &r->FinalPart;
+	r->FinalPart.pt_magic = PT_HD_MAGIC;
+	ap->a_Final_Part_hdp = &r->FinalPart;
+
+	BU_LIST_INIT(&r->waiting_segs.l);
+	BU_LIST_INIT(&r->finished_segs.l);
+	ap->a_finished_segs_hdp = &r->finished_segs;
+
+	r->solidbits = rt_get_solidbitv(rtip->nsolids, resp);
+	if (BU_LIST_IS_EMPTY(&resp->re_region_ptbl)) {
+	    BU_ALLOC(r->regionbits, struct bu_ptbl);
+	    bu_ptbl_init(r->regionbits, 7, "rt_shootray_packet() regionbits ptbl");
+	} else {
+	    r->regionbits = BU_LIST_FIRST(bu_ptbl, &resp->re_region_ptbl);
+	    BU_LIST_DEQUEUE(&r->regionbits->l);
+	    BU_CK_PTBL(r->regionbits);
+	}
+
+	r->ss.box_start = r->ss.model_start = ap->a_ray.r_min;
+	r->ss.box_end = r->ss.model_end = ap->a_ray.r_max;
+	if (r->ss.box_start < BACKING_DIST)
+	    r->ss.box_start = BACKING_DIST; /* Only look a little bit behind */
+	r->last_bool_start = BACKING_DIST;
+	shoot_setup_status(&r->ss, ap);
+
+	/* Infinite solids are not in the hierarchy */
+	for (j = 0; j < rtip->rti_inf_box.bn.bn_len; j++)
+	    shoot_solid(rtip->rti_inf_box.bn.bn_list[j], &r->ss, r->solidbits, &r->waiting_segs);
+
+	alive |= 1U << i;
+    }
+
+    if (alive)
+	shoot_packet_bvh(rtip, rays, alive);
+
+    for (i = 0; i < nrays; i++)
+	shoot_packet_finish(&rays[i], &aps[i]);
+
+    return nrays;
+}
+
+
 const union cutter *
 rt_cell_n_on_ray(register struct application *ap, int n)
 
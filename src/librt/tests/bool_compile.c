@@ -0,0 +1,275 @@
+/*                  B O O L _ C O M P I L E . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file bool_compile.c
+ *
+ * Shoot a grid of rays at regions with union, intersect, subtract,
+ * NOT and XOR trees over four overlapping spheres, once with the
+ * region trees compiled for rt_boolfinal() and once evaluated as
+ * trees, and check that the partitions agree.  The spheres overlap
+ * in every combination, which the union region checks the rays see.
+ */
+
+#include "common.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/env.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#define GRID_N 64
+#define MAX_PARTS 16
+#define NSOLIDS 4
+#define XOR_CHAIN 14	/* deep enough to be left uncompiled */
+
+struct ray_parts {
+    int n;
+    fastf_t in[MAX_PARTS];
+    fastf_t out[MAX_PARTS];
+    int mask[MAX_PARTS];	/* solids present, by bit */
+};
+
+
+static union tree *
+leaf(int i)
+{
+    union tree *tp;
+    char name[8];
+
+    snprintf(name, sizeof(name), "s%d", i % NSOLIDS);
+    BU_ALLOC(tp, union tree);
+    RT_TREE_INIT(tp);
+    tp->tr_l.tl_op = OP_DB_LEAF;
+    tp->tr_l.tl_name = bu_strdup(name);
+    tp->tr_l.tl_mat = NULL;
+    return tp;
+}
+
+
+static union tree *
+node(int op, union tree *left, union tree *right)
+{
+    union tree *tp;
+
+    BU_ALLOC(tp, union tree);
+    RT_TREE_INIT(tp);
+    tp->tr_b.tb_op = op;
+    tp->tr_b.tb_left = left;
+    tp->tr_b.tb_right = right;
+    return tp;
+}
+
+
+static void
+mk_region(struct rt_wdb *wdbp, const char *name, union tree *tree)
+{
+    struct rt_comb_internal *comb;
+
+    BU_ALLOC(comb, struct rt_comb_internal);
+    RT_COMB_INTERNAL_INIT(comb);
+    comb->tree = tree;
+    comb->region_flag = 1;
+    comb->region_id = 1000;
+    if (wdb_export(wdbp, name, (void *)comb, ID_COMBINATION, 1.0) < 0)
+	bu_exit(1, "unable to make %s\n", name);
+}
+
+
+static int
+record_hit(struct application *ap, struct partition *part_head, struct seg *UNUSED(segs))
+{
+    struct ray_parts *rp = (struct ray_parts *)ap->a_uptr;
+    struct partition *pp;
+    struct seg **segpp;
+
+    for (pp = part_head->pt_forw; pp != part_head && rp->n < MAX_PARTS; pp = pp->pt_forw) {
+	rp->in[rp->n] = pp->pt_inhit->hit_dist;
+	rp->out[rp->n] = pp->pt_outhit->hit_dist;
+	rp->mask[rp->n] = 0;
+	for (BU_PTBL_FOR(segpp, (struct seg **), &pp->pt_seglist))
+	    rp->mask[rp->n] |= 1 << ((*segpp)->seg_stp->st_dp->d_namep[1] - '0');
+	rp->n++;
+    }
+    return 1;
+}
+
+
+static int
+record_miss(struct application *UNUSED(ap))
+{
+    return 0;
+}
+
+
+static void
+shoot(struct db_i *dbip, const char *region, const char *compile, struct ray_parts *parts)
+{
+    struct application ap;
+    struct rt_i *rtip;
+    size_t i, j;
+
+    /* prep reads whether to compile the region trees */
+    bu_setenv("LIBRT_BOOL_COMPILE", compile, 1);
+
+    rtip = rt_new_rti(dbip);
+    if (rt_gettree(rtip, region) < 0)
+	bu_exit(1, "rt_gettree failed on %s\n", region);
+    rt_prep(rtip);
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_resource = &rt_uniresource;
+    ap.a_hit = record_hit;
+    ap.a_miss = record_miss;
+    ap.a_onehit = 0;
+
+    memset(parts, 0, GRID_N * GRID_N * sizeof(struct ray_parts));
+    for (i = 0; i < GRID_N; i++) {
+	for (j = 0; j < GRID_N; j++) {
+	    ap.a_uptr = (void *)&parts[i * GRID_N + j];
+	    VSET(ap.a_ray.r_pt, -3.2 + 6.4 * (i + 0.5) / GRID_N, -3.2 + 6.4 * (j + 0.5) / GRID_N, 10.0);
+	    VSET(ap.a_ray.r_dir, 0, 0, -1);
+	    (void)rt_shootray(&ap);
+	}
+    }
+
+    rt_free_rti(rtip);
+}
+
+
+int
+main(int argc, char **argv)
+{
+    struct db_i *dbip;
+    struct rt_wdb *wdbp;
+    struct ray_parts *compiled, *tree;
+    union tree *chain;
+    static const fastf_t centers[NSOLIDS][3] = {{1, 1, 1}, {1, -1, -1}, {-1, 1, -1}, {-1, -1, 1}};
+    const char *regions[] = {"union.r", "intersect.r", "subtract.r", "not.r", "xor.r", "xor_mix.r", "xor_short.r", "xor_chain.r"};
+    size_t i, r;
+    int k, seen = 0, fails = 0;
+
+    bu_setprogname(argv[0]);
+
+    if (argc != 1)
+	bu_exit(1, "Usage: %s\n", argv[0]);
+
+    if ((dbip = db_open_inmem()) == DBI_NULL)
+	bu_exit(1, "Unable to create database instance\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+
+    /* spheres on the corners of a tetrahedron, big enough that
+     * every combination of them has some space to itself
+     */
+    for (k = 0; k < NSOLIDS; k++) {
+	char name[8];
+
+	snprintf(name, sizeof(name), "s%d", k);
+	mk_sph(wdbp, name, centers[k], 2.0);
+    }
+
+    mk_region(wdbp, "union.r",
+	      node(OP_UNION, node(OP_UNION, node(OP_UNION, leaf(0), leaf(1)), leaf(2)), leaf(3)));
+    mk_region(wdbp, "intersect.r",
+	      node(OP_INTERSECT, node(OP_INTERSECT, leaf(0), leaf(1)), node(OP_UNION, leaf(2), leaf(3))));
+    mk_region(wdbp, "subtract.r",
+	      node(OP_SUBTRACT, node(OP_SUBTRACT, node(OP_UNION, leaf(0), leaf(1)), leaf(2)), leaf(3)));
+    mk_region(wdbp, "not.r",
+	      node(OP_INTERSECT, node(OP_UNION, leaf(1), leaf(2)), node(OP_NOT, node(OP_INTERSECT, leaf(0), leaf(3)), NULL)));
+    /* both sides true is a GUARD error */
+    mk_region(wdbp, "xor.r",
+	      node(OP_XOR, leaf(0), leaf(1)));
+    mk_region(wdbp, "xor_mix.r",
+	      node(OP_UNION, node(OP_XOR, node(OP_UNION, leaf(0), leaf(1)), node(OP_SUBTRACT, leaf(2), leaf(3))), node(OP_INTERSECT, leaf(1), leaf(3))));
+    mk_region(wdbp, "xor_short.r",
+	      node(OP_XOR, leaf(0), node(OP_XOR, leaf(1), node(OP_XOR, leaf(2), leaf(3)))));
+    chain = leaf(XOR_CHAIN);
+    for (k = XOR_CHAIN - 1; k >= 0; k--)
+	chain = node(OP_XOR, leaf(k), chain);
+    mk_region(wdbp, "xor_chain.r", chain);
+
+    compiled = (struct ray_parts *)bu_calloc(GRID_N * GRID_N, sizeof(struct ray_parts), "compiled");
+    tree = (struct ray_parts *)bu_calloc(GRID_N * GRID_N, sizeof(struct ray_parts), "tree");
+
+    for (r = 0; r < sizeof(regions) / sizeof(regions[0]); r++) {
+	int nbad = 0;
+
+	shoot(dbip, regions[r], "1", compiled);
+	shoot(dbip, regions[r], "0", tree);
+
+	for (i = 0; i < GRID_N * GRID_N; i++) {
+	    if (r == 0) {
+		for (k = 0; k < compiled[i].n; k++)
+		    seen |= 1 << compiled[i].mask[k];
+	    }
+	    if (compiled[i].n != tree[i].n) {
+		if (!nbad)
+		    bu_log("FAILED: %s: ray %zu has %d partitions compiled, %d as a tree\n",
+			   regions[r], i, compiled[i].n, tree[i].n);
+		nbad++;
+		continue;
+	    }
+	    for (k = 0; k < compiled[i].n; k++) {
+		if (compiled[i].mask[k] != tree[i].mask[k]
+		    || !NEAR_EQUAL(compiled[i].in[k], tree[i].in[k], SMALL_FASTF)
+		    || !NEAR_EQUAL(compiled[i].out[k], tree[i].out[k], SMALL_FASTF)) {
+		    if (!nbad)
+			bu_log("FAILED: %s: ray %zu partition %d differs compiled and as a tree\n",
+			       regions[r], i, k);
+		    nbad++;
+		    break;
+		}
+	    }
+	}
+	bu_log("%s: %zu rays, %d differ\n", regions[r], (size_t)(GRID_N * GRID_N), nbad);
+	if (nbad)
+	    fails++;
+    }
+
+    /* every combination but the empty one */
+    for (k = 1; k < (1 << NSOLIDS); k++) {
+	if (!(seen & (1 << k))) {
+	    bu_log("FAILED: no partition had solid combination %d\n", k);
+	    fails++;
+	}
+    }
+
+    bu_free(compiled, "compiled");
+    bu_free(tree, "tree");
+    db_close(dbip);
+
+    return fails != 0;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,305 @@
+/*                      B O T _ W I D E . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file bot_wide.c
+ *
+ * Shoot BoTs through the 4-wide BVH traversal (LIBRT_BOT_WIDE=1) and
+ * through the binary one (LIBRT_BOT_WIDE=0) and check that every ray
+ * gets the same partitions.  All vertices sit on a quarter unit
+ * lattice that the rays are aimed along, so rays run through shared
+ * vertices, along shared edges and in the planes of faces.  The
+ * tetrahedron fits in one leaf and the octahedron and cube in a few,
+ * leaving wide nodes with fewer than four children; LIBRT_BOT_MINTIE=1
+ * gives the same models deeper, narrower trees.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/env.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#define GRID_N 81	/* quarter unit steps from -10 to 10 */
+#define NDIRS 3
+#define MAX_PARTS 16
+#define HF_N 16		/* heightfield cells per side */
+
+struct ray_parts {
+    int n;
+    fastf_t in[MAX_PARTS];
+    fastf_t out[MAX_PARTS];
+};
+
+
+static int
+record_hit(struct application *ap, struct partition *part_head, struct seg *UNUSED(segs))
+{
+    struct ray_parts *rp = (struct ray_parts *)ap->a_uptr;
+    struct partition *pp;
+
+    rp->n = 0;
+    for (pp = part_head->pt_forw; pp != part_head && rp->n < MAX_PARTS; pp = pp->pt_forw) {
+	rp->in[rp->n] = pp->pt_inhit->hit_dist;
+	rp->out[rp->n] = pp->pt_outhit->hit_dist;
+	rp->n++;
+    }
+    return 1;
+}
+
+
+static int
+record_miss(struct application *ap)
+{
+    struct ray_parts *rp = (struct ray_parts *)ap->a_uptr;
+
+    rp->n = 0;
+    return 0;
+}
+
+
+static void
+mk_solid_bot(struct rt_wdb *wdbp, const char *name, const char *region, size_t nv, fastf_t *verts, size_t nf, int *faces)
+{
+    if (mk_bot(wdbp, name, RT_BOT_SOLID, RT_BOT_UNORIENTED, 0, nv, nf, verts, faces, NULL, NULL) < 0)
+	bu_exit(1, "unable to make %s\n", name);
+    (void)mk_comb1(wdbp, region, name, 1);
+}
+
+
+/* a closed heightfield on the integer lattice, quads split on the diagonal */
+static void
+mk_heightfield(struct rt_wdb *wdbp, const char *name, const char *region)
+{
+    size_t nv = 2 * (HF_N + 1) * (HF_N + 1);
+    size_t nf = 4 * HF_N * HF_N + 8 * HF_N;
+    fastf_t *verts = (fastf_t *)bu_calloc(nv * 3, sizeof(fastf_t), "verts");
+    int *faces = (int *)bu_calloc(nf * 3, sizeof(int), "faces");
+    int i, j, f = 0;
+
+#define HF_TOP(_i, _j) ((_i) * (HF_N + 1) + (_j))
+#define HF_BOT(_i, _j) ((HF_N + 1) * (HF_N + 1) + HF_TOP(_i, _j))
+#define HF_TRI(_a, _b, _c) { faces[3*f] = (_a); faces[3*f+1] = (_b); faces[3*f+2] = (_c); f++; }
+
+    for (i = 0; i <= HF_N; i++) {
+	for (j = 0; j <= HF_N; j++) {
+	    VSET(&verts[3 * HF_TOP(i, j)], i - HF_N / 2, j - HF_N / 2, 2 + (i * 3 + j * 5) % 4);
+	    VSET(&verts[3 * HF_BOT(i, j)], i - HF_N / 2, j - HF_N / 2, -2);
+	}
+    }
+    for (i = 0; i < HF_N; i++) {
+	for (j = 0; j < HF_N; j++) {
+	    HF_TRI(HF_TOP(i, j), HF_TOP(i + 1, j), HF_TOP(i + 1, j + 1));
+	    HF_TRI(HF_TOP(i, j), HF_TOP(i + 1, j + 1), HF_TOP(i, j + 1));
+	    HF_TRI(HF_BOT(i, j), HF_BOT(i + 1, j + 1), HF_BOT(i + 1, j));
+	    HF_TRI(HF_BOT(i, j), HF_BOT(i, j + 1), HF_BOT(i + 1, j + 1));
+	}
+    }
+    for (i = 0; i < HF_N; i++) {
+	HF_TRI(HF_TOP(i, 0), HF_BOT(i, 0), HF_BOT(i + 1, 0));
+	HF_TRI(HF_TOP(i, 0), HF_BOT(i + 1, 0), HF_TOP(i + 1, 0));
+	HF_TRI(HF_TOP(i, HF_N), HF_TOP(i + 1, HF_N), HF_BOT(i + 1, HF_N));
+	HF_TRI(HF_TOP(i, HF_N), HF_BOT(i + 1, HF_N), HF_BOT(i, HF_N));
+	HF_TRI(HF_TOP(0, i), HF_TOP(0, i + 1), HF_BOT(0, i + 1));
+	HF_TRI(HF_TOP(0, i), HF_BOT(0, i + 1), HF_BOT(0, i));
+	HF_TRI(HF_TOP(HF_N, i), HF_BOT(HF_N, i), HF_BOT(HF_N, i + 1));
+	HF_TRI(HF_TOP(HF_N, i), HF_BOT(HF_N, i + 1), HF_TOP(HF_N, i + 1));
+    }
+
+    mk_solid_bot(wdbp, name, region, nv, verts, nf, faces);
+
+    bu_free(verts, "verts");
+    bu_free(faces, "faces");
+}
+
+
+static void
+mk_models(struct rt_wdb *wdbp)
+{
+    fastf_t tet_v[] = {0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 2};
+    int tet_f[] = {0, 2, 1, 0, 1, 3, 0, 3, 2, 1, 2, 3};
+    fastf_t oct_v[] = {2, 0, 0, -2, 0, 0, 0, 2, 0, 0, -2, 0, 0, 0, 2, 0, 0, -2};
+    int oct_f[] = {0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4,
+		   2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5};
+    fastf_t cube_v[] = {-2, -2, -2, 2, -2, -2, 2, 2, -2, -2, 2, -2,
+			-2, -2, 2, 2, -2, 2, 2, 2, 2, -2, 2, 2};
+    int cube_f[] = {0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7,
+		    0, 1, 5, 0, 5, 4, 1, 2, 6, 1, 6, 5,
+		    2, 3, 7, 2, 7, 6, 3, 0, 4, 3, 4, 7};
+
+    mk_solid_bot(wdbp, "tet.bot", "tet", 4, tet_v, 4, tet_f);
+    mk_solid_bot(wdbp, "oct.bot", "oct", 6, oct_v, 8, oct_f);
+    mk_solid_bot(wdbp, "cube.bot", "cube", 8, cube_v, 12, cube_f);
+    mk_heightfield(wdbp, "hf.bot", "hf");
+}
+
+
+/* down the z axis, diagonally, and along the x axis */
+static void
+set_ray(struct application *ap, int dir, size_t i, size_t j)
+{
+    fastf_t u = -10.0 + 0.25 * i;
+    fastf_t v = -10.0 + 0.25 * j;
+    point_t through;
+
+    switch (dir) {
+	case 0:
+	    VSET(through, u, v, 0);
+	    VSET(ap->a_ray.r_dir, 0, 0, -1);
+	    break;
+	case 1:
+	    VSET(through, u, v, 0);
+	    VSET(ap->a_ray.r_dir, 1, 1, -1);
+	    VUNITIZE(ap->a_ray.r_dir);
+	    break;
+	default:
+	    VSET(through, 0, u, v);
+	    VSET(ap->a_ray.r_dir, 1, 0, 0);
+	    break;
+    }
+    VJOIN1(ap->a_ray.r_pt, through, -40.0, ap->a_ray.r_dir);
+}
+
+
+static void
+shoot(struct db_i *dbip, const char *region, const char *wide, struct ray_parts *parts)
+{
+    struct application ap;
+    struct rt_i *rtip;
+    size_t i, j;
+    int d;
+
+    /* prep reads which traversal to build */
+    bu_setenv("LIBRT_BOT_WIDE", wide, 1);
+
+    rtip = rt_new_rti(dbip);
+    if (rt_gettree(rtip, region) < 0)
+	bu_exit(1, "rt_gettree failed on %s\n", region);
+    rt_prep(rtip);
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_resource = &rt_uniresource;
+    ap.a_hit = record_hit;
+    ap.a_miss = record_miss;
+    ap.a_onehit = 0;
+
+    for (d = 0; d < NDIRS; d++) {
+	for (i = 0; i < GRID_N; i++) {
+	    for (j = 0; j < GRID_N; j++) {
+		ap.a_uptr = (void *)&parts[(d * GRID_N + i) * GRID_N + j];
+		set_ray(&ap, d, i, j);
+		(void)rt_shootray(&ap);
+	    }
+	}
+    }
+
+    rt_free_rti(rtip);
+}
+
+
+int
+main(int argc, char **argv)
+{
+    struct db_i *dbip;
+    struct rt_wdb *wdbp;
+    struct ray_parts *wide, *binary;
+    const char *regions[] = {"tet", "oct", "cube", "hf"};
+    const char *minties[] = {"8", "1"};
+    size_t i, r, m, nrays = NDIRS * GRID_N * GRID_N;
+    int k, fails = 0;
+
+    bu_setprogname(argv[0]);
+
+    if (argc != 1)
+	bu_exit(1, "Usage: %s\n", argv[0]);
+
+    /* the prep cache would hide LIBRT_BOT_MINTIE changes */
+    bu_setenv("LIBRT_CACHE", "0", 1);
+
+    if ((dbip = db_open_inmem()) == DBI_NULL)
+	bu_exit(1, "Unable to create database instance\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+
+    mk_models(wdbp);
+
+    wide = (struct ray_parts *)bu_calloc(nrays, sizeof(struct ray_parts), "wide");
+    binary = (struct ray_parts *)bu_calloc(nrays, sizeof(struct ray_parts), "binary");
+
+    for (m = 0; m < sizeof(minties) / sizeof(minties[0]); m++) {
+	bu_setenv("LIBRT_BOT_MINTIE", minties[m], 1);
+
+	for (r = 0; r < sizeof(regions) / sizeof(regions[0]); r++) {
+	    size_t nhit = 0, nbad = 0;
+
+	    shoot(dbip, regions[r], "1", wide);
+	    shoot(dbip, regions[r], "0", binary);
+
+	    for (i = 0; i < nrays; i++) {
+		if (binary[i].n)
+		    nhit++;
+		if (wide[i].n != binary[i].n) {
+		    if (!nbad)
+			bu_log("FAILED: %s: ray %zu has %d partitions wide, %d binary\n",
+			       regions[r], i, wide[i].n, binary[i].n);
+		    nbad++;
+		    continue;
+		}
+		for (k = 0; k < binary[i].n; k++) {
+		    if (!NEAR_EQUAL(wide[i].in[k], binary[i].in[k], SMALL_FASTF)
+			|| !NEAR_EQUAL(wide[i].out[k], binary[i].out[k], SMALL_FASTF)) {
+			if (!nbad)
+			    bu_log("FAILED: %s: ray %zu partition %d is %g..%g wide, %g..%g binary\n",
+				   regions[r], i, k, wide[i].in[k], wide[i].out[k], binary[i].in[k], binary[i].out[k]);
+			nbad++;
+			break;
+		    }
+		}
+	    }
+
+	    bu_log("%s (%s per leaf): %zu rays, %zu hits, %zu differ\n",
+		   regions[r], minties[m], nrays, nhit, nbad);
+	    if (nbad || !nhit)
+		fails++;
+	}
+    }
+
+    bu_free(wide, "wide");
+    bu_free(binary, "binary");
+    db_close(dbip);
+
+    return fails != 0;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
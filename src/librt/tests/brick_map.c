@@ -0,0 +1,624 @@
+/*                     B R I C K _ M A P . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file brick_map.c
+ *
+ * Shoot the grid primitives that skip empty space through the shared
+ * brick map (dsp, ebm and vol) and compare every partition with the
+ * solid found by walking the ray cell by cell here.  The data leave
+ * whole bricks empty, and besides rays from outside the solid there
+ * are rays starting inside it and rays running in the planes between
+ * bricks and through their corners.  The dsp bounding box, which only
+ * looks at the highest elevation, is checked against the data too.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/env.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/sort.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#define MAX_PARTS 32
+#define MAX_CROSS 1024
+#define GRID_N 24
+#define BRICK 4		/* cells along a brick edge */
+#define THIN 1.0e-5	/* partitions thinner than this are dropped */
+#define DIST_TOL 1.0e-6
+
+#define EBM_X 21
+#define EBM_Y 18
+#define EBM_Z 6.0
+#define VOL_X 19
+#define VOL_Y 17
+#define VOL_Z 13
+#define VOL_LO 100
+#define VOL_HI 255
+#define DSP_X 23	/* samples, one more than cells */
+#define DSP_Y 19
+
+enum grid_kind {GRID_EBM, GRID_VOL, GRID_DSP};
+
+struct grid_model {
+    enum grid_kind kind;
+    const char *region;
+    fastf_t size[3];		/* extent of the solid */
+    size_t dim[3];		/* cells along each axis */
+    const unsigned char *bits;	/* ebm */
+    const unsigned char *vox;	/* vol */
+    const unsigned short *elev;	/* dsp */
+};
+
+struct ray_parts {
+    int n;
+    fastf_t in[MAX_PARTS];
+    fastf_t out[MAX_PARTS];
+};
+
+
+static int
+record_hit(struct application *ap, struct partition *part_head, struct seg *UNUSED(segs))
+{
+    struct ray_parts *rp = (struct ray_parts *)ap->a_uptr;
+    struct partition *pp;
+
+    rp->n = 0;
+    for (pp = part_head->pt_forw; pp != part_head && rp->n < MAX_PARTS; pp = pp->pt_forw) {
+	rp->in[rp->n] = pp->pt_inhit->hit_dist;
+	rp->out[rp->n] = pp->pt_outhit->hit_dist;
+	rp->n++;
+    }
+    return 1;
+}
+
+
+static int
+record_miss(struct application *ap)
+{
+    struct ray_parts *rp = (struct ray_parts *)ap->a_uptr;
+
+    rp->n = 0;
+    return 0;
+}
+
+
+/* drop slivers and join abutting partitions, which the solids may split differently */
+static void
+parts_normalize(struct ray_parts *rp)
+{
+    int i, n = 0;
+
+    for (i = 0; i < rp->n; i++) {
+	if (rp->out[i] - rp->in[i] < THIN)
+	    continue;
+	if (n > 0 && rp->in[i] - rp->out[n-1] < THIN) {
+	    rp->out[n-1] = rp->out[i];
+	    continue;
+	}
+	rp->in[n] = rp->in[i];
+	rp->out[n] = rp->out[i];
+	n++;
+    }
+    rp->n = n;
+}
+
+
+static int
+fastf_comp(const void *a, const void *b, void *UNUSED(arg))
+{
+    fastf_t fa = *(const fastf_t *)a;
+    fastf_t fb = *(const fastf_t *)b;
+
+    return (fa > fb) - (fa < fb);
+}
+
+
+static size_t
+cell_of(fastf_t c, size_t dim)
+{
+    size_t i = (size_t)floor(c);
+
+    return (i >= dim) ? dim - 1 : i;
+}
+
+
+/* the dsp surface over (x, y), with the cells cut lower left to upper right */
+static fastf_t
+dsp_surface(const struct grid_model *gm, fastf_t x, fastf_t y, fastf_t *gx, fastf_t *gy)
+{
+    size_t i = cell_of(x, gm->dim[X]);
+    size_t j = cell_of(y, gm->dim[Y]);
+    fastf_t u = x - i, v = y - j;
+    fastf_t A = gm->elev[j * DSP_X + i];
+    fastf_t B = gm->elev[j * DSP_X + i + 1];
+    fastf_t C = gm->elev[(j + 1) * DSP_X + i];
+    fastf_t D = gm->elev[(j + 1) * DSP_X + i + 1];
+
+    if (u >= v) {
+	*gx = B - A;
+	*gy = D - B;
+    } else {
+	*gx = D - C;
+	*gy = C - A;
+    }
+    return A + u * (*gx) + v * (*gy);
+}
+
+
+static int
+grid_inside(const struct grid_model *gm, const point_t p)
+{
+    size_t x, y, z;
+    fastf_t gx, gy;
+
+    if (p[X] < 0.0 || p[Y] < 0.0 || p[Z] < 0.0
+	|| p[X] > gm->size[X] || p[Y] > gm->size[Y] || p[Z] > gm->size[Z])
+	return 0;
+
+    switch (gm->kind) {
+	case GRID_EBM:
+	    x = cell_of(p[X], gm->dim[X]);
+	    y = cell_of(p[Y], gm->dim[Y]);
+	    return gm->bits[y * EBM_X + x] != 0;
+	case GRID_VOL:
+	    x = cell_of(p[X], gm->dim[X]);
+	    y = cell_of(p[Y], gm->dim[Y]);
+	    z = cell_of(p[Z], gm->dim[Z]);
+	    return gm->vox[(z * VOL_Y + y) * VOL_X + x] >= VOL_LO && gm->vox[(z * VOL_Y + y) * VOL_X + x] <= VOL_HI;
+	default:
+	    return p[Z] <= dsp_surface(gm, p[X], p[Y], &gx, &gy);
+    }
+}
+
+
+/* add the distances at which the ray crosses planes coord = c0 + k * step */
+static void
+add_planes(fastf_t *t, size_t *nt, fastf_t tmin, fastf_t tmax, fastf_t pt, fastf_t dir, fastf_t c0, fastf_t c1)
+{
+    fastf_t c;
+
+    if (ZERO(dir))
+	return;
+    for (c = c0; c <= c1; c += 1.0) {
+	fastf_t d = (c - pt) / dir;
+	if (d > tmin && d < tmax && *nt < MAX_CROSS)
+	    t[(*nt)++] = d;
+    }
+}
+
+
+/**
+ * Find the solid along the whole line of the ray: every distance at
+ * which the ray could enter or leave it splits the line, and each
+ * piece is inside or out at its middle.
+ */
+static void
+grid_reference(const struct grid_model *gm, const struct xray *r, fastf_t tol, struct ray_parts *rp)
+{
+    fastf_t t[MAX_CROSS];
+    size_t nt = 0, k, npiece;
+    fastf_t tmin = -MAX_FASTF, tmax = MAX_FASTF;
+    int i, inside = 0;
+
+    rp->n = 0;
+
+    /* the box around the solid */
+    for (i = X; i <= Z; i++) {
+	fastf_t t0, t1;
+
+	if (ZERO(r->r_dir[i])) {
+	    if (r->r_pt[i] < 0.0 || r->r_pt[i] > gm->size[i])
+		return;
+	    continue;
+	}
+	t0 = -r->r_pt[i] / r->r_dir[i];
+	t1 = (gm->size[i] - r->r_pt[i]) / r->r_dir[i];
+	V_MAX(tmin, FMIN(t0, t1));
+	V_MIN(tmax, FMAX(t0, t1));
+    }
+    if (tmin >= tmax)
+	return;
+
+    t[nt++] = tmin;
+    t[nt++] = tmax;
+    add_planes(t, &nt, tmin, tmax, r->r_pt[X], r->r_dir[X], 1.0, gm->dim[X] - 1.0);
+    add_planes(t, &nt, tmin, tmax, r->r_pt[Y], r->r_dir[Y], 1.0, gm->dim[Y] - 1.0);
+    if (gm->kind == GRID_VOL)
+	add_planes(t, &nt, tmin, tmax, r->r_pt[Z], r->r_dir[Z], 1.0, gm->dim[Z] - 1.0);
+
+    if (gm->kind == GRID_DSP) {
+	/* the cell diagonals, then where the ray meets each triangle */
+	add_planes(t, &nt, tmin, tmax, r->r_pt[X] - r->r_pt[Y], r->r_dir[X] - r->r_dir[Y],
+		   -(fastf_t)gm->dim[Y] + 1.0, gm->dim[X] - 1.0);
+	bu_sort(t, nt, sizeof(fastf_t), fastf_comp, NULL);
+	npiece = nt - 1;
+	for (k = 0; k < npiece; k++) {
+	    fastf_t m = 0.5 * (t[k] + t[k+1]);
+	    fastf_t gx, gy, f, slope;
+	    point_t p;
+
+	    VJOIN1(p, r->r_pt, m, r->r_dir);
+	    f = p[Z] - dsp_surface(gm, p[X], p[Y], &gx, &gy);
+	    slope = r->r_dir[Z] - gx * r->r_dir[X] - gy * r->r_dir[Y];
+	    if (!ZERO(slope)) {
+		fastf_t root = m - f / slope;
+		if (root > t[k] && root < t[k+1] && nt < MAX_CROSS)
+		    t[nt++] = root;
+	    }
+	}
+    }
+    bu_sort(t, nt, sizeof(fastf_t), fastf_comp, NULL);
+
+    for (k = 0; k + 1 < nt; k++) {
+	point_t p;
+	int in;
+
+	if (t[k+1] - t[k] < SMALL_FASTF)
+	    continue;
+	VJOIN1(p, r->r_pt, 0.5 * (t[k] + t[k+1]), r->r_dir);
+	in = grid_inside(gm, p);
+	if (in && !inside) {
+	    if (rp->n >= MAX_PARTS)
+		break;
+	    rp->in[rp->n] = t[k];
+	    rp->out[rp->n] = t[k+1];
+	    rp->n++;
+	} else if (in) {
+	    rp->out[rp->n-1] = t[k+1];
+	}
+	inside = in;
+    }
+
+    parts_normalize(rp);
+
+    /* the raytracer keeps only what ends ahead of the ray start */
+    for (i = 0; i < rp->n && rp->out[i] < tol; i++)
+	;
+    if (i) {
+	memmove(rp->in, rp->in + i, (rp->n - i) * sizeof(fastf_t));
+	memmove(rp->out, rp->out + i, (rp->n - i) * sizeof(fastf_t));
+	rp->n -= i;
+    }
+}
+
+
+static void
+mk_grid_models(struct rt_wdb *wdbp, unsigned char *bits, unsigned char *vox, unsigned short *elev)
+{
+    struct rt_ebm_internal *ebm;
+    struct rt_dsp_internal *dsp;
+    vect_t cellsize = {1.0, 1.0, 1.0};
+    mat_t mat;
+    size_t x, y, z;
+
+    MAT_IDN(mat);
+
+    /* a disc, a block, a lone corner cell and a line, the rest empty */
+    for (y = 0; y < EBM_Y; y++) {
+	for (x = 0; x < EBM_X; x++) {
+	    fastf_t dx = x + 0.5 - 5.0, dy = y + 0.5 - 5.0;
+	    bits[y * EBM_X + x] = (dx * dx + dy * dy < 3.2 * 3.2)
+		|| (x >= 13 && x <= 18 && y >= 11 && y <= 15)
+		|| (x == EBM_X - 1 && y == 0)
+		|| (y == 9 && x <= 8);
+	}
+    }
+    if (mk_binunif(wdbp, "ebm.data", bits, WDB_BINUNIF_UINT8, EBM_X * EBM_Y) < 0)
+	bu_exit(1, "unable to make ebm.data\n");
+    BU_ALLOC(ebm, struct rt_ebm_internal);
+    ebm->magic = RT_EBM_INTERNAL_MAGIC;
+    bu_strlcpy(ebm->name, "ebm.data", RT_EBM_NAME_LEN);
+    ebm->datasrc = RT_EBM_SRC_OBJ;
+    ebm->xdim = EBM_X;
+    ebm->ydim = EBM_Y;
+    ebm->tallness = EBM_Z;
+    MAT_COPY(ebm->mat, mat);
+    if (wdb_export(wdbp, "ebm.s", (void *)ebm, ID_EBM, 1.0) < 0)
+	bu_exit(1, "unable to make ebm.s\n");
+    mk_comb1(wdbp, "ebm.r", "ebm.s", 1);
+
+    /* a ball, a block and a slab over noise below the threshold */
+    for (z = 0; z < VOL_Z; z++) {
+	for (y = 0; y < VOL_Y; y++) {
+	    for (x = 0; x < VOL_X; x++) {
+		fastf_t dx = x + 0.5 - 6.0, dy = y + 0.5 - 5.0, dz = z + 0.5 - 4.0;
+		unsigned char v = (unsigned char)((x * 7 + y * 3 + z) % 90);
+		if (dx * dx + dy * dy + dz * dz < 3.5 * 3.5)
+		    v = 200;
+		else if (x >= 12 && x <= 15 && y >= 10 && y <= 14 && z >= 7 && z <= 11)
+		    v = 150;
+		else if (z == 12 && x < 8)
+		    v = 120;
+		vox[(z * VOL_Y + y) * VOL_X + x] = v;
+	    }
+	}
+    }
+    if (mk_binunif(wdbp, "vol.data", vox, WDB_BINUNIF_UINT8, VOL_X * VOL_Y * VOL_Z) < 0)
+	bu_exit(1, "unable to make vol.data\n");
+    if (mk_vol(wdbp, "vol.s", RT_VOL_SRC_OBJ, "vol.data", VOL_X, VOL_Y, VOL_Z, VOL_LO, VOL_HI, cellsize, mat) < 0)
+	bu_exit(1, "unable to make vol.s\n");
+    mk_comb1(wdbp, "vol.r", "vol.s", 1);
+
+    /* low ground with a ridge and a hill */
+    for (y = 0; y < DSP_Y; y++) {
+	for (x = 0; x < DSP_X; x++) {
+	    fastf_t dx = x - 15.0, dy = y - 12.0;
+	    fastf_t hill = 30.0 * (1.0 - sqrt(dx * dx + dy * dy) / 6.0);
+	    elev[y * DSP_X + x] = (unsigned short)(2 + ((x == 7 && y < 9) ? 10 : 0) + ((hill > 0.0) ? (int)hill : 0));
+	}
+    }
+    if (mk_binunif(wdbp, "dsp.data", elev, WDB_BINUNIF_UINT16, DSP_X * DSP_Y) < 0)
+	bu_exit(1, "unable to make dsp.data\n");
+    BU_ALLOC(dsp, struct rt_dsp_internal);
+    dsp->magic = RT_DSP_INTERNAL_MAGIC;
+    bu_vls_init(&dsp->dsp_name);
+    bu_vls_strcat(&dsp->dsp_name, "dsp.data");
+    dsp->dsp_datasrc = RT_DSP_SRC_OBJ;
+    dsp->dsp_xcnt = DSP_X;
+    dsp->dsp_ycnt = DSP_Y;
+    dsp->dsp_smooth = 0;
+    dsp->dsp_cuttype = DSP_CUT_DIR_llUR;
+    MAT_COPY(dsp->dsp_stom, mat);
+    MAT_COPY(dsp->dsp_mtos, mat);
+    if (wdb_export(wdbp, "dsp.s", (void *)dsp, ID_DSP, 1.0) < 0)
+	bu_exit(1, "unable to make dsp.s\n");
+    mk_comb1(wdbp, "dsp.r", "dsp.s", 1);
+}
+
+
+/**
+ * Fill in ray number k of the test set for a solid of the given size,
+ * returning 0 past the last ray.  The set has rays from outside along
+ * three directions, the same rays started inside the solid box, rays
+ * in the planes between bricks, and rays through brick corners.
+ */
+static int
+test_ray(const struct grid_model *gm, size_t k, struct xray *r)
+{
+    const fastf_t *S = gm->size;
+    size_t ngrid = GRID_N * GRID_N;
+    size_t set = k / ngrid, u = (k % ngrid) / GRID_N, v = k % GRID_N;
+    fastf_t fu = (u + 0.37) / GRID_N, fv = (v + 0.61) / GRID_N;
+    size_t nb[3];
+    point_t through;
+    int i;
+
+    for (i = X; i <= Z; i++)
+	nb[i] = (gm->dim[i] - 1) / BRICK;
+
+    switch (set) {
+	case 0:
+	case 3:
+	    VSET(through, -0.5 + (S[X] + 1.0) * fu, -0.5 + (S[Y] + 1.0) * fv, 0.5 * S[Z]);
+	    VSET(r->r_dir, 0, 0, -1);
+	    break;
+	case 1:
+	case 4:
+	    VSET(through, -0.5 + (S[X] + 1.0) * fu, -0.5 + (S[Y] + 1.0) * fv, 0.5 * S[Z]);
+	    VSET(r->r_dir, 0.31, 0.17, -1);
+	    break;
+	case 2:
+	case 5:
+	    VSET(through, 0.5 * S[X], -0.5 + (S[Y] + 1.0) * fu, -0.5 + (S[Z] + 1.0) * fv);
+	    VSET(r->r_dir, 1, 0.23, 0.11);
+	    break;
+	case 6:
+	    /* in the planes x = multiple of BRICK, sloping down along y */
+	    if (u >= nb[X] * 2)
+		return 2;
+	    VSET(through, BRICK * (u / 2 + 1), -0.5 + (S[Y] + 1.0) * fv, 0.5 * S[Z]);
+	    if (u % 2)
+		VSET(r->r_dir, 0, 1, 0.05);
+	    else
+		VSET(r->r_dir, 0, 0.3, -1);
+	    break;
+	case 7:
+	    /* in the planes y = multiple of BRICK */
+	    if (u >= nb[Y] * 2)
+		return 2;
+	    VSET(through, -0.5 + (S[X] + 1.0) * fv, BRICK * (u / 2 + 1), 0.5 * S[Z]);
+	    if (u % 2)
+		VSET(r->r_dir, 1, 0, -0.07);
+	    else
+		VSET(r->r_dir, 0.3, 0, -1);
+	    break;
+	case 8:
+	    /* in the planes z = multiple of BRICK, for the vol */
+	    if (gm->kind != GRID_VOL || u >= nb[Z])
+		return 2;
+	    VSET(through, -0.5 + (S[X] + 1.0) * fv, 0.5 * S[Y], BRICK * (u + 1));
+	    VSET(r->r_dir, 0.3, 1, 0);
+	    break;
+	case 9:
+	    /* through brick corners, where the cell steps tie */
+	    if (u < 1 || v < 1 || u > nb[X] || v > nb[Y])
+		return 2;
+	    VSET(through, BRICK * u, BRICK * v, (gm->kind == GRID_VOL) ? BRICK : 0.5 * S[Z]);
+	    if ((u + v) % 2)
+		VSET(r->r_dir, 1, 1, -0.4);
+	    else
+		VSET(r->r_dir, 1, -1, 0);
+	    break;
+	default:
+	    return 0;
+    }
+    VUNITIZE(r->r_dir);
+
+    /* the first three sets start outside, the next three at their middle */
+    if (set >= 3 && set <= 5)
+	VMOVE(r->r_pt, through);
+    else
+	VJOIN1(r->r_pt, through, -100.0, r->r_dir);
+    return 1;
+}
+
+
+static int
+compare_model(struct db_i *dbip, const struct grid_model *gm)
+{
+    struct application ap;
+    struct rt_i *rtip;
+    struct ray_parts got, want;
+    size_t k, nrays = 0, nhit = 0, ninside = 0, nbad = 0;
+    int ret, p;
+
+    rtip = rt_new_rti(dbip);
+    if (rt_gettree(rtip, gm->region) < 0)
+	bu_exit(1, "rt_gettree failed on %s\n", gm->region);
+    rt_prep(rtip);
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_resource = &rt_uniresource;
+    ap.a_hit = record_hit;
+    ap.a_miss = record_miss;
+    ap.a_onehit = 0;
+    ap.a_uptr = (void *)&got;
+
+    for (k = 0; (ret = test_ray(gm, k, &ap.a_ray)) != 0; k++) {
+	if (ret != 1)
+	    continue;
+	nrays++;
+
+	(void)rt_shootray(&ap);
+	parts_normalize(&got);
+	grid_reference(gm, &ap.a_ray, rtip->rti_tol.dist, &want);
+
+	if (want.n)
+	    nhit++;
+	if (want.n && want.in[0] < 0.0)
+	    ninside++;
+
+	if (got.n != want.n) {
+	    if (!nbad)
+		bu_log("FAILED: %s: ray %zu (%g %g %g) dir (%g %g %g) has %d partitions, expected %d\n",
+		       gm->region, k, V3ARGS(ap.a_ray.r_pt), V3ARGS(ap.a_ray.r_dir), got.n, want.n);
+	    nbad++;
+	    continue;
+	}
+	for (p = 0; p < want.n; p++) {
+	    /* a ray starting inside may report its entry anywhere behind */
+	    int in_ok = (want.in[p] < rtip->rti_tol.dist) ? got.in[p] < rtip->rti_tol.dist
+		: NEAR_EQUAL(got.in[p], want.in[p], DIST_TOL);
+	    if (!in_ok || !NEAR_EQUAL(got.out[p], want.out[p], DIST_TOL)) {
+		if (!nbad)
+		    bu_log("FAILED: %s: ray %zu (%g %g %g) dir (%g %g %g) partition %d is %.12g..%.12g, expected %.12g..%.12g\n",
+			   gm->region, k, V3ARGS(ap.a_ray.r_pt), V3ARGS(ap.a_ray.r_dir),
+			   p, got.in[p], got.out[p], want.in[p], want.out[p]);
+		nbad++;
+		break;
+	    }
+	}
+    }
+
+    bu_log("%s: %zu rays, %zu hits, %zu from inside, %zu differ\n", gm->region, nrays, nhit, ninside, nbad);
+    rt_free_rti(rtip);
+
+    if (!nhit || !ninside) {
+	bu_log("FAILED: %s: the rays missed the solid or never started inside it\n", gm->region);
+	return 1;
+    }
+    return nbad != 0;
+}
+
+
+/* the dsp bounding box comes from the highest elevation alone */
+static int
+check_dsp_bbox(struct db_i *dbip, const struct grid_model *gm)
+{
+    struct directory *dp;
+    point_t min, max;
+    unsigned short top = 0;
+    size_t i;
+
+    for (i = 0; i < DSP_X * DSP_Y; i++)
+	V_MAX(top, gm->elev[i]);
+
+    if ((dp = db_lookup(dbip, "dsp.s", LOOKUP_QUIET)) == RT_DIR_NULL || rt_bound_internal(dbip, dp, min, max) < 0) {
+	bu_log("FAILED: no bounding box for dsp.s\n");
+	return 1;
+    }
+    if (min[X] > 0.0 || min[Y] > 0.0 || min[Z] > 0.0
+	|| max[X] < gm->size[X] || max[Y] < gm->size[Y] || max[Z] < top
+	|| max[Z] > top + 1.0) {
+	bu_log("FAILED: dsp.s bounding box (%g %g %g) (%g %g %g) does not fit elevations up to %u\n",
+	       V3ARGS(min), V3ARGS(max), top);
+	return 1;
+    }
+    return 0;
+}
+
+
+int
+main(int argc, char **argv)
+{
+    struct db_i *dbip;
+    struct rt_wdb *wdbp;
+    static unsigned char bits[EBM_X * EBM_Y];
+    static unsigned char vox[VOL_X * VOL_Y * VOL_Z];
+    static unsigned short elev[DSP_X * DSP_Y];
+    struct grid_model ebm = {GRID_EBM, "ebm.r", {EBM_X, EBM_Y, EBM_Z}, {EBM_X, EBM_Y, 1}, bits, NULL, NULL};
+    struct grid_model vol = {GRID_VOL, "vol.r", {VOL_X, VOL_Y, VOL_Z}, {VOL_X, VOL_Y, VOL_Z}, NULL, vox, NULL};
+    struct grid_model dsp = {GRID_DSP, "dsp.r", {DSP_X - 1, DSP_Y - 1, 0}, {DSP_X - 1, DSP_Y - 1, 1}, NULL, NULL, elev};
+    size_t i;
+    int fails = 0;
+
+    bu_setprogname(argv[0]);
+
+    if (argc != 1)
+	bu_exit(1, "Usage: %s\n", argv[0]);
+
+    /* always build the brick maps rather than read them back */
+    bu_setenv("LIBRT_CACHE", "0", 1);
+
+    if ((dbip = db_open_inmem()) == DBI_NULL)
+	bu_exit(1, "Unable to create database instance\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+
+    mk_grid_models(wdbp, bits, vox, elev);
+    for (i = 0; i < DSP_X * DSP_Y; i++)
+	V_MAX(dsp.size[Z], elev[i]);
+
+    fails += compare_model(dbip, &ebm);
+    fails += compare_model(dbip, &vol);
+    fails += compare_model(dbip, &dsp);
+    fails += check_dsp_bbox(dbip, &dsp);
+
+    db_close(dbip);
+
+    return fails != 0;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
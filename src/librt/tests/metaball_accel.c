@@ -0,0 +1,197 @@
+/*                  M E T A B A L L _ A C C E L . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file metaball_accel.c
+ *
+ * Shoot a grid of rays at a metaball with many control points, once
+ * prepped with the accelerated intersector and once without, and
+ * check that the hit distances agree.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/env.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/str.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#define GRID_N 96
+#define SIDE 10
+
+/* hit distances may differ by this much, the truncated field being
+ * off by at most 1e-3 of the threshold */
+#define DIST_TOL 0.02
+
+
+static int
+first_hit(struct application *ap, struct partition *part_head, struct seg *UNUSED(segs))
+{
+    fastf_t *dist = (fastf_t *)ap->a_uptr;
+
+    *dist = part_head->pt_forw->pt_inhit->hit_dist;
+    return 1;
+}
+
+
+static int
+first_miss(struct application *ap)
+{
+    fastf_t *dist = (fastf_t *)ap->a_uptr;
+
+    *dist = INFINITY;
+    return 0;
+}
+
+
+static void
+shoot(struct db_i *dbip, const char *accel, fastf_t *dists)
+{
+    struct application ap;
+    struct rt_i *rtip;
+    size_t i, j;
+
+    /* prep reads the choice of intersector */
+    bu_setenv("LIBRT_METABALL_ACCEL", accel, 1);
+
+    rtip = rt_new_rti(dbip);
+    if (rt_gettree(rtip, "mb") < 0)
+	bu_exit(1, "rt_gettree failed on mb\n");
+    rt_prep(rtip);
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_resource = &rt_uniresource;
+    ap.a_hit = first_hit;
+    ap.a_miss = first_miss;
+    ap.a_onehit = 1;
+
+    for (i = 0; i < GRID_N; i++) {
+	for (j = 0; j < GRID_N; j++) {
+	    ap.a_uptr = (void *)&dists[i * GRID_N + j];
+	    VSET(ap.a_ray.r_pt, -5.0 + 3.0 * (SIDE + 3) * i / GRID_N, -5.0 + 3.0 * (SIDE + 3) * j / GRID_N, 50.0);
+	    VSET(ap.a_ray.r_dir, 0, 0, -1);
+	    (void)rt_shootray(&ap);
+	}
+    }
+
+    rt_free_rti(rtip);
+}
+
+
+int
+main(int argc, char **argv)
+{
+    struct db_i *dbip;
+    struct rt_wdb *wdbp;
+    fastf_t pts[SIDE * SIDE][5];
+    const fastf_t *verts[SIDE * SIDE];
+    fastf_t *fast, *exact;
+    fastf_t maxdiff = 0.0;
+    size_t i, j, nhit = 0, nbad = 0;
+    int method;
+
+    bu_setprogname(argv[0]);
+
+    if (argc != 2)
+	bu_exit(1, "Usage: %s {isopotential|blob}\n", argv[0]);
+    if (BU_STR_EQUAL(argv[1], "isopotential"))
+	method = METABALL_ISOPOTENTIAL;
+    else if (BU_STR_EQUAL(argv[1], "blob"))
+	method = METABALL_BLOB;
+    else
+	bu_exit(1, "unknown method %s\n", argv[1]);
+
+    if ((dbip = db_open_inmem()) == DBI_NULL)
+	bu_exit(1, "Unable to create database instance\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+
+    /* a wavy, jittered sheet of overlapping blobs */
+    for (i = 0; i < SIDE; i++) {
+	for (j = 0; j < SIDE; j++) {
+	    fastf_t *p = pts[i * SIDE + j];
+	    p[X] = 3.0 * i + 0.4 * sin(7.0 * j);
+	    p[Y] = 3.0 * j + 0.4 * cos(5.0 * i);
+	    p[Z] = 1.5 * sin(0.9 * i) * cos(0.7 * j);
+	    p[3] = (method == METABALL_BLOB) ? 2.0 : 1.0;
+	    p[4] = 1.0;
+	    verts[i * SIDE + j] = p;
+	}
+    }
+    if (mk_metaball(wdbp, "mb", SIDE * SIDE, method, 1.0, verts) < 0)
+	bu_exit(1, "unable to make the metaball\n");
+
+    fast = (fastf_t *)bu_calloc(GRID_N * GRID_N, sizeof(fastf_t), "fast");
+    exact = (fastf_t *)bu_calloc(GRID_N * GRID_N, sizeof(fastf_t), "exact");
+
+    shoot(dbip, "1", fast);
+    shoot(dbip, "0", exact);
+
+    for (i = 0; i < GRID_N * GRID_N; i++) {
+	if (exact[i] < INFINITY)
+	    nhit++;
+	if (fast[i] >= INFINITY && exact[i] >= INFINITY)
+	    continue;
+	if (fast[i] >= INFINITY || exact[i] >= INFINITY) {
+	    /* only a ray grazing the surface could tell them apart */
+	    nbad++;
+	    continue;
+	}
+	if (fabs(fast[i] - exact[i]) > maxdiff)
+	    maxdiff = fabs(fast[i] - exact[i]);
+	if (fabs(fast[i] - exact[i]) > DIST_TOL)
+	    nbad++;
+    }
+
+    bu_log("%s: %d rays, %zu hits, %zu differ, largest difference %g\n",
+	   argv[1], GRID_N * GRID_N, nhit, nbad, maxdiff);
+
+    bu_free(fast, "fast");
+    bu_free(exact, "exact");
+    db_close(dbip);
+
+    if (!nhit) {
+	bu_log("FAILED: no ray hit the metaball\n");
+	return 1;
+    }
+    /* allow for the odd grazing ray, no more */
+    if (nbad > (size_t)(GRID_N * GRID_N) / 200) {
+	bu_log("FAILED: %zu rays differ between the accelerated and exact intersectors\n", nbad);
+	return 1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,194 @@
+/*               P O L Y _ R E A L _ R O O T S . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file poly_real_roots.c
+ *
+ * Build polynomials from known roots and check that
+ * rt_poly_real_roots() and rt_poly_real_roots_n() recover the ones
+ * inside the interval, and that rt_poly_near_real_roots_n() also
+ * reports a complex pair just off the real axis.
+ */
+
+#include "common.h"
+
+#include <math.h>
+
+#include "bu/app.h"
+#include "bu/log.h"
+#include "vmath.h"
+#include "raytrace.h"
+
+
+#define NCASES 2000
+#define NNEAR 200
+#define ROOT_TOL 1.0e-7
+
+
+/* eqn = scale * product of (x - r[i]) times (x^2 + 1) pairs */
+static void
+poly_from_roots(bn_poly_t *eqn, const fastf_t r[], int nreal, int ncomplex, fastf_t scale)
+{
+    bn_poly_t f = BN_POLY_INIT_ZERO;
+    bn_poly_t tmp;
+    int i;
+
+    *eqn = f;
+    eqn->cf[0] = scale;
+    for (i = 0; i < nreal; i++) {
+	f.dgr = 1;
+	f.cf[0] = 1.0;
+	f.cf[1] = -r[i];
+	bn_poly_mul(&tmp, eqn, &f);
+	*eqn = tmp;
+    }
+    for (i = 0; i < ncomplex; i++) {
+	f.dgr = 2;
+	f.cf[0] = 1.0;
+	f.cf[1] = -2.0 * i;
+	f.cf[2] = i * i + 0.25;
+	bn_poly_mul(&tmp, eqn, &f);
+	*eqn = tmp;
+    }
+}
+
+
+static int
+check(const char *what, const fastf_t found[], int nfound, const fastf_t r[], int nreal, fastf_t lo, fastf_t hi)
+{
+    fastf_t expect[BN_MAX_POLY_DEGREE];
+    int i, j, n = 0;
+
+    for (i = 0; i < nreal; i++) {
+	if (r[i] < lo || r[i] > hi)
+	    continue;
+	for (j = n; j > 0 && expect[j-1] > r[i]; j--)
+	    expect[j] = expect[j-1];
+	expect[j] = r[i];
+	n++;
+    }
+
+    if (n != nfound) {
+	bu_log("FAILED: %s: %d roots, expected %d\n", what, nfound, n);
+	return 1;
+    }
+    for (i = 0; i < n; i++) {
+	if (!NEAR_EQUAL(found[i], expect[i], ROOT_TOL * (1.0 + fabs(expect[i])))) {
+	    bu_log("FAILED: %s: root %d is %.17g, expected %.17g\n", what, i, found[i], expect[i]);
+	    return 1;
+	}
+    }
+    return 0;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    bn_poly_t eqns[NCASES];
+    bn_poly_t near_eqn;
+    fastf_t r[NCASES][BN_MAX_POLY_DEGREE];
+    int nreal[NCASES];
+    fastf_t lo[NCASES], hi[NCASES];
+    fastf_t roots[NCASES * BN_MAX_POLY_DEGREE];
+    fastf_t found[BN_MAX_POLY_DEGREE];
+    int nroots[NCASES];
+    int i, j, n, ncomplex, fails = 0;
+    unsigned long seed = 1;
+
+    bu_setprogname(argv[0]);
+    if (argc != 1)
+	bu_exit(1, "Usage: %s\n", argv[0]);
+
+    for (i = 0; i < NCASES; i++) {
+	/* degrees 2 through 6 with some complex pairs, a double root
+	 * (a grazing ray) in every fifth case
+	 */
+	ncomplex = i % 3 == 0 ? (i / 3) % 2 : 0;
+	nreal[i] = 2 + i % 5 - 2 * ncomplex;
+	if (nreal[i] < 1)
+	    nreal[i] = 1;
+	for (j = 0; j < nreal[i]; j++) {
+	    seed = seed * 1103515245 + 12345;
+	    r[i][j] = ((seed >> 8) % 20000) / 1000.0 - 10.0;
+	}
+	if (i % 5 == 0 && nreal[i] > 1)
+	    r[i][1] = r[i][0];
+
+	poly_from_roots(&eqns[i], r[i], nreal[i], ncomplex, 0.5 + (i % 7));
+	lo[i] = -8.0005;
+	hi[i] = 8.0005;
+
+	n = rt_poly_real_roots(&eqns[i], lo[i], hi[i], found);
+	fails += check("rt_poly_real_roots", found, n, r[i], nreal[i], lo[i], hi[i]);
+    }
+
+    rt_poly_real_roots_n(NCASES, eqns, lo, hi, roots, nroots);
+    for (i = 0; i < NCASES; i++)
+	fails += check("rt_poly_real_roots_n", &roots[i * BN_MAX_POLY_DEGREE], nroots[i], r[i], nreal[i], lo[i], hi[i]);
+
+    /* without near misses the near solver finds the same roots */
+    rt_poly_near_real_roots_n(NCASES, eqns, lo, hi, roots, nroots);
+    for (i = 0; i < NCASES; i++)
+	fails += check("rt_poly_near_real_roots_n", &roots[i * BN_MAX_POLY_DEGREE], nroots[i], r[i], nreal[i], lo[i], hi[i]);
+
+    /* quartics with a pair x = c +- im i just inside RT_ROOT_TOL of
+     * the real axis, which only the near solver reports, as a double
+     * root at c
+     */
+    for (i = 0; i < NNEAR; i++) {
+	bn_poly_t f = BN_POLY_INIT_ZERO;
+	fastf_t c = -6.0 + 12.0 * i / NNEAR;
+	fastf_t im = 0.9 * RT_ROOT_TOL * (1.0 + fabs(c));
+
+	r[i][0] = c - 1.5;
+	r[i][1] = c + 2.5;
+	poly_from_roots(&eqns[i], r[i], 2, 0, 1.0);
+	f.dgr = 2;
+	f.cf[0] = 1.0;
+	f.cf[1] = -2.0 * c;
+	f.cf[2] = c * c + im * im;
+	bn_poly_mul(&near_eqn, &eqns[i], &f);
+	eqns[i] = near_eqn;
+	lo[i] = -10.0;
+	hi[i] = 10.0;
+
+	n = rt_poly_real_roots(&eqns[i], lo[i], hi[i], found);
+	fails += check("rt_poly_real_roots near miss", found, n, r[i], 2, lo[i], hi[i]);
+
+	r[i][2] = c;
+	r[i][3] = c;
+    }
+    rt_poly_near_real_roots_n(NNEAR, eqns, lo, hi, roots, nroots);
+    for (i = 0; i < NNEAR; i++)
+	fails += check("rt_poly_near_real_roots_n near miss", &roots[i * BN_MAX_POLY_DEGREE], nroots[i], r[i], 4, lo[i], hi[i]);
+
+    bu_log("%d of %d cases failed\n", fails, 3 * NCASES + 2 * NNEAR);
+    return fails != 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,236 @@
+/*                   R E P R E P _ A N I M . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file reprep_anim.c
+ *
+ * Move one region of a prepped model with an animation, bring the
+ * model up to date with rt_reprep_anim(), and check a grid of rays
+ * against the same model prepped from scratch.
+ */
+
+#include "common.h"
+
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/parallel.h"
+#include "bu/ptbl.h"
+#include "bu/str.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#define GRID_N 64
+
+struct first_part {
+    const struct region *regp;
+    fastf_t in_dist;
+    fastf_t out_dist;
+};
+
+
+static int
+first_hit(struct application *ap, struct partition *part_head, struct seg *UNUSED(segs))
+{
+    struct first_part *fp = (struct first_part *)ap->a_uptr;
+    struct partition *pp = part_head->pt_forw;
+
+    fp->regp = pp->pt_regionp;
+    fp->in_dist = pp->pt_inhit->hit_dist;
+    fp->out_dist = pp->pt_outhit->hit_dist;
+    return 1;
+}
+
+
+static int
+first_miss(struct application *ap)
+{
+    struct first_part *fp = (struct first_part *)ap->a_uptr;
+
+    fp->regp = REGION_NULL;
+    return 0;
+}
+
+
+static struct rt_i *
+prep_model(struct db_i *dbip, struct resource *resp, size_t ncpus)
+{
+    struct rt_i *rtip = rt_new_rti(dbip);
+    size_t i;
+
+    for (i = 0; i < ncpus; i++)
+	rt_init_resource(&resp[i], (int)i, rtip);
+    if (rt_gettree(rtip, "all") < 0)
+	bu_exit(1, "rt_gettree failed on all\n");
+    rt_prep_parallel(rtip, ncpus);
+
+    return rtip;
+}
+
+
+static void
+shoot(struct rt_i *rtip, struct resource *resp, size_t ncpus, struct first_part *parts)
+{
+    struct application ap;
+    size_t i, j;
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_hit = first_hit;
+    ap.a_miss = first_miss;
+    ap.a_onehit = 1;
+
+    for (i = 0; i < GRID_N; i++) {
+	for (j = 0; j < GRID_N; j++) {
+	    size_t k = i * GRID_N + j;
+
+	    /* spread the rays over every resource */
+	    ap.a_resource = &resp[k % ncpus];
+	    ap.a_uptr = (void *)&parts[k];
+	    VSET(ap.a_ray.r_pt, -30.0 + 100.0 * i / GRID_N, -30.0 + 80.0 * j / GRID_N, 100.0);
+	    VSET(ap.a_ray.r_dir, 0, 0, -1);
+	    (void)rt_shootray(&ap);
+	}
+    }
+}
+
+
+int
+main(int argc, char **argv)
+{
+    struct db_i *dbip;
+    struct rt_wdb *wdbp;
+    struct wmember head;
+    struct rt_i *rtip, *full_rtip;
+    struct resource *resp, *full_resp;
+    struct first_part *parts, *full_parts;
+    struct animate *anp;
+    struct bu_ptbl anims = BU_PTBL_INIT_ZERO;
+    point_t center, min, max;
+    size_t ncpus = bu_avail_cpus();
+    size_t i, nmoved = 0;
+    int ret, fails = 0;
+    const char *anim_argv[] = {"anim", "all/b.r", "matrix", "rstack", "translate", "0", "25", "0"};
+
+    bu_setprogname(argv[0]);
+
+    if (argc != 1)
+	bu_exit(1, "Usage: %s\n", argv[0]);
+
+    if ((dbip = db_open_inmem()) == DBI_NULL)
+	bu_exit(1, "Unable to create database instance\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+
+    VSET(center, 0, 0, 0);
+    mk_sph(wdbp, "a.s", center, 10.0);
+    VSET(center, 40, 0, 0);
+    mk_sph(wdbp, "b.s", center, 10.0);
+    VSET(min, -20, -30, -5);
+    VSET(max, 60, -20, 5);
+    mk_rpp(wdbp, "c.s", min, max);
+    mk_comb1(wdbp, "a.r", "a.s", 1);
+    mk_comb1(wdbp, "b.r", "b.s", 1);
+    mk_comb1(wdbp, "c.r", "c.s", 1);
+
+    BU_LIST_INIT(&head.l);
+    (void)mk_addmember("a.r", &head.l, NULL, WMOP_UNION);
+    (void)mk_addmember("b.r", &head.l, NULL, WMOP_UNION);
+    (void)mk_addmember("c.r", &head.l, NULL, WMOP_UNION);
+    mk_lcomb(wdbp, "all", &head, 0, NULL, NULL, NULL, 0);
+
+    resp = (struct resource *)bu_calloc(ncpus, sizeof(struct resource), "resources");
+    full_resp = (struct resource *)bu_calloc(ncpus, sizeof(struct resource), "full resources");
+    parts = (struct first_part *)bu_calloc(GRID_N * GRID_N, sizeof(struct first_part), "parts");
+    full_parts = (struct first_part *)bu_calloc(GRID_N * GRID_N, sizeof(struct first_part), "full parts");
+
+    rtip = prep_model(dbip, resp, ncpus);
+
+    /* move b.r from y -10..10 over to 15..35 */
+    anp = db_parse_1anim(dbip, sizeof(anim_argv) / sizeof(anim_argv[0]), anim_argv);
+    if (!anp || db_add_anim(dbip, anp, 0) < 0)
+	bu_exit(1, "unable to animate all/b.r\n");
+    bu_ptbl_init(&anims, 8, "anims");
+    bu_ptbl_ins(&anims, (long *)anp);
+
+    ret = rt_reprep_anim(rtip, &anims, ncpus, &resp[0]);
+    if (ret != 1) {
+	bu_log("FAILED: rt_reprep_anim re-prepped %d regions, expected 1\n", ret);
+	fails++;
+    }
+
+    full_rtip = prep_model(dbip, full_resp, ncpus);
+
+    shoot(rtip, resp, ncpus, parts);
+    shoot(full_rtip, full_resp, ncpus, full_parts);
+
+    for (i = 0; i < GRID_N * GRID_N; i++) {
+	const struct region *r1 = parts[i].regp;
+	const struct region *r2 = full_parts[i].regp;
+
+	if (!r1 && !r2)
+	    continue;
+	if (!r1 || !r2 || !BU_STR_EQUAL(r1->reg_name, r2->reg_name)) {
+	    bu_log("FAILED: ray %zu hit %s, %s when prepped from scratch\n", i,
+		   r1 ? r1->reg_name : "nothing", r2 ? r2->reg_name : "nothing");
+	    fails++;
+	    continue;
+	}
+	if (!NEAR_EQUAL(parts[i].in_dist, full_parts[i].in_dist, SMALL_FASTF)
+	    || !NEAR_EQUAL(parts[i].out_dist, full_parts[i].out_dist, SMALL_FASTF)) {
+	    bu_log("FAILED: ray %zu on %s spans %g..%g, %g..%g when prepped from scratch\n", i,
+		   r1->reg_name, parts[i].in_dist, parts[i].out_dist,
+		   full_parts[i].in_dist, full_parts[i].out_dist);
+	    fails++;
+	    continue;
+	}
+	/* rays past y 12 could only reach b.r at its new place */
+	if (BU_STR_EQUAL(r1->reg_name, "/all/b.r") && -30.0 + 80.0 * (i % GRID_N) / GRID_N > 12.0)
+	    nmoved++;
+    }
+
+    if (!nmoved) {
+	bu_log("FAILED: no ray hit the moved region\n");
+	fails++;
+    }
+    bu_log("%d rays, %zu on the moved region, %d failed\n", GRID_N * GRID_N, nmoved, fails);
+
+    bu_ptbl_free(&anims);
+    rt_free_rti(rtip);
+    rt_free_rti(full_rtip);
+    bu_free(parts, "parts");
+    bu_free(full_parts, "full parts");
+    bu_free(resp, "resources");
+    bu_free(full_resp, "full resources");
+    db_close(dbip);
+
+    return fails != 0;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
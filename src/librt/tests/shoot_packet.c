@@ -0,0 +1,336 @@
+/*                  S H O O T _ P A C K E T . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file shoot_packet.c
+ *
+ * Shoot a perspective grid of rays at a BoT model and at a CSG model
+ * prepped with HLBVH space partitioning, once in 4x4 packets with
+ * rt_shootray_packet() and once ray by ray with rt_shootray(), and
+ * check that every ray gets the same partitions.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/str.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#define GRID_N 64	/* a multiple of TILE */
+#define TILE 4		/* TILE * TILE <= RT_PACKET_MAX */
+#define MAX_PARTS 16
+#define HF_N 24		/* heightfield cells per side */
+
+struct ray_parts {
+    int n;
+    const struct region *reg[MAX_PARTS];
+    fastf_t in[MAX_PARTS];
+    fastf_t out[MAX_PARTS];
+};
+
+
+static int
+record_hit(struct application *ap, struct partition *part_head, struct seg *UNUSED(segs))
+{
+    struct ray_parts *rp = (struct ray_parts *)ap->a_uptr;
+    struct partition *pp;
+
+    rp->n = 0;
+    for (pp = part_head->pt_forw; pp != part_head && rp->n < MAX_PARTS; pp = pp->pt_forw) {
+	rp->reg[rp->n] = pp->pt_regionp;
+	rp->in[rp->n] = pp->pt_inhit->hit_dist;
+	rp->out[rp->n] = pp->pt_outhit->hit_dist;
+	rp->n++;
+    }
+    return 1;
+}
+
+
+static int
+record_miss(struct application *ap)
+{
+    struct ray_parts *rp = (struct ray_parts *)ap->a_uptr;
+
+    rp->n = 0;
+    return 0;
+}
+
+
+/* a closed heightfield: a wavy top over a flat bottom, with walls */
+static void
+mk_heightfield(struct rt_wdb *wdbp, const char *name)
+{
+    size_t nv = 2 * (HF_N + 1) * (HF_N + 1);
+    size_t nf = 4 * HF_N * HF_N + 8 * HF_N;
+    fastf_t *verts = (fastf_t *)bu_calloc(nv * 3, sizeof(fastf_t), "verts");
+    int *faces = (int *)bu_calloc(nf * 3, sizeof(int), "faces");
+    int i, j, f = 0;
+
+#define HF_TOP(_i, _j) ((_i) * (HF_N + 1) + (_j))
+#define HF_BOT(_i, _j) ((HF_N + 1) * (HF_N + 1) + HF_TOP(_i, _j))
+#define HF_TRI(_a, _b, _c) { faces[3*f] = (_a); faces[3*f+1] = (_b); faces[3*f+2] = (_c); f++; }
+
+    for (i = 0; i <= HF_N; i++) {
+	for (j = 0; j <= HF_N; j++) {
+	    VSET(&verts[3 * HF_TOP(i, j)], i - HF_N / 2.0, j - HF_N / 2.0, 3.0 + 1.5 * sin(0.5 * i) * cos(0.4 * j));
+	    VSET(&verts[3 * HF_BOT(i, j)], i - HF_N / 2.0, j - HF_N / 2.0, 0.0);
+	}
+    }
+    for (i = 0; i < HF_N; i++) {
+	for (j = 0; j < HF_N; j++) {
+	    HF_TRI(HF_TOP(i, j), HF_TOP(i + 1, j), HF_TOP(i + 1, j + 1));
+	    HF_TRI(HF_TOP(i, j), HF_TOP(i + 1, j + 1), HF_TOP(i, j + 1));
+	    HF_TRI(HF_BOT(i, j), HF_BOT(i + 1, j + 1), HF_BOT(i + 1, j));
+	    HF_TRI(HF_BOT(i, j), HF_BOT(i, j + 1), HF_BOT(i + 1, j + 1));
+	}
+    }
+    for (i = 0; i < HF_N; i++) {
+	HF_TRI(HF_TOP(i, 0), HF_BOT(i, 0), HF_BOT(i + 1, 0));
+	HF_TRI(HF_TOP(i, 0), HF_BOT(i + 1, 0), HF_TOP(i + 1, 0));
+	HF_TRI(HF_TOP(i, HF_N), HF_TOP(i + 1, HF_N), HF_BOT(i + 1, HF_N));
+	HF_TRI(HF_TOP(i, HF_N), HF_BOT(i + 1, HF_N), HF_BOT(i, HF_N));
+	HF_TRI(HF_TOP(0, i), HF_TOP(0, i + 1), HF_BOT(0, i + 1));
+	HF_TRI(HF_TOP(0, i), HF_BOT(0, i + 1), HF_BOT(0, i));
+	HF_TRI(HF_TOP(HF_N, i), HF_BOT(HF_N, i), HF_BOT(HF_N, i + 1));
+	HF_TRI(HF_TOP(HF_N, i), HF_BOT(HF_N, i + 1), HF_TOP(HF_N, i + 1));
+    }
+
+    if (mk_bot(wdbp, name, RT_BOT_SOLID, RT_BOT_UNORIENTED, 0, nv, nf, verts, faces, NULL, NULL) < 0)
+	bu_exit(1, "unable to make %s\n", name);
+
+    bu_free(verts, "verts");
+    bu_free(faces, "faces");
+}
+
+
+static void
+mk_models(struct rt_wdb *wdbp)
+{
+    struct wmember head;
+    point_t p1, p2;
+    vect_t a, b, c;
+
+    /* BoT model: the heightfield with a sphere half sunk into it */
+    mk_heightfield(wdbp, "hf.bot");
+    mk_comb1(wdbp, "hf.r", "hf.bot", 1);
+    VSET(p1, 3, -2, 3);
+    mk_sph(wdbp, "bot_ball.s", p1, 2.5);
+    mk_comb1(wdbp, "bot_ball.r", "bot_ball.s", 1);
+    BU_LIST_INIT(&head.l);
+    (void)mk_addmember("hf.r", &head.l, NULL, WMOP_UNION);
+    (void)mk_addmember("bot_ball.r", &head.l, NULL, WMOP_UNION);
+    mk_lcomb(wdbp, "bot", &head, 0, NULL, NULL, NULL, 0);
+
+    /* CSG model, with a vectorized kernel for every solid type */
+    VSET(p1, -10, -10, 0);
+    VSET(p2, -2, -2, 6);
+    mk_rpp(wdbp, "box.s", p1, p2);
+    VSET(p1, -2, -2, 6);
+    mk_sph(wdbp, "hole.s", p1, 4.0);
+    BU_LIST_INIT(&head.l);
+    (void)mk_addmember("box.s", &head.l, NULL, WMOP_UNION);
+    (void)mk_addmember("hole.s", &head.l, NULL, WMOP_SUBTRACT);
+    mk_lcomb(wdbp, "box.r", &head, 1, NULL, NULL, NULL, 0);
+
+    VSET(p1, 6, 6, 3);
+    VSET(a, 0.3, 0.2, 1);
+    VUNITIZE(a);
+    mk_tor(wdbp, "ring.s", p1, a, 4.0, 1.2);
+    mk_comb1(wdbp, "ring.r", "ring.s", 1);
+
+    VSET(p1, 6, -6, 0);
+    VSET(p2, 5, -5, 8);
+    mk_trc_top(wdbp, "cone.s", p1, p2, 3.5, 1.0);
+    VSET(p1, 6, -6, 3);
+    VSET(a, 4, 0, 0);
+    VSET(b, 0, 3, 0);
+    VSET(c, 0, 0, 5);
+    mk_ell(wdbp, "egg.s", p1, a, b, c);
+    BU_LIST_INIT(&head.l);
+    (void)mk_addmember("cone.s", &head.l, NULL, WMOP_UNION);
+    (void)mk_addmember("egg.s", &head.l, NULL, WMOP_INTERSECT);
+    mk_lcomb(wdbp, "cone.r", &head, 1, NULL, NULL, NULL, 0);
+
+    VSET(p1, -6, 6, 0);
+    VSET(a, 1, 0, 7);
+    mk_rcc(wdbp, "post.s", p1, a, 2.0);
+    VSET(p1, -5, 6, 7);
+    mk_sph(wdbp, "knob.s", p1, 2.5);
+    BU_LIST_INIT(&head.l);
+    (void)mk_addmember("post.s", &head.l, NULL, WMOP_UNION);
+    (void)mk_addmember("knob.s", &head.l, NULL, WMOP_UNION);
+    mk_lcomb(wdbp, "post.r", &head, 1, NULL, NULL, NULL, 0);
+
+    BU_LIST_INIT(&head.l);
+    (void)mk_addmember("box.r", &head.l, NULL, WMOP_UNION);
+    (void)mk_addmember("ring.r", &head.l, NULL, WMOP_UNION);
+    (void)mk_addmember("cone.r", &head.l, NULL, WMOP_UNION);
+    (void)mk_addmember("post.r", &head.l, NULL, WMOP_UNION);
+    mk_lcomb(wdbp, "csg", &head, 0, NULL, NULL, NULL, 0);
+}
+
+
+static void
+set_ray(struct application *ap, size_t i, size_t j)
+{
+    point_t eye, target;
+
+    /* perspective from above and to one side */
+    VSET(eye, -4.0, -40.0, 25.0);
+    VSET(target, -16.0 + 32.0 * (i + 0.5) / GRID_N, 0.0, -8.0 + 20.0 * (j + 0.5) / GRID_N);
+    VMOVE(ap->a_ray.r_pt, eye);
+    VSUB2(ap->a_ray.r_dir, target, eye);
+    VUNITIZE(ap->a_ray.r_dir);
+}
+
+
+static int
+compare_model(struct db_i *dbip, const char *model)
+{
+    struct application aps[TILE * TILE];
+    struct application ap;
+    struct ray_parts *packet, *single;
+    struct rt_i *rtip;
+    size_t i, j, ti, tj, k, nhit = 0, nbad = 0;
+    int p;
+
+    rtip = rt_new_rti(dbip);
+    rtip->rti_space_partition = RT_PART_HLBVH;
+    if (rt_gettree(rtip, model) < 0)
+	bu_exit(1, "rt_gettree failed on %s\n", model);
+    rt_prep(rtip);
+    if (rtip->rti_space_partition != RT_PART_HLBVH)
+	bu_exit(1, "%s was not prepped with HLBVH space partitioning\n", model);
+
+    packet = (struct ray_parts *)bu_calloc(GRID_N * GRID_N, sizeof(struct ray_parts), "packet");
+    single = (struct ray_parts *)bu_calloc(GRID_N * GRID_N, sizeof(struct ray_parts), "single");
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_resource = &rt_uniresource;
+    ap.a_hit = record_hit;
+    ap.a_miss = record_miss;
+    ap.a_onehit = 0;
+
+    /* packets of neighboring rays */
+    for (ti = 0; ti < GRID_N; ti += TILE) {
+	for (tj = 0; tj < GRID_N; tj += TILE) {
+	    k = 0;
+	    for (i = ti; i < ti + TILE; i++) {
+		for (j = tj; j < tj + TILE; j++) {
+		    aps[k] = ap;
+		    aps[k].a_uptr = (void *)&packet[i * GRID_N + j];
+		    set_ray(&aps[k], i, j);
+		    k++;
+		}
+	    }
+	    (void)rt_shootray_packet(aps, (int)k);
+	}
+    }
+
+    /* the same rays one at a time */
+    for (i = 0; i < GRID_N; i++) {
+	for (j = 0; j < GRID_N; j++) {
+	    ap.a_uptr = (void *)&single[i * GRID_N + j];
+	    set_ray(&ap, i, j);
+	    (void)rt_shootray(&ap);
+	}
+    }
+
+    for (k = 0; k < GRID_N * GRID_N; k++) {
+	if (single[k].n)
+	    nhit++;
+	if (packet[k].n != single[k].n) {
+	    if (!nbad)
+		bu_log("FAILED: %s: ray %zu has %d partitions in a packet, %d alone\n",
+		       model, k, packet[k].n, single[k].n);
+	    nbad++;
+	    continue;
+	}
+	for (p = 0; p < single[k].n; p++) {
+	    if (packet[k].reg[p] != single[k].reg[p]
+		|| !NEAR_EQUAL(packet[k].in[p], single[k].in[p], SMALL_FASTF)
+		|| !NEAR_EQUAL(packet[k].out[p], single[k].out[p], SMALL_FASTF)) {
+		if (!nbad)
+		    bu_log("FAILED: %s: ray %zu partition %d is %s %g..%g in a packet, %s %g..%g alone\n",
+			   model, k, p,
+			   packet[k].reg[p] ? packet[k].reg[p]->reg_name : "nothing", packet[k].in[p], packet[k].out[p],
+			   single[k].reg[p] ? single[k].reg[p]->reg_name : "nothing", single[k].in[p], single[k].out[p]);
+		nbad++;
+		break;
+	    }
+	}
+    }
+
+    bu_log("%s: %d rays, %zu hits, %zu differ\n", model, GRID_N * GRID_N, nhit, nbad);
+
+    bu_free(packet, "packet");
+    bu_free(single, "single");
+    rt_free_rti(rtip);
+
+    if (!nhit) {
+	bu_log("FAILED: %s: no ray hit the model\n", model);
+	return 1;
+    }
+    return nbad != 0;
+}
+
+
+int
+main(int argc, char **argv)
+{
+    struct db_i *dbip;
+    struct rt_wdb *wdbp;
+    int fails = 0;
+
+    bu_setprogname(argv[0]);
+
+    if (argc != 1)
+	bu_exit(1, "Usage: %s\n", argv[0]);
+
+    if ((dbip = db_open_inmem()) == DBI_NULL)
+	bu_exit(1, "Unable to create database instance\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+
+    mk_models(wdbp);
+
+    fails += compare_model(dbip, "bot");
+    fails += compare_model(dbip, "csg");
+
+    db_close(dbip);
+
+    return fails != 0;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -484,7 +484,10 @@ _rt_gettree_leaf(struct db_tree_state *tsp, const struct db_full_path *pathp, st
     }
 
     if (rtip->rti_add_to_new_solids_list) {
+	/* leaves may be walked in parallel */
+	bu_semaphore_acquire(RT_SEM_MODEL);
 	bu_ptbl_ins(&rtip->rti_new_solids, (long *)stp);
+	bu_semaphore_release(RT_SEM_MODEL);
     }
 
     stp->st_id = ip->idb_type;
@@ -33,6 +33,29 @@
 #include "vmath.h"
 #include "raytrace.h"
 
+#include "./librt_private.h"
+
+
+void
+rt_vshot_store(struct seg *segp, struct seg *seghead, struct resource *resp)
+{
+    struct seg *first;
+
+    if (BU_LIST_IS_EMPTY(&(seghead->l))) {
+	segp->seg_stp = SOLTAB_NULL;
+	return;
+    }
+
+    first = BU_LIST_FIRST(seg, &(seghead->l));
+    BU_LIST_DEQUEUE(&(first->l));
+    segp->seg_in = first->seg_in;	/* struct copy */
+    segp->seg_out = first->seg_out;	/* struct copy */
+    segp->seg_stp = first->seg_stp;
+    RT_FREE_SEG(first, resp);
+
+    BU_LIST_APPEND_LIST(&(segp->l), &(seghead->l));
+}
+
 
 /**
  * Stub function which will "simulate" a call to a vector shot routine
@@ -46,7 +69,6 @@ vshot_stub(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struc
 /* pointer to an application */
 {
     register int i;
-    register struct seg *tmp_seg;
     struct seg seghead;
     int ret;
 
@@ -63,17 +85,78 @@ vshot_stub(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struc
 	    }
 	    if (ret <= 0) {
 		segp[i].seg_stp=(struct soltab *) 0;
+		rt_seg_list_release(&seghead, ap->a_resource);
 	    } else {
-		tmp_seg = BU_LIST_FIRST(seg, &(seghead.l));
-		BU_LIST_DEQUEUE(&(tmp_seg->l));
-		segp[i] = *tmp_seg; /* structure copy */
-		RT_FREE_SEG(tmp_seg, ap->a_resource);
+		rt_vshot_store(&segp[i], &seghead, ap->a_resource);
 	    }
 	}
     }
 }
 
 
+/**
+ * Move the segments of one ft_vshot() result slot onto seghead,
+ * giving the first one storage of its own.  Returns the number of
+ * hit points, as ft_shot() would.
+ */
+static int
+vshot_fetch(struct seg *segp, struct seg *seghead, struct resource *resp)
+{
+    struct seg *s;
+    int nhits;
+
+    if (segp->seg_stp == SOLTAB_NULL)
+	return 0;
+
+    RT_GET_SEG(s, resp);
+    s->seg_stp = segp->seg_stp;
+    s->seg_in = segp->seg_in;	/* struct copy */
+    s->seg_out = segp->seg_out;	/* struct copy */
+    s->seg_in.hit_magic = s->seg_out.hit_magic = RT_HIT_MAGIC;
+    BU_LIST_INSERT(&(seghead->l), &(s->l));
+    nhits = 2;
+
+    while (BU_LIST_WHILE(s, seg, &(segp->l))) {
+	BU_LIST_DEQUEUE(&(s->l));
+	BU_LIST_INSERT(&(seghead->l), &(s->l));
+	nhits += 2;
+    }
+    return nhits;
+}
+
+
+void
+rt_vshot_solid(struct soltab *stp, int n, struct xray *rp[], struct application *ap, struct seg *seghead[], int ret[])
+{
+    struct soltab *ary_stp[RT_VSHOT_BLOCK];
+    struct seg ary_seg[RT_VSHOT_BLOCK];
+    int base, m, i;
+
+    RT_CK_SOLTAB(stp);
+    RT_CK_RESOURCE(ap->a_resource);
+
+    for (base = 0; base < n; base += RT_VSHOT_BLOCK) {
+	m = n - base;
+	if (m > RT_VSHOT_BLOCK)
+	    m = RT_VSHOT_BLOCK;
+
+	for (i = 0; i < m; i++) {
+	    ary_stp[i] = stp;
+	    ary_seg[i].seg_stp = SOLTAB_NULL;
+	    BU_LIST_INIT(&(ary_seg[i].l));
+	}
+
+	if (stp->st_meth->ft_vshot)
+	    stp->st_meth->ft_vshot(ary_stp, &rp[base], ary_seg, m, ap);
+	else
+	    vshot_stub(ary_stp, &rp[base], ary_seg, m, ap);
+
+	for (i = 0; i < m; i++)
+	    ret[base+i] = vshot_fetch(&ary_seg[i], seghead[base+i], ap->a_resource);
+    }
+}
+
+
 /**
  * Given a ray, shoot it at all the relevant parts of the model,
  * (building the HeadSeg chain), and then call rt_boolregions() to
@@ -115,23 +198,25 @@ vshot_stub(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struc
 int
 rt_vshootray(struct application *ap)
 {
-    struct seg *HeadSeg;
-    int ret;
+    struct seg waiting_segs;	/* awaiting rt_boolweave() */
+    struct seg finished_segs;	/* processed by rt_boolweave() */
+    struct resource *resp;
+    struct xray ray;		/* copy of a_ray, clipped to the model */
     vect_t inv_dir;	/* inverses of ap->a_ray.r_dir */
     struct bu_bitv *solidbits;	/* bits for all solids shot so far */
     struct bu_ptbl *regionbits;	/* bits for all involved regions */
     char *status;
     struct partition InitialPart;	/* Head of Initial Partitions */
     struct partition FinalPart;	/* Head of Final Partitions */
-    int nrays = 1;			/* for now */
+    int ret;
     int vlen;
     int id;
     int i;
     struct soltab **ary_stp;	/* array of pointers */
     struct xray **ary_rp;	/* array of pointers */
+    struct xray *ary_ray;	/* copies of ray, clipped per solid */
     struct seg *ary_seg;	/* array of structures */
     struct rt_i *rtip;
-    int done;
 
 #define BACKING_DIST (-2.0)		/* mm to look behind start point */
     rtip = ap->a_rt_i;
@@ -139,11 +224,12 @@ rt_vshootray(struct application *ap)
     if (!ap->a_resource) {
 	ap->a_resource = &rt_uniresource;
     }
-    RT_CK_RESOURCE(ap->a_resource);
+    resp = ap->a_resource;
+    RT_CK_RESOURCE(resp);
 
     if (RT_G_DEBUG&(RT_DEBUG_ALLRAYS|RT_DEBUG_SHOOT|RT_DEBUG_PARTITION)) {
 	bu_log("\n**********mshootray cpu=%d  %d, %d lvl=%d (%s)\n",
-	       ap->a_resource->re_cpu,
+	       resp->re_cpu,
 	       ap->a_x, ap->a_y,
 	       ap->a_level,
 	       ap->a_purpose != (char *)0 ? ap->a_purpose : "?");
@@ -156,28 +242,36 @@ rt_vshootray(struct application *ap)
 	rt_prep(rtip);
 
     /* Allocate dynamic memory */
-    vlen = nrays * rtip->rti_maxsol_by_type;
+    vlen = rtip->rti_maxsol_by_type;
+    if (vlen < 1)
+	vlen = 1;
     ary_stp = (struct soltab **)bu_calloc(vlen, sizeof(struct soltab *),
 					  "*ary_stp[]");
     ary_rp = (struct xray **)bu_calloc(vlen, sizeof(struct xray *),
 				       "*ary_rp[]");
     ary_seg = (struct seg *)bu_calloc(vlen, sizeof(struct seg),
 				      "ary_seg[]");
+    ary_ray = (struct xray *)bu_calloc(vlen, sizeof(struct xray),
+				       "ary_ray[]");
 
     /**** for each ray, do this ****/
 
     InitialPart.pt_forw = InitialPart.pt_back = &InitialPart;
+    InitialPart.pt_magic = PT_HD_MAGIC;
     FinalPart.pt_forw = FinalPart.pt_back = &FinalPart;
+    FinalPart.pt_magic = PT_HD_MAGIC;
 
-    HeadSeg = RT_SEG_NULL;
+    BU_LIST_INIT(&waiting_segs.l);
+    BU_LIST_INIT(&finished_segs.l);
+    ap->a_finished_segs_hdp = &finished_segs;
 
-    solidbits = rt_get_solidbitv(rtip->nsolids, ap->a_resource);
+    solidbits = rt_get_solidbitv(rtip->nsolids, resp);
 
-    if (BU_LIST_IS_EMPTY(&ap->a_resource->re_region_ptbl)) {
+    if (BU_LIST_IS_EMPTY(&resp->re_region_ptbl)) {
 	BU_ALLOC(regionbits, struct bu_ptbl);
 	bu_ptbl_init(regionbits, 7, "rt_shootray() regionbits ptbl");
     } else {
-	regionbits = BU_LIST_FIRST(bu_ptbl, &ap->a_resource->re_region_ptbl);
+	regionbits = BU_LIST_FIRST(bu_ptbl, &resp->re_region_ptbl);
 	BU_LIST_DEQUEUE(&regionbits->l);
 	BU_CK_PTBL(regionbits);
     }
@@ -220,87 +314,91 @@ rt_vshootray(struct application *ap)
 	status = "MISS model";
 	goto out;
     }
+    ray = ap->a_ray;	/* struct copy */
 
     /* For each type of solid to be shot at, assemble the vectors */
     for (id = 1; id <= ID_MAX_SOLID; id++) {
 	register int nsol;
+	int nvec;
 
 	if ((nsol = rtip->rti_nsol_by_type[id]) <= 0) continue;
 
-	/* For each instance of this solid type */
-	for (i = nsol-1; i >= 0; i--) {
-	    ary_stp[i] = rtip->rti_sol_by_type[id][i];
-	    ary_rp[i] = &(ap->a_ray);	/* XXX, sb [ray] */
-	    ary_seg[i].seg_stp = SOLTAB_NULL;
-	    BU_LIST_INIT(&ary_seg[i].l);
+	/* For each instance of this solid type that the ray can reach */
+	nvec = 0;
+	for (i = 0; i < nsol; i++) {
+	    struct soltab *stp = rtip->rti_sol_by_type[id][i];
+	    struct xray *rp = &ary_ray[nvec];
+
+	    /* each solid gets its own r_min/r_max */
+	    *rp = ray;		/* struct copy */
+	    if (OBJ[id].ft_use_rpp &&
+		(!rt_in_rpp(rp, inv_dir, stp->st_min, stp->st_max) ||
+		 rp->r_max < BACKING_DIST)) {
+		resp->re_prune_solrpp++;
+		continue;
+	    }
+	    BU_BITSET(solidbits, stp->st_bit);
+	    ary_stp[nvec] = stp;
+	    ary_rp[nvec] = rp;
+	    ary_seg[nvec].seg_stp = SOLTAB_NULL;
+	    BU_LIST_INIT(&ary_seg[nvec].l);
+	    nvec++;
 	}
-	/* bounding box check */
-	/* bit vector per ray check */
-	/* mark elements to be skipped with ary_stp[] = SOLTAB_NULL */
-	ap->a_rt_i->nshots += nsol;	/* later: skipped ones */
+	if (!nvec)
+	    continue;
+
+	rtip->nshots += nvec;
+	resp->re_shots += nvec;
 	if (OBJ[id].ft_vshot) {
-	    OBJ[id].ft_vshot(ary_stp, ary_rp, ary_seg, nsol, ap);
+	    OBJ[id].ft_vshot(ary_stp, ary_rp, ary_seg, nvec, ap);
 	} else {
-	    vshot_stub(ary_stp, ary_rp, ary_seg, nsol, ap);
+	    vshot_stub(ary_stp, ary_rp, ary_seg, nvec, ap);
 	}
 
-
-	/* set bits for all solids shot at for each ray */
-
-	/* append resulting seg list to input for boolweave */
-	for (i = nsol-1; i >= 0; i--) {
+	/* append resulting segs to the list awaiting boolweave */
+	for (i = 0; i < nvec; i++) {
+	    struct seg seghead;
 	    register struct seg *seg2;
 
-	    if (ary_seg[i].seg_stp == SOLTAB_NULL) {
+	    BU_LIST_INIT(&seghead.l);
+	    if (!vshot_fetch(&ary_seg[i], &seghead, resp)) {
 		/* MISS */
-		ap->a_rt_i->nmiss++;
+		rtip->nmiss++;
+		resp->re_shot_miss++;
 		continue;
 	    }
-	    ap->a_rt_i->nhits++;
-
-	    /* For now, do it the slow way.  sb [ray] */
-	    /* MUST dup it -- all segs have to live till after a_hit() */
-	    RT_GET_SEG(seg2, ap->a_resource);
-	    *seg2 = ary_seg[i];	/* struct copy */
-	    /* rt_boolweave(seg2, &InitialPart, ap); */
-	    bu_bomb("FIXME: need to call boolweave here");
-
-	    /* Add seg chain to list of used segs awaiting reclaim */
-
-#if 0
-	    /* FIXME: need to use waiting_segs/finished_segs here in
-	     * conjunction with rt_boolweave()
-	     {
-	     register struct seg *seg3 = seg2;
-	     while (seg3->seg_next != RT_SEG_NULL)
-	     seg3 = seg3->seg_next;
-	     seg3->seg_next = HeadSeg;
-	     HeadSeg = seg2;
-	     }
-	    */
-#endif
+	    rtip->nhits++;
+	    resp->re_shot_hit++;
+
+	    /* all segs have to live till after a_hit() */
+	    while (BU_LIST_WHILE(seg2, seg, &(seghead.l))) {
+		BU_LIST_DEQUEUE(&(seg2->l));
+		seg2->seg_in.hit_rayp = seg2->seg_out.hit_rayp = &ap->a_ray;
+		BU_LIST_INSERT(&(waiting_segs.l), &(seg2->l));
+	    }
 	}
     }
 
     /*
      * Ray has finally left known space.
      */
-    if (InitialPart.pt_forw == &InitialPart) {
+    if (BU_LIST_NON_EMPTY(&(waiting_segs.l))) {
+	rt_boolweave(&finished_segs, &waiting_segs, &InitialPart, ap);
+    }
+    if (BU_LIST_IS_EMPTY(&(finished_segs.l))) {
 	if (ap->a_miss)
 	    ret = ap->a_miss(ap);
 	else
 	    ret = 0;
 	status = "MISSed all primitives";
-	goto freeup;
+	goto out;
     }
 
     /*
      * All intersections of the ray with the model have been computed.
      * Evaluate the boolean trees over each partition.
      */
-    done = rt_boolfinal(&InitialPart, &FinalPart, BACKING_DIST, INFINITY, regionbits, ap, solidbits);
-
-    if (done > 0) goto hitit;
+    (void)rt_boolfinal(&InitialPart, &FinalPart, BACKING_DIST, INFINITY, regionbits, ap, solidbits);
 
     if (FinalPart.pt_forw == &FinalPart) {
 	if (ap->a_miss)
@@ -323,11 +421,13 @@ rt_vshootray(struct application *ap)
      *
      * VJOIN1(hitp->hit_point, rp->r_pt, hitp->hit_dist, rp->r_dir);
      */
-hitit:
     if (RT_G_DEBUG&RT_DEBUG_SHOOT) rt_pr_partitions(rtip, &FinalPart, "a_hit()");
 
+    /* Release storage for unused Initial partitions before recursing */
+    rt_pt_list_release(&InitialPart, resp);
+
     if (ap->a_hit)
-	ret = ap->a_hit(ap, &FinalPart, HeadSeg/* &finished_segs */);
+	ret = ap->a_hit(ap, &FinalPart, &finished_segs);
     else
 	ret = 0;
     status = "HIT";
@@ -336,36 +436,27 @@ hitit:
      * Processing of this ray is complete.  Free dynamic resources.
      */
 freeup:
-    {
-	register struct partition *pp;
-
-	/* Free up initial partition list */
-	for (pp = InitialPart.pt_forw; pp != &InitialPart;) {
-	    register struct partition *newpp;
-	    newpp = pp;
-	    pp = pp->pt_forw;
-	    FREE_PT(newpp, ap->a_resource);
-	}
-	/* Free up final partition list */
-	for (pp = FinalPart.pt_forw; pp != &FinalPart;) {
-	    register struct partition *newpp;
-	    newpp = pp;
-	    pp = pp->pt_forw;
-	    FREE_PT(newpp, ap->a_resource);
-	}
-    }
+    rt_pt_list_release(&InitialPart, resp);
+    rt_pt_list_release(&FinalPart, resp);
 
 out:
+    rt_seg_list_release(&finished_segs, resp);
+    rt_seg_list_release(&waiting_segs, resp);
+
     bu_free((char *)ary_stp, "*ary_stp[]");
     bu_free((char *)ary_rp, "*ary_rp[]");
     bu_free((char *)ary_seg, "ary_seg[]");
+    bu_free((char *)ary_ray, "ary_ray[]");
+
+    /* Return dynamic resources to their freelists.  */
+    BU_CK_BITV(solidbits);
+    BU_LIST_APPEND(&resp->re_solid_bitv, &solidbits->l);
+    BU_CK_PTBL(regionbits);
+    BU_LIST_APPEND(&resp->re_region_ptbl, &regionbits->l);
 
-    if (solidbits != NULL) {
-	bu_bitv_free(solidbits);
-    }
     if (RT_G_DEBUG&(RT_DEBUG_ALLRAYS|RT_DEBUG_SHOOT|RT_DEBUG_PARTITION)) {
 	bu_log("----------mshootray cpu=%d  %d, %d lvl=%d (%s) %s ret=%d\n",
-	       ap->a_resource->re_cpu,
+	       resp->re_cpu,
 	       ap->a_x, ap->a_y,
 	       ap->a_level,
 	       ap->a_purpose != (char *)0 ? ap->a_purpose : "?",
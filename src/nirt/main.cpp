@@ -656,6 +656,15 @@ main(int argc, const char **argv)
 	(void)nirt_exec(ns, bu_vls_cstr(&ncmd));
     }
 
+    if (optv.space_partition == RT_PART_HLBVH) {
+	(void)nirt_exec(ns, "space_partition bvh");
+    }
+
+    if (optv.batch_size > 1) {
+	bu_vls_sprintf(&ncmd, "batch %d", optv.batch_size);
+	(void)nirt_exec(ns, bu_vls_cstr(&ncmd));
+    }
+
     if (optv.overlap_claims) {
 	switch (optv.overlap_claims) {
 	    case NIRT_OVLP_RESOLVE:
@@ -850,6 +859,10 @@ main(int argc, const char **argv)
 	bu_vls_trunc(&iline, 0);
     }
 
+    /* Fire any shots still queued from the last batch, however batching
+     * was turned on, while the output streams are still open */
+    (void)nirt_exec(ns, "batch 0");
+
 done:
     delete l;
     bu_vls_free(&launch_cmd);
@@ -301,10 +301,225 @@ int cm_orientation(const int argc, const char **argv)
 }
 
 
+/* "set anim_incremental=1" keeps the prepped geometry across "clean" */
+static int anim_incremental = 0;
+static int anim_pending = 0;		/* "clean" kept the geometry for "end" */
+static int view_dropped = 0;		/* view_setup() deleted regions */
+static struct bu_ptbl anim_prev = BU_PTBL_INIT_ZERO;	/* last frame's chains, one per arc */
+static struct animate *anim_prev_root = ANIM_NULL;
+
+
+/**
+ * Take every animation off the database, keeping the chain of each
+ * animated arc in saved and the rooted ones in *root.
+ */
+static void
+anim_detach(struct db_i *dbip, struct bu_ptbl *saved, struct animate **root)
+{
+    struct directory *dp;
+
+    if (!saved->l.magic)
+	bu_ptbl_init(saved, 8, "saved animations");
+
+    *root = dbip->dbi_anroot;
+    dbip->dbi_anroot = ANIM_NULL;
+    FOR_ALL_DIRECTORY_START(dp, dbip) {
+	if (dp->d_animate != ANIM_NULL) {
+	    bu_ptbl_ins(saved, (long *)dp->d_animate);
+	    dp->d_animate = ANIM_NULL;
+	}
+    } FOR_ALL_DIRECTORY_END;
+}
+
+
+/**
+ * Put animations taken off by anim_detach() back on the database.
+ */
+static void
+anim_attach(struct db_i *dbip, struct bu_ptbl *saved, struct animate *root)
+{
+    struct animate *anp;
+    size_t i;
+
+    dbip->dbi_anroot = root;
+    for (i = 0; i < BU_PTBL_LEN(saved); i++) {
+	anp = (struct animate *)BU_PTBL_GET(saved, i);
+	DB_FULL_PATH_CUR_DIR(&anp->an_path)->d_animate = anp;
+    }
+    bu_ptbl_reset(saved);
+}
+
+
+static void
+anim_free_chain(struct animate *anp)
+{
+    struct animate *next;
+
+    for (; anp != ANIM_NULL; anp = next) {
+	next = anp->an_forw;
+	db_free_1anim(anp);
+    }
+}
+
+
+/**
+ * Drop the previous frame's animations and any pending re-prep.
+ */
+static void
+anim_forget(void)
+{
+    size_t i;
+
+    for (i = 0; i < BU_PTBL_LEN(&anim_prev); i++)
+	anim_free_chain((struct animate *)BU_PTBL_GET(&anim_prev, i));
+    if (anim_prev.l.magic)
+	bu_ptbl_reset(&anim_prev);
+    anim_free_chain(anim_prev_root);
+    anim_prev_root = ANIM_NULL;
+    anim_pending = 0;
+}
+
+
+static int
+anim_same(const struct animate *a, const struct animate *b)
+{
+    if (a->an_type != b->an_type || !db_identical_full_paths(&a->an_path, &b->an_path))
+	return 0;
+
+    switch (a->an_type) {
+	case RT_AN_MATRIX:
+	    /* exactly, a small step each frame still adds up */
+	    return a->an_u.anu_m.anm_op == b->an_u.anu_m.anm_op
+		&& !memcmp(a->an_u.anu_m.anm_mat, b->an_u.anu_m.anm_mat, sizeof(mat_t));
+	case RT_AN_MATERIAL:
+	    return a->an_u.anu_p.anp_op == b->an_u.anu_p.anp_op
+		&& BU_STR_EQUAL(bu_vls_cstr(&a->an_u.anu_p.anp_shader), bu_vls_cstr(&b->an_u.anu_p.anp_shader));
+	case RT_AN_COLOR:
+	    return a->an_u.anu_c.anc_rgb[0] == b->an_u.anu_c.anc_rgb[0]
+		&& a->an_u.anu_c.anc_rgb[1] == b->an_u.anu_c.anc_rgb[1]
+		&& a->an_u.anu_c.anc_rgb[2] == b->an_u.anu_c.anc_rgb[2];
+	case RT_AN_TEMPERATURE:
+	    return ZERO(a->an_u.anu_t - b->an_u.anu_t);
+    }
+    return 0;
+}
+
+
+static int
+anim_chain_same(const struct animate *a, const struct animate *b)
+{
+    for (; a != ANIM_NULL && b != ANIM_NULL; a = a->an_forw, b = b->an_forw) {
+	if (!anim_same(a, b))
+	    return 0;
+    }
+    return a == b;
+}
+
+
+static void
+anim_chain_add(struct bu_ptbl *changed, struct animate *anp)
+{
+    for (; anp != ANIM_NULL; anp = anp->an_forw)
+	bu_ptbl_ins(changed, (long *)anp);
+}
+
+
+/**
+ * Collect into changed the animations, old and new, of every arc whose
+ * chain differs from the previous frame's.
+ */
+static void
+anim_changed(struct db_i *dbip, struct bu_ptbl *changed)
+{
+    struct directory *dp;
+    struct animate *old;
+    size_t i;
+
+    for (i = 0; i < BU_PTBL_LEN(&anim_prev); i++) {
+	old = (struct animate *)BU_PTBL_GET(&anim_prev, i);
+	dp = DB_FULL_PATH_CUR_DIR(&old->an_path);
+	if (!anim_chain_same(old, dp->d_animate)) {
+	    anim_chain_add(changed, old);
+	    anim_chain_add(changed, dp->d_animate);
+	}
+    }
+
+    /* arcs animated for the first time this frame */
+    FOR_ALL_DIRECTORY_START(dp, dbip) {
+	if (dp->d_animate == ANIM_NULL)
+	    continue;
+	for (i = 0; i < BU_PTBL_LEN(&anim_prev); i++) {
+	    old = (struct animate *)BU_PTBL_GET(&anim_prev, i);
+	    if (DB_FULL_PATH_CUR_DIR(&old->an_path) == dp)
+		break;
+	}
+	if (i == BU_PTBL_LEN(&anim_prev))
+	    anim_chain_add(changed, dp->d_animate);
+    } FOR_ALL_DIRECTORY_END;
+}
+
+
+/**
+ * view_setup(), noting whether it deleted any regions (invisible light
+ * sources and the like), which a re-prep could not bring back.
+ */
+static void
+setup_view(struct rt_i *rtip)
+{
+    size_t nregions = bu_list_len(&rtip->HeadRegion);
+
+    view_setup(rtip);
+    view_dropped = (size_t)bu_list_len(&rtip->HeadRegion) < nregions || BU_PTBL_LEN(&rtip->delete_regs) > 0;
+}
+
+
+/**
+ * Re-prep only the regions the animations of this frame moved or
+ * changed since the last one, falling back to what a plain "clean"
+ * would have done when that can't be done in place.
+ */
+static void
+anim_reprep(struct rt_i *rtip)
+{
+    struct bu_vls times = BU_VLS_INIT_ZERO;
+    struct bu_ptbl changed = BU_PTBL_INIT_ZERO;
+    struct bu_ptbl cur = BU_PTBL_INIT_ZERO;
+    struct animate *cur_root;
+    int ret = -1;
+
+    rt_prep_timer();
+    if (anim_chain_same(anim_prev_root, rtip->rti_dbip->dbi_anroot)) {
+	bu_ptbl_init(&changed, 8, "changed animations");
+	anim_changed(rtip->rti_dbip, &changed);
+	ret = rt_reprep_anim(rtip, &changed, (size_t)npsw, &resource[0]);
+	bu_ptbl_free(&changed);
+    }
+    (void)rt_get_timer(&times, NULL);
+
+    anim_forget();
+
+    if (ret < 0) {
+	/* everything but this frame's animations */
+	anim_detach(rtip->rti_dbip, &cur, &cur_root);
+	rt_clean(rtip);
+	anim_attach(rtip->rti_dbip, &cur, cur_root);
+	bu_ptbl_free(&cur);
+    } else {
+	if (rt_verbosity & VERBOSE_STATS)
+	    bu_log("REPREP: %d regions, %s\n", ret, bu_vls_addr(&times));
+	setup_view(rtip);
+    }
+    bu_vls_free(&times);
+}
+
+
 int cm_end(const int UNUSED(argc), const char **UNUSED(argv))
 {
     struct rt_i *rtip = APP.a_rt_i;
 
+    if (rtip && anim_pending)
+	anim_reprep(rtip);
+
     if (rtip && BU_LIST_IS_EMPTY(&rtip->HeadRegion)) {
 	def_tree(rtip);		/* Load the default trees */
     }
@@ -457,13 +672,35 @@ int cm_anim(const int argc, const char **argv)
 
 /**
  * Clean out results of last rt_prep(), and start anew.
+ *
+ * With anim_incremental set, the prepped geometry is kept and "end"
+ * re-preps just what the new frame's animations change.
  */
 int cm_clean(const int UNUSED(argc), const char **UNUSED(argv))
 {
+    struct rt_i *rtip = APP.a_rt_i;
+
+    /* already cleaned for this frame, drop what came since */
+    if (anim_pending) {
+	db_free_anim(rtip->rti_dbip);
+	return 0;
+    }
+
     /* Allow lighting model clean up (e.g. lights, materials, etc.) */
-    view_cleanup(APP.a_rt_i);
+    view_cleanup(rtip);
+
+    if (anim_incremental && !rtip->needprep && !view_dropped
+	&& BU_LIST_NON_EMPTY(&rtip->HeadRegion)
+#ifdef USE_OPENCL
+	&& !opencl_mode
+#endif
+	) {
+	anim_detach(rtip->rti_dbip, &anim_prev, &anim_prev_root);
+	anim_pending = 1;
+	return 0;
+    }
 
-    rt_clean(APP.a_rt_i);
+    rt_clean(rtip);
 
     return 0;
 }
@@ -510,6 +747,8 @@ struct bu_structparse set_parse[] = {
     {"%f",	1, "angle",			bu_byteoffset(rt_perspective),		BU_STRUCTPARSE_FUNC_NULL, NULL, NULL },
     {"%d",	1, "rt_bot_minpieces", bu_byteoffset(rt_bot_minpieces_deprecated),	parse_deprecated, NULL, NULL },
     {"%f",	1, "rt_cline_radius", 0 /* must be set manually since from lib */, 	BU_STRUCTPARSE_FUNC_NULL, NULL, NULL },
+    {"%d",	1, "tile_size",			bu_byteoffset(tile_size),		BU_STRUCTPARSE_FUNC_NULL, NULL, NULL },
+    {"%d",	1, "anim_incremental",		bu_byteoffset(anim_incremental),	BU_STRUCTPARSE_FUNC_NULL, NULL, NULL },
     /* daisy-chain to additional app-specific parameters */
     {"%p",	1, "Application-Specific Parameters", bu_byteoffset(view_parse[0]),	BU_STRUCTPARSE_FUNC_NULL, NULL, NULL },
     {"",	0, (char *)0,		0,						BU_STRUCTPARSE_FUNC_NULL, NULL, NULL }
@@ -749,7 +988,7 @@ do_prep(struct rt_i *rtip)
     RT_CHECK_RTI(rtip);
     if (rtip->needprep) {
 	/* Allow lighting model to set up (e.g. lights, materials, etc.) */
-	view_setup(rtip);
+	setup_view(rtip);
 
 	/* Allow RT library to prepare itself */
 	rt_prep_timer();
@@ -776,7 +1015,7 @@ do_prep(struct rt_i *rtip)
     if (rt_verbosity & VERBOSE_STATS) {
 	bu_log("%s: %zu cut, %zu box (%zu empty)\n",
 	       rtip->rti_space_partition == RT_PART_NUBSPT ?
-	       "NUBSP" : "unknown",
+	       "NUBSP" : (rtip->rti_space_partition == RT_PART_HLBVH ? "HLBVH" : "unknown"),
 	       rtip->rti_ncut_by_type[CUT_CUTNODE],
 	       rtip->rti_ncut_by_type[CUT_BOXNODE],
 	       rtip->nempty_cells);
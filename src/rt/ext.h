@@ -138,6 +138,9 @@ extern vect_t dx_model;			/* view delta-X as model-space vect (width of pixel as
 extern vect_t dx_unit;			/* unit-len dir vector of pixel side-to-side */
 extern vect_t dy_model;			/* view delta-Y as model-space vect (height of pixel as vector) */
 extern vect_t dy_unit;			/* unit-len dir vector of pixel top-to-bottom */
+extern int tile_size;			/* tile edge in pixels, 0 for scanline spans */
+extern void (*tile_done_hook)(int cpu, int xmin, int ymin, int xmax, int ymax);	/* set by view modules that take tiles */
+extern int tile_mode(void);		/* !0 when do_run() renders tiles */
 /** 'jitter' variable values **/
 #define JITTER_CELL 0x1			/* jitter position of ray in each cell */
 #define JITTER_FRAME 0x2		/* jitter position of entire frame */
@@ -169,8 +169,9 @@ char *framebuffer = NULL;       /* desired framebuffer */
 
 /**
  * space partitioning algorithm to use.  previously had experimental
- * grid support, but now only uses a Non-uniform Binary Spatial
- * Partitioning (BSP) tree.
+ * grid support, now defaults to a Non-uniform Binary Spatial
+ * Partitioning (BSP) tree, with a bounding volume hierarchy over the
+ * solid RPPs (RT_PART_HLBVH) available via -, bvh
  */
 int space_partition = RT_PART_NUBSPT;
 
@@ -289,7 +290,15 @@ get_args(int argc, const char *argv[])
 		break;
 	    }
 	    case COMMA:
-		space_partition = atoi(bu_optarg);
+		if (BU_STR_EQUIV(bu_optarg, "bvh") || BU_STR_EQUIV(bu_optarg, "hlbvh"))
+		    space_partition = RT_PART_HLBVH;
+		else if (BU_STR_EQUIV(bu_optarg, "nubsp"))
+		    space_partition = RT_PART_NUBSPT;
+		else
+		    space_partition = atoi(bu_optarg);
+		if (space_partition != RT_PART_NUBSPT && space_partition != RT_PART_HLBVH) {
+		    bu_exit(EXIT_FAILURE, "ERROR: unknown space partitioning method [%s]\n", bu_optarg);
+		}
 		break;
 	    case 'c':
 		(void)rt_do_cmd((struct rt_i *)0, bu_optarg, rt_do_tab);
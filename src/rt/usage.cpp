@@ -143,7 +143,7 @@ default_options(void)
     option("Developer", "-x #", "Specify librt debugging flags", 1);
     option("Developer", "-N #", "Specify libnmg debugging flags", 1);
     option("Developer", "-! #", "Specify libbu debugging flags", 1);
-    option("Developer", "-, #", "Specify space partitioning algorithm", 1);
+    option("Developer", "-, #", "Specify space partitioning algorithm (0|nubsp default, 1|bvh)", 1);
     option("Developer", "-B", "Disable randomness for \"benchmark\"-style repeatability", 1);
     option("Developer", "-b \"x y\"", "Only shoot one ray at pixel coordinates (quotes required)", 1);
     option("Developer", "-Q x,y", "Shoot one pixel with debugging; compute others without", 1);
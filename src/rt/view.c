@@ -98,6 +98,13 @@ struct mfuncs *mfHead = MF_NULL;	/* Head of list of shaders */
  */
 static int overlay = 0;
 
+/**
+ * In tile mode, write each tile to the framebuffer as soon as it is
+ * finished instead of waiting for complete scanlines.  Set with -c
+ * 'set tile_output=1'
+ */
+int tile_output = 0;
+
 /**
  * Called when the reprojected value lies on the current screen.
  * Write the reprojected value into the screen, checking *screen* Z
@@ -117,6 +124,7 @@ static int buf_mode=0;
 #define BUFMODE_ACC       7     /* Cumulative buffer - The buffer
 				   always have the average of the
 				   colors sampled for each pixel */
+#define BUFMODE_TILE      8	/* Whole frame, written out by tiles */
 
 vect_t kut_norm = VINIT_ZERO;
 struct soltab *kut_soltab = NULL;
@@ -164,10 +172,56 @@ struct bu_structparse view_parse[] = {
     {"%g", 1, "ambRadius", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
     {"%g", 1, "ambOffset", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
     {"%d", 1, "ambSlow", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
+    {"%d", 1, "tile_output", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
     {"", 0, (char *)0, 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL}
 };
 
 
+/**
+ * Write out and release a finished scanline buffer.  The framebuffer
+ * is skipped when to_fb is zero (already written by tiles).
+ */
+static void
+view_scanline_out(int y, int to_fb)
+{
+    if (fbp != FB_NULL && to_fb) {
+	size_t npix;
+	bu_semaphore_acquire(BU_SEM_SYSCALL);
+	if (sub_grid_mode) {
+	    npix = fb_write(fbp, sub_xmin, y,
+			    (unsigned char *)scanline[y].sl_buf+3*sub_xmin,
+			    sub_xmax-sub_xmin+1);
+	} else {
+	    npix = fb_write(fbp, 0, y,
+			    (unsigned char *)scanline[y].sl_buf, width);
+	}
+	bu_semaphore_release(BU_SEM_SYSCALL);
+	if (sub_grid_mode) {
+	    if (npix < (size_t)sub_xmax-(size_t)sub_xmin-1) {
+		bu_log("WARNING: scanline error (wrote %zu of %zu pixels)", npix, (size_t)sub_xmax-sub_xmin-1);
+	    }
+	}
+    }
+    if (bif != NULL) {
+	/* TODO : Add double type data to maintain resolution */
+	icv_writeline(bif, y, (unsigned char *)scanline[y].sl_buf, ICV_DATA_UCHAR);
+    } else if (outfp != NULL) {
+	size_t count;
+
+	bu_semaphore_acquire(BU_SEM_SYSCALL);
+	if (bu_fseek(outfp, y*width*pwidth, 0) != 0)
+	    fprintf(stderr, "fseek error\n");
+	count = fwrite(scanline[y].sl_buf,
+		       sizeof(char), width*pwidth, outfp);
+	bu_semaphore_release(BU_SEM_SYSCALL);
+	if (count != width*pwidth)
+	    bu_exit(EXIT_FAILURE, "view_pixel:  fwrite failure\n");
+    }
+    bu_free(scanline[y].sl_buf, "sl_buf scanline buffer");
+    scanline[y].sl_buf = (unsigned char *)0;
+}
+
+
 /**
  * Arrange to have the pixel output.  a_uptr has region pointer, for
  * reference.
@@ -377,6 +431,18 @@ view_pixel(struct application *ap)
 		do_eol = 1;
 	    break;
 
+	    /*
+	     * Scanline buffers are allocated up front, and the tile
+	     * scheduler gives each pixel to exactly one CPU, so no
+	     * interlock.  Output happens in view_tile().
+	     */
+	case BUFMODE_TILE:
+	    pixelp = scanline[ap->a_y].sl_buf+(ap->a_x*pwidth);
+	    *pixelp++ = r;
+	    *pixelp++ = g;
+	    *pixelp++ = b;
+	    return;
+
 	case BUFMODE_INCR:
 	    {
 		size_t dx, dy;
@@ -488,41 +554,75 @@ view_pixel(struct application *ap)
 	case BUFMODE_ACC:
 	case BUFMODE_SCANLINE:
 	case BUFMODE_DYNAMIC:
-	    if (fbp != FB_NULL) {
-		size_t npix;
-		bu_semaphore_acquire(BU_SEM_SYSCALL);
-		if (sub_grid_mode) {
-		    npix = fb_write(fbp, sub_xmin, ap->a_y,
-				    (unsigned char *)scanline[ap->a_y].sl_buf+3*sub_xmin,
-				    sub_xmax-sub_xmin+1);
-		} else {
-		    npix = fb_write(fbp, 0, ap->a_y,
-				    (unsigned char *)scanline[ap->a_y].sl_buf, width);
-		}
-		bu_semaphore_release(BU_SEM_SYSCALL);
-		if (sub_grid_mode) {
-		    if (npix < (size_t)sub_xmax-(size_t)sub_xmin-1) {
-			bu_log("WARNING: scanline error (wrote %zu of %zu pixels)", npix, (size_t)sub_xmax-sub_xmin-1);
-		    }
-		}
-	    }
-	    if (bif != NULL) {
-		/* TODO : Add double type data to maintain resolution */
-		icv_writeline(bif, ap->a_y, (unsigned char *)scanline[ap->a_y].sl_buf, ICV_DATA_UCHAR);
-	    } else if (outfp != NULL) {
-		size_t count;
+	    view_scanline_out(ap->a_y, 1);
+    }
+}
 
-		bu_semaphore_acquire(BU_SEM_SYSCALL);
-		if (bu_fseek(outfp, ap->a_y*width*pwidth, 0) != 0)
-		    fprintf(stderr, "fseek error\n");
-		count = fwrite(scanline[ap->a_y].sl_buf,
-			       sizeof(char), width*pwidth, outfp);
-		bu_semaphore_release(BU_SEM_SYSCALL);
-		if (count != width*pwidth)
-		    bu_exit(EXIT_FAILURE, "view_pixel:  fwrite failure\n");
-	    }
-	    bu_free(scanline[ap->a_y].sl_buf, "sl_buf scanline buffer");
-	    scanline[ap->a_y].sl_buf = (unsigned char *)0;
+
+/**
+ * Clip columns xmin..xmax of scanline y to the pixels this frame
+ * shoots, pix_start through pix_end and the sub-grid if any.  Returns
+ * the number of pixels left, with the span in *x0 and *x1.
+ */
+static int
+view_tile_span(int y, int xmin, int xmax, int *x0, int *x1)
+{
+    int row = y * (int)width;
+
+    if (sub_grid_mode) {
+	if (y < sub_ymin || y > sub_ymax)
+	    return 0;
+	V_MAX(xmin, sub_xmin);
+	V_MIN(xmax, sub_xmax);
+    }
+    V_MAX(xmin, pix_start - row);
+    V_MIN(xmax, pix_end - row);
+
+    *x0 = xmin;
+    *x1 = xmax;
+    return (xmax >= xmin) ? xmax - xmin + 1 : 0;
+}
+
+
+/**
+ * Called by the tile scheduler in worker.c after all pixels of a tile
+ * have been through view_pixel().  Scanlines are written out once
+ * every tile crossing them is done.
+ */
+static void
+view_tile(int UNUSED(cpu), int xmin, int ymin, int xmax, int ymax)
+{
+    int y, x0, x1;
+    int ncols;
+
+    if (buf_mode != BUFMODE_TILE)
+	return;
+
+    if (tile_output && fbp != FB_NULL) {
+	bu_semaphore_acquire(BU_SEM_SYSCALL);
+	for (y = ymin; y <= ymax; y++) {
+	    ncols = view_tile_span(y, xmin, xmax, &x0, &x1);
+	    if (ncols && (int)fb_write(fbp, x0, y, scanline[y].sl_buf+x0*pwidth, ncols) < ncols)
+		bu_log("WARNING: tile write error at %d, %d\n", x0, y);
+	}
+	bu_semaphore_release(BU_SEM_SYSCALL);
+    }
+
+    for (y = ymin; y <= ymax; y++) {
+	int done;
+
+	/* count only the pixels that were actually shot */
+	ncols = view_tile_span(y, xmin, xmax, &x0, &x1);
+	if (!ncols)
+	    continue;
+
+	bu_semaphore_acquire(RT_SEM_RESULTS);
+	scanline[y].sl_left -= ncols;
+	done = (scanline[y].sl_left <= 0);
+	bu_semaphore_release(RT_SEM_RESULTS);
+
+	if (done)
+	    view_scanline_out(y, !tile_output);
     }
 }
 
@@ -900,8 +1000,10 @@ ambientOcclusion(struct application *ap, struct partition *pp)
     vect_t vAxis;
     vect_t uAxis;
     int ao_samp;
+    int occluded;
     vect_t origin = VINIT_ZERO;
     double occlusionFactor;
+    fastf_t maxdist = ambRadius;
     int hitCount = 0;
 
     stp = pp->pt_inseg->seg_stp;
@@ -940,6 +1042,10 @@ ambientOcclusion(struct application *ap, struct partition *pp)
     VUNITIZE(vAxis);
     VCROSS(uAxis, vAxis, inormal);
 
+    /* without a radius, any hit is ambient occlusion */
+    if (NEAR_ZERO(ambRadius, ap->a_rt_i->rti_tol.dist))
+	maxdist = INFINITY;
+
     for (ao_samp=0; ao_samp < ambSamples ; ao_samp++) {
 	vect_t randScale;
 
@@ -958,12 +1064,27 @@ ambientOcclusion(struct application *ap, struct partition *pp)
 
 	VUNITIZE(amb_ap.a_ray.r_dir);
 
-	amb_ap.a_user = 0;
-	amb_ap.a_flag = 0;
+	/* Anything entering the ray inside the radius occludes, which
+	 * rt_occluded() can usually tell without weaving partitions.
+	 * Cut planes need the partitions, and so does a clear ray
+	 * with no radius, since hits behind the start count then.
+	 */
+	occluded = -1;
+	if (!do_kut_plane) {
+	    occluded = rt_occluded(&amb_ap, 0.0, maxdist, NULL);
+	    if (occluded == 0 && maxdist >= INFINITY)
+		occluded = -1;
+	}
+
+	if (occluded < 0) {
+	    amb_ap.a_user = 0;
+	    amb_ap.a_flag = 0;
 
-	/* shoot in the direction and see what we hit */
-	rt_shootray(&amb_ap);
-	hitCount += amb_ap.a_flag;
+	    /* shoot in the direction and see what we hit */
+	    rt_shootray(&amb_ap);
+	    occluded = amb_ap.a_flag;
+	}
+	hitCount += occluded;
     }
 
     occlusionFactor = 1.0 - (hitCount / (float)ambSamples);
@@ -1342,6 +1463,9 @@ view_init(struct application *UNUSED(ap), char *UNUSED(file), char *UNUSED(obj),
 
     optical_shader_init(&mfHead);	/* in liboptical/init.c */
 
+    /* take tiles from worker(), see view_tile() */
+    tile_done_hook = view_tile;
+
     if (do_kut_plane) {
 	struct rt_functab *functab;
 	struct directory *dp;
@@ -1553,6 +1677,8 @@ view_2init(struct application *ap, char *UNUSED(framename))
 	buf_mode = BUFMODE_ACC;
     } else if (width <= 96 || random_mode) {
 	buf_mode = BUFMODE_UNBUF;
+    } else if (tile_mode()) {
+	buf_mode = BUFMODE_TILE;
     } else if ((size_t)npsw <= (size_t)height/4) {
 	/* Have each CPU do a whole scanline.  Saves lots of semaphore
 	 * overhead.  For load balancing make sure each CPU has
@@ -1658,6 +1784,22 @@ view_2init(struct application *ap, char *UNUSED(framename))
 		scanline[i].sl_left = width;
 	    bu_log("Mode: Multiple-sample, average buffering\n");
 	    break;
+	case BUFMODE_TILE:
+	    if (rt_verbosity & VERBOSE_OUTPUTFILE) {
+		bu_log("Mode: %dx%d tile buffering%s\n", tile_size, tile_size,
+		       tile_output ? ", tiles written as completed" : "");
+	    }
+	    for (i=0; i<height; i++) {
+		int x0, x1;
+
+		/* view_tile() counts these down as tiles finish */
+		scanline[i].sl_left = view_tile_span((int)i, 0, (int)width - 1, &x0, &x1);
+		if (!scanline[i].sl_left)
+		    continue;
+		if (!scanline[i].sl_buf)
+		    scanline[i].sl_buf = (unsigned char *)bu_calloc(width, pwidth, "sl_buf scanline buffer");
+	    }
+	    break;
 	default:
 	    bu_exit(EXIT_FAILURE, "ERROR: bad buffering mode (%d), try -i", buf_mode);
     }
@@ -1843,6 +1985,7 @@ application_init(void)
     view_parse[ 9].sp_offset = bu_byteoffset(ambRadius);
     view_parse[10].sp_offset = bu_byteoffset(ambOffset);
     view_parse[11].sp_offset = bu_byteoffset(ambSlow);
+    view_parse[12].sp_offset = bu_byteoffset(tile_output);
 
     option("", "-A #", "Set image brightness, ambient light intensity (default: 0.4)", 0);
     option("Raytrace", "-i", "Enable incremental (progressive-style) rendering", 1);
@@ -317,6 +317,14 @@ static int occludes(struct application *ap, struct cell *here)
     VMOVE(occlusion_apps[cpu]->a_ray.r_pt, ap->a_ray.r_pt);
     VMOVE(occlusion_apps[cpu]->a_ray.r_dir, ap->a_ray.r_dir);
 
+    /*
+     * Anything of the second geometry entering the ray clearly in
+     * front of this pixel's hit makes it foreground, and that can
+     * usually be seen without building partitions.
+     */
+    if (rt_occluded(occlusion_apps[cpu], 0.0, here->c_dist - BN_TOL_DIST, NULL) > 0)
+	return 0;
+
     oc_hit = rt_shootray(occlusion_apps[cpu]);
 
     if (!oc_hit) {
@@ -31,6 +31,7 @@
 #include <math.h>
 
 #include "bu/log.h"
+#include "bu/sort.h"
 #include "vmath.h"
 #include "bn.h"
 #include "raytrace.h"
@@ -79,6 +80,32 @@ int last_pixel = 0;			/* last pixel number */
 
 int stop_worker = 0;
 
+/* Tile scheduling, see tile_setup() */
+int tile_size = 32;		/* tile edge in pixels, 0 for scanline spans */
+void (*tile_done_hook)(int cpu, int xmin, int ymin, int xmax, int ymax) = NULL;
+
+#define TILE_SEM_MAX 16
+
+struct tile_queue {
+    int head;			/* next tile for the owner */
+    int tail;			/* one past the last tile, thieves take from here */
+    int sem;			/* semaphore protecting head and tail */
+};
+
+static int tile_nx = 0;		/* tiles across */
+static int tile_ny = 0;		/* tiles down */
+static int tile_y0 = 0;		/* scanline of the first tile row */
+static int tile_count = 0;
+static int *tile_order = NULL;	/* tile numbers in Z-order */
+static struct tile_queue *tile_queues = NULL;
+static int tile_sem[TILE_SEM_MAX] = {0};
+static const char *tile_sem_names[TILE_SEM_MAX] = {
+    "RT_SEM_TILE0", "RT_SEM_TILE1", "RT_SEM_TILE2", "RT_SEM_TILE3",
+    "RT_SEM_TILE4", "RT_SEM_TILE5", "RT_SEM_TILE6", "RT_SEM_TILE7",
+    "RT_SEM_TILE8", "RT_SEM_TILE9", "RT_SEM_TILE10", "RT_SEM_TILE11",
+    "RT_SEM_TILE12", "RT_SEM_TILE13", "RT_SEM_TILE14", "RT_SEM_TILE15"
+};
+
 /**
  * For certain hypersample values there is a particular advantage to
  * subdividing the pixel and shooting a ray in each sub-pixel.  This
@@ -451,6 +478,280 @@ do_pixel(int cpu, int pat_num, int pixelnum)
 }
 
 
+/**
+ * Returns non-zero when the primary rays of neighboring pixels can be
+ * traced together with rt_shootray_packet(), i.e. when each pixel is
+ * exactly one ray with no per-pixel extras.
+ */
+static int
+packet_mode(void)
+{
+    return (hypersample == 0 && !stereo && !pixmap && lightmodel != 8 &&
+	    !Query_one_pixel && !fullfloat_mode && !random_mode &&
+	    !APP.a_rt_i->rti_prismtrace &&
+	    APP.a_rt_i->rti_space_partition == RT_PART_HLBVH);
+}
+
+
+/**
+ * Packet version of do_pixel() for the single sample case.  Sets up
+ * the main ray of each of the n pixels, traces them together, then
+ * stores the results in pixel order.
+ */
+static void
+do_pixel_packet(int cpu, int pat_num, const int *pixelnums, int n)
+{
+    struct application a[RT_PACKET_MAX];
+    int nrays = 0;
+    int i;
+
+    for (i = 0; i < n; i++) {
+	struct application *ap = &a[nrays];
+	vect_t point;
+
+	/* Obtain fresh copy of global application struct */
+	*ap = APP;				/* struct copy */
+	ap->a_resource = &resource[cpu];
+
+	if (incr_mode) {
+	    register int j = 1<<incr_level;
+	    ap->a_y = pixelnums[i]/j;
+	    ap->a_x = pixelnums[i] - (ap->a_y * j);
+	    if (incr_level != 0) {
+		/* See if already done last pass */
+		if (((ap->a_x & 1) == 0) &&
+		    ((ap->a_y & 1) == 0))
+		    continue;
+	    }
+	    ap->a_x <<= (incr_nlevel-incr_level);
+	    ap->a_y <<= (incr_nlevel-incr_level);
+	} else {
+	    ap->a_y = (int)(pixelnums[i]/width);
+	    ap->a_x = (int)(pixelnums[i] - (ap->a_y * width));
+	}
+
+	if (sub_grid_mode) {
+	    if (ap->a_x < sub_xmin || ap->a_x > sub_xmax)
+		continue;
+	    if (ap->a_y < sub_ymin || ap->a_y > sub_ymax)
+		continue;
+	}
+
+	VJOIN2 (point, viewbase_model, ap->a_x, dx_model, ap->a_y, dy_model);
+	ap->a_pixelext = (struct pixel_ext *)NULL;
+
+	if (jitter & JITTER_CELL) {
+	    jitter_start_pnt(point, ap, 0, pat_num);
+	}
+
+	if (rt_perspective > 0.0) {
+	    VSUB2(ap->a_ray.r_dir, point, eye_model);
+	    VUNITIZE(ap->a_ray.r_dir);
+	    VMOVE(ap->a_ray.r_pt, eye_model);
+	} else {
+	    VMOVE(ap->a_ray.r_pt, point);
+	    VMOVE(ap->a_ray.r_dir, APP.a_ray.r_dir);
+	}
+	if (report_progress) {
+	    report_progress = 0;
+	    bu_log("\tframe %d, xy=%d, %d on cpu %d, samp=%d\n", curframe, ap->a_x, ap->a_y, cpu, 0);
+	}
+
+	ap->a_level = 0;		/* recursion level */
+	ap->a_purpose = "main ray";
+	nrays++;
+    }
+    if (!nrays)
+	return;
+
+    (void)rt_shootray_packet(a, nrays);
+
+    /* we're done */
+    for (i = 0; i < nrays; i++) {
+	view_pixel(&a[i]);
+	if ((size_t)a[i].a_x == width-1) {
+	    view_eol(&a[i]);		/* End of scan line */
+	}
+    }
+}
+
+
+/**
+ * Returns non-zero when do_run() hands out square tiles instead of
+ * pixel spans.  The view module has to opt in by setting
+ * tile_done_hook, since tiles complete scanlines out of order.
+ */
+int
+tile_mode(void)
+{
+    return (tile_size > 0 && tile_done_hook && !incr_mode && !random_mode);
+}
+
+
+/* interleave the low 16 bits of v with zeros */
+static uint32_t
+tile_morton_spread(uint32_t v)
+{
+    v &= 0x0000ffff;
+    v = (v | (v << 8)) & 0x00ff00ff;
+    v = (v | (v << 4)) & 0x0f0f0f0f;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+
+static int
+tile_morton_cmp(const void *a, const void *b, void *arg)
+{
+    const uint32_t *keys = (const uint32_t *)arg;
+    uint32_t ka = keys[*(const int *)a];
+    uint32_t kb = keys[*(const int *)b];
+
+    if (ka < kb)
+	return -1;
+    if (ka > kb)
+	return 1;
+    return 0;
+}
+
+
+/**
+ * Cut the scanlines covering pixels a..b into tiles, order them along
+ * a Z-order curve so consecutive tiles are spatially close, and give
+ * each worker a contiguous run of that order as its queue.  Workers
+ * take tiles from the front of their own queue and, once it is empty,
+ * steal the back half of another worker's queue.
+ */
+static void
+tile_setup(int a, int b)
+{
+    uint32_t *keys;
+    int nq = (npsw > 0) ? (int)npsw : 1;
+    int rows, i;
+
+    if (!tile_sem[0]) {
+	for (i = 0; i < TILE_SEM_MAX; i++)
+	    tile_sem[i] = bu_semaphore_register(tile_sem_names[i]);
+    }
+
+    tile_y0 = a / (int)width;
+    rows = b / (int)width - tile_y0 + 1;
+    tile_nx = ((int)width + tile_size - 1) / tile_size;
+    tile_ny = (rows + tile_size - 1) / tile_size;
+    tile_count = tile_nx * tile_ny;
+
+    tile_order = (int *)bu_realloc(tile_order, (tile_count + 1) * sizeof(int), "tile_order");
+    keys = (uint32_t *)bu_malloc((tile_count + 1) * sizeof(uint32_t), "tile keys");
+    for (i = 0; i < tile_count; i++) {
+	int tx = i % tile_nx;
+	int ty = i / tile_nx;
+	if (top_down)
+	    ty = tile_ny - 1 - ty;
+	keys[i] = tile_morton_spread((uint32_t)tx) | (tile_morton_spread((uint32_t)ty) << 1);
+	tile_order[i] = i;
+    }
+    bu_sort(tile_order, tile_count, sizeof(int), tile_morton_cmp, keys);
+    bu_free(keys, "tile keys");
+
+    tile_queues = (struct tile_queue *)bu_realloc(tile_queues, nq * sizeof(struct tile_queue), "tile_queues");
+    for (i = 0; i < nq; i++) {
+	tile_queues[i].head = (int)(((long long)tile_count * i) / nq);
+	tile_queues[i].tail = (int)(((long long)tile_count * (i + 1)) / nq);
+	tile_queues[i].sem = tile_sem[i % TILE_SEM_MAX];
+    }
+}
+
+
+/**
+ * Returns the next tile for this worker, or -1 when all tiles have
+ * been handed out.
+ */
+static int
+tile_next(int cpu)
+{
+    struct tile_queue *q = &tile_queues[cpu];
+    int nq = (int)npsw;
+    int t = -1;
+    int i;
+
+    bu_semaphore_acquire(q->sem);
+    if (q->head < q->tail)
+	t = tile_order[q->head++];
+    bu_semaphore_release(q->sem);
+    if (t >= 0)
+	return t;
+
+    /* Own queue is drained, steal the back half of someone else's */
+    for (i = 1; i < nq; i++) {
+	struct tile_queue *v = &tile_queues[(cpu + i) % nq];
+	int first = 0, last = 0;
+
+	bu_semaphore_acquire(v->sem);
+	if (v->head < v->tail) {
+	    last = v->tail;
+	    first = v->tail - (v->tail - v->head + 1) / 2;
+	    v->tail = first;
+	}
+	bu_semaphore_release(v->sem);
+	if (first == last)
+	    continue;
+
+	bu_semaphore_acquire(q->sem);
+	q->head = first + 1;
+	q->tail = last;
+	bu_semaphore_release(q->sem);
+	return tile_order[first];
+    }
+    return -1;
+}
+
+
+/**
+ * Worker loop for tile mode.  Each tile is rendered in scanline order
+ * within its bounds, then reported to the view module.
+ */
+static void
+worker_tiles(int cpu, int pat_num)
+{
+    int packet = packet_mode();
+    int t;
+
+    while (!stop_worker && (t = tile_next(cpu)) >= 0) {
+	int xmin = (t % tile_nx) * tile_size;
+	int ymin = tile_y0 + (t / tile_nx) * tile_size;
+	int xmax = FMIN(xmin + tile_size, (int)width) - 1;
+	int ymax = FMIN(ymin + tile_size, (int)height) - 1;
+	int x, y;
+
+	for (y = ymin; y <= ymax; y++) {
+	    int pixelnums[RT_PACKET_MAX];
+	    int npixels = 0;
+
+	    for (x = xmin; x <= xmax; x++) {
+		int pixelnum = y * (int)width + x;
+
+		if (pixelnum < cur_pixel || pixelnum > last_pixel)
+		    continue;
+		if (!packet) {
+		    do_pixel(cpu, pat_num, pixelnum);
+		    continue;
+		}
+		pixelnums[npixels++] = pixelnum;
+		if (npixels == RT_PACKET_MAX) {
+		    do_pixel_packet(cpu, pat_num, pixelnums, npixels);
+		    npixels = 0;
+		}
+	    }
+	    if (npixels)
+		do_pixel_packet(cpu, pat_num, pixelnums, npixels);
+	}
+
+	tile_done_hook(cpu, xmin, ymin, xmax, ymax);
+    }
+}
+
+
 /**
  * Compute some pixels, and store them.
  *
@@ -531,6 +832,11 @@ worker(int cpu, void *UNUSED(arg))
 
 pat_found:
 
+    if (tile_count > 0) {
+	worker_tiles(cpu, pat_num);
+	return;
+    }
+
     if (random_mode) {
 
 	/* FIXME: this currently runs forever. It should probably
@@ -551,6 +857,7 @@ pat_found:
     } else {
 	int from;
 	int to;
+	int packet = packet_mode();
 
 	while (1) {
 	    if (stop_worker)
@@ -570,6 +877,29 @@ pat_found:
 	    }
 
 	    /* bu_log("SPAN[%d -> %d] for %d pixels\n", pixel_start, pixel_start+per_processor_chunk, per_processor_chunk); */
+	    if (packet) {
+		int pixelnums[RT_PACKET_MAX];
+		int npixels = 0;
+		int done = 0;
+
+		for (pixelnum = from; pixelnum != to; (from < to) ? pixelnum++ : pixelnum--) {
+		    if (pixelnum > last_pixel || pixelnum < 0) {
+			done = 1;
+			break;
+		    }
+		    pixelnums[npixels++] = pixelnum;
+		    if (npixels == RT_PACKET_MAX) {
+			do_pixel_packet(cpu, pat_num, pixelnums, npixels);
+			npixels = 0;
+		    }
+		}
+		if (npixels)
+		    do_pixel_packet(cpu, pat_num, pixelnums, npixels);
+		if (done)
+		    return;
+		continue;
+	    }
+
 	    for (pixelnum = from; pixelnum != to; (from < to) ? pixelnum++ : pixelnum--) {
 		if (pixelnum > last_pixel || pixelnum < 0)
 		    return;
@@ -591,11 +921,17 @@ do_run(int a, int b)
     cur_pixel = a;
     last_pixel = b;
 
+    if (!rtg_parallel)
+	npsw = 1;
+
+    tile_count = 0;
+    if (tile_mode() && a <= b)
+	tile_setup(a, b);
+
     if (!rtg_parallel) {
 	/*
 	 * SERIAL case -- one CPU does all the work.
 	 */
-	npsw = 1;
 	worker(0, NULL);
     } else {
 	/*